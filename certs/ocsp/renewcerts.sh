@@ -79,3 +79,14 @@ update_cert server2          "www2.wolfssl.com"                intermediate1-ca
 update_cert server3          "www3.wolfssl.com"                intermediate2-ca v3_req2 07
 update_cert server4          "www4.wolfssl.com"                intermediate2-ca v3_req2 08 # REVOKED
 update_cert server5          "www5.wolfssl.com"                intermediate3-ca v3_req3 09
+
+# canned response for server1, intermediate1 as its own responder
+openssl ocsp -issuer intermediate1-ca-cert.pem -cert server1-cert.pem \
+    -no_nonce -reqout server1-req.der
+check_result $? "OCSP request"
+openssl ocsp -index index-intermediate1-ca-issued-certs.txt           \
+    -rsigner intermediate1-ca-cert.pem -rkey intermediate1-ca-key.pem \
+    -CA intermediate1-ca-cert.pem -reqin server1-req.der              \
+    -respout server1-resp.der -ndays 200
+check_result $? "OCSP response"
+rm server1-req.der
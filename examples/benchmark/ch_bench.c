@@ -0,0 +1,344 @@
+/* ch_bench.c
+ *
+ * Copyright (C) 2006-2019 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ */
+
+
+/*
+ClientHello parsing microbenchmark.
+
+A ClientHello is generated once by a client and then, in a loop:
+ - parsed for the server name with wolfSSL_SNI_GetFromBuffer()
+ - processed by a server that has no cipher suite in common with the client,
+   as happens when a server is flooded with unwanted ClientHellos.
+
+Build with and without --enable-chpreparse to compare.
+
+Example gcc build statement
+gcc -lwolfssl -o ch_bench ch_bench.c
+./ch_bench -t 2
+*/
+
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+#ifndef WOLFSSL_USER_SETTINGS
+    #include <wolfssl/options.h>
+#endif
+#include <wolfssl/wolfcrypt/settings.h>
+#include <wolfssl/ssl.h>
+#include <wolfssl/error-ssl.h>
+#include <wolfssl/test.h>
+
+/* force certificate test buffers to be included via headers */
+#undef  USE_CERT_BUFFERS_2048
+#define USE_CERT_BUFFERS_2048
+#include <wolfssl/certs_test.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#define CH_BENCH_RUNTIME_SEC  1
+#define CH_BENCH_SERVER_NAME  "www.example.com"
+#define CH_BENCH_MAX_SZ       (16 * 1024)
+/* Suite the server wants - the client offers everything else */
+#define CH_BENCH_SERVER_SUITE "TLS13-AES256-GCM-SHA384"
+
+/* Global vars for argument parsing */
+int myoptind = 0;
+char* myoptarg = NULL;
+
+#if !defined(NO_WOLFSSL_CLIENT) && !defined(NO_WOLFSSL_SERVER) && \
+    !defined(WOLFCRYPT_ONLY) && defined(WOLFSSL_TLS13) && \
+    defined(HAVE_AESGCM) && defined(WOLFSSL_SHA384) && !defined(NO_RSA)
+
+typedef struct {
+    byte   buf[CH_BENCH_MAX_SZ];
+    word32 len;
+    word32 idx;
+} chBuf_t;
+
+static double gettime_secs(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+
+    return (double)tv.tv_sec + (double)tv.tv_usec / 1000000;
+}
+
+/* client send callback - keep the ClientHello */
+static int ClientSend(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    chBuf_t* ch = (chBuf_t*)ctx;
+    (void)ssl;
+
+    if (ch->len + sz > sizeof(ch->buf))
+        return WOLFSSL_CBIO_ERR_GENERAL;
+    XMEMCPY(ch->buf + ch->len, buf, sz);
+    ch->len += sz;
+
+    return sz;
+}
+
+/* client receive callback - no reply from server */
+static int ClientRecv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    (void)ssl;
+    (void)buf;
+    (void)sz;
+    (void)ctx;
+
+    return WOLFSSL_CBIO_ERR_WANT_READ;
+}
+
+/* server send callback - discard alerts */
+static int ServerSend(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    (void)ssl;
+    (void)buf;
+    (void)ctx;
+
+    return sz;
+}
+
+/* server receive callback - read the ClientHello */
+static int ServerRecv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    chBuf_t* ch = (chBuf_t*)ctx;
+    (void)ssl;
+
+    if (ch->idx == ch->len)
+        return WOLFSSL_CBIO_ERR_CONN_CLOSE;
+    if ((word32)sz > ch->len - ch->idx)
+        sz = (int)(ch->len - ch->idx);
+    XMEMCPY(buf, ch->buf + ch->idx, sz);
+    ch->idx += sz;
+
+    return sz;
+}
+
+/* Make a ClientHello offering all suites except the server's. */
+static int MakeClientHello(chBuf_t* ch)
+{
+    int ret = -1;
+    WOLFSSL_CTX* ctx = NULL;
+    WOLFSSL* ssl = NULL;
+    char ciphers[WOLFSSL_CIPHER_LIST_MAX_SIZE];
+    char list[WOLFSSL_CIPHER_LIST_MAX_SIZE];
+    char* cipher;
+    char* next;
+
+    /* all cipher suites less the one the server wants */
+    if (wolfSSL_get_ciphers(ciphers, (int)sizeof(ciphers)) != WOLFSSL_SUCCESS)
+        return -1;
+    list[0] = '\0';
+    for (cipher = ciphers; cipher != NULL; cipher = next) {
+        next = XSTRSTR(cipher, ":");
+        if (next != NULL)
+            *next++ = '\0';
+        if (XSTRNCMP(cipher, CH_BENCH_SERVER_SUITE,
+                                    sizeof(CH_BENCH_SERVER_SUITE)) == 0)
+            continue;
+        if (list[0] != '\0')
+            XSTRNCAT(list, ":", sizeof(list) - XSTRLEN(list) - 1);
+        XSTRNCAT(list, cipher, sizeof(list) - XSTRLEN(list) - 1);
+    }
+
+    ctx = wolfSSL_CTX_new(wolfTLSv1_3_client_method());
+    if (ctx == NULL)
+        goto exit;
+    wolfSSL_SetIOSend(ctx, ClientSend);
+    wolfSSL_SetIORecv(ctx, ClientRecv);
+    if (wolfSSL_CTX_set_cipher_list(ctx, list) != WOLFSSL_SUCCESS)
+        goto exit;
+    ssl = wolfSSL_new(ctx);
+    if (ssl == NULL)
+        goto exit;
+    wolfSSL_SetIOWriteCtx(ssl, ch);
+#ifdef HAVE_SNI
+    if (wolfSSL_UseSNI(ssl, WOLFSSL_SNI_HOST_NAME, CH_BENCH_SERVER_NAME,
+                (word16)XSTRLEN(CH_BENCH_SERVER_NAME)) != WOLFSSL_SUCCESS) {
+        goto exit;
+    }
+#endif
+
+    /* only the ClientHello is sent */
+    if (wolfSSL_connect(ssl) != WOLFSSL_SUCCESS &&
+            wolfSSL_get_error(ssl, 0) == WOLFSSL_ERROR_WANT_READ &&
+            ch->len > 0) {
+        ret = 0;
+    }
+
+exit:
+    wolfSSL_free(ssl);
+    wolfSSL_CTX_free(ctx);
+    return ret;
+}
+
+#ifdef HAVE_SNI
+static void bench_sni_get(chBuf_t* ch, int runTimeSec)
+{
+    byte   name[64];
+    word32 nameSz;
+    double start, elapsed;
+    long   count = 0;
+    int    ret;
+
+    start = gettime_secs();
+    do {
+        int i;
+
+        for (i = 0; i < 1000; i++) {
+            nameSz = sizeof(name);
+            ret = wolfSSL_SNI_GetFromBuffer(ch->buf, ch->len,
+                WOLFSSL_SNI_HOST_NAME, name, &nameSz);
+            if (ret != WOLFSSL_SUCCESS) {
+                printf("SNI_GetFromBuffer failed: %d\n", ret);
+                return;
+            }
+        }
+        count += i;
+        elapsed = gettime_secs() - start;
+    }
+    while (elapsed < runTimeSec);
+
+    printf("%-30s %10ld ClientHellos %8.3f s %12.0f /s\n", "SNI from buffer",
+        count, elapsed, count / elapsed);
+}
+#endif
+
+static void bench_server_reject(chBuf_t* ch, int runTimeSec)
+{
+    WOLFSSL_CTX* ctx;
+    WOLFSSL* ssl;
+    double start, elapsed;
+    long count = 0;
+    int err;
+
+    ctx = wolfSSL_CTX_new(wolfTLSv1_3_server_method());
+    if (ctx == NULL)
+        return;
+    wolfSSL_SetIOSend(ctx, ServerSend);
+    wolfSSL_SetIORecv(ctx, ServerRecv);
+    if (wolfSSL_CTX_use_certificate_buffer(ctx, server_cert_der_2048,
+            sizeof_server_cert_der_2048, WOLFSSL_FILETYPE_ASN1)
+                                                          != WOLFSSL_SUCCESS ||
+        wolfSSL_CTX_use_PrivateKey_buffer(ctx, server_key_der_2048,
+            sizeof_server_key_der_2048, WOLFSSL_FILETYPE_ASN1)
+                                                          != WOLFSSL_SUCCESS ||
+        wolfSSL_CTX_set_cipher_list(ctx, CH_BENCH_SERVER_SUITE)
+                                                          != WOLFSSL_SUCCESS) {
+        printf("error setting up server\n");
+        wolfSSL_CTX_free(ctx);
+        return;
+    }
+
+    start = gettime_secs();
+    do {
+        ssl = wolfSSL_new(ctx);
+        if (ssl == NULL)
+            break;
+        ch->idx = 0;
+        wolfSSL_SetIOReadCtx(ssl, ch);
+        if (wolfSSL_accept(ssl) == WOLFSSL_SUCCESS) {
+            printf("server unexpectedly accepted ClientHello\n");
+            wolfSSL_free(ssl);
+            break;
+        }
+        err = wolfSSL_get_error(ssl, 0);
+        wolfSSL_free(ssl);
+        if (err != MATCH_SUITE_ERROR) {
+            printf("server failed with %d, not MATCH_SUITE_ERROR\n", err);
+            break;
+        }
+        count++;
+        elapsed = gettime_secs() - start;
+    }
+    while (elapsed < runTimeSec);
+
+    if (count > 0) {
+        printf("%-30s %10ld ClientHellos %8.3f s %12.0f /s\n",
+            "Server reject no common suite", count, elapsed, count / elapsed);
+    }
+
+    wolfSSL_CTX_free(ctx);
+}
+
+static void Usage(void)
+{
+    printf("ch_bench "    LIBWOLFSSL_VERSION_STRING "\n");
+    printf("-?          Help, print this usage\n");
+    printf("-t <num>    Time <num> (seconds) to run each test (default %d)\n",
+        CH_BENCH_RUNTIME_SEC);
+}
+
+int main(int argc, char** argv)
+{
+    static chBuf_t ch;
+    int runTimeSec = CH_BENCH_RUNTIME_SEC;
+    int c;
+
+    while ((c = mygetopt(argc, argv, "?t:")) != -1) {
+        switch (c) {
+            case 't':
+                runTimeSec = atoi(myoptarg);
+                break;
+            case '?':
+            default:
+                Usage();
+                return MY_EX_USAGE;
+        }
+    }
+
+    wolfSSL_Init();
+
+    if (MakeClientHello(&ch) != 0) {
+        printf("error making ClientHello\n");
+        wolfSSL_Cleanup();
+        return 1;
+    }
+    printf("ClientHello record: %u bytes\n", ch.len);
+
+#ifdef HAVE_SNI
+    bench_sni_get(&ch, runTimeSec);
+#endif
+    bench_server_reject(&ch, runTimeSec);
+
+    wolfSSL_Cleanup();
+
+    return 0;
+}
+
+#else
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    printf("ch_bench requires TLS v1.3 client and server with RSA and "
+           "AES-GCM-SHA384\n");
+
+    return 0;
+}
+
+#endif
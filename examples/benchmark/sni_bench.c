@@ -0,0 +1,257 @@
+/* sni_bench.c
+ *
+ * Copyright (C) 2006-2019 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ */
+
+
+/*
+SNI certificate store benchmark.
+
+Adds server names to a CTX's certificate store, one in ten a wildcard, and
+then looks up names received from clients: exact matches, wildcard matches
+and unknown names. Certificates are added as files and are only read when
+first used in a handshake, so adding many names is cheap.
+For comparison, the same lookups are done with a linear scan of the names,
+as a simple SNI callback would.
+
+Run from the wolfSSL root directory.
+./examples/benchmark/sni_bench -n 100000 -l 1000000
+*/
+
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+#ifndef WOLFSSL_USER_SETTINGS
+    #include <wolfssl/options.h>
+#endif
+#include <wolfssl/wolfcrypt/settings.h>
+#include <wolfssl/ssl.h>
+#include <wolfssl/test.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#define SNI_BENCH_NAMES        100000
+#define SNI_BENCH_LOOKUPS      1000000
+#define SNI_BENCH_LINEAR_MAX   1000     /* lookups for linear scan */
+#define SNI_BENCH_NAME_MAX     64
+#define SNI_BENCH_WILD_EVERY   10       /* one in ten names is a wildcard */
+#define SNI_BENCH_LOOKUP_NAMES 65536    /* different names looked up */
+
+/* Global vars for argument parsing */
+int myoptind = 0;
+char* myoptarg = NULL;
+
+#if defined(WOLFSSL_SNI_CERT_STORE) && !defined(NO_FILESYSTEM)
+
+static double gettime_secs(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+
+    return (double)tv.tv_sec + (double)tv.tv_usec / 1000000;
+}
+
+/* Name added to the store. */
+static void MakeName(char* name, int i)
+{
+    if ((i % SNI_BENCH_WILD_EVERY) == 0)
+        sprintf(name, "*.site%d.example.com", i);
+    else
+        sprintf(name, "www.site%d.example.com", i);
+}
+
+/* Name sent by a client: 70% exact, 20% wildcard and 10% unknown. */
+static int MakeLookup(char* name, int i, int numNames)
+{
+    int n = (int)(((unsigned int)i * 2654435761U) % (unsigned int)numNames);
+
+    switch (i % 10) {
+        case 0:
+            return sprintf(name, "www.unknown%d.example.org", n);
+        case 1:
+        case 2:
+            n -= n % SNI_BENCH_WILD_EVERY;
+            return sprintf(name, "Host%d.SITE%d.example.com", i, n);
+        default:
+            if ((n % SNI_BENCH_WILD_EVERY) == 0)
+                n++;
+            if (n >= numNames)
+                n = 1;
+            return sprintf(name, "www.site%d.example.com", n);
+    }
+}
+
+/* Match as a simple SNI callback would - check every name. */
+static int LinearFind(char (*names)[SNI_BENCH_NAME_MAX], int numNames,
+                      const char* name, int nameSz)
+{
+    const char* domain = XSTRSTR(name, ".");
+    int domainSz = (domain != NULL) ? (int)(nameSz - (domain - name)) : 0;
+    int len;
+    int i;
+
+    for (i = 0; i < numNames; i++) {
+        len = (int)XSTRLEN(names[i]);
+        if (names[i][0] == '*') {
+            if (len - 1 == domainSz &&
+                              XSTRNCASECMP(names[i] + 1, domain, domainSz) == 0)
+                return 1;
+        }
+        else if (len == nameSz && XSTRNCASECMP(names[i], name, nameSz) == 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void Usage(void)
+{
+    printf("sni_bench "    LIBWOLFSSL_VERSION_STRING "\n");
+    printf("-?          Help, print this usage\n");
+    printf("-n <num>    Number of server names (default %d)\n",
+        SNI_BENCH_NAMES);
+    printf("-l <num>    Number of lookups (default %d)\n", SNI_BENCH_LOOKUPS);
+}
+
+int main(int argc, char** argv)
+{
+    WOLFSSL_CTX* ctx;
+    char (*names)[SNI_BENCH_NAME_MAX];
+    char (*lookups)[SNI_BENCH_NAME_MAX];
+    int*   lookupSz;
+    int    numNames = SNI_BENCH_NAMES;
+    int    numLookups = SNI_BENCH_LOOKUPS;
+    int    found = 0;
+    int    numLookupNames;
+    int    i, c;
+    double start, elapsed;
+
+    while ((c = mygetopt(argc, argv, "?n:l:")) != -1) {
+        switch (c) {
+            case 'n':
+                numNames = atoi(myoptarg);
+                break;
+            case 'l':
+                numLookups = atoi(myoptarg);
+                break;
+            case '?':
+            default:
+                Usage();
+                return MY_EX_USAGE;
+        }
+    }
+    if (numNames <= SNI_BENCH_WILD_EVERY || numLookups <= 0) {
+        Usage();
+        return MY_EX_USAGE;
+    }
+
+    /* names made before timing */
+    numLookupNames = (numLookups < SNI_BENCH_LOOKUP_NAMES) ? numLookups :
+                                                        SNI_BENCH_LOOKUP_NAMES;
+    names = (char (*)[SNI_BENCH_NAME_MAX])malloc(
+                                         numNames * sizeof(*names));
+    lookups = (char (*)[SNI_BENCH_NAME_MAX])malloc(
+                                         numLookupNames * sizeof(*lookups));
+    lookupSz = (int*)malloc(numLookupNames * sizeof(int));
+    if (names == NULL || lookups == NULL || lookupSz == NULL) {
+        free(names);
+        free(lookups);
+        free(lookupSz);
+        return 1;
+    }
+    for (i = 0; i < numNames; i++)
+        MakeName(names[i], i);
+    for (i = 0; i < numLookupNames; i++)
+        lookupSz[i] = MakeLookup(lookups[i], i, numNames);
+
+    wolfSSL_Init();
+    ctx = wolfSSL_CTX_new(wolfSSLv23_server_method());
+    if (ctx == NULL) {
+        free(names);
+        free(lookups);
+        free(lookupSz);
+        return 1;
+    }
+
+    start = gettime_secs();
+    for (i = 0; i < numNames; i++) {
+        if (wolfSSL_CTX_SNI_AddCertFiles(ctx, names[i], svrCertFile,
+                           svrKeyFile, WOLFSSL_FILETYPE_PEM) != WOLFSSL_SUCCESS) {
+            printf("failed to add %s\n", names[i]);
+            break;
+        }
+    }
+    elapsed = gettime_secs() - start;
+    printf("%-24s %10d names    %8.3f s %12.0f /s\n", "Add", numNames,
+        elapsed, numNames / elapsed);
+
+    start = gettime_secs();
+    for (i = 0; i < numLookups; i++) {
+        c = i % numLookupNames;
+        if (wolfSSL_CTX_SNI_FindCert(ctx, (const unsigned char*)lookups[c],
+                              (unsigned short)lookupSz[c]) == WOLFSSL_SUCCESS) {
+            found++;
+        }
+    }
+    elapsed = gettime_secs() - start;
+    printf("%-24s %10d lookups  %8.3f s %12.0f /s (%d found)\n",
+        "Store lookup", numLookups, elapsed, numLookups / elapsed, found);
+
+    found = 0;
+    start = gettime_secs();
+    for (i = 0; i < numLookupNames && i < SNI_BENCH_LINEAR_MAX; i++)
+        found += LinearFind(names, numNames, lookups[i], lookupSz[i]);
+    elapsed = gettime_secs() - start;
+    printf("%-24s %10d lookups  %8.3f s %12.0f /s (%d found)\n",
+        "Linear scan lookup", i, elapsed, i / elapsed, found);
+
+    start = gettime_secs();
+    for (i = 0; i < numNames; i++)
+        wolfSSL_CTX_SNI_RemoveCert(ctx, names[i]);
+    elapsed = gettime_secs() - start;
+    printf("%-24s %10d names    %8.3f s %12.0f /s\n", "Remove", numNames,
+        elapsed, numNames / elapsed);
+
+    wolfSSL_CTX_free(ctx);
+    wolfSSL_Cleanup();
+    free(names);
+    free(lookups);
+    free(lookupSz);
+
+    return 0;
+}
+
+#else
+
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    printf("sni_bench requires --enable-snicertstore and a filesystem\n");
+
+    return 0;
+}
+
+#endif
@@ -109,9 +109,13 @@ bench_tls(args);
 /* Must be large enough to handle max TLS packet size plus max TLS header MAX_MSG_EXTRA */
 #define MEM_BUFFER_SZ       (TEST_PACKET_SIZE + 38 + WC_MAX_DIGEST_SIZE)
 #define SHOW_VERBOSE        0 /* Default output is tab delimited format */
+#define LATENCY_HIST_BUCKETS 10   /* handshake latency histogram buckets */
+#define LATENCY_HIST_FIRST   0.25 /* first bucket limit in ms, then doubles */
 
 /* shutdown message - nice signal to server, we are done */
 static const char* kShutdown = "shutdown";
+/* greeting message - server speaks first in time to first byte mode */
+static const char* kGreeting = "greeting";
 
 #if (!defined(NO_WOLFSSL_CLIENT) || !defined(NO_WOLFSSL_SERVER)) && \
     !defined(WOLFCRYPT_ONLY)
@@ -256,6 +260,9 @@ typedef struct {
     int connCount;
     int rxTotal;
     int txTotal;
+    int hsTxTotal; /* bytes sent while handshaking */
+    double ttfbTime; /* connect start to server's first data */
+    int connHist[LATENCY_HIST_BUCKETS]; /* handshake latency histogram */
 } stats_t;
 
 typedef struct {
@@ -273,6 +280,10 @@ typedef struct {
     int runTimeSec;
     int showPeerInfo;
     int showVerbose;
+    int certCompress;
+    int ttfb; /* server sends greeting, client times it */
+    int halfRtt; /* greeting sent as TLS v1.3 0.5-RTT data */
+    int keySharePool; /* TLS v1.3 key shares generated between connections */
 #ifndef NO_WOLFSSL_SERVER
     int listenFd;
 #endif
@@ -313,6 +324,42 @@ static double gettime_secs(int reset)
 
 #ifdef HAVE_PTHREAD
 /* server send callback */
+/* Count the handshake time in the latency histogram */
+static void add_conn_latency(stats_t* stats, double secs)
+{
+    double limit = LATENCY_HIST_FIRST / 1000;
+    int i;
+
+    for (i = 0; i < LATENCY_HIST_BUCKETS - 1 && secs >= limit; i++)
+        limit *= 2;
+    stats->connHist[i]++;
+}
+
+#ifdef WOLFSSL_KEY_SHARE_POOL
+/* Pool key pairs for the groups used in TLS v1.3 key shares and fill it */
+static int SetupKeySharePool(WOLFSSL_CTX* ctx)
+{
+    int ret = 0;
+
+#if defined(HAVE_ECC) && !defined(NO_ECC256)
+    if (ret == 0)
+        ret = wolfSSL_CTX_UseKeySharePool(ctx, WOLFSSL_ECC_SECP256R1, 0);
+#endif
+#ifdef HAVE_CURVE25519
+    if (ret == 0)
+        ret = wolfSSL_CTX_UseKeySharePool(ctx, WOLFSSL_ECC_X25519, 0);
+#endif
+#if !defined(NO_DH) && defined(HAVE_FFDHE_2048)
+    if (ret == 0)
+        ret = wolfSSL_CTX_UseKeySharePool(ctx, WOLFSSL_FFDHE_2048, 0);
+#endif
+    if (ret == 0)
+        ret = wolfSSL_CTX_FillKeySharePool(ctx, 0);
+
+    return (ret < 0) ? ret : 0;
+}
+#endif
+
 static int ServerMemSend(info_t* info, char* buf, int sz)
 {
     pthread_mutex_lock(&info->to_client.mutex);
@@ -500,12 +547,16 @@ static int SocketSend(int sockFd, char* buf, int sz)
 static int ServerSend(WOLFSSL* ssl, char* buf, int sz, void* ctx)
 {
     info_t* info = (info_t*)ctx;
-    (void)ssl;
+    int ret;
 #ifdef HAVE_PTHREAD
     if (info->useLocalMem)
-        return ServerMemSend(info, buf, sz);
+        ret = ServerMemSend(info, buf, sz);
+    else
 #endif
-    return SocketSend(info->server.sockFd, buf, sz);
+        ret = SocketSend(info->server.sockFd, buf, sz);
+    if (ret > 0 && !wolfSSL_is_init_finished(ssl))
+        info->server_stats.hsTxTotal += ret;
+    return ret;
 }
 static int ServerRecv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
 {
@@ -523,12 +574,16 @@ static int ServerRecv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
 static int ClientSend(WOLFSSL* ssl, char* buf, int sz, void* ctx)
 {
     info_t* info = (info_t*)ctx;
-    (void)ssl;
+    int ret;
 #ifdef HAVE_PTHREAD
     if (info->useLocalMem)
-        return ClientMemSend(info, buf, sz);
+        ret = ClientMemSend(info, buf, sz);
+    else
 #endif
-    return SocketSend(info->client.sockFd, buf, sz);
+        ret = SocketSend(info->client.sockFd, buf, sz);
+    if (ret > 0 && !wolfSSL_is_init_finished(ssl))
+        info->client_stats.hsTxTotal += ret;
+    return ret;
 }
 static int ClientRecv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
 {
@@ -620,7 +675,7 @@ static int SetupSocketAndConnect(info_t* info, const char* host,
 static int bench_tls_client(info_t* info)
 {
     byte *writeBuf = NULL, *readBuf = NULL;
-    double start, total = 0;
+    double start, connStart, total = 0;
     int ret, readBufSz;
     WOLFSSL_CTX* cli_ctx = NULL;
     WOLFSSL* cli_ssl = NULL;
@@ -668,6 +723,17 @@ static int bench_tls_client(info_t* info)
     wolfSSL_CTX_SetIOSend(cli_ctx, ClientSend);
     wolfSSL_CTX_SetIORecv(cli_ctx, ClientRecv);
 
+#if defined(HAVE_CERT_COMPRESSION) && defined(HAVE_LIBZ)
+    if (tls13 && info->certCompress) {
+        ret = wolfSSL_CTX_UseCertCompression(cli_ctx,
+            WOLFSSL_CERT_COMPRESS_ZLIB, NULL, NULL);
+        if (ret != WOLFSSL_SUCCESS) {
+            printf("error setting certificate compression\n");
+            goto exit;
+        }
+    }
+#endif
+
     /* set cipher suite */
     ret = wolfSSL_CTX_set_cipher_list(cli_ctx, info->cipher);
     if (ret != WOLFSSL_SUCCESS) {
@@ -683,6 +749,16 @@ static int bench_tls_client(info_t* info)
     }
 #endif
 
+#ifdef WOLFSSL_KEY_SHARE_POOL
+    if (tls13 && info->keySharePool) {
+        ret = SetupKeySharePool(cli_ctx);
+        if (ret != 0) {
+            printf("error setting up key share pool\n");
+            goto exit;
+        }
+    }
+#endif
+
     /* Allocate and initialize a packet sized buffer */
     writeBuf = (unsigned char*)XMALLOC(info->packetSize, NULL,
         DYNAMIC_TYPE_TMP_BUFFER);
@@ -726,6 +802,7 @@ static int bench_tls_client(info_t* info)
 
         /* perform connect */
         start = gettime_secs(1);
+        connStart = start;
     #ifndef BENCH_USE_NONBLOCK
         ret = wolfSSL_connect(cli_ssl);
     #else
@@ -744,6 +821,27 @@ static int bench_tls_client(info_t* info)
         }
         info->client_stats.connTime += start;
         info->client_stats.connCount++;
+        add_conn_latency(&info->client_stats, start);
+
+        /* read server's greeting for time to first byte */
+        if (info->ttfb) {
+            XMEMSET(readBuf, 0, readBufSz);
+        #ifndef BENCH_USE_NONBLOCK
+            ret = wolfSSL_read(cli_ssl, readBuf, readBufSz);
+        #else
+            do {
+                ret = wolfSSL_read(cli_ssl, readBuf, readBufSz);
+                err = wolfSSL_get_error(cli_ssl, ret);
+            }
+            while (err == WOLFSSL_ERROR_WANT_READ);
+        #endif
+            if (ret <= 0) {
+                printf("error on client greeting read\n");
+                ret = wolfSSL_get_error(cli_ssl, ret);
+                goto exit;
+            }
+            info->client_stats.ttfbTime += gettime_secs(0) - connStart;
+        }
 
         if ((info->showPeerInfo) && (!haveShownPeerInfo)) {
             haveShownPeerInfo = 1;
@@ -829,6 +927,12 @@ static int bench_tls_client(info_t* info)
 
         wolfSSL_free(cli_ssl);
         cli_ssl = NULL;
+
+    #ifdef WOLFSSL_KEY_SHARE_POOL
+        /* replace the used key pair while idle between connections */
+        if (tls13 && info->keySharePool)
+            wolfSSL_CTX_FillKeySharePool(cli_ctx, 0);
+    #endif
     }
 
 exit:
@@ -1003,6 +1107,17 @@ static int bench_tls_server(info_t* info)
     wolfSSL_CTX_SetIOSend(srv_ctx, ServerSend);
     wolfSSL_CTX_SetIORecv(srv_ctx, ServerRecv);
 
+#if defined(HAVE_CERT_COMPRESSION) && defined(HAVE_LIBZ)
+    if (tls13 && info->certCompress) {
+        ret = wolfSSL_CTX_UseCertCompression(srv_ctx,
+            WOLFSSL_CERT_COMPRESS_ZLIB, NULL, NULL);
+        if (ret != WOLFSSL_SUCCESS) {
+            printf("error setting certificate compression\n");
+            goto exit;
+        }
+    }
+#endif
+
     /* set cipher suite */
     ret = wolfSSL_CTX_set_cipher_list(srv_ctx, info->cipher);
     if (ret != WOLFSSL_SUCCESS) {
@@ -1018,6 +1133,16 @@ static int bench_tls_server(info_t* info)
     }
 #endif
 
+#ifdef WOLFSSL_KEY_SHARE_POOL
+    if (tls13 && info->keySharePool) {
+        ret = SetupKeySharePool(srv_ctx);
+        if (ret != 0) {
+            printf("error setting up key share pool\n");
+            goto exit;
+        }
+    }
+#endif
+
     /* Allocate read buffer */
     readBufSz = info->packetSize;
     readBuf = (unsigned char*)XMALLOC(readBufSz, NULL, DYNAMIC_TYPE_TMP_BUFFER);
@@ -1064,6 +1189,29 @@ static int bench_tls_server(info_t* info)
 
         /* accept TLS connection */
         start = gettime_secs(1);
+    #ifdef WOLFSSL_HALF_RTT_DATA
+        if (tls13 && info->halfRtt) {
+            int outSz;
+
+            /* send greeting with server's handshake messages */
+        #ifndef BENCH_USE_NONBLOCK
+            ret = wolfSSL_write_half_rtt_data(srv_ssl, kGreeting,
+                (int)XSTRLEN(kGreeting) + 1, &outSz);
+        #else
+            do {
+                ret = wolfSSL_write_half_rtt_data(srv_ssl, kGreeting,
+                    (int)XSTRLEN(kGreeting) + 1, &outSz);
+                err = wolfSSL_get_error(srv_ssl, ret);
+            }
+            while (err == WOLFSSL_ERROR_WANT_READ || err == WOLFSSL_ERROR_WANT_WRITE);
+        #endif
+            if (ret < 0) {
+                printf("error on server 0.5-RTT write\n");
+                ret = wolfSSL_get_error(srv_ssl, ret);
+                goto exit;
+            }
+        }
+    #endif
     #ifndef BENCH_USE_NONBLOCK
         ret = wolfSSL_accept(srv_ssl);
     #else
@@ -1082,6 +1230,26 @@ static int bench_tls_server(info_t* info)
 
         info->server_stats.connTime += start;
         info->server_stats.connCount++;
+        add_conn_latency(&info->server_stats, start);
+
+        /* server speaks first */
+        if (info->ttfb && !(tls13 && info->halfRtt)) {
+        #ifndef BENCH_USE_NONBLOCK
+            ret = wolfSSL_write(srv_ssl, kGreeting, (int)XSTRLEN(kGreeting) + 1);
+        #else
+            do {
+                ret = wolfSSL_write(srv_ssl, kGreeting,
+                    (int)XSTRLEN(kGreeting) + 1);
+                err = wolfSSL_get_error(srv_ssl, ret);
+            }
+            while (err == WOLFSSL_ERROR_WANT_WRITE);
+        #endif
+            if (ret < 0) {
+                printf("error on server greeting write\n");
+                ret = wolfSSL_get_error(srv_ssl, ret);
+                goto exit;
+            }
+        }
 
         /* echo loop */
         ret = 0;
@@ -1148,6 +1316,12 @@ static int bench_tls_server(info_t* info)
 
         wolfSSL_free(srv_ssl);
         srv_ssl = NULL;
+
+    #ifdef WOLFSSL_KEY_SHARE_POOL
+        /* replace the used key pair while idle between connections */
+        if (tls13 && info->keySharePool)
+            wolfSSL_CTX_FillKeySharePool(srv_ctx, 0);
+    #endif
     }
 
 exit:
@@ -1214,10 +1388,12 @@ static void print_stats(stats_t* wcStat, const char* desc, const char* cipher, i
                "\tRx          : %9.3f MB/s\n"
                "\tTx          : %9.3f MB/s\n"
                "\tConnect     : %9.3f ms\n"
-               "\tConnect Avg : %9.3f ms\n";
+               "\tConnect Avg : %9.3f ms\n"
+               "\tHS Tx Avg   : %9d bytes\n"
+               "\tTTFB Avg    : %9.3f ms\n";
     }
     else {
-        formatStr = "%-6s  %-33s  %11d  %9d  %9.3f  %9.3f  %9.3f  %9.3f  %17.3f  %15.3f\n";
+        formatStr = "%-6s  %-33s  %11d  %9d  %9.3f  %9.3f  %9.3f  %9.3f  %17.3f  %15.3f  %9d  %11.3f\n";
     }
 
     printf(formatStr,
@@ -1230,7 +1406,33 @@ static void print_stats(stats_t* wcStat, const char* desc, const char* cipher, i
            wcStat->rxTotal / wcStat->rxTime / 1024 / 1024,
            wcStat->txTotal / wcStat->txTime / 1024 / 1024,
            wcStat->connTime * 1000,
-           wcStat->connTime * 1000 / wcStat->connCount);
+           wcStat->connTime * 1000 / wcStat->connCount,
+           wcStat->connCount ? wcStat->hsTxTotal / wcStat->connCount : 0,
+           wcStat->connCount ? wcStat->ttfbTime * 1000 / wcStat->connCount : 0);
+}
+
+static void print_latency_hist(stats_t* wcStat, const char* desc,
+    const char* cipher, const char* keyShares)
+{
+    double limit = LATENCY_HIST_FIRST;
+    int i, j, bar;
+
+    printf("%s %s handshake latency (%s key shares):\n", desc, cipher,
+        keyShares);
+    for (i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+        if (i < LATENCY_HIST_BUCKETS - 1)
+            printf("\t<  %8.3f ms : ", limit);
+        else
+            printf("\t>= %8.3f ms : ", limit / 2);
+        printf("%9d  %6.2f%%  ", wcStat->connHist[i], wcStat->connCount ?
+            wcStat->connHist[i] * 100.0 / wcStat->connCount : 0);
+        bar = wcStat->connCount ?
+            wcStat->connHist[i] * 50 / wcStat->connCount : 0;
+        for (j = 0; j < bar; j++)
+            printf("#");
+        printf("\n");
+        limit *= 2;
+    }
 }
 
 static void Usage(void)
@@ -1256,6 +1458,17 @@ static void Usage(void)
     printf("-T <num>    Number of threaded server/client pairs (default %d)\n", NUM_THREAD_PAIRS);
     printf("-m          Use local memory, not socket\n");
 #endif
+#if defined(HAVE_CERT_COMPRESSION) && defined(HAVE_LIBZ)
+    printf("-z          Compress TLS v1.3 certificates with zlib\n");
+#endif
+    printf("-F          Time to first byte, server sends a greeting first\n");
+#ifdef WOLFSSL_HALF_RTT_DATA
+    printf("-H          Send server's greeting as TLS v1.3 0.5-RTT data (implies -F)\n");
+#endif
+#ifdef WOLFSSL_KEY_SHARE_POOL
+    printf("-K          Use TLS v1.3 key shares generated between connections\n");
+#endif
+    printf("-L          Show handshake latency histogram (compare with/without -K)\n");
 }
 
 static void ShowCiphers(void)
@@ -1277,7 +1490,7 @@ int bench_tls(void* args)
     int ret = 0;
     info_t *theadInfo = NULL, *info;
     stats_t cli_comb, srv_comb;
-    int i;
+    int i, j;
     char *cipher, *next_cipher, *ciphers = NULL;
     int     argc = ((func_args*)args)->argc;
     char**  argv = ((func_args*)args)->argv;
@@ -1295,6 +1508,11 @@ int bench_tls(void* args)
     const char* argHost = BENCH_DEFAULT_HOST;
     int argPort = BENCH_DEFAULT_PORT;
     int argShowPeerInfo = 0;
+    int argCertCompress = 0;
+    int argTtfb = 0;
+    int argHalfRtt = 0;
+    int argKeySharePool = 0;
+    int argLatencyHist = 0;
 #ifdef HAVE_PTHREAD
     int doShutdown;
 #endif
@@ -1310,7 +1528,7 @@ int bench_tls(void* args)
     wolfSSL_Init();
 
     /* Parse command line arguments */
-    while ((ch = mygetopt(argc, argv, "?" "deil:p:t:vT:sch:P:mS:")) != -1) {
+    while ((ch = mygetopt(argc, argv, "?" "deil:p:t:vT:sch:P:mS:zFHKL")) != -1) {
         switch (ch) {
             case '?' :
                 Usage();
@@ -1383,6 +1601,33 @@ int bench_tls(void* args)
             #endif
                 break;
 
+            case 'z':
+            #if defined(HAVE_CERT_COMPRESSION) && defined(HAVE_LIBZ)
+                argCertCompress = 1;
+            #endif
+                break;
+
+            case 'F':
+                argTtfb = 1;
+                break;
+
+            case 'H':
+            #ifdef WOLFSSL_HALF_RTT_DATA
+                argTtfb = 1;
+                argHalfRtt = 1;
+            #endif
+                break;
+
+            case 'K':
+            #ifdef WOLFSSL_KEY_SHARE_POOL
+                argKeySharePool = 1;
+            #endif
+                break;
+
+            case 'L':
+                argLatencyHist = 1;
+                break;
+
             default:
                 Usage();
                 ret = MY_EX_USAGE; goto exit;
@@ -1460,6 +1705,10 @@ int bench_tls(void* args)
             info->maxSize = argTestMaxSize;
             info->showPeerInfo = argShowPeerInfo;
             info->showVerbose = argShowVerbose;
+            info->certCompress = argCertCompress;
+            info->ttfb = argTtfb;
+            info->halfRtt = argHalfRtt;
+            info->keySharePool = argKeySharePool;
         #ifndef NO_WOLFSSL_SERVER
             info->listenFd = listenFd;
         #endif
@@ -1557,15 +1806,27 @@ int bench_tls(void* args)
 
             cli_comb.txTime += info->client_stats.txTime;
             srv_comb.txTime += info->server_stats.txTime;
+
+            cli_comb.hsTxTotal += info->client_stats.hsTxTotal;
+            srv_comb.hsTxTotal += info->server_stats.hsTxTotal;
+
+            cli_comb.ttfbTime += info->client_stats.ttfbTime;
+            srv_comb.ttfbTime += info->server_stats.ttfbTime;
+
+            for (j = 0; j < LATENCY_HIST_BUCKETS; j++) {
+                cli_comb.connHist[j] += info->client_stats.connHist[j];
+                srv_comb.connHist[j] += info->server_stats.connHist[j];
+            }
         }
 
         if (argShowVerbose) {
             printf("Totals for %d Threads\n", argThreadPairs);
         }
         else {
-            printf("%-6s  %-33s  %11s  %9s  %9s  %9s  %9s  %9s  %17s  %15s\n",
+            printf("%-6s  %-33s  %11s  %9s  %9s  %9s  %9s  %9s  %17s  %15s  %9s  %11s\n",
                 "Side", "Cipher", "Total Bytes", "Num Conns", "Rx ms", "Tx ms",
-                "Rx MB/s", "Tx MB/s", "Connect Total ms", "Connect Avg ms");
+                "Rx MB/s", "Tx MB/s", "Connect Total ms", "Connect Avg ms",
+                "HS Tx Avg", "TTFB Avg ms");
         #ifndef NO_WOLFSSL_SERVER
             if (!argClientOnly)
                 print_stats(&srv_comb, "Server", theadInfo[0].cipher, 0);
@@ -1576,6 +1837,23 @@ int bench_tls(void* args)
         #endif
         }
 
+        if (argLatencyHist) {
+            /* only TLS v1.3 handshakes use key shares */
+            const char* keyShares = (argKeySharePool &&
+                XSTRNCMP(theadInfo[0].cipher, "TLS13", 5) == 0) ?
+                "pooled" : "inline";
+        #ifndef NO_WOLFSSL_SERVER
+            if (!argClientOnly)
+                print_latency_hist(&srv_comb, "Server", theadInfo[0].cipher,
+                    keyShares);
+        #endif
+        #ifndef NO_WOLFSSL_CLIENT
+            if (!argServerOnly)
+                print_latency_hist(&cli_comb, "Client", theadInfo[0].cipher,
+                    keyShares);
+        #endif
+        }
+
         /* target next cipher */
         cipher = (next_cipher != NULL) ? (next_cipher + 1) : NULL;
     } /* while */
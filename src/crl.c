@@ -75,6 +75,138 @@ int InitCRL(WOLFSSL_CRL* crl, WOLFSSL_CERT_MANAGER* cm)
 }
 
 
+/* Order serial numbers by length then value, returns <0, 0 or >0 */
+static int CompareRevokedSerial(const byte* a, int aSz, const byte* b, int bSz)
+{
+    if (aSz != bSz)
+        return aSz - bSz;
+
+    return XMEMCMP(a, b, aSz);
+}
+
+
+/* Sort revoked serials. Bottom up merge sort through a scratch array keeps
+ * loading of very large CRLs O(n log n) and cache friendly, 0 on success */
+static int SortRevokedSerials(CRL_RevokedSerial* rs, int n, void* heap)
+{
+    CRL_RevokedSerial* tmp;
+    CRL_RevokedSerial* src = rs;
+    CRL_RevokedSerial* dst;
+    int width;
+
+    if (n < 2)
+        return 0;
+
+    tmp = (CRL_RevokedSerial*)XMALLOC(sizeof(CRL_RevokedSerial) * n, heap,
+                                      DYNAMIC_TYPE_TMP_BUFFER);
+    if (tmp == NULL)
+        return MEMORY_E;
+    dst = tmp;
+
+    for (width = 1; width < n; width *= 2) {
+        CRL_RevokedSerial* swap;
+        int lo;
+
+        for (lo = 0; lo < n; lo += 2 * width) {
+            int mid = (lo + width < n) ? lo + width : n;
+            int hi  = (mid + width < n) ? mid + width : n;
+            int i = lo, j = mid, k = lo;
+
+            while (i < mid && j < hi) {
+                if (CompareRevokedSerial(src[j].serial, src[j].serialSz,
+                                         src[i].serial, src[i].serialSz) < 0)
+                    dst[k++] = src[j++];
+                else
+                    dst[k++] = src[i++];
+            }
+            while (i < mid)
+                dst[k++] = src[i++];
+            while (j < hi)
+                dst[k++] = src[j++];
+        }
+
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != rs)
+        XMEMCPY(rs, src, sizeof(CRL_RevokedSerial) * n);
+
+    XFREE(tmp, heap, DYNAMIC_TYPE_TMP_BUFFER);
+    (void)heap;
+
+    return 0;
+}
+
+
+/* Move the decoded revoked cert list into a sorted array on the CRL entry,
+ * 0 on success */
+static int InitCRL_Revoked(CRL_Entry* crle, DecodedCRL* dcrl, void* heap)
+{
+    RevokedCert* rc;
+    int          count = 0;
+
+    crle->revoked = NULL;
+    crle->totalCerts = 0;
+
+    for (rc = dcrl->certs; rc != NULL; rc = rc->next)
+        count++;
+    if (count == 0)
+        return 0;
+
+    crle->revoked = (CRL_RevokedSerial*)XMALLOC(
+                  sizeof(CRL_RevokedSerial) * count, heap, DYNAMIC_TYPE_REVOKED);
+    if (crle->revoked == NULL)
+        return MEMORY_E;
+
+    while (dcrl->certs != NULL) {
+        CRL_RevokedSerial* rs = &crle->revoked[crle->totalCerts++];
+
+        rc = dcrl->certs;
+        rs->serialSz = (byte)rc->serialSz;
+        XMEMCPY(rs->serial, rc->serialNumber, rc->serialSz);
+
+        dcrl->certs = rc->next;
+        XFREE(rc, dcrl->heap, DYNAMIC_TYPE_REVOKED);
+    }
+    dcrl->totalCerts = 0;
+
+    if (SortRevokedSerials(crle->revoked, crle->totalCerts, heap) != 0) {
+        XFREE(crle->revoked, heap, DYNAMIC_TYPE_REVOKED);
+        crle->revoked = NULL;
+        crle->totalCerts = 0;
+        return MEMORY_E;
+    }
+
+    return 0;
+}
+
+
+/* Binary search the sorted revoked serials of a CRL entry, 1 when found */
+static int FindRevokedSerial(const CRL_Entry* crle, const byte* serial,
+                             int serialSz)
+{
+    int lo = 0;
+    int hi = crle->totalCerts - 1;
+
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        int cmp = CompareRevokedSerial(crle->revoked[mid].serial,
+                                       crle->revoked[mid].serialSz,
+                                       serial, serialSz);
+        if (cmp == 0)
+            return 1;
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+
+    return 0;
+}
+
+
 /* Initialize CRL Entry */
 static int InitCRL_Entry(CRL_Entry* crle, DecodedCRL* dcrl, const byte* buff,
                          int verified, void* heap)
@@ -89,9 +221,12 @@ static int InitCRL_Entry(CRL_Entry* crle, DecodedCRL* dcrl, const byte* buff,
     crle->lastDateFormat = dcrl->lastDateFormat;
     crle->nextDateFormat = dcrl->nextDateFormat;
 
-    crle->certs = dcrl->certs;   /* take ownsership */
-    dcrl->certs = NULL;
-    crle->totalCerts = dcrl->totalCerts;
+    crle->next = NULL;
+    crle->srcFile = NULL;
+    crle->refCount = 1;  /* owned by the list it goes on */
+
+    if (InitCRL_Revoked(crle, dcrl, heap) != 0)
+        return -1;
     crle->verified = verified;
     if (!verified) {
         crle->tbsSz = dcrl->sigIndex - dcrl->certBegin;
@@ -99,12 +234,15 @@ static int InitCRL_Entry(CRL_Entry* crle, DecodedCRL* dcrl, const byte* buff,
         crle->signatureOID = dcrl->signatureOID;
         crle->toBeSigned = (byte*)XMALLOC(crle->tbsSz, heap,
                                           DYNAMIC_TYPE_CRL_ENTRY);
-        if (crle->toBeSigned == NULL)
+        if (crle->toBeSigned == NULL) {
+            XFREE(crle->revoked, heap, DYNAMIC_TYPE_REVOKED);
             return -1;
+        }
         crle->signature = (byte*)XMALLOC(crle->signatureSz, heap,
                                          DYNAMIC_TYPE_CRL_ENTRY);
         if (crle->signature == NULL) {
             XFREE(crle->toBeSigned, heap, DYNAMIC_TYPE_CRL_ENTRY);
+            XFREE(crle->revoked, heap, DYNAMIC_TYPE_REVOKED);
             return -1;
         }
         XMEMCPY(crle->toBeSigned, buff + dcrl->certBegin, crle->tbsSz);
@@ -130,20 +268,16 @@ static int InitCRL_Entry(CRL_Entry* crle, DecodedCRL* dcrl, const byte* buff,
 /* Free all CRL Entry resources */
 static void FreeCRL_Entry(CRL_Entry* crle, void* heap)
 {
-    RevokedCert* tmp = crle->certs;
-    RevokedCert* next;
-
     WOLFSSL_ENTER("FreeCRL_Entry");
 
-    while (tmp) {
-        next = tmp->next;
-        XFREE(tmp, heap, DYNAMIC_TYPE_REVOKED);
-        tmp = next;
-    }
+    if (crle->revoked != NULL)
+        XFREE(crle->revoked, heap, DYNAMIC_TYPE_REVOKED);
     if (crle->signature != NULL)
         XFREE(crle->signature, heap, DYNAMIC_TYPE_REVOKED);
     if (crle->toBeSigned != NULL)
         XFREE(crle->toBeSigned, heap, DYNAMIC_TYPE_REVOKED);
+    if (crle->srcFile != NULL)
+        XFREE(crle->srcFile, heap, DYNAMIC_TYPE_CRL_ENTRY);
 
     (void)heap;
 }
@@ -153,15 +287,31 @@ static void FreeCRL_Entry(CRL_Entry* crle, void* heap)
 /* Free all CRL resources */
 void FreeCRL(WOLFSSL_CRL* crl, int dynamic)
 {
-    CRL_Entry* tmp = crl->crlList;
+    CRL_Entry* tmp;
 
     WOLFSSL_ENTER("FreeCRL");
+
+#ifdef HAVE_CRL_MONITOR
+    /* stop the monitor first, it reads the paths and list */
+    if (crl->tid != 0) {
+        WOLFSSL_MSG("stopping monitor thread");
+        if (StopMonitor(crl->mfd) == 0)
+            pthread_join(crl->tid, NULL);
+        else {
+            WOLFSSL_MSG("stop monitor failed");
+        }
+    }
+    pthread_cond_destroy(&crl->cond);
+#endif
+
     if (crl->monitors[0].path)
         XFREE(crl->monitors[0].path, crl->heap, DYNAMIC_TYPE_CRL_MONITOR);
 
     if (crl->monitors[1].path)
         XFREE(crl->monitors[1].path, crl->heap, DYNAMIC_TYPE_CRL_MONITOR);
 
+    /* read the list only once the monitor can no longer swap it */
+    tmp = crl->crlList;
     while(tmp) {
         CRL_Entry* next = tmp->next;
         FreeCRL_Entry(tmp, crl->heap);
@@ -169,28 +319,30 @@ void FreeCRL(WOLFSSL_CRL* crl, int dynamic)
         tmp = next;
     }
 
-#ifdef HAVE_CRL_MONITOR
-    if (crl->tid != 0) {
-        WOLFSSL_MSG("stopping monitor thread");
-        if (StopMonitor(crl->mfd) == 0)
-            pthread_join(crl->tid, NULL);
-        else {
-            WOLFSSL_MSG("stop monitor failed");
-        }
-    }
-    pthread_cond_destroy(&crl->cond);
-#endif
     wc_FreeMutex(&crl->crlLock);
     if (dynamic)   /* free self */
         XFREE(crl, crl->heap, DYNAMIC_TYPE_CRL);
 }
 
 
+/* Drop a reference to a CRL entry, call with crlLock held. Returns 1 when
+ * that was the last one and the caller should free it after unlocking. */
+static int CRL_EntryDecRef(CRL_Entry* crle)
+{
+    return --crle->refCount == 0;
+}
+
+
+/* Look up the CRL for cert's issuer and check cert against it. The entry is
+ * referenced while in use so crlLock is only held to find it, never while
+ * verifying or searching, and a reload can replace it at any time. */
 static int CheckCertCRLList(WOLFSSL_CRL* crl, DecodedCert* cert, int *pFoundEntry)
 {
     CRL_Entry* crle;
     int        foundEntry = 0;
     int        ret = 0;
+    int        verified;
+    int        doFree;
 
     if (wc_LockMutex(&crl->crlLock) != 0) {
         WOLFSSL_MSG("wc_LockMutex failed");
@@ -198,147 +350,145 @@ static int CheckCertCRLList(WOLFSSL_CRL* crl, DecodedCert* cert, int *pFoundEntr
     }
 
     crle = crl->crlList;
-
     while (crle) {
-        if (XMEMCMP(crle->issuerHash, cert->issuerHash, CRL_DIGEST_SIZE) == 0) {
-            int doNextDate = 1;
-
-            WOLFSSL_MSG("Found CRL Entry on list");
-
-            if (crle->verified == 0) {
-                Signer* ca;
-            #if !defined(NO_SKID) && defined(CRL_SKID_READY)
-                byte extAuthKeyId[KEYID_SIZE]
-            #endif
-                byte issuerHash[CRL_DIGEST_SIZE];
-                byte* tbs = NULL;
-                word32 tbsSz = crle->tbsSz;
-                byte* sig = NULL;
-                word32 sigSz = crle->signatureSz;
-                word32 sigOID = crle->signatureOID;
-                SignatureCtx sigCtx;
-
-                tbs = (byte*)XMALLOC(tbsSz, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
-                if (tbs == NULL) {
-                    wc_UnLockMutex(&crl->crlLock);
-                    return MEMORY_E;
-                }
-                sig = (byte*)XMALLOC(sigSz, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
-                if (sig == NULL) {
-                    XFREE(tbs, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
-                    wc_UnLockMutex(&crl->crlLock);
-                    return MEMORY_E;
-                }
+        if (XMEMCMP(crle->issuerHash, cert->issuerHash, CRL_DIGEST_SIZE) == 0)
+            break;
+        crle = crle->next;
+    }
+    if (crle == NULL) {
+        wc_UnLockMutex(&crl->crlLock);
+        *pFoundEntry = 0;
+        return 0;
+    }
 
-                XMEMCPY(tbs, crle->toBeSigned, tbsSz);
-                XMEMCPY(sig, crle->signature, sigSz);
-            #if !defined(NO_SKID) && defined(CRL_SKID_READY)
-                XMEMCMPY(extAuthKeyId, crle->extAuthKeyId,
-                                                          sizeof(extAuthKeyId));
-            #endif
-                XMEMCPY(issuerHash, crle->issuerHash, sizeof(issuerHash));
-
-                wc_UnLockMutex(&crl->crlLock);
-
-            #if !defined(NO_SKID) && defined(CRL_SKID_READY)
-                if (crle->extAuthKeyIdSet)
-                    ca = GetCA(crl->cm, extAuthKeyId);
-                if (ca == NULL)
-                    ca = GetCAByName(crl->cm, issuerHash);
-            #else /* NO_SKID */
-                ca = GetCA(crl->cm, issuerHash);
-            #endif /* NO_SKID */
-                if (ca == NULL) {
-                    XFREE(sig, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
-                    XFREE(tbs, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
-                    WOLFSSL_MSG("Did NOT find CRL issuer CA");
-                    return ASN_CRL_NO_SIGNER_E;
-                }
+    WOLFSSL_MSG("Found CRL Entry on list");
+    crle->refCount++;
+    verified = crle->verified;
+
+    if (verified == 0) {
+        Signer* ca = NULL;
+    #if !defined(NO_SKID) && defined(CRL_SKID_READY)
+        byte extAuthKeyId[KEYID_SIZE]
+    #endif
+        byte issuerHash[CRL_DIGEST_SIZE];
+        byte* tbs = NULL;
+        word32 tbsSz = crle->tbsSz;
+        byte* sig = NULL;
+        word32 sigSz = crle->signatureSz;
+        word32 sigOID = crle->signatureOID;
+        SignatureCtx sigCtx;
+
+        tbs = (byte*)XMALLOC(tbsSz, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
+        sig = (byte*)XMALLOC(sigSz, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
+        if (tbs != NULL && sig != NULL) {
+            XMEMCPY(tbs, crle->toBeSigned, tbsSz);
+            XMEMCPY(sig, crle->signature, sigSz);
+        #if !defined(NO_SKID) && defined(CRL_SKID_READY)
+            XMEMCMPY(extAuthKeyId, crle->extAuthKeyId, sizeof(extAuthKeyId));
+        #endif
+            XMEMCPY(issuerHash, crle->issuerHash, sizeof(issuerHash));
+        }
+        else {
+            ret = MEMORY_E;
+        }
 
+        wc_UnLockMutex(&crl->crlLock);
+
+        if (ret == 0) {
+        #if !defined(NO_SKID) && defined(CRL_SKID_READY)
+            if (crle->extAuthKeyIdSet)
+                ca = GetCA(crl->cm, extAuthKeyId);
+            if (ca == NULL)
+                ca = GetCAByName(crl->cm, issuerHash);
+        #else /* NO_SKID */
+            ca = GetCA(crl->cm, issuerHash);
+        #endif /* NO_SKID */
+            if (ca == NULL) {
+                WOLFSSL_MSG("Did NOT find CRL issuer CA");
+                ret = ASN_CRL_NO_SIGNER_E;
+            }
+            else {
                 ret = VerifyCRL_Signature(&sigCtx, tbs, tbsSz, sig, sigSz,
                                           sigOID, ca, crl->heap);
+            }
+        }
 
-                XFREE(sig, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
-                XFREE(tbs, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
+        if (sig != NULL)
+            XFREE(sig, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
+        if (tbs != NULL)
+            XFREE(tbs, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
 
-                if (wc_LockMutex(&crl->crlLock) != 0) {
-                    WOLFSSL_MSG("wc_LockMutex failed");
-                    return BAD_MUTEX_E;
-                }
+        if (wc_LockMutex(&crl->crlLock) != 0) {
+            WOLFSSL_MSG("wc_LockMutex failed");
+            return BAD_MUTEX_E;
+        }
 
-                crle = crl->crlList;
-                while (crle) {
-                    if (XMEMCMP(crle->issuerHash, cert->issuerHash,
-                        CRL_DIGEST_SIZE) == 0) {
+        if (ret != MEMORY_E && ret != ASN_CRL_NO_SIGNER_E &&
+                                                       crle->verified == 0) {
+            crle->verified = (ret == 0) ? 1 : ret;
+            XFREE(crle->toBeSigned, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
+            crle->toBeSigned = NULL;
+            XFREE(crle->signature, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
+            crle->signature = NULL;
+        }
+        verified = crle->verified;
+    }
+    else if (verified < 0) {
+        WOLFSSL_MSG("Cannot use CRL as it didn't verify");
+        ret = verified;
+    }
 
-                        if (ret == 0)
-                            crle->verified = 1;
-                        else
-                            crle->verified = ret;
+    wc_UnLockMutex(&crl->crlLock);
 
-                        XFREE(crle->toBeSigned, crl->heap,
-                                                        DYNAMIC_TYPE_CRL_ENTRY);
-                        crle->toBeSigned = NULL;
-                        XFREE(crle->signature, crl->heap,
-                                                        DYNAMIC_TYPE_CRL_ENTRY);
-                        crle->signature = NULL;
-                        break;
-                    }
-                    crle = crle->next;
-                }
-                if (crle == NULL || crle->verified < 0)
-                    break;
-            }
-            else if (crle->verified < 0) {
-                WOLFSSL_MSG("Cannot use CRL as it didn't verify");
-                ret = crle->verified;
-                break;
-            }
+    /* the entry's dates and serials don't change once it's on a list */
+    if (ret == 0 && verified > 0) {
+        int doNextDate = 1;
 
-            WOLFSSL_MSG("Checking next date validity");
+        WOLFSSL_MSG("Checking next date validity");
 
-            #ifdef WOLFSSL_NO_CRL_NEXT_DATE
-                if (crle->nextDateFormat == ASN_OTHER_TYPE)
-                    doNextDate = 0;  /* skip */
-            #endif
+        #ifdef WOLFSSL_NO_CRL_NEXT_DATE
+            if (crle->nextDateFormat == ASN_OTHER_TYPE)
+                doNextDate = 0;  /* skip */
+        #endif
 
-            if (doNextDate) {
-            #ifndef NO_ASN_TIME
-                if (!XVALIDATE_DATE(crle->nextDate,crle->nextDateFormat, AFTER)) {
-                    WOLFSSL_MSG("CRL next date is no longer valid");
-                    ret = ASN_AFTER_DATE_E;
-                }
-            #endif
-            }
-            if (ret == 0) {
-                foundEntry = 1;
+        if (doNextDate) {
+        #ifndef NO_ASN_TIME
+            if (!XVALIDATE_DATE(crle->nextDate,crle->nextDateFormat, AFTER)) {
+                WOLFSSL_MSG("CRL next date is no longer valid");
+                ret = ASN_AFTER_DATE_E;
             }
-            break;
+        #endif
+        }
+        if (ret == 0) {
+            foundEntry = 1;
         }
-        crle = crle->next;
     }
 
     if (foundEntry) {
-        RevokedCert* rc = crle->certs;
-
-        while (rc) {
-            if (rc->serialSz == cert->serialSz &&
-                   XMEMCMP(rc->serialNumber, cert->serial, rc->serialSz) == 0) {
-                WOLFSSL_MSG("Cert revoked");
-                ret = CRL_CERT_REVOKED;
-                break;
-            }
-            rc = rc->next;
+        if (FindRevokedSerial(crle, cert->serial, cert->serialSz)) {
+            WOLFSSL_MSG("Cert revoked");
+            ret = CRL_CERT_REVOKED;
         }
     }
 
+    if (wc_LockMutex(&crl->crlLock) != 0) {
+        WOLFSSL_MSG("wc_LockMutex failed");
+        return BAD_MUTEX_E;
+    }
+    doFree = CRL_EntryDecRef(crle);
     wc_UnLockMutex(&crl->crlLock);
 
+    if (doFree) {
+        FreeCRL_Entry(crle, crl->heap);
+        XFREE(crle, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
+    }
+
     *pFoundEntry = foundEntry;
 
     return ret;
 }
 
+
 /* Is the cert ok with CRL, return 0 on success */
 int CheckCertCRL(WOLFSSL_CRL* crl, DecodedCert* cert)
 {
@@ -349,6 +499,17 @@ int CheckCertCRL(WOLFSSL_CRL* crl, DecodedCert* cert)
 
     ret = CheckCertCRLList(crl, cert, &foundEntry);
 
+#ifdef WOLFSSL_ASN_LAZY_EXT
+    /* distribution points are needed to find the missing CRL */
+    if (foundEntry == 0) {
+        int err = DecodeCertLazyExt(cert, CERT_LAZY_CRL_DIST);
+        if (err < 0) {
+            WOLFSSL_MSG("Unable to decode CRL distribution points");
+            return err;
+        }
+    }
+#endif
+
 #ifdef HAVE_CRL_IO
     if (foundEntry == 0) {
         /* perform embedded lookup */
@@ -423,6 +584,8 @@ static int AddCRL(WOLFSSL_CRL* crl, DecodedCRL* dcrl, const byte* buff,
     crl->crlList = crle;
     wc_UnLockMutex(&crl->crlLock);
 
+    CM_VerifyCacheInvalidate(crl->cm);
+
     return 0;
 }
 
@@ -516,12 +679,181 @@ int wolfSSL_X509_STORE_add_crl(WOLFSSL_X509_STORE *store, WOLFSSL_X509_CRL *newc
     newcrl->crlList = NULL;
     wc_UnLockMutex(&crl->crlLock);
 
+    CM_VerifyCacheInvalidate(crl->cm);
+
     WOLFSSL_LEAVE("wolfSSL_X509_STORE_add_crl", WOLFSSL_SUCCESS);
 
     return WOLFSSL_SUCCESS;
 }
 #endif
 
+#if !defined(NO_FILESYSTEM) && !defined(NO_WOLFSSL_DIR)
+
+/* Does file name have an extension LoadCRL takes for type, 1 on match */
+static int CRL_FileTypeMatch(const char* name, int type)
+{
+    if (type == WOLFSSL_FILETYPE_PEM) {
+        if (XSTRSTR(name, ".pem") == NULL) {
+            WOLFSSL_MSG("not .pem file, skipping");
+            return 0;
+        }
+    }
+    else {
+        if (XSTRSTR(name, ".der") == NULL &&
+            XSTRSTR(name, ".crl") == NULL)
+        {
+            WOLFSSL_MSG("not .der or .crl file, skipping");
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+/* Unlink a list of CRL entries, freeing those no check is still using.
+ * Entries in use are freed by the last CheckCertCRLList to release them. */
+static int ReleaseCRL_List(WOLFSSL_CRL* crl, CRL_Entry* list)
+{
+    CRL_Entry* toFree = NULL;
+
+    if (list == NULL)
+        return 0;
+
+    if (wc_LockMutex(&crl->crlLock) != 0) {
+        WOLFSSL_MSG("wc_LockMutex failed");
+        return BAD_MUTEX_E;
+    }
+    while (list) {
+        CRL_Entry* next = list->next;
+
+        list->next = NULL;
+        if (CRL_EntryDecRef(list)) {
+            list->next = toFree;
+            toFree = list;
+        }
+        list = next;
+    }
+    wc_UnLockMutex(&crl->crlLock);
+
+    while (toFree) {
+        CRL_Entry* next = toFree->next;
+        FreeCRL_Entry(toFree, crl->heap);
+        XFREE(toFree, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
+        toFree = next;
+    }
+
+    return 0;
+}
+
+
+/* Replace the entries loaded from file with newList, which may be NULL to
+ * just remove them. Entries still in use by a check are released, not freed,
+ * so this never waits on or disturbs an in-flight handshake. 0 on success */
+static int ReplaceCRLFile(WOLFSSL_CRL* crl, const char* file,
+                          CRL_Entry* newList)
+{
+    CRL_Entry*  old = NULL;
+    CRL_Entry** prev;
+    CRL_Entry*  crle;
+    word32      fileSz = (word32)XSTRLEN(file) + 1;
+
+    if (wc_LockMutex(&crl->crlLock) != 0) {
+        WOLFSSL_MSG("wc_LockMutex failed");
+        return BAD_MUTEX_E;
+    }
+
+    prev = &crl->crlList;
+    while ((crle = *prev) != NULL) {
+        if (crle->srcFile != NULL &&
+                                XSTRNCMP(crle->srcFile, file, fileSz) == 0) {
+            *prev = crle->next;
+            crle->next = old;
+            old = crle;
+        }
+        else {
+            prev = &crle->next;
+        }
+    }
+
+    if (newList != NULL) {
+        crle = newList;
+        while (crle->next)
+            crle = crle->next;
+        crle->next = crl->crlList;
+        crl->crlList = newList;
+    }
+
+    wc_UnLockMutex(&crl->crlLock);
+
+    if (old != NULL || newList != NULL)
+        CM_VerifyCacheInvalidate(crl->cm);
+
+    return ReleaseCRL_List(crl, old);
+}
+
+
+/* Parse CRL file off to the side and swap its entries in for the ones the
+ * file had before. On a parse failure the old entries are kept.
+ * WOLFSSL_SUCCESS on ok */
+static int LoadCRLFile(WOLFSSL_CRL* crl, const char* file, int type)
+{
+    int        ret;
+    word32     fileSz;
+    CRL_Entry* crle;
+#ifdef WOLFSSL_SMALL_STACK
+    WOLFSSL_CRL* tmp;
+#else
+    WOLFSSL_CRL tmp[1];
+#endif
+
+#ifdef WOLFSSL_SMALL_STACK
+    tmp = (WOLFSSL_CRL*)XMALLOC(sizeof(WOLFSSL_CRL), NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    if (tmp == NULL)
+        return MEMORY_E;
+#endif
+
+    if (InitCRL(tmp, crl->cm) < 0) {
+        WOLFSSL_MSG("Init tmp CRL failed");
+#ifdef WOLFSSL_SMALL_STACK
+        XFREE(tmp, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+        return -1;
+    }
+
+    ret = ProcessFile(NULL, file, type, CRL_TYPE, NULL, 0, tmp, VERIFY);
+    if (ret == WOLFSSL_SUCCESS && tmp->crlList == NULL)
+        ret = -1;
+
+    /* tag entries with their file, tmp is private so no lock needed */
+    fileSz = (word32)XSTRLEN(file) + 1;
+    for (crle = tmp->crlList; ret == WOLFSSL_SUCCESS && crle != NULL;
+                                                           crle = crle->next) {
+        crle->srcFile = (char*)XMALLOC(fileSz, crl->heap,
+                                                        DYNAMIC_TYPE_CRL_ENTRY);
+        if (crle->srcFile == NULL)
+            ret = MEMORY_E;
+        else
+            XMEMCPY(crle->srcFile, file, fileSz);
+    }
+
+    if (ret == WOLFSSL_SUCCESS) {
+        if (ReplaceCRLFile(crl, file, tmp->crlList) == 0)
+            tmp->crlList = NULL;  /* now owned by crl */
+        else
+            ret = -1;
+    }
+
+    FreeCRL(tmp, 0);
+#ifdef WOLFSSL_SMALL_STACK
+    XFREE(tmp, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    return ret;
+}
+
+#endif /* !NO_FILESYSTEM && !NO_WOLFSSL_DIR */
+
 #ifdef HAVE_CRL_MONITOR
 
 
@@ -548,11 +880,13 @@ static int SignalSetup(WOLFSSL_CRL* crl, int status)
 }
 
 
-/* read in new CRL entries and save new list */
+/* read in all CRL entries and save new list, used when we can't tell which
+ * files changed */
 static int SwapLists(WOLFSSL_CRL* crl)
 {
     int        ret;
     CRL_Entry* newList;
+    CRL_Entry* oldList;
 #ifdef WOLFSSL_SMALL_STACK
     WOLFSSL_CRL* tmp;
 #else
@@ -609,11 +943,16 @@ static int SwapLists(WOLFSSL_CRL* crl)
     newList = tmp->crlList;
 
     /* swap lists */
-    tmp->crlList  = crl->crlList;
+    tmp->crlList  = NULL;
+    oldList = crl->crlList;
     crl->crlList = newList;
 
     wc_UnLockMutex(&crl->crlLock);
 
+    CM_VerifyCacheInvalidate(crl->cm);
+
+    /* checks still using old entries free them when done */
+    ReleaseCRL_List(crl, oldList);
     FreeCRL(tmp, 0);
 
 #ifdef WOLFSSL_SMALL_STACK
@@ -794,11 +1133,45 @@ static int StopMonitor(int mfd)
 }
 
 
+/* Reload or drop the one CRL file an inotify event is about */
+static void ProcessNotifyEvent(WOLFSSL_CRL* crl, CRL_Monitor* mon,
+                               word32 mask, const char* name)
+{
+    char   file[MAX_FILENAME_SZ];
+    word32 pathLen = (word32)XSTRLEN(mon->path);
+    word32 nameLen = (word32)XSTRLEN(name);
+
+    if (pathLen + nameLen + 2 > MAX_FILENAME_SZ) {
+        WOLFSSL_MSG("CRL file name too long, skipping");
+        return;
+    }
+    /* same form wc_ReadDirFirst gave LoadCRL so the file tags match */
+    XMEMCPY(file, mon->path, pathLen);
+    file[pathLen] = '/';
+    XMEMCPY(file + pathLen + 1, name, nameLen + 1);
+
+    if (!CRL_FileTypeMatch(file, mon->type))
+        return;
+
+    if (mask & (IN_DELETE | IN_MOVED_FROM)) {
+        WOLFSSL_MSG("CRL file removed, dropping its entries");
+        if (ReplaceCRLFile(crl, file, NULL) != 0) {
+            WOLFSSL_MSG("ReplaceCRLFile problem, continue");
+        }
+    }
+    else if (LoadCRLFile(crl, file, mon->type) != WOLFSSL_SUCCESS) {
+        WOLFSSL_MSG("CRL file reload failed, keeping old entries");
+    }
+}
+
+
 /* linux monitoring */
 static void* DoMonitor(void* arg)
 {
     int         notifyFd;
     int         wd  = -1;
+    int         wdPEM = -1;
+    int         wdDER = -1;
     WOLFSSL_CRL* crl = (WOLFSSL_CRL*)arg;
 #ifdef WOLFSSL_SMALL_STACK
     char*       buff;
@@ -824,8 +1197,10 @@ static void* DoMonitor(void* arg)
     }
 
     if (crl->monitors[0].path) {
-        wd = inotify_add_watch(notifyFd, crl->monitors[0].path, IN_CLOSE_WRITE |
-                                                                IN_DELETE);
+        wdPEM = inotify_add_watch(notifyFd, crl->monitors[0].path,
+                           IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_TO |
+                           IN_MOVED_FROM);
+        wd = wdPEM;
         if (wd < 0) {
             WOLFSSL_MSG("PEM notify add watch failed");
             close(crl->mfd);
@@ -836,8 +1211,10 @@ static void* DoMonitor(void* arg)
     }
 
     if (crl->monitors[1].path) {
-        wd = inotify_add_watch(notifyFd, crl->monitors[1].path, IN_CLOSE_WRITE |
-                                                                IN_DELETE);
+        wdDER = inotify_add_watch(notifyFd, crl->monitors[1].path,
+                           IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_TO |
+                           IN_MOVED_FROM);
+        wd = wdDER;
         if (wd < 0) {
             WOLFSSL_MSG("DER notify add watch failed");
             close(crl->mfd);
@@ -870,6 +1247,8 @@ static void* DoMonitor(void* arg)
         fd_set readfds;
         int    result;
         int    length;
+        int    idx;
+        int    swap = 0;
 
         FD_ZERO(&readfds);
         FD_SET(notifyFd, &readfds);
@@ -895,7 +1274,32 @@ static void* DoMonitor(void* arg)
             continue;
         }
 
-        if (SwapLists(crl) < 0) {
+        /* only reparse the files the events name */
+        for (idx = 0; idx + (int)sizeof(struct inotify_event) <= length; ) {
+            struct inotify_event ev;
+            const char* name = buff + idx + sizeof(struct inotify_event);
+
+            /* copy header out, buff has no alignment guarantee */
+            XMEMCPY(&ev, buff + idx, sizeof(ev));
+            idx += (int)sizeof(struct inotify_event) + (int)ev.len;
+            if (idx > length)
+                break;
+
+            if (ev.mask & IN_Q_OVERFLOW) {
+                WOLFSSL_MSG("notify queue overflow, reloading all");
+                swap = 1;
+                break;
+            }
+            if (ev.len == 0 || name[0] == '\0')
+                continue;
+
+            if (ev.wd == wdPEM)
+                ProcessNotifyEvent(crl, &crl->monitors[0], ev.mask, name);
+            if (ev.wd == wdDER)
+                ProcessNotifyEvent(crl, &crl->monitors[1], ev.mask, name);
+        }
+
+        if (swap && SwapLists(crl) < 0) {
             WOLFSSL_MSG("SwapLists problem, continue");
         }
     }
@@ -1007,24 +1411,9 @@ int LoadCRL(WOLFSSL_CRL* crl, const char* path, int type, int monitor)
     /* try to load each regular file in path */
     ret = wc_ReadDirFirst(readCtx, path, &name);
     while (ret == 0 && name) {
-        int skip = 0;
-        if (type == WOLFSSL_FILETYPE_PEM) {
-            if (XSTRSTR(name, ".pem") == NULL) {
-                WOLFSSL_MSG("not .pem file, skipping");
-                skip = 1;
-            }
-        }
-        else {
-            if (XSTRSTR(name, ".der") == NULL &&
-                XSTRSTR(name, ".crl") == NULL)
-            {
-                WOLFSSL_MSG("not .der or .crl file, skipping");
-                skip = 1;
-            }
-        }
-
-        if (!skip && ProcessFile(NULL, name, type, CRL_TYPE, NULL, 0, crl,
-                                 VERIFY) != WOLFSSL_SUCCESS) {
+        /* replaces entries from an earlier load of the same file */
+        if (CRL_FileTypeMatch(name, type) &&
+                              LoadCRLFile(crl, name, type) != WOLFSSL_SUCCESS) {
             WOLFSSL_MSG("CRL file load failed, continuing");
         }
 
@@ -1801,6 +1801,31 @@ void SSL_CtxResourceFree(WOLFSSL_CTX* ctx)
     wolfEventQueue_Free(&ctx->event_queue);
 #endif /* HAVE_WOLF_EVENT */
 
+#ifdef WOLFSSL_EARLY_DATA_ANTI_REPLAY
+    if (ctx->antiReplay != NULL) {
+        FreeAntiReplayCache(ctx->antiReplay, ctx->heap);
+        ctx->antiReplay = NULL;
+    }
+#endif
+#ifdef WOLFSSL_KEY_SHARE_CACHE
+    if (ctx->keyShareCache != NULL) {
+        FreeKeyShareCache(ctx->keyShareCache, ctx->heap);
+        ctx->keyShareCache = NULL;
+    }
+#endif
+#ifdef WOLFSSL_KEY_SHARE_POOL
+    if (ctx->keySharePool != NULL) {
+        FreeKeySharePool(ctx->keySharePool, ctx->heap);
+        ctx->keySharePool = NULL;
+    }
+#endif
+#ifdef WOLFSSL_SNI_CERT_STORE
+    if (ctx->sniCertStore != NULL) {
+        FreeSNICertStore(ctx->sniCertStore, ctx->heap);
+        ctx->sniCertStore = NULL;
+    }
+#endif
+
 #ifdef WOLFSSL_STATIC_MEMORY
     if (ctx->onHeap == 1) {
         XFREE(ctx->method, ctx->heap, DYNAMIC_TYPE_METHOD);
@@ -1843,6 +1868,9 @@ void SSL_CtxResourceFree(WOLFSSL_CTX* ctx)
         }
     #endif /* KEEP_OUR_CERT */
     FreeDer(&ctx->certChain);
+    #ifdef WOLFSSL_CERT_MSG_CACHE
+        FreeCertMsgCache(ctx);
+    #endif
     wolfSSL_CertManagerFree(ctx->cm);
     ctx->cm = NULL;
     #ifdef OPENSSL_EXTRA
@@ -5044,6 +5072,38 @@ int SetSSL_CTX(WOLFSSL* ssl, WOLFSSL_CTX* ctx, int writeDup)
     return ret;
 }
 
+/* Mark the hashes in mask as copied for each Finished and CertificateVerify
+ * so that a device keeps their data */
+static void SetHandshakeHashFlags(HS_Hashes* hs, word32 mask)
+{
+#if defined(WOLFSSL_HASH_FLAGS) || defined(WOLF_CRYPTO_CB)
+#ifndef NO_OLD_TLS
+    #ifndef NO_MD5
+    if (mask & HS_HASH_MD5)
+        wc_Md5SetFlags(&hs->hashMd5, WC_HASH_FLAG_WILLCOPY);
+    #endif
+    #ifndef NO_SHA
+    if (mask & HS_HASH_SHA)
+        wc_ShaSetFlags(&hs->hashSha, WC_HASH_FLAG_WILLCOPY);
+    #endif
+#endif /* !NO_OLD_TLS */
+    #ifndef NO_SHA256
+    if (mask & HS_HASH_SHA256)
+        wc_Sha256SetFlags(&hs->hashSha256, WC_HASH_FLAG_WILLCOPY);
+    #endif
+    #ifdef WOLFSSL_SHA384
+    if (mask & HS_HASH_SHA384)
+        wc_Sha384SetFlags(&hs->hashSha384, WC_HASH_FLAG_WILLCOPY);
+    #endif
+    #ifdef WOLFSSL_SHA512
+    if (mask & HS_HASH_SHA512)
+        wc_Sha512SetFlags(&hs->hashSha512, WC_HASH_FLAG_WILLCOPY);
+    #endif
+#endif
+    (void)hs;
+    (void)mask;
+}
+
 int InitHandshakeHashes(WOLFSSL* ssl)
 {
     int ret;
@@ -5061,48 +5121,39 @@ int InitHandshakeHashes(WOLFSSL* ssl)
         return MEMORY_E;
     }
     XMEMSET(ssl->hsHashes, 0, sizeof(HS_Hashes));
+#ifndef WOLFSSL_LAZY_HS_HASH
+    ssl->hsHashes->hashMask = HS_HASH_ALL;
+#endif
 
 #ifndef NO_OLD_TLS
 #ifndef NO_MD5
     ret = wc_InitMd5_ex(&ssl->hsHashes->hashMd5, ssl->heap, ssl->devId);
     if (ret != 0)
         return ret;
-    #if defined(WOLFSSL_HASH_FLAGS) || defined(WOLF_CRYPTO_CB)
-        wc_Md5SetFlags(&ssl->hsHashes->hashMd5, WC_HASH_FLAG_WILLCOPY);
-    #endif
 #endif
 #ifndef NO_SHA
     ret = wc_InitSha_ex(&ssl->hsHashes->hashSha, ssl->heap, ssl->devId);
     if (ret != 0)
         return ret;
-    #if defined(WOLFSSL_HASH_FLAGS) || defined(WOLF_CRYPTO_CB)
-        wc_ShaSetFlags(&ssl->hsHashes->hashSha, WC_HASH_FLAG_WILLCOPY);
-    #endif
 #endif
 #endif /* !NO_OLD_TLS */
 #ifndef NO_SHA256
     ret = wc_InitSha256_ex(&ssl->hsHashes->hashSha256, ssl->heap, ssl->devId);
     if (ret != 0)
         return ret;
-    #if defined(WOLFSSL_HASH_FLAGS) || defined(WOLF_CRYPTO_CB)
-        wc_Sha256SetFlags(&ssl->hsHashes->hashSha256, WC_HASH_FLAG_WILLCOPY);
-    #endif
 #endif
 #ifdef WOLFSSL_SHA384
     ret = wc_InitSha384_ex(&ssl->hsHashes->hashSha384, ssl->heap, ssl->devId);
     if (ret != 0)
         return ret;
-    #if defined(WOLFSSL_HASH_FLAGS) || defined(WOLF_CRYPTO_CB)
-        wc_Sha384SetFlags(&ssl->hsHashes->hashSha384, WC_HASH_FLAG_WILLCOPY);
-    #endif
 #endif
 #ifdef WOLFSSL_SHA512
     ret = wc_InitSha512_ex(&ssl->hsHashes->hashSha512, ssl->heap, ssl->devId);
     if (ret != 0)
         return ret;
-    #if defined(WOLFSSL_HASH_FLAGS) || defined(WOLF_CRYPTO_CB)
-        wc_Sha512SetFlags(&ssl->hsHashes->hashSha512, WC_HASH_FLAG_WILLCOPY);
-    #endif
+#endif
+#ifndef WOLFSSL_LAZY_HS_HASH
+    SetHandshakeHashFlags(ssl->hsHashes, HS_HASH_ALL);
 #endif
 
     return ret;
@@ -5134,6 +5185,10 @@ void FreeHandshakeHashes(WOLFSSL* ssl)
             ssl->hsHashes->messages = NULL;
          }
     #endif
+    #ifdef WOLFSSL_LAZY_HS_HASH
+        if (ssl->hsHashes->transcript != NULL)
+            XFREE(ssl->hsHashes->transcript, ssl->heap, DYNAMIC_TYPE_HASHES);
+    #endif
 
         XFREE(ssl->hsHashes, ssl->heap, DYNAMIC_TYPE_HASHES);
         ssl->hsHashes = NULL;
@@ -5824,6 +5879,9 @@ void SSL_ResourceFree(WOLFSSL* ssl)
         ForceZero(&ssl->clientSecret, sizeof(ssl->clientSecret));
         ForceZero(&ssl->serverSecret, sizeof(ssl->serverSecret));
     }
+#ifdef WOLFSSL_HMAC_MIDSTATE
+    FreeTls13HkdfKeys(ssl);
+#endif
 #endif
 
 #ifndef NO_DH
@@ -5938,6 +5996,9 @@ void SSL_ResourceFree(WOLFSSL* ssl)
     }
 #endif
 #endif /* HAVE_TLS_EXTENSIONS */
+#ifdef HAVE_CERT_COMPRESSION
+    XFREE(ssl->certDecomp.buffer, ssl->heap, DYNAMIC_TYPE_CERT);
+#endif
 #if defined(WOLFSSL_APACHE_MYNEWT) && !defined(WOLFSSL_LWIP)
     if (ssl->mnCtx) {
         mynewt_ctx_clear(ssl->mnCtx);
@@ -6047,6 +6108,10 @@ void FreeHandshakeResources(WOLFSSL* ssl)
         FreeHandshakeHashes(ssl);
     }
 
+#if defined(WOLFSSL_TLS13) && defined(WOLFSSL_HMAC_MIDSTATE)
+    FreeTls13HkdfKeys(ssl);
+#endif
+
     /* RNG */
     if (ssl->options.tls1_1 == 0
 #ifndef WOLFSSL_AEAD_ONLY
@@ -7111,53 +7176,277 @@ static int Ed25519Update(WOLFSSL* ssl, const byte* data, int sz)
 }
 #endif /* HAVE_ED25519 && !WOLFSSL_NO_CLIENT_AUTH */
 
-#ifndef NO_CERTS
-int HashOutputRaw(WOLFSSL* ssl, const byte* output, int sz)
+#ifdef WOLFSSL_LAZY_HS_HASH
+/* Feed the buffered messages into the hashes in mask and hash directly from
+ * now on */
+static int HashTranscript(WOLFSSL* ssl, word32 mask)
 {
-    int ret = 0;
+    HS_Hashes* hs = ssl->hsHashes;
+    int        ret = 0;
+
+    hs->hashMask = mask;
+    SetHandshakeHashFlags(hs, mask);
+    if (hs->transcriptLen > 0)
+        ret = HashRaw(ssl, hs->transcript, (int)hs->transcriptLen);
+
+    if (hs->transcript != NULL)
+        XFREE(hs->transcript, ssl->heap, DYNAMIC_TYPE_HASHES);
+    hs->transcript = NULL;
+    hs->transcriptSz = 0;
+    hs->transcriptLen = 0;
+
+    return ret;
+}
+#endif /* WOLFSSL_LAZY_HS_HASH */
 
-    (void)output;
-    (void)sz;
+
+/* Update the handshake hashes in use with data. Until the cipher suite is
+ * negotiated the data is only buffered. */
+int HashRaw(WOLFSSL* ssl, const byte* data, int sz)
+{
+    int    ret = 0;
+    word32 mask;
 
     if (ssl->hsHashes == NULL)
         return BAD_FUNC_ARG;
 
-#ifdef HAVE_FUZZER
-    if (ssl->fuzzerCb)
-        ssl->fuzzerCb(ssl, output, sz, FUZZ_HASH, ssl->fuzzerCtx);
+#ifdef WOLFSSL_LAZY_HS_HASH
+    if (ssl->hsHashes->hashMask == 0) {
+        HS_Hashes* hs = ssl->hsHashes;
+
+        if (hs->transcriptLen + sz > hs->transcriptSz) {
+            word32 newSz = hs->transcriptSz * 2;
+            byte*  tmp;
+
+            if (newSz < hs->transcriptLen + sz)
+                newSz = hs->transcriptLen + sz;
+            tmp = (byte*)XREALLOC(hs->transcript, newSz, ssl->heap,
+                                                           DYNAMIC_TYPE_HASHES);
+            if (tmp == NULL)
+                return MEMORY_E;
+            hs->transcript = tmp;
+            hs->transcriptSz = newSz;
+        }
+        XMEMCPY(hs->transcript + hs->transcriptLen, data, sz);
+        hs->transcriptLen += sz;
+
+        return 0;
+    }
 #endif
+
+    mask = ssl->hsHashes->hashMask;
+    if (!IsAtLeastTLSv1_2(ssl))
+        mask &= HS_HASH_MD5 | HS_HASH_SHA;
+
 #ifndef NO_OLD_TLS
     #ifndef NO_SHA
-        wc_ShaUpdate(&ssl->hsHashes->hashSha, output, sz);
+    if (mask & HS_HASH_SHA)
+        wc_ShaUpdate(&ssl->hsHashes->hashSha, data, sz);
     #endif
     #ifndef NO_MD5
-        wc_Md5Update(&ssl->hsHashes->hashMd5, output, sz);
+    if (mask & HS_HASH_MD5)
+        wc_Md5Update(&ssl->hsHashes->hashMd5, data, sz);
     #endif
 #endif /* NO_OLD_TLS */
-
-    if (IsAtLeastTLSv1_2(ssl)) {
-    #ifndef NO_SHA256
-        ret = wc_Sha256Update(&ssl->hsHashes->hashSha256, output, sz);
+#ifndef NO_SHA256
+    if (mask & HS_HASH_SHA256) {
+        ret = wc_Sha256Update(&ssl->hsHashes->hashSha256, data, sz);
         if (ret != 0)
             return ret;
-    #endif
-    #ifdef WOLFSSL_SHA384
-        ret = wc_Sha384Update(&ssl->hsHashes->hashSha384, output, sz);
+    }
+#endif
+#ifdef WOLFSSL_SHA384
+    if (mask & HS_HASH_SHA384) {
+        ret = wc_Sha384Update(&ssl->hsHashes->hashSha384, data, sz);
         if (ret != 0)
             return ret;
-    #endif
-    #ifdef WOLFSSL_SHA512
-        ret = wc_Sha512Update(&ssl->hsHashes->hashSha512, output, sz);
+    }
+#endif
+#ifdef WOLFSSL_SHA512
+    if (mask & HS_HASH_SHA512) {
+        ret = wc_Sha512Update(&ssl->hsHashes->hashSha512, data, sz);
         if (ret != 0)
             return ret;
+    }
+#endif
+
+    (void)data;
+    (void)sz;
+    (void)mask;
+
+    return ret;
+}
+
+
+/* Once the version and cipher suite are negotiated only the hashes that can
+ * still be asked for are kept: MD5 and SHA-1 before TLS v1.2, the cipher
+ * suite's hash for TLS v1.3 and the PRF hash for TLS v1.2 unless a
+ * CertificateVerify, signed over any hash, may be sent or received. */
+int SelectHandshakeHashes(WOLFSSL* ssl)
+{
+#ifdef WOLFSSL_LAZY_HS_HASH
+    word32 mask = HS_HASH_ALL;
+    int    certVerify;
+
+    if (ssl->hsHashes == NULL)
+        return BAD_FUNC_ARG;
+    if (ssl->hsHashes->hashMask != 0)
+        return 0;  /* already picked */
+
+    if (!IsAtLeastTLSv1_2(ssl)) {
+        mask = HS_HASH_MD5 | HS_HASH_SHA;
+    }
+    else if (IsAtLeastTLSv1_3(ssl->version)) {
+        switch (ssl->specs.mac_algorithm) {
+            case sha256_mac:
+                mask = HS_HASH_SHA256;
+                break;
+            case sha384_mac:
+                mask = HS_HASH_SHA384;
+                break;
+            case sha512_mac:
+                mask = HS_HASH_SHA512;
+                break;
+        }
+    }
+    else {
+        if (ssl->options.side == WOLFSSL_SERVER_END) {
+            certVerify = ssl->options.verifyPeer && !ssl->options.resuming;
+        }
+        else {
+            certVerify = ssl->buffers.certificate != NULL &&
+                         ssl->buffers.certificate->buffer != NULL;
+        #if defined(OPENSSL_ALL) || defined(OPENSSL_EXTRA) || \
+            defined(WOLFSSL_NGINX) || defined (WOLFSSL_HAPROXY)
+            /* certificate may be loaded on CertificateRequest */
+            if (ssl->ctx->CBClientCert != NULL)
+                certVerify = 1;
+        #endif
+        }
+
+        if (!certVerify) {
+            mask = (ssl->specs.mac_algorithm == sha384_mac) ? HS_HASH_SHA384 :
+                                                              HS_HASH_SHA256;
+        }
+    }
+
+    return HashTranscript(ssl, mask);
+#else
+    (void)ssl;
+    return 0;
+#endif
+}
+
+
+/* Hash any buffered messages into all hashes, for a hash wanted before the
+ * cipher suite is negotiated */
+int FlushHandshakeHashes(WOLFSSL* ssl)
+{
+#ifdef WOLFSSL_LAZY_HS_HASH
+    if (ssl->hsHashes == NULL)
+        return BAD_FUNC_ARG;
+    if (ssl->hsHashes->hashMask == 0)
+        return HashTranscript(ssl, HS_HASH_ALL);
+#endif
+    (void)ssl;
+    return 0;
+}
+
+
+/* Get the hash of the handshake messages so far with the hash of macAlgo.
+ * Buffered messages are hashed on their own and stay buffered.
+ * returns the size of the hash, or a negative error */
+int GetHandshakeHash(WOLFSSL* ssl, int macAlgo, byte* hash)
+{
+    int ret = BAD_FUNC_ARG;
+#ifdef WOLFSSL_LAZY_HS_HASH
+    int buffered;
+#endif
+
+    if (ssl->hsHashes == NULL)
+        return BAD_FUNC_ARG;
+
+#ifdef WOLFSSL_LAZY_HS_HASH
+    buffered = (ssl->hsHashes->hashMask == 0);
+#endif
+
+    switch (macAlgo) {
+    #ifndef NO_SHA256
+        case sha256_mac:
+        #ifdef WOLFSSL_LAZY_HS_HASH
+            if (buffered)
+                ret = wc_Sha256Hash(ssl->hsHashes->transcript,
+                                    ssl->hsHashes->transcriptLen, hash);
+            else
+        #endif
+                ret = wc_Sha256GetHash(&ssl->hsHashes->hashSha256, hash);
+            if (ret == 0)
+                ret = WC_SHA256_DIGEST_SIZE;
+            break;
     #endif
-    #if !defined(WOLFSSL_NO_CLIENT_AUTH) && defined(HAVE_ED25519) && \
+    #ifdef WOLFSSL_SHA384
+        case sha384_mac:
+        #ifdef WOLFSSL_LAZY_HS_HASH
+            if (buffered)
+                ret = wc_Sha384Hash(ssl->hsHashes->transcript,
+                                    ssl->hsHashes->transcriptLen, hash);
+            else
+        #endif
+                ret = wc_Sha384GetHash(&ssl->hsHashes->hashSha384, hash);
+            if (ret == 0)
+                ret = WC_SHA384_DIGEST_SIZE;
+            break;
+    #endif
+    #ifdef WOLFSSL_SHA512
+        case sha512_mac:
+        #ifdef WOLFSSL_LAZY_HS_HASH
+            if (buffered)
+                ret = wc_Sha512Hash(ssl->hsHashes->transcript,
+                                    ssl->hsHashes->transcriptLen, hash);
+            else
+        #endif
+                ret = wc_Sha512GetHash(&ssl->hsHashes->hashSha512, hash);
+            if (ret == 0)
+                ret = WC_SHA512_DIGEST_SIZE;
+            break;
+    #endif
+        default:
+            break;
+    }
+
+    (void)hash;
+
+    return ret;
+}
+
+
+#ifndef NO_CERTS
+int HashOutputRaw(WOLFSSL* ssl, const byte* output, int sz)
+{
+    int ret = 0;
+
+    (void)output;
+    (void)sz;
+
+    if (ssl->hsHashes == NULL)
+        return BAD_FUNC_ARG;
+
+#ifdef HAVE_FUZZER
+    if (ssl->fuzzerCb)
+        ssl->fuzzerCb(ssl, output, sz, FUZZ_HASH, ssl->fuzzerCtx);
+#endif
+    ret = HashRaw(ssl, output, sz);
+    if (ret != 0)
+        return ret;
+
+#if !defined(WOLFSSL_NO_CLIENT_AUTH) && defined(HAVE_ED25519) && \
                                                 !defined(NO_ED25519_CLIENT_AUTH)
+    if (IsAtLeastTLSv1_2(ssl)) {
         ret = Ed25519Update(ssl, output, sz);
         if (ret != 0)
             return ret;
-    #endif
     }
+#endif
 
     return ret;
 }
@@ -7186,38 +7475,18 @@ int HashOutput(WOLFSSL* ssl, const byte* output, int sz, int ivSz)
         sz  -= DTLS_RECORD_EXTRA;
     }
 #endif
-#ifndef NO_OLD_TLS
-    #ifndef NO_SHA
-        wc_ShaUpdate(&ssl->hsHashes->hashSha, adj, sz);
-    #endif
-    #ifndef NO_MD5
-        wc_Md5Update(&ssl->hsHashes->hashMd5, adj, sz);
-    #endif
-#endif
+    ret = HashRaw(ssl, adj, sz);
+    if (ret != 0)
+        return ret;
 
-    if (IsAtLeastTLSv1_2(ssl)) {
-    #ifndef NO_SHA256
-        ret = wc_Sha256Update(&ssl->hsHashes->hashSha256, adj, sz);
-        if (ret != 0)
-            return ret;
-    #endif
-    #ifdef WOLFSSL_SHA384
-        ret = wc_Sha384Update(&ssl->hsHashes->hashSha384, adj, sz);
-        if (ret != 0)
-            return ret;
-    #endif
-    #ifdef WOLFSSL_SHA512
-        ret = wc_Sha512Update(&ssl->hsHashes->hashSha512, adj, sz);
-        if (ret != 0)
-            return ret;
-    #endif
-    #if !defined(WOLFSSL_NO_CLIENT_AUTH) && defined(HAVE_ED25519) && \
+#if !defined(WOLFSSL_NO_CLIENT_AUTH) && defined(HAVE_ED25519) && \
                                                 !defined(NO_ED25519_CLIENT_AUTH)
+    if (IsAtLeastTLSv1_2(ssl)) {
         ret = Ed25519Update(ssl, adj, sz);
         if (ret != 0)
             return ret;
-    #endif
     }
+#endif
 
     return ret;
 }
@@ -7245,38 +7514,18 @@ int HashInput(WOLFSSL* ssl, const byte* input, int sz)
         return BAD_FUNC_ARG;
     }
 
-#ifndef NO_OLD_TLS
-    #ifndef NO_SHA
-        wc_ShaUpdate(&ssl->hsHashes->hashSha, adj, sz);
-    #endif
-    #ifndef NO_MD5
-        wc_Md5Update(&ssl->hsHashes->hashMd5, adj, sz);
-    #endif
-#endif
+    ret = HashRaw(ssl, adj, sz);
+    if (ret != 0)
+        return ret;
 
-    if (IsAtLeastTLSv1_2(ssl)) {
-    #ifndef NO_SHA256
-        ret = wc_Sha256Update(&ssl->hsHashes->hashSha256, adj, sz);
-        if (ret != 0)
-            return ret;
-    #endif
-    #ifdef WOLFSSL_SHA384
-        ret = wc_Sha384Update(&ssl->hsHashes->hashSha384, adj, sz);
-        if (ret != 0)
-            return ret;
-    #endif
-    #ifdef WOLFSSL_SHA512
-        ret = wc_Sha512Update(&ssl->hsHashes->hashSha512, adj, sz);
-        if (ret != 0)
-            return ret;
-    #endif
-    #if !defined(WOLFSSL_NO_CLIENT_AUTH) && defined(HAVE_ED25519) && \
+#if !defined(WOLFSSL_NO_CLIENT_AUTH) && defined(HAVE_ED25519) && \
                                                 !defined(NO_ED25519_CLIENT_AUTH)
+    if (IsAtLeastTLSv1_2(ssl)) {
         ret = Ed25519Update(ssl, adj, sz);
         if (ret != 0)
             return ret;
-    #endif
     }
+#endif
 
     return ret;
 }
@@ -8078,6 +8327,10 @@ static int BuildFinished(WOLFSSL* ssl, Hashes* hashes, const byte* sender)
     if (ssl == NULL)
         return BAD_FUNC_ARG;
 
+    ret = FlushHandshakeHashes(ssl);
+    if (ret != 0)
+        return ret;
+
 #ifndef NO_TLS
     if (ssl->options.tls) {
         ret = BuildTlsFinished(ssl, hashes, sender);
@@ -8926,6 +9179,12 @@ int CopyDecodedToX509(WOLFSSL_X509* x509, DecodedCert* dCert)
         dCert->subjectCNLen < 0)
         return BAD_FUNC_ARG;
 
+#ifdef WOLFSSL_ASN_LAZY_EXT
+    /* the X509 object exposes every extension */
+    if ((ret = DecodeCertLazyExt(dCert, CERT_LAZY_ALL)) < 0)
+        return ret;
+#endif
+
     x509->version = dCert->version + 1;
 
     XSTRNCPY(x509->issuer.name, dCert->issuer, ASN_NAME_MAX);
@@ -9366,6 +9625,15 @@ typedef struct ProcPeerCertArgs {
 #ifdef WOLFSSL_TRUST_PEER_CERT
     word16 haveTrustPeer:1; /* was cert verified by loaded trusted peer cert */
 #endif
+#ifdef WOLFSSL_CERT_VERIFY_CACHE
+    word16 verifyCacheHit:1;  /* chain signatures verified on earlier connect */
+    word16 verifyCacheFail:1; /* a check failed, do not cache this chain */
+    word16 verifyCacheLookup:1; /* chainHash and verifyCacheEpoch are set */
+#endif
+#ifdef WOLFSSL_CERT_VERIFY_CACHE
+    word32 verifyCacheEpoch;  /* cache epoch when verification started */
+    byte   chainHash[WC_SHA256_DIGEST_SIZE]; /* hash of the chain received */
+#endif
 } ProcPeerCertArgs;
 
 /* WOLFSSL_ALWAYS_VERIFY_CB: Use verify callback for success or failure cases */
@@ -9739,6 +10007,10 @@ static int ProcessPeerCertParse(WOLFSSL* ssl, ProcPeerCertArgs* args,
 
         args->dCertInit = 1;
         args->dCert->sigCtx.devId = ssl->devId;
+    #ifdef WOLFSSL_ASN_LAZY_EXT
+        /* only decode the extensions the handshake ends up needing */
+        args->dCert->lazyExt = 1;
+    #endif
     #ifdef WOLFSSL_ASYNC_CRYPT
         args->dCert->sigCtx.asyncCtx = ssl;
     #endif
@@ -9786,6 +10058,63 @@ static int ProcessPeerCertParse(WOLFSSL* ssl, ProcPeerCertArgs* args,
     return ret;
 }
 
+#ifdef WOLFSSL_CERT_VERIFY_CACHE
+/* Hash of the peer's certificate chain as received, used as verify cache key.
+ * Each certificate is hashed with its length so the split is unambiguous. */
+static int HashPeerCertChain(WOLFSSL* ssl, ProcPeerCertArgs* args, byte* hash)
+{
+    int ret;
+    int i;
+    byte len[OPAQUE24_LEN];
+#ifdef WOLFSSL_SMALL_STACK
+    wc_Sha256* sha256;
+#else
+    wc_Sha256  sha256[1];
+#endif
+
+#ifdef WOLFSSL_SMALL_STACK
+    sha256 = (wc_Sha256*)XMALLOC(sizeof(wc_Sha256), ssl->heap,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+    if (sha256 == NULL)
+        return MEMORY_E;
+#endif
+
+    ret = wc_InitSha256_ex(sha256, ssl->heap, ssl->devId);
+    for (i = 0; ret == 0 && i < args->totalCerts; i++) {
+        c32to24(args->certs[i].length, len);
+        ret = wc_Sha256Update(sha256, len, OPAQUE24_LEN);
+        if (ret == 0) {
+            ret = wc_Sha256Update(sha256, args->certs[i].buffer,
+                                                      args->certs[i].length);
+        }
+    }
+    if (ret == 0)
+        ret = wc_Sha256Final(sha256, hash);
+    wc_Sha256Free(sha256);
+
+#ifdef WOLFSSL_SMALL_STACK
+    XFREE(sha256, ssl->heap, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    return ret;
+}
+#endif /* WOLFSSL_CERT_VERIFY_CACHE */
+
+/* Verification to perform on a chain or peer certificate. Chains found in
+ * the verify cache only need the checks that can change over time. */
+static WC_INLINE int ProcessPeerCertVerifyType(WOLFSSL* ssl,
+                                               ProcPeerCertArgs* args)
+{
+    if (ssl->options.verifyNone)
+        return NO_VERIFY;
+#ifdef WOLFSSL_CERT_VERIFY_CACHE
+    if (args->verifyCacheHit)
+        return VERIFY_NAME;
+#endif
+    (void)args;
+    return VERIFY;
+}
+
 /* Check key sizes for certs. Is redundant check since
    ProcessBuffer also performs this check. */
 static int ProcessPeerCertCheckKey(WOLFSSL* ssl, ProcPeerCertArgs* args)
@@ -10092,7 +10421,24 @@ int ProcessPeerCerts(WOLFSSL* ssl, byte* input, word32* inOutIdx,
             if (args->dCert == NULL) {
                 ERROR_OUT(MEMORY_E, exit_ppc);
             }
-            XMEMSET(args->dCert, 0, sizeof(DecodedCert));
+            XMEMSET(args->dCert, 0, sizeof(DecodedCert));
+        #endif
+
+        #ifdef WOLFSSL_CERT_VERIFY_CACHE
+            if (ssl->ctx->cm->verifyCache != NULL &&
+                                !ssl->options.verifyNone && args->count > 0) {
+                if (HashPeerCertChain(ssl, args, args->chainHash) != 0) {
+                    args->verifyCacheFail = 1;
+                }
+                else {
+                    args->verifyCacheLookup = 1;
+                    if (CM_VerifyCacheLookup(ssl->ctx->cm, args->chainHash,
+                                                   &args->verifyCacheEpoch)) {
+                        WOLFSSL_MSG("Peer cert chain found in verify cache");
+                        args->verifyCacheHit = 1;
+                    }
+                }
+            }
         #endif
 
             /* Advance state and proceed */
@@ -10164,7 +10510,7 @@ int ProcessPeerCerts(WOLFSSL* ssl, byte* input, word32* inOutIdx,
                     args->certIdx = args->count - 1;
 
                     ret = ProcessPeerCertParse(ssl, args, CERT_TYPE,
-                        !ssl->options.verifyNone ? VERIFY : NO_VERIFY,
+                        ProcessPeerCertVerifyType(ssl, args),
                         &subjectHash, &alreadySigner);
                 #ifdef WOLFSSL_ASYNC_CRYPT
                     if (ret == WC_PENDING_E)
@@ -10250,6 +10596,11 @@ int ProcessPeerCerts(WOLFSSL* ssl, byte* input, word32* inOutIdx,
                     }
             #endif /* HAVE_OCSP || HAVE_CRL */
 
+                #ifdef WOLFSSL_CERT_VERIFY_CACHE
+                    if (ret != 0)
+                        args->verifyCacheFail = 1;
+                #endif
+
                 #ifdef WOLFSSL_ALT_CERT_CHAINS
                     /* For alternate cert chain, its okay for a CA cert to fail
                         with ASN_NO_SIGNER_E here. The "alternate" certificate
@@ -10332,11 +10683,15 @@ int ProcessPeerCerts(WOLFSSL* ssl, byte* input, word32* inOutIdx,
                 args->certIdx = 0;
 
                 ret = ProcessPeerCertParse(ssl, args, CERT_TYPE,
-                        !ssl->options.verifyNone ? VERIFY : NO_VERIFY,
+                        ProcessPeerCertVerifyType(ssl, args),
                         &subjectHash, &alreadySigner);
             #ifdef WOLFSSL_ASYNC_CRYPT
                 if (ret == WC_PENDING_E)
                     goto exit_ppc;
+            #endif
+            #ifdef WOLFSSL_CERT_VERIFY_CACHE
+                if (ret != 0)
+                    args->verifyCacheFail = 1;
             #endif
                 if (ret == 0) {
                     WOLFSSL_MSG("Verified Peer's cert");
@@ -10512,6 +10867,11 @@ int ProcessPeerCerts(WOLFSSL* ssl, byte* input, word32* inOutIdx,
                 }
             #endif /* HAVE_OCSP || HAVE_CRL */
 
+            #ifdef WOLFSSL_CERT_VERIFY_CACHE
+                if (ret != 0)
+                    args->verifyCacheFail = 1;
+            #endif
+
             #ifdef KEEP_PEER_CERT
                 if (args->fatal == 0) {
                     int copyRet = 0;
@@ -10597,6 +10957,16 @@ int ProcessPeerCerts(WOLFSSL* ssl, byte* input, word32* inOutIdx,
 
                 ssl->options.havePeerCert = 1;
 
+            #ifdef WOLFSSL_ASN_LAZY_EXT
+                if (!ssl->options.verifyNone &&
+                        ssl->buffers.domainName.buffer &&
+                        DecodeCertLazyExt(args->dCert,
+                                          CERT_LAZY_ALT_NAMES) < 0) {
+                    WOLFSSL_MSG("Unable to decode peer alt names");
+                    ret = DOMAIN_NAME_MISMATCH;
+                }
+                else
+            #endif
                 if (!ssl->options.verifyNone && ssl->buffers.domainName.buffer) {
                 #ifndef WOLFSSL_ALLOW_NO_CN_IN_SAN
                     /* Per RFC 5280 section 4.2.1.6, "Whenever such identities
@@ -10866,6 +11236,23 @@ int ProcessPeerCerts(WOLFSSL* ssl, byte* input, word32* inOutIdx,
             }
         #endif
 
+        #ifdef WOLFSSL_CERT_VERIFY_CACHE
+            /* only remember chains that verified without any error */
+            if (ret == 0 && args->count > 0 && args->verifyCacheLookup &&
+                    !args->verifyCacheHit && !args->verifyCacheFail &&
+                    !ssl->options.verifyNone &&
+                #ifdef WOLFSSL_TRUST_PEER_CERT
+                    !args->haveTrustPeer &&
+                #endif
+                    ssl->ctx->cm->verifyCache != NULL &&
+                    args->dCert != NULL && args->dCertInit) {
+                if (CM_VerifyCacheAdd(ssl->ctx->cm, args->chainHash,
+                               args->verifyCacheEpoch, args->dCert) != 0) {
+                    WOLFSSL_MSG("Unable to add chain to verify cache");
+                }
+            }
+        #endif
+
             /* Do verify callback */
             ret = DoVerifyCallback(ssl, ret, args);
 
@@ -11748,6 +12135,8 @@ static int DoHandShakeMsgType(WOLFSSL* ssl, byte* input, word32* inOutIdx,
     case server_hello:
         WOLFSSL_MSG("processing server hello");
         ret = DoServerHello(ssl, input, inOutIdx, size);
+        if (ret == 0)
+            ret = SelectHandshakeHashes(ssl);
     #if !defined(WOLFSSL_NO_CLIENT_AUTH) && defined(HAVE_ED25519) && \
                                                 !defined(NO_ED25519_CLIENT_AUTH)
         if (ssl->options.resuming || !IsAtLeastTLSv1_2(ssl) ||
@@ -13587,8 +13976,16 @@ int DoApplicationData(WOLFSSL* ssl, byte* input, word32* inOutIdx)
 #endif
 
 #ifdef WOLFSSL_EARLY_DATA
+    int    isEarlyData = 0;
+
     if (ssl->options.tls1_3 && ssl->options.handShakeDone == 0) {
         if (ssl->options.side == WOLFSSL_SERVER_END &&
+                          ssl->earlyData == process_early_data &&
+                          ssl->options.clientState < CLIENT_FINISHED_COMPLETE) {
+            /* Early data was accepted - process it like application data. */
+            isEarlyData = 1;
+        }
+        else if (ssl->options.side == WOLFSSL_SERVER_END &&
                           ssl->earlyData != no_early_data &&
                           ssl->options.clientState < CLIENT_FINISHED_COMPLETE) {
             ssl->earlyDataSz += ssl->curSize;
@@ -13600,8 +13997,10 @@ int DoApplicationData(WOLFSSL* ssl, byte* input, word32* inOutIdx)
             WOLFSSL_MSG("Too much EarlyData!");
         }
     }
-#endif
+    if (ssl->options.handShakeDone == 0 && !isEarlyData) {
+#else
     if (ssl->options.handShakeDone == 0) {
+#endif
         WOLFSSL_MSG("Received App data before a handshake completed");
         SendAlert(ssl, alert_fatal, unexpected_message);
         return OUT_OF_ORDER_E;
@@ -15036,39 +15435,57 @@ static int BuildSHA_CertVerify(WOLFSSL* ssl, byte* digest)
 
 int BuildCertHashes(WOLFSSL* ssl, Hashes* hashes)
 {
-    int ret = 0;
+    int    ret;
+    word32 mask;
 
     (void)hashes;
 
+    ret = FlushHandshakeHashes(ssl);
+    if (ret != 0)
+        return ret;
+    /* only snapshot the hashes that are being kept */
+    mask = ssl->hsHashes->hashMask;
+    (void)mask;
+
     if (ssl->options.tls) {
     #if !defined(NO_MD5) && !defined(NO_OLD_TLS)
-        ret = wc_Md5GetHash(&ssl->hsHashes->hashMd5, hashes->md5);
-        if (ret != 0)
-            return ret;
+        if (mask & HS_HASH_MD5) {
+            ret = wc_Md5GetHash(&ssl->hsHashes->hashMd5, hashes->md5);
+            if (ret != 0)
+                return ret;
+        }
     #endif
     #if !defined(NO_SHA)
-        ret = wc_ShaGetHash(&ssl->hsHashes->hashSha, hashes->sha);
-        if (ret != 0)
-            return ret;
+        if (mask & HS_HASH_SHA) {
+            ret = wc_ShaGetHash(&ssl->hsHashes->hashSha, hashes->sha);
+            if (ret != 0)
+                return ret;
+        }
     #endif
         if (IsAtLeastTLSv1_2(ssl)) {
             #ifndef NO_SHA256
+            if (mask & HS_HASH_SHA256) {
                 ret = wc_Sha256GetHash(&ssl->hsHashes->hashSha256,
                                        hashes->sha256);
                 if (ret != 0)
                     return ret;
+            }
             #endif
             #ifdef WOLFSSL_SHA384
+            if (mask & HS_HASH_SHA384) {
                 ret = wc_Sha384GetHash(&ssl->hsHashes->hashSha384,
                                        hashes->sha384);
                 if (ret != 0)
                     return ret;
+            }
             #endif
             #ifdef WOLFSSL_SHA512
+            if (mask & HS_HASH_SHA512) {
                 ret = wc_Sha512GetHash(&ssl->hsHashes->hashSha512,
                                        hashes->sha512);
                 if (ret != 0)
                     return ret;
+            }
             #endif
         }
     }
@@ -15748,13 +16165,324 @@ int CreateOcspResponse(WOLFSSL* ssl, OcspRequest** ocspRequest,
 
     return ret;
 }
+
+#ifdef WOLFSSL_OCSP_STAPLE_MGR
+/* Point response at the shared managed staple for ssl's certificate and
+ * take a reference to it in "staple", NULL when there is none to send.
+ *
+ * Returns 1 when the certificate is managed so the caller must not fetch a
+ * response itself, 0 otherwise
+ */
+int GetOcspStaple(WOLFSSL* ssl, buffer* response, OcspStaple** staple)
+{
+    WOLFSSL_CERT_MANAGER* cm = ssl->ctx->cm;
+
+    *staple = NULL;
+    XMEMSET(response, 0, sizeof(*response));
+
+    if (ssl->buffers.weOwnCert || ssl->ctx->certStaple == NULL ||
+                cm == NULL || cm->ocspStaplingEnabled == 0 ||
+                cm->ocsp_stapling == NULL)
+        return 0;
+
+    *staple = OcspStapleGet(ssl->ctx->certStaple,
+                                                cm->ocsp_stapling->stapleMgr);
+    if (*staple != NULL) {
+        response->buffer = (*staple)->response;
+        response->length = (*staple)->responseSz;
+    }
+
+    return 1;
+}
+#endif /* WOLFSSL_OCSP_STAPLE_MGR */
 #endif
 #endif /* !NO_WOLFSSL_SERVER */
 
+#if !defined(NO_CERTS) && defined(WOLFSSL_CERT_MSG_CACHE)
+/* Free the encoded Certificate message bodies held by the context.
+ *
+ * ctx  SSL/TLS context object.
+ */
+void FreeCertMsgCache(WOLFSSL_CTX* ctx)
+{
+#ifdef HAVE_CERT_COMPRESSION
+    int i;
+
+    for (i = 0; i < ctx->certCompressCnt; i++)
+        FreeDer(&ctx->certCompress[i].msg);
+#endif
+    FreeDer(&ctx->certMsg);
+#ifdef WOLFSSL_TLS13
+    FreeDer(&ctx->certMsg13);
+#endif
+}
+
+#ifdef HAVE_CERT_COMPRESSION
+/* Compress the encoded TLS v1.3 Certificate message body with each algorithm
+ * that has a compression callback. The CompressedCertificate body is kept:
+ *     Algorithm | Uncompressed Length | Compressed Length | Compressed Data
+ * Nothing is kept for an algorithm when compressing fails or doesn't make the
+ * message smaller.
+ *
+ * ctx  SSL/TLS context object.
+ */
+static void CompressCertMsg(WOLFSSL_CTX* ctx)
+{
+    DerBuffer* msg = ctx->certMsg13;
+    byte*      out;
+    word32     outSz;
+    int        i;
+
+    out = (byte*)XMALLOC(msg->length, ctx->heap, DYNAMIC_TYPE_TMP_BUFFER);
+    if (out == NULL)
+        return;
+
+    for (i = 0; i < ctx->certCompressCnt; i++) {
+        CertCompressAlg* entry = &ctx->certCompress[i];
+        byte*            p;
+
+        if (entry->compress == NULL)
+            continue;
+
+        outSz = msg->length;
+        if (entry->compress(msg->buffer, msg->length, out, &outSz) != 0 ||
+                outSz == 0 || outSz >= msg->length) {
+            continue;
+        }
+
+        if (AllocDer(&entry->msg, OPAQUE16_LEN + 2 * OPAQUE24_LEN + outSz,
+                                                CERT_TYPE, ctx->heap) != 0) {
+            continue;
+        }
+        p = entry->msg->buffer;
+        c16toa(entry->alg, p);
+        p += OPAQUE16_LEN;
+        c32to24(msg->length, p);
+        p += OPAQUE24_LEN;
+        c32to24(outSz, p);
+        p += OPAQUE24_LEN;
+        XMEMCPY(p, out, outSz);
+    }
+
+    XFREE(out, ctx->heap, DYNAMIC_TYPE_TMP_BUFFER);
+}
+#endif /* HAVE_CERT_COMPRESSION */
+
+/* Encode the Certificate message bodies for the context's certificate and
+ * chain. Connections using the context's certificate and chain copy the
+ * encoding out rather than building the message each time.
+ * When encoding fails nothing is cached and the message is built as normal.
+ *
+ * ctx  SSL/TLS context object.
+ */
+void CacheCertMsg(WOLFSSL_CTX* ctx)
+{
+    word32 certSz;
+    word32 chainSz = 0;
+    byte*  chain = NULL;
+    byte*  out;
+
+    FreeCertMsgCache(ctx);
+
+    if (ctx->certificate == NULL || ctx->certificate->length == 0)
+        return;
+
+    certSz = ctx->certificate->length;
+    if (ctx->certChain != NULL) {
+        chain = ctx->certChain->buffer;
+        chainSz = ctx->certChain->length;
+    }
+
+#ifndef WOLFSSL_NO_TLS12
+    /* Cert List Len | Cert Data Len | Cert | Chain (has leading sizes) */
+    if (AllocDer(&ctx->certMsg, 2 * CERT_HEADER_SZ + certSz + chainSz,
+                                                CERT_TYPE, ctx->heap) == 0) {
+        out = ctx->certMsg->buffer;
+        c32to24(CERT_HEADER_SZ + certSz + chainSz, out);
+        c32to24(certSz, out + CERT_HEADER_SZ);
+        XMEMCPY(out + 2 * CERT_HEADER_SZ, ctx->certificate->buffer, certSz);
+        if (chainSz > 0)
+            XMEMCPY(out + 2 * CERT_HEADER_SZ + certSz, chain, chainSz);
+    }
+#endif
+
+#ifdef WOLFSSL_TLS13
+    {
+        word32 listSz;
+        word32 idx = 0;
+        word32 i;
+        word32 len;
+
+        /* Each certificate is followed by an empty extensions block. */
+        listSz = CERT_HEADER_SZ + certSz + OPAQUE16_LEN;
+        if (ctx->certChainCnt > 0)
+            listSz += chainSz + OPAQUE16_LEN * ctx->certChainCnt;
+
+        /* Cert Req Ctx Len | Cert List Len | Cert Data Len | Cert | Exts |
+         * Chain Cert | Exts ... */
+        if (AllocDer(&ctx->certMsg13, OPAQUE8_LEN + CERT_HEADER_SZ + listSz,
+                                                CERT_TYPE, ctx->heap) != 0) {
+            return;
+        }
+        out = ctx->certMsg13->buffer;
+
+        out[idx++] = 0;
+        c32to24(listSz, out + idx);
+        idx += CERT_HEADER_SZ;
+        c32to24(certSz, out + idx);
+        idx += CERT_HEADER_SZ;
+        XMEMCPY(out + idx, ctx->certificate->buffer, certSz);
+        idx += certSz;
+        out[idx++] = 0;
+        out[idx++] = 0;
+
+        for (i = 0; ctx->certChainCnt > 0 && i + CERT_HEADER_SZ <= chainSz;
+                                                                    i += len) {
+            c24to32(chain + i, &len);
+            len += CERT_HEADER_SZ;
+            if (i + len > chainSz ||
+                    idx + len + OPAQUE16_LEN > ctx->certMsg13->length) {
+                break;
+            }
+            XMEMCPY(out + idx, chain + i, len);
+            idx += len;
+            out[idx++] = 0;
+            out[idx++] = 0;
+        }
+
+        /* Chain count and data disagree - build message each time. */
+        if (idx != ctx->certMsg13->length)
+            FreeDer(&ctx->certMsg13);
+    }
+#endif
+
+#ifdef HAVE_CERT_COMPRESSION
+    if (ctx->certMsg13 != NULL)
+        CompressCertMsg(ctx);
+#endif
+}
+
+/* Get the encoded Certificate message body to send on the connection.
+ *
+ * ssl  SSL/TLS object.
+ * returns the encoding when the connection is using the context's certificate
+ * and chain, otherwise NULL.
+ */
+DerBuffer* GetCertMsgCache(WOLFSSL* ssl)
+{
+    if (ssl->ctx == NULL ||
+            ssl->buffers.certificate != ssl->ctx->certificate ||
+            ssl->buffers.certChain != ssl->ctx->certChain) {
+        return NULL;
+    }
+
+#ifdef WOLFSSL_TLS13
+    if (IsAtLeastTLSv1_3(ssl->version)) {
+        if (ssl->buffers.certChainCnt != ssl->ctx->certChainCnt)
+            return NULL;
+        return ssl->ctx->certMsg13;
+    }
+#endif
+
+    return ssl->ctx->certMsg;
+}
+#endif /* !NO_CERTS && WOLFSSL_CERT_MSG_CACHE */
+
 #ifndef WOLFSSL_NO_TLS12
 
 #ifndef NO_CERTS
 #if !defined(NO_WOLFSSL_SERVER) || !defined(WOLFSSL_NO_CLIENT_AUTH)
+#ifdef WOLFSSL_CERT_MSG_CACHE
+/* Send the Certificate message using the encoded body from the context.
+ * ssl->fragOffset is the count of body bytes already sent.
+ *
+ * ssl          SSL/TLS object.
+ * msg          Encoded Certificate message body.
+ * maxFragment  Maximum size of a record's data.
+ * returns 0 on success, otherwise failure.
+ */
+static int SendCertificateCached(WOLFSSL* ssl, DerBuffer* msg,
+                                 word32 maxFragment)
+{
+    int ret = 0;
+
+    while (ssl->fragOffset < msg->length && ret == 0) {
+        byte*  output = NULL;
+        word32 fragSz;
+        word32 i = RECORD_HEADER_SZ;
+        int    sendSz;
+
+        if (ssl->fragOffset == 0) {
+            fragSz = min(msg->length, maxFragment - HANDSHAKE_HEADER_SZ);
+            i += HANDSHAKE_HEADER_SZ;
+        }
+        else
+            fragSz = min(msg->length - ssl->fragOffset, maxFragment);
+
+        sendSz = i + fragSz;
+        if (IsEncryptionOn(ssl, 1))
+            sendSz += MAX_MSG_EXTRA;
+
+        /* check for available size */
+        if ((ret = CheckAvailableSize(ssl, sendSz)) != 0)
+            return ret;
+
+        /* get output buffer */
+        output = ssl->buffers.outputBuffer.buffer +
+                 ssl->buffers.outputBuffer.length;
+
+        if (ssl->fragOffset == 0) {
+            AddFragHeaders(output, fragSz, 0, msg->length, certificate, ssl);
+            if (!IsEncryptionOn(ssl, 1)) {
+                ret = HashOutputRaw(ssl, output + RECORD_HEADER_SZ,
+                                    HANDSHAKE_HEADER_SZ);
+                if (ret == 0)
+                    ret = HashOutputRaw(ssl, msg->buffer, msg->length);
+                if (ret != 0)
+                    return ret;
+            }
+        }
+        else
+            AddRecordHeader(output, fragSz, handshake, ssl);
+
+        XMEMCPY(output + i, msg->buffer + ssl->fragOffset, fragSz);
+        i += fragSz;
+        ssl->fragOffset += fragSz;
+
+        if (IsEncryptionOn(ssl, 1)) {
+            byte* input;
+            int   inputSz = i - RECORD_HEADER_SZ; /* build msg adds rec hdr */
+
+            input = (byte*)XMALLOC(inputSz, ssl->heap, DYNAMIC_TYPE_IN_BUFFER);
+            if (input == NULL)
+                return MEMORY_E;
+            XMEMCPY(input, output + RECORD_HEADER_SZ, inputSz);
+
+            sendSz = BuildMessage(ssl, output, sendSz, input, inputSz,
+                                                          handshake, 1, 0, 0);
+            XFREE(input, ssl->heap, DYNAMIC_TYPE_IN_BUFFER);
+
+            if (sendSz < 0)
+                return sendSz;
+        }
+
+    #if defined(WOLFSSL_CALLBACKS) || defined(OPENSSL_EXTRA)
+        if (ssl->hsInfoOn)
+            AddPacketName(ssl, "Certificate");
+        if (ssl->toInfoOn)
+            AddPacketInfo(ssl, "Certificate", handshake, output, sendSz,
+                           WRITE_PROTO, ssl->heap);
+    #endif
+
+        ssl->buffers.outputBuffer.length += sendSz;
+        if (!ssl->options.groupMessages)
+            ret = SendBuffered(ssl);
+    }
+
+    return ret;
+}
+#endif /* WOLFSSL_CERT_MSG_CACHE */
+
 /* handle generation of certificate (11) */
 int SendCertificate(WOLFSSL* ssl)
 {
@@ -15825,6 +16553,20 @@ int SendCertificate(WOLFSSL* ssl)
 
     maxFragment = wolfSSL_GetMaxRecordSize(ssl, maxFragment);
 
+#ifdef WOLFSSL_CERT_MSG_CACHE
+    if (!ssl->options.dtls && ssl->options.sendVerify != SEND_BLANK_CERT) {
+        DerBuffer* msg = GetCertMsgCache(ssl);
+
+        if (msg != NULL) {
+            ret = SendCertificateCached(ssl, msg, maxFragment);
+            if (ret != 0 && ret != WANT_WRITE)
+                return ret;
+            /* Message sent from encoding - nothing left to build. */
+            length = 0;
+        }
+    }
+#endif
+
     while (length > 0 && ret == 0) {
         byte*  output = NULL;
         word32 fragSz = 0;
@@ -16304,6 +17046,18 @@ int SendCertificateStatus(WOLFSSL* ssl)
         {
             OcspRequest* request = ssl->ctx->certOcspRequest;
             buffer response;
+        #ifdef WOLFSSL_OCSP_STAPLE_MGR
+            OcspStaple* staple;
+
+            if (GetOcspStaple(ssl, &response, &staple)) {
+                if (staple != NULL) {
+                    ret = BuildCertificateStatus(ssl, status_type, &response,
+                                                                             1);
+                    OcspStapleRelease(staple);
+                }
+                break;
+            }
+        #endif
 
             ret = CreateOcspResponse(ssl, &request, &response);
 
@@ -16333,10 +17087,17 @@ int SendCertificateStatus(WOLFSSL* ssl)
             OcspRequest* request = ssl->ctx->certOcspRequest;
             buffer responses[1 + MAX_CHAIN_DEPTH];
             int i = 0;
+        #ifdef WOLFSSL_OCSP_STAPLE_MGR
+            OcspStaple* staple = NULL;
+        #endif
 
             XMEMSET(responses, 0, sizeof(responses));
 
-            ret = CreateOcspResponse(ssl, &request, &responses[0]);
+        #ifdef WOLFSSL_OCSP_STAPLE_MGR
+            /* chain certificates below are still looked up here */
+            if (!GetOcspStaple(ssl, &responses[0], &staple))
+        #endif
+                ret = CreateOcspResponse(ssl, &request, &responses[0]);
 
             /* if a request was successfully created and not stored in
              * ssl->ctx then free it */
@@ -16429,12 +17190,19 @@ int SendCertificateStatus(WOLFSSL* ssl)
                 }
 
                 for (i = 0; i < 1 + MAX_CHAIN_DEPTH; i++) {
+                #ifdef WOLFSSL_OCSP_STAPLE_MGR
+                    if (i == 0 && staple != NULL)
+                        continue;  /* shared, released below */
+                #endif
                     if (responses[i].buffer) {
                         XFREE(responses[i].buffer, ssl->heap,
                                                      DYNAMIC_TYPE_OCSP_REQUEST);
                     }
                 }
             }
+        #ifdef WOLFSSL_OCSP_STAPLE_MGR
+            OcspStapleRelease(staple);
+        #endif
 
             break;
         }
@@ -16484,6 +17252,13 @@ int SendData(WOLFSSL* ssl, const void* data, int sz)
         }
     }
 
+#ifdef WOLFSSL_HALF_RTT_DATA
+    if (ssl->options.halfRttData) {
+        /* Server's flight is still buffered - send data with it. */
+        groupMsgs = 1;
+    }
+    else
+#endif
 #ifdef WOLFSSL_EARLY_DATA
     if (ssl->earlyData != no_early_data) {
         if (ssl->options.handShakeState == HANDSHAKE_DONE) {
@@ -17270,6 +18045,9 @@ const char* wolfSSL_ERR_reason_error_string(unsigned long e)
     case CLIENT_CERT_CB_ERROR:
         return "Error importing client cert or key from callback";
 
+    case CERT_DECOMPRESS_E:
+        return "Compressed certificate message decompression error";
+
     default :
         return "unknown error number";
     }
@@ -22735,6 +23513,11 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
         WOLFSSL_START(WC_FUNC_SERVER_HELLO_SEND);
         WOLFSSL_ENTER("SendServerHello");
 
+        /* cipher suite is picked, only hash with what it needs from here */
+        ret = SelectHandshakeHashes(ssl);
+        if (ret != 0)
+            return ret;
+
         length = VERSION_SZ + RAN_LEN
                + ID_LEN + ENUM_LEN
                + SUITE_LEN
@@ -24697,10 +25480,63 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
         return MATCH_SUITE_ERROR;
     }
 
+#ifdef WOLFSSL_CH_PREPARSE
+    /* Set a bit in the map for each cipher suite in the list.
+     *
+     * map     Bitmap of SUITE_MAP_SZ bytes.
+     * suites  List of cipher suites.
+     * sz      Length of list in bytes.
+     */
+    void BuildSuiteMap(byte* map, const byte* suites, word16 sz)
+    {
+        word16 i;
+        byte   bit;
+
+        XMEMSET(map, 0, SUITE_MAP_SZ);
+        for (i = 0; i + 1 < sz; i += 2) {
+            bit = SUITE_MAP_BIT(suites[i], suites[i+1]);
+            map[bit >> 3] |= (byte)(1 << (bit & 7));
+        }
+    }
+
+    /* Check whether any of the peer's cipher suites are in the list.
+     * Only suites with a bit set in the peer's map are compared.
+     *
+     * suites   List of our cipher suites.
+     * peer     Peer's list of cipher suites.
+     * peerSz   Length of peer's list in bytes.
+     * peerMap  Map of peer's cipher suites.
+     * returns 1 when there is a suite in common and 0 otherwise.
+     */
+    int HaveCommonSuite(const Suites* suites, const byte* peer, word16 peerSz,
+                        const byte* peerMap)
+    {
+        word16 i, j;
+
+        for (i = 0; i < suites->suiteSz; i += 2) {
+            if (!SUITE_MAP_HAS(peerMap, suites->suites[i],
+                                                       suites->suites[i+1])) {
+                continue;
+            }
+            for (j = 0; j < peerSz; j += 2) {
+                if (suites->suites[i]   == peer[j] &&
+                    suites->suites[i+1] == peer[j+1]) {
+                    return 1;
+                }
+            }
+        }
+
+        return 0;
+    }
+#endif /* WOLFSSL_CH_PREPARSE */
+
     int MatchSuite(WOLFSSL* ssl, Suites* peerSuites)
     {
         int ret;
         word16 i, j;
+    #ifdef WOLFSSL_CH_PREPARSE
+        byte map[SUITE_MAP_SZ];
+    #endif
 
         WOLFSSL_ENTER("MatchSuite");
 
@@ -24712,8 +25548,18 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
             return SUITES_ERROR;
 
         if (!ssl->options.useClientOrder) {
+        #ifdef WOLFSSL_CH_PREPARSE
+            /* Only look for suites that the peer may have. */
+            BuildSuiteMap(map, peerSuites->suites, peerSuites->suiteSz);
+        #endif
             /* Server order */
             for (i = 0; i < ssl->suites->suiteSz; i += 2) {
+            #ifdef WOLFSSL_CH_PREPARSE
+                if (!SUITE_MAP_HAS(map, ssl->suites->suites[i],
+                                                  ssl->suites->suites[i+1])) {
+                    continue;
+                }
+            #endif
                 for (j = 0; j < peerSuites->suiteSz; j += 2) {
                     ret = CompareSuites(ssl, peerSuites, i, j);
                     if (ret != MATCH_SUITE_ERROR)
@@ -24722,8 +25568,18 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
             }
         }
         else {
+        #ifdef WOLFSSL_CH_PREPARSE
+            /* Only look for peer's suites that we may have. */
+            BuildSuiteMap(map, ssl->suites->suites, ssl->suites->suiteSz);
+        #endif
             /* Client order */
             for (j = 0; j < peerSuites->suiteSz; j += 2) {
+            #ifdef WOLFSSL_CH_PREPARSE
+                if (!SUITE_MAP_HAS(map, peerSuites->suites[j],
+                                                  peerSuites->suites[j+1])) {
+                    continue;
+                }
+            #endif
                 for (i = 0; i < ssl->suites->suiteSz; i += 2) {
                     ret = CompareSuites(ssl, peerSuites, i, j);
                     if (ret != MATCH_SUITE_ERROR)
@@ -24760,22 +25616,9 @@ static int DoSessionTicket(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
 #endif
 
         /* manually hash input since different format */
-#ifndef NO_OLD_TLS
-#ifndef NO_MD5
-        wc_Md5Update(&ssl->hsHashes->hashMd5, input + idx, sz);
-#endif
-#ifndef NO_SHA
-        wc_ShaUpdate(&ssl->hsHashes->hashSha, input + idx, sz);
-#endif
-#endif
-#ifndef NO_SHA256
-        if (IsAtLeastTLSv1_2(ssl)) {
-            int shaRet = wc_Sha256Update(&ssl->hsHashes->hashSha256,
-                                         input + idx, sz);
-            if (shaRet != 0)
-                return shaRet;
-        }
-#endif
+        ret = HashRaw(ssl, input + idx, sz);
+        if (ret != 0)
+            return ret;
 
         /* does this value mean client_hello? */
         idx++;
@@ -96,6 +96,11 @@ void FreeOCSP(WOLFSSL_OCSP* ocsp, int dynamic)
 
     WOLFSSL_ENTER("FreeOCSP");
 
+#ifdef WOLFSSL_OCSP_STAPLE_MGR
+    if (ocsp->stapleMgr != NULL)
+        FreeOcspStapleMgr(ocsp->stapleMgr, ocsp->cm->heap);
+#endif
+
     for (entry = ocsp->ocspList; entry; entry = next) {
         next = entry->next;
         FreeOcspEntry(entry, ocsp->cm->heap);
@@ -279,6 +284,7 @@ WOLFSSL_LOCAL int CheckOcspResponse(WOLFSSL_OCSP *ocsp, byte *response, int resp
 #endif
     int           ret;
     int           validated      = 0;    /* ocsp validation flag */
+    int           statusChanged  = 0;    /* cert status differs from cache */
 
 #ifdef WOLFSSL_SMALL_STACK
     newStatus = (CertStatus*)XMALLOC(sizeof(CertStatus), NULL,
@@ -336,6 +342,8 @@ WOLFSSL_LOCAL int CheckOcspResponse(WOLFSSL_OCSP *ocsp, byte *response, int resp
     }
 
     if (status != NULL) {
+        if (status->status != newStatus->status)
+            statusChanged = 1;
         if (status->rawOcspResponse) {
             XFREE(status->rawOcspResponse, ocsp->cm->heap,
                   DYNAMIC_TYPE_OCSP_STATUS);
@@ -347,6 +355,8 @@ WOLFSSL_LOCAL int CheckOcspResponse(WOLFSSL_OCSP *ocsp, byte *response, int resp
     }
     else {
         /* Save new certificate entry */
+        if (newStatus->status != CERT_GOOD)
+            statusChanged = 1;
         status = (CertStatus*)XMALLOC(sizeof(CertStatus),
                                       ocsp->cm->heap, DYNAMIC_TYPE_OCSP_STATUS);
         if (status != NULL) {
@@ -371,6 +381,9 @@ WOLFSSL_LOCAL int CheckOcspResponse(WOLFSSL_OCSP *ocsp, byte *response, int resp
 
     wc_UnLockMutex(&ocsp->ocspLock);
 
+    if (statusChanged)
+        CM_VerifyCacheInvalidate(ocsp->cm);
+
 end:
     if (ret == 0 && validated == 1) {
         WOLFSSL_MSG("New OcspResponse validated");
@@ -491,6 +504,483 @@ int CheckOcspRequest(WOLFSSL_OCSP* ocsp, OcspRequest* ocspRequest,
     return ret;
 }
 
+#ifdef WOLFSSL_OCSP_STAPLE_MGR
+
+/* Convert an OCSP response date to seconds since the epoch, 0 on failure */
+static time_t OcspStapleTime(const byte* date, byte format)
+{
+    struct tm t;
+    int       idx = 0;
+    long      y, m, era, yoe, doy, doe, days;
+
+    if (date[0] == 0 || !ExtractDate(date, format, &t, &idx))
+        return 0;
+
+    /* days since the epoch of the civil date */
+    y = t.tm_year + 1900;
+    m = t.tm_mon + 1;
+    if (m <= 2)
+        y--;
+    era  = (y >= 0 ? y : y - 399) / 400;
+    yoe  = y - era * 400;
+    doy  = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + t.tm_mday - 1;
+    doe  = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    days = era * 146097 + doe - 719468;
+
+    return (time_t)(days * 86400L + t.tm_hour * 3600L + t.tm_min * 60L +
+                                                                      t.tm_sec);
+}
+
+
+static void FreeOcspStaple(OcspStaple* staple, void* heap)
+{
+    XFREE(staple->response, heap, DYNAMIC_TYPE_OCSP_STATUS);
+    XFREE(staple, heap, DYNAMIC_TYPE_OCSP_STATUS);
+    (void)heap;
+}
+
+
+/* Get a reference to entry's current staple, NULL if there is none or it
+ * is past nextUpdate. The lock only covers the pointer and count so a
+ * handshake never waits on a fetch. Release with OcspStapleRelease. */
+OcspStaple* OcspStapleGet(OcspStapleEntry* entry, OcspStapleMgr* mgr)
+{
+    OcspStaple* staple;
+    time_t      now = XTIME(0);
+
+    if (entry == NULL || mgr == NULL)
+        return NULL;
+
+    if (wc_LockMutex(&mgr->lock) != 0) {
+        WOLFSSL_MSG("wc_LockMutex failed");
+        return NULL;
+    }
+
+    staple = entry->staple;
+    if (staple != NULL) {
+        if (staple->nextUpdate != 0 && staple->nextUpdate <= now) {
+            WOLFSSL_MSG("OCSP staple expired, not sending");
+            staple = NULL;
+        }
+        else
+            staple->refCount++;
+    }
+
+    wc_UnLockMutex(&mgr->lock);
+
+    return staple;
+}
+
+
+void OcspStapleRelease(OcspStaple* staple)
+{
+    OcspStapleMgr* mgr;
+    int            doFree;
+
+    if (staple == NULL)
+        return;
+
+    mgr = staple->mgr;
+    if (wc_LockMutex(&mgr->lock) != 0) {
+        WOLFSSL_MSG("wc_LockMutex failed");
+        return;
+    }
+    doFree = --staple->refCount == 0;
+    wc_UnLockMutex(&mgr->lock);
+
+    if (doFree)
+        FreeOcspStaple(staple, mgr->cm->heap);
+}
+
+
+/* Ask the responder for a new response and check it. Runs without any lock
+ * held. Returns the new staple with one reference, NULL on failure. */
+static OcspStaple* FetchOcspStaple(OcspStapleMgr* mgr, OcspRequest* request)
+{
+    WOLFSSL_CERT_MANAGER* cm = mgr->cm;
+    OcspStaple*   staple     = NULL;
+    byte*         req        = NULL;
+    int           reqSz      = 2048;
+    byte*         resp       = NULL;
+    int           respSz     = 0;
+    const char*   url        = NULL;
+    int           urlSz      = 0;
+    int           ret;
+#ifdef WOLFSSL_SMALL_STACK
+    CertStatus*   status;
+    OcspResponse* response;
+#else
+    CertStatus    status[1];
+    OcspResponse  response[1];
+#endif
+
+    WOLFSSL_ENTER("FetchOcspStaple");
+
+    if (cm->ocspUseOverrideURL) {
+        url = cm->ocspOverrideURL;
+        if (url == NULL || url[0] == '\0')
+            return NULL;
+        urlSz = (int)XSTRLEN(url);
+    }
+    else if (request->urlSz != 0 && request->url != NULL) {
+        url = (const char*)request->url;
+        urlSz = request->urlSz;
+    }
+    else {
+        WOLFSSL_MSG("No OCSP responder for staple");
+        return NULL;
+    }
+
+    if (cm->ocspIOCb == NULL)
+        return NULL;
+
+#ifdef WOLFSSL_SMALL_STACK
+    status = (CertStatus*)XMALLOC(sizeof(CertStatus), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+    response = (OcspResponse*)XMALLOC(sizeof(OcspResponse), NULL,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+    if (status == NULL || response == NULL) {
+        if (status) XFREE(status, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        if (response) XFREE(response, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        return NULL;
+    }
+#endif
+
+    req = (byte*)XMALLOC(reqSz, cm->heap, DYNAMIC_TYPE_OCSP);
+    if (req != NULL) {
+        reqSz = EncodeOcspRequest(request, req, reqSz);
+        if (reqSz > 0)
+            respSz = cm->ocspIOCb(cm->ocspIOCtx, url, urlSz, req, reqSz, &resp);
+        XFREE(req, cm->heap, DYNAMIC_TYPE_OCSP);
+    }
+
+    if (respSz > 0 && resp != NULL) {
+        XMEMSET(status, 0, sizeof(CertStatus));
+        InitOcspResponse(response, status, resp, respSz);
+        ret = OcspResponseDecode(response, cm, cm->heap, 0);
+        if (ret == 0 && response->responseStatus != OCSP_SUCCESSFUL)
+            ret = OCSP_LOOKUP_FAIL;
+        if (ret == 0)
+            ret = CompareOcspReqResp(request, response);
+
+        if (ret == 0) {
+            staple = (OcspStaple*)XMALLOC(sizeof(OcspStaple), cm->heap,
+                                                      DYNAMIC_TYPE_OCSP_STATUS);
+            if (staple != NULL) {
+                XMEMSET(staple, 0, sizeof(OcspStaple));
+                staple->response = (byte*)XMALLOC(respSz, cm->heap,
+                                                      DYNAMIC_TYPE_OCSP_STATUS);
+                if (staple->response == NULL) {
+                    XFREE(staple, cm->heap, DYNAMIC_TYPE_OCSP_STATUS);
+                    staple = NULL;
+                }
+            }
+            if (staple != NULL) {
+                XMEMCPY(staple->response, resp, respSz);
+                staple->responseSz = respSz;
+                staple->nextUpdate = OcspStapleTime(status->nextDate,
+                                                    status->nextDateFormat);
+                staple->refCount   = 1;
+                staple->mgr        = mgr;
+            }
+        }
+        else {
+            WOLFSSL_MSG("OCSP staple response rejected");
+        }
+    }
+
+    if (resp != NULL && cm->ocspRespFreeCb)
+        cm->ocspRespFreeCb(cm->ocspIOCtx, resp);
+
+#ifdef WOLFSSL_SMALL_STACK
+    XFREE(status,   NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(response, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    return staple;
+}
+
+
+/* When to fetch again: half way to nextUpdate so there is time to retry */
+static time_t OcspStapleRefreshTime(OcspStaple* staple, time_t now)
+{
+    if (staple == NULL)
+        return now + WOLFSSL_OCSP_STAPLE_RETRY;
+    if (staple->nextUpdate == 0)
+        return now + WOLFSSL_OCSP_STAPLE_REFRESH;
+    if (staple->nextUpdate > now + 1)
+        return now + (staple->nextUpdate - now) / 2;
+
+    return now + WOLFSSL_OCSP_STAPLE_RETRY;
+}
+
+
+/* Free an entry that is no longer listed. Handshakes still sending its
+ * staple free the staple when done. */
+static void FreeOcspStapleEntry(OcspStapleEntry* entry, void* heap)
+{
+    OcspStapleRelease(entry->staple);
+    FreeOcspRequest(&entry->request);
+    XFREE(entry, heap, DYNAMIC_TYPE_OCSP_ENTRY);
+    (void)heap;
+}
+
+
+/* Fetch a new staple for entry and swap it in. On failure the current
+ * staple is kept until it expires. The caller marked entry as refreshing
+ * so it is not freed while the lock is not held. */
+static void RefreshOcspStaple(OcspStapleMgr* mgr, OcspStapleEntry* entry)
+{
+    OcspStaple* staple;
+    OcspStaple* old = NULL;
+    time_t      now;
+    int         removed;
+
+    /* request is never changed once the entry is listed */
+    staple = FetchOcspStaple(mgr, &entry->request);
+    now = XTIME(0);
+
+    if (wc_LockMutex(&mgr->lock) != 0) {
+        WOLFSSL_MSG("wc_LockMutex failed");
+        if (staple != NULL)
+            FreeOcspStaple(staple, mgr->cm->heap);
+        return;
+    }
+    entry->refreshing = 0;
+    removed = entry->removed;
+    if (removed) {
+        old = staple;
+    }
+    else if (staple != NULL) {
+        old = entry->staple;
+        entry->staple = staple;
+    }
+    else {
+        WOLFSSL_MSG("OCSP staple refresh failed, keeping current staple");
+    }
+    entry->refreshAt = OcspStapleRefreshTime(staple, now);
+    wc_UnLockMutex(&mgr->lock);
+
+    /* handshakes still sending the old staple free it when done */
+    OcspStapleRelease(old);
+    if (removed)
+        FreeOcspStapleEntry(entry, mgr->cm->heap);
+}
+
+
+/* Refresh thread, sleeps until the next entry is due */
+static void* OcspStapleThread(void* arg)
+{
+    OcspStapleMgr* mgr = (OcspStapleMgr*)arg;
+
+    WOLFSSL_ENTER("OcspStapleThread");
+
+    if (wc_LockMutex(&mgr->lock) != 0) {
+        WOLFSSL_MSG("wc_LockMutex failed");
+        return NULL;
+    }
+
+    while (!mgr->stop) {
+        OcspStapleEntry* entry;
+        OcspStapleEntry* due  = NULL;
+        time_t           now  = XTIME(0);
+        time_t           next = 0;
+
+        for (entry = mgr->entries; entry != NULL; entry = entry->next) {
+            if (entry->refreshAt <= now) {
+                due = entry;
+                break;
+            }
+            if (next == 0 || entry->refreshAt < next)
+                next = entry->refreshAt;
+        }
+
+        if (due != NULL) {
+            due->refreshing = 1;
+            wc_UnLockMutex(&mgr->lock);
+            RefreshOcspStaple(mgr, due);
+            if (wc_LockMutex(&mgr->lock) != 0) {
+                WOLFSSL_MSG("wc_LockMutex failed");
+                return NULL;
+            }
+        }
+        else if (next == 0) {
+            pthread_cond_wait(&mgr->cond, &mgr->lock);
+        }
+        else {
+            struct timespec ts;
+
+            /* XTIME may be a user clock, only use it for the interval */
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_sec += next - now;
+            pthread_cond_timedwait(&mgr->cond, &mgr->lock, &ts);
+        }
+    }
+
+    wc_UnLockMutex(&mgr->lock);
+
+    return NULL;
+}
+
+
+/* Keep a fresh staple for cert. The first response is fetched now, before
+ * any handshake needs it, then a background thread refreshes it ahead of
+ * nextUpdate. entry is set even if the first fetch fails, the thread keeps
+ * retrying. 0 on success */
+int OcspStapleMgrAdd(WOLFSSL_OCSP* ocsp, DecodedCert* cert,
+                     OcspStapleEntry** entry)
+{
+    OcspStapleMgr*   mgr;
+    OcspStapleEntry* newEntry;
+    void*            heap = ocsp->cm->heap;
+    int              ret  = 0;
+
+    WOLFSSL_ENTER("OcspStapleMgrAdd");
+
+    if (ocsp->stapleMgr == NULL) {
+        mgr = (OcspStapleMgr*)XMALLOC(sizeof(OcspStapleMgr), heap,
+                                                             DYNAMIC_TYPE_OCSP);
+        if (mgr == NULL)
+            return MEMORY_E;
+        XMEMSET(mgr, 0, sizeof(OcspStapleMgr));
+        mgr->cm = ocsp->cm;
+        if (wc_InitMutex(&mgr->lock) != 0) {
+            XFREE(mgr, heap, DYNAMIC_TYPE_OCSP);
+            return BAD_MUTEX_E;
+        }
+        if (pthread_cond_init(&mgr->cond, NULL) != 0) {
+            wc_FreeMutex(&mgr->lock);
+            XFREE(mgr, heap, DYNAMIC_TYPE_OCSP);
+            return BAD_COND_E;
+        }
+        ocsp->stapleMgr = mgr;
+    }
+    mgr = ocsp->stapleMgr;
+
+    newEntry = (OcspStapleEntry*)XMALLOC(sizeof(OcspStapleEntry), heap,
+                                                       DYNAMIC_TYPE_OCSP_ENTRY);
+    if (newEntry == NULL)
+        return MEMORY_E;
+    XMEMSET(newEntry, 0, sizeof(OcspStapleEntry));
+
+    ret = InitOcspRequest(&newEntry->request, cert, 0, heap);
+    if (ret != 0) {
+        XFREE(newEntry, heap, DYNAMIC_TYPE_OCSP_ENTRY);
+        return ret;
+    }
+
+    newEntry->staple = FetchOcspStaple(mgr, &newEntry->request);
+    newEntry->refreshAt = OcspStapleRefreshTime(newEntry->staple, XTIME(0));
+    if (newEntry->staple == NULL) {
+        WOLFSSL_MSG("First OCSP staple fetch failed, retrying in background");
+    }
+
+    if (wc_LockMutex(&mgr->lock) != 0) {
+        FreeOcspRequest(&newEntry->request);
+        if (newEntry->staple != NULL)
+            FreeOcspStaple(newEntry->staple, heap);
+        XFREE(newEntry, heap, DYNAMIC_TYPE_OCSP_ENTRY);
+        return BAD_MUTEX_E;
+    }
+
+    newEntry->next = mgr->entries;
+    mgr->entries = newEntry;
+
+    if (mgr->tid == 0) {
+        if (pthread_create(&mgr->tid, NULL, OcspStapleThread, mgr) != 0) {
+            WOLFSSL_MSG("OCSP staple thread creation error");
+            mgr->tid = 0;
+            ret = THREAD_CREATE_E;
+        }
+    }
+    else {
+        pthread_cond_signal(&mgr->cond);  /* new entry may be due first */
+    }
+
+    wc_UnLockMutex(&mgr->lock);
+
+    /* entry stays listed and is freed with the manager */
+    *entry = newEntry;
+
+    return ret;
+}
+
+
+/* Stop refreshing the staple of *entry, when its certificate is replaced
+ * or a new entry is added for it, and set *entry to NULL */
+void OcspStapleMgrRemove(WOLFSSL_CERT_MANAGER* cm, OcspStapleEntry** entry)
+{
+    OcspStapleMgr*    mgr;
+    OcspStapleEntry** prev;
+    int               doFree;
+
+    WOLFSSL_ENTER("OcspStapleMgrRemove");
+
+    if (cm == NULL || entry == NULL || *entry == NULL)
+        return;
+    if (cm->ocsp_stapling == NULL || cm->ocsp_stapling->stapleMgr == NULL) {
+        *entry = NULL;
+        return;
+    }
+    mgr = cm->ocsp_stapling->stapleMgr;
+
+    if (wc_LockMutex(&mgr->lock) != 0) {
+        WOLFSSL_MSG("wc_LockMutex failed");
+        return;
+    }
+    for (prev = &mgr->entries; *prev != NULL; prev = &(*prev)->next) {
+        if (*prev == *entry) {
+            *prev = (*entry)->next;
+            break;
+        }
+    }
+    /* a fetch in progress frees the entry when it finishes */
+    (*entry)->removed = 1;
+    doFree = !(*entry)->refreshing;
+    wc_UnLockMutex(&mgr->lock);
+
+    if (doFree)
+        FreeOcspStapleEntry(*entry, cm->heap);
+    *entry = NULL;
+}
+
+
+/* Stop the refresh thread and free all entries and staples */
+void FreeOcspStapleMgr(OcspStapleMgr* mgr, void* heap)
+{
+    OcspStapleEntry *entry, *next;
+
+    WOLFSSL_ENTER("FreeOcspStapleMgr");
+
+    if (mgr->tid != 0) {
+        if (wc_LockMutex(&mgr->lock) == 0) {
+            mgr->stop = 1;
+            pthread_cond_signal(&mgr->cond);
+            wc_UnLockMutex(&mgr->lock);
+            pthread_join(mgr->tid, NULL);
+        }
+        else {
+            WOLFSSL_MSG("wc_LockMutex failed, can't stop OCSP staple thread");
+        }
+    }
+
+    for (entry = mgr->entries; entry != NULL; entry = next) {
+        next = entry->next;
+        /* no connections are left using the cert manager's staples */
+        if (entry->staple != NULL && --entry->staple->refCount == 0)
+            FreeOcspStaple(entry->staple, heap);
+        FreeOcspRequest(&entry->request);
+        XFREE(entry, heap, DYNAMIC_TYPE_OCSP_ENTRY);
+    }
+
+    pthread_cond_destroy(&mgr->cond);
+    wc_FreeMutex(&mgr->lock);
+    XFREE(mgr, heap, DYNAMIC_TYPE_OCSP);
+    (void)heap;
+}
+
+#endif /* WOLFSSL_OCSP_STAPLE_MGR */
+
 #if defined(OPENSSL_ALL) || defined(WOLFSSL_NGINX) || defined(WOLFSSL_HAPROXY) || \
     defined(WOLFSSL_APACHE_HTTPD)
 
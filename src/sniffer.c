@@ -2719,6 +2719,9 @@ static int DoHandShake(const byte* input, int* sslBytes,
             Trace(GOT_CLIENT_KEY_EX_STR);
 #ifdef HAVE_EXTENDED_MASTER
             if (session->flags.expectEms && session->hash != NULL) {
+                /* copied contexts replace anything hashed so far */
+                FlushHandshakeHashes(session->sslServer);
+                FlushHandshakeHashes(session->sslClient);
                 if (HashCopy(session->sslServer->hsHashes,
                              session->hash) == 0 &&
                     HashCopy(session->sslClient->hsHashes,
@@ -69,6 +69,10 @@
 
 #include <wolfssl/wolfcrypt/wc_encrypt.h>
 
+#if defined(HAVE_CERT_COMPRESSION) && defined(HAVE_LIBZ)
+    #include <wolfssl/wolfcrypt/compress.h>
+#endif
+
 #ifdef OPENSSL_EXTRA
     /* openssl headers begin */
     #include <wolfssl/openssl/aes.h>
@@ -2115,6 +2119,767 @@ int wolfSSL_SNI_GetFromBuffer(const byte* clientHello, word32 helloSz,
     return BAD_FUNC_ARG;
 }
 
+#ifdef WOLFSSL_SNI_CERT_STORE
+
+#define SNI_CERT_STORE_HASH_INIT  2166136261U   /* FNV-1a offset basis */
+#define SNI_CERT_STORE_HASH_PRIME 16777619U     /* FNV-1a prime */
+
+/* Host names are not case sensitive - compare in lower case. */
+static WC_INLINE byte SNICertStore_ToLower(byte c)
+{
+    return (c >= 'A' && c <= 'Z') ? (byte)(c + ('a' - 'A')) : c;
+}
+
+/* Continue the hash of a lower case name with more characters.
+ *
+ * hash    The hash so far.
+ * name    The characters to hash.
+ * nameSz  The number of characters.
+ * returns the new hash.
+ */
+static word32 SNICertStore_Hash(word32 hash, const byte* name, word16 nameSz)
+{
+    word16 i;
+
+    for (i = 0; i < nameSz; i++) {
+        hash ^= SNICertStore_ToLower(name[i]);
+        hash *= SNI_CERT_STORE_HASH_PRIME;
+    }
+
+    return hash;
+}
+
+/* Compare a stored, lower case name with a received name. */
+static int SNICertStore_NameMatch(const char* stored, const byte* name,
+                                  word16 nameSz)
+{
+    word16 i;
+
+    for (i = 0; i < nameSz; i++) {
+        if ((byte)stored[i] != SNICertStore_ToLower(name[i]))
+            return 0;
+    }
+
+    return 1;
+}
+
+/* Find the entry in a bucket with the name.
+ * Only call when the store is locked.
+ *
+ * store   The certificate store.
+ * hash    The hash of the name to find.
+ * prefix  '*' when finding a wildcard name and otherwise 0.
+ * name    The name, or the domain of the wildcard name, to find.
+ * nameSz  The length of name.
+ * returns the entry or NULL when not found.
+ */
+static SNICertEntry* SNICertStore_Get(SNICertStore* store, word32 hash,
+                                      byte prefix, const byte* name,
+                                      word16 nameSz)
+{
+    SNICertEntry* entry = store->buckets[hash & (store->bucketCnt - 1)];
+    word16        skip = (prefix != 0) ? 1 : 0;
+
+    for (; entry != NULL; entry = entry->next) {
+        if (entry->hash == hash && entry->nameSz == nameSz + skip &&
+                (prefix == 0 || entry->name[0] == (char)prefix) &&
+                SNICertStore_NameMatch(entry->name + skip, name, nameSz)) {
+            break;
+        }
+    }
+
+    return entry;
+}
+
+/* Find the entry that matches a received server name.
+ * An exact match is preferred over a wildcard match. A wildcard name
+ * ("*.example.com") matches one label only, as in RFC 6125, and so is found
+ * by a single lookup of the parent domain.
+ * Only call when the store is locked.
+ *
+ * store   The certificate store.
+ * name    The server name.
+ * nameSz  The length of the server name.
+ * returns the entry or NULL when no entry matches.
+ */
+static SNICertEntry* SNICertStore_Match(SNICertStore* store, const byte* name,
+                                        word16 nameSz)
+{
+    SNICertEntry* entry;
+    word32        hash;
+    word16        i;
+
+    hash = SNICertStore_Hash(SNI_CERT_STORE_HASH_INIT, name, nameSz);
+    entry = SNICertStore_Get(store, hash, 0, name, nameSz);
+    if (entry != NULL || name[0] == '*' || name[0] == '.')
+        return entry;
+
+    /* Wildcard of the parent domain */
+    for (i = 1; i < nameSz - 1 && name[i] != '.'; i++) {
+    }
+    if (i >= nameSz - 1)
+        return NULL;
+
+    hash = SNICertStore_Hash(SNI_CERT_STORE_HASH_INIT, (const byte*)"*", 1);
+    hash = SNICertStore_Hash(hash, name + i, nameSz - i);
+    return SNICertStore_Get(store, hash, '*', name + i, nameSz - i);
+}
+
+/* Dispose of an entry and its certificate and private key. */
+static void SNICertEntry_Free(SNICertEntry* entry, void* heap)
+{
+    (void)heap;
+
+    if (entry->certSrc != NULL)
+        XFREE(entry->certSrc, heap, DYNAMIC_TYPE_CERT);
+    if (entry->keySrc != NULL) {
+        ForceZero(entry->keySrc, entry->keySrcSz);
+        XFREE(entry->keySrc, heap, DYNAMIC_TYPE_PRIVATE_KEY);
+    }
+#ifndef NO_FILESYSTEM
+    if (entry->certFile != NULL)
+        XFREE(entry->certFile, heap, DYNAMIC_TYPE_FILE);
+    if (entry->keyFile != NULL)
+        XFREE(entry->keyFile, heap, DYNAMIC_TYPE_FILE);
+#endif
+    FreeDer(&entry->cert);
+    FreeDer(&entry->key);
+    XFREE(entry, heap, DYNAMIC_TYPE_TMP_BUFFER);
+}
+
+/* Dispose of the certificate store and all entries. */
+void FreeSNICertStore(SNICertStore* store, void* heap)
+{
+    SNICertEntry* entry;
+    SNICertEntry* next;
+    word32        i;
+
+    for (i = 0; i < store->bucketCnt; i++) {
+        for (entry = store->buckets[i]; entry != NULL; entry = next) {
+            next = entry->next;
+            SNICertEntry_Free(entry, heap);
+        }
+    }
+    wc_FreeMutex(&store->lock);
+    XFREE(store->buckets, heap, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(store, heap, DYNAMIC_TYPE_TMP_BUFFER);
+}
+
+/* Double the number of buckets when the average chain is too long.
+ * The store is not changed when memory can't be allocated.
+ * Only call when the store is locked.
+ */
+static void SNICertStore_Grow(SNICertStore* store, void* heap)
+{
+    SNICertEntry** buckets;
+    SNICertEntry*  entry;
+    SNICertEntry*  next;
+    word32         cnt = store->bucketCnt * 2;
+    word32         i;
+
+    (void)heap;
+
+    buckets = (SNICertEntry**)XMALLOC(cnt * sizeof(SNICertEntry*), heap,
+                                      DYNAMIC_TYPE_TMP_BUFFER);
+    if (buckets == NULL)
+        return;
+    XMEMSET(buckets, 0, cnt * sizeof(SNICertEntry*));
+
+    for (i = 0; i < store->bucketCnt; i++) {
+        for (entry = store->buckets[i]; entry != NULL; entry = next) {
+            next = entry->next;
+            entry->next = buckets[entry->hash & (cnt - 1)];
+            buckets[entry->hash & (cnt - 1)] = entry;
+        }
+    }
+
+    XFREE(store->buckets, heap, DYNAMIC_TYPE_TMP_BUFFER);
+    store->buckets = buckets;
+    store->bucketCnt = cnt;
+}
+
+/* Get the CTX's certificate store - creating it when not there. */
+static SNICertStore* SNICertStore_Create(WOLFSSL_CTX* ctx)
+{
+    SNICertStore* store = ctx->sniCertStore;
+
+    if (store != NULL)
+        return store;
+
+    store = (SNICertStore*)XMALLOC(sizeof(SNICertStore), ctx->heap,
+                                   DYNAMIC_TYPE_TMP_BUFFER);
+    if (store == NULL)
+        return NULL;
+    XMEMSET(store, 0, sizeof(SNICertStore));
+
+    store->bucketCnt = SNI_CERT_STORE_MIN_BUCKETS;
+    store->buckets = (SNICertEntry**)XMALLOC(
+                                 store->bucketCnt * sizeof(SNICertEntry*),
+                                 ctx->heap, DYNAMIC_TYPE_TMP_BUFFER);
+    if (store->buckets == NULL) {
+        XFREE(store, ctx->heap, DYNAMIC_TYPE_TMP_BUFFER);
+        return NULL;
+    }
+    XMEMSET(store->buckets, 0, store->bucketCnt * sizeof(SNICertEntry*));
+    if (wc_InitMutex(&store->lock) != 0) {
+        XFREE(store->buckets, ctx->heap, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(store, ctx->heap, DYNAMIC_TYPE_TMP_BUFFER);
+        return NULL;
+    }
+
+    ctx->sniCertStore = store;
+    return store;
+}
+
+/* Create an entry for a server name.
+ * The name is kept in lower case.
+ *
+ * name  The server name - a wildcard name starts with "*.".
+ * heap  The heap hint for allocation.
+ * returns the entry or NULL when the name is invalid or out of memory.
+ */
+static SNICertEntry* SNICertEntry_New(const char* name, void* heap)
+{
+    SNICertEntry* entry;
+    word32        nameSz;
+    word16        i;
+
+    (void)heap;
+
+    nameSz = (word32)XSTRLEN(name);
+    if (nameSz == 0 || nameSz > SNI_CERT_STORE_MAX_NAME_SZ)
+        return NULL;
+    if (name[0] == '*' && (nameSz < 3 || name[1] != '.'))
+        return NULL;
+
+    entry = (SNICertEntry*)XMALLOC(sizeof(SNICertEntry) + nameSz + 1, heap,
+                                   DYNAMIC_TYPE_TMP_BUFFER);
+    if (entry == NULL)
+        return NULL;
+    XMEMSET(entry, 0, sizeof(SNICertEntry));
+
+    entry->name = (char*)(entry + 1);
+    for (i = 0; i < nameSz; i++)
+        entry->name[i] = (char)SNICertStore_ToLower((byte)name[i]);
+    entry->name[nameSz] = '\0';
+    entry->nameSz = (word16)nameSz;
+    entry->hash = SNICertStore_Hash(SNI_CERT_STORE_HASH_INIT,
+                                    (const byte*)entry->name, entry->nameSz);
+
+    return entry;
+}
+
+/* Put an entry into the CTX's store, replacing any with the same name.
+ * The store owns the entry even on failure.
+ *
+ * ctx    The SSL/TLS CTX object.
+ * entry  The new entry.
+ * returns WOLFSSL_SUCCESS on success and otherwise failure.
+ */
+static int SNICertStore_Insert(WOLFSSL_CTX* ctx, SNICertEntry* entry)
+{
+    SNICertStore*  store;
+    SNICertEntry** prev;
+
+    store = SNICertStore_Create(ctx);
+    if (store == NULL) {
+        SNICertEntry_Free(entry, ctx->heap);
+        return MEMORY_E;
+    }
+    if (wc_LockMutex(&store->lock) != 0) {
+        SNICertEntry_Free(entry, ctx->heap);
+        return BAD_MUTEX_E;
+    }
+
+    prev = &store->buckets[entry->hash & (store->bucketCnt - 1)];
+    for (; *prev != NULL; prev = &(*prev)->next) {
+        if ((*prev)->hash == entry->hash && (*prev)->nameSz == entry->nameSz &&
+                XMEMCMP((*prev)->name, entry->name, entry->nameSz) == 0) {
+            SNICertEntry* old = *prev;
+
+            *prev = old->next;
+            SNICertEntry_Free(old, ctx->heap);
+            store->count--;
+            break;
+        }
+    }
+
+    if (store->count >= store->bucketCnt * 2)
+        SNICertStore_Grow(store, ctx->heap);
+    entry->id = store->nextId++;
+    prev = &store->buckets[entry->hash & (store->bucketCnt - 1)];
+    entry->next = *prev;
+    *prev = entry;
+    store->count++;
+
+    wc_UnLockMutex(&store->lock);
+
+    return WOLFSSL_SUCCESS;
+}
+
+#ifndef NO_FILESYSTEM
+/* Read all of a file into a new buffer. */
+static int SNICertStore_ReadFile(const char* fname, byte** buf, word32* sz,
+                                 int dynType, void* heap)
+{
+    XFILE file;
+    long  fileSz;
+    int   ret = 0;
+
+    (void)heap;
+
+    file = XFOPEN(fname, "rb");
+    if (file == XBADFILE)
+        return WOLFSSL_BAD_FILE;
+    if (XFSEEK(file, 0, XSEEK_END) != 0) {
+        XFCLOSE(file);
+        return WOLFSSL_BAD_FILE;
+    }
+    fileSz = XFTELL(file);
+    XREWIND(file);
+    if (fileSz > MAX_WOLFSSL_FILE_SIZE || fileSz <= 0) {
+        XFCLOSE(file);
+        return WOLFSSL_BAD_FILE;
+    }
+
+    *buf = (byte*)XMALLOC(fileSz, heap, dynType);
+    if (*buf == NULL)
+        ret = MEMORY_E;
+    else if ((long)XFREAD(*buf, 1, fileSz, file) != fileSz)
+        ret = WOLFSSL_BAD_FILE;
+    else
+        *sz = (word32)fileSz;
+    XFCLOSE(file);
+
+    if (ret != 0 && *buf != NULL) {
+        XFREE(*buf, heap, dynType);
+        *buf = NULL;
+    }
+    return ret;
+}
+#endif /* !NO_FILESYSTEM */
+
+/* Decode a certificate or private key as added into a DER buffer. */
+static int SNICertStore_Decode(const byte* src, word32 srcSz, int format,
+                               int type, DerBuffer** der, void* heap)
+{
+    int ret;
+
+    if (format == WOLFSSL_FILETYPE_PEM) {
+    #ifdef WOLFSSL_PEM_TO_DER
+        ret = PemToDer(src, srcSz, type, der, heap, NULL, NULL);
+    #else
+        ret = NOT_COMPILED_IN;
+    #endif
+    }
+    else {
+        ret = AllocDer(der, srcSz, type, heap);
+        if (ret == 0)
+            XMEMCPY((*der)->buffer, src, srcSz);
+    }
+
+    return ret;
+}
+
+/* Copy a DER buffer so it can be used without the store locked. */
+static int SNICertStore_CopyDer(const DerBuffer* src, DerBuffer** dst,
+                                void* heap)
+{
+    int ret;
+
+    ret = AllocDer(dst, src->length, src->type, heap);
+    if (ret == 0)
+        XMEMCPY((*dst)->buffer, src->buffer, src->length);
+
+    return ret;
+}
+
+/* Copy the sources of an entry that is not loaded yet so that it can be
+ * loaded without the store locked.
+ * Only call when the store is locked.
+ */
+static SNICertEntry* SNICertEntry_Copy(const SNICertEntry* entry, void* heap)
+{
+    SNICertEntry* copy;
+    int           ok = 1;
+
+    copy = SNICertEntry_New(entry->name, heap);
+    if (copy == NULL)
+        return NULL;
+    copy->id = entry->id;
+    copy->format = entry->format;
+
+    if (entry->certSrc != NULL) {
+        copy->certSrc = (byte*)XMALLOC(entry->certSrcSz, heap,
+                                       DYNAMIC_TYPE_CERT);
+        if (copy->certSrc == NULL)
+            ok = 0;
+        else {
+            XMEMCPY(copy->certSrc, entry->certSrc, entry->certSrcSz);
+            copy->certSrcSz = entry->certSrcSz;
+        }
+    }
+    if (ok && entry->keySrc != NULL) {
+        copy->keySrc = (byte*)XMALLOC(entry->keySrcSz, heap,
+                                      DYNAMIC_TYPE_PRIVATE_KEY);
+        if (copy->keySrc == NULL)
+            ok = 0;
+        else {
+            XMEMCPY(copy->keySrc, entry->keySrc, entry->keySrcSz);
+            copy->keySrcSz = entry->keySrcSz;
+        }
+    }
+#ifndef NO_FILESYSTEM
+    if (ok && entry->certFile != NULL && entry->keyFile != NULL) {
+        word32 certFileSz = (word32)XSTRLEN(entry->certFile) + 1;
+        word32 keyFileSz = (word32)XSTRLEN(entry->keyFile) + 1;
+
+        copy->certFile = (char*)XMALLOC(certFileSz, heap, DYNAMIC_TYPE_FILE);
+        copy->keyFile = (char*)XMALLOC(keyFileSz, heap, DYNAMIC_TYPE_FILE);
+        if (copy->certFile == NULL || copy->keyFile == NULL)
+            ok = 0;
+        else {
+            XMEMCPY(copy->certFile, entry->certFile, certFileSz);
+            XMEMCPY(copy->keyFile, entry->keyFile, keyFileSz);
+        }
+    }
+#endif
+
+    if (!ok) {
+        SNICertEntry_Free(copy, heap);
+        copy = NULL;
+    }
+    return copy;
+}
+
+/* Load the certificate and private key of an entry.
+ * Files are read and PEM is converted to DER.
+ * Called on a copy of the entry so the store is not locked while loading.
+ */
+static int SNICertEntry_Load(SNICertEntry* entry, void* heap)
+{
+    int ret = 0;
+
+#ifndef NO_FILESYSTEM
+    if (entry->certSrc == NULL && entry->certFile != NULL) {
+        ret = SNICertStore_ReadFile(entry->certFile, &entry->certSrc,
+                                    &entry->certSrcSz, DYNAMIC_TYPE_CERT, heap);
+        if (ret == 0) {
+            ret = SNICertStore_ReadFile(entry->keyFile, &entry->keySrc,
+                                        &entry->keySrcSz,
+                                        DYNAMIC_TYPE_PRIVATE_KEY, heap);
+        }
+    }
+#endif
+    if (ret == 0 && (entry->certSrc == NULL || entry->keySrc == NULL))
+        ret = NO_PRIVATE_KEY;
+    if (ret == 0) {
+        ret = SNICertStore_Decode(entry->certSrc, entry->certSrcSz,
+                                  entry->format, CERT_TYPE, &entry->cert, heap);
+    }
+    if (ret == 0) {
+        ret = SNICertStore_Decode(entry->keySrc, entry->keySrcSz,
+                                  entry->format, PRIVATEKEY_TYPE, &entry->key,
+                                  heap);
+    }
+    if (ret != 0) {
+        FreeDer(&entry->cert);
+        FreeDer(&entry->key);
+    }
+
+    return ret;
+}
+
+/* Keep the decoded certificate and private key in the store's entry so that
+ * later handshakes don't load them again.
+ * Nothing is kept when the entry was replaced or loaded in the meantime.
+ *
+ * store   The certificate store.
+ * name    The server name the entry was found with.
+ * nameSz  The length of the server name.
+ * loaded  The copy of the entry that was loaded.
+ * heap    The heap hint for allocation.
+ */
+static void SNICertStore_Loaded(SNICertStore* store, const byte* name,
+                                word16 nameSz, const SNICertEntry* loaded,
+                                void* heap)
+{
+    SNICertEntry* entry;
+
+    if (wc_LockMutex(&store->lock) != 0)
+        return;
+
+    entry = SNICertStore_Match(store, name, nameSz);
+    if (entry != NULL && entry->id == loaded->id && !entry->loaded) {
+        if (SNICertStore_CopyDer(loaded->cert, &entry->cert, heap) == 0 &&
+                SNICertStore_CopyDer(loaded->key, &entry->key, heap) == 0) {
+            /* Sources no longer needed. */
+            if (entry->certSrc != NULL) {
+                XFREE(entry->certSrc, heap, DYNAMIC_TYPE_CERT);
+                entry->certSrc = NULL;
+            }
+            if (entry->keySrc != NULL) {
+                ForceZero(entry->keySrc, entry->keySrcSz);
+                XFREE(entry->keySrc, heap, DYNAMIC_TYPE_PRIVATE_KEY);
+                entry->keySrc = NULL;
+            }
+            entry->loaded = 1;
+        }
+        else {
+            FreeDer(&entry->cert);
+            FreeDer(&entry->key);
+        }
+    }
+
+    wc_UnLockMutex(&store->lock);
+}
+
+/* Use the certificate and private key for the server name received in the
+ * ClientHello.
+ * The store is only locked to find the entry and copy out its data. Loading
+ * on first use and parsing for the connection are done without the lock.
+ *
+ * ssl     The SSL/TLS object.
+ * name    The server name.
+ * nameSz  The length of the server name.
+ * returns 1 when a certificate was found and is now used, 0 when there is no
+ * certificate for the name and a negative value on error.
+ */
+int SNICertStore_Use(WOLFSSL* ssl, const byte* name, word16 nameSz)
+{
+    SNICertStore* store = ssl->ctx->sniCertStore;
+    void*         heap = ssl->ctx->heap;
+    SNICertEntry* entry;
+    SNICertEntry* load = NULL;
+    DerBuffer*    cert = NULL;
+    DerBuffer*    key = NULL;
+    int           ret = 0;
+
+    if (store == NULL || nameSz == 0)
+        return 0;
+    if (wc_LockMutex(&store->lock) != 0)
+        return BAD_MUTEX_E;
+
+    entry = SNICertStore_Match(store, name, nameSz);
+    if (entry != NULL && entry->loaded) {
+        ret = SNICertStore_CopyDer(entry->cert, &cert, heap);
+        if (ret == 0)
+            ret = SNICertStore_CopyDer(entry->key, &key, heap);
+    }
+    else if (entry != NULL) {
+        load = SNICertEntry_Copy(entry, heap);
+        if (load == NULL)
+            ret = MEMORY_E;
+    }
+
+    wc_UnLockMutex(&store->lock);
+
+    if (entry == NULL)
+        return 0;
+
+    if (load != NULL) {
+        ret = SNICertEntry_Load(load, heap);
+        if (ret == 0) {
+            SNICertStore_Loaded(store, name, nameSz, load, heap);
+            cert = load->cert;
+            key = load->key;
+            load->cert = NULL;
+            load->key = NULL;
+        }
+        SNICertEntry_Free(load, heap);
+    }
+
+    if (ret == 0) {
+        ret = wolfSSL_use_certificate_buffer(ssl, cert->buffer,
+                                  (long)cert->length, WOLFSSL_FILETYPE_ASN1);
+        if (ret == WOLFSSL_SUCCESS) {
+            ret = wolfSSL_use_PrivateKey_buffer(ssl, key->buffer,
+                                  (long)key->length, WOLFSSL_FILETYPE_ASN1);
+        }
+        if (ret == WOLFSSL_SUCCESS)
+            ret = 1;
+    }
+    FreeDer(&cert);
+    FreeDer(&key);
+
+    return ret;
+}
+
+/* Add a certificate and private key to use when the client asks for the
+ * server name. The data is copied and only decoded on first use.
+ * An entry with the same name is replaced.
+ * The CTX's certificate is used when no name in the store matches.
+ *
+ * ctx     The SSL/TLS CTX object.
+ * name    The server name. A name starting with "*." matches any one label
+ *         in its place.
+ * cert    The certificate.
+ * certSz  The length of the certificate.
+ * key     The private key.
+ * keySz   The length of the private key.
+ * format  The format of certificate and key: WOLFSSL_FILETYPE_PEM or
+ *         WOLFSSL_FILETYPE_ASN1.
+ * returns WOLFSSL_SUCCESS on success and otherwise failure.
+ */
+int wolfSSL_CTX_SNI_AddCert(WOLFSSL_CTX* ctx, const char* name,
+                            const unsigned char* cert, long certSz,
+                            const unsigned char* key, long keySz, int format)
+{
+    SNICertEntry* entry;
+
+    if (ctx == NULL || name == NULL || cert == NULL || certSz <= 0 ||
+            key == NULL || keySz <= 0 || (format != WOLFSSL_FILETYPE_PEM &&
+                                          format != WOLFSSL_FILETYPE_ASN1)) {
+        return BAD_FUNC_ARG;
+    }
+
+    entry = SNICertEntry_New(name, ctx->heap);
+    if (entry == NULL)
+        return BAD_FUNC_ARG;
+    entry->format = format;
+
+    entry->certSrc = (byte*)XMALLOC(certSz, ctx->heap, DYNAMIC_TYPE_CERT);
+    entry->keySrc = (byte*)XMALLOC(keySz, ctx->heap,
+                                   DYNAMIC_TYPE_PRIVATE_KEY);
+    if (entry->certSrc == NULL || entry->keySrc == NULL) {
+        SNICertEntry_Free(entry, ctx->heap);
+        return MEMORY_E;
+    }
+    XMEMCPY(entry->certSrc, cert, certSz);
+    entry->certSrcSz = (word32)certSz;
+    XMEMCPY(entry->keySrc, key, keySz);
+    entry->keySrcSz = (word32)keySz;
+
+    return SNICertStore_Insert(ctx, entry);
+}
+
+#ifndef NO_FILESYSTEM
+/* Add certificate and private key files to use when the client asks for the
+ * server name. The files are only read on first use.
+ * An entry with the same name is replaced.
+ *
+ * ctx       The SSL/TLS CTX object.
+ * name      The server name. A name starting with "*." matches any one
+ *           label in its place.
+ * certFile  The name of the certificate file.
+ * keyFile   The name of the private key file.
+ * format    The format of the files: WOLFSSL_FILETYPE_PEM or
+ *           WOLFSSL_FILETYPE_ASN1.
+ * returns WOLFSSL_SUCCESS on success and otherwise failure.
+ */
+int wolfSSL_CTX_SNI_AddCertFiles(WOLFSSL_CTX* ctx, const char* name,
+                                 const char* certFile, const char* keyFile,
+                                 int format)
+{
+    SNICertEntry* entry;
+    word32        certFileSz;
+    word32        keyFileSz;
+
+    if (ctx == NULL || name == NULL || certFile == NULL || keyFile == NULL ||
+            (format != WOLFSSL_FILETYPE_PEM &&
+             format != WOLFSSL_FILETYPE_ASN1)) {
+        return BAD_FUNC_ARG;
+    }
+
+    entry = SNICertEntry_New(name, ctx->heap);
+    if (entry == NULL)
+        return BAD_FUNC_ARG;
+    entry->format = format;
+
+    certFileSz = (word32)XSTRLEN(certFile) + 1;
+    keyFileSz = (word32)XSTRLEN(keyFile) + 1;
+    entry->certFile = (char*)XMALLOC(certFileSz, ctx->heap, DYNAMIC_TYPE_FILE);
+    entry->keyFile = (char*)XMALLOC(keyFileSz, ctx->heap, DYNAMIC_TYPE_FILE);
+    if (entry->certFile == NULL || entry->keyFile == NULL) {
+        SNICertEntry_Free(entry, ctx->heap);
+        return MEMORY_E;
+    }
+    XMEMCPY(entry->certFile, certFile, certFileSz);
+    XMEMCPY(entry->keyFile, keyFile, keyFileSz);
+
+    return SNICertStore_Insert(ctx, entry);
+}
+#endif /* !NO_FILESYSTEM */
+
+/* Remove the certificate and private key of a server name.
+ * Connections already using the certificate are not affected.
+ *
+ * ctx   The SSL/TLS CTX object.
+ * name  The server name as added.
+ * returns WOLFSSL_SUCCESS when removed, 0 when the name is not in the store
+ * and otherwise failure.
+ */
+int wolfSSL_CTX_SNI_RemoveCert(WOLFSSL_CTX* ctx, const char* name)
+{
+    SNICertStore*  store;
+    SNICertEntry** prev;
+    SNICertEntry*  entry;
+    word32         hash;
+    word16         nameSz;
+
+    if (ctx == NULL || name == NULL)
+        return BAD_FUNC_ARG;
+    store = ctx->sniCertStore;
+    if (store == NULL)
+        return 0;
+
+    nameSz = (word16)XSTRLEN(name);
+    hash = SNICertStore_Hash(SNI_CERT_STORE_HASH_INIT, (const byte*)name,
+                             nameSz);
+    if (wc_LockMutex(&store->lock) != 0)
+        return BAD_MUTEX_E;
+
+    prev = &store->buckets[hash & (store->bucketCnt - 1)];
+    for (; (entry = *prev) != NULL; prev = &entry->next) {
+        if (entry->hash == hash && entry->nameSz == nameSz &&
+                SNICertStore_NameMatch(entry->name, (const byte*)name,
+                                       nameSz)) {
+            *prev = entry->next;
+            store->count--;
+            break;
+        }
+    }
+
+    wc_UnLockMutex(&store->lock);
+
+    if (entry == NULL)
+        return 0;
+    SNICertEntry_Free(entry, ctx->heap);
+    return WOLFSSL_SUCCESS;
+}
+
+/* Check whether there is a certificate for a server name.
+ * Wildcard names are matched as in a handshake.
+ *
+ * ctx     The SSL/TLS CTX object.
+ * name    The server name as received from a client.
+ * nameSz  The length of the server name.
+ * returns WOLFSSL_SUCCESS when there is a certificate, 0 when not and
+ * otherwise failure.
+ */
+int wolfSSL_CTX_SNI_FindCert(WOLFSSL_CTX* ctx, const unsigned char* name,
+                             unsigned short nameSz)
+{
+    SNICertStore* store;
+    int           ret;
+
+    if (ctx == NULL || name == NULL || nameSz == 0)
+        return BAD_FUNC_ARG;
+    store = ctx->sniCertStore;
+    if (store == NULL)
+        return 0;
+
+    if (wc_LockMutex(&store->lock) != 0)
+        return BAD_MUTEX_E;
+    ret = (SNICertStore_Match(store, name, nameSz) != NULL) ?
+                                                         WOLFSSL_SUCCESS : 0;
+    wc_UnLockMutex(&store->lock);
+
+    return ret;
+}
+
+#endif /* WOLFSSL_SNI_CERT_STORE */
+
 #endif /* NO_WOLFSSL_SERVER */
 
 #endif /* HAVE_SNI */
@@ -2219,6 +2984,94 @@ int wolfSSL_CTX_UseTruncatedHMAC(WOLFSSL_CTX* ctx)
 #endif /* NO_WOLFSSL_CLIENT */
 #endif /* HAVE_TRUNCATED_HMAC */
 
+#ifdef HAVE_CERT_COMPRESSION
+
+#ifdef HAVE_LIBZ
+/* Compress the Certificate message with zlib (RFC 1950). */
+static int CertCompressZlib(const unsigned char* in, unsigned int inSz,
+                            unsigned char* out, unsigned int* outSz)
+{
+    int ret = wc_Compress(out, *outSz, in, inSz, 0);
+
+    if (ret < 0)
+        return ret;
+    *outSz = (unsigned int)ret;
+
+    return 0;
+}
+
+/* Decompress the Certificate message with zlib.
+ * Decompressed data must be exactly the expected length.
+ */
+static int CertDecompressZlib(const unsigned char* in, unsigned int inSz,
+                              unsigned char* out, unsigned int outSz)
+{
+    int ret = wc_DeCompress(out, outSz, in, inSz);
+
+    if (ret < 0)
+        return ret;
+    if ((unsigned int)ret != outSz)
+        return BUFFER_E;
+
+    return 0;
+}
+#endif /* HAVE_LIBZ */
+
+/* Register a certificate compression algorithm (RFC 8879) with the context.
+ * A client offers the algorithms that have a decompress callback and a server
+ * compresses its certificate chain, once for the context, with the first
+ * algorithm of the client's list that has a compress callback.
+ * Registering an algorithm again replaces the callbacks.
+ *
+ * ctx         SSL/TLS context object.
+ * alg         Algorithm identifier - WOLFSSL_CERT_COMPRESS_*.
+ * compress    Callback to compress with. May be NULL on a client.
+ * decompress  Callback to decompress with. May be NULL on a server.
+ *             When both are NULL, zlib uses the built-in implementation.
+ * returns WOLFSSL_SUCCESS on success, otherwise BAD_FUNC_ARG.
+ */
+int wolfSSL_CTX_UseCertCompression(WOLFSSL_CTX* ctx, unsigned short alg,
+                                   CallbackCertCompress compress,
+                                   CallbackCertDecompress decompress)
+{
+    int i;
+
+    if (ctx == NULL || alg == 0)
+        return BAD_FUNC_ARG;
+
+#ifdef HAVE_LIBZ
+    if (alg == WOLFSSL_CERT_COMPRESS_ZLIB && compress == NULL &&
+                                                        decompress == NULL) {
+        compress = CertCompressZlib;
+        decompress = CertDecompressZlib;
+    }
+#endif
+    if (compress == NULL && decompress == NULL)
+        return BAD_FUNC_ARG;
+
+    for (i = 0; i < ctx->certCompressCnt; i++) {
+        if (ctx->certCompress[i].alg == alg)
+            break;
+    }
+    if (i == MAX_CERT_COMPRESS_ALGS)
+        return BAD_FUNC_ARG;
+    if (i == ctx->certCompressCnt)
+        ctx->certCompressCnt++;
+
+    ctx->certCompress[i].alg = alg;
+    ctx->certCompress[i].compress = compress;
+    ctx->certCompress[i].decompress = decompress;
+
+#ifndef NO_CERTS
+    /* Compressed chain is cached with the encoded Certificate message. */
+    CacheCertMsg(ctx);
+#endif
+
+    return WOLFSSL_SUCCESS;
+}
+
+#endif /* HAVE_CERT_COMPRESSION */
+
 #ifdef HAVE_CERTIFICATE_STATUS_REQUEST
 
 int wolfSSL_UseOCSPStapling(WOLFSSL* ssl, byte status_type, byte options)
@@ -3467,6 +4320,10 @@ void wolfSSL_CertManagerFree(WOLFSSL_CERT_MANAGER* cm)
         wc_FreeMutex(&cm->tpLock);
         #endif
 
+        #ifdef WOLFSSL_CERT_VERIFY_CACHE
+        wolfSSL_CertManagerDisableVerifyCache(cm);
+        #endif
+
         XFREE(cm, cm->heap, DYNAMIC_TYPE_CERT_MANAGER);
     }
 
@@ -3686,6 +4543,7 @@ int wolfSSL_CertManagerUnloadCAs(WOLFSSL_CERT_MANAGER* cm)
 
     wc_UnLockMutex(&cm->caLock);
 
+    CM_VerifyCacheInvalidate(cm);
 
     return WOLFSSL_SUCCESS;
 }
@@ -3706,11 +4564,293 @@ int wolfSSL_CertManagerUnload_trust_peers(WOLFSSL_CERT_MANAGER* cm)
 
     wc_UnLockMutex(&cm->tpLock);
 
+    CM_VerifyCacheInvalidate(cm);
 
     return WOLFSSL_SUCCESS;
 }
 #endif /* WOLFSSL_TRUST_PEER_CERT */
 
+#ifdef WOLFSSL_CERT_VERIFY_CACHE
+
+/* Turn on the verified peer chain cache with room for about sz chains, 0 for
+ * CERT_VERIFY_CACHE_DEF_SZ. Any existing cache is dropped. Not thread safe
+ * with handshakes in progress, call during setup.
+ * WOLFSSL_SUCCESS on ok */
+int wolfSSL_CertManagerEnableVerifyCache(WOLFSSL_CERT_MANAGER* cm, int sz)
+{
+    CertVerifyCache* cache;
+    word32 rowCount;
+
+    WOLFSSL_ENTER("wolfSSL_CertManagerEnableVerifyCache");
+
+    if (cm == NULL || sz < 0)
+        return BAD_FUNC_ARG;
+
+    if (sz == 0)
+        sz = CERT_VERIFY_CACHE_DEF_SZ;
+    rowCount = ((word32)sz + CERT_VERIFY_CACHE_PER_ROW - 1) /
+                                                      CERT_VERIFY_CACHE_PER_ROW;
+
+    wolfSSL_CertManagerDisableVerifyCache(cm);
+
+    cache = (CertVerifyCache*)XMALLOC(sizeof(CertVerifyCache), cm->heap,
+                                      DYNAMIC_TYPE_CERT_MANAGER);
+    if (cache == NULL)
+        return MEMORY_E;
+    XMEMSET(cache, 0, sizeof(CertVerifyCache));
+
+    cache->rows = (CertVerifyCacheRow*)XMALLOC(
+                        sizeof(CertVerifyCacheRow) * rowCount, cm->heap,
+                        DYNAMIC_TYPE_CERT_MANAGER);
+    if (cache->rows == NULL) {
+        XFREE(cache, cm->heap, DYNAMIC_TYPE_CERT_MANAGER);
+        return MEMORY_E;
+    }
+    XMEMSET(cache->rows, 0, sizeof(CertVerifyCacheRow) * rowCount);
+    cache->rowCount = rowCount;
+
+    if (wc_InitMutex(&cache->lock) != 0) {
+        WOLFSSL_MSG("Bad mutex init");
+        XFREE(cache->rows, cm->heap, DYNAMIC_TYPE_CERT_MANAGER);
+        XFREE(cache, cm->heap, DYNAMIC_TYPE_CERT_MANAGER);
+        return BAD_MUTEX_E;
+    }
+
+    cm->verifyCache = cache;
+
+    return WOLFSSL_SUCCESS;
+}
+
+
+/* Turn off and free the verified peer chain cache, WOLFSSL_SUCCESS on ok */
+int wolfSSL_CertManagerDisableVerifyCache(WOLFSSL_CERT_MANAGER* cm)
+{
+    WOLFSSL_ENTER("wolfSSL_CertManagerDisableVerifyCache");
+
+    if (cm == NULL)
+        return BAD_FUNC_ARG;
+
+    if (cm->verifyCache != NULL) {
+        wc_FreeMutex(&cm->verifyCache->lock);
+        XFREE(cm->verifyCache->rows, cm->heap, DYNAMIC_TYPE_CERT_MANAGER);
+        XFREE(cm->verifyCache, cm->heap, DYNAMIC_TYPE_CERT_MANAGER);
+        cm->verifyCache = NULL;
+    }
+
+    return WOLFSSL_SUCCESS;
+}
+
+
+/* Remove all verified chains from the cache, WOLFSSL_SUCCESS on ok */
+int wolfSSL_CertManagerFlushVerifyCache(WOLFSSL_CERT_MANAGER* cm)
+{
+    CertVerifyCache* cache;
+
+    WOLFSSL_ENTER("wolfSSL_CertManagerFlushVerifyCache");
+
+    if (cm == NULL)
+        return BAD_FUNC_ARG;
+
+    cache = cm->verifyCache;
+    if (cache != NULL) {
+        if (wc_LockMutex(&cache->lock) != 0)
+            return BAD_MUTEX_E;
+
+        XMEMSET(cache->rows, 0, sizeof(CertVerifyCacheRow) * cache->rowCount);
+        cache->epoch++;
+
+        wc_UnLockMutex(&cache->lock);
+    }
+
+    return WOLFSSL_SUCCESS;
+}
+
+
+/* Get the number of cache hits and misses seen, WOLFSSL_SUCCESS on ok */
+int wolfSSL_CertManagerGetVerifyCacheStats(WOLFSSL_CERT_MANAGER* cm,
+                                           word32* hits, word32* misses)
+{
+    CertVerifyCache* cache;
+
+    if (cm == NULL || cm->verifyCache == NULL)
+        return BAD_FUNC_ARG;
+
+    cache = cm->verifyCache;
+    if (wc_LockMutex(&cache->lock) != 0)
+        return BAD_MUTEX_E;
+
+    if (hits)
+        *hits = cache->hits;
+    if (misses)
+        *misses = cache->misses;
+
+    wc_UnLockMutex(&cache->lock);
+
+    return WOLFSSL_SUCCESS;
+}
+
+
+int wolfSSL_CTX_EnableVerifyCache(WOLFSSL_CTX* ctx, int sz)
+{
+    WOLFSSL_ENTER("wolfSSL_CTX_EnableVerifyCache");
+
+    if (ctx == NULL)
+        return BAD_FUNC_ARG;
+
+    return wolfSSL_CertManagerEnableVerifyCache(ctx->cm, sz);
+}
+
+
+/* Trust store, CRL or OCSP state changed, results verified so far may no
+ * longer hold. Stale entries are dropped as they are looked up. */
+void CM_VerifyCacheInvalidate(WOLFSSL_CERT_MANAGER* cm)
+{
+    CertVerifyCache* cache;
+
+    if (cm == NULL || cm->verifyCache == NULL)
+        return;
+
+    cache = cm->verifyCache;
+    if (wc_LockMutex(&cache->lock) != 0) {
+        WOLFSSL_MSG("Verify cache lock failed, flushing unavailable");
+        return;
+    }
+    cache->epoch++;
+    wc_UnLockMutex(&cache->lock);
+}
+
+
+static CertVerifyCacheRow* VerifyCacheGetRow(CertVerifyCache* cache,
+                                             const byte* chainHash)
+{
+    word32 idx = ((word32)chainHash[0] << 24) | ((word32)chainHash[1] << 16) |
+                 ((word32)chainHash[2] <<  8) |  (word32)chainHash[3];
+
+    return &cache->rows[idx % cache->rowCount];
+}
+
+
+/* Look for a chain that verified in the current epoch and whose leaf is
+ * still within its validity period. The current epoch is returned in epoch
+ * to be passed to CM_VerifyCacheAdd() once the chain has been verified.
+ * returns 1 when found and 0 otherwise */
+int CM_VerifyCacheLookup(WOLFSSL_CERT_MANAGER* cm, const byte* chainHash,
+                         word32* epoch)
+{
+    CertVerifyCache*      cache;
+    CertVerifyCacheRow*   row;
+    CertVerifyCacheEntry* entry;
+    int                   i;
+    int                   found = 0;
+
+    if (cm == NULL || cm->verifyCache == NULL || chainHash == NULL)
+        return 0;
+
+    cache = cm->verifyCache;
+    if (wc_LockMutex(&cache->lock) != 0)
+        return 0;
+
+    if (epoch != NULL)
+        *epoch = cache->epoch;
+
+    row = VerifyCacheGetRow(cache, chainHash);
+    for (i = 0; i < CERT_VERIFY_CACHE_PER_ROW; i++) {
+        entry = &row->entries[i];
+        if (!entry->inUse || XMEMCMP(entry->chainHash, chainHash,
+                                             WC_SHA256_DIGEST_SIZE) != 0) {
+            continue;
+        }
+
+        if (entry->epoch != cache->epoch) {
+            WOLFSSL_MSG("Verify cache entry from old epoch");
+            entry->inUse = 0;
+        }
+    #ifndef NO_ASN_TIME
+        else if (!XVALIDATE_DATE(entry->notAfter, entry->notAfterFormat,
+                                                                       AFTER)) {
+            WOLFSSL_MSG("Verify cache entry past leaf not after date");
+            entry->inUse = 0;
+        }
+    #endif
+        else {
+            found = 1;
+        }
+        break;
+    }
+
+    if (found)
+        cache->hits++;
+    else
+        cache->misses++;
+
+    wc_UnLockMutex(&cache->lock);
+
+    return found;
+}
+
+
+/* Remember a chain that passed verification, 0 on success.
+ * epoch is the cache epoch from when verification started. The chain is not
+ * added when the trust store, CRL or OCSP state changed since then. */
+int CM_VerifyCacheAdd(WOLFSSL_CERT_MANAGER* cm, const byte* chainHash,
+                      word32 epoch, const DecodedCert* leaf)
+{
+    CertVerifyCache*      cache;
+    CertVerifyCacheRow*   row;
+    CertVerifyCacheEntry* entry = NULL;
+    int                   i;
+    int                   dateSz;
+
+    if (cm == NULL || chainHash == NULL || leaf == NULL)
+        return BAD_FUNC_ARG;
+
+    cache = cm->verifyCache;
+    if (cache == NULL)
+        return 0;
+
+    /* date is stored as tag, length and time string */
+    if (leaf->afterDate == NULL || leaf->afterDateLen < 2)
+        return BAD_FUNC_ARG;
+    dateSz = leaf->afterDateLen - 2;
+    if (dateSz > MAX_DATE_SIZE)
+        return BUFFER_E;
+
+    if (wc_LockMutex(&cache->lock) != 0)
+        return BAD_MUTEX_E;
+
+    if (epoch != cache->epoch) {
+        WOLFSSL_MSG("Verify cache epoch changed during verification");
+        wc_UnLockMutex(&cache->lock);
+        return 0;
+    }
+
+    row = VerifyCacheGetRow(cache, chainHash);
+    for (i = 0; i < CERT_VERIFY_CACHE_PER_ROW; i++) {
+        if (!row->entries[i].inUse || XMEMCMP(row->entries[i].chainHash,
+                                   chainHash, WC_SHA256_DIGEST_SIZE) == 0) {
+            entry = &row->entries[i];
+            break;
+        }
+    }
+    if (entry == NULL) {
+        entry = &row->entries[row->nextIdx];
+        row->nextIdx = (row->nextIdx + 1) % CERT_VERIFY_CACHE_PER_ROW;
+    }
+
+    XMEMCPY(entry->chainHash, chainHash, WC_SHA256_DIGEST_SIZE);
+    XMEMSET(entry->notAfter, 0, MAX_DATE_SIZE);
+    XMEMCPY(entry->notAfter, leaf->afterDate + 2, dateSz);
+    entry->notAfterFormat = leaf->afterDate[0];
+    entry->epoch = epoch;
+    entry->inUse = 1;
+
+    wc_UnLockMutex(&cache->lock);
+
+    return 0;
+}
+
+#endif /* WOLFSSL_CERT_VERIFY_CACHE */
+
 #endif /* NO_CERTS */
 
 #if defined(OPENSSL_EXTRA) || defined(OPENSSL_EXTRA_X509_SMALL) || \
@@ -5192,6 +6332,10 @@ static int ProcessUserChain(WOLFSSL_CTX* ctx, const unsigned char* buff,
             #ifdef WOLFSSL_TLS13
                 ctx->certChainCnt = cnt;
             #endif
+            #ifdef WOLFSSL_CERT_MSG_CACHE
+                /* Keep the encoding in step with the chain. */
+                CacheCertMsg(ctx);
+            #endif
             }
         }
 
@@ -5566,6 +6710,10 @@ int ProcessBuffer(WOLFSSL_CTX* ctx, const unsigned char* buff,
         }
         else if (ctx) {
             FreeDer(&ctx->certificate); /* Make sure previous is free'd */
+        #if defined(WOLFSSL_OCSP_STAPLE_MGR) && !defined(NO_WOLFSSL_SERVER)
+            /* managed staple is for the previous certificate */
+            OcspStapleMgrRemove(ctx->cm, &ctx->certStaple);
+        #endif
         #ifdef KEEP_OUR_CERT
             if (ctx->ourCert) {
                 if (ctx->ownOurCert) {
@@ -5576,6 +6724,9 @@ int ProcessBuffer(WOLFSSL_CTX* ctx, const unsigned char* buff,
             }
         #endif
             ctx->certificate = der;
+        #ifdef WOLFSSL_CERT_MSG_CACHE
+            CacheCertMsg(ctx);
+        #endif
         }
     }
     else if (type == PRIVATEKEY_TYPE) {
@@ -6073,6 +7224,7 @@ int wolfSSL_CertManagerFreeCRL(WOLFSSL_CERT_MANAGER* cm)
         FreeCRL(cm->crl, 1);
         cm->crl = NULL;
     }
+    CM_VerifyCacheInvalidate(cm);
     return WOLFSSL_SUCCESS;
 }
 
@@ -6135,6 +7287,7 @@ int wolfSSL_CertManagerEnableCRL(WOLFSSL_CERT_MANAGER* cm, int options)
         cm->crlEnabled = 1;
         if (options & WOLFSSL_CRL_CHECKALL)
             cm->crlCheckAll = 1;
+        CM_VerifyCacheInvalidate(cm);
     #else
         ret = NOT_COMPILED_IN;
     #endif
@@ -6150,6 +7303,7 @@ int wolfSSL_CertManagerDisableCRL(WOLFSSL_CERT_MANAGER* cm)
         return BAD_FUNC_ARG;
 
     cm->crlEnabled = 0;
+    CM_VerifyCacheInvalidate(cm);
 
     return WOLFSSL_SUCCESS;
 }
@@ -6245,6 +7399,7 @@ int wolfSSL_CertManagerEnableOCSP(WOLFSSL_CERT_MANAGER* cm, int options)
             cm->ocspSendNonce = 1;
         if (options & WOLFSSL_OCSP_CHECKALL)
             cm->ocspCheckAll = 1;
+        CM_VerifyCacheInvalidate(cm);
         #ifndef WOLFSSL_USER_IO
             cm->ocspIOCb = EmbedOcspLookup;
             cm->ocspRespFreeCb = EmbedOcspRespFree;
@@ -6265,6 +7420,7 @@ int wolfSSL_CertManagerDisableOCSP(WOLFSSL_CERT_MANAGER* cm)
         return BAD_FUNC_ARG;
 
     cm->ocspEnabled = 0;
+    CM_VerifyCacheInvalidate(cm);
 
     return WOLFSSL_SUCCESS;
 }
@@ -6418,6 +7574,8 @@ int wolfSSL_CertManagerSetOCSPOverrideURL(WOLFSSL_CERT_MANAGER* cm,
     else
         cm->ocspOverrideURL = NULL;
 
+    CM_VerifyCacheInvalidate(cm);
+
     return WOLFSSL_SUCCESS;
 }
 
@@ -6558,6 +7716,63 @@ int wolfSSL_CTX_DisableOCSPStapling(WOLFSSL_CTX* ctx)
     else
         return BAD_FUNC_ARG;
 }
+
+#if defined(WOLFSSL_OCSP_STAPLE_MGR) && !defined(NO_WOLFSSL_SERVER)
+/* Keep the OCSP staple for ctx's certificate fresh from a background thread
+ * so handshakes send a shared response and never wait on the responder.
+ * Turns on OCSP stapling. Call again after loading a new certificate.
+ * WOLFSSL_SUCCESS on ok */
+int wolfSSL_CTX_EnableOCSPStapleRefresh(WOLFSSL_CTX* ctx)
+{
+    int              ret;
+    OcspStapleEntry* entry = NULL;
+#ifdef WOLFSSL_SMALL_STACK
+    DecodedCert* cert;
+#else
+    DecodedCert  cert[1];
+#endif
+
+    WOLFSSL_ENTER("wolfSSL_CTX_EnableOCSPStapleRefresh");
+
+    if (ctx == NULL || ctx->certificate == NULL ||
+                                          ctx->certificate->buffer == NULL)
+        return BAD_FUNC_ARG;
+
+    /* keep the lookup callbacks of an already enabled stapling */
+    if (ctx->cm->ocsp_stapling == NULL) {
+        ret = wolfSSL_CertManagerEnableOCSPStapling(ctx->cm);
+        if (ret != WOLFSSL_SUCCESS)
+            return ret;
+    }
+
+#ifdef WOLFSSL_SMALL_STACK
+    cert = (DecodedCert*)XMALLOC(sizeof(DecodedCert), ctx->heap,
+                                                            DYNAMIC_TYPE_DCERT);
+    if (cert == NULL)
+        return MEMORY_E;
+#endif
+
+    InitDecodedCert(cert, ctx->certificate->buffer, ctx->certificate->length,
+                                                                     ctx->heap);
+    ret = ParseCertRelative(cert, CERT_TYPE, VERIFY, ctx->cm);
+    if (ret == 0)
+        ret = OcspStapleMgrAdd(ctx->cm->ocsp_stapling, cert, &entry);
+    FreeDecodedCert(cert);
+    if (entry != NULL) {
+        /* replaces the entry of an earlier call */
+        OcspStapleMgrRemove(ctx->cm, &ctx->certStaple);
+        ctx->certStaple = entry;
+    }
+
+#ifdef WOLFSSL_SMALL_STACK
+    XFREE(cert, ctx->heap, DYNAMIC_TYPE_DCERT);
+#endif
+
+    WOLFSSL_LEAVE("wolfSSL_CTX_EnableOCSPStapleRefresh", ret);
+
+    return ret == 0 ? WOLFSSL_SUCCESS : ret;
+}
+#endif /* WOLFSSL_OCSP_STAPLE_MGR && !NO_WOLFSSL_SERVER */
 #endif /* HAVE_CERTIFICATE_STATUS_REQUEST || HAVE_CERTIFICATE_STATUS_REQUEST_V2 */
 
 #endif /* HAVE_OCSP */
@@ -17617,6 +18832,11 @@ int wolfSSL_EVP_MD_type(const WOLFSSL_EVP_MD *md)
         XMEMSET(&ssl->msgsReceived, 0, sizeof(ssl->msgsReceived));
 
         if (ssl->hsHashes != NULL) {
+#ifdef WOLFSSL_LAZY_HS_HASH
+            /* buffer again until the next cipher suite is known */
+            ssl->hsHashes->hashMask = 0;
+            ssl->hsHashes->transcriptLen = 0;
+#endif
 #ifndef NO_OLD_TLS
 #ifndef NO_MD5
             if (wc_InitMd5_ex(&ssl->hsHashes->hashMd5, ssl->heap,
@@ -25685,6 +26905,9 @@ long wolfSSL_CTX_add_extra_chain_cert(WOLFSSL_CTX* ctx, WOLFSSL_X509* x509)
         if (ret == 0) {
             XMEMCPY(ctx->certChain->buffer, chain, idx);
         }
+    #ifdef WOLFSSL_CERT_MSG_CACHE
+        CacheCertMsg(ctx);
+    #endif
     }
 
     /* on success WOLFSSL_X509 memory is responsibility of ctx */
@@ -36962,6 +38185,10 @@ err:
         WOLFSSL_ENTER("wolfSSL_CTX_use_certificate");
 
         FreeDer(&ctx->certificate); /* Make sure previous is free'd */
+#if defined(WOLFSSL_OCSP_STAPLE_MGR) && !defined(NO_WOLFSSL_SERVER)
+        /* managed staple is for the previous certificate */
+        OcspStapleMgrRemove(ctx->cm, &ctx->certStaple);
+#endif
         ret = AllocDer(&ctx->certificate, x->derCert->length, CERT_TYPE,
                        ctx->heap);
         if (ret != 0)
@@ -36969,6 +38196,9 @@ err:
 
         XMEMCPY(ctx->certificate->buffer, x->derCert->buffer,
                 x->derCert->length);
+#ifdef WOLFSSL_CERT_MSG_CACHE
+        CacheCertMsg(ctx);
+#endif
 #ifdef KEEP_OUR_CERT
         if (ctx->ourCert != NULL && ctx->ownOurCert) {
             FreeX509(ctx->ourCert);
@@ -150,10 +150,16 @@ int BuildTlsHandshakeHash(WOLFSSL* ssl, byte* hash, word32* hashLen)
     if (ssl == NULL || hash == NULL || hashLen == NULL || *hashLen < HSHASH_SZ)
         return BAD_FUNC_ARG;
 
+    if (FlushHandshakeHashes(ssl) != 0)
+        return BAD_FUNC_ARG;
+
     /* for constant timing perform these even if error */
 #ifndef NO_OLD_TLS
-    ret |= wc_Md5GetHash(&ssl->hsHashes->hashMd5, hash);
-    ret |= wc_ShaGetHash(&ssl->hsHashes->hashSha, &hash[WC_MD5_DIGEST_SIZE]);
+    if (!IsAtLeastTLSv1_2(ssl)) {
+        ret |= wc_Md5GetHash(&ssl->hsHashes->hashMd5, hash);
+        ret |= wc_ShaGetHash(&ssl->hsHashes->hashSha,
+                             &hash[WC_MD5_DIGEST_SIZE]);
+    }
 #endif
 
     if (IsAtLeastTLSv1_2(ssl)) {
@@ -978,9 +984,12 @@ static int Hmac_UpdateFinal_CT(Hmac* hmac, byte* digest, const byte* in,
     c32toa(realLen >> ((sizeof(word32) * 8) - 3), lenBytes);
     c32toa(realLen << 3, lenBytes + sizeof(word32));
 
-    ret = Hmac_HashUpdate(hmac, (unsigned char*)hmac->ipad, blockSz);
-    if (ret != 0)
-        return ret;
+    /* The ipad may already be hashed when the key was set. */
+    if (!hmac->innerHashKeyed) {
+        ret = Hmac_HashUpdate(hmac, (unsigned char*)hmac->ipad, blockSz);
+        if (ret != 0)
+            return ret;
+    }
 
     XMEMSET(hmac->innerHash, 0, macLen);
 
@@ -2000,6 +2009,9 @@ static int TLSX_SNI_Parse(WOLFSSL* ssl, byte* input, word16 length,
             cacheOnly = 1;
             WOLFSSL_MSG("Forcing SSL object to store SNI parameter");
         #else
+        #ifdef WOLFSSL_SNI_CERT_STORE
+            if (ssl->ctx->sniCertStore == NULL)
+        #endif
             /* Skipping, SNI not enabled at server side. */
             return 0;
         #endif
@@ -2029,6 +2041,28 @@ static int TLSX_SNI_Parse(WOLFSSL* ssl, byte* input, word16 length,
     if (offset + size != length || size == 0)
         return BUFFER_ERROR;
 
+#ifdef WOLFSSL_SNI_CERT_STORE
+    /* Certificate for the name - only looked up in the first ClientHello. */
+    if (ssl->ctx->sniCertStore != NULL &&
+            TLSX_SNI_Status(ssl->extensions, type) != WOLFSSL_SNI_REAL_MATCH) {
+        int r = SNICertStore_Use(ssl, input + offset, size);
+        if (r < 0)
+            return r;
+        if (r == 1) {
+            WOLFSSL_MSG("SNI certificate store match");
+            r = TLSX_UseSNI(&ssl->extensions, type, input + offset, size,
+                                                                     ssl->heap);
+            if (r != WOLFSSL_SUCCESS)
+                return r;
+            TLSX_SNI_SetStatus(ssl->extensions, type, WOLFSSL_SNI_REAL_MATCH);
+            TLSX_SetResponse(ssl, TLSX_SERVER_NAME);
+            return 0;
+        }
+    }
+    if (!cacheOnly && (!extension || !extension->data))
+        return 0; /* no certificate for name - use default. */
+#endif
+
     if (!cacheOnly && !(sni = TLSX_SNI_Find((SNI*)extension->data, type)))
         return 0; /* not using this type of SNI. */
 
@@ -2869,6 +2903,11 @@ static void TLSX_CSR_Free(CertificateStatusRequest* csr, void* heap)
         break;
     }
 
+#if defined(WOLFSSL_TLS13) && !defined(NO_WOLFSSL_SERVER) && \
+    defined(WOLFSSL_OCSP_STAPLE_MGR)
+    OcspStapleRelease(csr->staple);
+#endif
+
     XFREE(csr, heap, DYNAMIC_TYPE_TLSX);
     (void)heap;
 }
@@ -3102,7 +3141,12 @@ static int TLSX_CSR_Parse(WOLFSSL* ssl, byte* input, word16 length,
                 return MEMORY_ERROR;
 
             request = &csr->request.ocsp;
-            ret = CreateOcspResponse(ssl, &request, &csr->response);
+        #ifdef WOLFSSL_OCSP_STAPLE_MGR
+            if (GetOcspStaple(ssl, &csr->response, &csr->staple))
+                ret = 0;
+            else
+        #endif
+                ret = CreateOcspResponse(ssl, &request, &csr->response);
             if (ret != 0)
                 return ret;
             if (csr->response.buffer)
@@ -6505,11 +6549,14 @@ static int TLSX_SetSignatureAlgorithmsCert(TLSX** extensions, const void* data,
 /* Create a key share entry using named Diffie-Hellman parameters group.
  * Generates a key pair.
  *
- * ssl   The SSL/TLS object.
- * kse   The key share entry object.
+ * heap   The heap to allocate with.
+ * devId  Device identifier for the key.
+ * rng    Random number generator.
+ * kse    The key share entry object.
  * returns 0 on success, otherwise failure.
  */
-static int TLSX_KeyShare_GenDhKey(WOLFSSL *ssl, KeyShareEntry* kse)
+static int TLSX_KeyShare_GenDhKey(void* heap, int devId, WC_RNG* rng,
+                                  KeyShareEntry* kse)
 {
     int             ret;
 #ifndef NO_DH
@@ -6562,28 +6609,28 @@ static int TLSX_KeyShare_GenDhKey(WOLFSSL *ssl, KeyShareEntry* kse)
     }
 
 #ifdef WOLFSSL_SMALL_STACK
-    dhKey = (DhKey*)XMALLOC(sizeof(DhKey), ssl->heap, DYNAMIC_TYPE_DH);
+    dhKey = (DhKey*)XMALLOC(sizeof(DhKey), heap, DYNAMIC_TYPE_DH);
     if (dhKey == NULL)
         return MEMORY_E;
 #endif
 
-    ret = wc_InitDhKey_ex(dhKey, ssl->heap, ssl->devId);
+    ret = wc_InitDhKey_ex(dhKey, heap, devId);
     if (ret != 0) {
     #ifdef WOLFSSL_SMALL_STACK
-        XFREE(dhKey, ssl->heap, DYNAMIC_TYPE_DH);
+        XFREE(dhKey, heap, DYNAMIC_TYPE_DH);
     #endif
         return ret;
     }
 
     /* Allocate space for the public key. */
     dataSz = params->p_len;
-    keyData = (byte*)XMALLOC(dataSz, ssl->heap, DYNAMIC_TYPE_PUBLIC_KEY);
+    keyData = (byte*)XMALLOC(dataSz, heap, DYNAMIC_TYPE_PUBLIC_KEY);
     if (keyData == NULL) {
         ret = MEMORY_E;
         goto end;
     }
     /* Allocate space for the private key. */
-    key = (byte*)XMALLOC(keySz, ssl->heap, DYNAMIC_TYPE_PRIVATE_KEY);
+    key = (byte*)XMALLOC(keySz, heap, DYNAMIC_TYPE_PRIVATE_KEY);
     if (key == NULL) {
         ret = MEMORY_E;
         goto end;
@@ -6597,7 +6644,7 @@ static int TLSX_KeyShare_GenDhKey(WOLFSSL *ssl, KeyShareEntry* kse)
         goto end;
 
     /* Generate a new key pair. */
-    ret = wc_DhGenerateKeyPair(dhKey, ssl->rng, (byte*)key, &keySz, keyData,
+    ret = wc_DhGenerateKeyPair(dhKey, rng, (byte*)key, &keySz, keyData,
                                &dataSz);
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* TODO: Make this function non-blocking */
@@ -6628,18 +6675,20 @@ end:
 
     wc_FreeDhKey(dhKey);
 #ifdef WOLFSSL_SMALL_STACK
-    XFREE(dhKey, ssl->heap, DYNAMIC_TYPE_DH);
+    XFREE(dhKey, heap, DYNAMIC_TYPE_DH);
 #endif
 
     if (ret != 0) {
         /* Data owned by key share entry otherwise. */
         if (keyData != NULL)
-            XFREE(keyData, ssl->heap, DYNAMIC_TYPE_PUBLIC_KEY);
+            XFREE(keyData, heap, DYNAMIC_TYPE_PUBLIC_KEY);
         if (key != NULL)
-            XFREE(key, ssl->heap, DYNAMIC_TYPE_PRIVATE_KEY);
+            XFREE(key, heap, DYNAMIC_TYPE_PRIVATE_KEY);
     }
 #else
-    (void)ssl;
+    (void)heap;
+    (void)devId;
+    (void)rng;
     (void)kse;
 
     ret = NOT_COMPILED_IN;
@@ -6651,11 +6700,14 @@ end:
 /* Create a key share entry using X25519 parameters group.
  * Generates a key pair.
  *
- * ssl   The SSL/TLS object.
- * kse   The key share entry object.
+ * heap   The heap to allocate with.
+ * devId  Device identifier for the key.
+ * rng    Random number generator.
+ * kse    The key share entry object.
  * returns 0 on success, otherwise failure.
  */
-static int TLSX_KeyShare_GenX25519Key(WOLFSSL *ssl, KeyShareEntry* kse)
+static int TLSX_KeyShare_GenX25519Key(void* heap, int devId, WC_RNG* rng,
+                                      KeyShareEntry* kse)
 {
     int             ret;
 #ifdef HAVE_CURVE25519
@@ -6663,9 +6715,11 @@ static int TLSX_KeyShare_GenX25519Key(WOLFSSL *ssl, KeyShareEntry* kse)
     word32          dataSize = CURVE25519_KEYSIZE;
     curve25519_key* key;
 
+    (void)devId;
+
     /* Allocate an ECC key to hold private key. */
     key = (curve25519_key*)XMALLOC(sizeof(curve25519_key),
-                                           ssl->heap, DYNAMIC_TYPE_PRIVATE_KEY);
+                                           heap, DYNAMIC_TYPE_PRIVATE_KEY);
     if (key == NULL) {
         WOLFSSL_MSG("EccTempKey Memory error");
         return MEMORY_E;
@@ -6675,12 +6729,12 @@ static int TLSX_KeyShare_GenX25519Key(WOLFSSL *ssl, KeyShareEntry* kse)
     ret = wc_curve25519_init(key);
     if (ret != 0)
         goto end;
-    ret = wc_curve25519_make_key(ssl->rng, CURVE25519_KEYSIZE, key);
+    ret = wc_curve25519_make_key(rng, CURVE25519_KEYSIZE, key);
     if (ret != 0)
         goto end;
 
     /* Allocate space for the public key. */
-    keyData = (byte*)XMALLOC(CURVE25519_KEYSIZE, ssl->heap,
+    keyData = (byte*)XMALLOC(CURVE25519_KEYSIZE, heap,
                                                        DYNAMIC_TYPE_PUBLIC_KEY);
     if (keyData == NULL) {
         WOLFSSL_MSG("Key data Memory error");
@@ -6708,12 +6762,14 @@ end:
     if (ret != 0) {
         /* Data owned by key share entry otherwise. */
         if (keyData != NULL)
-            XFREE(keyData, ssl->heap, DYNAMIC_TYPE_PUBLIC_KEY);
+            XFREE(keyData, heap, DYNAMIC_TYPE_PUBLIC_KEY);
         wc_curve25519_free(key);
-        XFREE(key, ssl->heap, DYNAMIC_TYPE_PRIVATE_KEY);
+        XFREE(key, heap, DYNAMIC_TYPE_PRIVATE_KEY);
     }
 #else
-    (void)ssl;
+    (void)heap;
+    (void)devId;
+    (void)rng;
     (void)kse;
 
     ret = NOT_COMPILED_IN;
@@ -6725,11 +6781,14 @@ end:
 /* Create a key share entry using named elliptic curve parameters group.
  * Generates a key pair.
  *
- * ssl   The SSL/TLS object.
- * kse   The key share entry object.
+ * heap   The heap to allocate with.
+ * devId  Device identifier for the key.
+ * rng    Random number generator.
+ * kse    The key share entry object.
  * returns 0 on success, otherwise failure.
  */
-static int TLSX_KeyShare_GenEccKey(WOLFSSL *ssl, KeyShareEntry* kse)
+static int TLSX_KeyShare_GenEccKey(void* heap, int devId, WC_RNG* rng,
+                                   KeyShareEntry* kse)
 {
     int      ret;
 #ifdef HAVE_ECC
@@ -6781,7 +6840,7 @@ static int TLSX_KeyShare_GenEccKey(WOLFSSL *ssl, KeyShareEntry* kse)
     }
 
     /* Allocate an ECC key to hold private key. */
-    keyPtr = (byte*)XMALLOC(sizeof(ecc_key), ssl->heap,
+    keyPtr = (byte*)XMALLOC(sizeof(ecc_key), heap,
                                                       DYNAMIC_TYPE_PRIVATE_KEY);
     if (keyPtr == NULL) {
         WOLFSSL_MSG("EccTempKey Memory error");
@@ -6790,10 +6849,10 @@ static int TLSX_KeyShare_GenEccKey(WOLFSSL *ssl, KeyShareEntry* kse)
     eccKey = (ecc_key*)keyPtr;
 
     /* Make an ECC key. */
-    ret = wc_ecc_init_ex(eccKey, ssl->heap, ssl->devId);
+    ret = wc_ecc_init_ex(eccKey, heap, devId);
     if (ret != 0)
         goto end;
-    ret = wc_ecc_make_key_ex(ssl->rng, keySize, eccKey, curveId);
+    ret = wc_ecc_make_key_ex(rng, keySize, eccKey, curveId);
 #ifdef WOLFSSL_ASYNC_CRYPT
     /* TODO: Make this function non-blocking */
     if (ret == WC_PENDING_E) {
@@ -6804,7 +6863,7 @@ static int TLSX_KeyShare_GenEccKey(WOLFSSL *ssl, KeyShareEntry* kse)
         goto end;
 
     /* Allocate space for the public key. */
-    keyData = (byte*)XMALLOC(dataSize, ssl->heap, DYNAMIC_TYPE_PUBLIC_KEY);
+    keyData = (byte*)XMALLOC(dataSize, heap, DYNAMIC_TYPE_PUBLIC_KEY);
     if (keyData == NULL) {
         WOLFSSL_MSG("Key data Memory error");
         ret = MEMORY_E;
@@ -6830,12 +6889,14 @@ end:
     if (ret != 0) {
         /* Data owned by key share entry otherwise. */
         if (keyPtr != NULL)
-            XFREE(keyPtr, ssl->heap, DYNAMIC_TYPE_PRIVATE_KEY);
+            XFREE(keyPtr, heap, DYNAMIC_TYPE_PRIVATE_KEY);
         if (keyData != NULL)
-            XFREE(keyData, ssl->heap, DYNAMIC_TYPE_PUBLIC_KEY);
+            XFREE(keyData, heap, DYNAMIC_TYPE_PUBLIC_KEY);
     }
 #else
-    (void)ssl;
+    (void)heap;
+    (void)devId;
+    (void)rng;
     (void)kse;
 
     ret = NOT_COMPILED_IN;
@@ -6844,6 +6905,28 @@ end:
     return ret;
 }
 
+/* Generate a key pair for the group of the key share entry.
+ *
+ * heap   The heap to allocate with.
+ * devId  Device identifier for the key.
+ * rng    Random number generator.
+ * kse    The key share entry object.
+ */
+static int TLSX_KeyShare_GenKey_ex(void* heap, int devId, WC_RNG* rng,
+                                   KeyShareEntry *kse)
+{
+    /* Named FFHE groups have a bit set to identify them. */
+    if ((kse->group & NAMED_DH_MASK) == NAMED_DH_MASK)
+        return TLSX_KeyShare_GenDhKey(heap, devId, rng, kse);
+    if (kse->group == WOLFSSL_ECC_X25519)
+        return TLSX_KeyShare_GenX25519Key(heap, devId, rng, kse);
+    return TLSX_KeyShare_GenEccKey(heap, devId, rng, kse);
+}
+
+#ifdef WOLFSSL_KEY_SHARE_POOL
+static int TLSX_KeySharePool_Get(WOLFSSL* ssl, KeyShareEntry* kse);
+#endif
+
 /* Generate a secret/key using the key share entry.
  *
  * ssl  The SSL/TLS object.
@@ -6851,12 +6934,12 @@ end:
  */
 static int TLSX_KeyShare_GenKey(WOLFSSL *ssl, KeyShareEntry *kse)
 {
-    /* Named FFHE groups have a bit set to identify them. */
-    if ((kse->group & NAMED_DH_MASK) == NAMED_DH_MASK)
-        return TLSX_KeyShare_GenDhKey(ssl, kse);
-    if (kse->group == WOLFSSL_ECC_X25519)
-        return TLSX_KeyShare_GenX25519Key(ssl, kse);
-    return TLSX_KeyShare_GenEccKey(ssl, kse);
+#ifdef WOLFSSL_KEY_SHARE_POOL
+    /* Use a key pair generated ahead of time when available. */
+    if (TLSX_KeySharePool_Get(ssl, kse) == 0)
+        return 0;
+#endif
+    return TLSX_KeyShare_GenKey_ex(ssl->heap, ssl->devId, ssl->rng, kse);
 }
 
 /* Free the key share dynamic data.
@@ -6882,6 +6965,10 @@ static void TLSX_KeyShare_FreeAll(KeyShareEntry* list, void* heap)
 #endif
             }
         }
+        else if (current->key != NULL) {
+            /* Private DH key is only bytes. */
+            ForceZero(current->key, current->keyLen);
+        }
         if (current->key != NULL)
             XFREE(current->key, heap, DYNAMIC_TYPE_PRIVATE_KEY);
         XFREE(current->pubKey, heap, DYNAMIC_TYPE_PUBLIC_KEY);
@@ -6892,6 +6979,217 @@ static void TLSX_KeyShare_FreeAll(KeyShareEntry* list, void* heap)
     (void)heap;
 }
 
+#ifdef WOLFSSL_KEY_SHARE_POOL
+/* Take a pre-generated key pair for the group of the key share entry.
+ * The key pair is removed from the pool so that it is only ever used once.
+ *
+ * ssl  The SSL/TLS object.
+ * kse  The key share entry object.
+ * returns 0 when a key pair was taken and BAD_STATE_E when there is none.
+ */
+static int TLSX_KeySharePool_Get(WOLFSSL* ssl, KeyShareEntry* kse)
+{
+    KeySharePool*      pool = ssl->ctx->keySharePool;
+    KeySharePoolGroup* poolGroup = NULL;
+    KeyShareEntry*     entry = NULL;
+    int                i;
+
+    /* Key pairs are allocated with and bound to the CTX's heap and device. */
+    if (pool == NULL || ssl->heap != ssl->ctx->heap ||
+                                                 ssl->devId != ssl->ctx->devId) {
+        return BAD_STATE_E;
+    }
+
+    if (wc_LockMutex(&pool->lock) != 0)
+        return BAD_MUTEX_E;
+    for (i = 0; i < pool->numGroups; i++) {
+        if (pool->groups[i].group == kse->group) {
+            poolGroup = &pool->groups[i];
+            break;
+        }
+    }
+    if (poolGroup != NULL) {
+        entry = poolGroup->list;
+        if (entry != NULL) {
+            poolGroup->list = entry->next;
+            poolGroup->cnt--;
+            poolGroup->hits++;
+        }
+        else
+            poolGroup->misses++;
+    }
+    wc_UnLockMutex(&pool->lock);
+
+    if (entry == NULL)
+        return BAD_STATE_E;
+
+    WOLFSSL_MSG("Using pre-generated key share");
+    kse->key = entry->key;
+    kse->keyLen = entry->keyLen;
+    kse->pubKey = entry->pubKey;
+    kse->pubKeyLen = entry->pubKeyLen;
+    entry->key = NULL;
+    entry->pubKey = NULL;
+    entry->next = NULL;
+    TLSX_KeyShare_FreeAll(entry, ssl->heap);
+
+    return 0;
+}
+
+/* Add a group to pool key pairs for or change the number to pool.
+ *
+ * pool   The key share pool.
+ * group  The named group.
+ * size   The maximum number of key pairs to hold for the group.
+ * returns BAD_FUNC_ARG when the group is not supported, BUFFER_E when the
+ * pool has no room for another group and 0 on success.
+ */
+int TLSX_KeySharePool_Add(KeySharePool* pool, word16 group, word32 size)
+{
+    int ret = 0;
+    int i;
+
+    if (!TLSX_KeyShare_IsSupported(group))
+        return BAD_FUNC_ARG;
+
+    if (wc_LockMutex(&pool->lock) != 0)
+        return BAD_MUTEX_E;
+    for (i = 0; i < pool->numGroups; i++) {
+        if (pool->groups[i].group == group)
+            break;
+    }
+    if (i == pool->numGroups) {
+        if (pool->numGroups == KEY_SHARE_POOL_MAX_GROUPS)
+            ret = BUFFER_E;
+        else {
+            pool->groups[i].group = group;
+            pool->numGroups++;
+        }
+    }
+    if (ret == 0)
+        pool->groups[i].size = size;
+    wc_UnLockMutex(&pool->lock);
+
+    return ret;
+}
+
+/* Generate key pairs for the groups in the pool that are not full.
+ * Key pairs are generated without holding the lock so that handshakes can
+ * take key pairs at the same time.
+ * Call from a low priority thread or when an event loop is idle.
+ *
+ * pool   The key share pool.
+ * heap   The heap of the CTX.
+ * devId  The device identifier of the CTX.
+ * max    The maximum number of key pairs to generate. 0 fills the pool.
+ * returns the number of key pairs added on success, otherwise failure.
+ */
+int TLSX_KeySharePool_Fill(KeySharePool* pool, void* heap, int devId, int max)
+{
+    int            ret = 0;
+    int            added = 0;
+    int            i;
+    int            tries;
+    word16         group;
+    KeyShareEntry* entry;
+    KeySharePoolGroup* poolGroup;
+#ifdef WOLFSSL_SMALL_STACK
+    WC_RNG*        rng;
+#else
+    WC_RNG         rng[1];
+#endif
+
+#ifdef WOLFSSL_SMALL_STACK
+    rng = (WC_RNG*)XMALLOC(sizeof(WC_RNG), heap, DYNAMIC_TYPE_RNG);
+    if (rng == NULL)
+        return MEMORY_E;
+#endif
+    ret = wc_InitRng_ex(rng, heap, devId);
+    if (ret != 0) {
+    #ifdef WOLFSSL_SMALL_STACK
+        XFREE(rng, heap, DYNAMIC_TYPE_RNG);
+    #endif
+        return ret;
+    }
+
+    /* Round robin over the groups, one key pair each time. */
+    i = 0;
+    tries = 0;
+    while (ret == 0 && (max <= 0 || added < max) &&
+                                                 tries < pool->numGroups) {
+        if (wc_LockMutex(&pool->lock) != 0) {
+            ret = BAD_MUTEX_E;
+            break;
+        }
+        poolGroup = &pool->groups[i];
+        group = poolGroup->group;
+        if (poolGroup->cnt >= poolGroup->size)
+            group = 0;
+        wc_UnLockMutex(&pool->lock);
+        i = (i + 1) % pool->numGroups;
+        if (group == 0) {
+            tries++;
+            continue;
+        }
+        tries = 0;
+
+        entry = (KeyShareEntry*)XMALLOC(sizeof(KeyShareEntry), heap,
+                                                            DYNAMIC_TYPE_TLSX);
+        if (entry == NULL) {
+            ret = MEMORY_E;
+            break;
+        }
+        XMEMSET(entry, 0, sizeof(KeyShareEntry));
+        entry->group = group;
+
+        ret = TLSX_KeyShare_GenKey_ex(heap, devId, rng, entry);
+        if (ret == 0 && wc_LockMutex(&pool->lock) != 0)
+            ret = BAD_MUTEX_E;
+        if (ret != 0) {
+            TLSX_KeyShare_FreeAll(entry, heap);
+            break;
+        }
+        /* Another thread may have filled the group in the mean time. */
+        if (poolGroup->cnt < poolGroup->size) {
+            entry->next = poolGroup->list;
+            poolGroup->list = entry;
+            poolGroup->cnt++;
+            entry = NULL;
+            added++;
+        }
+        wc_UnLockMutex(&pool->lock);
+        if (entry != NULL)
+            TLSX_KeyShare_FreeAll(entry, heap);
+    }
+
+    wc_FreeRng(rng);
+#ifdef WOLFSSL_SMALL_STACK
+    XFREE(rng, heap, DYNAMIC_TYPE_RNG);
+#endif
+
+    if (ret != 0)
+        return ret;
+    return added;
+}
+
+/* Free the key share pool, clearing the private keys.
+ *
+ * pool  The key share pool.
+ * heap  Heap hint used to allocate the pool.
+ */
+void FreeKeySharePool(KeySharePool* pool, void* heap)
+{
+    int i;
+
+    for (i = 0; i < pool->numGroups; i++)
+        TLSX_KeyShare_FreeAll(pool->groups[i].list, heap);
+    wc_FreeMutex(&pool->lock);
+    XFREE(pool, heap, DYNAMIC_TYPE_TMP_BUFFER);
+
+    (void)heap;
+}
+#endif /* WOLFSSL_KEY_SHARE_POOL */
+
 /* Get the size of the encoded key share extension.
  *
  * list     The linked list of key share extensions.
@@ -7424,6 +7722,155 @@ static int TLSX_SupportedGroups_Find(WOLFSSL* ssl, word16 name)
 }
 
 
+#ifdef WOLFSSL_KEY_SHARE_CACHE
+/* Get the identifier of the server name being connected to.
+ *
+ * ssl  The SSL/TLS object.
+ * id   Buffer to hold the hash of the server name.
+ * returns 0 on success, otherwise there is no server name or hashing failed.
+ */
+static int TLSX_KeyShareCache_Id(WOLFSSL* ssl, byte* id)
+{
+    TLSX* extension = TLSX_Find(ssl->extensions, TLSX_SERVER_NAME);
+    SNI*  sni;
+    byte  digest[WC_SHA256_DIGEST_SIZE];
+    int   ret;
+
+    if (extension == NULL)
+        extension = TLSX_Find(ssl->ctx->extensions, TLSX_SERVER_NAME);
+    sni = TLSX_SNI_Find(extension ? (SNI*)extension->data : NULL,
+                                                        WOLFSSL_SNI_HOST_NAME);
+    if (sni == NULL || sni->data.host_name == NULL)
+        return BAD_FUNC_ARG;
+
+    ret = wc_Sha256Hash((const byte*)sni->data.host_name,
+                        (word32)XSTRLEN(sni->data.host_name), digest);
+    if (ret == 0)
+        XMEMCPY(id, digest, KEY_SHARE_CACHE_ID_SZ);
+
+    return ret;
+}
+
+/* Find the entry in the cache for the server name hash.
+ *
+ * cache  The key share cache.
+ * id     Hash of the server name.
+ * returns the entry the server name maps to.
+ */
+static KeyShareCacheEntry* TLSX_KeyShareCache_Entry(KeyShareCache* cache,
+                                                    const byte* id)
+{
+    word32 row;
+
+    ato32(id, &row);
+    return &cache->entries[row % cache->cnt];
+}
+
+/* Get the group the server selected on a previous connection.
+ * Entries older than KEY_SHARE_CACHE_TIMEOUT seconds are not used.
+ *
+ * ssl    The SSL/TLS object.
+ * group  The group to send a key share for.
+ * returns 1 when a group was found and 0 otherwise.
+ */
+static int TLSX_KeyShareCache_Lookup(WOLFSSL* ssl, word16* group)
+{
+    KeyShareCache*      cache = ssl->ctx->keyShareCache;
+    KeyShareCacheEntry* entry;
+    byte                id[KEY_SHARE_CACHE_ID_SZ];
+    int                 found = 0;
+
+    if (cache == NULL || TLSX_KeyShareCache_Id(ssl, id) != 0)
+        return 0;
+
+    if (wc_LockMutex(&cache->lock) != 0)
+        return 0;
+    cache->lookups++;
+    entry = TLSX_KeyShareCache_Entry(cache, id);
+    if (entry->group != 0 &&
+                          XMEMCMP(entry->id, id, KEY_SHARE_CACHE_ID_SZ) == 0) {
+        if (LowResTimer() - entry->timeStamp >= KEY_SHARE_CACHE_TIMEOUT) {
+            entry->group = 0;
+        }
+        else if (TLSX_KeyShare_IsSupported(entry->group) &&
+                                 TLSX_SupportedGroups_Find(ssl, entry->group)) {
+            *group = entry->group;
+            cache->hits++;
+            found = 1;
+        }
+    }
+    wc_UnLockMutex(&cache->lock);
+
+    ssl->options.keySharePredicted = (word16)found;
+    return found;
+}
+
+/* Record the group the server selected.
+ *
+ * ssl    The SSL/TLS object.
+ * group  The group selected by the server.
+ * hrr    The group was selected in a HelloRetryRequest.
+ */
+static void TLSX_KeyShareCache_Set(WOLFSSL* ssl, word16 group, int hrr)
+{
+    KeyShareCache*      cache = ssl->ctx->keyShareCache;
+    KeyShareCacheEntry* entry;
+    byte                id[KEY_SHARE_CACHE_ID_SZ];
+
+    if (cache == NULL || TLSX_KeyShareCache_Id(ssl, id) != 0)
+        return;
+
+    if (wc_LockMutex(&cache->lock) != 0)
+        return;
+    if (hrr)
+        cache->hrrs++;
+    entry = TLSX_KeyShareCache_Entry(cache, id);
+    XMEMCPY(entry->id, id, KEY_SHARE_CACHE_ID_SZ);
+    entry->timeStamp = LowResTimer();
+    entry->group = group;
+    wc_UnLockMutex(&cache->lock);
+}
+
+/* Forget the group for the server when the handshake using it failed.
+ *
+ * ssl  The SSL/TLS object.
+ */
+void TLSX_KeyShareCache_Remove(WOLFSSL* ssl)
+{
+    KeyShareCache*      cache = ssl->ctx->keyShareCache;
+    KeyShareCacheEntry* entry;
+    byte                id[KEY_SHARE_CACHE_ID_SZ];
+
+    if (!ssl->options.keySharePredicted)
+        return;
+    ssl->options.keySharePredicted = 0;
+    if (cache == NULL || TLSX_KeyShareCache_Id(ssl, id) != 0)
+        return;
+
+    if (wc_LockMutex(&cache->lock) != 0)
+        return;
+    entry = TLSX_KeyShareCache_Entry(cache, id);
+    if (XMEMCMP(entry->id, id, KEY_SHARE_CACHE_ID_SZ) == 0)
+        entry->group = 0;
+    wc_UnLockMutex(&cache->lock);
+}
+
+/* Free the key share cache.
+ *
+ * cache  The key share cache.
+ * heap   Heap hint used to allocate the cache.
+ */
+void FreeKeyShareCache(KeyShareCache* cache, void* heap)
+{
+    wc_FreeMutex(&cache->lock);
+    XFREE(cache->entries, heap, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(cache, heap, DYNAMIC_TYPE_TMP_BUFFER);
+
+    (void)heap;
+}
+#endif /* WOLFSSL_KEY_SHARE_CACHE */
+
+
 /* Parse the KeyShare extension.
  * Different formats in different messages.
  *
@@ -7504,6 +7951,10 @@ static int TLSX_KeyShare_Parse(WOLFSSL* ssl, byte* input, word16 length,
         ret = TLSX_KeyShare_Process(ssl, keyShareEntry);
         if (ret == 0)
             ssl->session.namedGroup = ssl->namedGroup = group;
+    #ifdef WOLFSSL_KEY_SHARE_CACHE
+        if (ret == 0)
+            TLSX_KeyShareCache_Set(ssl, group, 0);
+    #endif
     }
     else if (msgType == hello_retry_request) {
         if (length != OPAQUE16_LEN)
@@ -7520,6 +7971,11 @@ static int TLSX_KeyShare_Parse(WOLFSSL* ssl, byte* input, word16 length,
         if (TLSX_KeyShare_Find(ssl, group))
             return BAD_KEY_SHARE_DATA;
 
+    #ifdef WOLFSSL_KEY_SHARE_CACHE
+        /* Send a key share for this group first next time. */
+        TLSX_KeyShareCache_Set(ssl, group, 1);
+    #endif
+
         /* Clear out unusable key shares. */
         ret = TLSX_KeyShare_Empty(ssl);
         if (ret != 0)
@@ -8714,6 +9170,151 @@ static int TLSX_PostHandAuth_Use(WOLFSSL* ssl)
 
 #endif
 
+/******************************************************************************/
+/* Certificate Compression                                                    */
+/******************************************************************************/
+
+#ifdef HAVE_CERT_COMPRESSION
+/* Get the size of the encoded Certificate Compression extension.
+ * Only in ClientHello.
+ *
+ * data     The encoded list of algorithms.
+ * msgType  The type of the message this extension is being written into.
+ * returns the number of bytes of the encoded Certificate Compression
+ * extension.
+ */
+static int TLSX_CertCompress_GetSize(byte* data, byte msgType, word16* pSz)
+{
+    if (msgType == client_hello) {
+        *pSz += OPAQUE8_LEN + data[0];
+        return 0;
+    }
+
+    return SANITY_MSG_E;
+}
+
+/* Writes the Certificate Compression extension into the output buffer.
+ * Assumes that the the output buffer is big enough to hold data.
+ * Only in ClientHello.
+ *
+ * data     The encoded list of algorithms.
+ * output   The buffer to write into.
+ * msgType  The type of the message this extension is being written into.
+ * returns the number of bytes written into the buffer.
+ */
+static int TLSX_CertCompress_Write(byte* data, byte* output, byte msgType,
+                                   word16* pSz)
+{
+    if (msgType == client_hello) {
+        XMEMCPY(output, data, OPAQUE8_LEN + data[0]);
+        *pSz += OPAQUE8_LEN + data[0];
+        return 0;
+    }
+
+    return SANITY_MSG_E;
+}
+
+/* Parse the Certificate Compression extension.
+ * In ClientHello the server picks the first of the client's algorithms that
+ * it can compress with. Client certificates aren't compressed so the
+ * extension in a CertificateRequest is only checked.
+ *
+ * ssl      The SSL/TLS object.
+ * input    The extension data.
+ * length   The length of the extension data.
+ * msgType  The type of the message this extension is being parsed from.
+ * returns 0 on success and other values indicate failure.
+ */
+static int TLSX_CertCompress_Parse(WOLFSSL* ssl, byte* input, word16 length,
+                                   byte msgType)
+{
+    word16 alg;
+    word16 i;
+    int    j;
+
+    if (msgType != client_hello && msgType != certificate_request)
+        return SANITY_MSG_E;
+
+    /* List of algorithms: 1..127 entries. */
+    if (length < OPAQUE8_LEN + OPAQUE16_LEN ||
+            input[0] != length - OPAQUE8_LEN || (input[0] & 1) != 0) {
+        return BUFFER_ERROR;
+    }
+
+    if (msgType == certificate_request)
+        return 0;
+
+    ssl->certCompressAlg = 0;
+    for (i = OPAQUE8_LEN; i < length && ssl->certCompressAlg == 0;
+                                                          i += OPAQUE16_LEN) {
+        ato16(input + i, &alg);
+        for (j = 0; j < ssl->ctx->certCompressCnt; j++) {
+            if (ssl->ctx->certCompress[j].alg == alg &&
+                              ssl->ctx->certCompress[j].compress != NULL) {
+                ssl->certCompressAlg = alg;
+                break;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* Create the Certificate Compression extension listing the algorithms of the
+ * context that can decompress.
+ *
+ * ssl    The SSL/TLS object.
+ * returns 0 on success and other values indicate failure.
+ */
+static int TLSX_CertCompress_Use(WOLFSSL* ssl)
+{
+    int   ret;
+    int   i;
+    byte  len = 0;
+    byte* data;
+
+    if (TLSX_Find(ssl->extensions, TLSX_COMPRESS_CERTIFICATE) != NULL)
+        return 0;
+
+    data = (byte*)XMALLOC(OPAQUE8_LEN + OPAQUE16_LEN * MAX_CERT_COMPRESS_ALGS,
+                          ssl->heap, DYNAMIC_TYPE_TLSX);
+    if (data == NULL)
+        return MEMORY_E;
+
+    for (i = 0; i < ssl->ctx->certCompressCnt; i++) {
+        if (ssl->ctx->certCompress[i].decompress != NULL) {
+            c16toa(ssl->ctx->certCompress[i].alg, data + OPAQUE8_LEN + len);
+            len += OPAQUE16_LEN;
+        }
+    }
+    if (len == 0) {
+        XFREE(data, ssl->heap, DYNAMIC_TYPE_TLSX);
+        return 0;
+    }
+    data[0] = len;
+
+    ret = TLSX_Push(&ssl->extensions, TLSX_COMPRESS_CERTIFICATE, data,
+                                                                    ssl->heap);
+    if (ret != 0)
+        XFREE(data, ssl->heap, DYNAMIC_TYPE_TLSX);
+
+    return ret;
+}
+
+#define CC_FREE_ALL(data, heap) XFREE(data, (heap), DYNAMIC_TYPE_TLSX)
+#define CC_GET_SIZE             TLSX_CertCompress_GetSize
+#define CC_WRITE                TLSX_CertCompress_Write
+#define CC_PARSE                TLSX_CertCompress_Parse
+
+#else
+
+#define CC_FREE_ALL(data, heap)
+#define CC_GET_SIZE(a, b, c)  0
+#define CC_WRITE(a, b, c, d)  0
+#define CC_PARSE(a, b, c, d)  0
+
+#endif /* HAVE_CERT_COMPRESSION */
+
 /******************************************************************************/
 /* Early Data Indication                                                      */
 /******************************************************************************/
@@ -8977,6 +9578,12 @@ void TLSX_FreeAll(TLSX* list, void* heap)
                 break;
     #endif
 
+    #ifdef HAVE_CERT_COMPRESSION
+            case TLSX_COMPRESS_CERTIFICATE:
+                CC_FREE_ALL(extension->data, heap);
+                break;
+    #endif
+
     #if !defined(WOLFSSL_TLS13_DRAFT_18) && !defined(WOLFSSL_TLS13_DRAFT_22)
             case TLSX_SIGNATURE_ALGORITHMS_CERT:
                 break;
@@ -9124,6 +9731,12 @@ static int TLSX_GetSize(TLSX* list, byte* semaphore, byte msgType,
                 break;
     #endif
 
+    #ifdef HAVE_CERT_COMPRESSION
+            case TLSX_COMPRESS_CERTIFICATE:
+                ret = CC_GET_SIZE((byte*)extension->data, msgType, &length);
+                break;
+    #endif
+
     #if !defined(WOLFSSL_TLS13_DRAFT_18) && !defined(WOLFSSL_TLS13_DRAFT_22)
             case TLSX_SIGNATURE_ALGORITHMS_CERT:
                 length += SAC_GET_SIZE(extension->data);
@@ -9302,6 +9915,14 @@ static int TLSX_Write(TLSX* list, byte* output, byte* semaphore,
                 break;
     #endif
 
+    #ifdef HAVE_CERT_COMPRESSION
+            case TLSX_COMPRESS_CERTIFICATE:
+                WOLFSSL_MSG("Certificate Compression extension to write");
+                ret = CC_WRITE((byte*)extension->data, output + offset,
+                                                             msgType, &offset);
+                break;
+    #endif
+
     #if !defined(WOLFSSL_TLS13_DRAFT_18) && !defined(WOLFSSL_TLS13_DRAFT_22)
             case TLSX_SIGNATURE_ALGORITHMS_CERT:
                 WOLFSSL_MSG("Signature Algorithms extension to write");
@@ -9875,6 +10496,12 @@ int TLSX_PopulateExtensions(WOLFSSL* ssl, byte isServer)
                 if (ssl->options.resuming && ssl->session.namedGroup != 0)
                     namedGroup = ssl->session.namedGroup;
                 else
+        #endif
+        #ifdef WOLFSSL_KEY_SHARE_CACHE
+                if (TLSX_KeyShareCache_Lookup(ssl, &namedGroup)) {
+                    WOLFSSL_MSG("Using group server selected previously");
+                }
+                else
         #endif
                 {
         #if defined(HAVE_ECC) && (!defined(NO_ECC256) || \
@@ -10009,6 +10636,13 @@ int TLSX_PopulateExtensions(WOLFSSL* ssl, byte isServer)
                     return ret;
             }
         #endif
+        #if defined(HAVE_CERT_COMPRESSION)
+            if (!isServer && ssl->ctx->certCompressCnt > 0) {
+                ret = TLSX_CertCompress_Use(ssl);
+                if (ret != 0)
+                    return ret;
+            }
+        #endif
         }
 
     #endif
@@ -10057,6 +10691,9 @@ int TLSX_GetRequestSize(WOLFSSL* ssl, byte msgType, word16* pLength)
             TURN_ON(semaphore, TLSX_ToSemaphore(TLSX_COOKIE));
     #ifdef WOLFSSL_POST_HANDSHAKE_AUTH
             TURN_ON(semaphore, TLSX_ToSemaphore(TLSX_POST_HANDSHAKE_AUTH));
+    #endif
+    #ifdef HAVE_CERT_COMPRESSION
+            TURN_ON(semaphore, TLSX_ToSemaphore(TLSX_COMPRESS_CERTIFICATE));
     #endif
         }
 #endif
@@ -10145,6 +10782,9 @@ int TLSX_WriteRequest(WOLFSSL* ssl, byte* output, byte msgType, word16* pOffset)
             TURN_ON(semaphore, TLSX_ToSemaphore(TLSX_COOKIE));
     #ifdef WOLFSSL_POST_HANDSHAKE_AUTH
             TURN_ON(semaphore, TLSX_ToSemaphore(TLSX_POST_HANDSHAKE_AUTH));
+    #endif
+    #ifdef HAVE_CERT_COMPRESSION
+            TURN_ON(semaphore, TLSX_ToSemaphore(TLSX_COMPRESS_CERTIFICATE));
     #endif
         }
     #if defined(HAVE_SESSION_TICKET) || !defined(NO_PSK)
@@ -10474,6 +11114,142 @@ int TLSX_WriteResponse(WOLFSSL *ssl, byte* output, byte msgType, word16* pOffset
 
 #endif /* WOLFSSL_TLS13 || !NO_WOLFSSL_SERVER */
 
+#ifdef WOLFSSL_CH_PREPARSE
+/* Index the fields and extensions of a ClientHello in one pass.
+ * All lengths are checked against the message so that later processing can
+ * go straight to a field or extension.
+ * Extensions with types below CH_EXT_INDEX_SZ, and renegotiation_info, are
+ * found by type in constant time and may only appear once.
+ *
+ * input    The ClientHello message body.
+ * helloSz  The length of the ClientHello message body.
+ * ch       The index of the ClientHello.
+ * returns BUFFER_ERROR when a length is invalid, DUPLICATE_MSG_E when an
+ * extension is repeated, PSK_KEY_ERROR when pre_shared_key is not the last
+ * extension and 0 on success.
+ */
+int TLSX_ClientHello_Index(const byte* input, word32 helloSz,
+                           ClientHelloIndex* ch)
+{
+    word32 i = 0;
+    word32 end;
+    word16 j;
+    int    pskSeen = 0;
+
+    /* Only extensions with a bit set are valid - no need to clear them. */
+    XMEMSET(ch->extSeen, 0, sizeof(ch->extSeen));
+    ch->extsSz = 0;
+    ch->exts = 0;
+    ch->extCnt = 0;
+
+    /* protocol version, random and session id length */
+    if (helloSz < OPAQUE16_LEN + RAN_LEN + OPAQUE8_LEN)
+        return BUFFER_ERROR;
+    ch->pv.major = input[i++];
+    ch->pv.minor = input[i++];
+    i += RAN_LEN;
+
+    /* Session id */
+    ch->sessionIdSz = input[i++];
+    if (ch->sessionIdSz > ID_LEN || i + ch->sessionIdSz > helloSz)
+        return BUFFER_ERROR;
+    ch->sessionId = i;
+    i += ch->sessionIdSz;
+
+    /* Cipher suites */
+    if (i + OPAQUE16_LEN > helloSz)
+        return BUFFER_ERROR;
+    ato16(input + i, &ch->suitesSz);
+    i += OPAQUE16_LEN;
+    if (ch->suitesSz == 0 || (ch->suitesSz & 0x1) ||
+                                   i + ch->suitesSz + OPAQUE8_LEN > helloSz) {
+        return BUFFER_ERROR;
+    }
+    ch->suites = i;
+    i += ch->suitesSz;
+
+    /* Compression */
+    ch->compSz = input[i++];
+    if (ch->compSz == 0 || i + ch->compSz > helloSz)
+        return BUFFER_ERROR;
+    ch->comp = i;
+    i += ch->compSz;
+
+    /* Extensions - optional but must fill the message exactly */
+    if (i == helloSz)
+        return 0;
+    if (i + OPAQUE16_LEN > helloSz)
+        return BUFFER_ERROR;
+    ato16(input + i, &ch->extsSz);
+    i += OPAQUE16_LEN;
+    if (i + ch->extsSz != helloSz)
+        return BUFFER_ERROR;
+    ch->exts = i;
+
+    end = helloSz;
+    while (i < end) {
+        word16 type;
+        word16 size;
+
+        if (pskSeen)
+            return PSK_KEY_ERROR;
+        if (end - i < HELLO_EXT_TYPE_SZ + OPAQUE16_LEN)
+            return BUFFER_ERROR;
+        ato16(input + i, &type);
+        ato16(input + i + HELLO_EXT_TYPE_SZ, &size);
+        if (end - i - HELLO_EXT_TYPE_SZ - OPAQUE16_LEN < size)
+            return BUFFER_ERROR;
+
+        if (type < CH_EXT_INDEX_SZ)
+            j = type;
+        else if (type == TLSX_RENEGOTIATION_INFO)
+            j = CH_EXT_RENEG_IDX;
+        else
+            j = CH_EXT_INDEX_SZ + 1;
+        if (j <= CH_EXT_INDEX_SZ) {
+            if (ch->extSeen[j >> 3] & (1 << (j & 7)))
+                return DUPLICATE_MSG_E;
+            ch->extSeen[j >> 3] |= (byte)(1 << (j & 7));
+            ch->ext[j].offset = i;
+            ch->ext[j].length = size;
+        }
+    #if defined(HAVE_SESSION_TICKET) || !defined(NO_PSK)
+        if (type == TLSX_PRE_SHARED_KEY)
+            pskSeen = 1;
+    #endif
+
+        ch->extCnt++;
+        i += HELLO_EXT_TYPE_SZ + OPAQUE16_LEN + size;
+    }
+
+    return 0;
+}
+
+/* Find an extension in an indexed ClientHello.
+ *
+ * ch    The index of the ClientHello.
+ * type  The extension type.
+ * returns NULL when the extension was not in the ClientHello or is not
+ * indexed, otherwise the location of the extension.
+ */
+const ClientHelloExt* TLSX_ClientHello_FindExt(const ClientHelloIndex* ch,
+                                               word16 type)
+{
+    word16 j;
+
+    if (type < CH_EXT_INDEX_SZ)
+        j = type;
+    else if (type == TLSX_RENEGOTIATION_INFO)
+        j = CH_EXT_RENEG_IDX;
+    else
+        return NULL;
+
+    if ((ch->extSeen[j >> 3] & (1 << (j & 7))) == 0)
+        return NULL;
+    return &ch->ext[j];
+}
+#endif /* WOLFSSL_CH_PREPARSE */
+
 #ifdef WOLFSSL_TLS13
 int TLSX_ParseVersion(WOLFSSL* ssl, byte* input, word16 length, byte msgType,
                       int* found)
@@ -10912,6 +11688,23 @@ int TLSX_Parse(WOLFSSL* ssl, byte* input, word16 length, byte msgType,
                 break;
     #endif
 
+    #ifdef HAVE_CERT_COMPRESSION
+            case TLSX_COMPRESS_CERTIFICATE:
+                WOLFSSL_MSG("Certificate Compression extension received");
+            #ifdef WOLFSSL_DEBUG_TLS
+                WOLFSSL_BUFFER(input + offset, size);
+            #endif
+
+                if (!IsAtLeastTLSv1_3(ssl->version))
+                    break;
+
+                if (msgType != client_hello && msgType != certificate_request)
+                    return EXT_NOT_ALLOWED;
+
+                ret = CC_PARSE(ssl, input + offset, size, msgType);
+                break;
+    #endif
+
     #if !defined(WOLFSSL_TLS13_DRAFT_18) && !defined(WOLFSSL_TLS13_DRAFT_22)
             case TLSX_SIGNATURE_ALGORITHMS_CERT:
                 WOLFSSL_MSG("Signature Algorithms extension received");
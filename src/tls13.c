@@ -44,6 +44,9 @@
  *    Allow 0-RTT Handshake using Early Data extensions and handshake message
  * WOLFSSL_EARLY_DATA_GROUP
  *    Group EarlyData message with ClientHello when sending
+ * WOLFSSL_HALF_RTT_DATA
+ *    Allow server to send application data with its Finished message, before
+ *    the client's Finished message is received (0.5-RTT data).
  * WOLFSSL_NO_SERVER_GROUPS_EXT
  *    Do not send the server's groups in an extension when the server's top
  *    preference is not in client's list.
@@ -202,9 +205,91 @@ static int Tls13_HKDF_Extract(byte* prk, const byte* salt, int saltLen,
     return ret;
 }
 
+#ifdef WOLFSSL_HMAC_MIDSTATE
+/* Free the keyed HMAC states of the key schedule secrets.
+ *
+ * ssl  The SSL/TLS object.
+ */
+void FreeTls13HkdfKeys(WOLFSSL* ssl)
+{
+    int i;
+
+    if (ssl->hkdfKeys == NULL)
+        return;
+
+    for (i = 0; i < TLS13_HKDF_KEYS_SZ; i++)
+        wc_HmacFreeKeyState(&ssl->hkdfKeys->state[i]);
+    ForceZero(ssl->hkdfKeys, sizeof(Tls13HkdfKeys));
+    XFREE(ssl->hkdfKeys, ssl->heap, DYNAMIC_TYPE_TMP_BUFFER);
+    ssl->hkdfKeys = NULL;
+}
+
+/* Set the secret as the HMAC key.
+ * A secret is expanded with a number of labels in the key schedule so the
+ * keyed state is kept and re-used instead of hashing the pads each time.
+ * Secrets are only cached during the handshake - after it, KeyUpdate and
+ * resumption secrets are keyed directly so no old traffic secret is kept.
+ *
+ * ssl      The SSL/TLS object.
+ * hmac     The initialized HMAC object to key.
+ * prk      The secret - pseudo-random key.
+ * prkLen   The length of the secret.
+ * digest   The type of digest to use.
+ * returns 0 on success, otherwise failure.
+ */
+static int Tls13HkdfSetKey(WOLFSSL* ssl, Hmac* hmac, const byte* prk,
+                           word32 prkLen, int digest)
+{
+    int            ret;
+    int            i;
+    Tls13HkdfKeys* keys = ssl->hkdfKeys;
+
+    if (ssl->options.handShakeDone) {
+        FreeTls13HkdfKeys(ssl);
+        return wc_HmacSetKey(hmac, digest, prk, prkLen);
+    }
+
+    if (keys == NULL) {
+        keys = (Tls13HkdfKeys*)XMALLOC(sizeof(Tls13HkdfKeys), ssl->heap,
+                                       DYNAMIC_TYPE_TMP_BUFFER);
+        /* not having the cache isn't fatal */
+        if (keys == NULL)
+            return wc_HmacSetKey(hmac, digest, prk, prkLen);
+        XMEMSET(keys, 0, sizeof(Tls13HkdfKeys));
+        ssl->hkdfKeys = keys;
+    }
+
+    for (i = 0; i < TLS13_HKDF_KEYS_SZ; i++) {
+        if (keys->secretSz[i] == prkLen &&
+                keys->state[i].macType == (byte)digest &&
+                ConstantCompare(keys->secret[i], prk, prkLen) == 0) {
+            return wc_HmacImportKeyState(hmac, &keys->state[i]);
+        }
+    }
+
+    ret = wc_HmacSetKey(hmac, digest, prk, prkLen);
+    if (ret == 0 && prkLen <= WC_MAX_DIGEST_SIZE) {
+        i = keys->next;
+        keys->next = (byte)((i + 1) % TLS13_HKDF_KEYS_SZ);
+
+        /* zero the replaced secret and its keyed state */
+        wc_HmacFreeKeyState(&keys->state[i]);
+        ForceZero(keys->secret[i], sizeof(keys->secret[i]));
+        keys->secretSz[i] = 0;
+        if (wc_HmacExportKeyState(hmac, &keys->state[i]) == 0) {
+            XMEMCPY(keys->secret[i], prk, prkLen);
+            keys->secretSz[i] = prkLen;
+        }
+    }
+
+    return ret;
+}
+#endif /* WOLFSSL_HMAC_MIDSTATE */
+
 /* Expand data using HMAC, salt and label and info.
  * TLS v1.3 defines this function.
  *
+ * ssl          The SSL/TLS object.
  * okm          The generated pseudorandom key - output key material.
  * okmLen       The length of generated pseudorandom key - output key material.
  * prk          The salt - pseudo-random key.
@@ -216,7 +301,7 @@ static int Tls13_HKDF_Extract(byte* prk, const byte* salt, int saltLen,
  * digest       The type of digest to use.
  * returns 0 on success, otherwise failure.
  */
-static int HKDF_Expand_Label(byte* okm, word32 okmLen,
+static int HKDF_Expand_Label(WOLFSSL* ssl, byte* okm, word32 okmLen,
                              const byte* prk, word32 prkLen,
                              const byte* protocol, word32 protocolLen,
                              const byte* label, word32 labelLen,
@@ -226,6 +311,9 @@ static int HKDF_Expand_Label(byte* okm, word32 okmLen,
     int    ret = 0;
     int    idx = 0;
     byte   data[MAX_HKDF_LABEL_SZ];
+#ifdef WOLFSSL_HMAC_MIDSTATE
+    Hmac   hmac;
+#endif
 
     /* Output length. */
     data[idx++] = (byte)(okmLen >> 8);
@@ -251,7 +339,18 @@ static int HKDF_Expand_Label(byte* okm, word32 okmLen,
     WOLFSSL_BUFFER(data, idx);
 #endif
 
+#ifdef WOLFSSL_HMAC_MIDSTATE
+    ret = wc_HmacInit(&hmac, ssl->heap, INVALID_DEVID);
+    if (ret == 0) {
+        ret = Tls13HkdfSetKey(ssl, &hmac, prk, prkLen, digest);
+        if (ret == 0)
+            ret = wc_HKDF_ExpandKeyed(&hmac, data, idx, okm, okmLen);
+        wc_HmacFree(&hmac);
+    }
+#else
+    (void)ssl;
     ret = wc_HKDF_Expand(digest, prk, prkLen, data, idx, okm, okmLen);
+#endif
 
 #ifdef WOLFSSL_DEBUG_TLS
     WOLFSSL_MSG("  OKM");
@@ -365,7 +464,7 @@ static int DeriveKeyMsg(WOLFSSL* ssl, byte* output, int outputLen,
     if (outputLen == -1)
         outputLen = hashSz;
 
-    return HKDF_Expand_Label(output, outputLen, secret, hashSz,
+    return HKDF_Expand_Label(ssl, output, outputLen, secret, hashSz,
                              protocol, protocolLen, label, labelLen,
                              hash, hashSz, digestAlg);
 }
@@ -400,8 +499,6 @@ static int DeriveKey(WOLFSSL* ssl, byte* output, int outputLen,
             case sha256_mac:
                 hashSz    = WC_SHA256_DIGEST_SIZE;
                 digestAlg = WC_SHA256;
-                if (includeMsgs)
-                    ret = wc_Sha256GetHash(&ssl->hsHashes->hashSha256, hash);
             break;
         #endif
 
@@ -409,8 +506,6 @@ static int DeriveKey(WOLFSSL* ssl, byte* output, int outputLen,
             case sha384_mac:
                 hashSz    = WC_SHA384_DIGEST_SIZE;
                 digestAlg = WC_SHA384;
-                if (includeMsgs)
-                    ret = wc_Sha384GetHash(&ssl->hsHashes->hashSha384, hash);
             break;
         #endif
 
@@ -418,13 +513,14 @@ static int DeriveKey(WOLFSSL* ssl, byte* output, int outputLen,
             case sha512_mac:
                 hashSz    = WC_SHA512_DIGEST_SIZE;
                 digestAlg = WC_SHA512;
-                if (includeMsgs)
-                    ret = wc_Sha512GetHash(&ssl->hsHashes->hashSha512, hash);
             break;
         #endif
     }
-    if (ret != 0)
-        return ret;
+    if (includeMsgs && hashSz > 0) {
+        ret = GetHandshakeHash(ssl, hashAlgo, hash);
+        if (ret < 0)
+            return ret;
+    }
 
     /* Only one protocol version defined at this time. */
     protocol = tls13ProtocolLabel;
@@ -435,7 +531,7 @@ static int DeriveKey(WOLFSSL* ssl, byte* output, int outputLen,
     if (includeMsgs)
         hashOutSz = hashSz;
 
-    return HKDF_Expand_Label(output, outputLen, secret, hashSz,
+    return HKDF_Expand_Label(ssl, output, outputLen, secret, hashSz,
                              protocol, protocolLen, label, labelLen,
                              hash, hashOutSz, digestAlg);
 }
@@ -899,7 +995,7 @@ static int DeriveResumptionPSK(WOLFSSL* ssl, byte* nonce, byte nonceLen,
             return BAD_FUNC_ARG;
     }
 
-    return HKDF_Expand_Label(secret, ssl->specs.hash_size,
+    return HKDF_Expand_Label(ssl, secret, ssl->specs.hash_size,
                              ssl->session.masterSecret, ssl->specs.hash_size,
                              protocol, protocolLen, resumptionLabel,
                              RESUMPTION_LABEL_SZ, nonce, nonceLen, digestAlg);
@@ -929,25 +1025,25 @@ static int BuildTls13HandshakeHmac(WOLFSSL* ssl, byte* key, byte* hash,
         case sha256_mac:
             hashType = WC_SHA256;
             hashSz = WC_SHA256_DIGEST_SIZE;
-            ret = wc_Sha256GetHash(&ssl->hsHashes->hashSha256, hash);
+            ret = GetHandshakeHash(ssl, sha256_mac, hash);
             break;
     #endif /* !NO_SHA256 */
     #ifdef WOLFSSL_SHA384
         case sha384_mac:
             hashType = WC_SHA384;
             hashSz = WC_SHA384_DIGEST_SIZE;
-            ret = wc_Sha384GetHash(&ssl->hsHashes->hashSha384, hash);
+            ret = GetHandshakeHash(ssl, sha384_mac, hash);
             break;
     #endif /* WOLFSSL_SHA384 */
     #ifdef WOLFSSL_TLS13_SHA512
         case sha512_mac:
             hashType = WC_SHA512;
             hashSz = WC_SHA512_DIGEST_SIZE;
-            ret = wc_Sha512GetHash(&ssl->hsHashes->hashSha512, hash);
+            ret = GetHandshakeHash(ssl, sha512_mac, hash);
             break;
     #endif /* WOLFSSL_TLS13_SHA512 */
     }
-    if (ret != 0)
+    if (ret < 0)
         return ret;
 
     /* Calculate the verify data. */
@@ -1361,6 +1457,10 @@ end:
  */
 static int HashInputRaw(WOLFSSL* ssl, const byte* input, int sz)
 {
+#ifdef WOLFSSL_LAZY_HS_HASH
+    /* buffered until the suite hash is known */
+    return HashRaw(ssl, input, sz);
+#else
     int ret = BAD_FUNC_ARG;
 
 #ifndef NO_SHA256
@@ -1380,6 +1480,7 @@ static int HashInputRaw(WOLFSSL* ssl, const byte* input, int sz)
 #endif
 
     return ret;
+#endif
 }
 #endif
 
@@ -2382,36 +2483,19 @@ static int CreateCookie(WOLFSSL* ssl, byte* hash, byte hashSz)
 static int RestartHandshakeHash(WOLFSSL* ssl)
 {
     int    ret;
-    Hashes hashes;
     byte   header[HANDSHAKE_HEADER_SZ] = {0};
-    byte*  hash = NULL;
+    byte   hash[WC_MAX_DIGEST_SIZE];
     byte   hashSz = 0;
 
-    ret = BuildCertHashes(ssl, &hashes);
-    if (ret != 0)
-        return ret;
-    switch (ssl->specs.mac_algorithm) {
-    #ifndef NO_SHA256
-        case sha256_mac:
-            hash = hashes.sha256;
-            break;
-    #endif
-    #ifdef WOLFSSL_SHA384
-        case sha384_mac:
-            hash = hashes.sha384;
-            break;
-    #endif
-    #ifdef WOLFSSL_TLS13_SHA512
-        case sha512_mac:
-            hash = hashes.sha512;
-            break;
-    #endif
-    }
     hashSz = ssl->specs.hash_size;
-
-    /* check hash */
-    if (hash == NULL && hashSz > 0)
-        return BAD_FUNC_ARG;
+    if (hashSz > 0) {
+        ret = GetHandshakeHash(ssl, ssl->specs.mac_algorithm, hash);
+        if (ret < 0)
+            return ret;
+        /* check hash */
+        if (ret != hashSz)
+            return BAD_FUNC_ARG;
+    }
 
     AddTls13HandShakeHeader(header, hashSz, 0, 0, message_hash, ssl);
 
@@ -2426,8 +2510,7 @@ static int RestartHandshakeHash(WOLFSSL* ssl)
 
         /* Cookie Data = Hash Len | Hash | CS | KeyShare Group */
         cookie[idx++] = hashSz;
-        if (hash)
-            XMEMCPY(cookie + idx, hash, hashSz);
+        XMEMCPY(cookie + idx, hash, hashSz);
         idx += hashSz;
         cookie[idx++] = ssl->options.cipherSuite0;
         cookie[idx++] = ssl->options.cipherSuite;
@@ -3459,6 +3542,176 @@ static void RefineSuites(WOLFSSL* ssl, Suites* peerSuites)
     XMEMCPY(ssl->suites->suites, &suites, sizeof(suites));
 }
 
+#ifdef WOLFSSL_EARLY_DATA_ANTI_REPLAY
+/* Empty a window of the anti-replay cache.
+ *
+ * cache  The anti-replay cache.
+ * gen    The window to empty.
+ * start  Time the window starts in milliseconds.
+ */
+static void AntiReplayGenReset(AntiReplayCache* cache, AntiReplayGen* gen,
+                               word32 start)
+{
+    if (gen->count > 0)
+        XMEMSET(gen->data, 0, cache->dataSz);
+    gen->count = 0;
+    gen->start = start;
+}
+
+/* Look for a ClientHello's binder fingerprint in a window.
+ * Exact windows are open addressed tables of fingerprints. Bloom windows set
+ * ANTI_REPLAY_BLOOM_K bits chosen by the fingerprint.
+ *
+ * cache  The anti-replay cache.
+ * gen    The window to search.
+ * fp     Fingerprint of the binder. Never all zeros.
+ * add    Record the fingerprint when not found.
+ * returns 1 when found and 0 otherwise.
+ */
+static int AntiReplayGenFind(AntiReplayCache* cache, AntiReplayGen* gen,
+                             const byte* fp, int add)
+{
+    word32 idx;
+    word32 cnt;
+    int    i;
+
+    if (cache->bloom) {
+        word32 bits = cache->dataSz * WOLFSSL_BIT_SIZE;
+        word32 pos[ANTI_REPLAY_BLOOM_K];
+        int    found = 1;
+
+        for (i = 0; i < ANTI_REPLAY_BLOOM_K; i++) {
+            ato32(fp + i * OPAQUE32_LEN, &pos[i]);
+            pos[i] %= bits;
+            if ((gen->data[pos[i] / WOLFSSL_BIT_SIZE] &
+                                 (1 << (pos[i] % WOLFSSL_BIT_SIZE))) == 0) {
+                found = 0;
+            }
+        }
+        if (!found && add) {
+            for (i = 0; i < ANTI_REPLAY_BLOOM_K; i++) {
+                gen->data[pos[i] / WOLFSSL_BIT_SIZE] |=
+                                        (byte)(1 << (pos[i] % WOLFSSL_BIT_SIZE));
+            }
+        }
+        return found;
+    }
+
+    cnt = cache->dataSz / ANTI_REPLAY_FP_SZ;
+    ato32(fp, &idx);
+    for (idx %= cnt; ; idx = (idx + 1) % cnt) {
+        byte* slot = gen->data + idx * ANTI_REPLAY_FP_SZ;
+
+        if (XMEMCMP(slot, fp, ANTI_REPLAY_FP_SZ) == 0)
+            return 1;
+        /* Empty slot ends the probe - tables are never more than half full. */
+        if (slot[ANTI_REPLAY_FP_SZ - 1] == 0) {
+            if (add)
+                XMEMCPY(slot, fp, ANTI_REPLAY_FP_SZ);
+            return 0;
+        }
+    }
+}
+
+/* Check whether early data of a ClientHello can be accepted and record it.
+ * The binder is unique to the ClientHello and is remembered for two windows.
+ * The ticket age must be within a window of the server's view so that a
+ * replay arriving after the binder is forgotten is not fresh.
+ * A shard is locked only while checking one of its binders.
+ *
+ * cache      The anti-replay cache.
+ * binder     Binder of the first PSK in the ClientHello.
+ * binderLen  Length of the binder.
+ * ageDiff    Difference of ticket age from expected in milliseconds.
+ *            NULL when the PSK doesn't have an age.
+ * returns 0 when early data can be accepted and 1 otherwise.
+ */
+static int AntiReplayCheck(AntiReplayCache* cache, const byte* binder,
+                           word32 binderLen, const int* ageDiff)
+{
+    AntiReplayShard* shard;
+    AntiReplayGen*   cur;
+    AntiReplayGen*   prev;
+    byte             fp[ANTI_REPLAY_FP_SZ];
+    word32           now;
+    word32           span = 2 * cache->windowMs;
+    word32           elapsed;
+    int              ret = 0;
+
+    if (binderLen <= ANTI_REPLAY_FP_SZ)
+        return 1;
+    XMEMCPY(fp, binder, ANTI_REPLAY_FP_SZ);
+    fp[ANTI_REPLAY_FP_SZ - 1] |= 1;
+    shard = &cache->shards[binder[ANTI_REPLAY_FP_SZ] % ANTI_REPLAY_SHARDS];
+
+    now = TimeNowInMilliseconds();
+    if (now == (word32)GETTIME_ERROR)
+        return 1;
+
+    if (wc_LockMutex(&shard->lock) != 0)
+        return 1;
+    shard->checks++;
+
+    /* Start a new window when the current one has ended. */
+    cur = &shard->gen[shard->cur];
+    elapsed = now - cur->start;
+    if (elapsed >= span) {
+        prev = cur;
+        shard->cur ^= 1;
+        cur = &shard->gen[shard->cur];
+        AntiReplayGenReset(cache, cur, now);
+        if (elapsed >= 2 * span)
+            AntiReplayGenReset(cache, prev, now);
+    }
+    prev = &shard->gen[shard->cur ^ 1];
+
+    if (ageDiff == NULL || *ageDiff < -(int)cache->windowMs ||
+                                             *ageDiff > (int)cache->windowMs) {
+        WOLFSSL_MSG("Early data ClientHello not fresh");
+        shard->rejects++;
+        ret = 1;
+    }
+    else if (AntiReplayGenFind(cache, prev, fp, 0) ||
+             AntiReplayGenFind(cache, cur, fp, 0)) {
+        WOLFSSL_MSG("Early data ClientHello replayed");
+        shard->replays++;
+        ret = 1;
+    }
+    else if (cur->count >= cache->perShard) {
+        WOLFSSL_MSG("Anti-replay window full");
+        shard->rejects++;
+        ret = 1;
+    }
+    else {
+        AntiReplayGenFind(cache, cur, fp, 1);
+        cur->count++;
+    }
+
+    wc_UnLockMutex(&shard->lock);
+
+    return ret;
+}
+
+/* Free the anti-replay cache.
+ *
+ * cache  The anti-replay cache.
+ * heap   Heap hint used to allocate the cache.
+ */
+void FreeAntiReplayCache(AntiReplayCache* cache, void* heap)
+{
+    int i;
+
+    for (i = 0; i < ANTI_REPLAY_SHARDS; i++) {
+        wc_FreeMutex(&cache->shards[i].lock);
+        XFREE(cache->shards[i].gen[0].data, heap, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(cache->shards[i].gen[1].data, heap, DYNAMIC_TYPE_TMP_BUFFER);
+    }
+    XFREE(cache, heap, DYNAMIC_TYPE_TMP_BUFFER);
+
+    (void)heap;
+}
+#endif /* WOLFSSL_EARLY_DATA_ANTI_REPLAY */
+
 /* Handle any Pre-Shared Key (PSK) extension.
  * Must do this in ClientHello as it requires a hash of the truncated message.
  * Don't know size of binders until Pre-Shared Key extension has been parsed.
@@ -3485,6 +3738,10 @@ static int DoPreSharedKeys(WOLFSSL* ssl, const byte* input, word32 helloSz,
     int           pskCnt = 0;
     TLSX*         extEarlyData;
 #endif
+#ifdef WOLFSSL_EARLY_DATA_ANTI_REPLAY
+    int           ageDiff = 0;
+    int           ageKnown = 0;
+#endif
 #ifndef NO_PSK
     const char*   cipherName = NULL;
     byte          cipherSuite0 = TLS13_BYTE;
@@ -3526,6 +3783,9 @@ static int DoPreSharedKeys(WOLFSSL* ssl, const byte* input, word32 helloSz,
     #ifdef WOLFSSL_EARLY_DATA
         pskCnt++;
     #endif
+    #ifdef WOLFSSL_EARLY_DATA_ANTI_REPLAY
+        ageKnown = 0;
+    #endif
 
     #ifndef NO_PSK
         if (current->identityLen > MAX_PSK_ID_LEN) {
@@ -3557,6 +3817,10 @@ static int DoPreSharedKeys(WOLFSSL* ssl, const byte* input, word32 helloSz,
                 ssl->options.resuming = 0;
                 break;
             }
+        #ifdef WOLFSSL_EARLY_DATA_ANTI_REPLAY
+            ageDiff = diff;
+            ageKnown = 1;
+        #endif
 
             /* Check whether resumption is possible based on suites in SSL and
              * ciphersuite in ticket.
@@ -3697,7 +3961,13 @@ static int DoPreSharedKeys(WOLFSSL* ssl, const byte* input, word32 helloSz,
 #ifdef WOLFSSL_EARLY_DATA
     extEarlyData = TLSX_Find(ssl->extensions, TLSX_EARLY_DATA);
     if (extEarlyData != NULL) {
-        if (ssl->earlyData != no_early_data && current == ext->data) {
+        if (ssl->earlyData != no_early_data && current == ext->data
+        #ifdef WOLFSSL_EARLY_DATA_ANTI_REPLAY
+                && (ssl->ctx->antiReplay == NULL ||
+                    AntiReplayCheck(ssl->ctx->antiReplay, current->binder,
+                         current->binderLen, ageKnown ? &ageDiff : NULL) == 0)
+        #endif
+                ) {
             extEarlyData->resp = 1;
 
             /* Derive early data decryption key. */
@@ -3964,6 +4234,7 @@ static int RestartHandshakeHashWithCookie(WOLFSSL* ssl, Cookie* cookie)
 }
 #endif
 
+#ifndef WOLFSSL_CH_PREPARSE
 /* Do SupportedVersion extension for TLS v1.3+ otherwise it is not.
  *
  * ssl       The SSL/TLS object.
@@ -4022,6 +4293,70 @@ static int DoTls13SupportedVersions(WOLFSSL* ssl, const byte* input, word32 i,
 
     return 0;
 }
+#endif /* !WOLFSSL_CH_PREPARSE */
+
+#ifdef WOLFSSL_CH_PREPARSE
+/* Index the ClientHello and do the SupportedVersions extension.
+ * Checks all lengths in the message, and that there is a cipher suite in
+ * common, before extensions are parsed and objects allocated for them.
+ *
+ * ssl            The SSL/TLS object.
+ * input          The ClientHello message.
+ * helloSz        The length of the ClientHello message.
+ * wantDowngrade  Set to whether the version is less than TLS v1.3.
+ * returns 0 on success and otherwise failure.
+ */
+static int DoTls13ClientHelloIndex(WOLFSSL* ssl, const byte* input,
+                                   word32 helloSz, int* wantDowngrade)
+{
+    int                   ret;
+    int                   foundVersion = 0;
+    const ClientHelloExt* ext;
+    byte                  map[SUITE_MAP_SZ];
+#ifdef WOLFSSL_SMALL_STACK
+    ClientHelloIndex*     ch;
+#else
+    ClientHelloIndex      ch[1];
+#endif
+
+#ifdef WOLFSSL_SMALL_STACK
+    ch = (ClientHelloIndex*)XMALLOC(sizeof(ClientHelloIndex), ssl->heap,
+                                    DYNAMIC_TYPE_TMP_BUFFER);
+    if (ch == NULL)
+        return MEMORY_E;
+#endif
+
+    ret = TLSX_ClientHello_Index(input, helloSz, ch);
+    if (ret == 0) {
+        /* Need to negotiate version first. */
+        ext = TLSX_ClientHello_FindExt(ch, TLSX_SUPPORTED_VERSIONS);
+        if (ext != NULL) {
+            ret = TLSX_ParseVersion(ssl, (byte*)input + ext->offset,
+                           HELLO_EXT_TYPE_SZ + OPAQUE16_LEN + ext->length,
+                           client_hello, &foundVersion);
+        }
+    }
+    if (ret == 0) {
+        *wantDowngrade = !foundVersion || !IsAtLeastTLSv1_3(ssl->version);
+
+        if (!*wantDowngrade && ssl->suites != NULL) {
+            BuildSuiteMap(map, input + ch->suites, ch->suitesSz);
+            if (!HaveCommonSuite(ssl->suites, input + ch->suites, ch->suitesSz,
+                                 map)) {
+                WOLFSSL_MSG("No cipher suite in common, ClientHello");
+                SendAlert(ssl, alert_fatal, handshake_failure);
+                ret = MATCH_SUITE_ERROR;
+            }
+        }
+    }
+
+#ifdef WOLFSSL_SMALL_STACK
+    XFREE(ch, ssl->heap, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    return ret;
+}
+#endif /* WOLFSSL_CH_PREPARSE */
 
 /* Handle a ClientHello handshake message.
  * If the protocol version in the message is not TLS v1.3 or higher, use
@@ -4092,8 +4427,13 @@ int DoTls13ClientHello(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
         ssl->version.minor = pv.minor;
     }
     else {
+#ifdef WOLFSSL_CH_PREPARSE
+        ret = DoTls13ClientHelloIndex(ssl, input + begin, helloSz,
+                                                                &wantDowngrade);
+#else
         ret = DoTls13SupportedVersions(ssl, input + begin, i - begin, helloSz,
                                                                 &wantDowngrade);
+#endif
         if (ret < 0)
             return ret;
     }
@@ -4426,7 +4766,13 @@ int SendTls13ServerHello(WOLFSSL* ssl, byte extMsgType)
         if ((ret = RestartHandshakeHash(ssl)) < 0)
             return ret;
     }
+    else
 #endif
+    {
+        /* cipher suite is picked, only hash with what it needs from here */
+        if ((ret = SelectHandshakeHashes(ssl)) != 0)
+            return ret;
+    }
 
 #ifdef WOLFSSL_TLS13_DRAFT_18
     /* Protocol version, server random, cipher suite and extensions. */
@@ -4871,23 +5217,17 @@ static WC_INLINE int GetMsgHash(WOLFSSL* ssl, byte* hash)
     switch (ssl->specs.mac_algorithm) {
     #ifndef NO_SHA256
         case sha256_mac:
-            ret = wc_Sha256GetHash(&ssl->hsHashes->hashSha256, hash);
-            if (ret == 0)
-                ret = WC_SHA256_DIGEST_SIZE;
+            ret = GetHandshakeHash(ssl, sha256_mac, hash);
             break;
     #endif /* !NO_SHA256 */
     #ifdef WOLFSSL_SHA384
         case sha384_mac:
-            ret = wc_Sha384GetHash(&ssl->hsHashes->hashSha384, hash);
-            if (ret == 0)
-                ret = WC_SHA384_DIGEST_SIZE;
+            ret = GetHandshakeHash(ssl, sha384_mac, hash);
             break;
     #endif /* WOLFSSL_SHA384 */
     #ifdef WOLFSSL_TLS13_SHA512
         case sha512_mac:
-            ret = wc_Sha512GetHash(&ssl->hsHashes->hashSha512, hash);
-            if (ret == 0)
-                ret = WC_SHA512_DIGEST_SIZE;
+            ret = GetHandshakeHash(ssl, sha512_mac, hash);
             break;
     #endif /* WOLFSSL_TLS13_SHA512 */
     }
@@ -5198,6 +5538,79 @@ static word32 AddCertExt(WOLFSSL* ssl, byte* cert, word32 len, word16 extSz,
     return i;
 }
 
+#ifdef WOLFSSL_CERT_MSG_CACHE
+/* Send the Certificate message using the encoded body from the context.
+ * ssl->fragOffset is the count of body bytes already sent.
+ * This message is always encrypted in TLS v1.3.
+ *
+ * ssl          The SSL/TLS object.
+ * msg          Encoded Certificate or CompressedCertificate message body.
+ * type         Handshake message type: certificate or compressed_certificate.
+ * maxFragment  Maximum size of a record's data.
+ * returns 0 on success, otherwise failure.
+ */
+static int SendTls13CertificateCached(WOLFSSL* ssl, DerBuffer* msg, byte type,
+                                      word32 maxFragment)
+{
+    int ret = 0;
+
+    while (ssl->fragOffset < msg->length && ret == 0) {
+        byte*  output = NULL;
+        word32 fragSz;
+        word32 i = RECORD_HEADER_SZ;
+        int    sendSz;
+
+        if (ssl->fragOffset == 0) {
+            fragSz = min(msg->length, maxFragment - HANDSHAKE_HEADER_SZ);
+            i += HANDSHAKE_HEADER_SZ;
+        }
+        else
+            fragSz = min(msg->length - ssl->fragOffset, maxFragment);
+
+        sendSz = i + fragSz + MAX_MSG_EXTRA;
+
+        /* Check buffers are big enough and grow if needed. */
+        if ((ret = CheckAvailableSize(ssl, sendSz)) != 0)
+            return ret;
+
+        /* Get position in output buffer to write new message to. */
+        output = ssl->buffers.outputBuffer.buffer +
+                 ssl->buffers.outputBuffer.length;
+
+        if (ssl->fragOffset == 0)
+            AddTls13FragHeaders(output, fragSz, 0, msg->length, type, ssl);
+        else
+            AddTls13RecordHeader(output, fragSz, handshake, ssl);
+
+        XMEMCPY(output + i, msg->buffer + ssl->fragOffset, fragSz);
+        i += fragSz;
+        ssl->fragOffset += fragSz;
+
+        /* This message is always encrypted. */
+        sendSz = BuildTls13Message(ssl, output, sendSz,
+                                   output + RECORD_HEADER_SZ,
+                                   i - RECORD_HEADER_SZ, handshake, 1, 0, 0);
+        if (sendSz < 0)
+            return sendSz;
+
+        #ifdef WOLFSSL_CALLBACKS
+            if (ssl->hsInfoOn)
+                AddPacketName(ssl, "Certificate");
+            if (ssl->toInfoOn) {
+                AddPacketInfo(ssl, "Certificate", handshake, output,
+                        sendSz, WRITE_PROTO, ssl->heap);
+            }
+        #endif
+
+        ssl->buffers.outputBuffer.length += sendSz;
+        if (!ssl->options.groupMessages)
+            ret = SendBuffered(ssl);
+    }
+
+    return ret;
+}
+#endif /* WOLFSSL_CERT_MSG_CACHE */
+
 /* handle generation TLS v1.3 certificate (11) */
 /* Send the certificate for this end and any CAs that help with validation.
  * This message is always encrypted in TLS v1.3.
@@ -5288,6 +5701,39 @@ static int SendTls13Certificate(WOLFSSL* ssl)
 
     maxFragment = wolfSSL_GetMaxRecordSize(ssl, MAX_RECORD_SIZE);
 
+#ifdef WOLFSSL_CERT_MSG_CACHE
+    /* Encoding only holds empty request context and extensions. */
+    if (ssl->options.sendVerify != SEND_BLANK_CERT && certReqCtxLen == 0 &&
+                                                      extSz == OPAQUE16_LEN) {
+        DerBuffer* msg = GetCertMsgCache(ssl);
+        byte       type = certificate;
+
+    #ifdef HAVE_CERT_COMPRESSION
+        /* Send the compressed chain when the client offered an algorithm. */
+        if (msg != NULL && ssl->certCompressAlg != 0) {
+            int i;
+
+            for (i = 0; i < ssl->ctx->certCompressCnt; i++) {
+                if (ssl->ctx->certCompress[i].alg == ssl->certCompressAlg &&
+                                     ssl->ctx->certCompress[i].msg != NULL) {
+                    msg = ssl->ctx->certCompress[i].msg;
+                    type = compressed_certificate;
+                    break;
+                }
+            }
+        }
+    #endif
+
+        if (msg != NULL) {
+            ret = SendTls13CertificateCached(ssl, msg, type, maxFragment);
+            if (ret != 0 && ret != WANT_WRITE)
+                return ret;
+            /* Message sent from encoding - nothing left to build. */
+            length = 0;
+        }
+    }
+#endif
+
     while (length > 0 && ret == 0) {
         byte*  output = NULL;
         word32 fragSz = 0;
@@ -5826,6 +6272,115 @@ static int DoTls13Certificate(WOLFSSL* ssl, byte* input, word32* inOutIdx,
     return ret;
 }
 
+#ifdef HAVE_CERT_COMPRESSION
+/* handle processing TLS v1.3 compressed_certificate (25) */
+/* Parse and handle a TLS v1.3 CompressedCertificate message.
+ * The decompressed Certificate message is kept until processed so that the
+ * message can be handled again when certificate processing is re-entered.
+ *
+ * ssl       The SSL/TLS object.
+ * input     The message buffer.
+ * inOutIdx  On entry, the index into the message buffer of
+ *           CompressedCertificate.
+ *           On exit, the index of byte after the CompressedCertificate
+ *           message.
+ * totalSz   The length of the current handshake message.
+ * returns 0 on success and otherwise failure.
+ */
+static int DoTls13CompressedCertificate(WOLFSSL* ssl, byte* input,
+                                        word32* inOutIdx, word32 totalSz)
+{
+    int                   ret = 0;
+    word32                begin = *inOutIdx;
+    word32                idx = 0;
+    word32                len;
+    word32                compLen;
+    word16                alg;
+    int                   i;
+    CallbackCertDecompress decompress = NULL;
+
+    WOLFSSL_ENTER("DoTls13CompressedCertificate");
+
+    /* Only acceptable when the algorithms were offered. */
+    if (TLSX_Find(ssl->extensions, TLSX_COMPRESS_CERTIFICATE) == NULL) {
+        WOLFSSL_MSG("CompressedCertificate without extension");
+        SendAlert(ssl, alert_fatal, unexpected_message);
+        return OUT_OF_ORDER_E;
+    }
+
+    if (totalSz < OPAQUE16_LEN + 2 * OPAQUE24_LEN)
+        return BUFFER_ERROR;
+    ato16(input + begin, &alg);
+    c24to32(input + begin + OPAQUE16_LEN, &len);
+    c24to32(input + begin + OPAQUE16_LEN + OPAQUE24_LEN, &compLen);
+    if (compLen != totalSz - OPAQUE16_LEN - 2 * OPAQUE24_LEN)
+        return BUFFER_ERROR;
+
+    for (i = 0; i < ssl->ctx->certCompressCnt; i++) {
+        if (ssl->ctx->certCompress[i].alg == alg) {
+            decompress = ssl->ctx->certCompress[i].decompress;
+            break;
+        }
+    }
+    if (decompress == NULL) {
+        WOLFSSL_MSG("CompressedCertificate algorithm not offered");
+        SendAlert(ssl, alert_fatal, illegal_parameter);
+        return INVALID_PARAMETER;
+    }
+    if (len == 0 || len > MAX_CERTIFICATE_SZ) {
+        SendAlert(ssl, alert_fatal, bad_certificate);
+        return CERT_DECOMPRESS_E;
+    }
+
+    if (ssl->certDecomp.buffer == NULL) {
+        ssl->certDecomp.buffer = (byte*)XMALLOC(len, ssl->heap,
+                                                DYNAMIC_TYPE_CERT);
+        if (ssl->certDecomp.buffer == NULL)
+            return MEMORY_E;
+        ssl->certDecomp.length = len;
+
+        if (decompress(input + begin + OPAQUE16_LEN + 2 * OPAQUE24_LEN,
+                       compLen, ssl->certDecomp.buffer, len) != 0) {
+            ret = CERT_DECOMPRESS_E;
+        }
+    }
+    else if (ssl->certDecomp.length != len)
+        ret = CERT_DECOMPRESS_E;
+
+    if (ret == 0)
+        ret = DoTls13Certificate(ssl, ssl->certDecomp.buffer, &idx, len);
+
+#ifdef WOLFSSL_ASYNC_CRYPT
+    if (ret == WC_PENDING_E)
+        return ret;
+#endif
+#ifdef WOLFSSL_NONBLOCK_OCSP
+    if (ret == OCSP_WANT_READ)
+        return ret;
+#endif
+
+    XFREE(ssl->certDecomp.buffer, ssl->heap, DYNAMIC_TYPE_CERT);
+    ssl->certDecomp.buffer = NULL;
+    ssl->certDecomp.length = 0;
+
+    if (ret == CERT_DECOMPRESS_E) {
+        WOLFSSL_MSG("CompressedCertificate decompression failed");
+        SendAlert(ssl, alert_fatal, bad_certificate);
+    }
+    else if (ret == 0) {
+        /* Processing the certificates also skips the record padding. */
+        if (idx < len)
+            ret = BUFFER_ERROR;
+        else
+            *inOutIdx = begin + totalSz + (idx - len);
+    }
+
+    WOLFSSL_LEAVE("DoTls13CompressedCertificate", ret);
+
+    return ret;
+}
+#endif /* HAVE_CERT_COMPRESSION */
+
 #if !defined(NO_RSA) || defined(HAVE_ECC) || defined(HAVE_ED25519)
 
 typedef struct Dcv13Args {
@@ -6407,6 +6962,10 @@ static int SendTls13Finished(WOLFSSL* ssl)
     }
 #endif
 
+#ifdef WOLFSSL_HALF_RTT_DATA
+    /* Server's flight is sent with the 0.5-RTT data. */
+    if (!ssl->options.halfRttData)
+#endif
     if ((ret = SendBuffered(ssl)) != 0)
         return ret;
 
@@ -6798,6 +7357,9 @@ static int ExpectedResumptionSecret(WOLFSSL* ssl)
     Digest      digest;
     static byte header[] = { 0x14, 0x00, 0x00, 0x00 };
 
+    if ((ret = FlushHandshakeHashes(ssl)) != 0)
+        return ret;
+
     /* Copy the running hash so we can restore it after. */
     switch (ssl->specs.mac_algorithm) {
     #ifndef NO_SHA256
@@ -7147,6 +7709,9 @@ static int SanityCheckTls13MsgReceived(WOLFSSL* ssl, byte type)
             break;
 #endif
 
+    #ifdef HAVE_CERT_COMPRESSION
+        case compressed_certificate:
+    #endif
         case certificate:
     #ifndef NO_WOLFSSL_CLIENT
             if (ssl->options.side == WOLFSSL_CLIENT_END &&
@@ -7396,6 +7961,8 @@ int DoTls13HandShakeMsgType(WOLFSSL* ssl, byte* input, word32* inOutIdx,
     case server_hello:
         WOLFSSL_MSG("processing server hello");
         ret = DoTls13ServerHello(ssl, input, inOutIdx, size, &type);
+        if (ret == 0 && type == server_hello)
+            ret = SelectHandshakeHashes(ssl);
     #if !defined(WOLFSSL_NO_CLIENT_AUTH) && defined(HAVE_ED25519) && \
                                                 !defined(NO_ED25519_CLIENT_AUTH)
         if (ssl->options.resuming || !IsAtLeastTLSv1_2(ssl) ||
@@ -7448,6 +8015,13 @@ int DoTls13HandShakeMsgType(WOLFSSL* ssl, byte* input, word32* inOutIdx,
         WOLFSSL_MSG("processing certificate");
         ret = DoTls13Certificate(ssl, input, inOutIdx, size);
         break;
+
+    #ifdef HAVE_CERT_COMPRESSION
+    case compressed_certificate:
+        WOLFSSL_MSG("processing compressed certificate");
+        ret = DoTls13CompressedCertificate(ssl, input, inOutIdx, size);
+        break;
+    #endif
 #endif
 
 #if !defined(NO_RSA) || defined(HAVE_ECC) || defined(HAVE_ED25519)
@@ -7759,6 +8333,15 @@ int wolfSSL_connect_TLSv13(WOLFSSL* ssl)
                                           SERVER_HELLO_RETRY_REQUEST_COMPLETE) {
                 if ((ssl->error = ProcessReply(ssl)) < 0) {
                     WOLFSSL_ERROR(ssl->error);
+            #ifdef WOLFSSL_KEY_SHARE_CACHE
+                    if (ssl->error != WANT_READ && ssl->error != WANT_WRITE
+                #ifdef WOLFSSL_ASYNC_CRYPT
+                            && ssl->error != WC_PENDING_E
+                #endif
+                       ) {
+                        TLSX_KeyShareCache_Remove(ssl);
+                    }
+            #endif
                     return WOLFSSL_FATAL_ERROR;
                 }
             }
@@ -8292,6 +8875,212 @@ int wolfSSL_set_groups(WOLFSSL* ssl, int* groups, int count)
     return WOLFSSL_SUCCESS;
 }
 
+#ifdef WOLFSSL_KEY_SHARE_CACHE
+/* Enable the cache of groups selected by servers.
+ * When no key shares have been set, the client sends a key share for the
+ * group the server, identified by SNI host name, selected on a previous
+ * connection. This avoids a HelloRetryRequest when the server prefers a group
+ * other than the default. An entry is forgotten when the handshake using it
+ * fails before the server's reply is processed.
+ *
+ * ctx      The SSL/TLS CTX object.
+ * entries  Number of servers to remember.
+ *          0 indicates the default of KEY_SHARE_CACHE_DEF_ENTRIES.
+ * returns BAD_FUNC_ARG when ctx is NULL or not TLS v1.3, SIDE_ERROR when not a
+ * client, MEMORY_E on dynamic memory allocation failure and 0 on success.
+ */
+int wolfSSL_CTX_EnableKeyShareCache(WOLFSSL_CTX* ctx, unsigned int entries)
+{
+    KeyShareCache* cache;
+
+    if (ctx == NULL || !IsAtLeastTLSv1_3(ctx->method->version))
+        return BAD_FUNC_ARG;
+    if (ctx->method->side == WOLFSSL_SERVER_END)
+        return SIDE_ERROR;
+
+    if (entries == 0)
+        entries = KEY_SHARE_CACHE_DEF_ENTRIES;
+
+    cache = (KeyShareCache*)XMALLOC(sizeof(KeyShareCache), ctx->heap,
+                                    DYNAMIC_TYPE_TMP_BUFFER);
+    if (cache == NULL)
+        return MEMORY_E;
+    XMEMSET(cache, 0, sizeof(KeyShareCache));
+
+    cache->entries = (KeyShareCacheEntry*)XMALLOC(
+                                       entries * sizeof(KeyShareCacheEntry),
+                                       ctx->heap, DYNAMIC_TYPE_TMP_BUFFER);
+    if (cache->entries == NULL) {
+        XFREE(cache, ctx->heap, DYNAMIC_TYPE_TMP_BUFFER);
+        return MEMORY_E;
+    }
+    XMEMSET(cache->entries, 0, entries * sizeof(KeyShareCacheEntry));
+    cache->cnt = entries;
+    if (wc_InitMutex(&cache->lock) != 0) {
+        XFREE(cache->entries, ctx->heap, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(cache, ctx->heap, DYNAMIC_TYPE_TMP_BUFFER);
+        return BAD_MUTEX_E;
+    }
+
+    if (ctx->keyShareCache != NULL)
+        FreeKeyShareCache(ctx->keyShareCache, ctx->heap);
+    ctx->keyShareCache = cache;
+
+    return 0;
+}
+
+/* Disable the cache of groups selected by servers.
+ *
+ * ctx  The SSL/TLS CTX object.
+ * returns BAD_FUNC_ARG when ctx is NULL and 0 on success.
+ */
+int wolfSSL_CTX_DisableKeyShareCache(WOLFSSL_CTX* ctx)
+{
+    if (ctx == NULL)
+        return BAD_FUNC_ARG;
+
+    if (ctx->keyShareCache != NULL) {
+        FreeKeyShareCache(ctx->keyShareCache, ctx->heap);
+        ctx->keyShareCache = NULL;
+    }
+
+    return 0;
+}
+
+/* Get the counts of the key share cache.
+ *
+ * ctx      The SSL/TLS CTX object.
+ * lookups  Number of ClientHellos with a server name.
+ * hits     Number of ClientHellos with a key share from the cache.
+ * hrrs     Number of HelloRetryRequests received from named servers.
+ * returns BAD_FUNC_ARG when ctx is NULL or the cache is not enabled,
+ * BAD_MUTEX_E when locking fails and 0 on success.
+ */
+int wolfSSL_CTX_GetKeyShareCacheStats(WOLFSSL_CTX* ctx, unsigned int* lookups,
+                                      unsigned int* hits, unsigned int* hrrs)
+{
+    KeyShareCache* cache;
+
+    if (ctx == NULL || ctx->keyShareCache == NULL)
+        return BAD_FUNC_ARG;
+    cache = ctx->keyShareCache;
+
+    if (wc_LockMutex(&cache->lock) != 0)
+        return BAD_MUTEX_E;
+    if (lookups != NULL)
+        *lookups = cache->lookups;
+    if (hits != NULL)
+        *hits = cache->hits;
+    if (hrrs != NULL)
+        *hrrs = cache->hrrs;
+    wc_UnLockMutex(&cache->lock);
+
+    return 0;
+}
+#endif /* WOLFSSL_KEY_SHARE_CACHE */
+
+#ifdef WOLFSSL_KEY_SHARE_POOL
+/* Keep a pool of pre-generated key pairs for a group.
+ * Key shares for the group are taken from the pool, when not empty, instead
+ * of generating a key pair during the handshake. Each key pair is used once.
+ * The pool is filled by calling wolfSSL_CTX_FillKeySharePool().
+ * Call before the CTX is used to create SSL/TLS objects.
+ *
+ * ctx    The SSL/TLS CTX object.
+ * group  The named group to pool key pairs for.
+ * size   The maximum number of key pairs to hold for the group.
+ *        0 indicates the default of KEY_SHARE_POOL_DEF_SIZE.
+ * returns BAD_FUNC_ARG when ctx is NULL, not TLS v1.3 or the group is not
+ * supported, BUFFER_E when KEY_SHARE_POOL_MAX_GROUPS groups are already
+ * pooled, MEMORY_E on dynamic memory allocation failure and 0 on success.
+ */
+int wolfSSL_CTX_UseKeySharePool(WOLFSSL_CTX* ctx, word16 group,
+                                unsigned int size)
+{
+    KeySharePool* pool;
+
+    if (ctx == NULL || !IsAtLeastTLSv1_3(ctx->method->version))
+        return BAD_FUNC_ARG;
+
+    if (size == 0)
+        size = KEY_SHARE_POOL_DEF_SIZE;
+
+    if (ctx->keySharePool == NULL) {
+        pool = (KeySharePool*)XMALLOC(sizeof(KeySharePool), ctx->heap,
+                                      DYNAMIC_TYPE_TMP_BUFFER);
+        if (pool == NULL)
+            return MEMORY_E;
+        XMEMSET(pool, 0, sizeof(KeySharePool));
+        if (wc_InitMutex(&pool->lock) != 0) {
+            XFREE(pool, ctx->heap, DYNAMIC_TYPE_TMP_BUFFER);
+            return BAD_MUTEX_E;
+        }
+        ctx->keySharePool = pool;
+    }
+
+    return TLSX_KeySharePool_Add(ctx->keySharePool, group, size);
+}
+
+/* Generate key pairs to fill the pool.
+ * Safe to call while handshakes are taking key pairs from the pool.
+ * Call from a low priority thread or when an event loop is idle.
+ *
+ * ctx  The SSL/TLS CTX object.
+ * max  The maximum number of key pairs to generate. 0 fills the pool.
+ * returns BAD_FUNC_ARG when ctx is NULL or has no pool, the number of key
+ * pairs generated on success and a negative value otherwise.
+ */
+int wolfSSL_CTX_FillKeySharePool(WOLFSSL_CTX* ctx, int max)
+{
+    if (ctx == NULL || ctx->keySharePool == NULL)
+        return BAD_FUNC_ARG;
+
+    return TLSX_KeySharePool_Fill(ctx->keySharePool, ctx->heap, ctx->devId,
+                                  max);
+}
+
+/* Get the counts of the key share pool for a group.
+ *
+ * ctx     The SSL/TLS CTX object.
+ * group   The named group.
+ * avail   Number of key pairs in the pool.
+ * hits    Number of key shares that used a key pair from the pool.
+ * misses  Number of key shares generated as the pool was empty.
+ * returns BAD_FUNC_ARG when ctx is NULL or the group is not pooled,
+ * BAD_MUTEX_E when locking fails and 0 on success.
+ */
+int wolfSSL_CTX_GetKeySharePoolStats(WOLFSSL_CTX* ctx, word16 group,
+                                     unsigned int* avail, unsigned int* hits,
+                                     unsigned int* misses)
+{
+    KeySharePool* pool;
+    int           ret = BAD_FUNC_ARG;
+    int           i;
+
+    if (ctx == NULL || ctx->keySharePool == NULL)
+        return BAD_FUNC_ARG;
+    pool = ctx->keySharePool;
+
+    if (wc_LockMutex(&pool->lock) != 0)
+        return BAD_MUTEX_E;
+    for (i = 0; i < pool->numGroups; i++) {
+        if (pool->groups[i].group != group)
+            continue;
+        if (avail != NULL)
+            *avail = pool->groups[i].cnt;
+        if (hits != NULL)
+            *hits = pool->groups[i].hits;
+        if (misses != NULL)
+            *misses = pool->groups[i].misses;
+        ret = 0;
+        break;
+    }
+    wc_UnLockMutex(&pool->lock);
+
+    return ret;
+}
+#endif /* WOLFSSL_KEY_SHARE_POOL */
+
 #ifndef NO_PSK
 void wolfSSL_CTX_set_psk_client_tls13_callback(WOLFSSL_CTX* ctx,
                                                wc_psk_client_tls13_callback cb)
@@ -8625,6 +9414,10 @@ int wolfSSL_accept_TLSv13(WOLFSSL* ssl)
                 ssl->options.handShakeState = SERVER_FINISHED_COMPLETE;
                 return WOLFSSL_SUCCESS;
             }
+#endif
+#ifdef WOLFSSL_HALF_RTT_DATA
+            if (ssl->options.halfRttData)
+                return WOLFSSL_SUCCESS;
 #endif
             FALL_THROUGH;
 
@@ -8699,6 +9492,114 @@ int wolfSSL_accept_TLSv13(WOLFSSL* ssl)
 }
 #endif
 
+#ifdef WOLFSSL_HALF_RTT_DATA
+/* Write application data to the client with the server's handshake flight.
+ * The handshake is performed up to sending the server's Finished message and
+ * the data is encrypted with the server's application traffic key and sent in
+ * the same write as the flight. Call wolfSSL_accept() to finish the handshake.
+ * Once the client's Finished message has been processed, this is the same as
+ * wolfSSL_write().
+ *
+ * 0.5-RTT data is sent before the client has proven it holds the keys. The
+ * client's certificate, when requested, has not been verified and the client
+ * may not be live (the ClientHello may be a replay). Only send data that is
+ * suitable for any client that can send a ClientHello, e.g. a greeting.
+ *
+ * When the write would block, call again with the same data once the
+ * transport is writable. The buffered flight and data are sent without
+ * encrypting the data again.
+ *
+ * ssl    The SSL/TLS object.
+ * data   Application data to send.
+ * sz     The size of the data in bytes.
+ * outSz  The number of bytes of data written.
+ * returns BAD_FUNC_ARG when: ssl, data or outSz is NULL; sz is negative;
+ * or not using TLS v1.3. SIDE ERROR when not a server. Otherwise the number of
+ * bytes written.
+ */
+int wolfSSL_write_half_rtt_data(WOLFSSL* ssl, const void* data, int sz,
+                                int* outSz)
+{
+    int    ret = 0;
+    word16 groupMessages;
+
+    WOLFSSL_ENTER("wolfSSL_write_half_rtt_data()");
+
+    if (ssl == NULL || data == NULL || sz < 0 || outSz == NULL)
+        return BAD_FUNC_ARG;
+    if (!IsAtLeastTLSv1_3(ssl->version))
+        return BAD_FUNC_ARG;
+
+#ifndef NO_WOLFSSL_SERVER
+    if (ssl->options.side == WOLFSSL_CLIENT_END)
+        return SIDE_ERROR;
+
+    if (ssl->options.halfRttPending) {
+        /* Data is already encrypted in the output buffer - only send it. */
+        if (ssl->buffers.outputBuffer.length > 0 &&
+                                 (ssl->error = SendBuffered(ssl)) < 0) {
+            WOLFSSL_LEAVE("wolfSSL_write_half_rtt_data()", ssl->error);
+            return WOLFSSL_FATAL_ERROR;
+        }
+        ssl->options.halfRttPending = 0;
+        ret = ssl->buffers.prevSent + ssl->buffers.plainSz;
+        *outSz = ret;
+        WOLFSSL_LEAVE("wolfSSL_write_half_rtt_data()", ret);
+        return ret;
+    }
+
+    if (ssl->options.acceptState > TLS13_ACCEPT_FINISHED_SENT) {
+        ret = SendData(ssl, data, sz);
+        if (ret > 0)
+            *outSz = ret;
+        WOLFSSL_LEAVE("wolfSSL_write_half_rtt_data()", ret);
+        return ret < 0 ? WOLFSSL_FATAL_ERROR : ret;
+    }
+
+    ssl->options.halfRttData = 1;
+    if (ssl->options.acceptState < TLS13_ACCEPT_FINISHED_SENT) {
+        /* Keep the server's flight in the output buffer. */
+        groupMessages = ssl->options.groupMessages;
+        ssl->options.groupMessages = 1;
+        ret = wolfSSL_accept_TLSv13(ssl);
+        ssl->options.groupMessages = groupMessages;
+        if (ret != WOLFSSL_SUCCESS) {
+            /* Send any HelloRetryRequest before waiting on the client. */
+            if (ssl->buffers.outputBuffer.length > 0 &&
+                                                  ssl->error == WANT_READ) {
+                if ((ret = SendBuffered(ssl)) != 0)
+                    ssl->error = ret;
+            }
+            ssl->options.halfRttData = 0;
+            return WOLFSSL_FATAL_ERROR;
+        }
+    }
+    ret = SendData(ssl, data, sz);
+    if (ret >= 0 && ssl->buffers.outputBuffer.length > 0) {
+        /* No data to send with the flight. */
+        ssl->buffers.prevSent = ret;
+        ssl->buffers.plainSz  = 0;
+        if ((ssl->error = SendBuffered(ssl)) < 0)
+            ret = ssl->error;
+    }
+    /* SendData recorded the size of the data left in the output buffer. */
+    if (ret == WANT_WRITE)
+        ssl->options.halfRttPending = 1;
+    ssl->options.halfRttData = 0;
+    if (ret > 0)
+        *outSz = ret;
+#else
+    return SIDE_ERROR;
+#endif
+
+    WOLFSSL_LEAVE("wolfSSL_write_half_rtt_data()", ret);
+
+    if (ret < 0)
+        ret = WOLFSSL_FATAL_ERROR;
+    return ret;
+}
+#endif /* WOLFSSL_HALF_RTT_DATA */
+
 #ifdef WOLFSSL_EARLY_DATA
 /* Sets the maximum amount of early data that can be seen by server when using
  * session tickets for resumption.
@@ -8744,6 +9645,159 @@ int wolfSSL_set_max_early_data(WOLFSSL* ssl, unsigned int sz)
     return 0;
 }
 
+#ifdef WOLFSSL_EARLY_DATA_ANTI_REPLAY
+/* Enable the anti-replay cache for early data.
+ * Early data is only accepted from a ClientHello resuming with a ticket whose
+ * age is within windowMs of the server's view and whose binder has not been
+ * seen. Binders are remembered for at least twice windowMs.
+ * When the cache can't hold any more ClientHellos, or may have seen it before,
+ * the early data is rejected and the handshake continues as normal.
+ *
+ * ctx         The SSL/TLS CTX object.
+ * windowMs    Allowed difference in ticket age in milliseconds.
+ *             0 indicates the default of MAX_TICKET_AGE_SECS.
+ * maxEntries  Maximum number of ClientHellos with early data in a window.
+ *             0 indicates the default of ANTI_REPLAY_DEF_ENTRIES.
+ * mode        WOLFSSL_ANTI_REPLAY_EXACT to keep binder fingerprints or
+ *             WOLFSSL_ANTI_REPLAY_BLOOM to use a smaller Bloom filter that
+ *             rarely rejects fresh early data.
+ * returns BAD_FUNC_ARG when ctx is NULL or not TLS v1.3, SIDE_ERROR when not a
+ * server, MEMORY_E on dynamic memory allocation failure and 0 on success.
+ */
+int wolfSSL_CTX_EnableAntiReplay(WOLFSSL_CTX* ctx, unsigned int windowMs,
+                                 unsigned int maxEntries, int mode)
+{
+    AntiReplayCache* cache;
+    int              i;
+    int              ret = 0;
+
+    if (ctx == NULL || !IsAtLeastTLSv1_3(ctx->method->version))
+        return BAD_FUNC_ARG;
+    if (mode != WOLFSSL_ANTI_REPLAY_EXACT && mode != WOLFSSL_ANTI_REPLAY_BLOOM)
+        return BAD_FUNC_ARG;
+    if (ctx->method->side == WOLFSSL_CLIENT_END)
+        return SIDE_ERROR;
+
+    if (windowMs == 0)
+        windowMs = MAX_TICKET_AGE_SECS * 1000;
+    if (maxEntries == 0)
+        maxEntries = ANTI_REPLAY_DEF_ENTRIES;
+    /* Four windows must fit in the 32-bit millisecond clock. */
+    if (windowMs > 0x3FFFFFFF)
+        return BAD_FUNC_ARG;
+
+    cache = (AntiReplayCache*)XMALLOC(sizeof(AntiReplayCache), ctx->heap,
+                                      DYNAMIC_TYPE_TMP_BUFFER);
+    if (cache == NULL)
+        return MEMORY_E;
+    XMEMSET(cache, 0, sizeof(AntiReplayCache));
+
+    cache->windowMs = windowMs;
+    cache->bloom = (mode == WOLFSSL_ANTI_REPLAY_BLOOM);
+    cache->perShard = (maxEntries + ANTI_REPLAY_SHARDS - 1) /
+                                                            ANTI_REPLAY_SHARDS;
+    if (cache->bloom)
+        cache->dataSz = cache->perShard * ANTI_REPLAY_BLOOM_BITS /
+                                                              WOLFSSL_BIT_SIZE;
+    else
+        cache->dataSz = cache->perShard * 2 * ANTI_REPLAY_FP_SZ;
+
+    for (i = 0; i < ANTI_REPLAY_SHARDS; i++) {
+        AntiReplayShard* shard = &cache->shards[i];
+
+        shard->gen[0].data = (byte*)XMALLOC(cache->dataSz, ctx->heap,
+                                            DYNAMIC_TYPE_TMP_BUFFER);
+        shard->gen[1].data = (byte*)XMALLOC(cache->dataSz, ctx->heap,
+                                            DYNAMIC_TYPE_TMP_BUFFER);
+        if (shard->gen[0].data == NULL || shard->gen[1].data == NULL) {
+            ret = MEMORY_E;
+        }
+        else {
+            XMEMSET(shard->gen[0].data, 0, cache->dataSz);
+            XMEMSET(shard->gen[1].data, 0, cache->dataSz);
+        }
+        if (wc_InitMutex(&shard->lock) != 0 && ret == 0)
+            ret = BAD_MUTEX_E;
+    }
+    if (ret != 0) {
+        FreeAntiReplayCache(cache, ctx->heap);
+        return ret;
+    }
+
+    if (ctx->antiReplay != NULL)
+        FreeAntiReplayCache(ctx->antiReplay, ctx->heap);
+    ctx->antiReplay = cache;
+
+    return 0;
+}
+
+/* Disable the anti-replay cache for early data.
+ * Early data is then accepted without replay checks.
+ *
+ * ctx  The SSL/TLS CTX object.
+ * returns BAD_FUNC_ARG when ctx is NULL and 0 on success.
+ */
+int wolfSSL_CTX_DisableAntiReplay(WOLFSSL_CTX* ctx)
+{
+    if (ctx == NULL)
+        return BAD_FUNC_ARG;
+
+    if (ctx->antiReplay != NULL) {
+        FreeAntiReplayCache(ctx->antiReplay, ctx->heap);
+        ctx->antiReplay = NULL;
+    }
+
+    return 0;
+}
+
+/* Get the counts of the anti-replay cache.
+ *
+ * ctx      The SSL/TLS CTX object.
+ * checks   Number of ClientHellos with early data checked.
+ * replays  Number of ClientHellos whose binder was seen before.
+ * rejects  Number of ClientHellos not fresh or not recorded as window full.
+ * memSz    Size of the cache in bytes.
+ * returns BAD_FUNC_ARG when ctx is NULL or the cache is not enabled and 0 on
+ * success.
+ */
+int wolfSSL_CTX_GetAntiReplayStats(WOLFSSL_CTX* ctx, unsigned int* checks,
+                                   unsigned int* replays, unsigned int* rejects,
+                                   unsigned int* memSz)
+{
+    AntiReplayCache* cache;
+    word32           c = 0, h = 0, r = 0;
+    int              i;
+
+    if (ctx == NULL || ctx->antiReplay == NULL)
+        return BAD_FUNC_ARG;
+    cache = ctx->antiReplay;
+
+    for (i = 0; i < ANTI_REPLAY_SHARDS; i++) {
+        AntiReplayShard* shard = &cache->shards[i];
+
+        if (wc_LockMutex(&shard->lock) != 0)
+            return BAD_MUTEX_E;
+        c += shard->checks;
+        h += shard->replays;
+        r += shard->rejects;
+        wc_UnLockMutex(&shard->lock);
+    }
+
+    if (checks != NULL)
+        *checks = c;
+    if (replays != NULL)
+        *replays = h;
+    if (rejects != NULL)
+        *rejects = r;
+    if (memSz != NULL) {
+        *memSz = (word32)sizeof(AntiReplayCache) +
+                                  ANTI_REPLAY_SHARDS * 2 * cache->dataSz;
+    }
+
+    return 0;
+}
+#endif /* WOLFSSL_EARLY_DATA_ANTI_REPLAY */
+
 /* Write early data to the server.
  *
  * ssl    The SSL/TLS object.
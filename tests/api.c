@@ -1151,6 +1151,10 @@ static void test_wolfSSL_CertManagerCRL(void)
     const char* ca_cert = "./certs/ca-cert.pem";
     const char* crl1     = "./certs/crl/crl.pem";
     const char* crl2     = "./certs/crl/crl2.pem";
+    const char* revoked  = "./certs/server-revoked-cert.pem";
+    byte        crlBuf[FOURK_BUF];
+    int         crlSz;
+    XFILE       f;
 
     WOLFSSL_CERT_MANAGER* cm = NULL;
 
@@ -1159,6 +1163,18 @@ static void test_wolfSSL_CertManagerCRL(void)
         wolfSSL_CertManagerLoadCA(cm, ca_cert, NULL));
     AssertIntEQ(WOLFSSL_SUCCESS,
         wolfSSL_CertManagerLoadCRL(cm, crl1, WOLFSSL_FILETYPE_PEM, 0));
+
+    /* revoked serial lookup */
+    AssertTrue((f = XFOPEN(crl1, "rb")) != XBADFILE);
+    crlSz = (int)XFREAD(crlBuf, 1, sizeof(crlBuf), f);
+    AssertIntGT(crlSz, 0);
+    XFCLOSE(f);
+    AssertIntEQ(WOLFSSL_SUCCESS, wolfSSL_CertManagerLoadCRLBuffer(cm, crlBuf,
+                                                crlSz, WOLFSSL_FILETYPE_PEM));
+    AssertIntEQ(CRL_CERT_REVOKED,
+        wolfSSL_CertManagerVerify(cm, revoked, WOLFSSL_FILETYPE_PEM));
+    AssertIntEQ(WOLFSSL_SUCCESS,
+        wolfSSL_CertManagerVerify(cm, svrCertFile, WOLFSSL_FILETYPE_PEM));
     AssertIntEQ(WOLFSSL_SUCCESS,
         wolfSSL_CertManagerLoadCRL(cm, crl2, WOLFSSL_FILETYPE_PEM, 0));
     wolfSSL_CertManagerFreeCRL(cm);
@@ -1172,6 +1188,144 @@ static void test_wolfSSL_CertManagerCRL(void)
 #endif
 }
 
+#if defined(HAVE_CRL_MONITOR) && !defined(NO_FILESYSTEM) && \
+    !defined(NO_CERTS) && !defined(NO_RSA) && !defined(NO_WOLFSSL_DIR)
+#define CRL_MON_THREADS 4
+
+typedef struct crl_mon_args {
+    WOLFSSL_CERT_MANAGER* cm;
+    const byte*           revoked;
+    int                   revokedSz;
+    const byte*           good;
+    int                   goodSz;
+    volatile int*         done;
+    int                   checks;
+    int                   errors;
+} crl_mon_args;
+
+/* check certs against the CRL over and over while the monitor reloads */
+static THREAD_RETURN WOLFSSL_THREAD test_crl_mon_checker(void* args)
+{
+    crl_mon_args* a = (crl_mon_args*)args;
+
+    while (*a->done == 0) {
+        if (wolfSSL_CertManagerVerifyBuffer(a->cm, a->revoked, a->revokedSz,
+                                   WOLFSSL_FILETYPE_PEM) != CRL_CERT_REVOKED)
+            a->errors++;
+        if (wolfSSL_CertManagerVerifyBuffer(a->cm, a->good, a->goodSz,
+                                   WOLFSSL_FILETYPE_PEM) != WOLFSSL_SUCCESS)
+            a->errors++;
+        a->checks++;
+    }
+
+#ifndef WOLFSSL_TIRTOS
+    return 0;
+#endif
+}
+
+static void test_crl_mon_write(const char* name, const byte* buf, int sz)
+{
+    XFILE f;
+
+    AssertTrue((f = XFOPEN(name, "wb")) != XBADFILE);
+    AssertIntEQ((int)XFWRITE(buf, 1, sz, f), sz);
+    XFCLOSE(f);
+}
+
+static int test_crl_mon_read(const char* name, byte* buf, int bufSz)
+{
+    XFILE f;
+    int   sz;
+
+    AssertTrue((f = XFOPEN(name, "rb")) != XBADFILE);
+    sz = (int)XFREAD(buf, 1, bufSz, f);
+    XFCLOSE(f);
+    AssertIntGT(sz, 0);
+    AssertIntLT(sz, bufSz);  /* whole file read */
+
+    return sz;
+}
+#endif
+
+/* CRL files churn under the monitor while many threads check certs, every
+ * check has to see a complete CRL */
+static void test_wolfSSL_CertManagerCRL_monitor(void)
+{
+#if defined(HAVE_CRL_MONITOR) && !defined(NO_FILESYSTEM) && \
+    !defined(NO_CERTS) && !defined(NO_RSA) && !defined(NO_WOLFSSL_DIR)
+    WOLFSSL_CERT_MANAGER* cm = NULL;
+    THREAD_TYPE  threads[CRL_MON_THREADS];
+    crl_mon_args args[CRL_MON_THREADS];
+    volatile int done = 0;
+    char   dir[] = "/tmp/wolfssl_crl_XXXXXX";
+    char   fileA[64], fileB[64], fileTmp[64];
+    byte   crlBuf[FOURK_BUF];
+    static byte revoked[FOURK_BUF * 3];
+    static byte good[FOURK_BUF * 3];
+    int    crlSz, revokedSz, goodSz;
+    int    i;
+    int    checks = 0;
+
+    printf(testingFmt, "wolfSSL_CertManagerCRL monitor");
+
+    crlSz = test_crl_mon_read("./certs/crl/crl.pem", crlBuf, sizeof(crlBuf));
+    revokedSz = test_crl_mon_read("./certs/server-revoked-cert.pem", revoked,
+                                  sizeof(revoked));
+    goodSz = test_crl_mon_read(svrCertFile, good, sizeof(good));
+
+    AssertNotNull(mkdtemp(dir));
+    XSNPRINTF(fileA, sizeof(fileA), "%s/a.pem", dir);
+    XSNPRINTF(fileB, sizeof(fileB), "%s/b.pem", dir);
+    XSNPRINTF(fileTmp, sizeof(fileTmp), "%s/a.tmp", dir);
+    test_crl_mon_write(fileA, crlBuf, crlSz);
+
+    AssertNotNull(cm = wolfSSL_CertManagerNew());
+    AssertIntEQ(WOLFSSL_SUCCESS,
+        wolfSSL_CertManagerLoadCA(cm, "./certs/ca-cert.pem", NULL));
+    AssertIntEQ(WOLFSSL_SUCCESS, wolfSSL_CertManagerLoadCRL(cm, dir,
+            WOLFSSL_FILETYPE_PEM, WOLFSSL_CRL_MONITOR | WOLFSSL_CRL_START_MON));
+    /* loading the directory again replaces the entries from each file */
+    AssertIntEQ(WOLFSSL_SUCCESS,
+        wolfSSL_CertManagerLoadCRL(cm, dir, WOLFSSL_FILETYPE_PEM, 0));
+
+    for (i = 0; i < CRL_MON_THREADS; i++) {
+        XMEMSET(&args[i], 0, sizeof(args[i]));
+        args[i].cm        = cm;
+        args[i].revoked   = revoked;
+        args[i].revokedSz = revokedSz;
+        args[i].good      = good;
+        args[i].goodSz    = goodSz;
+        args[i].done      = &done;
+        start_thread(test_crl_mon_checker, (func_args*)&args[i], &threads[i]);
+    }
+
+    for (i = 0; i < 100; i++) {
+        /* rewrite in place, replace by rename, add and delete a file */
+        test_crl_mon_write(fileA, crlBuf, crlSz);
+        test_crl_mon_write(fileTmp, crlBuf, crlSz);
+        AssertIntEQ(rename(fileTmp, fileA), 0);
+        test_crl_mon_write(fileB, crlBuf, crlSz);
+        AssertIntEQ(remove(fileB), 0);
+    }
+
+    done = 1;
+    for (i = 0; i < CRL_MON_THREADS; i++) {
+        join_thread(threads[i]);
+        AssertIntEQ(args[i].errors, 0);
+        checks += args[i].checks;
+    }
+    AssertIntGT(checks, 0);
+
+    /* frees the CRL with the monitor still running */
+    wolfSSL_CertManagerFree(cm);
+
+    AssertIntEQ(remove(fileA), 0);
+    AssertIntEQ(rmdir(dir), 0);
+
+    printf(resultFmt, passed);
+#endif
+}
+
 static void test_wolfSSL_CTX_load_verify_locations_ex(void)
 {
 #if !defined(NO_FILESYSTEM) && !defined(NO_CERTS) && !defined(NO_RSA) && \
@@ -2018,6 +2172,1581 @@ static void test_wolfSSL_EVP_CIPHER_CTX()
 #define HAVE_IO_TESTS_DEPENDENCIES
 #endif
 
+#if !defined(NO_FILESYSTEM) && !defined(NO_CERTS) && !defined(NO_RSA) && \
+    !defined(NO_WOLFSSL_SERVER) && !defined(NO_WOLFSSL_CLIENT) && \
+    (defined(WOLFSSL_CERT_VERIFY_CACHE) || defined(WOLFSSL_OCSP_STAPLE_MGR) || \
+     defined(WOLFSSL_LAZY_HS_HASH) || defined(WOLFSSL_CERT_MSG_CACHE) || \
+     defined(WOLFSSL_EARLY_DATA_ANTI_REPLAY) || defined(WOLFSSL_HALF_RTT_DATA) || \
+     defined(WOLFSSL_KEY_SHARE_CACHE) || defined(WOLFSSL_KEY_SHARE_POOL) || \
+     defined(WOLFSSL_CH_PREPARSE) || defined(WOLFSSL_SNI_CERT_STORE) || \
+     defined(WOLFSSL_HMAC_MIDSTATE))
+#define HAVE_MEMIO_TESTS_DEPENDENCIES
+#endif
+
+#if defined(WOLFSSL_CERT_MSG_CACHE) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+#include "wolfssl/internal.h" /* for comparing the CTX's encoded message */
+#endif
+#if defined(WOLFSSL_OCSP_STAPLE_MGR) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+#include "wolfssl/internal.h" /* for counting the staple manager's entries */
+#endif
+#if defined(WOLFSSL_HMAC_MIDSTATE) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+#include "wolfssl/internal.h" /* for checking the cached HKDF keys */
+#endif
+
+#ifdef HAVE_MEMIO_TESTS_DEPENDENCIES
+/* In memory transport so a client and server can handshake in one thread */
+#define TEST_MEMIO_BUF_SZ (64 * 1024)
+struct test_memio_ctx {
+    byte c_buff[TEST_MEMIO_BUF_SZ]; /* data for the client to read */
+    int  c_len;
+    byte s_buff[TEST_MEMIO_BUF_SZ]; /* data for the server to read */
+    int  s_len;
+};
+
+static int test_memio_write_cb(WOLFSSL* ssl, char* data, int sz, void* ctx)
+{
+    struct test_memio_ctx* test_ctx = (struct test_memio_ctx*)ctx;
+    byte* buf;
+    int*  len;
+
+    if (wolfSSL_is_server(ssl)) {
+        buf = test_ctx->c_buff;
+        len = &test_ctx->c_len;
+    }
+    else {
+        buf = test_ctx->s_buff;
+        len = &test_ctx->s_len;
+    }
+
+    if (*len + sz > TEST_MEMIO_BUF_SZ)
+        return WOLFSSL_CBIO_ERR_GENERAL;
+
+    XMEMCPY(buf + *len, data, sz);
+    *len += sz;
+
+    return sz;
+}
+
+static int test_memio_read_cb(WOLFSSL* ssl, char* data, int sz, void* ctx)
+{
+    struct test_memio_ctx* test_ctx = (struct test_memio_ctx*)ctx;
+    byte* buf;
+    int*  len;
+    int   readSz;
+
+    if (wolfSSL_is_server(ssl)) {
+        buf = test_ctx->s_buff;
+        len = &test_ctx->s_len;
+    }
+    else {
+        buf = test_ctx->c_buff;
+        len = &test_ctx->c_len;
+    }
+
+    if (*len == 0)
+        return WOLFSSL_CBIO_ERR_WANT_READ;
+
+    readSz = (sz < *len) ? sz : *len;
+    XMEMCPY(data, buf, readSz);
+    XMEMMOVE(buf, buf + readSz, *len - readSz);
+    *len -= readSz;
+
+    return readSz;
+}
+
+/* Step client and server until both finish the handshake.
+ * returns 0 on success and -1 on failure or when max_rounds is reached */
+static int test_memio_do_handshake(WOLFSSL* ssl_c, WOLFSSL* ssl_s,
+                                   int max_rounds, int* rounds)
+{
+    int handshake_c = 0;
+    int handshake_s = 0;
+    int ret, err;
+
+    if (rounds != NULL)
+        *rounds = 0;
+
+    while ((!handshake_c || !handshake_s) && max_rounds-- > 0) {
+        if (!handshake_c) {
+            ret = wolfSSL_connect(ssl_c);
+            if (ret == WOLFSSL_SUCCESS) {
+                handshake_c = 1;
+            }
+            else {
+                err = wolfSSL_get_error(ssl_c, ret);
+                if (err != WOLFSSL_ERROR_WANT_READ &&
+                                               err != WOLFSSL_ERROR_WANT_WRITE)
+                    return -1;
+            }
+        }
+        if (!handshake_s) {
+            ret = wolfSSL_accept(ssl_s);
+            if (ret == WOLFSSL_SUCCESS) {
+                handshake_s = 1;
+            }
+            else {
+                err = wolfSSL_get_error(ssl_s, ret);
+                if (err != WOLFSSL_ERROR_WANT_READ &&
+                                               err != WOLFSSL_ERROR_WANT_WRITE)
+                    return -1;
+            }
+        }
+        if (rounds != NULL)
+            (*rounds)++;
+    }
+
+    return (handshake_c && handshake_s) ? 0 : -1;
+}
+
+/* Create the contexts when not passed in and a new client and server pair
+ * connected through ctx. returns 0 on success */
+static int test_memio_setup(struct test_memio_ctx* ctx,
+    WOLFSSL_CTX** ctx_c, WOLFSSL_CTX** ctx_s, WOLFSSL** ssl_c, WOLFSSL** ssl_s,
+    method_provider method_c, method_provider method_s)
+{
+    if (*ctx_c == NULL) {
+        *ctx_c = wolfSSL_CTX_new(method_c());
+        if (*ctx_c == NULL)
+            return -1;
+        wolfSSL_SetIORecv(*ctx_c, test_memio_read_cb);
+        wolfSSL_SetIOSend(*ctx_c, test_memio_write_cb);
+        if (wolfSSL_CTX_load_verify_locations(*ctx_c, caCertFile, 0) !=
+                                                              WOLFSSL_SUCCESS ||
+            wolfSSL_CTX_use_certificate_file(*ctx_c, cliCertFile,
+                                     WOLFSSL_FILETYPE_PEM) != WOLFSSL_SUCCESS ||
+            wolfSSL_CTX_use_PrivateKey_file(*ctx_c, cliKeyFile,
+                                     WOLFSSL_FILETYPE_PEM) != WOLFSSL_SUCCESS) {
+            return -1;
+        }
+    }
+    if (*ctx_s == NULL) {
+        *ctx_s = wolfSSL_CTX_new(method_s());
+        if (*ctx_s == NULL)
+            return -1;
+        wolfSSL_SetIORecv(*ctx_s, test_memio_read_cb);
+        wolfSSL_SetIOSend(*ctx_s, test_memio_write_cb);
+        if (wolfSSL_CTX_load_verify_locations(*ctx_s, cliCertFile, 0) !=
+                                                              WOLFSSL_SUCCESS ||
+            wolfSSL_CTX_use_certificate_file(*ctx_s, svrCertFile,
+                                     WOLFSSL_FILETYPE_PEM) != WOLFSSL_SUCCESS ||
+            wolfSSL_CTX_use_PrivateKey_file(*ctx_s, svrKeyFile,
+                                     WOLFSSL_FILETYPE_PEM) != WOLFSSL_SUCCESS) {
+            return -1;
+        }
+    }
+
+    ctx->c_len = 0;
+    ctx->s_len = 0;
+
+    *ssl_c = wolfSSL_new(*ctx_c);
+    *ssl_s = wolfSSL_new(*ctx_s);
+    if (*ssl_c == NULL || *ssl_s == NULL)
+        return -1;
+
+    wolfSSL_SetIOReadCtx(*ssl_c, ctx);
+    wolfSSL_SetIOWriteCtx(*ssl_c, ctx);
+    wolfSSL_SetIOReadCtx(*ssl_s, ctx);
+    wolfSSL_SetIOWriteCtx(*ssl_s, ctx);
+#if !defined(NO_DH)
+    wolfSSL_SetTmpDH_file(*ssl_s, dhParamFile, WOLFSSL_FILETYPE_PEM);
+#endif
+
+    return 0;
+}
+#endif /* HAVE_MEMIO_TESTS_DEPENDENCIES */
+
+static void test_wolfSSL_CertManagerVerifyCache(void)
+{
+#if defined(WOLFSSL_CERT_VERIFY_CACHE) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL_CTX* ctx_s = NULL;
+    WOLFSSL*     ssl_c = NULL;
+    WOLFSSL*     ssl_s = NULL;
+    WOLFSSL_CERT_MANAGER* cm = NULL;
+    word32 hits = 0, misses = 0;
+    int i;
+
+    printf(testingFmt, "wolfSSL_CertManagerVerifyCache()");
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+
+    AssertIntEQ(wolfSSL_CertManagerEnableVerifyCache(NULL, 0), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_EnableVerifyCache(NULL, 0), BAD_FUNC_ARG);
+
+    /* client certificate verified by the server on every connection */
+    for (i = 0; i < 3; i++) {
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+            wolfSSLv23_client_method, wolfSSLv23_server_method), 0);
+        if (i == 0) {
+            wolfSSL_CTX_set_verify(ctx_s, WOLFSSL_VERIFY_PEER |
+                                    WOLFSSL_VERIFY_FAIL_IF_NO_PEER_CERT, NULL);
+            wolfSSL_set_verify(ssl_s, WOLFSSL_VERIFY_PEER |
+                                    WOLFSSL_VERIFY_FAIL_IF_NO_PEER_CERT, NULL);
+            AssertIntEQ(wolfSSL_CTX_EnableVerifyCache(ctx_s, 16),
+                                                              WOLFSSL_SUCCESS);
+            AssertNotNull(cm = wolfSSL_CTX_GetCertManager(ctx_s));
+            AssertIntEQ(wolfSSL_CertManagerGetVerifyCacheStats(cm, &hits,
+                                                     &misses), WOLFSSL_SUCCESS);
+            AssertIntEQ(hits, 0);
+            AssertIntEQ(misses, 0);
+        }
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+    }
+    /* first connection verified, the others found the chain */
+    AssertIntEQ(wolfSSL_CertManagerGetVerifyCacheStats(cm, &hits, &misses),
+                                                              WOLFSSL_SUCCESS);
+    AssertIntEQ(hits, 2);
+    AssertIntEQ(misses, 1);
+
+    /* state change drops the verified chains */
+    AssertIntEQ(wolfSSL_CertManagerDisableCRL(cm), WOLFSSL_SUCCESS);
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+        wolfSSLv23_client_method, wolfSSLv23_server_method), 0);
+    AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    AssertIntEQ(wolfSSL_CertManagerGetVerifyCacheStats(cm, &hits, &misses),
+                                                              WOLFSSL_SUCCESS);
+    AssertIntEQ(hits, 2);
+    AssertIntEQ(misses, 2);
+
+    /* removed trust means the chain must fail again */
+    AssertIntEQ(wolfSSL_CertManagerUnloadCAs(cm), WOLFSSL_SUCCESS);
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+        wolfSSLv23_client_method, wolfSSLv23_server_method), 0);
+    AssertIntNE(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+
+    AssertIntEQ(wolfSSL_CertManagerFlushVerifyCache(cm), WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_CertManagerDisableVerifyCache(cm), WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_CertManagerGetVerifyCacheStats(cm, &hits, &misses),
+                                                                 BAD_FUNC_ARG);
+
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+
+    printf(resultFmt, passed);
+#endif
+}
+
+#if defined(WOLFSSL_OCSP_STAPLE_MGR) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+static int test_ocsp_staple_calls = 0;
+static int test_ocsp_staple_fail = 0;
+
+/* Responder stand-in returning the canned response for server1 */
+static int test_ocsp_staple_io_cb(void* ctx, const char* url, int urlSz,
+                                  unsigned char* req, int reqSz,
+                                  unsigned char** resp)
+{
+    XFILE f;
+    int   sz;
+
+    (void)ctx;
+    (void)url;
+    (void)urlSz;
+    (void)req;
+    (void)reqSz;
+
+    test_ocsp_staple_calls++;
+    if (test_ocsp_staple_fail)
+        return -1;
+
+    f = XFOPEN("./certs/ocsp/server1-resp.der", "rb");
+    if (f == XBADFILE)
+        return -1;
+    *resp = (unsigned char*)XMALLOC(FOURK_BUF, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    if (*resp == NULL) {
+        XFCLOSE(f);
+        return -1;
+    }
+    sz = (int)XFREAD(*resp, 1, FOURK_BUF, f);
+    XFCLOSE(f);
+
+    return sz;
+}
+
+static void test_ocsp_staple_free_cb(void* ctx, unsigned char* resp)
+{
+    (void)ctx;
+    XFREE(resp, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+}
+
+/* Client side lookup, must not be reached when the staple is used */
+static int test_ocsp_client_io_cb(void* ctx, const char* url, int urlSz,
+                                  unsigned char* req, int reqSz,
+                                  unsigned char** resp)
+{
+    (void)url;
+    (void)urlSz;
+    (void)req;
+    (void)reqSz;
+    (void)resp;
+
+    (*(int*)ctx)++;
+    return -1;
+}
+
+/* Number of certificates the staple manager of ctx keeps staples for */
+static int test_ocsp_staple_entries(WOLFSSL_CTX* ctx)
+{
+    OcspStapleEntry* entry;
+    int              cnt = 0;
+
+    for (entry = ctx->cm->ocsp_stapling->stapleMgr->entries; entry != NULL;
+                                                          entry = entry->next)
+        cnt++;
+
+    return cnt;
+}
+#endif
+
+static void test_wolfSSL_CTX_EnableOCSPStapleRefresh(void)
+{
+#if defined(WOLFSSL_OCSP_STAPLE_MGR) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX* ctx_c;
+    WOLFSSL_CTX* ctx_s;
+    WOLFSSL*     ssl_c;
+    WOLFSSL*     ssl_s;
+    int          clientCalls = 0;
+    int          i;
+    const char*  ocspRoot  = "./certs/ocsp/root-ca-cert.pem";
+    const char*  ocspInter = "./certs/ocsp/intermediate1-ca-cert.pem";
+    method_provider methods_c[] = {
+    #ifndef WOLFSSL_NO_TLS12
+        wolfTLSv1_2_client_method,
+    #endif
+    #ifdef WOLFSSL_TLS13
+        wolfTLSv1_3_client_method,
+    #endif
+    };
+    method_provider methods_s[] = {
+    #ifndef WOLFSSL_NO_TLS12
+        wolfTLSv1_2_server_method,
+    #endif
+    #ifdef WOLFSSL_TLS13
+        wolfTLSv1_3_server_method,
+    #endif
+    };
+    int m;
+
+    printf(testingFmt, "wolfSSL_CTX_EnableOCSPStapleRefresh()");
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+
+    AssertIntEQ(wolfSSL_CTX_EnableOCSPStapleRefresh(NULL), BAD_FUNC_ARG);
+
+    for (m = 0; m < (int)(sizeof(methods_c) / sizeof(*methods_c)); m++) {
+        test_ocsp_staple_calls = 0;
+        test_ocsp_staple_fail = 0;
+        clientCalls = 0;
+
+        AssertNotNull(ctx_s = wolfSSL_CTX_new(methods_s[m]()));
+        wolfSSL_SetIORecv(ctx_s, test_memio_read_cb);
+        wolfSSL_SetIOSend(ctx_s, test_memio_write_cb);
+        AssertIntEQ(wolfSSL_CTX_load_verify_locations(ctx_s, ocspRoot, 0),
+                                                              WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_load_verify_locations(ctx_s, ocspInter, 0),
+                                                              WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_use_certificate_file(ctx_s,
+                "./certs/ocsp/server1-cert.pem", WOLFSSL_FILETYPE_PEM),
+                                                              WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_use_PrivateKey_file(ctx_s,
+                "./certs/ocsp/server1-key.pem", WOLFSSL_FILETYPE_PEM),
+                                                              WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_EnableOCSPStapling(ctx_s), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_SetOCSP_Cb(ctx_s, test_ocsp_staple_io_cb,
+                              test_ocsp_staple_free_cb, NULL), WOLFSSL_SUCCESS);
+
+        /* first staple fetched before any connection is accepted */
+        AssertIntEQ(wolfSSL_CTX_EnableOCSPStapleRefresh(ctx_s),
+                                                              WOLFSSL_SUCCESS);
+        AssertIntEQ(test_ocsp_staple_calls, 1);
+
+        AssertNotNull(ctx_c = wolfSSL_CTX_new(methods_c[m]()));
+        wolfSSL_SetIORecv(ctx_c, test_memio_read_cb);
+        wolfSSL_SetIOSend(ctx_c, test_memio_write_cb);
+        AssertIntEQ(wolfSSL_CTX_load_verify_locations(ctx_c, ocspRoot, 0),
+                                                              WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_load_verify_locations(ctx_c, ocspInter, 0),
+                                                              WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_EnableOCSPStapling(ctx_c), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_CTX_SetOCSP_Cb(ctx_c, test_ocsp_client_io_cb,
+                                        NULL, &clientCalls), WOLFSSL_SUCCESS);
+
+        /* every handshake is served the shared staple without a lookup */
+        for (i = 0; i < 3; i++) {
+            AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                                         &ssl_s, NULL, NULL), 0);
+            AssertIntEQ(wolfSSL_UseOCSPStapling(ssl_c, WOLFSSL_CSR_OCSP, 0),
+                                                              WOLFSSL_SUCCESS);
+            AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+            wolfSSL_free(ssl_c);
+            wolfSSL_free(ssl_s);
+        }
+        AssertIntEQ(test_ocsp_staple_calls, 1);
+        AssertIntEQ(clientCalls, 0);
+
+        /* responder outage does not reach the handshake */
+        test_ocsp_staple_fail = 1;
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+                                     &ssl_s, NULL, NULL), 0);
+        AssertIntEQ(wolfSSL_UseOCSPStapling(ssl_c, WOLFSSL_CSR_OCSP, 0),
+                                                              WOLFSSL_SUCCESS);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        AssertIntEQ(test_ocsp_staple_calls, 1);
+        AssertIntEQ(clientCalls, 0);
+
+        /* enabling again replaces the certificate's entry */
+        test_ocsp_staple_fail = 0;
+        AssertIntEQ(wolfSSL_CTX_EnableOCSPStapleRefresh(ctx_s),
+                                                              WOLFSSL_SUCCESS);
+        AssertIntEQ(test_ocsp_staple_calls, 2);
+        AssertIntEQ(test_ocsp_staple_entries(ctx_s), 1);
+
+        /* staple of the previous certificate is not sent after a reload */
+        AssertIntEQ(wolfSSL_CTX_use_certificate_file(ctx_s,
+                "./certs/ocsp/server1-cert.pem", WOLFSSL_FILETYPE_PEM),
+                                                              WOLFSSL_SUCCESS);
+        AssertNull(ctx_s->certStaple);
+        AssertIntEQ(test_ocsp_staple_entries(ctx_s), 0);
+        AssertIntEQ(wolfSSL_CTX_EnableOCSPStapleRefresh(ctx_s),
+                                                              WOLFSSL_SUCCESS);
+        AssertIntEQ(test_ocsp_staple_entries(ctx_s), 1);
+
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+    }
+
+    printf(resultFmt, passed);
+#endif
+}
+
+#if defined(WOLFSSL_LAZY_HS_HASH) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+#if defined(OPENSSL_EXTRA) && !defined(NO_RSA) && !defined(NO_FILESYSTEM)
+/* client certificate loaded only when the CertificateRequest is seen */
+static int test_lazy_hs_hash_client_cert_cb(WOLFSSL* ssl, WOLFSSL_X509** x509,
+    WOLFSSL_EVP_PKEY** pkey)
+{
+    const unsigned char* key = client_key_der_2048;
+
+    (void)ssl;
+    *x509 = wolfSSL_X509_load_certificate_file(cliCertFile,
+                                                         WOLFSSL_FILETYPE_PEM);
+    *pkey = wolfSSL_d2i_PrivateKey(EVP_PKEY_RSA, NULL, &key,
+                                          (long)sizeof_client_key_der_2048);
+    return (*x509 != NULL && *pkey != NULL) ? 1 : 0;
+}
+#endif
+
+/* Handshake with the cipher list and client auth setting, 0 on success.
+ * clientAuth of 2 gives the client certificate from the client cert
+ * callback. */
+static int test_lazy_hs_hash_connect(method_provider method_c,
+    method_provider method_s, const char* cipherList, int clientAuth,
+    int forceHrr)
+{
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL_CTX* ctx_s = NULL;
+    WOLFSSL*     ssl_c = NULL;
+    WOLFSSL*     ssl_s = NULL;
+    int          ret;
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+
+    if (clientAuth != 1) {
+        /* no client certificate means no CertificateVerify */
+        AssertNotNull(ctx_c = wolfSSL_CTX_new(method_c()));
+        wolfSSL_SetIORecv(ctx_c, test_memio_read_cb);
+        wolfSSL_SetIOSend(ctx_c, test_memio_write_cb);
+        AssertIntEQ(wolfSSL_CTX_load_verify_locations(ctx_c, caCertFile, 0),
+                                                              WOLFSSL_SUCCESS);
+    }
+#if defined(OPENSSL_EXTRA) && !defined(NO_RSA) && !defined(NO_FILESYSTEM)
+    if (clientAuth == 2) {
+        wolfSSL_CTX_set_client_cert_cb(ctx_c,
+                                             test_lazy_hs_hash_client_cert_cb);
+    }
+#endif
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                                 method_c, method_s), 0);
+    if (cipherList != NULL) {
+        AssertIntEQ(wolfSSL_set_cipher_list(ssl_c, cipherList),
+                                                              WOLFSSL_SUCCESS);
+    }
+    if (clientAuth) {
+        wolfSSL_set_verify(ssl_s, WOLFSSL_VERIFY_PEER |
+                                    WOLFSSL_VERIFY_FAIL_IF_NO_PEER_CERT, NULL);
+    }
+#ifdef WOLFSSL_TLS13
+    if (forceHrr) {
+        AssertIntEQ(wolfSSL_NoKeyShares(ssl_c), WOLFSSL_SUCCESS);
+    }
+#endif
+    (void)forceHrr;
+
+    ret = test_memio_do_handshake(ssl_c, ssl_s, 10, NULL);
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+
+    return ret;
+}
+#endif
+
+static void test_wolfSSL_lazy_handshake_hash(void)
+{
+#if defined(WOLFSSL_LAZY_HS_HASH) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    printf(testingFmt, "lazy handshake hash");
+
+#ifndef WOLFSSL_NO_TLS12
+    /* PRF hash only, then every hash for CertificateVerify */
+    #if defined(HAVE_ECC) && defined(HAVE_AESGCM) && defined(WOLFSSL_SHA384)
+    AssertIntEQ(test_lazy_hs_hash_connect(wolfTLSv1_2_client_method,
+        wolfTLSv1_2_server_method, "ECDHE-RSA-AES256-GCM-SHA384", 0, 0), 0);
+    AssertIntEQ(test_lazy_hs_hash_connect(wolfTLSv1_2_client_method,
+        wolfTLSv1_2_server_method, "ECDHE-RSA-AES256-GCM-SHA384", 1, 0), 0);
+    #if defined(OPENSSL_EXTRA) && !defined(NO_RSA) && !defined(NO_FILESYSTEM)
+    AssertIntEQ(test_lazy_hs_hash_connect(wolfTLSv1_2_client_method,
+        wolfTLSv1_2_server_method, "ECDHE-RSA-AES256-GCM-SHA384", 2, 0), 0);
+    #endif
+    #endif
+    #if defined(HAVE_ECC) && defined(HAVE_AESGCM)
+    AssertIntEQ(test_lazy_hs_hash_connect(wolfTLSv1_2_client_method,
+        wolfTLSv1_2_server_method, "ECDHE-RSA-AES128-GCM-SHA256", 0, 0), 0);
+    AssertIntEQ(test_lazy_hs_hash_connect(wolfTLSv1_2_client_method,
+        wolfTLSv1_2_server_method, "ECDHE-RSA-AES128-GCM-SHA256", 1, 0), 0);
+    #endif
+    /* version downgrade picks the hashes after the ServerHello */
+    AssertIntEQ(test_lazy_hs_hash_connect(wolfSSLv23_client_method,
+        wolfTLSv1_2_server_method, NULL, 1, 0), 0);
+#endif
+#if !defined(NO_OLD_TLS) && !defined(NO_MD5) && !defined(NO_SHA)
+    AssertIntEQ(test_lazy_hs_hash_connect(wolfTLSv1_1_client_method,
+        wolfTLSv1_1_server_method, NULL, 1, 0), 0);
+#endif
+#ifdef WOLFSSL_TLS13
+    #if defined(HAVE_AESGCM) && defined(WOLFSSL_SHA384)
+    AssertIntEQ(test_lazy_hs_hash_connect(wolfTLSv1_3_client_method,
+        wolfTLSv1_3_server_method, "TLS13-AES256-GCM-SHA384", 1, 0), 0);
+    #endif
+    /* HelloRetryRequest restarts the transcript before the hash is picked */
+    AssertIntEQ(test_lazy_hs_hash_connect(wolfTLSv1_3_client_method,
+        wolfTLSv1_3_server_method, NULL, 0, 1), 0);
+#endif
+
+    printf(resultFmt, passed);
+#endif
+}
+
+#if defined(WOLFSSL_CERT_MSG_CACHE) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && \
+    !defined(WOLFSSL_NO_TLS12)
+/* Run the server's first TLS v1.2 flight and copy out the Certificate
+ * handshake message. When sslChain is set the server's WOLFSSL object loads
+ * its own chain so the message is built by the encoder.
+ * returns the message size or -1 on failure */
+static int test_cert_msg_capture(WOLFSSL_CTX* ctx_s, int sslChain, byte* msg,
+                                 int msgSz)
+{
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL*     ssl_c = NULL;
+    WOLFSSL*     ssl_s = NULL;
+    int          idx = 0;
+    int          ret = -1;
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfTLSv1_2_client_method, wolfTLSv1_2_server_method), 0);
+    if (sslChain) {
+        AssertIntEQ(wolfSSL_use_certificate_chain_file(ssl_s,
+                   "./certs/intermediate/server-chain.pem"), WOLFSSL_SUCCESS);
+    }
+
+    AssertIntNE(wolfSSL_connect(ssl_c), WOLFSSL_SUCCESS);
+    AssertIntNE(wolfSSL_accept(ssl_s), WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_get_error(ssl_s, WOLFSSL_FATAL_ERROR),
+                                                     WOLFSSL_ERROR_WANT_READ);
+
+    /* walk the plaintext handshake records for the Certificate message */
+    while (ret < 0 && idx + RECORD_HEADER_SZ <= test_ctx.c_len) {
+        byte* rec = test_ctx.c_buff + idx;
+        int   recSz = (rec[3] << 8) | rec[4];
+        int   i = RECORD_HEADER_SZ;
+
+        AssertIntEQ(rec[0], handshake);
+        AssertIntLE(idx + RECORD_HEADER_SZ + recSz, test_ctx.c_len);
+        while (i + HANDSHAKE_HEADER_SZ <= RECORD_HEADER_SZ + recSz) {
+            int hsSz = (rec[i + 1] << 16) | (rec[i + 2] << 8) | rec[i + 3];
+
+            hsSz += HANDSHAKE_HEADER_SZ;
+            if (rec[i] == certificate) {
+                AssertIntLE(i + hsSz, RECORD_HEADER_SZ + recSz);
+                AssertIntLE(hsSz, msgSz);
+                XMEMCPY(msg, rec + i, hsSz);
+                ret = hsSz;
+                break;
+            }
+            i += hsSz;
+        }
+        idx += RECORD_HEADER_SZ + recSz;
+    }
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    wolfSSL_CTX_free(ctx_c);
+
+    return ret;
+}
+#endif
+
+static void test_wolfSSL_CTX_CertMsgCache(void)
+{
+#if defined(WOLFSSL_CERT_MSG_CACHE) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL_CTX* ctx_s = NULL;
+    WOLFSSL*     ssl_c = NULL;
+    WOLFSSL*     ssl_s = NULL;
+    const char*  chainFile = "./certs/intermediate/server-chain.pem";
+#ifndef WOLFSSL_NO_TLS12
+    byte         cached[4096];
+    byte         built[4096];
+    int          cachedSz;
+    int          builtSz;
+#endif
+
+    printf(testingFmt, "wolfSSL_CTX_CertMsgCache()");
+
+#ifndef WOLFSSL_NO_TLS12
+    AssertNotNull(ctx_s = wolfSSL_CTX_new(wolfTLSv1_2_server_method()));
+    wolfSSL_SetIORecv(ctx_s, test_memio_read_cb);
+    wolfSSL_SetIOSend(ctx_s, test_memio_write_cb);
+    AssertIntEQ(wolfSSL_CTX_use_certificate_chain_file(ctx_s, chainFile),
+                                                              WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_file(ctx_s, svrKeyFile,
+                                       WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+    AssertNotNull(ctx_s->certMsg);
+
+    /* message from the CTX's encoding matches the encoder's */
+    cachedSz = test_cert_msg_capture(ctx_s, 0, cached, sizeof(cached));
+    builtSz = test_cert_msg_capture(ctx_s, 1, built, sizeof(built));
+    AssertIntGT(cachedSz, HANDSHAKE_HEADER_SZ);
+    AssertIntEQ(cachedSz, builtSz);
+    AssertIntEQ(XMEMCMP(cached, built, cachedSz), 0);
+    AssertIntEQ(cachedSz, HANDSHAKE_HEADER_SZ + ctx_s->certMsg->length);
+    AssertIntEQ(XMEMCMP(cached + HANDSHAKE_HEADER_SZ, ctx_s->certMsg->buffer,
+                        ctx_s->certMsg->length), 0);
+
+    #ifdef WOLFSSL_TLS13
+    {
+        /* TLS v1.3 body is the same list with a request context and empty
+         * extensions after each certificate */
+        byte*  p = cached + HANDSHAKE_HEADER_SZ;
+        word32 listSz = (p[0] << 16) | (p[1] << 8) | p[2];
+        word32 i = CERT_HEADER_SZ;
+        word32 j;
+        word32 certSz;
+        int    cnt = 0;
+        byte*  m;
+
+        AssertNotNull(ctx_s->certMsg13);
+        m = ctx_s->certMsg13->buffer;
+        AssertIntEQ(m[0], 0);
+        j = OPAQUE8_LEN + CERT_HEADER_SZ;
+        while (i < CERT_HEADER_SZ + listSz) {
+            certSz = CERT_HEADER_SZ +
+                              ((p[i] << 16) | (p[i + 1] << 8) | p[i + 2]);
+            AssertIntEQ(XMEMCMP(m + j, p + i, certSz), 0);
+            j += certSz;
+            AssertIntEQ(m[j], 0);
+            AssertIntEQ(m[j + 1], 0);
+            j += OPAQUE16_LEN;
+            i += certSz;
+            cnt++;
+        }
+        AssertIntEQ(cnt, 2);
+        AssertIntEQ(j, ctx_s->certMsg13->length);
+        AssertIntEQ((m[1] << 16) | (m[2] << 8) | m[3],
+                    j - OPAQUE8_LEN - CERT_HEADER_SZ);
+    }
+    #endif
+
+    /* replacing the certificate re-encodes */
+    AssertIntEQ(wolfSSL_CTX_use_certificate_file(ctx_s, svrCertFile,
+                                       WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+    AssertNotNull(ctx_s->certMsg);
+    AssertIntEQ(ctx_s->certMsg->length, 2 * CERT_HEADER_SZ +
+                ctx_s->certificate->length + ctx_s->certChain->length);
+
+    /* replacing the chain re-encodes */
+    AssertIntEQ(wolfSSL_CTX_use_certificate_chain_file(ctx_s, chainFile),
+                                                              WOLFSSL_SUCCESS);
+    AssertNotNull(ctx_s->certMsg);
+    AssertIntEQ(ctx_s->certMsg->length, 2 * CERT_HEADER_SZ +
+                ctx_s->certificate->length + ctx_s->certChain->length);
+    AssertIntEQ(test_cert_msg_capture(ctx_s, 0, cached, sizeof(cached)),
+                cachedSz);
+    wolfSSL_CTX_free(ctx_s);
+    ctx_s = NULL;
+#endif
+
+#ifdef WOLFSSL_TLS13
+    /* client verifies the chain sent from the encoding */
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    AssertNotNull(ctx_s = wolfSSL_CTX_new(wolfTLSv1_3_server_method()));
+    wolfSSL_SetIORecv(ctx_s, test_memio_read_cb);
+    wolfSSL_SetIOSend(ctx_s, test_memio_write_cb);
+    AssertIntEQ(wolfSSL_CTX_use_certificate_chain_file(ctx_s, chainFile),
+                                                              WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_file(ctx_s, svrKeyFile,
+                                       WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+    AssertNotNull(ctx_s->certMsg13);
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+    wolfSSL_set_verify(ssl_c, WOLFSSL_VERIFY_PEER, NULL);
+    AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+#endif
+    (void)test_ctx;
+    (void)ctx_c;
+    (void)ssl_c;
+    (void)ssl_s;
+
+    printf(resultFmt, passed);
+#endif
+}
+
+#if defined(HAVE_CERT_COMPRESSION) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && \
+    defined(HAVE_LIBZ)
+static int test_cert_decompress_fail(const unsigned char* in,
+        unsigned int inSz, unsigned char* out, unsigned int outSz)
+{
+    (void)in;
+    (void)inSz;
+    (void)out;
+    (void)outSz;
+    return -1;
+}
+
+/* TLS v1.3 handshake against ctx_s. The client offers zlib when offer is set
+ * and decompresses with decompress (NULL for the built-in).
+ * returns the size of the server's first flight */
+static int test_cert_compress_hs(WOLFSSL_CTX* ctx_s, int offer,
+                                 CallbackCertDecompress decompress)
+{
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL*     ssl_c = NULL;
+    WOLFSSL*     ssl_s = NULL;
+    int          flightSz;
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+    if (offer) {
+        AssertIntEQ(wolfSSL_CTX_UseCertCompression(ctx_c,
+                    WOLFSSL_CERT_COMPRESS_ZLIB, NULL, decompress),
+                    WOLFSSL_SUCCESS);
+    }
+    wolfSSL_set_verify(ssl_c, WOLFSSL_VERIFY_PEER, NULL);
+
+    AssertIntNE(wolfSSL_connect(ssl_c), WOLFSSL_SUCCESS);
+    AssertIntNE(wolfSSL_accept(ssl_s), WOLFSSL_SUCCESS);
+    flightSz = test_ctx.c_len;
+
+    if (decompress == NULL) {
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    }
+    else {
+        AssertIntNE(wolfSSL_connect(ssl_c), WOLFSSL_SUCCESS);
+        AssertIntEQ(wolfSSL_get_error(ssl_c, WOLFSSL_FATAL_ERROR),
+                                                            CERT_DECOMPRESS_E);
+    }
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    wolfSSL_CTX_free(ctx_c);
+
+    return flightSz;
+}
+#endif
+
+static void test_wolfSSL_CTX_UseCertCompression(void)
+{
+#if defined(HAVE_CERT_COMPRESSION) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    WOLFSSL_CTX* ctx_s;
+#ifdef HAVE_LIBZ
+    int          plainSz;
+    int          compSz;
+#endif
+
+    printf(testingFmt, "wolfSSL_CTX_UseCertCompression()");
+
+    AssertNotNull(ctx_s = wolfSSL_CTX_new(wolfTLSv1_3_server_method()));
+    wolfSSL_SetIORecv(ctx_s, test_memio_read_cb);
+    wolfSSL_SetIOSend(ctx_s, test_memio_write_cb);
+
+    /* bad args */
+    AssertIntEQ(wolfSSL_CTX_UseCertCompression(NULL,
+                WOLFSSL_CERT_COMPRESS_ZLIB, NULL, NULL), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_UseCertCompression(ctx_s, 0, NULL, NULL),
+                                                                BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_UseCertCompression(ctx_s,
+                WOLFSSL_CERT_COMPRESS_BROTLI, NULL, NULL), BAD_FUNC_ARG);
+
+#ifdef HAVE_LIBZ
+    /* registered before the certificate is loaded - compressed on load */
+    AssertIntEQ(wolfSSL_CTX_UseCertCompression(ctx_s,
+                WOLFSSL_CERT_COMPRESS_ZLIB, NULL, NULL), WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_CTX_use_certificate_chain_file(ctx_s,
+               "./certs/intermediate/server-chain.pem"), WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_file(ctx_s, svrKeyFile,
+                                       WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+    AssertIntEQ(ctx_s->certCompressCnt, 1);
+    AssertNotNull(ctx_s->certCompress[0].msg);
+    AssertIntLT(ctx_s->certCompress[0].msg->length, ctx_s->certMsg13->length);
+
+    /* client not offering gets the plain Certificate message */
+    plainSz = test_cert_compress_hs(ctx_s, 0, NULL);
+    compSz = test_cert_compress_hs(ctx_s, 1, NULL);
+    AssertIntLT(compSz, plainSz);
+    AssertIntLE(compSz + (int)(ctx_s->certMsg13->length -
+                ctx_s->certCompress[0].msg->length) - HANDSHAKE_HEADER_SZ,
+                plainSz);
+
+    /* decompression failure is fatal */
+    test_cert_compress_hs(ctx_s, 1, test_cert_decompress_fail);
+#endif
+
+    wolfSSL_CTX_free(ctx_s);
+
+    printf(resultFmt, passed);
+#endif
+}
+
+#if defined(WOLFSSL_EARLY_DATA_ANTI_REPLAY) && \
+    defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && defined(HAVE_CHACHA) && \
+    defined(HAVE_POLY1305)
+/* Server reads early data from the ClientHello flight in test_ctx.
+ * returns the number of early data bytes accepted */
+static int test_anti_replay_read(WOLFSSL_CTX* ctx_s, const byte* flight,
+                                 int flightSz)
+{
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL*     ssl_c = NULL;
+    WOLFSSL*     ssl_s = NULL;
+    char         buf[64];
+    int          outSz = 0;
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+    XMEMCPY(test_ctx.s_buff, flight, flightSz);
+    test_ctx.s_len = flightSz;
+
+    wolfSSL_read_early_data(ssl_s, buf, sizeof(buf), &outSz);
+    AssertIntEQ(test_ctx.s_len, 0);
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    wolfSSL_CTX_free(ctx_c);
+
+    return outSz;
+}
+#endif
+
+static void test_wolfSSL_CTX_AntiReplay(void)
+{
+#if defined(WOLFSSL_EARLY_DATA_ANTI_REPLAY) && \
+    defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && defined(HAVE_CHACHA) && \
+    defined(HAVE_POLY1305)
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL_CTX* ctx_s = NULL;
+    WOLFSSL*     ssl_c = NULL;
+    WOLFSSL*     ssl_s = NULL;
+    WOLFSSL*     ssl_c2;
+    WOLFSSL_SESSION* sess;
+    const char   msg[] = "early data";
+    char         buf[64];
+    byte         flight[4096];
+    int          flightSz;
+    int          outSz;
+    int          mode;
+    unsigned int checks, replays, rejects, memSz;
+
+    printf(testingFmt, "wolfSSL_CTX_EnableAntiReplay()");
+
+    TicketInit();
+
+    AssertNotNull(ctx_c = wolfSSL_CTX_new(wolfTLSv1_3_client_method()));
+    AssertIntEQ(wolfSSL_CTX_EnableAntiReplay(NULL, 0, 0,
+                          WOLFSSL_ANTI_REPLAY_EXACT), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_EnableAntiReplay(ctx_c, 0, 0,
+                          WOLFSSL_ANTI_REPLAY_EXACT), SIDE_ERROR);
+    wolfSSL_CTX_free(ctx_c);
+    ctx_c = NULL;
+
+    for (mode = WOLFSSL_ANTI_REPLAY_EXACT; mode <= WOLFSSL_ANTI_REPLAY_BLOOM;
+                                                                      mode++) {
+        /* full handshake for a ticket */
+        XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c,
+            &ssl_s, wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+        AssertIntEQ(wolfSSL_CTX_GetAntiReplayStats(ctx_s, NULL, NULL, NULL,
+                                                         NULL), BAD_FUNC_ARG);
+        AssertIntEQ(wolfSSL_CTX_EnableAntiReplay(ctx_s, 0, 0, 2),
+                                                                BAD_FUNC_ARG);
+        AssertIntEQ(wolfSSL_CTX_EnableAntiReplay(ctx_s, 0, 0, mode), 0);
+        wolfSSL_CTX_set_TicketEncCb(ctx_s, myTicketEncCb);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+        AssertIntEQ(wolfSSL_read(ssl_c, buf, sizeof(buf)),
+                                                          WOLFSSL_FATAL_ERROR);
+        AssertNotNull(sess = wolfSSL_get_session(ssl_c));
+
+        /* resume with early data and keep the client's first flight */
+        AssertNotNull(ssl_c2 = wolfSSL_new(ctx_c));
+        wolfSSL_SetIOReadCtx(ssl_c2, &test_ctx);
+        wolfSSL_SetIOWriteCtx(ssl_c2, &test_ctx);
+        AssertIntEQ(wolfSSL_set_session(ssl_c2, sess), WOLFSSL_SUCCESS);
+        test_ctx.s_len = 0;
+        test_ctx.c_len = 0;
+        AssertIntEQ(wolfSSL_write_early_data(ssl_c2, msg, sizeof(msg), &outSz),
+                                                                 sizeof(msg));
+        flightSz = test_ctx.s_len;
+        AssertIntLE(flightSz, sizeof(flight));
+        XMEMCPY(flight, test_ctx.s_buff, flightSz);
+        wolfSSL_free(ssl_c2);
+
+        /* first use accepted, replay of the same ClientHello rejected */
+        AssertIntEQ(test_anti_replay_read(ctx_s, flight, flightSz),
+                                                                 sizeof(msg));
+        AssertIntEQ(test_anti_replay_read(ctx_s, flight, flightSz), 0);
+
+        AssertIntEQ(wolfSSL_CTX_GetAntiReplayStats(ctx_s, &checks, &replays,
+                                                      &rejects, &memSz), 0);
+        AssertIntEQ(checks, 2);
+        AssertIntEQ(replays, 1);
+        AssertIntEQ(rejects, 0);
+        AssertIntGT(memSz, 0);
+
+        /* without the cache the replay is accepted */
+        AssertIntEQ(wolfSSL_CTX_DisableAntiReplay(ctx_s), 0);
+        AssertIntEQ(test_anti_replay_read(ctx_s, flight, flightSz),
+                                                                 sizeof(msg));
+
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+        wolfSSL_CTX_free(ctx_c);
+        wolfSSL_CTX_free(ctx_s);
+        ctx_c = NULL;
+        ctx_s = NULL;
+    }
+
+    TicketCleanup();
+
+    printf(resultFmt, passed);
+#endif
+}
+
+#if defined(WOLFSSL_HALF_RTT_DATA) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+static int test_half_rtt_writes = 0;
+static int test_half_rtt_block = 0;
+
+/* Count the server's writes to the transport, blocking once when asked */
+static int test_half_rtt_write_cb(WOLFSSL* ssl, char* data, int sz, void* ctx)
+{
+    if (test_half_rtt_block) {
+        test_half_rtt_block = 0;
+        return WOLFSSL_CBIO_ERR_WANT_WRITE;
+    }
+    test_half_rtt_writes++;
+    return test_memio_write_cb(ssl, data, sz, ctx);
+}
+#endif
+
+static void test_wolfSSL_write_half_rtt_data(void)
+{
+#if defined(WOLFSSL_HALF_RTT_DATA) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL_CTX* ctx_s = NULL;
+    WOLFSSL*     ssl_c = NULL;
+    WOLFSSL*     ssl_s = NULL;
+    const char   msg[] = "server greeting";
+    char         buf[64];
+    int          outSz = 0;
+
+    printf(testingFmt, "wolfSSL_write_half_rtt_data()");
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+    /* new server object that counts its writes */
+    wolfSSL_free(ssl_s);
+    wolfSSL_SetIOSend(ctx_s, test_half_rtt_write_cb);
+    AssertNotNull(ssl_s = wolfSSL_new(ctx_s));
+    wolfSSL_SetIOReadCtx(ssl_s, &test_ctx);
+    wolfSSL_SetIOWriteCtx(ssl_s, &test_ctx);
+
+    AssertIntEQ(wolfSSL_write_half_rtt_data(NULL, msg, sizeof(msg), &outSz),
+                                                                 BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_write_half_rtt_data(ssl_s, NULL, sizeof(msg), &outSz),
+                                                                 BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_write_half_rtt_data(ssl_s, msg, sizeof(msg), NULL),
+                                                                 BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_write_half_rtt_data(ssl_c, msg, sizeof(msg), &outSz),
+                                                                   SIDE_ERROR);
+
+    /* no ClientHello yet */
+    AssertIntEQ(wolfSSL_write_half_rtt_data(ssl_s, msg, sizeof(msg), &outSz),
+                                                          WOLFSSL_FATAL_ERROR);
+    AssertIntEQ(wolfSSL_get_error(ssl_s, WOLFSSL_FATAL_ERROR),
+                                                      WOLFSSL_ERROR_WANT_READ);
+    AssertIntEQ(wolfSSL_connect(ssl_c), WOLFSSL_FATAL_ERROR);
+
+    /* server's flight and data in one write */
+    test_half_rtt_writes = 0;
+    AssertIntEQ(wolfSSL_write_half_rtt_data(ssl_s, msg, sizeof(msg), &outSz),
+                                                                 sizeof(msg));
+    AssertIntEQ(outSz, sizeof(msg));
+    AssertIntEQ(test_half_rtt_writes, 1);
+    AssertIntEQ(wolfSSL_is_init_finished(ssl_s), 0);
+
+    /* client reads data straight after handshake */
+    AssertIntEQ(wolfSSL_connect(ssl_c), WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_read(ssl_c, buf, sizeof(buf)), sizeof(msg));
+    AssertIntEQ(XMEMCMP(buf, msg, sizeof(msg)), 0);
+    AssertIntEQ(wolfSSL_accept(ssl_s), WOLFSSL_SUCCESS);
+
+    /* after the handshake it is a normal write */
+    AssertIntEQ(wolfSSL_write_half_rtt_data(ssl_s, msg, sizeof(msg), &outSz),
+                                                                 sizeof(msg));
+    AssertIntEQ(wolfSSL_read(ssl_c, buf, sizeof(buf)), sizeof(msg));
+    AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+    AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), sizeof(msg));
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    ssl_c = NULL;
+    ssl_s = NULL;
+
+    /* retry after the write blocks sends the data once */
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+    AssertIntEQ(wolfSSL_connect(ssl_c), WOLFSSL_FATAL_ERROR);
+    test_half_rtt_block = 1;
+    outSz = 0;
+    AssertIntEQ(wolfSSL_write_half_rtt_data(ssl_s, msg, sizeof(msg), &outSz),
+                                                          WOLFSSL_FATAL_ERROR);
+    AssertIntEQ(wolfSSL_get_error(ssl_s, WOLFSSL_FATAL_ERROR),
+                                                     WOLFSSL_ERROR_WANT_WRITE);
+    AssertIntEQ(outSz, 0);
+    AssertIntEQ(wolfSSL_write_half_rtt_data(ssl_s, msg, sizeof(msg), &outSz),
+                                                                 sizeof(msg));
+    AssertIntEQ(outSz, sizeof(msg));
+    AssertIntEQ(wolfSSL_connect(ssl_c), WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_read(ssl_c, buf, sizeof(buf)), sizeof(msg));
+    AssertIntEQ(XMEMCMP(buf, msg, sizeof(msg)), 0);
+    AssertIntEQ(wolfSSL_accept(ssl_s), WOLFSSL_SUCCESS);
+    /* nothing more from the server */
+    AssertIntEQ(wolfSSL_read(ssl_c, buf, sizeof(buf)), WOLFSSL_FATAL_ERROR);
+    AssertIntEQ(wolfSSL_get_error(ssl_c, WOLFSSL_FATAL_ERROR),
+                                                      WOLFSSL_ERROR_WANT_READ);
+    AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+    AssertIntEQ(wolfSSL_read(ssl_s, buf, sizeof(buf)), sizeof(msg));
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+
+    printf(resultFmt, passed);
+#endif
+}
+
+#if defined(WOLFSSL_KEY_SHARE_CACHE) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && \
+    defined(HAVE_ECC) && (defined(HAVE_ALL_CURVES) || \
+    (defined(HAVE_ECC384) && defined(HAVE_ECC521)))
+/* Handshake with the server as the named host.
+ * returns the number of rounds taken */
+static int test_key_share_cache_connect(struct test_memio_ctx* test_ctx,
+    WOLFSSL_CTX* ctx_c, WOLFSSL_CTX* ctx_s, const char* name)
+{
+    WOLFSSL* ssl_c = NULL;
+    WOLFSSL* ssl_s = NULL;
+    int      rounds = 0;
+
+    AssertIntEQ(test_memio_setup(test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+    AssertIntEQ(wolfSSL_UseSNI(ssl_c, WOLFSSL_SNI_HOST_NAME, name,
+                                          (word16)XSTRLEN(name)), WOLFSSL_SUCCESS);
+    AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, &rounds), 0);
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+
+    return rounds;
+}
+#endif
+
+static void test_wolfSSL_CTX_EnableKeyShareCache(void)
+{
+#if defined(WOLFSSL_KEY_SHARE_CACHE) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && \
+    defined(HAVE_ECC) && (defined(HAVE_ALL_CURVES) || \
+    (defined(HAVE_ECC384) && defined(HAVE_ECC521)))
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL_CTX* ctx_a = NULL;
+    WOLFSSL_CTX* ctx_b = NULL;
+    WOLFSSL*     ssl_c = NULL;
+    WOLFSSL*     ssl_s = NULL;
+    int          groups_a[] = { WOLFSSL_ECC_SECP384R1 };
+    int          groups_b[] = { WOLFSSL_ECC_SECP521R1 };
+    unsigned int lookups, hits, hrrs;
+    int          hrrRounds_a, hrrRounds_b;
+    int          i;
+
+    printf(testingFmt, "wolfSSL_CTX_EnableKeyShareCache()");
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_a, &ssl_c, &ssl_s,
+                   wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_b, &ssl_c, &ssl_s,
+                   wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    /* each server only accepts a group the client doesn't send by default */
+    AssertIntEQ(wolfSSL_CTX_set_groups(ctx_a, groups_a, 1), WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_CTX_set_groups(ctx_b, groups_b, 1), WOLFSSL_SUCCESS);
+
+    AssertIntEQ(wolfSSL_CTX_EnableKeyShareCache(NULL, 0), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_EnableKeyShareCache(ctx_a, 0), SIDE_ERROR);
+    AssertIntEQ(wolfSSL_CTX_DisableKeyShareCache(NULL), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_GetKeyShareCacheStats(NULL, &lookups, &hits,
+                                                         &hrrs), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_GetKeyShareCacheStats(ctx_c, &lookups, &hits,
+                                                         &hrrs), BAD_FUNC_ARG);
+
+    /* without the cache every connection needs a HelloRetryRequest */
+    hrrRounds_a = test_key_share_cache_connect(&test_ctx, ctx_c, ctx_a,
+                                               "a.example.com");
+    hrrRounds_b = test_key_share_cache_connect(&test_ctx, ctx_c, ctx_b,
+                                               "b.example.com");
+    for (i = 0; i < 3; i++) {
+        AssertIntEQ(test_key_share_cache_connect(&test_ctx, ctx_c, ctx_a,
+                                            "a.example.com"), hrrRounds_a);
+        AssertIntEQ(test_key_share_cache_connect(&test_ctx, ctx_c, ctx_b,
+                                            "b.example.com"), hrrRounds_b);
+    }
+
+    /* with the cache only the first connection to each server does */
+    AssertIntEQ(wolfSSL_CTX_EnableKeyShareCache(ctx_c, 4), 0);
+    AssertIntEQ(test_key_share_cache_connect(&test_ctx, ctx_c, ctx_a,
+                                            "a.example.com"), hrrRounds_a);
+    AssertIntEQ(test_key_share_cache_connect(&test_ctx, ctx_c, ctx_b,
+                                            "b.example.com"), hrrRounds_b);
+    for (i = 0; i < 3; i++) {
+        AssertIntLT(test_key_share_cache_connect(&test_ctx, ctx_c, ctx_a,
+                                            "a.example.com"), hrrRounds_a);
+        AssertIntLT(test_key_share_cache_connect(&test_ctx, ctx_c, ctx_b,
+                                            "b.example.com"), hrrRounds_b);
+    }
+    AssertIntEQ(wolfSSL_CTX_GetKeyShareCacheStats(ctx_c, &lookups, &hits,
+                                                                   &hrrs), 0);
+    AssertIntEQ(lookups, 8);
+    AssertIntEQ(hits, 6);
+    AssertIntEQ(hrrs, 2);
+
+    /* a server changing its preference is learnt from its retry request */
+    AssertIntEQ(test_key_share_cache_connect(&test_ctx, ctx_c, ctx_b,
+                                            "a.example.com"), hrrRounds_b);
+    AssertIntLT(test_key_share_cache_connect(&test_ctx, ctx_c, ctx_b,
+                                            "a.example.com"), hrrRounds_b);
+
+    AssertIntEQ(wolfSSL_CTX_DisableKeyShareCache(ctx_c), 0);
+    AssertIntEQ(test_key_share_cache_connect(&test_ctx, ctx_c, ctx_a,
+                                            "a.example.com"), hrrRounds_a);
+
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_a);
+    wolfSSL_CTX_free(ctx_b);
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_CTX_UseKeySharePool(void)
+{
+#if defined(WOLFSSL_KEY_SHARE_POOL) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && \
+    defined(HAVE_ECC) && !defined(NO_ECC256)
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL_CTX* ctx_s = NULL;
+    WOLFSSL*     ssl_c = NULL;
+    WOLFSSL*     ssl_s = NULL;
+    unsigned int avail, hits, misses;
+    int          i;
+
+    printf(testingFmt, "wolfSSL_CTX_UseKeySharePool()");
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+
+    AssertIntEQ(wolfSSL_CTX_UseKeySharePool(NULL, WOLFSSL_ECC_SECP256R1, 0),
+                                                                 BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_FillKeySharePool(ctx_c, 0), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_GetKeySharePoolStats(ctx_c, WOLFSSL_ECC_SECP256R1,
+                                       &avail, &hits, &misses), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_UseKeySharePool(ctx_c, 0xFFFF, 0), BAD_FUNC_ARG);
+
+    /* default group of client and so the server's too */
+    AssertIntEQ(wolfSSL_CTX_UseKeySharePool(ctx_c, WOLFSSL_ECC_SECP256R1, 2),
+                                                                            0);
+    AssertIntEQ(wolfSSL_CTX_UseKeySharePool(ctx_s, WOLFSSL_ECC_SECP256R1, 2),
+                                                                            0);
+    AssertIntEQ(wolfSSL_CTX_GetKeySharePoolStats(ctx_c, WOLFSSL_ECC_SECP384R1,
+                                       &avail, &hits, &misses), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_FillKeySharePool(ctx_c, 1), 1);
+    AssertIntEQ(wolfSSL_CTX_FillKeySharePool(ctx_c, 0), 1);
+    AssertIntEQ(wolfSSL_CTX_FillKeySharePool(ctx_c, 0), 0);
+    AssertIntEQ(wolfSSL_CTX_FillKeySharePool(ctx_s, 0), 2);
+
+    /* two handshakes use the pool then key pairs are generated */
+    for (i = 0; i < 3; i++) {
+        AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+        AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+        AssertIntEQ(wolfSSL_write(ssl_c, "ping", 4), 4);
+        AssertIntEQ(wolfSSL_read(ssl_s, &avail, sizeof(avail)), 4);
+        wolfSSL_free(ssl_c);
+        wolfSSL_free(ssl_s);
+    }
+    AssertIntEQ(wolfSSL_CTX_GetKeySharePoolStats(ctx_c, WOLFSSL_ECC_SECP256R1,
+                                                 &avail, &hits, &misses), 0);
+    AssertIntEQ(avail, 0);
+    AssertIntEQ(hits, 2);
+    AssertIntEQ(misses, 1);
+    AssertIntEQ(wolfSSL_CTX_GetKeySharePoolStats(ctx_s, WOLFSSL_ECC_SECP256R1,
+                                                 &avail, &hits, &misses), 0);
+    AssertIntEQ(avail, 0);
+    AssertIntEQ(hits, 2);
+    AssertIntEQ(misses, 1);
+
+    /* unused key pairs are freed with the CTX */
+    AssertIntEQ(wolfSSL_CTX_FillKeySharePool(ctx_s, 0), 2);
+
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_ClientHello_PreParse(void)
+{
+#if defined(WOLFSSL_CH_PREPARSE) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && \
+    defined(HAVE_AESGCM) && defined(WOLFSSL_SHA384)
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL_CTX* ctx_s = NULL;
+    WOLFSSL*     ssl_c = NULL;
+    WOLFSSL*     ssl_s = NULL;
+#ifdef HAVE_SNI
+    byte         name[32];
+    word32       nameSz;
+#endif
+    /* ClientHello with two server_name extensions */
+    const byte   dupSni[] = {
+        0x16, 0x03, 0x01, 0x00, 0x47,
+        0x01, 0x00, 0x00, 0x43,
+        0x03, 0x03,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00,
+        0x00, 0x02, 0x13, 0x01,
+        0x01, 0x00,
+        0x00, 0x18,
+        0x00, 0x00, 0x00, 0x08, 0x00, 0x06, 0x00, 0x00, 0x03, 'a', 'b', 'c',
+        0x00, 0x00, 0x00, 0x08, 0x00, 0x06, 0x00, 0x00, 0x03, 'x', 'y', 'z'
+    };
+
+    printf(testingFmt, "wolfSSL_ClientHello_PreParse()");
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+
+    /* no cipher suite in common - rejected before the extensions are used */
+    AssertIntEQ(wolfSSL_set_cipher_list(ssl_c, "TLS13-AES128-GCM-SHA256"),
+                                                              WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_set_cipher_list(ssl_s, "TLS13-AES256-GCM-SHA384"),
+                                                              WOLFSSL_SUCCESS);
+#ifdef HAVE_SNI
+    AssertIntEQ(wolfSSL_UseSNI(ssl_c, WOLFSSL_SNI_HOST_NAME, "www.abc.com",
+                                                      11), WOLFSSL_SUCCESS);
+#endif
+    AssertIntNE(wolfSSL_connect(ssl_c), WOLFSSL_SUCCESS);
+    AssertIntGT(test_ctx.s_len, 0);
+#ifdef HAVE_SNI
+    /* server name found in the ClientHello by pre-parsing */
+    nameSz = sizeof(name);
+    AssertIntEQ(wolfSSL_SNI_GetFromBuffer(test_ctx.s_buff, test_ctx.s_len,
+                  WOLFSSL_SNI_HOST_NAME, name, &nameSz), WOLFSSL_SUCCESS);
+    AssertIntEQ(nameSz, 11);
+    AssertIntEQ(XMEMCMP(name, "www.abc.com", 11), 0);
+#endif
+    AssertIntNE(wolfSSL_accept(ssl_s), WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_get_error(ssl_s, 0), MATCH_SUITE_ERROR);
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+
+    /* duplicate extensions are rejected by the server's index */
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+    XMEMCPY(test_ctx.s_buff, dupSni, sizeof(dupSni));
+    test_ctx.s_len = (int)sizeof(dupSni);
+    AssertIntNE(wolfSSL_accept(ssl_s), WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_get_error(ssl_s, 0), DUPLICATE_MSG_E);
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    test_ctx.c_len = 0;
+
+    /* server order */
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+    AssertIntEQ(wolfSSL_set_cipher_list(ssl_c,
+                "TLS13-AES256-GCM-SHA384:TLS13-AES128-GCM-SHA256"),
+                                                              WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_set_cipher_list(ssl_s,
+                "TLS13-AES128-GCM-SHA256:TLS13-AES256-GCM-SHA384"),
+                                                              WOLFSSL_SUCCESS);
+    AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    AssertStrEQ(wolfSSL_get_cipher_name(ssl_s), "TLS13-AES128-GCM-SHA256");
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+
+    /* client order */
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+    AssertIntEQ(wolfSSL_set_cipher_list(ssl_c,
+                "TLS13-AES256-GCM-SHA384:TLS13-AES128-GCM-SHA256"),
+                                                              WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_set_cipher_list(ssl_s,
+                "TLS13-AES128-GCM-SHA256:TLS13-AES256-GCM-SHA384"),
+                                                              WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_UseClientSuites(ssl_s), 0);
+    AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    AssertStrEQ(wolfSSL_get_cipher_name(ssl_s), "TLS13-AES256-GCM-SHA384");
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_CTX_SNI_AddCert(void)
+{
+#if defined(WOLFSSL_SNI_CERT_STORE) && defined(HAVE_MEMIO_TESTS_DEPENDENCIES) && \
+    defined(HAVE_ECC) && !defined(NO_ECC256)
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL_CTX* ctx_s = NULL;
+    WOLFSSL*     ssl_c = NULL;
+    WOLFSSL*     ssl_s = NULL;
+    const char*  name;
+
+    printf(testingFmt, "wolfSSL_CTX_SNI_AddCert()");
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfSSLv23_client_method, wolfSSLv23_server_method), 0);
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+
+    AssertIntEQ(wolfSSL_CTX_SNI_AddCert(NULL, "www.example.com",
+                    serv_ecc_der_256, sizeof_serv_ecc_der_256, ecc_key_der_256,
+                    sizeof_ecc_key_der_256, WOLFSSL_FILETYPE_ASN1),
+                                                                 BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_SNI_AddCert(ctx_s, "*example.com",
+                    serv_ecc_der_256, sizeof_serv_ecc_der_256, ecc_key_der_256,
+                    sizeof_ecc_key_der_256, WOLFSSL_FILETYPE_ASN1),
+                                                                 BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_SNI_AddCertFiles(ctx_s, "www.example.com", NULL,
+                    eccKeyFile, WOLFSSL_FILETYPE_PEM), BAD_FUNC_ARG);
+    AssertIntEQ(wolfSSL_CTX_SNI_FindCert(ctx_s, (const byte*)"a", 1), 0);
+    AssertIntEQ(wolfSSL_CTX_SNI_RemoveCert(ctx_s, "a"), 0);
+
+    /* files only read when the name is first used */
+    AssertIntEQ(wolfSSL_CTX_SNI_AddCertFiles(ctx_s, "www.example.com",
+                    eccCertFile, eccKeyFile, WOLFSSL_FILETYPE_PEM),
+                                                              WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_CTX_SNI_AddCertFiles(ctx_s, "missing.example.com",
+                    "./certs/missing.pem", eccKeyFile, WOLFSSL_FILETYPE_PEM),
+                                                              WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_CTX_SNI_AddCert(ctx_s, "*.Wild.Example.com",
+                    serv_ecc_der_256, sizeof_serv_ecc_der_256, ecc_key_der_256,
+                    sizeof_ecc_key_der_256, WOLFSSL_FILETYPE_ASN1),
+                                                              WOLFSSL_SUCCESS);
+
+    name = "WWW.example.COM";
+    AssertIntEQ(wolfSSL_CTX_SNI_FindCert(ctx_s, (const byte*)name,
+                                 (word16)XSTRLEN(name)), WOLFSSL_SUCCESS);
+    name = "host.wild.example.com";
+    AssertIntEQ(wolfSSL_CTX_SNI_FindCert(ctx_s, (const byte*)name,
+                                 (word16)XSTRLEN(name)), WOLFSSL_SUCCESS);
+    /* wildcard matches one label only */
+    name = "a.host.wild.example.com";
+    AssertIntEQ(wolfSSL_CTX_SNI_FindCert(ctx_s, (const byte*)name,
+                                 (word16)XSTRLEN(name)), 0);
+    name = "wild.example.com";
+    AssertIntEQ(wolfSSL_CTX_SNI_FindCert(ctx_s, (const byte*)name,
+                                 (word16)XSTRLEN(name)), 0);
+    name = "example.com";
+    AssertIntEQ(wolfSSL_CTX_SNI_FindCert(ctx_s, (const byte*)name,
+                                 (word16)XSTRLEN(name)), 0);
+
+    /* client only trusts the CA of the certificates in the store */
+    wolfSSL_CTX_free(ctx_c);
+    ctx_c = wolfSSL_CTX_new(wolfSSLv23_client_method());
+    AssertNotNull(ctx_c);
+    wolfSSL_SetIORecv(ctx_c, test_memio_read_cb);
+    wolfSSL_SetIOSend(ctx_c, test_memio_write_cb);
+    AssertIntEQ(wolfSSL_CTX_load_verify_locations(ctx_c, caEccCertFile, 0),
+                                                              WOLFSSL_SUCCESS);
+
+    /* exact name and wildcard */
+    name = "www.example.com";
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfSSLv23_client_method, wolfSSLv23_server_method), 0);
+    AssertIntEQ(wolfSSL_UseSNI(ssl_c, WOLFSSL_SNI_HOST_NAME, name,
+                                 (word16)XSTRLEN(name)), WOLFSSL_SUCCESS);
+    AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    AssertIntEQ(wolfSSL_SNI_Status(ssl_s, WOLFSSL_SNI_HOST_NAME),
+                                                       WOLFSSL_SNI_REAL_MATCH);
+    AssertIntEQ(wolfSSL_SNI_Status(ssl_c, WOLFSSL_SNI_HOST_NAME),
+                                                       WOLFSSL_SNI_REAL_MATCH);
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+
+    /* loaded on first use and kept for the next connection */
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfSSLv23_client_method, wolfSSLv23_server_method), 0);
+    AssertIntEQ(wolfSSL_UseSNI(ssl_c, WOLFSSL_SNI_HOST_NAME, name,
+                                 (word16)XSTRLEN(name)), WOLFSSL_SUCCESS);
+    AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+
+    name = "host.wild.example.com";
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfSSLv23_client_method, wolfSSLv23_server_method), 0);
+    AssertIntEQ(wolfSSL_UseSNI(ssl_c, WOLFSSL_SNI_HOST_NAME, name,
+                                 (word16)XSTRLEN(name)), WOLFSSL_SUCCESS);
+    AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+
+    /* unknown name - CTX's RSA certificate not trusted by client */
+    name = "other.example.com";
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfSSLv23_client_method, wolfSSLv23_server_method), 0);
+    AssertIntEQ(wolfSSL_UseSNI(ssl_c, WOLFSSL_SNI_HOST_NAME, name,
+                                 (word16)XSTRLEN(name)), WOLFSSL_SUCCESS);
+    AssertIntNE(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    AssertIntEQ(wolfSSL_SNI_Status(ssl_s, WOLFSSL_SNI_HOST_NAME),
+                                                         WOLFSSL_SNI_NO_MATCH);
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+
+    /* file that can't be read when first used */
+    name = "missing.example.com";
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfSSLv23_client_method, wolfSSLv23_server_method), 0);
+    AssertIntEQ(wolfSSL_UseSNI(ssl_c, WOLFSSL_SNI_HOST_NAME, name,
+                                 (word16)XSTRLEN(name)), WOLFSSL_SUCCESS);
+    AssertIntNE(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    AssertIntEQ(wolfSSL_get_error(ssl_s, 0), WOLFSSL_BAD_FILE);
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+
+    /* removed while loaded */
+    AssertIntEQ(wolfSSL_CTX_SNI_RemoveCert(ctx_s, "WWW.EXAMPLE.COM"),
+                                                              WOLFSSL_SUCCESS);
+    name = "www.example.com";
+    AssertIntEQ(wolfSSL_CTX_SNI_FindCert(ctx_s, (const byte*)name,
+                                 (word16)XSTRLEN(name)), 0);
+
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+
+    printf(resultFmt, passed);
+#endif
+}
+
+static void test_wolfSSL_Tls13HkdfKeys(void)
+{
+#if defined(WOLFSSL_HMAC_MIDSTATE) && defined(WOLFSSL_TLS13) && \
+    defined(HAVE_MEMIO_TESTS_DEPENDENCIES)
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL_CTX* ctx_s = NULL;
+    WOLFSSL*     ssl_c = NULL;
+    WOLFSSL*     ssl_s = NULL;
+    const char   msg[] = "after key update";
+    char         reply[sizeof(msg)];
+
+    printf(testingFmt, "TLS 1.3 HKDF keyed secrets");
+
+    AssertIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                   wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+    AssertIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    AssertNull(ssl_c->hkdfKeys);
+    AssertNull(ssl_s->hkdfKeys);
+
+    /* secrets derived after the handshake are not cached */
+    AssertIntEQ(wolfSSL_update_keys(ssl_c), WOLFSSL_SUCCESS);
+    AssertIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+    AssertIntEQ(wolfSSL_read(ssl_s, reply, sizeof(reply)), sizeof(msg));
+    AssertIntEQ(XMEMCMP(reply, msg, sizeof(msg)), 0);
+    AssertNull(ssl_c->hkdfKeys);
+    AssertNull(ssl_s->hkdfKeys);
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+
+    printf(resultFmt, passed);
+#endif
+}
+
 /* helper functions */
 #ifdef HAVE_IO_TESTS_DEPENDENCIES
 
@@ -4723,7 +6452,7 @@ static WC_INLINE int PKCS8TestCallBack(char* passwd, int sz, int rw, void* userd
 static void test_wolfSSL_PKCS8(void)
 {
 #if !defined(NO_FILESYSTEM) && !defined(NO_ASN) && defined(HAVE_PKCS8)
-    byte buffer[FOURK_BUF];
+    byte buf[FOURK_BUF];
     byte der[FOURK_BUF];
     #ifndef NO_RSA
         const char serverKeyPkcs8PemFile[] = "./certs/server-keyPkcs8.pem";
@@ -4778,36 +6507,36 @@ static void test_wolfSSL_PKCS8(void)
     /* test loading PEM PKCS8 encrypted file */
     f = XFOPEN(serverKeyPkcs8EncPemFile, "rb");
     AssertTrue((f != XBADFILE));
-    bytes = (int)XFREAD(buffer, 1, sizeof(buffer), f);
+    bytes = (int)XFREAD(buf, 1, sizeof(buf), f);
     XFCLOSE(f);
-    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buffer, bytes,
+    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buf, bytes,
                 WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
 
     /* this next case should fail because of password callback return code */
     flag = 0; /* used by password callback as return code */
-    AssertIntNE(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buffer, bytes,
+    AssertIntNE(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buf, bytes,
                 WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
 
     /* decrypt PKCS8 PEM to key in DER format with not using WOLFSSL_CTX */
-    AssertIntGT(wc_KeyPemToDer(buffer, bytes, der, (word32)sizeof(der),
+    AssertIntGT(wc_KeyPemToDer(buf, bytes, der, (word32)sizeof(der),
         "yassl123"), 0);
 
     /* test that error value is returned with a bad password */
-    AssertIntLT(wc_KeyPemToDer(buffer, bytes, der, (word32)sizeof(der),
+    AssertIntLT(wc_KeyPemToDer(buf, bytes, der, (word32)sizeof(der),
         "bad"), 0);
 
     /* test loading PEM PKCS8 encrypted file */
     f = XFOPEN(serverKeyPkcs8EncDerFile, "rb");
     AssertTrue((f != XBADFILE));
-    bytes = (int)XFREAD(buffer, 1, sizeof(buffer), f);
+    bytes = (int)XFREAD(buf, 1, sizeof(buf), f);
     XFCLOSE(f);
     flag = 1; /* used by password callback as return code */
-    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buffer, bytes,
+    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buf, bytes,
                 WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
 
     /* this next case should fail because of password callback return code */
     flag = 0; /* used by password callback as return code */
-    AssertIntNE(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buffer, bytes,
+    AssertIntNE(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buf, bytes,
                 WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
     #endif /* !NO_RSA */
 
@@ -4815,37 +6544,37 @@ static void test_wolfSSL_PKCS8(void)
     /* test loading PEM PKCS8 encrypted ECC Key file */
     f = XFOPEN(eccPkcs8EncPrivKeyPemFile, "rb");
     AssertTrue((f != XBADFILE));
-    bytes = (int)XFREAD(buffer, 1, sizeof(buffer), f);
+    bytes = (int)XFREAD(buf, 1, sizeof(buf), f);
     XFCLOSE(f);
     flag = 1; /* used by password callback as return code */
-    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buffer, bytes,
+    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buf, bytes,
                 WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
 
     /* this next case should fail because of password callback return code */
     flag = 0; /* used by password callback as return code */
-    AssertIntNE(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buffer, bytes,
+    AssertIntNE(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buf, bytes,
                 WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
 
     /* decrypt PKCS8 PEM to key in DER format with not using WOLFSSL_CTX */
-    AssertIntGT(wc_KeyPemToDer(buffer, bytes, der, (word32)sizeof(der),
+    AssertIntGT(wc_KeyPemToDer(buf, bytes, der, (word32)sizeof(der),
         "yassl123"), 0);
 
     /* test that error value is returned with a bad password */
-    AssertIntLT(wc_KeyPemToDer(buffer, bytes, der, (word32)sizeof(der),
+    AssertIntLT(wc_KeyPemToDer(buf, bytes, der, (word32)sizeof(der),
         "bad"), 0);
 
     /* test loading DER PKCS8 encrypted ECC Key file */
     f = XFOPEN(eccPkcs8EncPrivKeyDerFile, "rb");
     AssertTrue((f != XBADFILE));
-    bytes = (int)XFREAD(buffer, 1, sizeof(buffer), f);
+    bytes = (int)XFREAD(buf, 1, sizeof(buf), f);
     XFCLOSE(f);
     flag = 1; /* used by password callback as return code */
-    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buffer, bytes,
+    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buf, bytes,
                 WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
 
     /* this next case should fail because of password callback return code */
     flag = 0; /* used by password callback as return code */
-    AssertIntNE(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buffer, bytes,
+    AssertIntNE(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buf, bytes,
                 WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
 
     /* leave flag as "okay" */
@@ -4858,32 +6587,32 @@ static void test_wolfSSL_PKCS8(void)
     /* test loading ASN.1 (DER) PKCS8 private key file (not encrypted) */
     f = XFOPEN(serverKeyPkcs8DerFile, "rb");
     AssertTrue((f != XBADFILE));
-    bytes = (int)XFREAD(buffer, 1, sizeof(buffer), f);
+    bytes = (int)XFREAD(buf, 1, sizeof(buf), f);
     XFCLOSE(f);
-    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buffer, bytes,
+    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buf, bytes,
                 WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
 
     /* test loading PEM PKCS8 private key file (not encrypted) */
     f = XFOPEN(serverKeyPkcs8PemFile, "rb");
     AssertTrue((f != XBADFILE));
-    bytes = (int)XFREAD(buffer, 1, sizeof(buffer), f);
+    bytes = (int)XFREAD(buf, 1, sizeof(buf), f);
     XFCLOSE(f);
-    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buffer, bytes,
+    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buf, bytes,
                 WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
 #endif /* !NO_RSA */
 
     /* Test PKCS8 PEM ECC key no crypt */
     f = XFOPEN(eccPkcs8PrivKeyPemFile, "rb");
     AssertTrue((f != XBADFILE));
-    bytes = (int)XFREAD(buffer, 1, sizeof(buffer), f);
+    bytes = (int)XFREAD(buf, 1, sizeof(buf), f);
     XFCLOSE(f);
 #ifdef HAVE_ECC
     /* Test PKCS8 PEM ECC key no crypt */
-    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buffer, bytes,
+    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buf, bytes,
                 WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
 
     /* decrypt PKCS8 PEM to key in DER format */
-    AssertIntGT((bytes = wc_KeyPemToDer(buffer, bytes, der,
+    AssertIntGT((bytes = wc_KeyPemToDer(buf, bytes, der,
         (word32)sizeof(der), NULL)), 0);
     ret = wc_ecc_init(&key);
     if (ret == 0) {
@@ -4895,14 +6624,14 @@ static void test_wolfSSL_PKCS8(void)
     /* Test PKCS8 DER ECC key no crypt */
     f = XFOPEN(eccPkcs8PrivKeyDerFile, "rb");
     AssertTrue((f != XBADFILE));
-    bytes = (int)XFREAD(buffer, 1, sizeof(buffer), f);
+    bytes = (int)XFREAD(buf, 1, sizeof(buf), f);
     XFCLOSE(f);
 
     /* Test using a PKCS8 ECC PEM */
-    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buffer, bytes,
+    AssertIntEQ(wolfSSL_CTX_use_PrivateKey_buffer(ctx, buf, bytes,
                 WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
 #else
-    AssertIntEQ((bytes = wc_KeyPemToDer(buffer, bytes, der,
+    AssertIntEQ((bytes = wc_KeyPemToDer(buf, bytes, der,
         (word32)sizeof(der), NULL)), ASN_NO_PEM_HEADER);
 #endif /* HAVE_ECC */
 
@@ -9155,6 +10884,97 @@ static int test_wc_Sha384HmacFinal (void)
     return flag;
 } /* END test_wc_Sha384HmacFinal */
 
+/*
+ * Testing wc_HmacExportKeyState() and wc_HmacImportKeyState()
+ */
+static int test_wc_HmacKeyState (void)
+{
+    int flag = 0;
+#if !defined(NO_HMAC) && !defined(NO_SHA256) && \
+    defined(WOLFSSL_HMAC_MIDSTATE) && !defined(HAVE_FIPS)
+    Hmac hmac;
+    Hmac imported;
+    HmacKeyState state;
+    byte hash[WC_SHA256_DIGEST_SIZE];
+    byte okm[WC_SHA256_DIGEST_SIZE * 2 + 10];
+    byte okmKeyed[sizeof(okm)];
+    testVector a;
+    int i;
+    const char* key;
+    const char* info = "info";
+
+    key = "\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b\x0b"
+                                                                "\x0b\x0b\x0b";
+    a.input = "Hi There";
+    a.output = "\xb0\x34\x4c\x61\xd8\xdb\x38\x53\x5c\xa8\xaf\xce\xaf\x0b\xf1"
+               "\x2b\x88\x1d\xc2\x00\xc9\x83\x3d\xa7\x26\xe9\x37\x6c\x2e\x32"
+               "\xcf\xf7";
+    a.inLen  = XSTRLEN(a.input);
+    a.outLen = XSTRLEN(a.output);
+
+    printf(testingFmt, "wc_HmacExportKeyState()");
+
+    XMEMSET(&state, 0, sizeof(state));
+    AssertIntEQ(wc_HmacInit(&hmac, NULL, INVALID_DEVID), 0);
+    AssertIntEQ(wc_HmacInit(&imported, NULL, INVALID_DEVID), 0);
+
+    /* Key not set yet. */
+    AssertIntEQ(wc_HmacExportKeyState(&hmac, &state), BAD_FUNC_ARG);
+    AssertIntEQ(wc_HmacImportKeyState(&imported, &state), BAD_FUNC_ARG);
+
+    AssertIntEQ(wc_HmacSetKey(&hmac, WC_SHA256, (byte*)key,
+                                               (word32)XSTRLEN(key)), 0);
+    /* Same key used for consecutive messages. */
+    for (i = 0; i < 2; i++) {
+        AssertIntEQ(wc_HmacUpdate(&hmac, (byte*)a.input, (word32)a.inLen), 0);
+        AssertIntEQ(wc_HmacFinal(&hmac, hash), 0);
+        AssertIntEQ(XMEMCMP(hash, a.output, WC_SHA256_DIGEST_SIZE), 0);
+    }
+
+    AssertIntEQ(wc_HmacExportKeyState(NULL, &state), BAD_FUNC_ARG);
+    AssertIntEQ(wc_HmacExportKeyState(&hmac, NULL), BAD_FUNC_ARG);
+    AssertIntEQ(wc_HmacExportKeyState(&hmac, &state), 0);
+
+    /* Replaces a different key. */
+    AssertIntEQ(wc_HmacSetKey(&imported, WC_SHA256, (byte*)info,
+                                              (word32)XSTRLEN(info)), 0);
+    AssertIntEQ(wc_HmacImportKeyState(NULL, &state), BAD_FUNC_ARG);
+    AssertIntEQ(wc_HmacImportKeyState(&imported, NULL), BAD_FUNC_ARG);
+    AssertIntEQ(wc_HmacImportKeyState(&imported, &state), 0);
+    for (i = 0; i < 2; i++) {
+        XMEMSET(hash, 0, sizeof(hash));
+        AssertIntEQ(wc_HmacUpdate(&imported, (byte*)a.input,
+                                                      (word32)a.inLen), 0);
+        AssertIntEQ(wc_HmacFinal(&imported, hash), 0);
+        AssertIntEQ(XMEMCMP(hash, a.output, WC_SHA256_DIGEST_SIZE), 0);
+    }
+
+#ifdef HAVE_HKDF
+    /* More than one block of output from the same keyed state. */
+    AssertIntEQ(wc_HKDF_Expand(WC_SHA256, (byte*)key, (word32)XSTRLEN(key),
+                   (byte*)info, (word32)XSTRLEN(info), okm, sizeof(okm)), 0);
+    AssertIntEQ(wc_HmacImportKeyState(&imported, &state), 0);
+    AssertIntEQ(wc_HKDF_ExpandKeyed(&imported, (byte*)info,
+                   (word32)XSTRLEN(info), okmKeyed, sizeof(okmKeyed)), 0);
+    AssertIntEQ(XMEMCMP(okm, okmKeyed, sizeof(okm)), 0);
+    AssertIntEQ(wc_HKDF_ExpandKeyed(NULL, (byte*)info,
+                   (word32)XSTRLEN(info), okmKeyed, sizeof(okmKeyed)),
+                BAD_FUNC_ARG);
+#else
+    (void)okm;
+    (void)okmKeyed;
+#endif
+
+    wc_HmacFreeKeyState(&state);
+    wc_HmacFree(&imported);
+    wc_HmacFree(&hmac);
+
+    printf(resultFmt, flag == 0 ? passed : failed);
+
+#endif
+    return flag;
+} /* END test_wc_HmacKeyState */
+
 
 
 /*
@@ -23712,7 +25532,7 @@ static void test_wolfSSL_RSA(void)
 
     AssertNull(RSA_generate_key(-1, 3, NULL, NULL));
     AssertNull(RSA_generate_key(511, 3, NULL, NULL)); /* RSA_MIN_SIZE - 1 */
-    AssertNull(RSA_generate_key(4097, 3, NULL, NULL)); /* RSA_MAX_SIZE + 1 */
+    AssertNull(RSA_generate_key(RSA_MAX_SIZE + 1, 3, NULL, NULL));
     AssertNull(RSA_generate_key(2048, 0, NULL, NULL));
 
     printf(resultFmt, passed);
@@ -28659,6 +30479,19 @@ void ApiTest(void)
     test_wolfSSL_CertManagerLoadCABuffer();
     test_wolfSSL_CertManagerGetCerts();
     test_wolfSSL_CertManagerCRL();
+    test_wolfSSL_CertManagerCRL_monitor();
+    test_wolfSSL_CertManagerVerifyCache();
+    test_wolfSSL_CTX_EnableOCSPStapleRefresh();
+    test_wolfSSL_lazy_handshake_hash();
+    test_wolfSSL_CTX_CertMsgCache();
+    test_wolfSSL_CTX_UseCertCompression();
+    test_wolfSSL_CTX_AntiReplay();
+    test_wolfSSL_write_half_rtt_data();
+    test_wolfSSL_CTX_EnableKeyShareCache();
+    test_wolfSSL_CTX_UseKeySharePool();
+    test_wolfSSL_ClientHello_PreParse();
+    test_wolfSSL_CTX_SNI_AddCert();
+    test_wolfSSL_Tls13HkdfKeys();
     test_wolfSSL_CTX_load_verify_locations_ex();
     test_wolfSSL_CTX_load_verify_buffer_ex();
     test_wolfSSL_CTX_load_verify_chain_buffer_format();
@@ -28974,6 +30807,7 @@ void ApiTest(void)
     AssertFalse(test_wc_Sha384HmacSetKey());
     AssertFalse(test_wc_Sha384HmacUpdate());
     AssertFalse(test_wc_Sha384HmacFinal());
+    AssertFalse(test_wc_HmacKeyState());
 
     AssertIntEQ(test_wc_HashInit(), 0);
 
@@ -0,0 +1,339 @@
+/* client_hello.c
+ *
+ * Copyright (C) 2006-2019 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ */
+
+
+/*
+ClientHello fuzz target.
+
+Each input is a TLS record that is:
+ - searched for a server name with wolfSSL_SNI_GetFromBuffer()
+ - processed by a TLS v1.3 server as the first flight from a client.
+
+Build for libFuzzer with:
+    CFLAGS="-fsanitize=fuzzer-no-link,address" ./configure --enable-tls13 ...
+    clang -fsanitize=fuzzer,address -DWOLFSSL_LIBFUZZER \
+        tests/fuzz/client_hello.c src/.libs/libwolfssl.a -I. -o ch_fuzz
+
+Without WOLFSSL_LIBFUZZER a main is built that runs the files given on the
+command line or, with no arguments, a fixed number of mutations of a
+generated ClientHello.
+*/
+
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+#ifndef WOLFSSL_USER_SETTINGS
+    #include <wolfssl/options.h>
+#endif
+#include <wolfssl/wolfcrypt/settings.h>
+#include <wolfssl/ssl.h>
+
+#undef  USE_CERT_BUFFERS_2048
+#define USE_CERT_BUFFERS_2048
+#include <wolfssl/certs_test.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FUZZ_MAX_INPUT_SZ  (16 * 1024 + 5)
+#define FUZZ_MUTATIONS     20000
+
+int LLVMFuzzerTestOneInput(const unsigned char* data, size_t size);
+
+#if !defined(NO_WOLFSSL_CLIENT) && !defined(NO_WOLFSSL_SERVER) && \
+    !defined(WOLFCRYPT_ONLY) && defined(WOLFSSL_TLS13) && !defined(NO_RSA)
+
+typedef struct {
+    const unsigned char* buf;
+    word32 len;
+    word32 idx;
+} FuzzBuf;
+
+static WOLFSSL_CTX* serverCtx = NULL;
+
+/* server send callback - discard all output */
+static int FuzzSend(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    (void)ssl;
+    (void)buf;
+    (void)ctx;
+
+    return sz;
+}
+
+/* server receive callback - read from fuzz input, then end connection */
+static int FuzzRecv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    FuzzBuf* in = (FuzzBuf*)ctx;
+    (void)ssl;
+
+    if (in->idx == in->len)
+        return WOLFSSL_CBIO_ERR_CONN_CLOSE;
+    if ((word32)sz > in->len - in->idx)
+        sz = (int)(in->len - in->idx);
+    XMEMCPY(buf, in->buf + in->idx, sz);
+    in->idx += sz;
+
+    return sz;
+}
+
+static int FuzzInit(void)
+{
+    if (serverCtx != NULL)
+        return 0;
+
+    wolfSSL_Init();
+    serverCtx = wolfSSL_CTX_new(wolfTLSv1_3_server_method());
+    if (serverCtx == NULL)
+        return -1;
+    wolfSSL_SetIOSend(serverCtx, FuzzSend);
+    wolfSSL_SetIORecv(serverCtx, FuzzRecv);
+    if (wolfSSL_CTX_use_certificate_buffer(serverCtx, server_cert_der_2048,
+            sizeof_server_cert_der_2048, WOLFSSL_FILETYPE_ASN1)
+                                                          != WOLFSSL_SUCCESS ||
+        wolfSSL_CTX_use_PrivateKey_buffer(serverCtx, server_key_der_2048,
+            sizeof_server_key_der_2048, WOLFSSL_FILETYPE_ASN1)
+                                                          != WOLFSSL_SUCCESS) {
+        wolfSSL_CTX_free(serverCtx);
+        serverCtx = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const unsigned char* data, size_t size)
+{
+    WOLFSSL* ssl;
+    FuzzBuf  in;
+#ifdef HAVE_SNI
+    byte     name[256];
+    word32   nameSz = sizeof(name);
+#endif
+
+    if (size > FUZZ_MAX_INPUT_SZ || FuzzInit() != 0)
+        return 0;
+
+#ifdef HAVE_SNI
+    (void)wolfSSL_SNI_GetFromBuffer(data, (word32)size, WOLFSSL_SNI_HOST_NAME,
+        name, &nameSz);
+#endif
+
+    ssl = wolfSSL_new(serverCtx);
+    if (ssl == NULL)
+        return 0;
+    in.buf = data;
+    in.len = (word32)size;
+    in.idx = 0;
+    wolfSSL_SetIOReadCtx(ssl, &in);
+    (void)wolfSSL_accept(ssl);
+    wolfSSL_free(ssl);
+
+    return 0;
+}
+
+#ifndef WOLFSSL_LIBFUZZER
+
+typedef struct {
+    unsigned char buf[FUZZ_MAX_INPUT_SZ];
+    word32 len;
+} SeedBuf;
+
+/* client send callback - keep the ClientHello */
+static int SeedSend(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    SeedBuf* seed = (SeedBuf*)ctx;
+    (void)ssl;
+
+    if (seed->len + sz > sizeof(seed->buf))
+        return WOLFSSL_CBIO_ERR_GENERAL;
+    XMEMCPY(seed->buf + seed->len, buf, sz);
+    seed->len += sz;
+
+    return sz;
+}
+
+/* client receive callback - no reply from server */
+static int SeedRecv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    (void)ssl;
+    (void)buf;
+    (void)sz;
+    (void)ctx;
+
+    return WOLFSSL_CBIO_ERR_WANT_READ;
+}
+
+static int MakeSeed(SeedBuf* seed)
+{
+    WOLFSSL_CTX* ctx;
+    WOLFSSL* ssl = NULL;
+    int ret = -1;
+
+    ctx = wolfSSL_CTX_new(wolfTLSv1_3_client_method());
+    if (ctx == NULL)
+        return -1;
+    wolfSSL_SetIOSend(ctx, SeedSend);
+    wolfSSL_SetIORecv(ctx, SeedRecv);
+    ssl = wolfSSL_new(ctx);
+    if (ssl != NULL) {
+        wolfSSL_SetIOWriteCtx(ssl, seed);
+    #ifdef HAVE_SNI
+        (void)wolfSSL_UseSNI(ssl, WOLFSSL_SNI_HOST_NAME, "www.example.com",
+            15);
+    #endif
+        if (wolfSSL_connect(ssl) != WOLFSSL_SUCCESS && seed->len > 0)
+            ret = 0;
+    }
+
+    wolfSSL_free(ssl);
+    wolfSSL_CTX_free(ctx);
+    return ret;
+}
+
+/* Deterministic pseudo-random numbers so that failures can be reproduced. */
+static word32 NextRand(word32* state)
+{
+    word32 x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return x;
+}
+
+static int RunMutations(void)
+{
+    static SeedBuf seed;
+    static unsigned char input[FUZZ_MAX_INPUT_SZ];
+    word32 state = 0x2545F491;
+    word32 len;
+    int i, j, n;
+
+    if (MakeSeed(&seed) != 0) {
+        printf("error making seed ClientHello\n");
+        return 1;
+    }
+
+    LLVMFuzzerTestOneInput(seed.buf, seed.len);
+    for (i = 0; i < FUZZ_MUTATIONS; i++) {
+        XMEMCPY(input, seed.buf, seed.len);
+        len = seed.len;
+
+        n = 1 + (int)(NextRand(&state) % 4);
+        for (j = 0; j < n; j++) {
+            switch (NextRand(&state) % 4) {
+                case 0: /* random byte */
+                    input[NextRand(&state) % len] = (byte)NextRand(&state);
+                    break;
+                case 1: /* bit flip */
+                    input[NextRand(&state) % len] ^=
+                                              (byte)(1 << (NextRand(&state) % 8));
+                    break;
+                case 2: /* boundary length value */
+                    input[NextRand(&state) % len] =
+                                        (NextRand(&state) & 1) ? 0x00 : 0xff;
+                    break;
+                default: /* truncate */
+                    len = 1 + NextRand(&state) % len;
+                    break;
+            }
+        }
+
+        LLVMFuzzerTestOneInput(input, len);
+    }
+
+    printf("ran %d ClientHello mutations\n", FUZZ_MUTATIONS);
+    return 0;
+}
+
+static int RunFile(const char* fileName)
+{
+    static unsigned char input[FUZZ_MAX_INPUT_SZ];
+    FILE*  file;
+    size_t len;
+
+    file = fopen(fileName, "rb");
+    if (file == NULL) {
+        printf("unable to open %s\n", fileName);
+        return 1;
+    }
+    len = fread(input, 1, sizeof(input), file);
+    fclose(file);
+
+    LLVMFuzzerTestOneInput(input, len);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    int ret = 0;
+    int i;
+
+    if (FuzzInit() != 0) {
+        printf("error setting up server\n");
+        return 1;
+    }
+
+    if (argc > 1) {
+        for (i = 1; i < argc && ret == 0; i++)
+            ret = RunFile(argv[i]);
+    }
+    else {
+        ret = RunMutations();
+    }
+
+    wolfSSL_CTX_free(serverCtx);
+    wolfSSL_Cleanup();
+
+    return ret;
+}
+
+#endif /* !WOLFSSL_LIBFUZZER */
+
+#else
+
+int LLVMFuzzerTestOneInput(const unsigned char* data, size_t size)
+{
+    (void)data;
+    (void)size;
+
+    return 0;
+}
+
+#ifndef WOLFSSL_LIBFUZZER
+int main(int argc, char** argv)
+{
+    (void)argc;
+    (void)argv;
+
+    printf("ClientHello fuzzer requires TLS v1.3 client and server with "
+           "RSA\n");
+
+    return 0;
+}
+#endif
+
+#endif
@@ -257,6 +257,8 @@
 #define BENCH_RSA_KEYGEN         0x00000001
 #define BENCH_RSA                0x00000002
 #define BENCH_RSA_SZ             0x00000004
+#define BENCH_RSA_MP             0x00000008
+#define BENCH_RSA_8192           0x00000020
 #define BENCH_DH                 0x00000010
 #define BENCH_NTRU               0x00000100
 #define BENCH_NTRU_KEYGEN        0x00000200
@@ -270,6 +272,16 @@
 /* Other */
 #define BENCH_RNG                0x00000001
 #define BENCH_SCRYPT             0x00000002
+#define BENCH_ASN                0x00000004
+
+/* Certificate parsing needs the ASN API exported and the 2048-bit buffers */
+#if !defined(NO_RSA) && !defined(NO_ASN) && \
+    (!defined(WOLFSSL_RSA_PUBLIC_ONLY) || defined(WOLFSSL_PUBLIC_MP)) && \
+    !defined(USE_CERT_BUFFERS_1024) && !defined(USE_CERT_BUFFERS_3072) && \
+    (defined(WOLFSSL_TEST_CERT) || defined(OPENSSL_EXTRA) || \
+     defined(OPENSSL_EXTRA_X509_SMALL))
+    #define BENCH_ASN_PARSE
+#endif
 
 
 /* Benchmark all compiled in algorithms.
@@ -447,6 +459,12 @@ static const bench_alg bench_asym_opt[] = {
     #endif
     { "-rsa",                BENCH_RSA               },
     { "-rsa-sz",             BENCH_RSA_SZ            },
+    #if defined(WOLFSSL_KEY_GEN) && defined(WOLFSSL_RSA_MULTI_PRIME)
+    { "-rsa-mp",             BENCH_RSA_MP            },
+    #endif
+    #if defined(WOLFSSL_KEY_GEN) && RSA_MAX_SIZE >= 8192
+    { "-rsa-8192",           BENCH_RSA_8192          },
+    #endif
 #endif
 #ifndef NO_DH
     { "-dh",                 BENCH_DH                },
@@ -484,6 +502,9 @@ static const bench_alg bench_other_opt[] = {
 #endif
 #ifdef HAVE_SCRYPT
     { "-scrypt",             BENCH_SCRYPT            },
+#endif
+#ifdef BENCH_ASN_PARSE
+    { "-asn",                BENCH_ASN               },
 #endif
     { NULL, 0}
 };
@@ -505,7 +526,7 @@ static int lng_index = 0;
 
 #ifndef NO_MAIN_DRIVER
 #ifndef MAIN_NO_ARGS
-static const char* bench_Usage_msg1[][14] = {
+static const char* bench_Usage_msg1[][15] = {
     /* 0 English  */
     {   "-? <num>    Help, print this usage\n            0: English, 1: Japanese\n",
         "-csv        Print terminal output in csv format\n",
@@ -520,7 +541,8 @@ static const char* bench_Usage_msg1[][14] = {
         "-lng <num>  Display benchmark result by specified language.\n            0: English, 1: Japanese\n",
         "<num>       Size of block in bytes\n",
         "-threads <num> Number of threads to run\n",
-        "-print      Show benchmark stats summary\n"
+        "-print      Show benchmark stats summary\n",
+        "-kg_threads <num> Threads to find RSA key generation primes with\n"
     },
 #ifndef NO_MULTIBYTE_PRINT
     /* 1 Japanese */
@@ -537,7 +559,8 @@ static const char* bench_Usage_msg1[][14] = {
         "-lng <num>  指定された言語でベンチマーク結果を表示します。\n            0: 英語、 1: 日本語\n",
         "<num>       ブロックサイズをバイト単位で指定します。\n",
         "-threads <num> 実行するスレッド数\n",
-        "-print      ベンチマーク統計の要約を表示する\n"
+        "-print      ベンチマーク統計の要約を表示する\n",
+        "-kg_threads <num> Threads to find RSA key generation primes with\n"
     },
 #endif
 };
@@ -868,6 +891,14 @@ static int digest_stream = 1;
 /* Don't measure RSA sign/verify by default */
 static int rsa_sign_verify = 0;
 #endif
+#if !defined(NO_RSA) && defined(WOLFSSL_KEY_GEN) && defined(HAVE_PTHREAD) && \
+    !defined(SINGLE_THREADED) && !defined(HAVE_FIPS) && !defined(HAVE_SELFTEST)
+    #include <pthread.h>
+    #define BENCH_RSA_KG_THREADS
+    #define BENCH_RSA_KG_MAX_THREADS 64
+/* Threads to search for primes with in RSA key generation - none by default */
+static int rsa_kg_threads = 0;
+#endif
 #ifndef NO_DH
 /* Use the FFDHE parameters */
 static int use_ffdhe = 0;
@@ -1685,6 +1716,11 @@ static void* benchmarks_do(void* args)
         bench_scrypt();
 #endif
 
+#ifdef BENCH_ASN_PARSE
+    if (bench_all || (bench_other_algs & BENCH_ASN))
+        bench_asn();
+#endif
+
 #ifndef NO_RSA
     #ifdef WOLFSSL_KEY_GEN
         if (bench_all || (bench_asym_algs & BENCH_RSA_KEYGEN)) {
@@ -1728,6 +1764,28 @@ static void* benchmarks_do(void* args)
     #endif
     }
     #endif
+    #if defined(WOLFSSL_KEY_GEN) && RSA_MAX_SIZE >= 8192
+    if (bench_asym_algs & BENCH_RSA_8192) {
+    #ifndef NO_SW_BENCH
+        bench_rsa_key(0, 8192);
+    #endif
+    #if defined(WOLFSSL_ASYNC_CRYPT) && defined(WC_ASYNC_ENABLE_RSA) && \
+        !defined(NO_HW_BENCH)
+        bench_rsa_key(1, 8192);
+    #endif
+    }
+    #endif
+    #if defined(WOLFSSL_KEY_GEN) && defined(WOLFSSL_RSA_MULTI_PRIME)
+    if (bench_asym_algs & BENCH_RSA_MP) {
+    #ifndef NO_SW_BENCH
+        bench_rsa_multi_prime(0);
+    #endif
+    #if defined(WOLFSSL_ASYNC_CRYPT) && defined(WC_ASYNC_ENABLE_RSA) && \
+        !defined(NO_HW_BENCH)
+        bench_rsa_multi_prime(1);
+    #endif
+    }
+    #endif
 #endif
 
 #ifndef NO_DH
@@ -3945,6 +4003,71 @@ exit:
 
 #endif /* HAVE_SCRYPT */
 
+#ifdef BENCH_ASN_PARSE
+
+#define BENCH_ASN_CHAIN_LEN 3
+
+/* Parse a leaf, intermediate and root sized chain of test certificates the
+ * way the TLS layer does, without signature checks. Reports certificates
+ * parsed per second. */
+static void bench_asn_parse(int lazy)
+{
+    const byte*  chain[BENCH_ASN_CHAIN_LEN];
+    word32       chainSz[BENCH_ASN_CHAIN_LEN];
+    DecodedCert* cert;
+    double       start;
+    int          ret = 0, i, j, count;
+
+    chain[0] = server_cert_der_2048;
+    chainSz[0] = (word32)sizeof(server_cert_der_2048);
+    chain[1] = ca_cert_der_2048;
+    chainSz[1] = (word32)sizeof(ca_cert_der_2048);
+    chain[2] = ca_cert_chain_der;
+    chainSz[2] = (word32)sizeof(ca_cert_chain_der);
+
+    cert = (DecodedCert*)XMALLOC(sizeof(DecodedCert), HEAP_HINT,
+                                 DYNAMIC_TYPE_TMP_BUFFER);
+    if (cert == NULL) {
+        printf("ASN parse failed to allocate\n");
+        return;
+    }
+
+    bench_stats_start(&count, &start);
+    do {
+        for (i = 0; i < agreeTimes; i++) {
+            for (j = 0; j < BENCH_ASN_CHAIN_LEN; j++) {
+                InitDecodedCert(cert, chain[j], chainSz[j], HEAP_HINT);
+            #ifdef WOLFSSL_ASN_LAZY_EXT
+                cert->lazyExt = (byte)lazy;
+            #endif
+                ret = ParseCert(cert, CERT_TYPE, NO_VERIFY, NULL);
+                FreeDecodedCert(cert);
+                if (ret != 0) {
+                    printf("ParseCert failed, ret = %d\n", ret);
+                    goto exit;
+                }
+            }
+        }
+        count += i * BENCH_ASN_CHAIN_LEN;
+    } while (bench_stats_sym_check(start));
+exit:
+    bench_stats_asym_finish("ASN", 2048, lazy ? "lazy" : "parse", 0, count,
+                            start, ret);
+
+    XFREE(cert, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+    (void)lazy;
+}
+
+void bench_asn(void)
+{
+    bench_asn_parse(0);
+#ifdef WOLFSSL_ASN_LAZY_EXT
+    bench_asn_parse(1);
+#endif
+}
+
+#endif /* BENCH_ASN_PARSE */
+
 #ifndef NO_HMAC
 
 static void bench_hmac(int doAsync, int type, int digestSz,
@@ -4149,6 +4272,80 @@ void bench_pbkdf2(void)
 #ifndef NO_RSA
 
 #if defined(WOLFSSL_KEY_GEN)
+#ifdef BENCH_RSA_KG_THREADS
+/* job to run on a thread */
+typedef struct bench_kg_job {
+    void (*job)(void* arg);
+    void*  arg;
+} bench_kg_job;
+
+static void* bench_kg_thread(void* arg)
+{
+    bench_kg_job* job = (bench_kg_job*)arg;
+
+    job->job(job->arg);
+
+    return NULL;
+}
+
+/* RSA key generation thread pool - runs each job on a new thread */
+static int bench_kg_run(void* ctx, void (*job)(void* arg), void** args,
+                        int cnt)
+{
+    pthread_t    tid[BENCH_RSA_KG_MAX_THREADS];
+    bench_kg_job jobs[BENCH_RSA_KG_MAX_THREADS];
+    int          i, started = 0;
+
+    (void)ctx;
+
+    if (cnt > BENCH_RSA_KG_MAX_THREADS)
+        return BAD_FUNC_ARG;
+
+    for (i = 0; i < cnt; i++) {
+        jobs[i].job = job;
+        jobs[i].arg = args[i];
+        if (pthread_create(&tid[i], NULL, bench_kg_thread, &jobs[i]) != 0)
+            break;
+        started++;
+    }
+    /* run jobs that didn't get a thread on this one */
+    for (i = started; i < cnt; i++) {
+        job(args[i]);
+    }
+    for (i = 0; i < started; i++) {
+        pthread_join(tid[i], NULL);
+    }
+
+    return 0;
+}
+#endif
+
+/* most key generation times kept for median and p99 */
+#define BENCH_RSA_KG_SAMPLES 1000
+
+/* Display median and 99th percentile of key generation times. */
+static void bench_rsaKeyGen_percentiles(int keySz, double* samples, int cnt)
+{
+    int    i, j;
+    double t;
+
+    if (cnt == 0 || csv_format)
+        return;
+
+    /* insertion sort - samples are few */
+    for (i = 1; i < cnt; i++) {
+        t = samples[i];
+        for (j = i; j > 0 && samples[j - 1] > t; j--)
+            samples[j] = samples[j - 1];
+        samples[j] = t;
+    }
+
+    /* nearest rank */
+    printf("RSA     %d key gen    median %.3f ms, p99 %.3f ms, %d keys\n",
+        keySz, samples[(cnt - 1) / 2] * 1000,
+        samples[(cnt * 99 + 99) / 100 - 1] * 1000, cnt);
+}
+
 static void bench_rsaKeyGen_helper(int doAsync, int keySz)
 {
     RsaKey genKey[BENCH_MAX_PENDING];
@@ -4156,10 +4353,26 @@ static void bench_rsaKeyGen_helper(int doAsync, int keySz)
     int    ret = 0, i, count = 0, times, pending = 0;
     const long rsa_e_val = WC_RSA_EXPONENT;
     const char**desc = bench_desc_words[lng_index];
+#ifdef BENCH_RSA_KG_THREADS
+    RsaKeyGenPool  threadPool;
+    RsaKeyGenPool* pool = NULL;
+#endif
+    double opStart;
+    int    samplesCnt = 0;
+    DECLARE_VAR(samples, double, BENCH_RSA_KG_SAMPLES, HEAP_HINT);
 
     /* clear for done cleanup */
     XMEMSET(genKey, 0, sizeof(genKey));
 
+#ifdef BENCH_RSA_KG_THREADS
+    if (rsa_kg_threads > 0) {
+        threadPool.run = bench_kg_run;
+        threadPool.ctx = NULL;
+        threadPool.threads = rsa_kg_threads;
+        pool = &threadPool;
+    }
+#endif
+
     bench_stats_start(&count, &start);
     do {
         /* while free pending slots in queue, submit ops */
@@ -4176,7 +4389,18 @@ static void bench_rsaKeyGen_helper(int doAsync, int keySz)
                         goto exit;
                     }
 
+                    opStart = current_time(0);
+                #ifdef BENCH_RSA_KG_THREADS
+                    ret = wc_MakeRsaKey_ex(&genKey[i], keySz, rsa_e_val, &rng,
+                                                                          pool);
+                #else
                     ret = wc_MakeRsaKey(&genKey[i], keySz, rsa_e_val, &rng);
+                #endif
+                    /* time of each key only when not overlapped */
+                    if (ret == 0 && !doAsync &&
+                                       samplesCnt < BENCH_RSA_KG_SAMPLES) {
+                        samples[samplesCnt++] = current_time(0) - opStart;
+                    }
                     if (!bench_async_handle(&ret, BENCH_ASYNC_GET_DEV(&genKey[i]), 0, &times, &pending)) {
                         goto exit;
                     }
@@ -4187,11 +4411,14 @@ static void bench_rsaKeyGen_helper(int doAsync, int keySz)
     } while (bench_stats_sym_check(start));
 exit:
     bench_stats_asym_finish("RSA", keySz, desc[2], doAsync, count, start, ret);
+    if (ret == 0)
+        bench_rsaKeyGen_percentiles(keySz, samples, samplesCnt);
 
     /* cleanup */
     for (i = 0; i < BENCH_MAX_PENDING; i++) {
         wc_FreeRsaKey(&genKey[i]);
     }
+    FREE_VAR(samples, HEAP_HINT);
 }
 
 void bench_rsaKeyGen(int doAsync)
@@ -4519,6 +4746,157 @@ exit_rsa_verify:
 }
 #endif
 
+#if (defined(WC_RSA_PREPARED) || (defined(WOLFSSL_KEY_GEN) && \
+    defined(WOLFSSL_RSA_MULTI_PRIME))) && !defined(WOLFSSL_RSA_PUBLIC_ONLY)
+/* bench private key operation only - decrypt or sign */
+static void bench_rsa_private(int doAsync, RsaKey rsaKey[BENCH_MAX_PENDING],
+        int rsaKeySz, const char* algo)
+{
+    int         ret = 0, i, times, count = 0, pending = 0;
+    word32      idx = (word32)(rsaKeySz/8);
+    const char* messageStr = "Everyone gets Friday off.";
+    const int   len = (int)XSTRLEN((char*)messageStr);
+    double      start = 0.0f;
+    const char**desc = bench_desc_words[lng_index];
+    DECLARE_VAR_INIT(message, byte, len, messageStr, HEAP_HINT);
+    DECLARE_ARRAY_DYNAMIC_DEC(enc, byte, BENCH_MAX_PENDING, rsaKeySz, HEAP_HINT);
+    DECLARE_ARRAY_DYNAMIC_DEC(out, byte, BENCH_MAX_PENDING, rsaKeySz, HEAP_HINT);
+
+    DECLARE_ARRAY_DYNAMIC_EXE(enc, byte, BENCH_MAX_PENDING, rsaKeySz, HEAP_HINT);
+    DECLARE_ARRAY_DYNAMIC_EXE(out, byte, BENCH_MAX_PENDING, rsaKeySz, HEAP_HINT);
+
+    if (!rsa_sign_verify) {
+        for (i = 0; i < BENCH_MAX_PENDING; i++) {
+            ret = wc_RsaPublicEncrypt(message, (word32)len, enc[i], idx,
+                                                            &rsaKey[i], &rng);
+            if (ret < 0) {
+                printf("wc_RsaPublicEncrypt failed! %d\n", ret);
+                goto exit;
+            }
+            ret = 0;
+        }
+    }
+
+    bench_stats_start(&count, &start);
+    do {
+        for (times = 0; times < ntimes || pending > 0; ) {
+            bench_async_poll(&pending);
+
+            /* while free pending slots in queue, submit ops */
+            for (i = 0; i < BENCH_MAX_PENDING; i++) {
+                if (bench_async_check(&ret, BENCH_ASYNC_GET_DEV(&rsaKey[i]),
+                                             1, &times, ntimes, &pending)) {
+                    if (rsa_sign_verify) {
+                        ret = wc_RsaSSL_Sign(message, len, out[i], idx,
+                                                            &rsaKey[i], &rng);
+                    }
+                    else {
+                        ret = wc_RsaPrivateDecrypt(enc[i], idx, out[i], idx,
+                                                                   &rsaKey[i]);
+                    }
+                    if (!bench_async_handle(&ret,
+                                            BENCH_ASYNC_GET_DEV(&rsaKey[i]),
+                                            1, &times, &pending)) {
+                        goto exit;
+                    }
+                }
+            } /* for i */
+        } /* for times */
+        count += times;
+    } while (bench_stats_sym_check(start));
+exit:
+    bench_stats_asym_finish(algo, rsaKeySz,
+                   rsa_sign_verify ? desc[4] : desc[1], doAsync, count, start,
+                                                                          ret);
+
+    FREE_ARRAY_DYNAMIC(enc, BENCH_MAX_PENDING, HEAP_HINT);
+    FREE_ARRAY_DYNAMIC(out, BENCH_MAX_PENDING, HEAP_HINT);
+    FREE_VAR(message, HEAP_HINT);
+}
+#endif
+
+#if defined(WC_RSA_PREPARED) && !defined(WOLFSSL_RSA_PUBLIC_ONLY)
+/* bench private key operation with keys prepared by wc_RsaPrepareKey() */
+static void bench_rsa_prepared(int doAsync, RsaKey rsaKey[BENCH_MAX_PENDING],
+        int rsaKeySz)
+{
+    int i, ret;
+
+    for (i = 0; i < BENCH_MAX_PENDING; i++) {
+        ret = wc_RsaPrepareKey(&rsaKey[i]);
+        if (ret != 0) {
+            printf("wc_RsaPrepareKey failed! %d\n", ret);
+            return;
+        }
+    }
+
+    /* RSA-P: private operation with prepared key */
+    bench_rsa_private(doAsync, rsaKey, rsaKeySz, "RSA-P");
+}
+#endif
+
+#if defined(WC_RSA_BATCH) && !defined(WOLFSSL_RSA_PUBLIC_ONLY)
+/* Number of signatures verified in each call. */
+#define BENCH_RSA_BATCH_SZ   8
+
+/* bench verifying signatures in batches with wc_RsaSSL_VerifyBatch() */
+static void bench_rsa_verify_batch(RsaKey* rsaKey, int rsaKeySz)
+{
+    int         ret = 0, i, count = 0;
+    word32      sigSz = (word32)(rsaKeySz/8);
+    const char* messageStr = "Everyone gets Friday off.";
+    const int   len = (int)XSTRLEN((char*)messageStr);
+    double      start = 0.0f;
+    const char**desc = bench_desc_words[lng_index];
+    const byte* sigs[BENCH_RSA_BATCH_SZ];
+    word32      sigLen[BENCH_RSA_BATCH_SZ];
+    byte*       outs[BENCH_RSA_BATCH_SZ];
+    word32      outLen[BENCH_RSA_BATCH_SZ];
+    RsaKey*     keys[BENCH_RSA_BATCH_SZ];
+    int         res[BENCH_RSA_BATCH_SZ];
+    DECLARE_VAR_INIT(message, byte, len, messageStr, HEAP_HINT);
+    DECLARE_ARRAY_DYNAMIC_DEC(sig, byte, BENCH_RSA_BATCH_SZ, rsaKeySz, HEAP_HINT);
+    DECLARE_ARRAY_DYNAMIC_DEC(out, byte, BENCH_RSA_BATCH_SZ, rsaKeySz, HEAP_HINT);
+
+    DECLARE_ARRAY_DYNAMIC_EXE(sig, byte, BENCH_RSA_BATCH_SZ, rsaKeySz, HEAP_HINT);
+    DECLARE_ARRAY_DYNAMIC_EXE(out, byte, BENCH_RSA_BATCH_SZ, rsaKeySz, HEAP_HINT);
+
+    for (i = 0; i < BENCH_RSA_BATCH_SZ; i++) {
+        ret = wc_RsaSSL_Sign(message, len, sig[i], sigSz, rsaKey, &rng);
+        if (ret < 0) {
+            printf("wc_RsaSSL_Sign failed! %d\n", ret);
+            goto exit;
+        }
+        sigs[i] = sig[i];
+        sigLen[i] = (word32)ret;
+        outs[i] = out[i];
+        outLen[i] = sigSz;
+        keys[i] = rsaKey;
+    }
+    ret = 0;
+
+    bench_stats_start(&count, &start);
+    do {
+        for (i = 0; i < ntimes; i++) {
+            ret = wc_RsaSSL_VerifyBatch(sigs, sigLen, outs, outLen, keys, res,
+                                                           BENCH_RSA_BATCH_SZ);
+            if (ret == 0 && res[0] < 0)
+                ret = res[0];
+            if (ret != 0)
+                goto exit;
+        }
+        count += i * BENCH_RSA_BATCH_SZ;
+    } while (bench_stats_sym_check(start));
+exit:
+    /* RSA-B: signatures verified in batches */
+    bench_stats_asym_finish("RSA-B", rsaKeySz, desc[5], 0, count, start, ret);
+
+    FREE_ARRAY_DYNAMIC(sig, BENCH_RSA_BATCH_SZ, HEAP_HINT);
+    FREE_ARRAY_DYNAMIC(out, BENCH_RSA_BATCH_SZ, HEAP_HINT);
+    FREE_VAR(message, HEAP_HINT);
+}
+#endif
+
 void bench_rsa(int doAsync)
 {
     int         ret = 0, i;
@@ -4597,6 +4975,13 @@ void bench_rsa(int doAsync)
 #if !defined(WOLFSSL_RSA_PUBLIC_ONLY) || defined(WOLFSSL_PUBLIC_MP)
     bench_rsa_helper(doAsync, rsaKey, rsaKeySz);
 #endif
+#if defined(WC_RSA_PREPARED) && !defined(WOLFSSL_RSA_PUBLIC_ONLY)
+    bench_rsa_prepared(doAsync, rsaKey, rsaKeySz);
+#endif
+#if defined(WC_RSA_BATCH) && !defined(WOLFSSL_RSA_PUBLIC_ONLY)
+    if (!doAsync)
+        bench_rsa_verify_batch(&rsaKey[0], rsaKeySz);
+#endif
 exit_bench_rsa:
     /* cleanup */
     for (i = 0; i < BENCH_MAX_PENDING; i++) {
@@ -4658,6 +5043,60 @@ exit_bench_rsa_key:
         wc_FreeRsaKey(&rsaKey[i]);
     }
 }
+
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+/* bench private key operation of keys with 2, 3 and 4 primes */
+void bench_rsa_multi_prime(int doAsync)
+{
+    int         ret = 0, i, k, primes;
+    RsaKey      rsaKey[BENCH_MAX_PENDING];
+    long        exp = 65537l;
+    const int   keySizes[2] = {3072, 4096};
+    const char* algo[RSA_MAX_PRIMES + 1] = { NULL, NULL,
+        "RSA-2p", "RSA-3p", "RSA-4p" };
+
+    /* clear for done cleanup */
+    XMEMSET(rsaKey, 0, sizeof(rsaKey));
+
+    for (k = 0; k < (int)(sizeof(keySizes)/sizeof(int)); k++) {
+        for (primes = 2; primes <= RSA_MAX_PRIMES; primes++) {
+            /* 4 primes only from 4096 bits */
+            if (primes > 3 && keySizes[k] < 4096)
+                continue;
+
+            for (i = 0; i < BENCH_MAX_PENDING; i++) {
+                if ((ret = wc_InitRsaKey_ex(&rsaKey[i], HEAP_HINT,
+                                    doAsync ? devId : INVALID_DEVID)) < 0) {
+                    goto exit_bench_rsa_mp;
+                }
+            #ifdef WC_RSA_BLINDING
+                ret = wc_RsaSetRNG(&rsaKey[i], &rng);
+                if (ret != 0)
+                    goto exit_bench_rsa_mp;
+            #endif
+                ret = wc_MakeRsaKeyMultiPrime(&rsaKey[i], keySizes[k], exp,
+                                                                primes, &rng);
+                if (ret != 0) {
+                    printf("wc_MakeRsaKeyMultiPrime failed! %d\n", ret);
+                    goto exit_bench_rsa_mp;
+                }
+            }
+
+            bench_rsa_private(doAsync, rsaKey, keySizes[k], algo[primes]);
+
+            for (i = 0; i < BENCH_MAX_PENDING; i++) {
+                wc_FreeRsaKey(&rsaKey[i]);
+            }
+        }
+    }
+
+exit_bench_rsa_mp:
+    /* cleanup */
+    for (i = 0; i < BENCH_MAX_PENDING; i++) {
+        wc_FreeRsaKey(&rsaKey[i]);
+    }
+}
+#endif /* WOLFSSL_RSA_MULTI_PRIME */
 #endif /* WOLFSSL_KEY_GEN */
 #endif /* !NO_RSA */
 
@@ -5111,6 +5550,50 @@ exit:
     }
 }
 
+#if defined(WOLFSSL_ECC_PRECOMPUTE) && !defined(NO_ASN) && \
+    defined(HAVE_ECC_SIGN) && defined(HAVE_ECC_VERIFY)
+/* bench verifying signatures with a precomputed table of the public key */
+static void bench_ecc_verify_precompute(ecc_key* key, int keySize)
+{
+    int         ret = 0, i, count = 0;
+    int         verify = 0;
+    word32      sigSz = ECC_MAX_SIG_SIZE;
+    double      start = 0.0f;
+    const char**desc = bench_desc_words[lng_index];
+    byte        sig[ECC_MAX_SIG_SIZE];
+    byte        digest[MAX_ECC_BYTES];
+
+    for (i = 0; i < keySize; i++) {
+        digest[i] = (byte)i;
+    }
+    ret = wc_ecc_sign_hash(digest, (word32)keySize, sig, &sigSz, &rng, key);
+    if (ret == 0) {
+        ret = wc_ecc_precompute(key);
+    }
+    if (ret != 0) {
+        printf("wc_ecc_precompute failed! %d\n", ret);
+        return;
+    }
+
+    bench_stats_start(&count, &start);
+    do {
+        for (i = 0; i < agreeTimes; i++) {
+            ret = wc_ecc_verify_hash(sig, sigSz, digest, (word32)keySize,
+                                     &verify, key);
+            if (ret == 0 && verify != 1)
+                ret = SIG_VERIFY_E;
+            if (ret != 0)
+                goto exit;
+        }
+        count += i;
+    } while (bench_stats_sym_check(start));
+exit:
+    /* ECDSA-P: public key with precomputed table */
+    bench_stats_asym_finish("ECDSA-P", keySize * 8, desc[5], 0, count, start,
+                            ret);
+}
+#endif
+
 void bench_ecc(int doAsync)
 {
     int ret = 0, i, times, count, pending = 0;
@@ -5258,6 +5741,10 @@ exit_ecdsa_sign:
     } while (bench_stats_sym_check(start));
 exit_ecdsa_verify:
     bench_stats_asym_finish("ECDSA", keySize * 8, desc[5], doAsync, count, start, ret);
+#ifdef WOLFSSL_ECC_PRECOMPUTE
+    if (ret >= 0 && !doAsync)
+        bench_ecc_verify_precompute(&genKey[0], keySize);
+#endif
 #endif /* HAVE_ECC_VERIFY */
 #endif /* !NO_ASN && HAVE_ECC_SIGN */
 
@@ -5801,6 +6288,9 @@ static void Usage(void)
     printf("%s", bench_Usage_msg1[lng_index][12]);   /* option -threads <num> */
 #endif
     printf("%s", bench_Usage_msg1[lng_index][13]);   /* option -print */
+#ifdef BENCH_RSA_KG_THREADS
+    printf("%s", bench_Usage_msg1[lng_index][14]);   /* option -kg_threads */
+#endif
 }
 
 /* Match the command line argument with the string.
@@ -5880,6 +6370,21 @@ int main(int argc, char** argv)
         else if (string_matches(argv[1], "-rsa_sign"))
             rsa_sign_verify = 1;
 #endif
+#ifdef BENCH_RSA_KG_THREADS
+        else if (string_matches(argv[1], "-kg_threads")) {
+            argc--;
+            argv++;
+            if (argc > 1) {
+                rsa_kg_threads = XATOI(argv[1]);
+                if (rsa_kg_threads < 1 ||
+                                rsa_kg_threads > BENCH_RSA_KG_MAX_THREADS) {
+                    printf("invalid number(%d) is specified. [<num> :1-%d]\n",
+                        rsa_kg_threads, BENCH_RSA_KG_MAX_THREADS);
+                    rsa_kg_threads = 0;
+                }
+            }
+        }
+#endif
 #if !defined(NO_DH) && defined(HAVE_FFDHE_2048)
         else if (string_matches(argv[1], "-ffdhe2048"))
             use_ffdhe = 2048;
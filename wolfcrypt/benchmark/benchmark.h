@@ -69,6 +69,7 @@ void bench_sha3_512(int);
 int  bench_ripemd(void);
 void bench_cmac(void);
 void bench_scrypt(void);
+void bench_asn(void);
 void bench_hmac_md5(int);
 void bench_hmac_sha(int);
 void bench_hmac_sha224(int);
@@ -79,6 +80,7 @@ void bench_rsaKeyGen(int);
 void bench_rsaKeyGen_size(int, int);
 void bench_rsa(int);
 void bench_rsa_key(int, int);
+void bench_rsa_multi_prime(int);
 void bench_dh(int);
 void bench_eccMakeKey(int);
 void bench_ecc(int);
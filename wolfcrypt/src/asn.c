@@ -2556,6 +2556,38 @@ int wc_RsaPrivateKeyDecode(const byte* input, word32* inOutIdx, RsaKey* key,
         SkipInt(input, inOutIdx, inSz) < 0 )  return ASN_RSA_KEY_E;
 #endif
 
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    key->primes = 0;
+    if (version == 1) {
+        /* otherPrimeInfos: SEQUENCE OF SEQUENCE { prime, exponent,
+         *                                         coefficient } */
+        word32 end, infoEnd;
+        int    cnt = 0;
+
+        if (GetSequence(input, inOutIdx, &length, inSz) < 0)
+            return ASN_RSA_KEY_E;
+        end = *inOutIdx + length;
+
+        while (*inOutIdx < end) {
+            if (cnt == RSA_MAX_PRIMES - 2)
+                return ASN_RSA_KEY_E;
+            if (GetSequence(input, inOutIdx, &length, end) < 0)
+                return ASN_RSA_KEY_E;
+            infoEnd = *inOutIdx + length;
+            if (GetInt(&key->r[cnt],  input, inOutIdx, infoEnd) < 0 ||
+                GetInt(&key->dR[cnt], input, inOutIdx, infoEnd) < 0 ||
+                GetInt(&key->tR[cnt], input, inOutIdx, infoEnd) < 0 ||
+                *inOutIdx != infoEnd) {
+                return ASN_RSA_KEY_E;
+            }
+            cnt++;
+        }
+        if (cnt == 0)
+            return ASN_RSA_KEY_E;
+        key->primes = 2 + cnt;
+    }
+#endif
+
 #if defined(WOLFSSL_XILINX_CRYPT) || defined(WOLFSSL_CRYPTOCELL)
     if (wc_InitRsaHw(key) != 0) {
         return BAD_STATE_E;
@@ -7965,6 +7997,45 @@ int DecodePolicyOID(char *out, word32 outSz, const byte *in, word32 inSz)
 #define VERIFY_AND_SET_OID(bit) bit = 1;
 #endif
 
+#ifdef WOLFSSL_ASN_LAZY_EXT
+/* Index of a CertLazyExt bit in the lazy extension tables of DecodedCert. */
+static int CertLazyExtSlot(byte ext)
+{
+    int slot = 0;
+
+    while ((ext >>= 1) != 0)
+        slot++;
+
+    return slot;
+}
+
+/* Remember where an extension value is so it can be decoded on demand.
+ * The value must be a SEQUENCE that fits in the extension - the full decode
+ * is left until the extension is needed.
+ *
+ * returns ASN_PARSE_E when the value is not a SEQUENCE and 0 otherwise.
+ */
+static int RecordCertLazyExt(DecodedCert* cert, byte ext, word32 idx,
+                             int length)
+{
+    int    slot = CertLazyExtSlot(ext);
+    word32 seqIdx = 0;
+    int    seqLen;
+
+    if (GetSequence(&cert->extensions[idx], &seqIdx, &seqLen,
+                                                         (word32)length) < 0) {
+        WOLFSSL_MSG("\tfail: deferred extension not a SEQUENCE");
+        return ASN_PARSE_E;
+    }
+
+    cert->lazyExtIdx[slot] = idx;
+    cert->lazyExtSz[slot]  = (word32)length;
+    cert->lazyExtPending  |= ext;
+
+    return 0;
+}
+#endif /* WOLFSSL_ASN_LAZY_EXT */
+
 static int DecodeCertExtensions(DecodedCert* cert)
 /*
  *  Processing the Certificate Extensions. This does not modify the current
@@ -8061,6 +8132,14 @@ static int DecodeCertExtensions(DecodedCert* cert)
                 #if defined(OPENSSL_EXTRA) || defined(OPENSSL_EXTRA_X509_SMALL)
                     cert->extCRLdistCrit = critical;
                 #endif
+            #ifdef WOLFSSL_ASN_LAZY_EXT
+                if (cert->lazyExt) {
+                    if (RecordCertLazyExt(cert, CERT_LAZY_CRL_DIST,
+                                                            idx, length) < 0)
+                        return ASN_PARSE_E;
+                    break;
+                }
+            #endif
                 if (DecodeCrlDist(&input[idx], length, cert) < 0)
                     return ASN_PARSE_E;
                 break;
@@ -8070,6 +8149,14 @@ static int DecodeCertExtensions(DecodedCert* cert)
                 #if defined(OPENSSL_EXTRA) || defined(OPENSSL_EXTRA_X509_SMALL)
                     cert->extAuthInfoCrit = critical;
                 #endif
+            #ifdef WOLFSSL_ASN_LAZY_EXT
+                if (cert->lazyExt) {
+                    if (RecordCertLazyExt(cert, CERT_LAZY_AUTH_INFO,
+                                                            idx, length) < 0)
+                        return ASN_PARSE_E;
+                    break;
+                }
+            #endif
                 if (DecodeAuthInfo(&input[idx], length, cert) < 0)
                     return ASN_PARSE_E;
                 break;
@@ -8079,6 +8166,14 @@ static int DecodeCertExtensions(DecodedCert* cert)
                 #if defined(OPENSSL_EXTRA) || defined(OPENSSL_EXTRA_X509_SMALL)
                     cert->extSubjAltNameCrit = critical;
                 #endif
+            #ifdef WOLFSSL_ASN_LAZY_EXT
+                if (cert->lazyExt) {
+                    if (RecordCertLazyExt(cert, CERT_LAZY_ALT_NAMES,
+                                                            idx, length) < 0)
+                        return ASN_PARSE_E;
+                    break;
+                }
+            #endif
                 ret = DecodeAltNames(&input[idx], length, cert);
                 if (ret < 0)
                     return ret;
@@ -8134,6 +8229,15 @@ static int DecodeCertExtensions(DecodedCert* cert)
                     #endif
                 #endif
                 #if defined(WOLFSSL_SEP) || defined(WOLFSSL_CERT_EXT)
+                #ifdef WOLFSSL_ASN_LAZY_EXT
+                    if (cert->lazyExt) {
+                        if (RecordCertLazyExt(cert, CERT_LAZY_CERT_POLICY,
+                                                             idx, length) < 0) {
+                            return ASN_PARSE_E;
+                        }
+                        break;
+                    }
+                #endif
                     if (DecodeCertPolicy(&input[idx], length, cert) < 0) {
                         return ASN_PARSE_E;
                     }
@@ -8175,6 +8279,14 @@ static int DecodeCertExtensions(DecodedCert* cert)
                 #if defined(OPENSSL_EXTRA) || defined(OPENSSL_EXTRA_X509_SMALL)
                     cert->extNameConstraintCrit = critical;
                 #endif
+            #ifdef WOLFSSL_ASN_LAZY_EXT
+                if (cert->lazyExt) {
+                    if (RecordCertLazyExt(cert, CERT_LAZY_NAME_CONS,
+                                                            idx, length) < 0)
+                        return ASN_PARSE_E;
+                    break;
+                }
+            #endif
                 if (DecodeNameConstraints(&input[idx], length, cert) < 0)
                     return ASN_PARSE_E;
                 break;
@@ -8202,6 +8314,85 @@ static int DecodeCertExtensions(DecodedCert* cert)
     return criticalFail ? ASN_CRIT_EXT_E : 0;
 }
 
+#ifdef WOLFSSL_ASN_LAZY_EXT
+/* Decode extensions that were skipped when the certificate was parsed with
+ * lazyExt set. The certificate's source buffer must still be valid.
+ *
+ * cert  Certificate parsed with ParseCertRelative.
+ * exts  Mask of CertLazyExt values to decode. Extensions that are absent or
+ *       were already decoded are ignored.
+ * returns 0 on success, BAD_FUNC_ARG when cert is NULL and a negative parse
+ * error when an extension is malformed. Once an extension fails to decode,
+ * that error is returned by every later call.
+ */
+int DecodeCertLazyExt(DecodedCert* cert, byte exts)
+{
+    int  ret = 0;
+    byte ext;
+
+    if (cert == NULL)
+        return BAD_FUNC_ARG;
+    if (cert->lazyExtErr != 0)
+        return cert->lazyExtErr;
+
+    exts &= cert->lazyExtPending;
+    for (ext = CERT_LAZY_ALT_NAMES; ret == 0 && exts != 0; ext <<= 1) {
+        const byte* input;
+        int         length;
+        int         slot;
+
+        if ((exts & ext) == 0)
+            continue;
+
+        /* only ever try once, a failure is remembered in lazyExtErr */
+        exts &= ~ext;
+        cert->lazyExtPending &= ~ext;
+
+        slot   = CertLazyExtSlot(ext);
+        input  = &cert->extensions[cert->lazyExtIdx[slot]];
+        length = (int)cert->lazyExtSz[slot];
+
+        switch (ext) {
+            case CERT_LAZY_ALT_NAMES:
+                ret = DecodeAltNames(input, length, cert);
+                break;
+
+            case CERT_LAZY_AUTH_INFO:
+                if (DecodeAuthInfo(input, length, cert) < 0)
+                    ret = ASN_PARSE_E;
+                break;
+
+            case CERT_LAZY_CRL_DIST:
+                if (DecodeCrlDist(input, length, cert) < 0)
+                    ret = ASN_PARSE_E;
+                break;
+
+        #if defined(WOLFSSL_SEP) || defined(WOLFSSL_CERT_EXT)
+            case CERT_LAZY_CERT_POLICY:
+                if (DecodeCertPolicy(input, length, cert) < 0)
+                    ret = ASN_PARSE_E;
+                break;
+        #endif
+
+        #ifndef IGNORE_NAME_CONSTRAINTS
+            case CERT_LAZY_NAME_CONS:
+                if (DecodeNameConstraints(input, length, cert) < 0)
+                    ret = ASN_PARSE_E;
+                break;
+        #endif
+
+            default:
+                break;
+        }
+    }
+
+    if (ret < 0)
+        cert->lazyExtErr = ret;
+
+    return ret;
+}
+#endif /* WOLFSSL_ASN_LAZY_EXT */
+
 int ParseCert(DecodedCert* cert, int type, int verify, void* cm)
 {
     int   ret;
@@ -8921,6 +9112,13 @@ int ParseCertRelative(DecodedCert* cert, int type, int verify, void* cm)
         #ifndef IGNORE_NAME_CONSTRAINTS
             if (verify == VERIFY || verify == VERIFY_OCSP ||
                         verify == VERIFY_NAME || verify == VERIFY_SKIP_DATE) {
+            #ifdef WOLFSSL_ASN_LAZY_EXT
+                if ((cert->ca->permittedNames || cert->ca->excludedNames) &&
+                        (ret = DecodeCertLazyExt(cert,
+                                                 CERT_LAZY_ALT_NAMES)) < 0) {
+                    return ret;
+                }
+            #endif
                 /* check that this cert's name is permitted by the signer's
                  * name constraints */
                 if (!ConfirmNameConstraints(cert->ca, cert)) {
@@ -10437,6 +10635,13 @@ int wc_RsaPublicKeyDerSize(RsaKey* key, int with_header)
 
 #if defined(WOLFSSL_KEY_GEN) && !defined(NO_RSA) && !defined(HAVE_USER_RSA)
 
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    /* RSA ints in private key including OtherPrimeInfos */
+    #define RSA_KEY_INTS    (RSA_INTS + 3 * (RSA_MAX_PRIMES - 2))
+#else
+    #define RSA_KEY_INTS    RSA_INTS
+#endif
+
 static mp_int* GetRsaInt(RsaKey* key, int idx)
 {
     if (idx == 0)
@@ -10455,6 +10660,17 @@ static mp_int* GetRsaInt(RsaKey* key, int idx)
         return &key->dQ;
     if (idx == 7)
         return &key->u;
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    /* prime, exponent and coefficient of each OtherPrimeInfo */
+    if (idx < RSA_KEY_INTS) {
+        idx -= RSA_INTS;
+        if (idx % 3 == 0)
+            return &key->r[idx / 3];
+        if (idx % 3 == 1)
+            return &key->dR[idx / 3];
+        return &key->tR[idx / 3];
+    }
+#endif
 
     return NULL;
 }
@@ -10467,7 +10683,7 @@ static WC_INLINE void FreeTmpRsas(byte** tmps, void* heap)
 
     (void)heap;
 
-    for (i = 0; i < RSA_INTS; i++)
+    for (i = 0; i < RSA_KEY_INTS; i++)
         XFREE(tmps[i], heap, DYNAMIC_TYPE_RSA);
 }
 
@@ -10477,12 +10693,20 @@ static WC_INLINE void FreeTmpRsas(byte** tmps, void* heap)
 int wc_RsaKeyToDer(RsaKey* key, byte* output, word32 inLen)
 {
     word32 seqSz, verSz, rawLen, intTotalLen = 0;
-    word32 sizes[RSA_INTS];
+    word32 sizes[RSA_KEY_INTS];
     int    i, j, outLen, ret = 0, mpSz;
+    int    intCnt = RSA_INTS;
 
     byte  seq[MAX_SEQ_SZ];
     byte  ver[MAX_VERSION_SZ];
-    byte* tmps[RSA_INTS];
+    byte* tmps[RSA_KEY_INTS];
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    byte   otherSeq[MAX_SEQ_SZ];
+    byte   infoSeq[RSA_MAX_PRIMES - 2][MAX_SEQ_SZ];
+    word32 infoSeqSz[RSA_MAX_PRIMES - 2];
+    word32 otherSeqSz = 0, infoLen, otherLen = 0;
+    int    k;
+#endif
 
     if (!key || !output)
         return BAD_FUNC_ARG;
@@ -10490,11 +10714,16 @@ int wc_RsaKeyToDer(RsaKey* key, byte* output, word32 inLen)
     if (key->type != RSA_PRIVATE)
         return BAD_FUNC_ARG;
 
-    for (i = 0; i < RSA_INTS; i++)
+    for (i = 0; i < RSA_KEY_INTS; i++)
         tmps[i] = NULL;
 
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    if (key->primes > 2)
+        intCnt += 3 * (key->primes - 2);
+#endif
+
     /* write all big ints from key to DER tmps */
-    for (i = 0; i < RSA_INTS; i++) {
+    for (i = 0; i < intCnt; i++) {
         mp_int* keyInt = GetRsaInt(key, i);
 
         rawLen = mp_unsigned_bin_size(keyInt) + 1;
@@ -10510,7 +10739,9 @@ int wc_RsaKeyToDer(RsaKey* key, byte* output, word32 inLen)
             ret = mpSz;
             break;
         }
-        intTotalLen += (sizes[i] = mpSz);
+        sizes[i] = mpSz;
+        if (i < RSA_INTS)
+            intTotalLen += mpSz;
     }
 
     if (ret != 0) {
@@ -10518,8 +10749,25 @@ int wc_RsaKeyToDer(RsaKey* key, byte* output, word32 inLen)
         return ret;
     }
 
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    /* otherPrimeInfos: SEQUENCE OF SEQUENCE { prime, exponent, coefficient } */
+    if (key->primes > 2) {
+        for (k = 0; k < key->primes - 2; k++) {
+            i = RSA_INTS + 3 * k;
+            infoLen = sizes[i] + sizes[i + 1] + sizes[i + 2];
+            infoSeqSz[k] = SetSequence(infoLen, infoSeq[k]);
+            otherLen += infoSeqSz[k] + infoLen;
+        }
+        otherSeqSz = SetSequence(otherLen, otherSeq);
+        intTotalLen += otherSeqSz + otherLen;
+    }
+
+    /* make headers - version is multi (1) when there are other primes */
+    verSz = SetMyVersion(key->primes > 2 ? 1 : 0, ver, FALSE);
+#else
     /* make headers */
     verSz = SetMyVersion(0, ver, FALSE);
+#endif
     seqSz = SetSequence(verSz + intTotalLen, seq);
 
     outLen = seqSz + verSz + intTotalLen;
@@ -10538,6 +10786,20 @@ int wc_RsaKeyToDer(RsaKey* key, byte* output, word32 inLen)
         XMEMCPY(output + j, tmps[i], sizes[i]);
         j += sizes[i];
     }
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    if (key->primes > 2) {
+        XMEMCPY(output + j, otherSeq, otherSeqSz);
+        j += otherSeqSz;
+        for (k = 0; k < key->primes - 2; k++) {
+            XMEMCPY(output + j, infoSeq[k], infoSeqSz[k]);
+            j += infoSeqSz[k];
+            for (i = RSA_INTS + 3 * k; i < RSA_INTS + 3 * k + 3; i++) {
+                XMEMCPY(output + j, tmps[i], sizes[i]);
+                j += sizes[i];
+            }
+        }
+    }
+#endif
     FreeTmpRsas(tmps, key->heap);
 
     return outLen;
@@ -15607,6 +15869,10 @@ int InitOcspRequest(OcspRequest* req, DecodedCert* cert, byte useNonce,
     req->heap = heap;
 
     if (cert) {
+    #ifdef WOLFSSL_ASN_LAZY_EXT
+        if ((ret = DecodeCertLazyExt(cert, CERT_LAZY_AUTH_INFO)) < 0)
+            return ret;
+    #endif
         XMEMCPY(req->issuerHash,    cert->issuerHash,    KEYID_SIZE);
         XMEMCPY(req->issuerKeyHash, cert->issuerKeyHash, KEYID_SIZE);
 
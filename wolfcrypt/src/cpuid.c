@@ -86,6 +86,25 @@
         return 0;
     }
 
+    /* Check the OS saves the AVX-512 opmask and ZMM registers. */
+    static int cpuid_os_avx512(void)
+    {
+        word32 xcr0;
+
+        if (!cpuid_flag(1, 0, ECX, 27))
+            return 0;
+    #ifndef _MSC_VER
+        {
+            word32 hi;
+            __asm__ __volatile__ ("xgetbv" : "=a" (xcr0), "=d" (hi) : "c" (0));
+            (void)hi;
+        }
+    #else
+        xcr0 = (word32)_xgetbv(0);
+    #endif
+        /* SSE, AVX, opmask, ZMM0-15 upper and ZMM16-31 state */
+        return (xcr0 & 0xe6) == 0xe6;
+    }
 
     void cpuid_set_flags(void)
     {
@@ -97,6 +116,10 @@
             if (cpuid_flag(7, 0, EBX, 18)) { cpuid_flags |= CPUID_RDSEED; }
             if (cpuid_flag(1, 0, ECX, 25)) { cpuid_flags |= CPUID_AESNI ; }
             if (cpuid_flag(7, 0, EBX, 19)) { cpuid_flags |= CPUID_ADX   ; }
+            if (cpuid_flag(7, 0, EBX, 16) && cpuid_os_avx512()) {
+                cpuid_flags |= CPUID_AVX512;
+                if (cpuid_flag(7, 0, EBX, 21)) { cpuid_flags |= CPUID_IFMA; }
+            }
             cpuid_check = 1;
         }
     }
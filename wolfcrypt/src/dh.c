@@ -1261,7 +1261,8 @@ static int GeneratePublicDh(DhKey* key, byte* priv, word32 privSz,
         return MEMORY_E;
     }
 #endif
-    if (mp_init_multi(x, y, 0, 0, 0, 0) != MP_OKAY) {
+    if (mp_init_multi_size(MP_MOD_SIZE(&key->p), x, y, 0, 0, 0, 0)
+                                                                  != MP_OKAY) {
     #ifdef WOLFSSL_SMALL_STACK
         XFREE(y, key->heap, DYNAMIC_TYPE_DH);
         XFREE(x, key->heap, DYNAMIC_TYPE_DH);
@@ -1950,7 +1951,8 @@ static int wc_DhAgree_Sync(DhKey* key, byte* agree, word32* agreeSz,
 #endif
 
 #ifndef WOLFSSL_SP_MATH
-    if (mp_init_multi(x, y, z, 0, 0, 0) != MP_OKAY) {
+    if (mp_init_multi_size(MP_MOD_SIZE(&key->p), x, y, z, 0, 0, 0)
+                                                                  != MP_OKAY) {
     #ifdef WOLFSSL_SMALL_STACK
         XFREE(z, key->heap, DYNAMIC_TYPE_DH);
         XFREE(x, key->heap, DYNAMIC_TYPE_DH);
@@ -51,8 +51,12 @@ Possible ECC enable options:
  * ECC_CACHE_CURVE:     Enables cache of curve info to improve perofrmance
                                                                 default: off
  * FP_ECC:              ECC Fixed Point Cache                   default: off
+ * FP_ECC_GEN_MIN_SIZE: Smallest curve in bytes given a shared  default: 32
+                         generator table on first use (FP_ECC)
  * USE_ECC_B_PARAM:     Enable ECC curve B param                default: off
                          (on for HAVE_COMP_KEY)
+ * NO_ECC_CURVE_DIGITS: Load fast math curve params from hex    default: off
+                         strings instead of binary digit tables
  */
 
 /*
@@ -1139,6 +1143,14 @@ const ecc_set_type ecc_sets[] = {
 };
 #define ECC_SET_COUNT   (sizeof(ecc_sets)/sizeof(ecc_set_type))
 
+#if defined(USE_FAST_MATH) && !defined(WOLFSSL_SP_MATH) && \
+    !defined(NO_ECC_CURVE_DIGITS) && defined(SIZEOF_FP_DIGIT) && \
+    (SIZEOF_FP_DIGIT == 8 || SIZEOF_FP_DIGIT == 4)
+    /* built-in curve parameters as binary digits, no hex parsing on load */
+    #define HAVE_ECC_CURVE_DIGITS
+    #include "ecc_curve_digits.i"
+#endif
+
 
 #ifdef HAVE_OID_ENCODING
     /* encoded OID cache */
@@ -1153,6 +1165,9 @@ const ecc_set_type ecc_sets[] = {
 #ifdef HAVE_COMP_KEY
 static int wc_ecc_export_x963_compressed(ecc_key*, byte* out, word32* outLen);
 #endif
+#if defined(FP_ECC) && !defined(WOLFSSL_SP_MATH)
+static void fp_gen_use(const ecc_set_type* dp);
+#endif
 
 
 #if (defined(WOLFSSL_VALIDATE_ECC_KEYGEN) || !defined(WOLFSSL_SP_MATH)) && \
@@ -1286,8 +1301,31 @@ static void wc_ecc_curve_free(ecc_curve_spec* curve)
     (void)curve;
 }
 
-static int wc_ecc_curve_load_item(const char* src, mp_int** dst,
-    ecc_curve_spec* curve, byte mask)
+#ifdef HAVE_ECC_CURVE_DIGITS
+/* Find the binary digits of a built-in curve's parameters.
+ *
+ * dp  Curve parameters.
+ * returns the digits of the curve or NULL when not an entry of ecc_sets[].
+ */
+static const ecc_curve_digits_t* wc_ecc_curve_digits(const ecc_set_type* dp)
+{
+    int x = wc_ecc_get_curve_idx(dp->id);
+
+    if (x < 0 || &ecc_sets[x] != dp ||
+            x >= (int)(sizeof(ecc_curve_digits) / sizeof(ecc_curve_digits_t)) ||
+            ecc_curve_digits[x].id != dp->id ||
+            ecc_curve_digits[x].words * ECC_DIGITS_PER_WORD > FP_SIZE) {
+        return NULL;
+    }
+
+    return &ecc_curve_digits[x];
+}
+#endif
+
+/* Load a curve parameter from its digits when available, otherwise from its
+ * hex string. */
+static int wc_ecc_curve_load_item(const char* src, const mp_digit* digits,
+    int cnt, mp_int** dst, ecc_curve_spec* curve, byte mask)
 {
     int err;
 
@@ -1300,6 +1338,28 @@ static int wc_ecc_curve_load_item(const char* src, mp_int** dst,
     *dst = &curve->spec_ints[curve->spec_use++];
 #endif
 
+#ifdef HAVE_ECC_CURVE_DIGITS
+    if (digits != NULL) {
+        /* same size class as temporaries modulo the parameter */
+        err = mp_init_size(*dst, 2 * cnt + 1);
+        if (err == MP_OKAY) {
+            curve->load_mask |= mask;
+
+            XMEMCPY((*dst)->dp, digits, cnt * sizeof(mp_digit));
+            (*dst)->used = cnt;
+            mp_clamp(*dst);
+
+        #ifdef HAVE_WOLF_BIGINT
+            err = wc_mp_to_bigint(*dst, &(*dst)->raw);
+        #endif
+        }
+        return err;
+    }
+#else
+    (void)digits;
+    (void)cnt;
+#endif
+
     err = mp_init(*dst);
     if (err == MP_OKAY) {
         curve->load_mask |= mask;
@@ -1320,6 +1380,11 @@ static int wc_ecc_curve_load(const ecc_set_type* dp, ecc_curve_spec** pCurve,
     int ret = 0, x;
     ecc_curve_spec* curve;
     byte load_items = 0; /* mask of items to load */
+    const mp_digit* digits = NULL;
+    int cnt = 0;
+#ifdef HAVE_ECC_CURVE_DIGITS
+    const ecc_curve_digits_t* cd;
+#endif
 
     if (dp == NULL || pCurve == NULL)
         return BAD_FUNC_ARG;
@@ -1376,28 +1441,40 @@ static int wc_ecc_curve_load(const ecc_set_type* dp, ecc_curve_spec** pCurve,
     load_items = (((byte)~(word32)curve->load_mask) & load_mask);
     curve->load_mask |= load_items;
 
+#ifdef HAVE_ECC_CURVE_DIGITS
+    /* built-in curves are copied from digits, custom curves parsed */
+    if (load_items != 0 && (cd = wc_ecc_curve_digits(dp)) != NULL) {
+        digits = cd->digits;
+        cnt = cd->words * ECC_DIGITS_PER_WORD;
+    }
+#endif
+    /* digits of the n'th parameter: prime, A, B, order, Gx, Gy */
+    #define ECC_CURVE_ITEM_DIGITS(n) \
+        ((digits != NULL) ? &digits[(n) * cnt] : NULL)
+
     /* load items */
     x = 0;
     if (load_items & ECC_CURVE_FIELD_PRIME)
-        x += wc_ecc_curve_load_item(dp->prime, &curve->prime, curve,
-            ECC_CURVE_FIELD_PRIME);
+        x += wc_ecc_curve_load_item(dp->prime, ECC_CURVE_ITEM_DIGITS(0), cnt,
+            &curve->prime, curve, ECC_CURVE_FIELD_PRIME);
     if (load_items & ECC_CURVE_FIELD_AF)
-        x += wc_ecc_curve_load_item(dp->Af, &curve->Af, curve,
-            ECC_CURVE_FIELD_AF);
+        x += wc_ecc_curve_load_item(dp->Af, ECC_CURVE_ITEM_DIGITS(1), cnt,
+            &curve->Af, curve, ECC_CURVE_FIELD_AF);
 #ifdef USE_ECC_B_PARAM
     if (load_items & ECC_CURVE_FIELD_BF)
-        x += wc_ecc_curve_load_item(dp->Bf, &curve->Bf, curve,
-            ECC_CURVE_FIELD_BF);
+        x += wc_ecc_curve_load_item(dp->Bf, ECC_CURVE_ITEM_DIGITS(2), cnt,
+            &curve->Bf, curve, ECC_CURVE_FIELD_BF);
 #endif
     if (load_items & ECC_CURVE_FIELD_ORDER)
-        x += wc_ecc_curve_load_item(dp->order, &curve->order, curve,
-            ECC_CURVE_FIELD_ORDER);
+        x += wc_ecc_curve_load_item(dp->order, ECC_CURVE_ITEM_DIGITS(3), cnt,
+            &curve->order, curve, ECC_CURVE_FIELD_ORDER);
     if (load_items & ECC_CURVE_FIELD_GX)
-        x += wc_ecc_curve_load_item(dp->Gx, &curve->Gx, curve,
-            ECC_CURVE_FIELD_GX);
+        x += wc_ecc_curve_load_item(dp->Gx, ECC_CURVE_ITEM_DIGITS(4), cnt,
+            &curve->Gx, curve, ECC_CURVE_FIELD_GX);
     if (load_items & ECC_CURVE_FIELD_GY)
-        x += wc_ecc_curve_load_item(dp->Gy, &curve->Gy, curve,
-            ECC_CURVE_FIELD_GY);
+        x += wc_ecc_curve_load_item(dp->Gy, ECC_CURVE_ITEM_DIGITS(5), cnt,
+            &curve->Gy, curve, ECC_CURVE_FIELD_GY);
+    #undef ECC_CURVE_ITEM_DIGITS
 
     /* check for error */
     if (x != 0) {
@@ -1588,7 +1665,9 @@ int ecc_projective_add_point(ecc_point* P, ecc_point* Q, ecc_point* R,
    }
 #endif /* WOLFSSL_SMALL_STACK */
 
-   if ((err = mp_init_multi(t1, t2, NULL, NULL, NULL, NULL)) != MP_OKAY) {
+   err = mp_init_multi_size(MP_MOD_SIZE(modulus), t1, t2, NULL, NULL, NULL,
+                                                                         NULL);
+   if (err != MP_OKAY) {
 #ifdef WOLFSSL_SMALL_STACK
    #ifdef WOLFSSL_SMALL_STACK_CACHE
        if (R->key == NULL)
@@ -1975,7 +2054,9 @@ int ecc_projective_dbl_point(ecc_point *P, ecc_point *R, mp_int* a,
     }
 #endif
 
-   if ((err = mp_init_multi(t1, t2, NULL, NULL, NULL, NULL)) != MP_OKAY) {
+   err = mp_init_multi_size(MP_MOD_SIZE(modulus), t1, t2, NULL, NULL, NULL,
+                                                                         NULL);
+   if (err != MP_OKAY) {
 #ifdef WOLFSSL_SMALL_STACK
 #ifdef WOLFSSL_SMALL_STACK_CACHE
     if (R->key == NULL)
@@ -2333,7 +2414,9 @@ int ecc_map(ecc_point* P, mp_int* modulus, mp_digit mp)
    }
 #endif /* WOLFSSL_SMALL_STACK */
 
-   if ((err = mp_init_multi(t1, t2, NULL, NULL, NULL, NULL)) != MP_OKAY) {
+   err = mp_init_multi_size(MP_MOD_SIZE(modulus), t1, t2, NULL, NULL, NULL,
+                                                                         NULL);
+   if (err != MP_OKAY) {
 #ifdef WOLFSSL_SMALL_STACK
 #ifdef WOLFSSL_SMALL_STACK_CACHE
       if (P->key == NULL)
@@ -2554,7 +2637,7 @@ int wc_ecc_mulmod_ex(mp_int* k, ecc_point *G, ecc_point *R,
        return err;
    }
 
-   if ((err = mp_init(mu)) != MP_OKAY) {
+   if ((err = mp_init_size(mu, MP_MOD_SIZE(modulus))) != MP_OKAY) {
 #ifdef WOLFSSL_SMALL_STACK_CACHE
 #ifdef ALT_ECC_SIZE
        XFREE(key.z, heap, DYNAMIC_TYPE_ECC);
@@ -3454,6 +3537,12 @@ static void wc_ecc_free_async(ecc_key* key)
 
 
 #ifdef HAVE_ECC_DHE
+#if defined(WOLFSSL_SP_ECC_PRECOMP) && !defined(WOLFSSL_ATECC508A) && \
+    !defined(WOLFSSL_CRYPTOCELL)
+static int ecc_shared_secret_ex(ecc_key* private_key, ecc_point* point,
+                                void* precomp, byte* out, word32 *outlen);
+#endif
+
 /**
   Create an ECC shared secret between two keys
   private_key      The private ECC key (heap hint based off of private key)
@@ -3524,6 +3613,10 @@ int wc_ecc_shared_secret(ecc_key* private_key, ecc_key* public_key, byte* out,
         return err;
     }
 
+#elif defined(WOLFSSL_SP_ECC_PRECOMP)
+   /* use the table of multiples of the public key when there is one */
+   err = ecc_shared_secret_ex(private_key, &public_key->pubkey,
+                              public_key->precomp, out, outlen);
 #else
    err = wc_ecc_shared_secret_ex(private_key, &public_key->pubkey, out, outlen);
 #endif /* WOLFSSL_ATECC508A */
@@ -3534,8 +3627,10 @@ int wc_ecc_shared_secret(ecc_key* private_key, ecc_key* public_key, byte* out,
 
 #if !defined(WOLFSSL_ATECC508A) && !defined(WOLFSSL_CRYPTOCELL)
 
+/* precomp is the table of multiples of the point, when there is one */
 static int wc_ecc_shared_secret_gen_sync(ecc_key* private_key, ecc_point* point,
-                               byte* out, word32* outlen, ecc_curve_spec* curve)
+                               void* precomp, byte* out, word32* outlen,
+                               ecc_curve_spec* curve)
 {
     int err;
 #ifndef WOLFSSL_SP_MATH
@@ -3545,7 +3640,11 @@ static int wc_ecc_shared_secret_gen_sync(ecc_key* private_key, ecc_point* point,
     mp_int* k = &private_key->k;
 #ifdef HAVE_ECC_CDH
     mp_int k_lcl;
+#endif
+
+    (void)precomp;
 
+#ifdef HAVE_ECC_CDH
     /* if cofactor flag has been set */
     if (private_key->flags & WC_ECC_FLAG_COFACTOR) {
         mp_digit cofactor = (mp_digit)private_key->dp->cofactor;
@@ -3568,6 +3667,13 @@ static int wc_ecc_shared_secret_gen_sync(ecc_key* private_key, ecc_point* point,
 #ifndef WOLFSSL_SP_NO_256
     if (private_key->idx != ECC_CUSTOM_IDX &&
                                ecc_sets[private_key->idx].id == ECC_SECP256R1) {
+    #ifdef WOLFSSL_SP_ECC_PRECOMP
+        if (precomp != NULL) {
+            err = sp_ecc_secret_gen_table_256(k, point, precomp, out, outlen,
+                                                             private_key->heap);
+        }
+        else
+    #endif
         err = sp_ecc_secret_gen_256(k, point, out, outlen, private_key->heap);
     }
     else
@@ -3675,14 +3781,15 @@ static int wc_ecc_shared_secret_gen_async(ecc_key* private_key,
 #endif
 
     /* use sync in other cases */
-    err = wc_ecc_shared_secret_gen_sync(private_key, point, out, outlen, curve);
+    err = wc_ecc_shared_secret_gen_sync(private_key, point, NULL, out, outlen,
+                                                                        curve);
 
     return err;
 }
 #endif /* WOLFSSL_ASYNC_CRYPT && WC_ASYNC_ENABLE_ECC */
 
-int wc_ecc_shared_secret_gen(ecc_key* private_key, ecc_point* point,
-                                                    byte* out, word32 *outlen)
+static int ecc_shared_secret_gen(ecc_key* private_key, ecc_point* point,
+                                 void* precomp, byte* out, word32 *outlen)
 {
     int err;
     DECLARE_CURVE_SPECS(curve, 2);
@@ -3710,7 +3817,7 @@ int wc_ecc_shared_secret_gen(ecc_key* private_key, ecc_point* point,
     else
 #endif
     {
-        err = wc_ecc_shared_secret_gen_sync(private_key, point,
+        err = wc_ecc_shared_secret_gen_sync(private_key, point, precomp,
             out, outlen, curve);
     }
 
@@ -3720,17 +3827,17 @@ int wc_ecc_shared_secret_gen(ecc_key* private_key, ecc_point* point,
     return err;
 }
 
-/**
- Create an ECC shared secret between private key and public point
- private_key      The private ECC key (heap hint based on private key)
- point            The point to use (public key)
- out              [out] Destination of the shared secret
-                        Conforms to EC-DH from ANSI X9.63
- outlen           [in/out] The max size and resulting size of the shared secret
- return           MP_OKAY if successful
-*/
-int wc_ecc_shared_secret_ex(ecc_key* private_key, ecc_point* point,
-                            byte* out, word32 *outlen)
+int wc_ecc_shared_secret_gen(ecc_key* private_key, ecc_point* point,
+                                                    byte* out, word32 *outlen)
+{
+    return ecc_shared_secret_gen(private_key, point, NULL, out, outlen);
+}
+
+/* Create an ECC shared secret between private key and public point.
+ * precomp is the table of multiples of the point, when there is one.
+ */
+static int ecc_shared_secret_ex(ecc_key* private_key, ecc_point* point,
+                                void* precomp, byte* out, word32 *outlen)
 {
     int err;
 
@@ -3754,7 +3861,8 @@ int wc_ecc_shared_secret_ex(ecc_key* private_key, ecc_point* point,
         case ECC_STATE_SHARED_SEC_GEN:
             private_key->state = ECC_STATE_SHARED_SEC_GEN;
 
-            err = wc_ecc_shared_secret_gen(private_key, point, out, outlen);
+            err = ecc_shared_secret_gen(private_key, point, precomp, out,
+                                                                        outlen);
             if (err < 0) {
                 break;
             }
@@ -3795,6 +3903,21 @@ int wc_ecc_shared_secret_ex(ecc_key* private_key, ecc_point* point,
 
     return err;
 }
+
+/**
+ Create an ECC shared secret between private key and public point
+ private_key      The private ECC key (heap hint based on private key)
+ point            The point to use (public key)
+ out              [out] Destination of the shared secret
+                        Conforms to EC-DH from ANSI X9.63
+ outlen           [in/out] The max size and resulting size of the shared secret
+ return           MP_OKAY if successful
+*/
+int wc_ecc_shared_secret_ex(ecc_key* private_key, ecc_point* point,
+                            byte* out, word32 *outlen)
+{
+    return ecc_shared_secret_ex(private_key, point, NULL, out, outlen);
+}
 #endif /* !WOLFSSL_ATECC508A && !WOLFSSL_CRYPTOCELL */
 #endif /* HAVE_ECC_DHE */
 
@@ -3959,6 +4082,9 @@ static int wc_ecc_make_pub_ex(ecc_key* key, ecc_curve_spec* curveIn,
 
         /* make the public key */
         if (err == MP_OKAY) {
+        #ifdef FP_ECC
+            fp_gen_use(key->dp);
+        #endif
             err = wc_ecc_mulmod_ex(&key->k, base, pub, curve->Af, curve->prime,
                                                                   1, key->heap);
             if (err == MP_MEM) {
@@ -4416,6 +4542,43 @@ int wc_ecc_set_flags(ecc_key* key, word32 flags)
     return 0;
 }
 
+#ifdef WOLFSSL_ECC_PRECOMPUTE
+/* Precompute a table of multiples of the public key.
+ * Signature verification and shared secret generation with the key as the
+ * public key then use the table. The table is read-only and is used without
+ * locking. It is ignored once the public key changes and is freed with the key.
+ * Tables are only generated for P-256 with SP x86_64 code - nothing is done
+ * for other curves.
+ *
+ * key  ECC key with public part.
+ * returns BAD_FUNC_ARG when key is NULL, ECC_BAD_ARG_E when key has no public
+ * part, MEMORY_E when dynamic memory allocation fails and 0 on success.
+ */
+int wc_ecc_precompute(ecc_key* key)
+{
+    int err = 0;
+
+    if (key == NULL) {
+        return BAD_FUNC_ARG;
+    }
+    if (key->type != ECC_PUBLICKEY && key->type != ECC_PRIVATEKEY) {
+        return ECC_BAD_ARG_E;
+    }
+
+#ifdef WOLFSSL_SP_ECC_PRECOMP
+    if (key->idx != ECC_CUSTOM_IDX && ecc_sets[key->idx].id == ECC_SECP256R1) {
+        sp_ecc_precompute_free_256(key->precomp, key->heap);
+        key->precomp = NULL;
+
+        err = sp_ecc_precompute_256(key->pubkey.x, key->pubkey.y,
+                                    key->pubkey.z, &key->precomp, key->heap);
+    }
+#endif
+
+    return err;
+}
+#endif /* WOLFSSL_ECC_PRECOMPUTE */
+
 
 static int wc_ecc_get_curve_order_bit_count(const ecc_set_type* dp)
 {
@@ -5195,6 +5358,11 @@ int wc_ecc_free(ecc_key* key)
         wc_ecc_free_curve(key->dp, key->heap);
 #endif
 
+#ifdef WOLFSSL_SP_ECC_PRECOMP
+    sp_ecc_precompute_free_256(key->precomp, key->heap);
+    key->precomp = NULL;
+#endif
+
     return 0;
 }
 
@@ -5818,8 +5986,14 @@ int wc_ecc_verify_hash_ex(mp_int *r, mp_int *s, const byte* hash,
 
 #if defined(WOLFSSL_SP_MATH) && !defined(FREESCALE_LTC_ECC)
   if (key->idx != ECC_CUSTOM_IDX && ecc_sets[key->idx].id == ECC_SECP256R1) {
+  #ifdef WOLFSSL_SP_ECC_PRECOMP
+      return sp_ecc_verify_table_256(hash, hashlen, key->pubkey.x,
+                  key->pubkey.y, key->pubkey.z, key->precomp, r, s, res,
+                  key->heap);
+  #else
       return sp_ecc_verify_256(hash, hashlen, key->pubkey.x, key->pubkey.y,
                                            key->pubkey.z, r, s, res, key->heap);
+  #endif
   }
   else
       return WC_KEY_SIZE_E;
@@ -5830,9 +6004,16 @@ int wc_ecc_verify_hash_ex(mp_int *r, mp_int *s, const byte* hash,
     if (key->asyncDev.marker != WOLFSSL_ASYNC_MARKER_ECC)
     #endif
     {
-        if (key->idx != ECC_CUSTOM_IDX && ecc_sets[key->idx].id == ECC_SECP256R1)
+        if (key->idx != ECC_CUSTOM_IDX && ecc_sets[key->idx].id == ECC_SECP256R1) {
+        #ifdef WOLFSSL_SP_ECC_PRECOMP
+            return sp_ecc_verify_table_256(hash, hashlen, key->pubkey.x,
+                        key->pubkey.y, key->pubkey.z, key->precomp, r, s, res,
+                        key->heap);
+        #else
             return sp_ecc_verify_256(hash, hashlen, key->pubkey.x, key->pubkey.y,
                                      key->pubkey.z,r, s, res, key->heap);
+        #endif
+        }
     }
 #endif /* WOLFSSL_SP_NO_256 */
 #endif /* WOLFSSL_HAVE_SP_ECC */
@@ -5991,6 +6172,11 @@ int wc_ecc_verify_hash_ex(mp_int *r, mp_int *s, const byte* hash,
    if (err == MP_OKAY)
        err = mp_copy(key->pubkey.z, mQ->z);
 
+#if defined(FP_ECC) && !defined(FREESCALE_LTC_ECC)
+   if (err == MP_OKAY)
+       fp_gen_use(key->dp);
+#endif
+
 #if defined(FREESCALE_LTC_ECC)
    /* use PKHA to compute u1*mG + u2*mQ */
    if (err == MP_OKAY)
@@ -7718,6 +7904,23 @@ static THREAD_LS_T fp_cache_t fp_cache[FP_ENTRIES];
     static wolfSSL_Mutex ecc_fp_lock;
 #endif /* HAVE_THREAD_LS */
 
+/* smallest curve, in bytes, that gets a shared generator table */
+#ifndef FP_ECC_GEN_MIN_SIZE
+    #define FP_ECC_GEN_MIN_SIZE 32
+#endif
+
+/** Shared generator LUT of a built-in curve */
+typedef struct {
+   fp_cache_t cache;           /* generator and its LUT */
+   mp_int     prime;           /* modulus the LUT was built for */
+} fp_gen_t;
+
+/* built by fp_gen_use() on first use of a curve and only read afterwards,
+   published and looked up under fp_gen_lock */
+static fp_gen_t* fp_gen[ECC_SET_COUNT];
+static wolfSSL_Mutex fp_gen_lock;
+static volatile int fp_gen_lock_init = 0;
+
 /* simple table to help direct the generation of the LUT */
 static const struct {
    int ham, terma, termb;
@@ -8300,41 +8503,65 @@ static int find_base(ecc_point* g)
    return x;
 }
 
+/* find the shared generator table of base g on the curve with modulus */
+static fp_cache_t* find_gen(ecc_point* g, mp_int* modulus)
+{
+   unsigned x;
+   fp_cache_t* gen = NULL;
+
+   if (fp_gen_lock_init == 0 || wc_LockMutex(&fp_gen_lock) != 0)
+      return NULL;
+   for (x = 0; x < ECC_SET_COUNT; x++) {
+      if (fp_gen[x] != NULL &&
+          mp_cmp(fp_gen[x]->cache.g->x, g->x) == MP_EQ &&
+          mp_cmp(fp_gen[x]->cache.g->y, g->y) == MP_EQ &&
+          mp_cmp(fp_gen[x]->cache.g->z, g->z) == MP_EQ &&
+          mp_cmp(&fp_gen[x]->prime, modulus) == MP_EQ) {
+         gen = &fp_gen[x]->cache;
+         break;
+      }
+   }
+   wc_UnLockMutex(&fp_gen_lock);
+
+   /* table is not changed until wc_ecc_fp_gen_free() */
+   return gen;
+}
+
 /* add a new base to the cache */
-static int add_entry(int idx, ecc_point *g)
+static int add_entry(fp_cache_t* cache, ecc_point *g)
 {
    unsigned x, y;
 
    /* allocate base and LUT */
-   fp_cache[idx].g = wc_ecc_new_point();
-   if (fp_cache[idx].g == NULL) {
+   cache->g = wc_ecc_new_point();
+   if (cache->g == NULL) {
       return GEN_MEM_ERR;
    }
 
    /* copy x and y */
-   if ((mp_copy(g->x, fp_cache[idx].g->x) != MP_OKAY) ||
-       (mp_copy(g->y, fp_cache[idx].g->y) != MP_OKAY) ||
-       (mp_copy(g->z, fp_cache[idx].g->z) != MP_OKAY)) {
-      wc_ecc_del_point(fp_cache[idx].g);
-      fp_cache[idx].g = NULL;
+   if ((mp_copy(g->x, cache->g->x) != MP_OKAY) ||
+       (mp_copy(g->y, cache->g->y) != MP_OKAY) ||
+       (mp_copy(g->z, cache->g->z) != MP_OKAY)) {
+      wc_ecc_del_point(cache->g);
+      cache->g = NULL;
       return GEN_MEM_ERR;
    }
 
    for (x = 0; x < (1U<<FP_LUT); x++) {
-      fp_cache[idx].LUT[x] = wc_ecc_new_point();
-      if (fp_cache[idx].LUT[x] == NULL) {
+      cache->LUT[x] = wc_ecc_new_point();
+      if (cache->LUT[x] == NULL) {
          for (y = 0; y < x; y++) {
-            wc_ecc_del_point(fp_cache[idx].LUT[y]);
-            fp_cache[idx].LUT[y] = NULL;
+            wc_ecc_del_point(cache->LUT[y]);
+            cache->LUT[y] = NULL;
          }
-         wc_ecc_del_point(fp_cache[idx].g);
-         fp_cache[idx].g         = NULL;
-         fp_cache[idx].lru_count = 0;
+         wc_ecc_del_point(cache->g);
+         cache->g         = NULL;
+         cache->lru_count = 0;
          return GEN_MEM_ERR;
       }
    }
 
-   fp_cache[idx].lru_count = 0;
+   cache->lru_count = 0;
 
    return MP_OKAY;
 }
@@ -8346,8 +8573,8 @@ static int add_entry(int idx, ecc_point *g)
  * The algorithm builds patterns in increasing bit order by first making all
  * single bit input patterns, then all two bit input patterns and so on
  */
-static int build_lut(int idx, mp_int* a, mp_int* modulus, mp_digit mp,
-    mp_int* mu)
+static int build_lut(fp_cache_t* cache, mp_int* a, mp_int* modulus,
+    mp_digit mp, mp_int* mu)
 {
    int err;
    unsigned x, y, bitlen, lut_gap;
@@ -8371,17 +8598,17 @@ static int build_lut(int idx, mp_int* a, mp_int* modulus, mp_digit mp,
     lut_gap = bitlen / FP_LUT;
 
     /* init the mu */
-    err = mp_init_copy(&fp_cache[idx].mu, mu);
+    err = mp_init_copy(&cache->mu, mu);
    }
 
    /* copy base */
    if (err == MP_OKAY) {
-     if ((mp_mulmod(fp_cache[idx].g->x, mu, modulus,
-                  fp_cache[idx].LUT[1]->x) != MP_OKAY) ||
-         (mp_mulmod(fp_cache[idx].g->y, mu, modulus,
-                  fp_cache[idx].LUT[1]->y) != MP_OKAY) ||
-         (mp_mulmod(fp_cache[idx].g->z, mu, modulus,
-                  fp_cache[idx].LUT[1]->z) != MP_OKAY)) {
+     if ((mp_mulmod(cache->g->x, mu, modulus,
+                  cache->LUT[1]->x) != MP_OKAY) ||
+         (mp_mulmod(cache->g->y, mu, modulus,
+                  cache->LUT[1]->y) != MP_OKAY) ||
+         (mp_mulmod(cache->g->z, mu, modulus,
+                  cache->LUT[1]->z) != MP_OKAY)) {
        err = MP_MULMOD_E;
      }
    }
@@ -8390,20 +8617,20 @@ static int build_lut(int idx, mp_int* a, mp_int* modulus, mp_digit mp,
    for (x = 1; x < FP_LUT; x++) {
       if (err != MP_OKAY)
           break;
-      if ((mp_copy(fp_cache[idx].LUT[1<<(x-1)]->x,
-                   fp_cache[idx].LUT[1<<x]->x) != MP_OKAY) ||
-          (mp_copy(fp_cache[idx].LUT[1<<(x-1)]->y,
-                   fp_cache[idx].LUT[1<<x]->y) != MP_OKAY) ||
-          (mp_copy(fp_cache[idx].LUT[1<<(x-1)]->z,
-                   fp_cache[idx].LUT[1<<x]->z) != MP_OKAY)){
+      if ((mp_copy(cache->LUT[1<<(x-1)]->x,
+                   cache->LUT[1<<x]->x) != MP_OKAY) ||
+          (mp_copy(cache->LUT[1<<(x-1)]->y,
+                   cache->LUT[1<<x]->y) != MP_OKAY) ||
+          (mp_copy(cache->LUT[1<<(x-1)]->z,
+                   cache->LUT[1<<x]->z) != MP_OKAY)){
           err = MP_INIT_E;
           break;
       } else {
 
          /* now double it bitlen/FP_LUT times */
          for (y = 0; y < lut_gap; y++) {
-             if ((err = ecc_projective_dbl_point(fp_cache[idx].LUT[1<<x],
-                            fp_cache[idx].LUT[1<<x], a, modulus, mp)) != MP_OKAY) {
+             if ((err = ecc_projective_dbl_point(cache->LUT[1<<x],
+                            cache->LUT[1<<x], a, modulus, mp)) != MP_OKAY) {
                  break;
              }
          }
@@ -8419,9 +8646,9 @@ static int build_lut(int idx, mp_int* a, mp_int* modulus, mp_digit mp,
 
            /* perform the add */
            if ((err = ecc_projective_add_point(
-                           fp_cache[idx].LUT[lut_orders[y].terma],
-                           fp_cache[idx].LUT[lut_orders[y].termb],
-                           fp_cache[idx].LUT[y], a, modulus, mp)) != MP_OKAY) {
+                           cache->LUT[lut_orders[y].terma],
+                           cache->LUT[lut_orders[y].termb],
+                           cache->LUT[y], a, modulus, mp)) != MP_OKAY) {
               break;
            }
        }
@@ -8433,34 +8660,34 @@ static int build_lut(int idx, mp_int* a, mp_int* modulus, mp_digit mp,
            break;
 
        /* convert z to normal from montgomery */
-       err = mp_montgomery_reduce(fp_cache[idx].LUT[x]->z, modulus, mp);
+       err = mp_montgomery_reduce(cache->LUT[x]->z, modulus, mp);
 
        /* invert it */
        if (err == MP_OKAY)
-         err = mp_invmod(fp_cache[idx].LUT[x]->z, modulus,
-                         fp_cache[idx].LUT[x]->z);
+         err = mp_invmod(cache->LUT[x]->z, modulus,
+                         cache->LUT[x]->z);
 
        if (err == MP_OKAY)
          /* now square it */
-         err = mp_sqrmod(fp_cache[idx].LUT[x]->z, modulus, &tmp);
+         err = mp_sqrmod(cache->LUT[x]->z, modulus, &tmp);
 
        if (err == MP_OKAY)
          /* fix x */
-         err = mp_mulmod(fp_cache[idx].LUT[x]->x, &tmp, modulus,
-                         fp_cache[idx].LUT[x]->x);
+         err = mp_mulmod(cache->LUT[x]->x, &tmp, modulus,
+                         cache->LUT[x]->x);
 
        if (err == MP_OKAY)
          /* get 1/z^3 */
-         err = mp_mulmod(&tmp, fp_cache[idx].LUT[x]->z, modulus, &tmp);
+         err = mp_mulmod(&tmp, cache->LUT[x]->z, modulus, &tmp);
 
        if (err == MP_OKAY)
          /* fix y */
-         err = mp_mulmod(fp_cache[idx].LUT[x]->y, &tmp, modulus,
-                         fp_cache[idx].LUT[x]->y);
+         err = mp_mulmod(cache->LUT[x]->y, &tmp, modulus,
+                         cache->LUT[x]->y);
 
        if (err == MP_OKAY)
          /* free z */
-         mp_clear(fp_cache[idx].LUT[x]->z);
+         mp_clear(cache->LUT[x]->z);
    }
 
    mp_clear(&tmp);
@@ -8470,19 +8697,19 @@ static int build_lut(int idx, mp_int* a, mp_int* modulus, mp_digit mp,
 
    /* err cleanup */
    for (y = 0; y < (1U<<FP_LUT); y++) {
-      wc_ecc_del_point(fp_cache[idx].LUT[y]);
-      fp_cache[idx].LUT[y] = NULL;
+      wc_ecc_del_point(cache->LUT[y]);
+      cache->LUT[y] = NULL;
    }
-   wc_ecc_del_point(fp_cache[idx].g);
-   fp_cache[idx].g         = NULL;
-   fp_cache[idx].lru_count = 0;
-   mp_clear(&fp_cache[idx].mu);
+   wc_ecc_del_point(cache->g);
+   cache->g         = NULL;
+   cache->lru_count = 0;
+   mp_clear(&cache->mu);
 
    return err;
 }
 
 /* perform a fixed point ECC mulmod */
-static int accel_fp_mul(int idx, mp_int* k, ecc_point *R, mp_int* a,
+static int accel_fp_mul(fp_cache_t* cache, mp_int* k, ecc_point *R, mp_int* a,
                         mp_int* modulus, mp_digit mp, int map)
 {
 #define KB_SIZE 128
@@ -8588,14 +8815,14 @@ static int accel_fp_mul(int idx, mp_int* k, ecc_point *R, mp_int* a,
 
           /* add if not first, otherwise copy */
           if (!first && z) {
-             if ((err = ecc_projective_add_point(R, fp_cache[idx].LUT[z], R, a,
+             if ((err = ecc_projective_add_point(R, cache->LUT[z], R, a,
                                                      modulus, mp)) != MP_OKAY) {
                 break;
              }
              if (mp_iszero(R->z)) {
                  /* When all zero then should have done an add */
                  if (mp_iszero(R->x) && mp_iszero(R->y)) {
-                     if ((err = ecc_projective_dbl_point(fp_cache[idx].LUT[z],
+                     if ((err = ecc_projective_dbl_point(cache->LUT[z],
                                                R, a, modulus, mp)) != MP_OKAY) {
                          break;
                      }
@@ -8610,7 +8837,7 @@ static int accel_fp_mul(int idx, mp_int* k, ecc_point *R, mp_int* a,
                     if (err != MP_OKAY) {
                        break;
                     }
-                    err = mp_copy(&fp_cache[idx].mu, R->z);
+                    err = mp_copy(&cache->mu, R->z);
                     if (err != MP_OKAY) {
                        break;
                     }
@@ -8618,9 +8845,9 @@ static int accel_fp_mul(int idx, mp_int* k, ecc_point *R, mp_int* a,
                  }
              }
           } else if (z) {
-             if ((mp_copy(fp_cache[idx].LUT[z]->x, R->x) != MP_OKAY) ||
-                 (mp_copy(fp_cache[idx].LUT[z]->y, R->y) != MP_OKAY) ||
-                 (mp_copy(&fp_cache[idx].mu,       R->z) != MP_OKAY)) {
+             if ((mp_copy(cache->LUT[z]->x, R->x) != MP_OKAY) ||
+                 (mp_copy(cache->LUT[z]->y, R->y) != MP_OKAY) ||
+                 (mp_copy(&cache->mu,       R->z) != MP_OKAY)) {
                  err = GEN_MEM_ERR;
                  break;
              }
@@ -8659,7 +8886,7 @@ done:
 #ifdef ECC_SHAMIR
 #ifndef WOLFSSL_SP_MATH
 /* perform a fixed point ECC mulmod */
-static int accel_fp_mul2add(int idx1, int idx2,
+static int accel_fp_mul2add(fp_cache_t* cacheA, fp_cache_t* cacheB,
                             mp_int* kA, mp_int* kB,
                             ecc_point *R, mp_int* a,
                             mp_int* modulus, mp_digit mp)
@@ -8826,7 +9053,7 @@ static int accel_fp_mul2add(int idx1, int idx2,
           /* add if not first, otherwise copy */
           if (!first) {
              if (zA) {
-                if ((err = ecc_projective_add_point(R, fp_cache[idx1].LUT[zA],
+                if ((err = ecc_projective_add_point(R, cacheA->LUT[zA],
                                                R, a, modulus, mp)) != MP_OKAY) {
                    break;
                 }
@@ -8834,7 +9061,7 @@ static int accel_fp_mul2add(int idx1, int idx2,
                     /* When all zero then should have done an add */
                     if (mp_iszero(R->x) && mp_iszero(R->y)) {
                         if ((err = ecc_projective_dbl_point(
-                                                  fp_cache[idx1].LUT[zA], R,
+                                                  cacheA->LUT[zA], R,
                                                   a, modulus, mp)) != MP_OKAY) {
                             break;
                         }
@@ -8849,7 +9076,7 @@ static int accel_fp_mul2add(int idx1, int idx2,
                        if (err != MP_OKAY) {
                           break;
                        }
-                       err = mp_copy(&fp_cache[idx1].mu, R->z);
+                       err = mp_copy(&cacheA->mu, R->z);
                        if (err != MP_OKAY) {
                           break;
                        }
@@ -8859,7 +9086,7 @@ static int accel_fp_mul2add(int idx1, int idx2,
              }
 
              if (zB) {
-                if ((err = ecc_projective_add_point(R, fp_cache[idx2].LUT[zB],
+                if ((err = ecc_projective_add_point(R, cacheB->LUT[zB],
                                                R, a, modulus, mp)) != MP_OKAY) {
                    break;
                 }
@@ -8867,7 +9094,7 @@ static int accel_fp_mul2add(int idx1, int idx2,
                     /* When all zero then should have done an add */
                     if (mp_iszero(R->x) && mp_iszero(R->y)) {
                         if ((err = ecc_projective_dbl_point(
-                                                  fp_cache[idx2].LUT[zB], R,
+                                                  cacheB->LUT[zB], R,
                                                   a, modulus, mp)) != MP_OKAY) {
                             break;
                         }
@@ -8882,7 +9109,7 @@ static int accel_fp_mul2add(int idx1, int idx2,
                        if (err != MP_OKAY) {
                           break;
                        }
-                       err = mp_copy(&fp_cache[idx2].mu, R->z);
+                       err = mp_copy(&cacheB->mu, R->z);
                        if (err != MP_OKAY) {
                           break;
                        }
@@ -8892,9 +9119,9 @@ static int accel_fp_mul2add(int idx1, int idx2,
              }
           } else {
              if (zA) {
-                 if ((mp_copy(fp_cache[idx1].LUT[zA]->x, R->x) != MP_OKAY) ||
-                     (mp_copy(fp_cache[idx1].LUT[zA]->y, R->y) != MP_OKAY) ||
-                     (mp_copy(&fp_cache[idx1].mu,        R->z) != MP_OKAY)) {
+                 if ((mp_copy(cacheA->LUT[zA]->x, R->x) != MP_OKAY) ||
+                     (mp_copy(cacheA->LUT[zA]->y, R->y) != MP_OKAY) ||
+                     (mp_copy(&cacheA->mu,        R->z) != MP_OKAY)) {
                      err = GEN_MEM_ERR;
                      break;
                  }
@@ -8903,14 +9130,14 @@ static int accel_fp_mul2add(int idx1, int idx2,
              if (zB && first == 0) {
                 if (zB) {
                    if ((err = ecc_projective_add_point(R,
-                        fp_cache[idx2].LUT[zB], R, a, modulus, mp)) != MP_OKAY){
+                        cacheB->LUT[zB], R, a, modulus, mp)) != MP_OKAY){
                       break;
                    }
                    if (mp_iszero(R->z)) {
                        /* When all zero then should have done an add */
                        if (mp_iszero(R->x) && mp_iszero(R->y)) {
                            if ((err = ecc_projective_dbl_point(
-                                                  fp_cache[idx2].LUT[zB], R,
+                                                  cacheB->LUT[zB], R,
                                                   a, modulus, mp)) != MP_OKAY) {
                                break;
                            }
@@ -8925,7 +9152,7 @@ static int accel_fp_mul2add(int idx1, int idx2,
                           if (err != MP_OKAY) {
                              break;
                           }
-                          err = mp_copy(&fp_cache[idx2].mu, R->z);
+                          err = mp_copy(&cacheB->mu, R->z);
                           if (err != MP_OKAY) {
                              break;
                           }
@@ -8934,9 +9161,9 @@ static int accel_fp_mul2add(int idx1, int idx2,
                    }
                 }
              } else if (zB && first == 1) {
-                 if ((mp_copy(fp_cache[idx2].LUT[zB]->x, R->x) != MP_OKAY) ||
-                     (mp_copy(fp_cache[idx2].LUT[zB]->y, R->y) != MP_OKAY) ||
-                     (mp_copy(&fp_cache[idx2].mu,        R->z) != MP_OKAY)) {
+                 if ((mp_copy(cacheB->LUT[zB]->x, R->x) != MP_OKAY) ||
+                     (mp_copy(cacheB->LUT[zB]->y, R->y) != MP_OKAY) ||
+                     (mp_copy(&cacheB->mu,        R->z) != MP_OKAY)) {
                      err = GEN_MEM_ERR;
                      break;
                  }
@@ -8993,6 +9220,10 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
    int  idx1 = -1, idx2 = -1, err = MP_OKAY, mpInit = 0;
    mp_digit mp;
    mp_int   mu;
+   fp_cache_t* cacheA;
+
+   /* shared generator table is used in place of a cache entry for A */
+   cacheA = find_gen(A, modulus);
 
    err = mp_init(&mu);
    if (err != MP_OKAY)
@@ -9007,19 +9238,21 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
       return BAD_MUTEX_E;
 #endif /* HAVE_THREAD_LS */
 
-      /* find point */
-      idx1 = find_base(A);
+      if (cacheA == NULL) {
+         /* find point */
+         idx1 = find_base(A);
 
-      /* no entry? */
-      if (idx1 == -1) {
-         /* find hole and add it */
-         if ((idx1 = find_hole()) >= 0) {
-            err = add_entry(idx1, A);
+         /* no entry? */
+         if (idx1 == -1) {
+            /* find hole and add it */
+            if ((idx1 = find_hole()) >= 0) {
+               err = add_entry(&fp_cache[idx1], A);
+            }
+         }
+         if (err == MP_OKAY && idx1 != -1) {
+            /* increment LRU */
+            ++(fp_cache[idx1].lru_count);
          }
-      }
-      if (err == MP_OKAY && idx1 != -1) {
-         /* increment LRU */
-         ++(fp_cache[idx1].lru_count);
       }
 
       if (err == MP_OKAY)
@@ -9031,7 +9264,7 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
         if (idx2 == -1) {
            /* find hole and add it */
            if ((idx2 = find_hole()) >= 0)
-              err = add_entry(idx2, B);
+              err = add_entry(&fp_cache[idx2], B);
          }
       }
 
@@ -9053,7 +9286,7 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
 
            if (err == MP_OKAY)
              /* build the LUT */
-               err = build_lut(idx1, a, modulus, mp, &mu);
+               err = build_lut(&fp_cache[idx1], a, modulus, mp, &mu);
         }
       }
 
@@ -9071,20 +9304,25 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
 
             if (err == MP_OKAY)
             /* build the LUT */
-              err = build_lut(idx2, a, modulus, mp, &mu);
+              err = build_lut(&fp_cache[idx2], a, modulus, mp, &mu);
         }
       }
 
 
+      if (err == MP_OKAY && cacheA == NULL && idx1 >= 0 &&
+                                            fp_cache[idx1].lru_count >= 2) {
+         cacheA = &fp_cache[idx1];
+      }
+
       if (err == MP_OKAY) {
-        if (idx1 >=0 && idx2 >= 0 && fp_cache[idx1].lru_count >= 2 &&
-                                     fp_cache[idx2].lru_count >= 2) {
+        if (cacheA != NULL && idx2 >= 0 && fp_cache[idx2].lru_count >= 2) {
            if (mpInit == 0) {
               /* compute mp */
               err = mp_montgomery_setup(modulus, &mp);
            }
            if (err == MP_OKAY)
-             err = accel_fp_mul2add(idx1, idx2, kA, kB, C, a, modulus, mp);
+             err = accel_fp_mul2add(cacheA, &fp_cache[idx2], kA, kB, C, a,
+                                                                   modulus, mp);
         } else {
            err = normal_ecc_mul2add(A, kA, B, kB, C, a, modulus, heap);
         }
@@ -9118,11 +9356,21 @@ int wc_ecc_mulmod_ex(mp_int* k, ecc_point *G, ecc_point *R, mp_int* a,
    mp_digit mp;
    mp_int   mu;
    int      mpSetup = 0;
+   fp_cache_t* gen;
 
    if (k == NULL || G == NULL || R == NULL || a == NULL || modulus == NULL) {
        return ECC_BAD_ARG_E;
    }
 
+   /* generator of a built-in curve - shared read-only table */
+   gen = find_gen(G, modulus);
+   if (gen != NULL) {
+      err = mp_montgomery_setup(modulus, &mp);
+      if (err == MP_OKAY)
+         err = accel_fp_mul(gen, k, R, a, modulus, mp, map);
+      return err;
+   }
+
    if (mp_init(&mu) != MP_OKAY)
        return MP_INIT_E;
 
@@ -9145,7 +9393,7 @@ int wc_ecc_mulmod_ex(mp_int* k, ecc_point *G, ecc_point *R, mp_int* a,
          idx = find_hole();
 
          if (idx >= 0)
-            err = add_entry(idx, G);
+            err = add_entry(&fp_cache[idx], G);
       }
       if (err == MP_OKAY && idx >= 0) {
          /* increment LRU */
@@ -9167,7 +9415,7 @@ int wc_ecc_mulmod_ex(mp_int* k, ecc_point *G, ecc_point *R, mp_int* a,
 
            if (err == MP_OKAY)
              /* build the LUT */
-             err = build_lut(idx, a, modulus, mp, &mu);
+             err = build_lut(&fp_cache[idx], a, modulus, mp, &mu);
         }
       }
 
@@ -9178,7 +9426,7 @@ int wc_ecc_mulmod_ex(mp_int* k, ecc_point *G, ecc_point *R, mp_int* a,
               err = mp_montgomery_setup(modulus, &mp);
            }
            if (err == MP_OKAY)
-             err = accel_fp_mul(idx, k, R, a, modulus, mp, map);
+             err = accel_fp_mul(&fp_cache[idx], k, R, a, modulus, mp, map);
         } else {
            err = normal_ecc_mulmod(k, G, R, a, modulus, map, heap);
         }
@@ -9199,6 +9447,141 @@ int wc_ecc_mulmod_ex(mp_int* k, ecc_point *G, ecc_point *R, mp_int* a,
 #endif
 }
 
+#ifndef WOLFSSL_SP_MATH
+/* free a shared generator table */
+static void fp_gen_free_entry(fp_gen_t* gen)
+{
+   unsigned x;
+   for (x = 0; x < (1U<<FP_LUT); x++) {
+      wc_ecc_del_point(gen->cache.LUT[x]);
+   }
+   wc_ecc_del_point(gen->cache.g);
+   mp_clear(&gen->cache.mu);
+   mp_clear(&gen->prime);
+   XFREE(gen, NULL, DYNAMIC_TYPE_ECC);
+}
+
+/* build the shared generator table of a built-in curve */
+static int fp_gen_build(const ecc_set_type* dp, ecc_point* G, mp_int* mu,
+                        fp_gen_t** pGen)
+{
+   int err;
+   mp_digit mp;
+   fp_gen_t* gen;
+   DECLARE_CURVE_SPECS(curve, ECC_CURVE_FIELD_COUNT);
+
+   ALLOC_CURVE_SPECS(ECC_CURVE_FIELD_COUNT);
+
+   gen = (fp_gen_t*)XMALLOC(sizeof(fp_gen_t), NULL, DYNAMIC_TYPE_ECC);
+   if (gen == NULL) {
+      FREE_CURVE_SPECS();
+      return MEMORY_E;
+   }
+   XMEMSET(gen, 0, sizeof(fp_gen_t));
+
+   err = wc_ecc_curve_load(dp, &curve, ECC_CURVE_FIELD_ALL);
+   if (err == MP_OKAY)
+      err = mp_init_copy(&gen->prime, curve->prime);
+   if (err == MP_OKAY)
+      err = mp_copy(curve->Gx, G->x);
+   if (err == MP_OKAY)
+      err = mp_copy(curve->Gy, G->y);
+   if (err == MP_OKAY)
+      err = mp_set(G->z, 1);
+   if (err == MP_OKAY)
+      err = add_entry(&gen->cache, G);
+   if (err == MP_OKAY)
+      err = mp_montgomery_setup(curve->prime, &mp);
+   if (err == MP_OKAY)
+      err = mp_montgomery_calc_normalization(mu, curve->prime);
+   if (err == MP_OKAY)
+      err = build_lut(&gen->cache, curve->Af, curve->prime, mp, mu);
+
+   wc_ecc_curve_free(curve);
+   FREE_CURVE_SPECS();
+
+   if (err == MP_OKAY)
+      *pGen = gen;
+   else
+      fp_gen_free_entry(gen);
+
+   return err;
+}
+#endif
+
+#ifndef WOLFSSL_SP_MATH
+/* build the shared generator table of curve dp if not built yet, called
+   where the curve is known before its generator is multiplied. A failure
+   leaves the generator to the fixed point cache. */
+static void fp_gen_use(const ecc_set_type* dp)
+{
+   int        x;
+   mp_int     mu;
+   ecc_point* G;
+
+   if (dp == NULL || dp->size < FP_ECC_GEN_MIN_SIZE || fp_gen_lock_init == 0)
+      return;
+#ifdef WOLFSSL_HAVE_SP_ECC
+   /* P-256 is calculated with SP code and its own tables */
+   if (dp->id == ECC_SECP256R1)
+      return;
+#endif
+   x = wc_ecc_get_curve_idx(dp->id);
+   if (x < 0 || &ecc_sets[x] != dp)
+      return;
+
+   if (wc_LockMutex(&fp_gen_lock) != 0)
+      return;
+   if (fp_gen[x] == NULL) {
+      G = wc_ecc_new_point();
+      if (G != NULL) {
+         if (mp_init(&mu) == MP_OKAY) {
+            (void)fp_gen_build(dp, G, &mu, &fp_gen[x]);
+            mp_clear(&mu);
+         }
+         wc_ecc_del_point(G);
+      }
+   }
+   wc_UnLockMutex(&fp_gen_lock);
+}
+#endif
+
+/** Prepare the shared generator tables of the built-in curves of at least
+    FP_ECC_GEN_MIN_SIZE bytes. Called once from wolfCrypt_Init(); each table
+    is built on first use of its curve.
+    return MP_OKAY on success
+*/
+int wc_ecc_fp_gen_init(void)
+{
+#ifndef WOLFSSL_SP_MATH
+   if (fp_gen_lock_init == 0) {
+      if (wc_InitMutex(&fp_gen_lock) != 0)
+         return BAD_MUTEX_E;
+      fp_gen_lock_init = 1;
+   }
+#endif
+   return 0;
+}
+
+/** Free the shared generator tables */
+void wc_ecc_fp_gen_free(void)
+{
+#ifndef WOLFSSL_SP_MATH
+   unsigned x;
+
+   if (fp_gen_lock_init == 0)
+      return;
+   for (x = 0; x < ECC_SET_COUNT; x++) {
+      if (fp_gen[x] != NULL) {
+         fp_gen_free_entry(fp_gen[x]);
+         fp_gen[x] = NULL;
+      }
+   }
+   wc_FreeMutex(&fp_gen_lock);
+   fp_gen_lock_init = 0;
+#endif
+}
+
 #ifndef WOLFSSL_SP_MATH
 /* helper function for freeing the cache ...
    must be called with the cache mutex locked */
@@ -0,0 +1,791 @@
+/* ecc_curve_digits.i
+ *
+ * Copyright (C) 2006-2019 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ */
+
+
+
+/* Curve parameters of ecc_sets[] as little-endian fast math digits.
+ *
+ * Each curve has prime, A, B, order, Gx and Gy in that order, each taking the
+ * same number of 64-bit words. Generated from the hex strings in ecc_sets[]
+ * and ***MUST*** be kept in the same order with the same conditionals.
+ */
+
+#if SIZEOF_FP_DIGIT == 8
+    #define ECC_DIGITS(hi, lo)     (((fp_digit)(hi) << 32) | (fp_digit)(lo))
+    #define ECC_DIGITS_PER_WORD    1
+#else
+    #define ECC_DIGITS(hi, lo)     (fp_digit)(lo), (fp_digit)(hi)
+    #define ECC_DIGITS_PER_WORD    2
+#endif
+
+typedef struct ecc_curve_digits_t {
+    int             id;     /* curve ID, as in ecc_sets[]           */
+    int             words;  /* 64-bit words in each parameter       */
+    const fp_digit* digits; /* prime, A, B, order, Gx, Gy           */
+} ecc_curve_digits_t;
+
+#ifdef ECC112
+    #ifndef NO_ECC_SECP
+    static const fp_digit ecc_digits_secp112r1[] = {
+        /* prime */
+        ECC_DIGITS(0x5e668076, 0xbead208b), ECC_DIGITS(0x0000db7c, 0x2abf62e3),
+        /* A */
+        ECC_DIGITS(0x5e668076, 0xbead2088), ECC_DIGITS(0x0000db7c, 0x2abf62e3),
+        /* B */
+        ECC_DIGITS(0x16eede89, 0x11702b22), ECC_DIGITS(0x0000659e, 0xf8ba0439),
+        /* order */
+        ECC_DIGITS(0x5e7628df, 0xac6561c5), ECC_DIGITS(0x0000db7c, 0x2abf62e3),
+        /* Gx */
+        ECC_DIGITS(0x5ee76b55, 0xf9c2f098), ECC_DIGITS(0x00000948, 0x7239995a),
+        /* Gy */
+        ECC_DIGITS(0xc0a23e0e, 0x0ff77500), ECC_DIGITS(0x0000a89c, 0xe5af8724),
+    };
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_SECPR2
+    static const fp_digit ecc_digits_secp112r2[] = {
+        /* prime */
+        ECC_DIGITS(0x5e668076, 0xbead208b), ECC_DIGITS(0x0000db7c, 0x2abf62e3),
+        /* A */
+        ECC_DIGITS(0x8a0aaaf6, 0x5c0ef02c), ECC_DIGITS(0x00006127, 0xc24c05f3),
+        /* B */
+        ECC_DIGITS(0xed74fcc3, 0x4c85d709), ECC_DIGITS(0x000051de, 0xf1815db5),
+        /* order */
+        ECC_DIGITS(0xd7597ca1, 0x0520d04b), ECC_DIGITS(0x000036df, 0x0aafd8b8),
+        /* Gx */
+        ECC_DIGITS(0xb4e1649d, 0xd0928643), ECC_DIGITS(0x00004ba3, 0x0ab5e892),
+        /* Gy */
+        ECC_DIGITS(0x3747def3, 0x6e956e97), ECC_DIGITS(0x0000adcd, 0x46f5882e),
+    };
+    #endif /* HAVE_ECC_SECPR2 */
+#endif /* ECC112 */
+#ifdef ECC128
+    #ifndef NO_ECC_SECP
+    static const fp_digit ecc_digits_secp128r1[] = {
+        /* prime */
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xfffffffd, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0xffffffff, 0xfffffffc), ECC_DIGITS(0xfffffffd, 0xffffffff),
+        /* B */
+        ECC_DIGITS(0xd824993c, 0x2cee5ed3), ECC_DIGITS(0xe87579c1, 0x1079f43d),
+        /* order */
+        ECC_DIGITS(0x75a30d1b, 0x9038a115), ECC_DIGITS(0xfffffffe, 0x00000000),
+        /* Gx */
+        ECC_DIGITS(0x0c28607c, 0xa52c5b86), ECC_DIGITS(0x161ff752, 0x8b899b2d),
+        /* Gy */
+        ECC_DIGITS(0xc02da292, 0xdded7a83), ECC_DIGITS(0xcf5ac839, 0x5bafeb13),
+    };
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_SECPR2
+    static const fp_digit ecc_digits_secp128r2[] = {
+        /* prime */
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xfffffffd, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0xbf59cc9b, 0xbff9aee1), ECC_DIGITS(0xd6031998, 0xd1b3bbfe),
+        /* B */
+        ECC_DIGITS(0xdc2c6558, 0xbb6d8a5d), ECC_DIGITS(0x5eeefca3, 0x80d02919),
+        /* order */
+        ECC_DIGITS(0xbe002472, 0x0613b5a3), ECC_DIGITS(0x3fffffff, 0x7fffffff),
+        /* Gx */
+        ECC_DIGITS(0xe6fb32a7, 0xcdebc140), ECC_DIGITS(0x7b6aa5d8, 0x5e572983),
+        /* Gy */
+        ECC_DIGITS(0x7106fe80, 0x5fc34b44), ECC_DIGITS(0x27b6916a, 0x894d3aee),
+    };
+    #endif /* HAVE_ECC_SECPR2 */
+#endif /* ECC128 */
+#ifdef ECC160
+    #ifndef NO_ECC_SECP
+    static const fp_digit ecc_digits_secp160r1[] = {
+        /* prime */
+        ECC_DIGITS(0xffffffff, 0x7fffffff), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0x00000000, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0xffffffff, 0x7ffffffc), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0x00000000, 0xffffffff),
+        /* B */
+        ECC_DIGITS(0x81d4d4ad, 0xc565fa45), ECC_DIGITS(0x54bd7a8b, 0x65acf89f),
+        ECC_DIGITS(0x00000000, 0x1c97befc),
+        /* order */
+        ECC_DIGITS(0xf927aed3, 0xca752257), ECC_DIGITS(0x00000000, 0x0001f4c8),
+        ECC_DIGITS(0x00000001, 0x00000000),
+        /* Gx */
+        ECC_DIGITS(0x68c38bb9, 0x13cbfc82), ECC_DIGITS(0x8ef57328, 0x46646989),
+        ECC_DIGITS(0x00000000, 0x4a96b568),
+        /* Gy */
+        ECC_DIGITS(0x04235137, 0x7ac5fb32), ECC_DIGITS(0x3168947d, 0x59dcc912),
+        ECC_DIGITS(0x00000000, 0x23a62855),
+    };
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_SECPR2
+    static const fp_digit ecc_digits_secp160r2[] = {
+        /* prime */
+        ECC_DIGITS(0xfffffffe, 0xffffac73), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0x00000000, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0xfffffffe, 0xffffac70), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0x00000000, 0xffffffff),
+        /* B */
+        ECC_DIGITS(0x04664d5a, 0xf50388ba), ECC_DIGITS(0xfb59eb8b, 0xab572749),
+        ECC_DIGITS(0x00000000, 0xb4e134d3),
+        /* order */
+        ECC_DIGITS(0xe786a818, 0xf3a1a16b), ECC_DIGITS(0x00000000, 0x0000351e),
+        ECC_DIGITS(0x00000001, 0x00000000),
+        /* Gx */
+        ECC_DIGITS(0x30f7199d, 0x3144ce6d), ECC_DIGITS(0x293a117e, 0x1f4ff11b),
+        ECC_DIGITS(0x00000000, 0x52dcb034),
+        /* Gy */
+        ECC_DIGITS(0xf9982cfe, 0xa7d43f2e), ECC_DIGITS(0xe331f296, 0xe071fa0d),
+        ECC_DIGITS(0x00000000, 0xfeaffef2),
+    };
+    #endif /* HAVE_ECC_SECPR2 */
+    #ifdef HAVE_ECC_KOBLITZ
+    static const fp_digit ecc_digits_secp160k1[] = {
+        /* prime */
+        ECC_DIGITS(0xfffffffe, 0xffffac73), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0x00000000, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0x00000000, 0x00000000), ECC_DIGITS(0x00000000, 0x00000000),
+        ECC_DIGITS(0x00000000, 0x00000000),
+        /* B */
+        ECC_DIGITS(0x00000000, 0x00000007), ECC_DIGITS(0x00000000, 0x00000000),
+        ECC_DIGITS(0x00000000, 0x00000000),
+        /* order */
+        ECC_DIGITS(0x16dfab9a, 0xca16b6b3), ECC_DIGITS(0x00000000, 0x0001b8fa),
+        ECC_DIGITS(0x00000001, 0x00000000),
+        /* Gx */
+        ECC_DIGITS(0x3036f4f5, 0xdd4d7ebb), ECC_DIGITS(0xe37aa192, 0xa4019e76),
+        ECC_DIGITS(0x00000000, 0x3b4c382c),
+        /* Gy */
+        ECC_DIGITS(0x531733c3, 0xf03c4fee), ECC_DIGITS(0x318fdced, 0x6bc28286),
+        ECC_DIGITS(0x00000000, 0x938cf935),
+    };
+    #endif /* HAVE_ECC_KOBLITZ */
+    #ifdef HAVE_ECC_BRAINPOOL
+    static const fp_digit ecc_digits_brainpoolp160r1[] = {
+        /* prime */
+        ECC_DIGITS(0x95b3d813, 0x9515620f), ECC_DIGITS(0x737059dc, 0x60dfc7ad),
+        ECC_DIGITS(0x00000000, 0xe95e4a5f),
+        /* A */
+        ECC_DIGITS(0xda745d97, 0xe8f7c300), ECC_DIGITS(0xa280eb74, 0xe2be61ba),
+        ECC_DIGITS(0x00000000, 0x340e7be2),
+        /* B */
+        ECC_DIGITS(0xbdec95c8, 0xd8675e58), ECC_DIGITS(0x95423412, 0x134faa2d),
+        ECC_DIGITS(0x00000000, 0x1e589a85),
+        /* order */
+        ECC_DIGITS(0xd4502940, 0x9e60fc09), ECC_DIGITS(0x737059dc, 0x60df5991),
+        ECC_DIGITS(0x00000000, 0xe95e4a5f),
+        /* Gx */
+        ECC_DIGITS(0x31eb5af7, 0xbdbcdbc3), ECC_DIGITS(0xea3f6a4f, 0x62938c46),
+        ECC_DIGITS(0x00000000, 0xbed5af16),
+        /* Gy */
+        ECC_DIGITS(0x669c9763, 0x16da6321), ECC_DIGITS(0x7a1a8ec3, 0x38f94741),
+        ECC_DIGITS(0x00000000, 0x1667cb47),
+    };
+    #endif /* HAVE_ECC_BRAINPOOL */
+#endif /* ECC160 */
+#ifdef ECC192
+    #ifndef NO_ECC_SECP
+    static const fp_digit ecc_digits_secp192r1[] = {
+        /* prime */
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0xfffffffe),
+        ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0xffffffff, 0xfffffffc), ECC_DIGITS(0xffffffff, 0xfffffffe),
+        ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* B */
+        ECC_DIGITS(0xfeb8deec, 0xc146b9b1), ECC_DIGITS(0x0fa7e9ab, 0x72243049),
+        ECC_DIGITS(0x64210519, 0xe59c80e7),
+        /* order */
+        ECC_DIGITS(0x146bc9b1, 0xb4d22831), ECC_DIGITS(0xffffffff, 0x99def836),
+        ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* Gx */
+        ECC_DIGITS(0xf4ff0afd, 0x82ff1012), ECC_DIGITS(0x7cbf20eb, 0x43a18800),
+        ECC_DIGITS(0x188da80e, 0xb03090f6),
+        /* Gy */
+        ECC_DIGITS(0x73f977a1, 0x1e794811), ECC_DIGITS(0x631011ed, 0x6b24cdd5),
+        ECC_DIGITS(0x07192b95, 0xffc8da78),
+    };
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_SECPR2
+    static const fp_digit ecc_digits_prime192v2[] = {
+        /* prime */
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0xfffffffe),
+        ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0xffffffff, 0xfffffffc), ECC_DIGITS(0xffffffff, 0xfffffffe),
+        ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* B */
+        ECC_DIGITS(0x0c393aa2, 0x1668d953), ECC_DIGITS(0xe49c0d63, 0x64a4e598),
+        ECC_DIGITS(0xcc22d6df, 0xb95c6b25),
+        /* order */
+        ECC_DIGITS(0xdc804186, 0x48d8dd31), ECC_DIGITS(0xfffffffe, 0x5fb1a724),
+        ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* Gx */
+        ECC_DIGITS(0xc072ad69, 0x6f48034a), ECC_DIGITS(0xf2de7769, 0xcfe9c989),
+        ECC_DIGITS(0xeea2bae7, 0xe1497842),
+        /* Gy */
+        ECC_DIGITS(0xb0847de9, 0x70b2de15), ECC_DIGITS(0x672bb82a, 0x083df2f2),
+        ECC_DIGITS(0x6574d11d, 0x69b6ec7a),
+    };
+    #endif /* HAVE_ECC_SECPR2 */
+    #ifdef HAVE_ECC_SECPR3
+    static const fp_digit ecc_digits_prime192v3[] = {
+        /* prime */
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0xfffffffe),
+        ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0xffffffff, 0xfffffffc), ECC_DIGITS(0xffffffff, 0xfffffffe),
+        ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* B */
+        ECC_DIGITS(0xa7d46225, 0x6bd56916), ECC_DIGITS(0xa7423dae, 0xccc94760),
+        ECC_DIGITS(0x22123dc2, 0x395a05ca),
+        /* order */
+        ECC_DIGITS(0xc83f4294, 0xf640ec13), ECC_DIGITS(0xffffffff, 0x7a62d031),
+        ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* Gx */
+        ECC_DIGITS(0x8b4aee8e, 0x228f1896), ECC_DIGITS(0xa1783716, 0x588dce2b),
+        ECC_DIGITS(0x7d297781, 0x00c65a1d),
+        /* Gy */
+        ECC_DIGITS(0x978aca76, 0x48a943b0), ECC_DIGITS(0x4b49dcb6, 0x6a6dc8f9),
+        ECC_DIGITS(0x38a90f22, 0x63733733),
+    };
+    #endif /* HAVE_ECC_SECPR3 */
+    #ifdef HAVE_ECC_KOBLITZ
+    static const fp_digit ecc_digits_secp192k1[] = {
+        /* prime */
+        ECC_DIGITS(0xfffffffe, 0xffffee37), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0x00000000, 0x00000000), ECC_DIGITS(0x00000000, 0x00000000),
+        ECC_DIGITS(0x00000000, 0x00000000),
+        /* B */
+        ECC_DIGITS(0x00000000, 0x00000003), ECC_DIGITS(0x00000000, 0x00000000),
+        ECC_DIGITS(0x00000000, 0x00000000),
+        /* order */
+        ECC_DIGITS(0x0f69466a, 0x74defd8d), ECC_DIGITS(0xfffffffe, 0x26f2fc17),
+        ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* Gx */
+        ECC_DIGITS(0x1da5d1b1, 0xeae06c7d), ECC_DIGITS(0x26b07d02, 0x80b7f434),
+        ECC_DIGITS(0xdb4ff10e, 0xc057e9ae),
+        /* Gy */
+        ECC_DIGITS(0x4082aa88, 0xd95e2f9d), ECC_DIGITS(0x844163d0, 0x15be8634),
+        ECC_DIGITS(0x9b2f2f6d, 0x9c5628a7),
+    };
+    #endif /* HAVE_ECC_KOBLITZ */
+    #ifdef HAVE_ECC_BRAINPOOL
+    static const fp_digit ecc_digits_brainpoolp192r1[] = {
+        /* prime */
+        ECC_DIGITS(0x8fce476d, 0xe1a86297), ECC_DIGITS(0xa7a34630, 0x93d18db7),
+        ECC_DIGITS(0xc302f41d, 0x932a36cd),
+        /* A */
+        ECC_DIGITS(0xcae040e5, 0xc69a28ef), ECC_DIGITS(0x9c39c031, 0xfe8685c1),
+        ECC_DIGITS(0x6a911740, 0x76b1e0e1),
+        /* B */
+        ECC_DIGITS(0xca7ef414, 0x6fbf25c9), ECC_DIGITS(0xdc721d04, 0x4f4496bc),
+        ECC_DIGITS(0x469a28ef, 0x7c28cca3),
+        /* order */
+        ECC_DIGITS(0x5be8f102, 0x9ac4acc1), ECC_DIGITS(0xa7a3462f, 0x9e9e916b),
+        ECC_DIGITS(0xc302f41d, 0x932a36cd),
+        /* Gx */
+        ECC_DIGITS(0x0a2f5c48, 0x53375fd6), ECC_DIGITS(0x53b033c5, 0x6cb0f090),
+        ECC_DIGITS(0xc0a0647e, 0xaab6a487),
+        /* Gy */
+        ECC_DIGITS(0xe6773fa2, 0xfa299b8f), ECC_DIGITS(0x8b5f4828, 0xc1490002),
+        ECC_DIGITS(0x14b69086, 0x6abd5bb8),
+    };
+    #endif /* HAVE_ECC_BRAINPOOL */
+#endif /* ECC192 */
+#ifdef ECC224
+    #ifndef NO_ECC_SECP
+    static const fp_digit ecc_digits_secp224r1[] = {
+        /* prime */
+        ECC_DIGITS(0x00000000, 0x00000001), ECC_DIGITS(0xffffffff, 0x00000000),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0x00000000, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0xffffffff, 0xfffffffe), ECC_DIGITS(0xfffffffe, 0xffffffff),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0x00000000, 0xffffffff),
+        /* B */
+        ECC_DIGITS(0x270b3943, 0x2355ffb4), ECC_DIGITS(0x5044b0b7, 0xd7bfd8ba),
+        ECC_DIGITS(0x0c04b3ab, 0xf5413256), ECC_DIGITS(0x00000000, 0xb4050a85),
+        /* order */
+        ECC_DIGITS(0x13dd2945, 0x5c5c2a3d), ECC_DIGITS(0xffff16a2, 0xe0b8f03e),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0x00000000, 0xffffffff),
+        /* Gx */
+        ECC_DIGITS(0x343280d6, 0x115c1d21), ECC_DIGITS(0x4a03c1d3, 0x56c21122),
+        ECC_DIGITS(0x6bb4bf7f, 0x321390b9), ECC_DIGITS(0x00000000, 0xb70e0cbd),
+        /* Gy */
+        ECC_DIGITS(0x44d58199, 0x85007e34), ECC_DIGITS(0xcd4375a0, 0x5a074764),
+        ECC_DIGITS(0xb5f723fb, 0x4c22dfe6), ECC_DIGITS(0x00000000, 0xbd376388),
+    };
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_KOBLITZ
+    static const fp_digit ecc_digits_secp224k1[] = {
+        /* prime */
+        ECC_DIGITS(0xfffffffe, 0xffffe56d), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0x00000000, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0x00000000, 0x00000000), ECC_DIGITS(0x00000000, 0x00000000),
+        ECC_DIGITS(0x00000000, 0x00000000), ECC_DIGITS(0x00000000, 0x00000000),
+        /* B */
+        ECC_DIGITS(0x00000000, 0x00000005), ECC_DIGITS(0x00000000, 0x00000000),
+        ECC_DIGITS(0x00000000, 0x00000000), ECC_DIGITS(0x00000000, 0x00000000),
+        /* order */
+        ECC_DIGITS(0xcaf0a971, 0x769fb1f7), ECC_DIGITS(0x0001dce8, 0xd2ec6184),
+        ECC_DIGITS(0x00000000, 0x00000000), ECC_DIGITS(0x00000001, 0x00000000),
+        /* Gx */
+        ECC_DIGITS(0x0f7e650e, 0xb6b7a45c), ECC_DIGITS(0x69a467e9, 0xe47075a9),
+        ECC_DIGITS(0x4df099df, 0x30fc28a1), ECC_DIGITS(0x00000000, 0xa1455b33),
+        /* Gy */
+        ECC_DIGITS(0xe2ca4bdb, 0x556d61a5), ECC_DIGITS(0xf7e319f7, 0xc0b0bd59),
+        ECC_DIGITS(0x7fba3442, 0x82cafbd6), ECC_DIGITS(0x00000000, 0x7e089fed),
+    };
+    #endif /* HAVE_ECC_KOBLITZ */
+    #ifdef HAVE_ECC_BRAINPOOL
+    static const fp_digit ecc_digits_brainpoolp224r1[] = {
+        /* prime */
+        ECC_DIGITS(0x97da89f5, 0x7ec8c0ff), ECC_DIGITS(0x75d1d787, 0xb09f0757),
+        ECC_DIGITS(0x26436686, 0x2a183025), ECC_DIGITS(0x00000000, 0xd7c134aa),
+        /* A */
+        ECC_DIGITS(0xb0042a59, 0xcad29f43), ECC_DIGITS(0xc1530b51, 0x4e182ad8),
+        ECC_DIGITS(0xa9ce6c1c, 0x299803a6), ECC_DIGITS(0x00000000, 0x68a5e62c),
+        /* B */
+        ECC_DIGITS(0x66dbb372, 0x386c400b), ECC_DIGITS(0xa92369e3, 0x3e2135d2),
+        ECC_DIGITS(0xcfe44138, 0x870713b1), ECC_DIGITS(0x00000000, 0x2580f63c),
+        /* order */
+        ECC_DIGITS(0x6ddebca3, 0xa5a7939f), ECC_DIGITS(0x75d0fb98, 0xd116bc4b),
+        ECC_DIGITS(0x26436686, 0x2a183025), ECC_DIGITS(0x00000000, 0xd7c134aa),
+        /* Gx */
+        ECC_DIGITS(0x4c1e6efd, 0xee12c07d), ECC_DIGITS(0xa87dc68c, 0x9e4ce317),
+        ECC_DIGITS(0x2c7e5cf4, 0x340823b2), ECC_DIGITS(0x00000000, 0x0d9029ad),
+        /* Gy */
+        ECC_DIGITS(0xcaa3f6d3, 0x761402cd), ECC_DIGITS(0x4ecdac24, 0x354b9e99),
+        ECC_DIGITS(0x72c0726f, 0x24c6b89e), ECC_DIGITS(0x00000000, 0x58aa56f7),
+    };
+    #endif /* HAVE_ECC_BRAINPOOL */
+#endif /* ECC224 */
+#ifdef ECC239
+    #ifndef NO_ECC_SECP
+    static const fp_digit ecc_digits_prime239v1[] = {
+        /* prime */
+        ECC_DIGITS(0x00007fff, 0xffffffff), ECC_DIGITS(0xffffffff, 0x80000000),
+        ECC_DIGITS(0xffffffff, 0xffff7fff), ECC_DIGITS(0x00007fff, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0x00007fff, 0xfffffffc), ECC_DIGITS(0xffffffff, 0x80000000),
+        ECC_DIGITS(0xffffffff, 0xffff7fff), ECC_DIGITS(0x00007fff, 0xffffffff),
+        /* B */
+        ECC_DIGITS(0x37796185, 0xc2942c0a), ECC_DIGITS(0xca71a9db, 0x2fb27d1d),
+        ECC_DIGITS(0x8941d0d6, 0x54921475), ECC_DIGITS(0x00006b01, 0x6c3bdcf1),
+        /* order */
+        ECC_DIGITS(0xfbd15226, 0x88909d0b), ECC_DIGITS(0xff9e5e9a, 0x9f5d9071),
+        ECC_DIGITS(0xffffffff, 0xffff7fff), ECC_DIGITS(0x00007fff, 0xffffffff),
+        /* Gx */
+        ECC_DIGITS(0x27fbbd3b, 0x3cb9aaaf), ECC_DIGITS(0xf905c3d3, 0x58573d3f),
+        ECC_DIGITS(0x816ccc33, 0xb8642bed), ECC_DIGITS(0x00000ffa, 0x963cdca8),
+        /* Gy */
+        ECC_DIGITS(0x6b39fccb, 0x7b02f1ae), ECC_DIGITS(0xa04654b3, 0x6818ce22),
+        ECC_DIGITS(0x5dae6e40, 0x54ca530b), ECC_DIGITS(0x00007deb, 0xe8e4e90a),
+    };
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_SECPR2
+    static const fp_digit ecc_digits_prime239v2[] = {
+        /* prime */
+        ECC_DIGITS(0x00007fff, 0xffffffff), ECC_DIGITS(0xffffffff, 0x80000000),
+        ECC_DIGITS(0xffffffff, 0xffff7fff), ECC_DIGITS(0x00007fff, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0x00007fff, 0xfffffffc), ECC_DIGITS(0xffffffff, 0x80000000),
+        ECC_DIGITS(0xffffffff, 0xffff7fff), ECC_DIGITS(0x00007fff, 0xffffffff),
+        /* B */
+        ECC_DIGITS(0x8c7ae84c, 0x8c832f2c), ECC_DIGITS(0x9c3fee58, 0xb94ba003),
+        ECC_DIGITS(0x6cbbfed5, 0x0d99f024), ECC_DIGITS(0x0000617f, 0xab683257),
+        /* order */
+        ECC_DIGITS(0x14c03821, 0xbc582063), ECC_DIGITS(0x00cfa7e8, 0x594377d4),
+        ECC_DIGITS(0xffffffff, 0xffff8000), ECC_DIGITS(0x00007fff, 0xffffffff),
+        /* Gx */
+        ECC_DIGITS(0x57a0eafd, 0x87b830e7), ECC_DIGITS(0x26296a3c, 0xdcf2f357),
+        ECC_DIGITS(0x705120c9, 0x21bb5e9e), ECC_DIGITS(0x000038af, 0x09d98727),
+        /* Gy */
+        ECC_DIGITS(0xf460237d, 0xff8be4ba), ECC_DIGITS(0xb081329f, 0xb555de6e),
+        ECC_DIGITS(0x0ec7206d, 0xa0fc01d9), ECC_DIGITS(0x00005b01, 0x25e4dbea),
+    };
+    #endif /* HAVE_ECC_SECPR2 */
+    #ifdef HAVE_ECC_SECPR3
+    static const fp_digit ecc_digits_prime239v3[] = {
+        /* prime */
+        ECC_DIGITS(0x00007fff, 0xffffffff), ECC_DIGITS(0xffffffff, 0x80000000),
+        ECC_DIGITS(0xffffffff, 0xffff7fff), ECC_DIGITS(0x00007fff, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0x00007fff, 0xfffffffc), ECC_DIGITS(0xffffffff, 0x80000000),
+        ECC_DIGITS(0xffffffff, 0xffff7fff), ECC_DIGITS(0x00007fff, 0xffffffff),
+        /* B */
+        ECC_DIGITS(0x8717d9ba, 0x15ab6d3e), ECC_DIGITS(0x50a30c25, 0x0102d498),
+        ECC_DIGITS(0x6654b1f4, 0xcb03d6a7), ECC_DIGITS(0x00002557, 0x05fa2a30),
+        /* order */
+        ECC_DIGITS(0x7c3c4321, 0x46526551), ECC_DIGITS(0xff975deb, 0x41b3a605),
+        ECC_DIGITS(0xffffffff, 0xffff7fff), ECC_DIGITS(0x00007fff, 0xffffffff),
+        /* Gx */
+        ECC_DIGITS(0xf854b1c9, 0x505fe95a), ECC_DIGITS(0xc6d94853, 0xd0e660bb),
+        ECC_DIGITS(0x92cfcf00, 0x5c949aa2), ECC_DIGITS(0x00006768, 0xae8e18bb),
+        /* Gy */
+        ECC_DIGITS(0x8499af18, 0xe3ed6cf3), ECC_DIGITS(0x6f3b6fcf, 0xe48b6e81),
+        ECC_DIGITS(0x0c06bc1d, 0x552bad22), ECC_DIGITS(0x00001607, 0xe6898f39),
+    };
+    #endif /* HAVE_ECC_SECPR3 */
+#endif /* ECC239 */
+#ifdef ECC256
+    #ifndef NO_ECC_SECP
+    static const fp_digit ecc_digits_secp256r1[] = {
+        /* prime */
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0x00000000, 0xffffffff),
+        ECC_DIGITS(0x00000000, 0x00000000), ECC_DIGITS(0xffffffff, 0x00000001),
+        /* A */
+        ECC_DIGITS(0xffffffff, 0xfffffffc), ECC_DIGITS(0x00000000, 0xffffffff),
+        ECC_DIGITS(0x00000000, 0x00000000), ECC_DIGITS(0xffffffff, 0x00000001),
+        /* B */
+        ECC_DIGITS(0x3bce3c3e, 0x27d2604b), ECC_DIGITS(0x651d06b0, 0xcc53b0f6),
+        ECC_DIGITS(0xb3ebbd55, 0x769886bc), ECC_DIGITS(0x5ac635d8, 0xaa3a93e7),
+        /* order */
+        ECC_DIGITS(0xf3b9cac2, 0xfc632551), ECC_DIGITS(0xbce6faad, 0xa7179e84),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0x00000000),
+        /* Gx */
+        ECC_DIGITS(0xf4a13945, 0xd898c296), ECC_DIGITS(0x77037d81, 0x2deb33a0),
+        ECC_DIGITS(0xf8bce6e5, 0x63a440f2), ECC_DIGITS(0x6b17d1f2, 0xe12c4247),
+        /* Gy */
+        ECC_DIGITS(0xcbb64068, 0x37bf51f5), ECC_DIGITS(0x2bce3357, 0x6b315ece),
+        ECC_DIGITS(0x8ee7eb4a, 0x7c0f9e16), ECC_DIGITS(0x4fe342e2, 0xfe1a7f9b),
+    };
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_KOBLITZ
+    static const fp_digit ecc_digits_secp256k1[] = {
+        /* prime */
+        ECC_DIGITS(0xfffffffe, 0xfffffc2f), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0x00000000, 0x00000000), ECC_DIGITS(0x00000000, 0x00000000),
+        ECC_DIGITS(0x00000000, 0x00000000), ECC_DIGITS(0x00000000, 0x00000000),
+        /* B */
+        ECC_DIGITS(0x00000000, 0x00000007), ECC_DIGITS(0x00000000, 0x00000000),
+        ECC_DIGITS(0x00000000, 0x00000000), ECC_DIGITS(0x00000000, 0x00000000),
+        /* order */
+        ECC_DIGITS(0xbfd25e8c, 0xd0364141), ECC_DIGITS(0xbaaedce6, 0xaf48a03b),
+        ECC_DIGITS(0xffffffff, 0xfffffffe), ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* Gx */
+        ECC_DIGITS(0x59f2815b, 0x16f81798), ECC_DIGITS(0x029bfcdb, 0x2dce28d9),
+        ECC_DIGITS(0x55a06295, 0xce870b07), ECC_DIGITS(0x79be667e, 0xf9dcbbac),
+        /* Gy */
+        ECC_DIGITS(0x9c47d08f, 0xfb10d4b8), ECC_DIGITS(0xfd17b448, 0xa6855419),
+        ECC_DIGITS(0x5da4fbfc, 0x0e1108a8), ECC_DIGITS(0x483ada77, 0x26a3c465),
+    };
+    #endif /* HAVE_ECC_KOBLITZ */
+    #ifdef HAVE_ECC_BRAINPOOL
+    static const fp_digit ecc_digits_brainpoolp256r1[] = {
+        /* prime */
+        ECC_DIGITS(0x2013481d, 0x1f6e5377), ECC_DIGITS(0x6e3bf623, 0xd5262028),
+        ECC_DIGITS(0x3e660a90, 0x9d838d72), ECC_DIGITS(0xa9fb57db, 0xa1eea9bc),
+        /* A */
+        ECC_DIGITS(0xe94a4b44, 0xf330b5d9), ECC_DIGITS(0xfb8055c1, 0x26dc5c6c),
+        ECC_DIGITS(0xeef67530, 0x417affe7), ECC_DIGITS(0x7d5a0975, 0xfc2c3057),
+        /* B */
+        ECC_DIGITS(0x6bccdc18, 0xff8c07b6), ECC_DIGITS(0x95841629, 0x5cf7e1ce),
+        ECC_DIGITS(0xf330b5d9, 0xbbd77cbf), ECC_DIGITS(0x26dc5c6c, 0xe94a4b44),
+        /* order */
+        ECC_DIGITS(0x901e0e82, 0x974856a7), ECC_DIGITS(0x8c397aa3, 0xb561a6f7),
+        ECC_DIGITS(0x3e660a90, 0x9d838d71), ECC_DIGITS(0xa9fb57db, 0xa1eea9bc),
+        /* Gx */
+        ECC_DIGITS(0x3a4453bd, 0x9ace3262), ECC_DIGITS(0xb9de27e1, 0xe3bd23c2),
+        ECC_DIGITS(0x2c4b482f, 0xfc81b7af), ECC_DIGITS(0x8bd2aeb9, 0xcb7e57cb),
+        /* Gy */
+        ECC_DIGITS(0x5c1d54c7, 0x2f046997), ECC_DIGITS(0xc2774513, 0x2ded8e54),
+        ECC_DIGITS(0x97f8461a, 0x14611dc9), ECC_DIGITS(0x547ef835, 0xc3dac4fd),
+    };
+    #endif /* HAVE_ECC_BRAINPOOL */
+#endif /* ECC256 */
+#ifdef ECC320
+    #ifdef HAVE_ECC_BRAINPOOL
+    static const fp_digit ecc_digits_brainpoolp320r1[] = {
+        /* prime */
+        ECC_DIGITS(0xfcd412b1, 0xf1b32e27), ECC_DIGITS(0x4f92b9ec, 0x7893ec28),
+        ECC_DIGITS(0xf98fcfa6, 0xf6f40def), ECC_DIGITS(0xe13c785e, 0xd201e065),
+        ECC_DIGITS(0xd35e4720, 0x36bc4fb7),
+        /* A */
+        ECC_DIGITS(0x92f375a9, 0x7d860eb4), ECC_DIGITS(0x66190eb0, 0x85ffa9f4),
+        ECC_DIGITS(0xa2a73513, 0xf5eb79da), ECC_DIGITS(0x83ccebd4, 0x6d3f3bb8),
+        ECC_DIGITS(0x3ee30b56, 0x8fbab0f8),
+        /* B */
+        ECC_DIGITS(0x6f5eb4ac, 0x8fb1f1a6), ECC_DIGITS(0xcc31dccd, 0x88453981),
+        ECC_DIGITS(0xe13f4134, 0x9554b49a), ECC_DIGITS(0xd3ad1986, 0x40688a6f),
+        ECC_DIGITS(0x52088394, 0x9dfdbc42),
+        /* order */
+        ECC_DIGITS(0x8691555b, 0x44c59311), ECC_DIGITS(0x2d482ec7, 0xee8658e9),
+        ECC_DIGITS(0xf98fcfa5, 0xb68f12a3), ECC_DIGITS(0xe13c785e, 0xd201e065),
+        ECC_DIGITS(0xd35e4720, 0x36bc4fb7),
+        /* Gx */
+        ECC_DIGITS(0x10af8d0d, 0x39e20611), ECC_DIGITS(0xe7871e2a, 0x10a599c7),
+        ECC_DIGITS(0xf20137d1, 0x0a087eb6), ECC_DIGITS(0x5289bcc4, 0x8ee5bfe6),
+        ECC_DIGITS(0x43bd7e9a, 0xfb53d8b8),
+        /* Gy */
+        ECC_DIGITS(0xd35245d1, 0x692e8ee1), ECC_DIGITS(0xa9c77877, 0xaaac6ac7),
+        ECC_DIGITS(0x0743ffed, 0x117182ea), ECC_DIGITS(0xab409324, 0x7f77275e),
+        ECC_DIGITS(0x14fdd055, 0x45ec1cc8),
+    };
+    #endif /* HAVE_ECC_BRAINPOOL */
+#endif /* ECC320 */
+#ifdef ECC384
+    #ifndef NO_ECC_SECP
+    static const fp_digit ecc_digits_secp384r1[] = {
+        /* prime */
+        ECC_DIGITS(0x00000000, 0xffffffff), ECC_DIGITS(0xffffffff, 0x00000000),
+        ECC_DIGITS(0xffffffff, 0xfffffffe), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* A */
+        ECC_DIGITS(0x00000000, 0xfffffffc), ECC_DIGITS(0xffffffff, 0x00000000),
+        ECC_DIGITS(0xffffffff, 0xfffffffe), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* B */
+        ECC_DIGITS(0x2a85c8ed, 0xd3ec2aef), ECC_DIGITS(0xc656398d, 0x8a2ed19d),
+        ECC_DIGITS(0x0314088f, 0x5013875a), ECC_DIGITS(0x181d9c6e, 0xfe814112),
+        ECC_DIGITS(0x988e056b, 0xe3f82d19), ECC_DIGITS(0xb3312fa7, 0xe23ee7e4),
+        /* order */
+        ECC_DIGITS(0xecec196a, 0xccc52973), ECC_DIGITS(0x581a0db2, 0x48b0a77a),
+        ECC_DIGITS(0xc7634d81, 0xf4372ddf), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0xffffffff),
+        /* Gx */
+        ECC_DIGITS(0x3a545e38, 0x72760ab7), ECC_DIGITS(0x5502f25d, 0xbf55296c),
+        ECC_DIGITS(0x59f741e0, 0x82542a38), ECC_DIGITS(0x6e1d3b62, 0x8ba79b98),
+        ECC_DIGITS(0x8eb1c71e, 0xf320ad74), ECC_DIGITS(0xaa87ca22, 0xbe8b0537),
+        /* Gy */
+        ECC_DIGITS(0x7a431d7c, 0x90ea0e5f), ECC_DIGITS(0x0a60b1ce, 0x1d7e819d),
+        ECC_DIGITS(0xe9da3113, 0xb5f0b8c0), ECC_DIGITS(0xf8f41dbd, 0x289a147c),
+        ECC_DIGITS(0x5d9e98bf, 0x9292dc29), ECC_DIGITS(0x3617de4a, 0x96262c6f),
+    };
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_BRAINPOOL
+    static const fp_digit ecc_digits_brainpoolp384r1[] = {
+        /* prime */
+        ECC_DIGITS(0x87470013, 0x3107ec53), ECC_DIGITS(0xacd3a729, 0x901d1a71),
+        ECC_DIGITS(0x12b1da19, 0x7fb71123), ECC_DIGITS(0x152f7109, 0xed5456b4),
+        ECC_DIGITS(0x0f5d6f7e, 0x50e641df), ECC_DIGITS(0x8cb91e82, 0xa3386d28),
+        /* A */
+        ECC_DIGITS(0x04a8c7dd, 0x22ce2826), ECC_DIGITS(0x8aa5814a, 0x503ad4eb),
+        ECC_DIGITS(0x139165ef, 0xba91f90f), ECC_DIGITS(0xc2bea28e, 0x4fb22787),
+        ECC_DIGITS(0x3c72080a, 0xce05afa0), ECC_DIGITS(0x7bc382c6, 0x3d8c150c),
+        /* B */
+        ECC_DIGITS(0x3ab78696, 0xfa504c11), ECC_DIGITS(0x7cb43902, 0x95dbc994),
+        ECC_DIGITS(0x2e880ea5, 0x3eeb62d5), ECC_DIGITS(0x2fb77de1, 0x07dcd2a6),
+        ECC_DIGITS(0x8b39b554, 0x16f0447c), ECC_DIGITS(0x04a8c7dd, 0x22ce2826),
+        /* order */
+        ECC_DIGITS(0x3b883202, 0xe9046565), ECC_DIGITS(0xcf3ab6af, 0x6b7fc310),
+        ECC_DIGITS(0x1f166e6c, 0xac0425a7), ECC_DIGITS(0x152f7109, 0xed5456b3),
+        ECC_DIGITS(0x0f5d6f7e, 0x50e641df), ECC_DIGITS(0x8cb91e82, 0xa3386d28),
+        /* Gx */
+        ECC_DIGITS(0xef87b2e2, 0x47d4af1e), ECC_DIGITS(0xe826e034, 0x36d646aa),
+        ECC_DIGITS(0xdb7fcafe, 0x0cbd10e8), ECC_DIGITS(0x8847a3e7, 0x7ef14fe3),
+        ECC_DIGITS(0xa2a63a81, 0xb7c13f6b), ECC_DIGITS(0x1d1c64f0, 0x68cf45ff),
+        /* Gy */
+        ECC_DIGITS(0x42820341, 0x263c5315), ECC_DIGITS(0x0e464621, 0x77918111),
+        ECC_DIGITS(0xe19c054f, 0xf9912928), ECC_DIGITS(0x62b70b29, 0xfeec5864),
+        ECC_DIGITS(0x5cb1eb8e, 0x95cfd552), ECC_DIGITS(0x8abe1d75, 0x20f9c2a4),
+    };
+    #endif /* HAVE_ECC_BRAINPOOL */
+#endif /* ECC384 */
+#ifdef ECC512
+    #ifdef HAVE_ECC_BRAINPOOL
+    static const fp_digit ecc_digits_brainpoolp512r1[] = {
+        /* prime */
+        ECC_DIGITS(0x28aa6056, 0x583a48f3), ECC_DIGITS(0x2881ff2f, 0x2d82c685),
+        ECC_DIGITS(0xaecda12a, 0xe6a380e6), ECC_DIGITS(0x7d4d9b00, 0x9bc66842),
+        ECC_DIGITS(0xd6639cca, 0x70330871), ECC_DIGITS(0xcb308db3, 0xb3c9d20e),
+        ECC_DIGITS(0x3fd4e6ae, 0x33c9fc07), ECC_DIGITS(0xaadd9db8, 0xdbe9c48b),
+        /* A */
+        ECC_DIGITS(0xe7c1ac4d, 0x77fc94ca), ECC_DIGITS(0x7f1117a7, 0x2bf2c7b9),
+        ECC_DIGITS(0x0a2ef1c9, 0x8b9ac8b5), ECC_DIGITS(0x2ded5d5a, 0xa8253aa1),
+        ECC_DIGITS(0xa83441ca, 0xea9863bc), ECC_DIGITS(0x94cbdd8d, 0x3df91610),
+        ECC_DIGITS(0xe2327145, 0xac234cc5), ECC_DIGITS(0x7830a331, 0x8b603b89),
+        /* B */
+        ECC_DIGITS(0x2809bd63, 0x8016f723), ECC_DIGITS(0x984050b7, 0x5ebae5dd),
+        ECC_DIGITS(0x77fc94ca, 0xdc083e67), ECC_DIGITS(0x2bf2c7b9, 0xe7c1ac4d),
+        ECC_DIGITS(0x8b9ac8b5, 0x7f1117a7), ECC_DIGITS(0xa8253aa1, 0x0a2ef1c9),
+        ECC_DIGITS(0xea9863bc, 0x2ded5d5a), ECC_DIGITS(0x3df91610, 0xa83441ca),
+        /* order */
+        ECC_DIGITS(0xb5879682, 0x9ca90069), ECC_DIGITS(0x1db1d381, 0x085ddadd),
+        ECC_DIGITS(0x41866119, 0x7fac1047), ECC_DIGITS(0x553e5c41, 0x4ca92619),
+        ECC_DIGITS(0xd6639cca, 0x70330870), ECC_DIGITS(0xcb308db3, 0xb3c9d20e),
+        ECC_DIGITS(0x3fd4e6ae, 0x33c9fc07), ECC_DIGITS(0xaadd9db8, 0xdbe9c48b),
+        /* Gx */
+        ECC_DIGITS(0x8b352209, 0xbcb9f822), ECC_DIGITS(0x7c6d5047, 0x406a5e68),
+        ECC_DIGITS(0x50d1687b, 0x93b97d5f), ECC_DIGITS(0xff3b1f78, 0xe2d0d48d),
+        ECC_DIGITS(0xb43b62ee, 0xf4d0098e), ECC_DIGITS(0x85ed9f70, 0xb5d916c1),
+        ECC_DIGITS(0x5a21322e, 0x9c4c6a93), ECC_DIGITS(0x81aee4bd, 0xd82ed964),
+        /* Gy */
+        ECC_DIGITS(0x78cd1e0f, 0x3ad80892), ECC_DIGITS(0xd1ca2b2f, 0xa8f05406),
+        ECC_DIGITS(0x5bca4bd8, 0x8a2763ae), ECC_DIGITS(0xb2dcde49, 0x4a5f485e),
+        ECC_DIGITS(0xa000c55b, 0x881f8111), ECC_DIGITS(0xf209f700, 0x24a57b1a),
+        ECC_DIGITS(0xc0eabfa9, 0xcf7822fd), ECC_DIGITS(0x7dde385d, 0x566332ec),
+    };
+    #endif /* HAVE_ECC_BRAINPOOL */
+#endif /* ECC512 */
+#ifdef ECC521
+    #ifndef NO_ECC_SECP
+    static const fp_digit ecc_digits_secp521r1[] = {
+        /* prime */
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0x00000000, 0x000001ff),
+        /* A */
+        ECC_DIGITS(0xffffffff, 0xfffffffc), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0x00000000, 0x000001ff),
+        /* B */
+        ECC_DIGITS(0xef451fd4, 0x6b503f00), ECC_DIGITS(0x3573df88, 0x3d2c34f1),
+        ECC_DIGITS(0x1652c0bd, 0x3bb1bf07), ECC_DIGITS(0x56193951, 0xec7e937b),
+        ECC_DIGITS(0xb8b48991, 0x8ef109e1), ECC_DIGITS(0xa2da725b, 0x99b315f3),
+        ECC_DIGITS(0x929a21a0, 0xb68540ee), ECC_DIGITS(0x953eb961, 0x8e1c9a1f),
+        ECC_DIGITS(0x00000000, 0x00000051),
+        /* order */
+        ECC_DIGITS(0xbb6fb71e, 0x91386409), ECC_DIGITS(0x3bb5c9b8, 0x899c47ae),
+        ECC_DIGITS(0x7fcc0148, 0xf709a5d0), ECC_DIGITS(0x51868783, 0xbf2f966b),
+        ECC_DIGITS(0xffffffff, 0xfffffffa), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0xffffffff, 0xffffffff), ECC_DIGITS(0xffffffff, 0xffffffff),
+        ECC_DIGITS(0x00000000, 0x000001ff),
+        /* Gx */
+        ECC_DIGITS(0xf97e7e31, 0xc2e5bd66), ECC_DIGITS(0x3348b3c1, 0x856a429b),
+        ECC_DIGITS(0xfe1dc127, 0xa2ffa8de), ECC_DIGITS(0xa14b5e77, 0xefe75928),
+        ECC_DIGITS(0xf828af60, 0x6b4d3dba), ECC_DIGITS(0x9c648139, 0x053fb521),
+        ECC_DIGITS(0x9e3ecb66, 0x2395b442), ECC_DIGITS(0x858e06b7, 0x0404e9cd),
+        ECC_DIGITS(0x00000000, 0x000000c6),
+        /* Gy */
+        ECC_DIGITS(0x88be9476, 0x9fd16650), ECC_DIGITS(0x353c7086, 0xa272c240),
+        ECC_DIGITS(0xc550b901, 0x3fad0761), ECC_DIGITS(0x97ee7299, 0x5ef42640),
+        ECC_DIGITS(0x17afbd17, 0x273e662c), ECC_DIGITS(0x98f54449, 0x579b4468),
+        ECC_DIGITS(0x5c8a5fb4, 0x2c7d1bd9), ECC_DIGITS(0x39296a78, 0x9a3bc004),
+        ECC_DIGITS(0x00000000, 0x00000118),
+    };
+    #endif /* !NO_ECC_SECP */
+#endif /* ECC521 */
+
+static const ecc_curve_digits_t ecc_curve_digits[] = {
+#ifdef ECC112
+    #ifndef NO_ECC_SECP
+    { ECC_SECP112R1, 2, ecc_digits_secp112r1 },
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_SECPR2
+    { ECC_SECP112R2, 2, ecc_digits_secp112r2 },
+    #endif /* HAVE_ECC_SECPR2 */
+#endif /* ECC112 */
+#ifdef ECC128
+    #ifndef NO_ECC_SECP
+    { ECC_SECP128R1, 2, ecc_digits_secp128r1 },
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_SECPR2
+    { ECC_SECP128R2, 2, ecc_digits_secp128r2 },
+    #endif /* HAVE_ECC_SECPR2 */
+#endif /* ECC128 */
+#ifdef ECC160
+    #ifndef NO_ECC_SECP
+    { ECC_SECP160R1, 3, ecc_digits_secp160r1 },
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_SECPR2
+    { ECC_SECP160R2, 3, ecc_digits_secp160r2 },
+    #endif /* HAVE_ECC_SECPR2 */
+    #ifdef HAVE_ECC_KOBLITZ
+    { ECC_SECP160K1, 3, ecc_digits_secp160k1 },
+    #endif /* HAVE_ECC_KOBLITZ */
+    #ifdef HAVE_ECC_BRAINPOOL
+    { ECC_BRAINPOOLP160R1, 3, ecc_digits_brainpoolp160r1 },
+    #endif /* HAVE_ECC_BRAINPOOL */
+#endif /* ECC160 */
+#ifdef ECC192
+    #ifndef NO_ECC_SECP
+    { ECC_SECP192R1, 3, ecc_digits_secp192r1 },
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_SECPR2
+    { ECC_PRIME192V2, 3, ecc_digits_prime192v2 },
+    #endif /* HAVE_ECC_SECPR2 */
+    #ifdef HAVE_ECC_SECPR3
+    { ECC_PRIME192V3, 3, ecc_digits_prime192v3 },
+    #endif /* HAVE_ECC_SECPR3 */
+    #ifdef HAVE_ECC_KOBLITZ
+    { ECC_SECP192K1, 3, ecc_digits_secp192k1 },
+    #endif /* HAVE_ECC_KOBLITZ */
+    #ifdef HAVE_ECC_BRAINPOOL
+    { ECC_BRAINPOOLP192R1, 3, ecc_digits_brainpoolp192r1 },
+    #endif /* HAVE_ECC_BRAINPOOL */
+#endif /* ECC192 */
+#ifdef ECC224
+    #ifndef NO_ECC_SECP
+    { ECC_SECP224R1, 4, ecc_digits_secp224r1 },
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_KOBLITZ
+    { ECC_SECP224K1, 4, ecc_digits_secp224k1 },
+    #endif /* HAVE_ECC_KOBLITZ */
+    #ifdef HAVE_ECC_BRAINPOOL
+    { ECC_BRAINPOOLP224R1, 4, ecc_digits_brainpoolp224r1 },
+    #endif /* HAVE_ECC_BRAINPOOL */
+#endif /* ECC224 */
+#ifdef ECC239
+    #ifndef NO_ECC_SECP
+    { ECC_PRIME239V1, 4, ecc_digits_prime239v1 },
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_SECPR2
+    { ECC_PRIME239V2, 4, ecc_digits_prime239v2 },
+    #endif /* HAVE_ECC_SECPR2 */
+    #ifdef HAVE_ECC_SECPR3
+    { ECC_PRIME239V3, 4, ecc_digits_prime239v3 },
+    #endif /* HAVE_ECC_SECPR3 */
+#endif /* ECC239 */
+#ifdef ECC256
+    #ifndef NO_ECC_SECP
+    { ECC_SECP256R1, 4, ecc_digits_secp256r1 },
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_KOBLITZ
+    { ECC_SECP256K1, 4, ecc_digits_secp256k1 },
+    #endif /* HAVE_ECC_KOBLITZ */
+    #ifdef HAVE_ECC_BRAINPOOL
+    { ECC_BRAINPOOLP256R1, 4, ecc_digits_brainpoolp256r1 },
+    #endif /* HAVE_ECC_BRAINPOOL */
+#endif /* ECC256 */
+#ifdef ECC320
+    #ifdef HAVE_ECC_BRAINPOOL
+    { ECC_BRAINPOOLP320R1, 5, ecc_digits_brainpoolp320r1 },
+    #endif /* HAVE_ECC_BRAINPOOL */
+#endif /* ECC320 */
+#ifdef ECC384
+    #ifndef NO_ECC_SECP
+    { ECC_SECP384R1, 6, ecc_digits_secp384r1 },
+    #endif /* !NO_ECC_SECP */
+    #ifdef HAVE_ECC_BRAINPOOL
+    { ECC_BRAINPOOLP384R1, 6, ecc_digits_brainpoolp384r1 },
+    #endif /* HAVE_ECC_BRAINPOOL */
+#endif /* ECC384 */
+#ifdef ECC512
+    #ifdef HAVE_ECC_BRAINPOOL
+    { ECC_BRAINPOOLP512R1, 8, ecc_digits_brainpoolp512r1 },
+    #endif /* HAVE_ECC_BRAINPOOL */
+#endif /* ECC512 */
+#ifdef ECC521
+    #ifndef NO_ECC_SECP
+    { ECC_SECP521R1, 9, ecc_digits_secp521r1 },
+    #endif /* !NO_ECC_SECP */
+#endif /* ECC521 */
+    { ECC_CURVE_INVALID, 0, NULL }
+};
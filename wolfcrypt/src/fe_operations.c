@@ -46,6 +46,7 @@
 #elif defined(WOLFSSL_ARMASM)
 /* Assembly code in fe_armv[78]_x25519.* */
 #elif defined(CURVED25519_128BIT)
+#include "safegcd.i"
 #include "fe_x25519_128.i"
 #else
 
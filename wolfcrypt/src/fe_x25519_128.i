@@ -371,31 +371,45 @@ void fe_mul121666(fe r, fe a)
     r[4] = t4 & 0x7ffffffffffff;
 }
 
+/* The prime 2^255 - 19 for inversion. */
+static const safegcd_mod fe_mod_inv = {
+    { 0x3fffffffffffffedL,0x3fffffffffffffffL,0x3fffffffffffffffL,
+      0x3fffffffffffffffL,0x000000000000007fL },
+    0x39435e50d79435e5UL
+};
+
 /* Find the inverse of a modulo 2^255 - 1 and put result in r.
  * (r * a) mod (2^255 - 1) = 1
- * Implementation is constant time.
+ * Implementation is constant time - uses divsteps (safegcd).
  *
  * r  A field element.
  * a  A field element.
  */
 void fe_invert(fe r, const fe a)
 {
-    fe  t0, t1, t2, t3;
-    int i;
+    unsigned char b[32];
+    uint64_t      w[4];
+    int           i;
+
+    /* Fully reduced. */
+    fe_tobytes(b, a);
+    for (i = 0; i < 4; i++) {
+        w[i] = ((uint64_t)b[i * 8 + 0]      ) | ((uint64_t)b[i * 8 + 1] <<  8)
+             | ((uint64_t)b[i * 8 + 2] << 16) | ((uint64_t)b[i * 8 + 3] << 24)
+             | ((uint64_t)b[i * 8 + 4] << 32) | ((uint64_t)b[i * 8 + 5] << 40)
+             | ((uint64_t)b[i * 8 + 6] << 48) | ((uint64_t)b[i * 8 + 7] << 56);
+    }
 
-    /* a ^ (2^255 - 21) */
-    fe_sq(t0,  a); for (i = 1; i <   1; ++i) fe_sq(t0, t0);
-    fe_sq(t1, t0); for (i = 1; i <   2; ++i) fe_sq(t1, t1); fe_mul(t1,  a, t1);
-    fe_mul(t0, t0, t1);
-    fe_sq(t2, t0); for (i = 1; i <   1; ++i) fe_sq(t2, t2); fe_mul(t1, t1, t2);
-    fe_sq(t2, t1); for (i = 1; i <   5; ++i) fe_sq(t2, t2); fe_mul(t1, t2, t1);
-    fe_sq(t2, t1); for (i = 1; i <  10; ++i) fe_sq(t2, t2); fe_mul(t2, t2, t1);
-    fe_sq(t3, t2); for (i = 1; i <  20; ++i) fe_sq(t3, t3); fe_mul(t2, t3, t2);
-    fe_sq(t2, t2); for (i = 1; i <  10; ++i) fe_sq(t2, t2); fe_mul(t1, t2, t1);
-    fe_sq(t2, t1); for (i = 1; i <  50; ++i) fe_sq(t2, t2); fe_mul(t2, t2, t1);
-    fe_sq(t3, t2); for (i = 1; i < 100; ++i) fe_sq(t3, t3); fe_mul(t2, t3, t2);
-    fe_sq(t2, t2); for (i = 1; i <  50; ++i) fe_sq(t2, t2); fe_mul(t1, t2, t1);
-    fe_sq(t1, t1); for (i = 1; i <   5; ++i) fe_sq(t1, t1); fe_mul( r, t1, t0);
+    safegcd_inv_256(w, w, &fe_mod_inv);
+
+    r[0] = (int64_t)( w[0]                      ) & 0x7ffffffffffff;
+    r[1] = (int64_t)((w[0] >> 51) | (w[1] << 13)) & 0x7ffffffffffff;
+    r[2] = (int64_t)((w[1] >> 38) | (w[2] << 26)) & 0x7ffffffffffff;
+    r[3] = (int64_t)((w[2] >> 25) | (w[3] << 39)) & 0x7ffffffffffff;
+    r[4] = (int64_t)( w[3] >> 12);
+
+    ForceZero(b, sizeof(b));
+    ForceZero(w, sizeof(w));
 }
 
 #ifndef CURVE25519_SMALL
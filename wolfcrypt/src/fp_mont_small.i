@@ -31,26 +31,26 @@ int fp_montgomery_reduce_small(fp_int *a, fp_int *m, fp_digit mp)
    fp_digit *c;
 #endif
    fp_digit *_c, *tmpm, mu, cy;
-   int      oldused, x, y, pa;
+   int      oldused, x, y, pa, sz;
+
+   pa = m->used;
+   oldused = a->used;
+   /* digits the result and its carries can reach */
+   sz = MIN(MAX(oldused, pa + pa) + 1, FP_SIZE);
 
 #ifdef WOLFSSL_SMALL_STACK
    /* only allocate space for what's needed for window plus res */
-   c = (fp_digit*)XMALLOC(sizeof(fp_digit)*FP_SIZE, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+   c = (fp_digit*)XMALLOC(sizeof(fp_digit)*sz, NULL, DYNAMIC_TYPE_TMP_BUFFER);
    if (c == NULL) {
       return FP_MEM;
    }
 #endif
 
-   /* now zero the buff */
-   XMEMSET(c, 0, sizeof(fp_digit)*(FP_SIZE));
-
-   pa = m->used;
-
-   /* copy the input */
-   oldused = a->used;
+   /* copy the input and zero the rest of the buff */
    for (x = 0; x < oldused; x++) {
        c[x] = a->dp[x];
    }
+   XMEMSET(c + oldused, 0, sizeof(fp_digit)*(sz - oldused));
 
    MONT_START;
 
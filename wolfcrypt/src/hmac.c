@@ -276,6 +276,10 @@ int _InitHmac(Hmac* hmac, int type, void* heap)
 }
 
 
+#ifdef WOLFSSL_HMAC_MIDSTATE
+static int HmacKeyMidStates(Hmac* hmac, word32 blockSz);
+#endif
+
 int wc_HmacSetKey(Hmac* hmac, int type, const byte* key, word32 length)
 {
     byte*  ip;
@@ -300,6 +304,9 @@ int wc_HmacSetKey(Hmac* hmac, int type, const byte* key, word32 length)
 
     hmac->innerHashKeyed = 0;
     hmac->macType = (byte)type;
+#ifdef WOLFSSL_HMAC_MIDSTATE
+    hmac->midState = 0;
+#endif
 
     ret = _InitHmac(hmac, type, heap);
     if (ret != 0)
@@ -558,6 +565,17 @@ int wc_HmacSetKey(Hmac* hmac, int type, const byte* key, word32 length)
         }
     }
 
+#ifdef WOLFSSL_HMAC_MIDSTATE
+    #ifdef WOLF_CRYPTO_CB
+    /* device may do the whole HMAC with the raw key */
+    if (ret == 0 && hmac->devId == INVALID_DEVID)
+        ret = HmacKeyMidStates(hmac, hmac_block_size);
+    #else
+    if (ret == 0)
+        ret = HmacKeyMidStates(hmac, hmac_block_size);
+    #endif
+#endif
+
     return ret;
 }
 
@@ -645,6 +663,332 @@ static int HmacKeyInnerHash(Hmac* hmac)
 }
 
 
+#ifdef WOLFSSL_HMAC_MIDSTATE
+static int HmacHashUpdate(int type, Hash* hash, const byte* data, word32 len)
+{
+    int ret = BAD_FUNC_ARG;
+
+    switch (type) {
+    #ifndef NO_MD5
+        case WC_MD5:
+            ret = wc_Md5Update(&hash->md5, data, len);
+            break;
+    #endif /* !NO_MD5 */
+
+    #ifndef NO_SHA
+        case WC_SHA:
+            ret = wc_ShaUpdate(&hash->sha, data, len);
+            break;
+    #endif /* !NO_SHA */
+
+    #ifdef WOLFSSL_SHA224
+        case WC_SHA224:
+            ret = wc_Sha224Update(&hash->sha224, data, len);
+            break;
+    #endif /* WOLFSSL_SHA224 */
+    #ifndef NO_SHA256
+        case WC_SHA256:
+            ret = wc_Sha256Update(&hash->sha256, data, len);
+            break;
+    #endif /* !NO_SHA256 */
+
+    #ifdef WOLFSSL_SHA384
+        case WC_SHA384:
+            ret = wc_Sha384Update(&hash->sha384, data, len);
+            break;
+    #endif /* WOLFSSL_SHA384 */
+    #ifdef WOLFSSL_SHA512
+        case WC_SHA512:
+            ret = wc_Sha512Update(&hash->sha512, data, len);
+            break;
+    #endif /* WOLFSSL_SHA512 */
+
+    #ifdef WOLFSSL_SHA3
+    #ifndef WOLFSSL_NOSHA3_224
+        case WC_SHA3_224:
+            ret = wc_Sha3_224_Update(&hash->sha3, data, len);
+            break;
+    #endif
+    #ifndef WOLFSSL_NOSHA3_256
+        case WC_SHA3_256:
+            ret = wc_Sha3_256_Update(&hash->sha3, data, len);
+            break;
+    #endif
+    #ifndef WOLFSSL_NOSHA3_384
+        case WC_SHA3_384:
+            ret = wc_Sha3_384_Update(&hash->sha3, data, len);
+            break;
+    #endif
+    #ifndef WOLFSSL_NOSHA3_512
+        case WC_SHA3_512:
+            ret = wc_Sha3_512_Update(&hash->sha3, data, len);
+            break;
+    #endif
+    #endif /* WOLFSSL_SHA3 */
+
+        default:
+            break;
+    }
+
+    return ret;
+}
+
+static int HmacHashFinal(int type, Hash* hash, byte* out)
+{
+    int ret = BAD_FUNC_ARG;
+
+    switch (type) {
+    #ifndef NO_MD5
+        case WC_MD5:
+            ret = wc_Md5Final(&hash->md5, out);
+            break;
+    #endif /* !NO_MD5 */
+
+    #ifndef NO_SHA
+        case WC_SHA:
+            ret = wc_ShaFinal(&hash->sha, out);
+            break;
+    #endif /* !NO_SHA */
+
+    #ifdef WOLFSSL_SHA224
+        case WC_SHA224:
+            ret = wc_Sha224Final(&hash->sha224, out);
+            break;
+    #endif /* WOLFSSL_SHA224 */
+    #ifndef NO_SHA256
+        case WC_SHA256:
+            ret = wc_Sha256Final(&hash->sha256, out);
+            break;
+    #endif /* !NO_SHA256 */
+
+    #ifdef WOLFSSL_SHA384
+        case WC_SHA384:
+            ret = wc_Sha384Final(&hash->sha384, out);
+            break;
+    #endif /* WOLFSSL_SHA384 */
+    #ifdef WOLFSSL_SHA512
+        case WC_SHA512:
+            ret = wc_Sha512Final(&hash->sha512, out);
+            break;
+    #endif /* WOLFSSL_SHA512 */
+
+    #ifdef WOLFSSL_SHA3
+    #ifndef WOLFSSL_NOSHA3_224
+        case WC_SHA3_224:
+            ret = wc_Sha3_224_Final(&hash->sha3, out);
+            break;
+    #endif
+    #ifndef WOLFSSL_NOSHA3_256
+        case WC_SHA3_256:
+            ret = wc_Sha3_256_Final(&hash->sha3, out);
+            break;
+    #endif
+    #ifndef WOLFSSL_NOSHA3_384
+        case WC_SHA3_384:
+            ret = wc_Sha3_384_Final(&hash->sha3, out);
+            break;
+    #endif
+    #ifndef WOLFSSL_NOSHA3_512
+        case WC_SHA3_512:
+            ret = wc_Sha3_512_Final(&hash->sha3, out);
+            break;
+    #endif
+    #endif /* WOLFSSL_SHA3 */
+
+        default:
+            break;
+    }
+
+    return ret;
+}
+
+/* Copy a hash state. Anything held by dst must have been freed already. */
+static int HmacHashCopy(int type, Hash* src, Hash* dst)
+{
+    int ret = BAD_FUNC_ARG;
+
+    switch (type) {
+    #ifndef NO_MD5
+        case WC_MD5:
+            ret = wc_Md5Copy(&src->md5, &dst->md5);
+            break;
+    #endif /* !NO_MD5 */
+
+    #ifndef NO_SHA
+        case WC_SHA:
+            ret = wc_ShaCopy(&src->sha, &dst->sha);
+            break;
+    #endif /* !NO_SHA */
+
+    #ifdef WOLFSSL_SHA224
+        case WC_SHA224:
+            ret = wc_Sha224Copy(&src->sha224, &dst->sha224);
+            break;
+    #endif /* WOLFSSL_SHA224 */
+    #ifndef NO_SHA256
+        case WC_SHA256:
+            ret = wc_Sha256Copy(&src->sha256, &dst->sha256);
+            break;
+    #endif /* !NO_SHA256 */
+
+    #ifdef WOLFSSL_SHA384
+        case WC_SHA384:
+            ret = wc_Sha384Copy(&src->sha384, &dst->sha384);
+            break;
+    #endif /* WOLFSSL_SHA384 */
+    #ifdef WOLFSSL_SHA512
+        case WC_SHA512:
+            ret = wc_Sha512Copy(&src->sha512, &dst->sha512);
+            break;
+    #endif /* WOLFSSL_SHA512 */
+
+    #ifdef WOLFSSL_SHA3
+    #ifndef WOLFSSL_NOSHA3_224
+        case WC_SHA3_224:
+            ret = wc_Sha3_224_Copy(&src->sha3, &dst->sha3);
+            break;
+    #endif
+    #ifndef WOLFSSL_NOSHA3_256
+        case WC_SHA3_256:
+            ret = wc_Sha3_256_Copy(&src->sha3, &dst->sha3);
+            break;
+    #endif
+    #ifndef WOLFSSL_NOSHA3_384
+        case WC_SHA3_384:
+            ret = wc_Sha3_384_Copy(&src->sha3, &dst->sha3);
+            break;
+    #endif
+    #ifndef WOLFSSL_NOSHA3_512
+        case WC_SHA3_512:
+            ret = wc_Sha3_512_Copy(&src->sha3, &dst->sha3);
+            break;
+    #endif
+    #endif /* WOLFSSL_SHA3 */
+
+        default:
+            break;
+    }
+
+    return ret;
+}
+
+static void HmacHashFree(int type, Hash* hash)
+{
+    switch (type) {
+    #ifndef NO_MD5
+        case WC_MD5:
+            wc_Md5Free(&hash->md5);
+            break;
+    #endif /* !NO_MD5 */
+
+    #ifndef NO_SHA
+        case WC_SHA:
+            wc_ShaFree(&hash->sha);
+            break;
+    #endif /* !NO_SHA */
+
+    #ifdef WOLFSSL_SHA224
+        case WC_SHA224:
+            wc_Sha224Free(&hash->sha224);
+            break;
+    #endif /* WOLFSSL_SHA224 */
+    #ifndef NO_SHA256
+        case WC_SHA256:
+            wc_Sha256Free(&hash->sha256);
+            break;
+    #endif /* !NO_SHA256 */
+
+    #ifdef WOLFSSL_SHA384
+        case WC_SHA384:
+            wc_Sha384Free(&hash->sha384);
+            break;
+    #endif /* WOLFSSL_SHA384 */
+    #ifdef WOLFSSL_SHA512
+        case WC_SHA512:
+            wc_Sha512Free(&hash->sha512);
+            break;
+    #endif /* WOLFSSL_SHA512 */
+
+    #ifdef WOLFSSL_SHA3
+    #ifndef WOLFSSL_NOSHA3_224
+        case WC_SHA3_224:
+            wc_Sha3_224_Free(&hash->sha3);
+            break;
+    #endif
+    #ifndef WOLFSSL_NOSHA3_256
+        case WC_SHA3_256:
+            wc_Sha3_256_Free(&hash->sha3);
+            break;
+    #endif
+    #ifndef WOLFSSL_NOSHA3_384
+        case WC_SHA3_384:
+            wc_Sha3_384_Free(&hash->sha3);
+            break;
+    #endif
+    #ifndef WOLFSSL_NOSHA3_512
+        case WC_SHA3_512:
+            wc_Sha3_512_Free(&hash->sha3);
+            break;
+    #endif
+    #endif /* WOLFSSL_SHA3 */
+
+        default:
+            break;
+    }
+}
+
+/* Hash the ipad and opad blocks once and keep the states.
+ * Each HMAC then only hashes the message and the inner digest. */
+static int HmacKeyMidStates(Hmac* hmac, word32 blockSz)
+{
+    int ret;
+
+    /* hash is freshly initialized - use it as the start of the outer hash */
+    ret = HmacHashCopy(hmac->macType, &hmac->hash, &hmac->outerState);
+    if (ret == 0) {
+        ret = HmacHashUpdate(hmac->macType, &hmac->outerState,
+                             (byte*)hmac->opad, blockSz);
+    }
+    if (ret == 0)
+        ret = HmacKeyInnerHash(hmac);
+    if (ret == 0)
+        ret = HmacHashCopy(hmac->macType, &hmac->hash, &hmac->innerState);
+    if (ret == 0)
+        hmac->midState = 1;
+
+    return ret;
+}
+
+static int HmacFinalMidState(Hmac* hmac, byte* hash)
+{
+    int ret;
+    int digestSz = wc_HmacSizeByType(hmac->macType);
+
+    if (digestSz < 0)
+        return digestSz;
+
+    ret = HmacHashFinal(hmac->macType, &hmac->hash, (byte*)hmac->innerHash);
+    if (ret == 0) {
+        HmacHashFree(hmac->macType, &hmac->hash);
+        ret = HmacHashCopy(hmac->macType, &hmac->outerState, &hmac->hash);
+    }
+    if (ret == 0) {
+        ret = HmacHashUpdate(hmac->macType, &hmac->hash,
+                             (byte*)hmac->innerHash, (word32)digestSz);
+    }
+    if (ret == 0)
+        ret = HmacHashFinal(hmac->macType, &hmac->hash, hash);
+    if (ret == 0) {
+        /* ready for the next message with the same key */
+        HmacHashFree(hmac->macType, &hmac->hash);
+        ret = HmacHashCopy(hmac->macType, &hmac->innerState, &hmac->hash);
+    }
+
+    return ret;
+}
+#endif /* WOLFSSL_HMAC_MIDSTATE */
+
+
 int wc_HmacUpdate(Hmac* hmac, const byte* msg, word32 length)
 {
     int ret = 0;
@@ -787,6 +1131,11 @@ int wc_HmacFinal(Hmac* hmac, byte* hash)
             return ret;
     }
 
+#ifdef WOLFSSL_HMAC_MIDSTATE
+    if (hmac->midState)
+        return HmacFinalMidState(hmac, hash);
+#endif
+
     switch (hmac->macType) {
     #ifndef NO_MD5
         case WC_MD5:
@@ -1100,6 +1449,14 @@ void wc_HmacFree(Hmac* hmac)
     wolfAsync_DevCtxFree(&hmac->asyncDev, WOLFSSL_ASYNC_MARKER_HMAC);
 #endif /* WOLFSSL_ASYNC_CRYPT */
 
+#ifdef WOLFSSL_HMAC_MIDSTATE
+    if (hmac->midState) {
+        HmacHashFree(hmac->macType, &hmac->innerState);
+        HmacHashFree(hmac->macType, &hmac->outerState);
+        hmac->midState = 0;
+    }
+#endif
+
     switch (hmac->macType) {
     #ifndef NO_MD5
         case WC_MD5:
@@ -1142,6 +1499,87 @@ int wolfSSL_GetHmacMaxSize(void)
     return WC_MAX_DIGEST_SIZE;
 }
 
+#ifdef WOLFSSL_HMAC_MIDSTATE
+/* Export the keyed state of an HMAC object.
+ * The state can be imported into any number of HMAC objects later to
+ * compute an HMAC with the same key without hashing the pads again.
+ *
+ * hmac   HMAC object that has had the key set.
+ * state  Keyed state. Free with wc_HmacFreeKeyState() when done.
+ * returns 0 on success, otherwise failure.
+ */
+int wc_HmacExportKeyState(Hmac* hmac, HmacKeyState* state)
+{
+    int ret;
+
+    if (hmac == NULL || state == NULL || !hmac->midState)
+        return BAD_FUNC_ARG;
+
+    XMEMSET(state, 0, sizeof(HmacKeyState));
+    state->macType = hmac->macType;
+    ret = HmacHashCopy(hmac->macType, &hmac->innerState, &state->inner);
+    if (ret == 0)
+        ret = HmacHashCopy(hmac->macType, &hmac->outerState, &state->outer);
+    if (ret != 0)
+        wc_HmacFreeKeyState(state);
+
+    return ret;
+}
+
+/* Key an HMAC object from an exported keyed state.
+ * Hardware devices need the raw key and are not supported.
+ *
+ * hmac   HMAC object that has been initialized.
+ * state  Keyed state from wc_HmacExportKeyState().
+ * returns 0 on success, otherwise failure.
+ */
+int wc_HmacImportKeyState(Hmac* hmac, HmacKeyState* state)
+{
+    int ret;
+
+    if (hmac == NULL || state == NULL || state->macType == 0)
+        return BAD_FUNC_ARG;
+#ifdef WOLF_CRYPTO_CB
+    if (hmac->devId != INVALID_DEVID)
+        return BAD_FUNC_ARG;
+#endif
+#if defined(WOLFSSL_ASYNC_CRYPT) && defined(WC_ASYNC_ENABLE_HMAC)
+    if (hmac->asyncDev.marker == WOLFSSL_ASYNC_MARKER_HMAC)
+        return BAD_FUNC_ARG;
+#endif
+
+    if (hmac->macType != 0) {
+        wc_HmacFree(hmac);
+    }
+
+    hmac->macType = state->macType;
+    ret = HmacHashCopy(hmac->macType, &state->inner, &hmac->innerState);
+    if (ret == 0)
+        ret = HmacHashCopy(hmac->macType, &state->outer, &hmac->outerState);
+    if (ret == 0)
+        ret = HmacHashCopy(hmac->macType, &state->inner, &hmac->hash);
+    if (ret == 0) {
+        hmac->innerHashKeyed = WC_HMAC_INNER_HASH_KEYED_SW;
+        hmac->midState = 1;
+    }
+
+    return ret;
+}
+
+/* Free and zeroize an exported keyed state. */
+void wc_HmacFreeKeyState(HmacKeyState* state)
+{
+    if (state == NULL)
+        return;
+
+    if (state->macType != 0) {
+        HmacHashFree(state->macType, &state->inner);
+        HmacHashFree(state->macType, &state->outer);
+    }
+    ForceZero(state, sizeof(HmacKeyState));
+}
+#endif /* WOLFSSL_HMAC_MIDSTATE */
+
 #ifdef HAVE_HKDF
     /* HMAC-KDF-Extract.
      * RFC 5869 - HMAC-based Extract-and-Expand Key Derivation Function (HKDF).
@@ -1188,48 +1626,47 @@ int wolfSSL_GetHmacMaxSize(void)
         return ret;
     }
 
-    /* HMAC-KDF-Expand.
-     * RFC 5869 - HMAC-based Extract-and-Expand Key Derivation Function (HKDF).
+    /* HMAC-KDF-Expand with an HMAC object that already has the key set.
+     * The key is only hashed into the pads once for all output blocks.
      *
-     * type     The hash algorithm type.
-     * inKey    The input key.
-     * inKeySz  The size of the input key.
+     * hmac     The HMAC object keyed with the pseudorandom key.
      * info     The application specific information.
      * infoSz   The size of the application specific information.
      * out      The output keying material.
      * returns 0 on success, otherwise failure.
      */
-    int wc_HKDF_Expand(int type, const byte* inKey, word32 inKeySz,
-                       const byte* info, word32 infoSz, byte* out, word32 outSz)
+    int wc_HKDF_ExpandKeyed(Hmac* hmac, const byte* info, word32 infoSz,
+                            byte* out, word32 outSz)
     {
         byte   tmp[WC_MAX_DIGEST_SIZE];
-        Hmac   myHmac;
         int    ret = 0;
         word32 outIdx = 0;
-        word32 hashSz = wc_HmacSizeByType(type);
+        word32 hashSz;
         byte   n = 0x1;
 
-        ret = wc_HmacInit(&myHmac, NULL, INVALID_DEVID);
-        if (ret != 0)
+        if (hmac == NULL || (out == NULL && outSz > 0))
+            return BAD_FUNC_ARG;
+
+        ret = wc_HmacSizeByType(hmac->macType);
+        if (ret < 0)
             return ret;
+        hashSz = (word32)ret;
+        ret = 0;
 
         while (outIdx < outSz) {
             int    tmpSz = (n == 1) ? 0 : hashSz;
             word32 left = outSz - outIdx;
 
-            ret = wc_HmacSetKey(&myHmac, type, inKey, inKeySz);
+            ret = wc_HmacUpdate(hmac, tmp, tmpSz);
             if (ret != 0)
                 break;
-            ret = wc_HmacUpdate(&myHmac, tmp, tmpSz);
+            ret = wc_HmacUpdate(hmac, info, infoSz);
             if (ret != 0)
                 break;
-            ret = wc_HmacUpdate(&myHmac, info, infoSz);
+            ret = wc_HmacUpdate(hmac, &n, 1);
             if (ret != 0)
                 break;
-            ret = wc_HmacUpdate(&myHmac, &n, 1);
-            if (ret != 0)
-                break;
-            ret = wc_HmacFinal(&myHmac, tmp);
+            ret = wc_HmacFinal(hmac, tmp);
             if (ret != 0)
                 break;
 
@@ -1240,6 +1677,36 @@ int wolfSSL_GetHmacMaxSize(void)
             n++;
         }
 
+        ForceZero(tmp, sizeof(tmp));
+
+        return ret;
+    }
+
+    /* HMAC-KDF-Expand.
+     * RFC 5869 - HMAC-based Extract-and-Expand Key Derivation Function (HKDF).
+     *
+     * type     The hash algorithm type.
+     * inKey    The input key.
+     * inKeySz  The size of the input key.
+     * info     The application specific information.
+     * infoSz   The size of the application specific information.
+     * out      The output keying material.
+     * returns 0 on success, otherwise failure.
+     */
+    int wc_HKDF_Expand(int type, const byte* inKey, word32 inKeySz,
+                       const byte* info, word32 infoSz, byte* out, word32 outSz)
+    {
+        Hmac   myHmac;
+        int    ret = 0;
+
+        ret = wc_HmacInit(&myHmac, NULL, INVALID_DEVID);
+        if (ret != 0)
+            return ret;
+
+        ret = wc_HmacSetKey(&myHmac, type, inKey, inKeySz);
+        if (ret == 0)
+            ret = wc_HKDF_ExpandKeyed(&myHmac, info, infoSz, out, outSz);
+
         wc_HmacFree(&myHmac);
 
         return ret;
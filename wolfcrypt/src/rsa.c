@@ -62,6 +62,8 @@ Possible RSA enable options:
  * WC_RSA_NONBLOCK:     Enables support for RSA non-blocking        default: off
  * WC_RSA_NONBLOCK_TIME:Enables support for time based blocking     default: off
  *                      time calculation.
+ * WOLFSSL_RSA_MULTI_PRIME: Private keys with 3 and 4 primes       default: off
+ * WC_RSA_BATCH:        Batched PKCS #1 v1.5 signature verification default: off
 */
 
 /*
@@ -252,6 +254,9 @@ static void wc_RsaCleanup(RsaKey* key)
 int wc_InitRsaKey_ex(RsaKey* key, void* heap, int devId)
 {
     int ret = 0;
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    int i;
+#endif
 
     if (key == NULL) {
         return BAD_FUNC_ARG;
@@ -306,6 +311,14 @@ int wc_InitRsaKey_ex(RsaKey* key, void* heap, int devId)
         mp_clear(&key->e);
         return ret;
     }
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    for (i = 0; ret == MP_OKAY && i < RSA_MAX_PRIMES - 2; i++) {
+        ret = mp_init_multi(&key->r[i], &key->dR[i], &key->tR[i], NULL, NULL,
+                                                                         NULL);
+    }
+    if (ret != MP_OKAY)
+        return ret;
+#endif
 #else
     ret = mp_init(&key->n);
     if (ret != MP_OKAY)
@@ -509,9 +522,34 @@ static int cc310_RSA_GenerateKeyPair(RsaKey* key, int size, long e)
 }
 #endif /* WOLFSSL_CRYPTOCELL */
 
+#ifdef WC_RSA_PREPARED
+/* Free the cached values of a prepared key.
+ *
+ * key  RSA key.
+ */
+static void RsaPreparedFree(RsaKey* key)
+{
+#ifdef WC_RSA_BLINDING
+    mp_forcezero(&key->blindInv);
+    mp_forcezero(&key->blind);
+    mp_clear(&key->blindInv);
+    mp_clear(&key->blind);
+    key->blindUses = 0;
+#endif
+#ifdef WC_RSA_PREPARED_MONT
+    mp_clear(&key->r2q);
+    mp_clear(&key->r2p);
+#endif
+    key->prepared = 0;
+}
+#endif
+
 int wc_FreeRsaKey(RsaKey* key)
 {
     int ret = 0;
+#if defined(WOLFSSL_RSA_MULTI_PRIME) && !defined(WOLFSSL_RSA_PUBLIC_ONLY)
+    int i;
+#endif
 
     if (key == NULL) {
         return BAD_FUNC_ARG;
@@ -523,6 +561,11 @@ int wc_FreeRsaKey(RsaKey* key)
     wolfAsync_DevCtxFree(&key->asyncDev, WOLFSSL_ASYNC_MARKER_RSA);
 #endif
 
+#ifdef WC_RSA_PREPARED
+    if (key->prepared)
+        RsaPreparedFree(key);
+#endif
+
 #ifndef WOLFSSL_RSA_PUBLIC_ONLY
     if (key->type == RSA_PRIVATE) {
 #if defined(WOLFSSL_KEY_GEN) || defined(OPENSSL_EXTRA) || !defined(RSA_LOW_MEM)
@@ -534,6 +577,19 @@ int wc_FreeRsaKey(RsaKey* key)
         mp_forcezero(&key->p);
         mp_forcezero(&key->d);
     }
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    for (i = 0; i < RSA_MAX_PRIMES - 2; i++) {
+        if (key->type == RSA_PRIVATE) {
+            mp_forcezero(&key->tR[i]);
+            mp_forcezero(&key->dR[i]);
+            mp_forcezero(&key->r[i]);
+        }
+        mp_clear(&key->tR[i]);
+        mp_clear(&key->dR[i]);
+        mp_clear(&key->r[i]);
+    }
+    key->primes = 0;
+#endif
     /* private part */
 #if defined(WOLFSSL_KEY_GEN) || defined(OPENSSL_EXTRA) || !defined(RSA_LOW_MEM)
     mp_clear(&key->u);
@@ -585,6 +641,9 @@ int wc_CheckRsaKey(RsaKey* key)
     mp_int k[1], tmp[1];
 #endif
     int ret = 0;
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    int i;
+#endif
 
 #ifdef WOLFSSL_SMALL_STACK
     k = (mp_int*)XMALLOC(sizeof(mp_int) * 2, NULL, DYNAMIC_TYPE_RSA);
@@ -676,6 +735,14 @@ int wc_CheckRsaKey(RsaKey* key)
             ret = MP_EXPTMOD_E;
         }
     }
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    /* Include other primes of a multi-prime key. */
+    for (i = 0; ret == 0 && i < key->primes - 2; i++) {
+        if (mp_mul(tmp, &key->r[i], tmp) != MP_OKAY) {
+            ret = MP_EXPTMOD_E;
+        }
+    }
+#endif
     if (ret == 0 ) {
         if (mp_cmp(&key->n, tmp) != MP_EQ) {
             ret = MP_EXPTMOD_E;
@@ -747,6 +814,37 @@ int wc_CheckRsaKey(RsaKey* key)
                 ret = MP_EXPTMOD_E;
             }
         }
+
+    #ifdef WOLFSSL_RSA_MULTI_PRIME
+        /* k = product of primes before r_i */
+        if (ret == 0 && key->primes > 2) {
+            if (mp_mul(&key->p, &key->q, k) != MP_OKAY) {
+                ret = MP_EXPTMOD_E;
+            }
+        }
+        for (i = 0; ret == 0 && i < key->primes - 2; i++) {
+            /* Check dR <= r-1 and e*dR mod r-1 = 1. */
+            if (mp_sub_d(&key->r[i], 1, tmp) != MP_OKAY ||
+                    mp_cmp(&key->dR[i], tmp) != MP_LT ||
+                    mp_mulmod(&key->dR[i], &key->e, tmp, tmp) != MP_OKAY ||
+                    !mp_isone(tmp)) {
+                ret = MP_EXPTMOD_E;
+            }
+            /* Check tR <= r and tR*k mod r = 1. */
+            if (ret == 0) {
+                if (mp_cmp(&key->tR[i], &key->r[i]) != MP_LT ||
+                        mp_mulmod(&key->tR[i], k, &key->r[i], tmp) != MP_OKAY ||
+                        !mp_isone(tmp)) {
+                    ret = MP_EXPTMOD_E;
+                }
+            }
+            if (ret == 0) {
+                if (mp_mul(k, &key->r[i], k) != MP_OKAY) {
+                    ret = MP_EXPTMOD_E;
+                }
+            }
+        }
+    #endif
     }
 
     mp_forcezero(tmp);
@@ -1842,6 +1940,193 @@ static int wc_RsaFunctionNonBlock(const byte* in, word32 inLen, byte* out,
 }
 #endif /* WC_RSA_NONBLOCK */
 
+#if defined(WC_RSA_PREPARED) && defined(WC_RSA_BLINDING) && \
+    !defined(WC_NO_RNG) && !defined(WOLFSSL_SP_MATH)
+#ifndef RSA_PREPARED_BLIND_USES
+    /* private operations before a prepared key generates new blinding */
+    #define RSA_PREPARED_BLIND_USES 32
+#endif
+
+/* Update the cached blinding pair of a prepared key for the next use.
+ * A new pair is generated every RSA_PREPARED_BLIND_USES operations, otherwise
+ * both values are squared: (r^e)^2 = (r^2)^e and (1/r)^2 = 1/r^2 mod n.
+ *
+ * key  prepared RSA private key.
+ * rng  random number generator to generate a new pair with.
+ * returns 0 on success, otherwise MP math or RNG error.
+ */
+static int RsaPreparedBlind(RsaKey* key, WC_RNG* rng)
+{
+    int ret = 0;
+
+    if (key->blindUses == 0) {
+        /* blind */
+        ret = mp_rand(&key->blind, get_digit_count(&key->n), rng);
+
+        /* blindInv = 1/blind mod n */
+        if (ret == 0 && mp_invmod(&key->blind, &key->n,
+                                                 &key->blindInv) != MP_OKAY) {
+            ret = MP_INVMOD_E;
+        }
+
+        /* blind = blind^e */
+        if (ret == 0 && mp_exptmod(&key->blind, &key->e, &key->n,
+                                                    &key->blind) != MP_OKAY) {
+            ret = MP_EXPTMOD_E;
+        }
+    }
+    else {
+        if (mp_sqrmod(&key->blind, &key->n, &key->blind) != MP_OKAY)
+            ret = MP_MULMOD_E;
+
+        if (ret == 0 && mp_sqrmod(&key->blindInv, &key->n,
+                                                 &key->blindInv) != MP_OKAY) {
+            ret = MP_MULMOD_E;
+        }
+    }
+
+    /* pair is not usable after an error so generate a new one next time */
+    if (ret != 0 || ++key->blindUses == RSA_PREPARED_BLIND_USES)
+        key->blindUses = 0;
+
+    return ret;
+}
+#endif /* WC_RSA_PREPARED && WC_RSA_BLINDING && !WC_NO_RNG */
+
+#if defined(WOLFSSL_RSA_MULTI_PRIME) && !defined(RSA_LOW_MEM)
+/* r = b^e mod m where m is one of the primes of a multi-prime key.
+ * The SP code is used when it supports the size of the prime.
+ *
+ * b  base - may be larger than m.
+ * e  exponent, smaller than m.
+ * m  prime modulus.
+ * r  result.
+ * returns 0 on success, otherwise MP_EXPTMOD_E.
+ */
+static int RsaExptModPrime(mp_int* b, mp_int* e, mp_int* m, mp_int* r)
+{
+    int ret;
+
+#ifdef WOLFSSL_HAVE_SP_RSA
+    switch (mp_count_bits(m)) {
+    #ifndef WOLFSSL_SP_NO_2048
+        case 1024:
+            ret = mp_mod(b, m, r);
+            if (ret == MP_OKAY)
+                ret = sp_ModExp_1024(r, e, m, r);
+            return (ret == MP_OKAY) ? 0 : MP_EXPTMOD_E;
+        case 2048:
+            ret = mp_mod(b, m, r);
+            if (ret == MP_OKAY)
+                ret = sp_ModExp_2048(r, e, m, r);
+            return (ret == MP_OKAY) ? 0 : MP_EXPTMOD_E;
+    #endif
+    #ifndef WOLFSSL_SP_NO_3072
+        case 1536:
+            ret = mp_mod(b, m, r);
+            if (ret == MP_OKAY)
+                ret = sp_ModExp_1536(r, e, m, r);
+            return (ret == MP_OKAY) ? 0 : MP_EXPTMOD_E;
+        case 3072:
+            ret = mp_mod(b, m, r);
+            if (ret == MP_OKAY)
+                ret = sp_ModExp_3072(r, e, m, r);
+            return (ret == MP_OKAY) ? 0 : MP_EXPTMOD_E;
+    #endif
+        default:
+            break;
+    }
+#endif
+
+    ret = mp_exptmod(b, e, m, r);
+
+    return (ret == MP_OKAY) ? 0 : MP_EXPTMOD_E;
+}
+
+/* Private key operation using the CRT values of all the primes of a
+ * multi-prime key - RFC 8017, 5.1.2 RSADP step 2.b.
+ *
+ * tmp  number to exponentiate, replaced with the result.
+ * key  RSA private key with more than two primes.
+ * returns 0 on success, otherwise MP math or memory error.
+ */
+static int RsaFunctionMultiPrime(mp_int* tmp, RsaKey* key)
+{
+#ifdef WOLFSSL_SMALL_STACK
+    mp_int* m = NULL;
+#else
+    mp_int  m[RSA_MAX_PRIMES + 2];
+#endif
+    mp_int* h;
+    mp_int* R;
+    int     ret = 0;
+    int     i;
+    int     cnt = key->primes - 2;
+
+#ifdef WOLFSSL_SMALL_STACK
+    m = (mp_int*)XMALLOC(sizeof(mp_int) * (RSA_MAX_PRIMES + 2), key->heap,
+                                                             DYNAMIC_TYPE_RSA);
+    if (m == NULL)
+        return MEMORY_E;
+#endif
+    h = &m[RSA_MAX_PRIMES];
+    R = &m[RSA_MAX_PRIMES + 1];
+
+    for (i = 0; i < RSA_MAX_PRIMES + 2; i++) {
+        if (mp_init(&m[i]) != MP_OKAY)
+            ret = MP_INIT_E;
+    }
+
+    /* m_1 = tmp^dP mod p, m_2 = tmp^dQ mod q, m_i = tmp^d_i mod r_i */
+    if (ret == 0)
+        ret = RsaExptModPrime(tmp, &key->dP, &key->p, &m[0]);
+    if (ret == 0)
+        ret = RsaExptModPrime(tmp, &key->dQ, &key->q, &m[1]);
+    for (i = 0; ret == 0 && i < cnt; i++)
+        ret = RsaExptModPrime(tmp, &key->dR[i], &key->r[i], &m[i + 2]);
+
+    /* h = (m_1 - m_2) * qInv mod p */
+    if (ret == 0 && mp_sub(&m[0], &m[1], h) != MP_OKAY)
+        ret = MP_SUB_E;
+    if (ret == 0 && mp_mulmod(h, &key->u, &key->p, h) != MP_OKAY)
+        ret = MP_MULMOD_E;
+    /* tmp = m_2 + q * h */
+    if (ret == 0 && mp_mul(h, &key->q, tmp) != MP_OKAY)
+        ret = MP_MUL_E;
+    if (ret == 0 && mp_add(tmp, &m[1], tmp) != MP_OKAY)
+        ret = MP_ADD_E;
+
+    /* R = p * q */
+    if (ret == 0 && mp_mul(&key->p, &key->q, R) != MP_OKAY)
+        ret = MP_MUL_E;
+    for (i = 0; ret == 0 && i < cnt; i++) {
+        /* R = r_1 * r_2 * ... * r_(i-1) */
+        if (i > 0 && mp_mul(R, &key->r[i - 1], R) != MP_OKAY)
+            ret = MP_MUL_E;
+        /* h = (m_i - tmp) * t_i mod r_i */
+        if (ret == 0 && mp_sub(&m[i + 2], tmp, h) != MP_OKAY)
+            ret = MP_SUB_E;
+        if (ret == 0 && mp_mulmod(h, &key->tR[i], &key->r[i], h) != MP_OKAY)
+            ret = MP_MULMOD_E;
+        /* tmp = tmp + R * h */
+        if (ret == 0 && mp_mul(R, h, h) != MP_OKAY)
+            ret = MP_MUL_E;
+        if (ret == 0 && mp_add(tmp, h, tmp) != MP_OKAY)
+            ret = MP_ADD_E;
+    }
+
+    for (i = 0; i < RSA_MAX_PRIMES + 2; i++) {
+        mp_forcezero(&m[i]);
+        mp_clear(&m[i]);
+    }
+#ifdef WOLFSSL_SMALL_STACK
+    XFREE(m, key->heap, DYNAMIC_TYPE_RSA);
+#endif
+
+    return ret;
+}
+#endif /* WOLFSSL_RSA_MULTI_PRIME && !RSA_LOW_MEM */
+
 #ifdef WOLFSSL_AFALG_XILINX_RSA
 #ifndef ERROR_OUT
 #define ERROR_OUT(x) ret = (x); goto done
@@ -2030,6 +2315,10 @@ static int wc_RsaFunctionSync(const byte* in, word32 inLen, byte* out,
 #ifndef WOLFSSL_RSA_PUBLIC_ONLY
         case RSA_PRIVATE_DECRYPT:
         case RSA_PRIVATE_ENCRYPT:
+    #ifdef WOLFSSL_RSA_MULTI_PRIME
+            if (key->primes > 2)
+                break;
+    #endif
     #ifdef WC_RSA_BLINDING
             if (rng == NULL)
                 return MISSING_RNG_E;
@@ -2055,6 +2344,10 @@ static int wc_RsaFunctionSync(const byte* in, word32 inLen, byte* out,
 #ifndef WOLFSSL_RSA_PUBLIC_ONLY
         case RSA_PRIVATE_DECRYPT:
         case RSA_PRIVATE_ENCRYPT:
+    #ifdef WOLFSSL_RSA_MULTI_PRIME
+            if (key->primes > 2)
+                break;
+    #endif
     #ifdef WC_RSA_BLINDING
             if (rng == NULL)
                 return MISSING_RNG_E;
@@ -2080,6 +2373,10 @@ static int wc_RsaFunctionSync(const byte* in, word32 inLen, byte* out,
 #ifndef WOLFSSL_RSA_PUBLIC_ONLY
         case RSA_PRIVATE_DECRYPT:
         case RSA_PRIVATE_ENCRYPT:
+    #ifdef WOLFSSL_RSA_MULTI_PRIME
+            if (key->primes > 2)
+                break;
+    #endif
     #ifdef WC_RSA_BLINDING
             if (rng == NULL)
                 return MISSING_RNG_E;
@@ -2122,13 +2419,14 @@ static int wc_RsaFunctionSync(const byte* in, word32 inLen, byte* out,
 #endif /* WC_RSA_BLINDING */
 #endif /* WOLFSSL_SMALL_STACK */
 
-    if (mp_init(tmp) != MP_OKAY)
+    if (mp_init_size(tmp, MP_MOD_SIZE(&key->n)) != MP_OKAY)
         ret = MP_INIT_E;
 
 #ifdef WC_RSA_BLINDING
     if (ret == 0) {
         if (type == RSA_PRIVATE_DECRYPT || type == RSA_PRIVATE_ENCRYPT) {
-            if (mp_init_multi(rnd, rndi, NULL, NULL, NULL, NULL) != MP_OKAY) {
+            if (mp_init_multi_size(MP_MOD_SIZE(&key->n), rnd, rndi, NULL, NULL,
+                                                   NULL, NULL) != MP_OKAY) {
                 mp_clear(tmp);
                 ret = MP_INIT_E;
             }
@@ -2147,16 +2445,31 @@ static int wc_RsaFunctionSync(const byte* in, word32 inLen, byte* out,
         case RSA_PRIVATE_ENCRYPT:
         {
         #if defined(WC_RSA_BLINDING) && !defined(WC_NO_RNG)
-            /* blind */
-            ret = mp_rand(rnd, get_digit_count(&key->n), rng);
+        #ifdef WC_RSA_PREPARED
+            if (key->prepared) {
+                /* use cached blinding pair */
+                ret = RsaPreparedBlind(key, rng);
+                if (ret == 0)
+                    ret = mp_copy(&key->blind, rnd);
+                if (ret == 0)
+                    ret = mp_copy(&key->blindInv, rndi);
+            }
+            else
+        #endif
+            {
+                /* blind */
+                ret = mp_rand(rnd, get_digit_count(&key->n), rng);
 
-            /* rndi = 1/rnd mod n */
-            if (ret == 0 && mp_invmod(rnd, &key->n, rndi) != MP_OKAY)
-                ret = MP_INVMOD_E;
+                /* rndi = 1/rnd mod n */
+                if (ret == 0 && mp_invmod(rnd, &key->n, rndi) != MP_OKAY)
+                    ret = MP_INVMOD_E;
 
-            /* rnd = rnd^e */
-            if (ret == 0 && mp_exptmod(rnd, &key->e, &key->n, rnd) != MP_OKAY)
-                ret = MP_EXPTMOD_E;
+                /* rnd = rnd^e */
+                if (ret == 0 && mp_exptmod(rnd, &key->e, &key->n,
+                                                             rnd) != MP_OKAY) {
+                    ret = MP_EXPTMOD_E;
+                }
+            }
 
             /* tmp = tmp*rnd mod n */
             if (ret == 0 && mp_mulmod(tmp, rnd, &key->n, tmp) != MP_OKAY)
@@ -2167,6 +2480,11 @@ static int wc_RsaFunctionSync(const byte* in, word32 inLen, byte* out,
             if (ret == 0 && mp_exptmod(tmp, &key->d, &key->n, tmp) != MP_OKAY)
                 ret = MP_EXPTMOD_E;
         #else
+        #ifdef WOLFSSL_RSA_MULTI_PRIME
+            if (ret == 0 && key->primes > 2)
+                ret = RsaFunctionMultiPrime(tmp, key);
+            else
+        #endif
             if (ret == 0) {
             #ifdef WOLFSSL_SMALL_STACK
                 mp_int* tmpa = NULL;
@@ -2186,28 +2504,44 @@ static int wc_RsaFunctionSync(const byte* in, word32 inLen, byte* out,
             #endif
 
                 if (ret == 0) {
-                    if (mp_init(tmpa) != MP_OKAY)
+                    if (mp_init_size(tmpa, MP_MOD_SIZE(&key->n)) != MP_OKAY)
                         ret = MP_INIT_E;
                     else
                         cleara = 1;
                 }
 
                 if (ret == 0) {
-                    if (mp_init(tmpb) != MP_OKAY)
+                    if (mp_init_size(tmpb, MP_MOD_SIZE(&key->n)) != MP_OKAY)
                         ret = MP_INIT_E;
                     else
                         clearb = 1;
                 }
 
-                /* tmpa = tmp^dP mod p */
-                if (ret == 0 && mp_exptmod(tmp, &key->dP, &key->p,
+            #ifdef WC_RSA_PREPARED_MONT
+                if (key->prepared) {
+                    /* tmpa = tmp^dP mod p */
+                    if (ret == 0 && mp_exptmod_mont(tmp, &key->dP, &key->p,
+                                          &key->r2p, key->mpp, tmpa) != MP_OKAY)
+                        ret = MP_EXPTMOD_E;
+
+                    /* tmpb = tmp^dQ mod q */
+                    if (ret == 0 && mp_exptmod_mont(tmp, &key->dQ, &key->q,
+                                          &key->r2q, key->mpq, tmpb) != MP_OKAY)
+                        ret = MP_EXPTMOD_E;
+                }
+                else
+            #endif
+                {
+                    /* tmpa = tmp^dP mod p */
+                    if (ret == 0 && mp_exptmod(tmp, &key->dP, &key->p,
                                                                tmpa) != MP_OKAY)
-                    ret = MP_EXPTMOD_E;
+                        ret = MP_EXPTMOD_E;
 
-                /* tmpb = tmp^dQ mod q */
-                if (ret == 0 && mp_exptmod(tmp, &key->dQ, &key->q,
+                    /* tmpb = tmp^dQ mod q */
+                    if (ret == 0 && mp_exptmod(tmp, &key->dQ, &key->q,
                                                                tmpb) != MP_OKAY)
-                    ret = MP_EXPTMOD_E;
+                        ret = MP_EXPTMOD_E;
+                }
 
                 /* tmp = (tmpa - tmpb) * qInv (mod p) */
                 if (ret == 0 && mp_sub(tmpa, tmpb, tmp) != MP_OKAY)
@@ -3137,6 +3471,166 @@ int wc_RsaSSL_Verify(const byte* in, word32 inLen, byte* out, word32 outLen,
         RSA_PUBLIC_DECRYPT, RSA_BLOCK_TYPE_1, WC_RSA_PKCSV15_PAD,
         WC_HASH_TYPE_NONE, WC_MGF1NONE, NULL, 0, 0, rng);
 }
+
+#ifdef WC_RSA_BATCH
+#ifdef WOLFSSL_SP_RSA_BATCH
+/* Check whether the public key operation can be done in an SP batch.
+ * Only software 2048-bit keys not in the middle of an operation are batched.
+ *
+ * key    Public RSA key.
+ * inLen  Length of the signature.
+ * returns 1 when the operation can be batched and 0 otherwise.
+ */
+static int RsaBatchKey(RsaKey* key, word32 inLen)
+{
+    if (key->state != RSA_STATE_NONE || key->data != NULL)
+        return 0;
+#ifdef WOLF_CRYPTO_CB
+    if (key->devId != INVALID_DEVID)
+        return 0;
+#endif
+#if defined(WOLFSSL_ASYNC_CRYPT) && defined(WC_ASYNC_ENABLE_RSA)
+    if (key->asyncDev.marker == WOLFSSL_ASYNC_MARKER_RSA)
+        return 0;
+#endif
+#ifdef WC_RSA_NONBLOCK
+    if (key->nb != NULL)
+        return 0;
+#endif
+
+    return inLen == 256 && mp_count_bits(&key->n) == 2048;
+}
+
+/* Exponentiate the signatures together and then remove the padding from
+ * each.
+ *
+ * in      Array of signatures.
+ * inLen   Length of each signature.
+ * out     Array of buffers to hold the decoded data.
+ * outLen  Size of each output buffer.
+ * key     Array of public keys.
+ * res     Result of each verification.
+ * idx     Indices of the signatures to verify.
+ * cnt     Number of signatures to verify - at most SP_RSA_BATCH_SZ.
+ * returns 0 on success and MEMORY_E when dynamic memory allocation fails.
+ */
+static int RsaSSL_VerifyBatchSp(const byte** in, const word32* inLen,
+                                byte** out, const word32* outLen, RsaKey** key,
+                                int* res, const int* idx, int cnt)
+{
+#ifdef WOLFSSL_SMALL_STACK
+    byte* data;
+#else
+    byte data[SP_RSA_BATCH_SZ * 256];
+#endif
+    const byte* bIn[SP_RSA_BATCH_SZ];
+    word32 bInLen[SP_RSA_BATCH_SZ] = { 0 };
+    mp_int* e[SP_RSA_BATCH_SZ];
+    mp_int* n[SP_RSA_BATCH_SZ];
+    byte* bOut[SP_RSA_BATCH_SZ];
+    word32 bOutLen[SP_RSA_BATCH_SZ];
+    int bRes[SP_RSA_BATCH_SZ];
+    byte* pad;
+    int ret;
+    int i, j;
+
+#ifdef WOLFSSL_SMALL_STACK
+    data = (byte*)XMALLOC(SP_RSA_BATCH_SZ * 256, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    if (data == NULL)
+        return MEMORY_E;
+#endif
+
+    for (j = 0; j < cnt; j++) {
+        i = idx[j];
+        bIn[j] = in[i];
+        bInLen[j] = inLen[i];
+        e[j] = &key[i]->e;
+        n[j] = &key[i]->n;
+        bOut[j] = data + j * 256;
+        bOutLen[j] = 256;
+    }
+
+    ret = sp_RsaPublic_2048_batch(bIn, bInLen, e, n, bOut, bOutLen, bRes, cnt);
+    for (j = 0; ret == 0 && j < cnt; j++) {
+        i = idx[j];
+        res[i] = bRes[j];
+        if (res[i] != 0)
+            continue;
+
+        pad = NULL;
+        res[i] = wc_RsaUnPad_ex(bOut[j], bOutLen[j], &pad, RSA_BLOCK_TYPE_1,
+                                WC_RSA_PKCSV15_PAD, WC_HASH_TYPE_NONE,
+                                WC_MGF1NONE, NULL, 0, 0, 2048, key[i]->heap);
+        if (res[i] > (int)outLen[i] || res[i] == 0)
+            res[i] = RSA_BUFFER_E;
+        else if (res[i] > 0 && pad != NULL)
+            XMEMCPY(out[i], pad, res[i]);
+    }
+
+#ifdef WOLFSSL_SMALL_STACK
+    XFREE(data, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    return ret;
+}
+#endif /* WOLFSSL_SP_RSA_BATCH */
+
+/* Verify a batch of PKCS #1 v1.5 signatures, each with its own public key.
+ * Signatures made with 2048-bit keys are exponentiated together when the SP
+ * code supports it. All others are verified one at a time.
+ *
+ * in      Array of signatures.
+ * inLen   Length of each signature.
+ * out     Array of buffers to hold the decoded data.
+ * outLen  Size of each output buffer.
+ * key     Array of public keys. A key may appear more than once.
+ * res     Result of each verification: the length of the decoded data or a
+ *         negative error code.
+ * cnt     Number of signatures.
+ * returns 0 when the signatures were processed, BAD_FUNC_ARG when an array is
+ * NULL and MEMORY_E when dynamic memory allocation fails.
+ */
+int wc_RsaSSL_VerifyBatch(const byte** in, const word32* inLen, byte** out,
+                          const word32* outLen, RsaKey** key, int* res, int cnt)
+{
+    int ret = 0;
+    int i;
+#ifdef WOLFSSL_SP_RSA_BATCH
+    int idx[SP_RSA_BATCH_SZ];
+    int n = 0;
+#endif
+
+    if (in == NULL || inLen == NULL || out == NULL || outLen == NULL ||
+            key == NULL || res == NULL || cnt < 0) {
+        return BAD_FUNC_ARG;
+    }
+
+    for (i = 0; ret == 0 && i < cnt; i++) {
+        if (in[i] == NULL || out[i] == NULL || key[i] == NULL) {
+            res[i] = BAD_FUNC_ARG;
+            continue;
+        }
+#ifdef WOLFSSL_SP_RSA_BATCH
+        if (RsaBatchKey(key[i], inLen[i])) {
+            idx[n++] = i;
+            if (n == SP_RSA_BATCH_SZ) {
+                ret = RsaSSL_VerifyBatchSp(in, inLen, out, outLen, key, res,
+                                                                      idx, n);
+                n = 0;
+            }
+            continue;
+        }
+#endif
+        res[i] = wc_RsaSSL_Verify(in[i], inLen[i], out[i], outLen[i], key[i]);
+    }
+#ifdef WOLFSSL_SP_RSA_BATCH
+    if (ret == 0 && n > 0)
+        ret = RsaSSL_VerifyBatchSp(in, inLen, out, outLen, key, res, idx, n);
+#endif
+
+    return ret;
+}
+#endif /* WC_RSA_BATCH */
 #endif
 
 #ifdef WC_RSA_PSS
@@ -3862,17 +4356,335 @@ int wc_CheckProbablePrime(const byte* pRaw, word32 pRawSz,
 
 #if !defined(HAVE_FIPS) || (defined(HAVE_FIPS) && \
         defined(HAVE_FIPS_VERSION) && (HAVE_FIPS_VERSION >= 2))
+#ifndef WC_NO_RNG
+#ifdef WC_RSA_SIEVE
+#ifndef WC_RSA_SIEVE_PRIMES
+    /* number of small odd primes that candidates are sieved with */
+    #define WC_RSA_SIEVE_PRIMES 2048
+#endif
+#ifndef WC_RSA_SIEVE_RANGE
+    /* odd numbers after a random start that are searched before restarting,
+     * must fit in an mp_digit */
+    #define WC_RSA_SIEVE_RANGE  0x4000
+#endif
+#endif /* WC_RSA_SIEVE */
+
+/* Search for a prime shared by all jobs. */
+typedef struct RsaPrimeSearch {
+    mp_int*       prime;     /* prime found */
+    mp_int*       p;         /* p when searching for q, otherwise NULL */
+    mp_int*       e;         /* public exponent */
+#ifdef WC_RSA_SIEVE
+    const word16* sieve;     /* small odd primes */
+#endif
+    void*         heap;
+    int           size;      /* size of key in bits */
+    int           failCount; /* candidates to test before failing */
+    int           tested;    /* candidates tested by all jobs */
+    int           stop;      /* prime found or error */
+    int           err;       /* first error of a job */
+    wolfSSL_Mutex lock;
+} RsaPrimeSearch;
+
+/* Job searching for a prime. */
+typedef struct RsaPrimeJob {
+    RsaPrimeSearch* search;
+    WC_RNG*         rng;     /* NULL when job has its own */
+} RsaPrimeJob;
+
+#ifdef WC_RSA_SIEVE
+/* Fill sieve with the first WC_RSA_SIEVE_PRIMES odd primes. */
+static void RsaSieveInit(word16* sieve)
+{
+    word32 n;
+    int    cnt = 0, i;
+
+    for (n = 3; cnt < WC_RSA_SIEVE_PRIMES; n += 2) {
+        for (i = 0; i < cnt && (word32)sieve[i] * sieve[i] <= n; i++) {
+            if (n % sieve[i] == 0)
+                break;
+        }
+        if (i == cnt || (word32)sieve[i] * sieve[i] > n)
+            sieve[cnt++] = (word16)n;
+    }
+}
+
+#endif /* WC_RSA_SIEVE */
+
+/* Test a candidate for p or q and record the result in the search.
+ *
+ * search  search shared by all jobs.
+ * cand    candidate to test.
+ * rng     random number generator.
+ * done    set when the search is over.
+ * returns 0 on success, otherwise MP math, RNG or mutex error.
+ */
+static int RsaPrimeSearchTest(RsaPrimeSearch* search, mp_int* cand,
+                              WC_RNG* rng, int* done)
+{
+    int err, isPrime = 0;
+
+    if (search->p == NULL) {
+        err = _CheckProbablePrime(cand, NULL, search->e, search->size,
+                                                                &isPrime, rng);
+    }
+    else {
+        err = _CheckProbablePrime(search->p, cand, search->e, search->size,
+                                                                &isPrime, rng);
+    }
+    if (err != MP_OKAY)
+        return err;
+
+    if (wc_LockMutex(&search->lock) != 0)
+        return BAD_MUTEX_E;
+    search->tested++;
+    if (search->stop) {
+        *done = 1;
+    }
+    else if (isPrime) {
+        err = mp_copy(cand, search->prime);
+        search->stop = *done = 1;
+    }
+#ifdef HAVE_FIPS
+    else if (search->tested >= search->failCount) {
+        search->stop = *done = 1;
+    }
+#endif
+    wc_UnLockMutex(&search->lock);
+
+    return err;
+}
+
+/* Job that searches for a prime for p or q until one is found by any job.
+ * Each candidate is new random data by default. With WC_RSA_SIEVE, odd
+ * numbers following a random start are sieved incrementally with the
+ * residues of the start modulo small primes and only numbers with no small
+ * factor are tested.
+ *
+ * arg  RsaPrimeJob of this job.
+ */
+static void RsaPrimeSearchJob(void* arg)
+{
+    RsaPrimeJob*    job = (RsaPrimeJob*)arg;
+    RsaPrimeSearch* search = job->search;
+    WC_RNG          localRng;
+    WC_RNG*         rng = job->rng;
+    mp_int          start, cand;
+    byte*           buf = NULL;
+    int             err, done = 0;
+    int             primeSz = search->size / 16;
+#ifdef WC_RSA_SIEVE
+    mp_digit        r;
+    word16*         res = NULL;
+    word32          delta;
+    int             i;
+#endif
+
+    err = mp_init_multi(&start, &cand, NULL, NULL, NULL, NULL);
+    if (err == MP_OKAY) {
+        buf = (byte*)XMALLOC(primeSz, search->heap, DYNAMIC_TYPE_RSA);
+        if (buf == NULL)
+            err = MEMORY_E;
+    }
+#ifdef WC_RSA_SIEVE
+    if (err == MP_OKAY) {
+        res = (word16*)XMALLOC(sizeof(word16) * WC_RSA_SIEVE_PRIMES,
+                                          search->heap, DYNAMIC_TYPE_TMP_BUFFER);
+        if (res == NULL)
+            err = MEMORY_E;
+    }
+#endif
+    if (err == MP_OKAY && rng == NULL) {
+        err = wc_InitRng_ex(&localRng, search->heap, INVALID_DEVID);
+        if (err == 0)
+            rng = &localRng;
+    }
+
+    while (err == MP_OKAY && !done) {
+        /* stop when another job has finished */
+        if (wc_LockMutex(&search->lock) != 0) {
+            err = BAD_MUTEX_E;
+            break;
+        }
+        done = search->stop;
+        wc_UnLockMutex(&search->lock);
+        if (done)
+            break;
+
+#ifdef SHOW_GEN
+        printf(".");
+        fflush(stdout);
+#endif
+        /* generate value */
+        err = wc_RNG_GenerateBlock(rng, buf, primeSz);
+        if (err == 0) {
+            /* prime lower bound has the MSB set, set it in candidate */
+            buf[0] |= 0x80;
+            /* make candidate odd */
+            buf[primeSz-1] |= 0x01;
+            /* load value */
+            err = mp_read_unsigned_bin(&start, buf, primeSz);
+        }
+
+#ifndef WC_RSA_SIEVE
+        if (err == MP_OKAY)
+            err = RsaPrimeSearchTest(search, &start, rng, &done);
+#else
+        for (i = 0; err == MP_OKAY && i < WC_RSA_SIEVE_PRIMES; i++) {
+            err = mp_mod_d(&start, search->sieve[i], &r);
+            res[i] = (word16)r;
+        }
+
+        for (delta = 0; err == MP_OKAY && delta < WC_RSA_SIEVE_RANGE;
+                                                                  delta += 2) {
+            /* skip numbers with a small factor */
+            for (i = 0; i < WC_RSA_SIEVE_PRIMES; i++) {
+                if ((res[i] + delta) % search->sieve[i] == 0)
+                    break;
+            }
+            if (i < WC_RSA_SIEVE_PRIMES)
+                continue;
+
+            err = mp_add_d(&start, (mp_digit)delta, &cand);
+            /* start again when the candidate no longer fits */
+            if (err != MP_OKAY || mp_count_bits(&cand) > primeSz * 8)
+                break;
+
+            err = RsaPrimeSearchTest(search, &cand, rng, &done);
+            if (err != MP_OKAY || done)
+                break;
+        }
+#endif
+    }
+
+    if (err != MP_OKAY && wc_LockMutex(&search->lock) == 0) {
+        if (search->err == 0)
+            search->err = err;
+        search->stop = 1;
+        wc_UnLockMutex(&search->lock);
+    }
+
+    if (rng == &localRng)
+        wc_FreeRng(&localRng);
+    if (buf != NULL) {
+        ForceZero(buf, primeSz);
+        XFREE(buf, search->heap, DYNAMIC_TYPE_RSA);
+    }
+#ifdef WC_RSA_SIEVE
+    XFREE(res, search->heap, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+    mp_forcezero(&cand);
+    mp_clear(&cand);
+    mp_forcezero(&start);
+    mp_clear(&start);
+}
+
+/* Find a prime for p, or for q when p is not NULL.
+ * Without a pool one job is run with the RNG passed in. With a pool, one job
+ * is run on each thread, each with its own RNG, and the first prime found is
+ * used.
+ *
+ * prime  prime found.
+ * p      p when searching for q, otherwise NULL.
+ * e      public exponent.
+ * size   size of key in bits.
+ * sieve  small odd primes, NULL without WC_RSA_SIEVE.
+ * rng    random number generator.
+ * pool   thread pool or NULL.
+ * heap   heap hint.
+ * returns 0 on success, PRIME_GEN_E when no prime found in the candidates
+ * allowed, otherwise MP math, RNG, memory or thread pool error.
+ */
+static int RsaFindPrime(mp_int* prime, mp_int* p, mp_int* e, int size,
+                        const word16* sieve, WC_RNG* rng, RsaKeyGenPool* pool,
+                        void* heap)
+{
+    RsaPrimeSearch search;
+    RsaPrimeJob*   jobs = NULL;
+    void**         args = NULL;
+    int            err, i, cnt = 1;
+
+    XMEMSET(&search, 0, sizeof(search));
+    search.prime = prime;
+    search.p = p;
+    search.e = e;
+#ifdef WC_RSA_SIEVE
+    search.sieve = sieve;
+#else
+    (void)sieve;
+#endif
+    search.heap = heap;
+    search.size = size;
+    /* The failCount value comes from NIST FIPS 186-4, section B.3.3,
+     * process steps 4.7 and 5.8. */
+    search.failCount = 5 * (size / 2);
+
+    if (wc_InitMutex(&search.lock) != 0)
+        return BAD_MUTEX_E;
+
+    if (pool == NULL) {
+        RsaPrimeJob job;
+
+        job.search = &search;
+        job.rng = rng;
+        RsaPrimeSearchJob(&job);
+        err = search.err;
+    }
+    else {
+        cnt = pool->threads;
+        jobs = (RsaPrimeJob*)XMALLOC(sizeof(RsaPrimeJob) * cnt, heap,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+        args = (void**)XMALLOC(sizeof(void*) * cnt, heap,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+        if (jobs == NULL || args == NULL)
+            err = MEMORY_E;
+        else {
+            for (i = 0; i < cnt; i++) {
+                jobs[i].search = &search;
+                jobs[i].rng = NULL;
+                args[i] = &jobs[i];
+            }
+            err = pool->run(pool->ctx, RsaPrimeSearchJob, args, cnt);
+            if (err == 0)
+                err = search.err;
+        }
+        XFREE(args, heap, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(jobs, heap, DYNAMIC_TYPE_TMP_BUFFER);
+    }
+
+    /* stopped without a prime when failCount reached */
+    if (err == 0 && mp_iszero(prime))
+        err = PRIME_GEN_E;
+
+    wc_FreeMutex(&search.lock);
+
+    return err;
+}
+#endif /* !WC_NO_RNG */
+
 /* Make an RSA key for size bits, with e specified, 65537 is a good e */
 int wc_MakeRsaKey(RsaKey* key, int size, long e, WC_RNG* rng)
+{
+    return wc_MakeRsaKey_ex(key, size, e, rng, NULL);
+}
+
+/* Make an RSA key for size bits, with e specified, 65537 is a good e.
+ * The primes are searched for on the threads of pool when not NULL.
+ */
+int wc_MakeRsaKey_ex(RsaKey* key, int size, long e, WC_RNG* rng,
+                     RsaKeyGenPool* pool)
 {
 #ifndef WC_NO_RNG
     mp_int p, q, tmp1, tmp2, tmp3;
-    int err, i, failCount, primeSz, isPrime = 0;
-    byte* buf = NULL;
+    int err;
+    word16* sieve = NULL;
 
     if (key == NULL || rng == NULL)
         return BAD_FUNC_ARG;
 
+    if (pool != NULL && (pool->run == NULL || pool->threads <= 0))
+        return BAD_FUNC_ARG;
+
     if (!RsaSizeCheck(size))
         return BAD_FUNC_ARG;
 
@@ -3919,93 +4731,29 @@ int wc_MakeRsaKey(RsaKey* key, int size, long e, WC_RNG* rng)
     if (err == MP_OKAY)
         err = mp_set_int(&tmp3, e);
 
-    /* The failCount value comes from NIST FIPS 186-4, section B.3.3,
-     * process steps 4.7 and 5.8. */
-    failCount = 5 * (size / 2);
-    primeSz = size / 16; /* size is the size of n in bits.
-                            primeSz is in bytes. */
-
-    /* allocate buffer to work with */
+#ifdef WC_RSA_SIEVE
+    /* small primes to sieve candidates with */
     if (err == MP_OKAY) {
-        buf = (byte*)XMALLOC(primeSz, key->heap, DYNAMIC_TYPE_RSA);
-        if (buf == NULL)
+        sieve = (word16*)XMALLOC(sizeof(word16) * WC_RSA_SIEVE_PRIMES,
+                                             key->heap, DYNAMIC_TYPE_TMP_BUFFER);
+        if (sieve == NULL)
             err = MEMORY_E;
+        else
+            RsaSieveInit(sieve);
     }
-
-    /* make p */
-    if (err == MP_OKAY) {
-        isPrime = 0;
-        i = 0;
-        do {
-#ifdef SHOW_GEN
-            printf(".");
-            fflush(stdout);
-#endif
-            /* generate value */
-            err = wc_RNG_GenerateBlock(rng, buf, primeSz);
-            if (err == 0) {
-                /* prime lower bound has the MSB set, set it in candidate */
-                buf[0] |= 0x80;
-                /* make candidate odd */
-                buf[primeSz-1] |= 0x01;
-                /* load value */
-                err = mp_read_unsigned_bin(&p, buf, primeSz);
-            }
-
-            if (err == MP_OKAY)
-                err = _CheckProbablePrime(&p, NULL, &tmp3, size, &isPrime, rng);
-
-#ifdef HAVE_FIPS
-            i++;
-#else
-            /* Keep the old retry behavior in non-FIPS build. */
-            (void)i;
 #endif
-        } while (err == MP_OKAY && !isPrime && i < failCount);
-    }
 
-    if (err == MP_OKAY && !isPrime)
-        err = PRIME_GEN_E;
+    /* make p */
+    if (err == MP_OKAY)
+        err = RsaFindPrime(&p, NULL, &tmp3, size, sieve, rng, pool, key->heap);
 
     /* make q */
-    if (err == MP_OKAY) {
-        isPrime = 0;
-        i = 0;
-        do {
-#ifdef SHOW_GEN
-            printf(".");
-            fflush(stdout);
-#endif
-            /* generate value */
-            err = wc_RNG_GenerateBlock(rng, buf, primeSz);
-            if (err == 0) {
-                /* prime lower bound has the MSB set, set it in candidate */
-                buf[0] |= 0x80;
-                /* make candidate odd */
-                buf[primeSz-1] |= 0x01;
-                /* load value */
-                err = mp_read_unsigned_bin(&q, buf, primeSz);
-            }
-
-            if (err == MP_OKAY)
-                err = _CheckProbablePrime(&p, &q, &tmp3, size, &isPrime, rng);
+    if (err == MP_OKAY)
+        err = RsaFindPrime(&q, &p, &tmp3, size, sieve, rng, pool, key->heap);
 
-#ifdef HAVE_FIPS
-            i++;
-#else
-            /* Keep the old retry behavior in non-FIPS build. */
-            (void)i;
+#ifdef WC_RSA_SIEVE
+    XFREE(sieve, key->heap, DYNAMIC_TYPE_TMP_BUFFER);
 #endif
-        } while (err == MP_OKAY && !isPrime && i < failCount);
-    }
-
-    if (err == MP_OKAY && !isPrime)
-        err = PRIME_GEN_E;
-
-    if (buf) {
-        ForceZero(buf, primeSz);
-        XFREE(buf, key->heap, DYNAMIC_TYPE_RSA);
-    }
 
     if (err == MP_OKAY && mp_cmp(&p, &q) < 0) {
         err = mp_copy(&p, &tmp1);
@@ -4096,6 +4844,211 @@ int wc_MakeRsaKey(RsaKey* key, int size, long e, WC_RNG* rng)
     return NOT_COMPILED_IN;
 #endif
 }
+
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+#ifndef WC_NO_RNG
+/* Returns the i'th prime of a multi-prime key. */
+static mp_int* RsaKeyPrime(RsaKey* key, int i)
+{
+    if (i == 0)
+        return &key->p;
+    if (i == 1)
+        return &key->q;
+    return &key->r[i - 2];
+}
+
+/* Make a random prime of exactly bits bits for a multi-prime key.
+ * The top three bits are set so that the product of the primes has all the
+ * bits of the key size. (prime - 1) and e must be coprime.
+ *
+ * prime  generated prime.
+ * bits   size of prime in bits.
+ * e      public exponent.
+ * buf    buffer of (bits + 7) / 8 bytes to generate candidates in.
+ * rng    random number generator.
+ * returns 0 on success, otherwise MP math or RNG error.
+ */
+static int RsaMakePrime(mp_int* prime, int bits, mp_int* e, byte* buf,
+                        WC_RNG* rng)
+{
+    mp_int tmp1, tmp2;
+    int    err, i, isPrime = 0;
+    int    sz = (bits + 7) / 8;
+
+    err = mp_init_multi(&tmp1, &tmp2, NULL, NULL, NULL, NULL);
+
+    while (err == MP_OKAY && !isPrime) {
+        err = wc_RNG_GenerateBlock(rng, buf, sz);
+        if (err == 0) {
+            /* keep bits bits, set top three bits and make candidate odd */
+            buf[0] &= (byte)(0xff >> (sz * 8 - bits));
+            for (i = bits - 3; i < bits; i++)
+                buf[sz - 1 - i / 8] |= (byte)(1 << (i % 8));
+            buf[sz - 1] |= 0x01;
+            err = mp_read_unsigned_bin(prime, buf, sz);
+        }
+
+        /* gcd(prime - 1, e) == 1 */
+        if (err == MP_OKAY)
+            err = mp_sub_d(prime, 1, &tmp1);
+        if (err == MP_OKAY)
+            err = mp_gcd(&tmp1, e, &tmp2);
+        if (err == MP_OKAY && mp_cmp_d(&tmp2, 1) != MP_EQ)
+            continue;
+
+        if (err == MP_OKAY)
+            err = mp_prime_is_prime_ex(prime, 8, &isPrime, rng);
+    }
+
+    mp_clear(&tmp1);
+    mp_clear(&tmp2);
+    return err;
+}
+#endif /* !WC_NO_RNG */
+
+/* Make a multi-prime RSA key for size bits, with e specified - RFC 8017.
+ * The primes are of equal size and the private operation is faster with each
+ * extra prime. As with other implementations, the number of primes is limited
+ * by key size to keep the primes too large to find with ECM:
+ * 3 primes below 4096 bits and 4 primes from 4096 bits.
+ *
+ * key     RSA key to make.
+ * size    size of modulus in bits.
+ * e       public exponent, 65537 is a good e.
+ * primes  number of primes, 2 to RSA_MAX_PRIMES.
+ * rng     random number generator.
+ * returns 0 on success, BAD_FUNC_ARG when the parameters are invalid,
+ * otherwise MP math, RNG or memory error.
+ */
+int wc_MakeRsaKeyMultiPrime(RsaKey* key, int size, long e, int primes,
+                            WC_RNG* rng)
+{
+#ifndef WC_NO_RNG
+    mp_int  tmp1, tmp2, tmp3;
+    mp_int* prime;
+    int     err, i, j, bits;
+    byte*   buf = NULL;
+
+    if (key == NULL || rng == NULL)
+        return BAD_FUNC_ARG;
+    if (primes == 2)
+        return wc_MakeRsaKey(key, size, e, rng);
+
+    if (!RsaSizeCheck(size) || size < 1024)
+        return BAD_FUNC_ARG;
+    if (primes < 2 || primes > RSA_MAX_PRIMES ||
+                                          (primes > 3 && size < 4096)) {
+        return BAD_FUNC_ARG;
+    }
+    if (e < 3 || (e & 1) == 0)
+        return BAD_FUNC_ARG;
+
+    err = mp_init_multi(&tmp1, &tmp2, &tmp3, NULL, NULL, NULL);
+    if (err == MP_OKAY)
+        err = mp_set_int(&key->e, (mp_digit)e);
+
+    /* largest prime has one more bit when size doesn't divide evenly */
+    if (err == MP_OKAY) {
+        buf = (byte*)XMALLOC(size / primes / 8 + 1, key->heap,
+                                                             DYNAMIC_TYPE_RSA);
+        if (buf == NULL)
+            err = MEMORY_E;
+    }
+
+    /* make distinct primes whose sizes sum to size */
+    for (i = 0; err == MP_OKAY && i < primes; i++) {
+        bits = size / primes + (i < size % primes);
+        prime = RsaKeyPrime(key, i);
+        do {
+#ifdef SHOW_GEN
+            printf(".");
+            fflush(stdout);
+#endif
+            err = RsaMakePrime(prime, bits, &key->e, buf, rng);
+            for (j = 0; err == MP_OKAY && j < i; j++) {
+                if (mp_cmp(prime, RsaKeyPrime(key, j)) == MP_EQ)
+                    break;
+            }
+        } while (err == MP_OKAY && j < i);
+    }
+
+    if (buf) {
+        ForceZero(buf, size / primes / 8 + 1);
+        XFREE(buf, key->heap, DYNAMIC_TYPE_RSA);
+    }
+
+    /* tmp3 = lcm(p-1, q-1, r_1-1, ...), n = p * q * r_1 * ... */
+    if (err == MP_OKAY)
+        err = mp_set_int(&tmp3, 1);
+    if (err == MP_OKAY)
+        err = mp_set_int(&key->n, 1);
+    for (i = 0; err == MP_OKAY && i < primes; i++) {
+        err = mp_sub_d(RsaKeyPrime(key, i), 1, &tmp1);
+        if (err == MP_OKAY)
+            err = mp_lcm(&tmp3, &tmp1, &tmp3);
+        if (err == MP_OKAY)
+            err = mp_mul(&key->n, RsaKeyPrime(key, i), &key->n);
+    }
+    if (err == MP_OKAY)                /* key->d = 1/e mod lcm */
+        err = mp_invmod(&key->e, &tmp3, &key->d);
+
+    if (err == MP_OKAY)                /* key->dP = d mod(p-1) */
+        err = mp_sub_d(&key->p, 1, &tmp1);
+    if (err == MP_OKAY)
+        err = mp_mod(&key->d, &tmp1, &key->dP);
+    if (err == MP_OKAY)                /* key->dQ = d mod(q-1) */
+        err = mp_sub_d(&key->q, 1, &tmp1);
+    if (err == MP_OKAY)
+        err = mp_mod(&key->d, &tmp1, &key->dQ);
+    if (err == MP_OKAY)                /* key->u = 1/q mod p */
+        err = mp_invmod(&key->q, &key->p, &key->u);
+
+    /* tmp2 = product of primes before r_i */
+    if (err == MP_OKAY)
+        err = mp_mul(&key->p, &key->q, &tmp2);
+    for (i = 0; err == MP_OKAY && i < primes - 2; i++) {
+        err = mp_sub_d(&key->r[i], 1, &tmp1);
+        if (err == MP_OKAY)            /* key->dR = d mod(r_i-1) */
+            err = mp_mod(&key->d, &tmp1, &key->dR[i]);
+        if (err == MP_OKAY)            /* key->tR = 1/tmp2 mod r_i */
+            err = mp_invmod(&tmp2, &key->r[i], &key->tR[i]);
+        if (err == MP_OKAY)
+            err = mp_mul(&tmp2, &key->r[i], &tmp2);
+    }
+
+    if (err == MP_OKAY) {
+        key->primes = primes;
+        key->type = RSA_PRIVATE;
+    }
+
+    mp_forcezero(&tmp1);
+    mp_clear(&tmp1);
+    mp_clear(&tmp2);
+    mp_forcezero(&tmp3);
+    mp_clear(&tmp3);
+
+#ifndef WOLFSSL_NO_RSA_KEY_CHECK
+    /* Perform the pair-wise consistency test on the new key. */
+    if (err == 0)
+        err = wc_CheckRsaKey(key);
+#endif
+
+    if (err != 0) {
+        wc_FreeRsaKey(key);
+        return err;
+    }
+
+    return 0;
+#else
+    (void)key;
+    (void)size;
+    (void)e;
+    (void)primes;
+    (void)rng;
+    return NOT_COMPILED_IN;
+#endif
+}
+#endif /* WOLFSSL_RSA_MULTI_PRIME */
 #endif /* !FIPS || FIPS_VER >= 2 */
 #endif /* WOLFSSL_KEY_GEN */
 
@@ -4112,6 +5065,61 @@ int wc_RsaSetRNG(RsaKey* key, WC_RNG* rng)
 }
 #endif /* WC_RSA_BLINDING */
 
+#ifdef WC_RSA_PREPARED
+/* Prepare an RSA private key for many private key operations.
+ * The Montgomery values of the CRT primes are calculated once (fast math
+ * only) and, with blinding, the blinding pair is cached and updated by
+ * squaring rather than inverting a new random value for every operation.
+ * The key must not be used by more than one thread at a time as private key
+ * operations update the cached blinding pair.
+ * Key sizes handled by the SP code are not changed as that code doesn't use
+ * the cached values.
+ *
+ * key  RSA private key.
+ * returns BAD_FUNC_ARG when key is NULL or not a private key, MP_INIT_E or
+ * MP_EXPTMOD_E on math error and 0 on success.
+ */
+int wc_RsaPrepareKey(RsaKey* key)
+{
+    int ret = 0;
+
+    if (key == NULL || key->type != RSA_PRIVATE)
+        return BAD_FUNC_ARG;
+
+    if (key->prepared)
+        RsaPreparedFree(key);
+
+#ifdef WC_RSA_BLINDING
+    if (mp_init_multi(&key->blind, &key->blindInv, NULL, NULL, NULL,
+                                                            NULL) != MP_OKAY) {
+        ret = MP_INIT_E;
+    }
+    /* new blinding pair generated on first use */
+    key->blindUses = 0;
+#endif
+#ifdef WC_RSA_PREPARED_MONT
+    if (ret == 0 && mp_init_multi(&key->r2p, &key->r2q, NULL, NULL, NULL,
+                                                            NULL) != MP_OKAY) {
+        ret = MP_INIT_E;
+    }
+    if (ret == 0 && mp_exptmod_mont_setup(&key->p, &key->r2p,
+                                                        &key->mpp) != MP_OKAY) {
+        ret = MP_EXPTMOD_E;
+    }
+    if (ret == 0 && mp_exptmod_mont_setup(&key->q, &key->r2q,
+                                                        &key->mpq) != MP_OKAY) {
+        ret = MP_EXPTMOD_E;
+    }
+#endif
+
+    key->prepared = 1;
+    if (ret != 0)
+        RsaPreparedFree(key);
+
+    return ret;
+}
+#endif /* WC_RSA_PREPARED */
+
 #ifdef WC_RSA_NONBLOCK
 int wc_RsaSetNonBlock(RsaKey* key, RsaNb* nb)
 {
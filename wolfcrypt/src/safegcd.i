@@ -0,0 +1,255 @@
+/* safegcd.i
+ *
+ * Copyright (C) 2006-2019 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ */
+
+
+
+/* Constant time modular inversion for odd moduli of up to 256 bits using the
+ * divstep based algorithm of Bernstein and Yang ("safegcd"):
+ *   https://eprint.iacr.org/2019/266
+ *
+ * Numbers are held as 5 signed 64-bit words of 62 bits each, with the top
+ * word holding the remaining bits and the sign. 59 divsteps are performed on
+ * the bottom 64 bits at a time and the resulting 2x2 transition matrix is
+ * then applied to the full numbers. 10 batches, 590 divsteps, are enough for
+ * any input of up to 256 bits.
+ *
+ * The number of operations and memory accesses do not depend on the value
+ * being inverted. Requires a 128-bit integer type.
+ */
+
+#define SAFEGCD_MASK    ((int64_t)(0xffffffffffffffffUL >> 2))
+
+/* Modulus to invert with. */
+typedef struct safegcd_mod {
+    int64_t  m[5];      /* modulus in 62-bit words            */
+    uint64_t mInv;      /* modulus ^ -1 mod 2^62               */
+} safegcd_mod;
+
+/* Transition matrix of 59 divsteps, scaled by 2^62. */
+typedef struct safegcd_trans {
+    int64_t u;
+    int64_t v;
+    int64_t q;
+    int64_t r;
+} safegcd_trans;
+
+/* Perform 59 divsteps on the bottom 64 bits of f and g.
+ *
+ * zeta  -(delta + 1/2) on entry, where delta is the divstep state.
+ * f0    Bottom word of f.
+ * g0    Bottom word of g.
+ * t     Transition matrix of the divsteps, scaled by 2^62.
+ * returns the new value of zeta.
+ */
+static int64_t safegcd_divsteps_59(int64_t zeta, uint64_t f0, uint64_t g0,
+        safegcd_trans* t)
+{
+    uint64_t u = 8, v = 0, q = 0, r = 8;
+    volatile uint64_t c1, c2;
+    uint64_t mask1, mask2, f = f0, g = g0, x, y, z;
+    int i;
+
+    for (i = 3; i < 62; i++) {
+        /* Masks for zeta < 0 and g odd. */
+        c1 = (uint64_t)(zeta >> 63);
+        mask1 = c1;
+        c2 = g & 1;
+        mask2 = 0 - c2;
+        /* When g is odd: add f, or -f when zeta < 0, to g. */
+        x = (f ^ mask1) - mask1;
+        y = (u ^ mask1) - mask1;
+        z = (v ^ mask1) - mask1;
+        g += x & mask2;
+        q += y & mask2;
+        r += z & mask2;
+        /* When zeta < 0 and g odd: swap, by adding the new g to f, and
+         * zeta = -zeta - 2. Otherwise zeta = zeta - 1. */
+        mask1 &= mask2;
+        zeta = (zeta ^ (int64_t)mask1) - 1;
+        f += g & mask1;
+        u += q & mask1;
+        v += r & mask1;
+        g >>= 1;
+        u <<= 1;
+        v <<= 1;
+    }
+
+    t->u = (int64_t)u;
+    t->v = (int64_t)v;
+    t->q = (int64_t)q;
+    t->r = (int64_t)r;
+
+    return zeta;
+}
+
+/* Apply the transition matrix to d and e modulo the modulus.
+ * (d, e) = t * (d, e) / 2^62 mod m
+ * d and e are in the range (-2m, m) on entry and exit.
+ *
+ * d    First number.
+ * e    Second number.
+ * t    Transition matrix.
+ * mod  Modulus.
+ */
+static void safegcd_update_de(int64_t* d, int64_t* e, const safegcd_trans* t,
+        const safegcd_mod* mod)
+{
+    const int64_t u = t->u, v = t->v, q = t->q, r = t->r;
+    int64_t md, me, sd, se;
+    __int128_t cd, ce;
+    int i;
+
+    /* Add m when d or e is negative to keep the result in range. */
+    sd = d[4] >> 63;
+    se = e[4] >> 63;
+    md = (u & sd) + (v & se);
+    me = (q & sd) + (r & se);
+    cd = (__int128_t)u * d[0] + (__int128_t)v * e[0];
+    ce = (__int128_t)q * d[0] + (__int128_t)r * e[0];
+    /* Choose multiples of m that make the bottom 62 bits zero. */
+    md -= (int64_t)((mod->mInv * (uint64_t)cd + (uint64_t)md) &
+                                                       (uint64_t)SAFEGCD_MASK);
+    me -= (int64_t)((mod->mInv * (uint64_t)ce + (uint64_t)me) &
+                                                       (uint64_t)SAFEGCD_MASK);
+    cd += (__int128_t)mod->m[0] * md;
+    ce += (__int128_t)mod->m[0] * me;
+    cd >>= 62;
+    ce >>= 62;
+    for (i = 1; i < 5; i++) {
+        cd += (__int128_t)u * d[i] + (__int128_t)v * e[i];
+        ce += (__int128_t)q * d[i] + (__int128_t)r * e[i];
+        cd += (__int128_t)mod->m[i] * md;
+        ce += (__int128_t)mod->m[i] * me;
+        d[i - 1] = (int64_t)cd & SAFEGCD_MASK;
+        e[i - 1] = (int64_t)ce & SAFEGCD_MASK;
+        cd >>= 62;
+        ce >>= 62;
+    }
+    d[4] = (int64_t)cd;
+    e[4] = (int64_t)ce;
+}
+
+/* Apply the transition matrix to f and g.
+ * (f, g) = t * (f, g) / 2^62
+ *
+ * f  First number.
+ * g  Second number.
+ * t  Transition matrix.
+ */
+static void safegcd_update_fg(int64_t* f, int64_t* g, const safegcd_trans* t)
+{
+    const int64_t u = t->u, v = t->v, q = t->q, r = t->r;
+    __int128_t cf, cg;
+    int i;
+
+    /* Bottom 62 bits are zero. */
+    cf = (__int128_t)u * f[0] + (__int128_t)v * g[0];
+    cg = (__int128_t)q * f[0] + (__int128_t)r * g[0];
+    cf >>= 62;
+    cg >>= 62;
+    for (i = 1; i < 5; i++) {
+        cf += (__int128_t)u * f[i] + (__int128_t)v * g[i];
+        cg += (__int128_t)q * f[i] + (__int128_t)r * g[i];
+        f[i - 1] = (int64_t)cf & SAFEGCD_MASK;
+        g[i - 1] = (int64_t)cg & SAFEGCD_MASK;
+        cf >>= 62;
+        cg >>= 62;
+    }
+    f[4] = (int64_t)cf;
+    g[4] = (int64_t)cg;
+}
+
+/* Bring d into the range [0, m) and negate it when sign is negative.
+ *
+ * d     Number in the range (-2m, m).
+ * sign  Negative when d is to be negated.
+ * mod   Modulus.
+ */
+static void safegcd_norm(int64_t* d, int64_t sign, const safegcd_mod* mod)
+{
+    volatile int64_t condAdd, condNeg;
+    int i;
+
+    condAdd = d[4] >> 63;
+    for (i = 0; i < 5; i++) {
+        d[i] += mod->m[i] & condAdd;
+    }
+    condNeg = sign >> 63;
+    for (i = 0; i < 5; i++) {
+        d[i] = (d[i] ^ condNeg) - condNeg;
+    }
+    for (i = 0; i < 4; i++) {
+        d[i + 1] += d[i] >> 62;
+        d[i] &= SAFEGCD_MASK;
+    }
+
+    condAdd = d[4] >> 63;
+    for (i = 0; i < 5; i++) {
+        d[i] += mod->m[i] & condAdd;
+    }
+    for (i = 0; i < 4; i++) {
+        d[i + 1] += d[i] >> 62;
+        d[i] &= SAFEGCD_MASK;
+    }
+}
+
+/* Invert the number modulo the modulus. (r = 1 / a mod m)
+ * The inverse of 0 is 0.
+ *
+ * r    Inverse result as 4 little-endian 64-bit words.
+ * a    Number to invert as 4 little-endian 64-bit words. Less than m.
+ * mod  Modulus - odd.
+ */
+static void safegcd_inv_256(uint64_t* r, const uint64_t* a,
+        const safegcd_mod* mod)
+{
+    int64_t d[5] = { 0, 0, 0, 0, 0 };
+    int64_t e[5] = { 1, 0, 0, 0, 0 };
+    int64_t f[5];
+    int64_t g[5];
+    int64_t zeta = -1;
+    safegcd_trans t;
+    int i;
+
+    XMEMCPY(f, mod->m, sizeof(f));
+    g[0] = (int64_t)( a[0]                 ) & SAFEGCD_MASK;
+    g[1] = (int64_t)((a[0] >> 62) | (a[1] <<  2)) & SAFEGCD_MASK;
+    g[2] = (int64_t)((a[1] >> 60) | (a[2] <<  4)) & SAFEGCD_MASK;
+    g[3] = (int64_t)((a[2] >> 58) | (a[3] <<  6)) & SAFEGCD_MASK;
+    g[4] = (int64_t)( a[3] >> 56);
+
+    for (i = 0; i < 10; i++) {
+        zeta = safegcd_divsteps_59(zeta, (uint64_t)f[0], (uint64_t)g[0], &t);
+        safegcd_update_de(d, e, &t, mod);
+        safegcd_update_fg(f, g, &t);
+    }
+    /* f is now +/-1 and d is +/-1/a. */
+    safegcd_norm(d, f[4], mod);
+
+    r[0] = ((uint64_t)d[0]      ) | ((uint64_t)d[1] << 62);
+    r[1] = ((uint64_t)d[1] >>  2) | ((uint64_t)d[2] << 60);
+    r[2] = ((uint64_t)d[2] >>  4) | ((uint64_t)d[3] << 58);
+    r[3] = ((uint64_t)d[3] >>  6) | ((uint64_t)d[4] << 56);
+
+    ForceZero(g, sizeof(g));
+    ForceZero(e, sizeof(e));
+    ForceZero(d, sizeof(d));
+}
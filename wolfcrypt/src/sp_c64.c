@@ -12255,6 +12255,8 @@ int sp_DhExp_4096(mp_int* base, const byte* exp, word32 expLen,
 
 #endif /* WOLFSSL_HAVE_SP_RSA || WOLFSSL_HAVE_SP_DH */
 #ifdef WOLFSSL_HAVE_SP_ECC
+#include "safegcd.i"
+
 #ifndef WOLFSSL_SP_NO_256
 
 /* Point structure to use. */
@@ -12277,6 +12279,17 @@ static const sp_digit p256_norm_mod[5] = {
 };
 /* The Montogmery multiplier for modulus of the curve P256. */
 static const sp_digit p256_mp_mod = 0x0000000000001;
+/* R^3 mod modulus of the curve P256 (R = 2^256). */
+static const sp_digit p256_mod_r3[5] = {
+    0xffffd0000000aL,0xedfffffff7fffL,0xffffffcffffffL,0x000100000005fL,
+    0x0000000180000L
+};
+/* The modulus of the curve P256 for inversion. */
+static const safegcd_mod p256_mod_inv = {
+    { 0x3fffffffffffffffL,0x00000003ffffffffL,0x0000000000000000L,
+      0x3fffffc000000040L,0x00000000000000ffL },
+    0x3fffffffffffffffUL
+};
 #if defined(WOLFSSL_VALIDATE_ECC_KEYGEN) || defined(HAVE_ECC_SIGN) || \
                                             defined(HAVE_ECC_VERIFY)
 /* The order of the curve P256. */
@@ -12300,6 +12313,17 @@ static const sp_digit p256_norm_order[5] = {
 #if defined(HAVE_ECC_SIGN) || defined(HAVE_ECC_VERIFY)
 /* The Montogmery multiplier for order of the curve P256. */
 static const sp_digit p256_mp_order = 0x1c8aaee00bc4fL;
+/* R^3 mod order of the curve P256 (R = 2^256). */
+static const sp_digit p256_order_r3[5] = {
+    0xebec90b65a624L,0xae0c0555c9ac8L,0xba5e93f111f28L,0xbe652543b9246L,
+    0x0503a54e76407L
+};
+/* The order of the curve P256 for inversion. */
+static const safegcd_mod p256_order_inv = {
+    { 0x33b9cac2fc632551L,0x339beab69c5e7a13L,0x3ffffffffffffffbL,
+      0x3fffffc00000003fL,0x00000000000000ffL },
+    0x332e375511ff43b1UL
+};
 #endif
 /* The base point of curve P256. */
 static const sp_point p256_base = {
@@ -13048,7 +13072,7 @@ static void sp_256_mont_sqr_5(sp_digit* r, const sp_digit* a, const sp_digit* m,
     sp_256_mont_reduce_5(r, m, mp);
 }
 
-#if !defined(WOLFSSL_SP_SMALL) || defined(HAVE_COMP_KEY)
+#ifdef HAVE_COMP_KEY
 /* Square the Montgomery form number a number of times. (r = a ^ n mod m)
  *
  * r   Result of squaring.
@@ -13066,17 +13090,37 @@ static void sp_256_mont_sqr_n_5(sp_digit* r, const sp_digit* a, int n,
     }
 }
 
-#endif /* !WOLFSSL_SP_SMALL || HAVE_COMP_KEY */
-#ifdef WOLFSSL_SP_SMALL
-/* Mod-2 for the P256 curve. */
-static const uint64_t p256_mod_2[4] = {
-    0xfffffffffffffffdU,0x00000000ffffffffU,0x0000000000000000U,
-    0xffffffff00000001U
-};
-#endif /* !WOLFSSL_SP_SMALL */
+#endif /* HAVE_COMP_KEY */
+/* Convert the normalized number to 64-bit words.
+ *
+ * r  Number as 4 little-endian 64-bit words.
+ * a  Normalized number less than 2^256.
+ */
+static void sp_256_to_words_5(uint64_t* r, const sp_digit* a)
+{
+    r[0] = ((uint64_t)a[0]      ) | ((uint64_t)a[1] << 52);
+    r[1] = ((uint64_t)a[1] >> 12) | ((uint64_t)a[2] << 40);
+    r[2] = ((uint64_t)a[2] >> 24) | ((uint64_t)a[3] << 28);
+    r[3] = ((uint64_t)a[3] >> 36) | ((uint64_t)a[4] << 16);
+}
+
+/* Convert 64-bit words to a normalized number.
+ *
+ * r  Normalized number.
+ * a  Number as 4 little-endian 64-bit words.
+ */
+static void sp_256_from_words_5(sp_digit* r, const uint64_t* a)
+{
+    r[0] = (sp_digit)( a[0]                      ) & 0xfffffffffffffL;
+    r[1] = (sp_digit)((a[0] >> 52) | (a[1] << 12)) & 0xfffffffffffffL;
+    r[2] = (sp_digit)((a[1] >> 40) | (a[2] << 24)) & 0xfffffffffffffL;
+    r[3] = (sp_digit)((a[2] >> 28) | (a[3] << 36)) & 0xfffffffffffffL;
+    r[4] = (sp_digit)( a[3] >> 16);
+}
 
 /* Invert the number, in Montgomery form, modulo the modulus (prime) of the
  * P256 curve. (r = 1 / a mod m)
+ * Uses constant time divsteps (safegcd) on the reduced number.
  *
  * r   Inverse result.
  * a   Number to invert.
@@ -13084,69 +13128,23 @@ static const uint64_t p256_mod_2[4] = {
  */
 static void sp_256_mont_inv_5(sp_digit* r, const sp_digit* a, sp_digit* td)
 {
-#ifdef WOLFSSL_SP_SMALL
     sp_digit* t = td;
-    int i;
+    uint64_t w[4];
+    sp_digit n;
 
-    XMEMCPY(t, a, sizeof(sp_digit) * 5);
-    for (i=254; i>=0; i--) {
-        sp_256_mont_sqr_5(t, t, p256_mod, p256_mp_mod);
-        if (p256_mod_2[i / 64] & ((sp_digit)1 << (i % 64)))
-            sp_256_mont_mul_5(t, t, a, p256_mod, p256_mp_mod);
-    }
-    XMEMCPY(r, t, sizeof(sp_digit) * 5);
-#else
-    sp_digit* t = td;
-    sp_digit* t2 = td + 2 * 5;
-    sp_digit* t3 = td + 4 * 5;
-
-    /* t = a^2 */
-    sp_256_mont_sqr_5(t, a, p256_mod, p256_mp_mod);
-    /* t = a^3 = t * a */
-    sp_256_mont_mul_5(t, t, a, p256_mod, p256_mp_mod);
-    /* t2= a^c = t ^ 2 ^ 2 */
-    sp_256_mont_sqr_n_5(t2, t, 2, p256_mod, p256_mp_mod);
-    /* t3= a^d = t2 * a */
-    sp_256_mont_mul_5(t3, t2, a, p256_mod, p256_mp_mod);
-    /* t = a^f = t2 * t */
-    sp_256_mont_mul_5(t, t2, t, p256_mod, p256_mp_mod);
-    /* t2= a^f0 = t ^ 2 ^ 4 */
-    sp_256_mont_sqr_n_5(t2, t, 4, p256_mod, p256_mp_mod);
-    /* t3= a^fd = t2 * t3 */
-    sp_256_mont_mul_5(t3, t2, t3, p256_mod, p256_mp_mod);
-    /* t = a^ff = t2 * t */
-    sp_256_mont_mul_5(t, t2, t, p256_mod, p256_mp_mod);
-    /* t2= a^ff00 = t ^ 2 ^ 8 */
-    sp_256_mont_sqr_n_5(t2, t, 8, p256_mod, p256_mp_mod);
-    /* t3= a^fffd = t2 * t3 */
-    sp_256_mont_mul_5(t3, t2, t3, p256_mod, p256_mp_mod);
-    /* t = a^ffff = t2 * t */
-    sp_256_mont_mul_5(t, t2, t, p256_mod, p256_mp_mod);
-    /* t2= a^ffff0000 = t ^ 2 ^ 16 */
-    sp_256_mont_sqr_n_5(t2, t, 16, p256_mod, p256_mp_mod);
-    /* t3= a^fffffffd = t2 * t3 */
-    sp_256_mont_mul_5(t3, t2, t3, p256_mod, p256_mp_mod);
-    /* t = a^ffffffff = t2 * t */
-    sp_256_mont_mul_5(t, t2, t, p256_mod, p256_mp_mod);
-    /* t = a^ffffffff00000000 = t ^ 2 ^ 32  */
-    sp_256_mont_sqr_n_5(t2, t, 32, p256_mod, p256_mp_mod);
-    /* t2= a^ffffffffffffffff = t2 * t */
-    sp_256_mont_mul_5(t, t2, t, p256_mod, p256_mp_mod);
-    /* t2= a^ffffffff00000001 = t2 * a */
-    sp_256_mont_mul_5(t2, t2, a, p256_mod, p256_mp_mod);
-    /* t2= a^ffffffff000000010000000000000000000000000000000000000000
-     *   = t2 ^ 2 ^ 160 */
-    sp_256_mont_sqr_n_5(t2, t2, 160, p256_mod, p256_mp_mod);
-    /* t2= a^ffffffff00000001000000000000000000000000ffffffffffffffff
-     *   = t2 * t */
-    sp_256_mont_mul_5(t2, t2, t, p256_mod, p256_mp_mod);
-    /* t2= a^ffffffff00000001000000000000000000000000ffffffffffffffff00000000
-     *   = t2 ^ 2 ^ 32 */
-    sp_256_mont_sqr_n_5(t2, t2, 32, p256_mod, p256_mp_mod);
-    /* r = a^ffffffff00000001000000000000000000000000fffffffffffffffffffffffd
-     *   = t2 * t3 */
-    sp_256_mont_mul_5(r, t2, t3, p256_mod, p256_mp_mod);
-#endif /* WOLFSSL_SP_SMALL */
+    /* Reduce a to less than modulus */
+    n = sp_256_cmp_5(a, p256_mod);
+    sp_256_cond_sub_5(t, a, p256_mod, 0 - ((n >= 0) ?
+                (sp_digit)1 : (sp_digit)0));
+    sp_256_norm_5(t);
+    /* t = 1 / (a.R) */
+    sp_256_to_words_5(w, t);
+    safegcd_inv_256(w, w, &p256_mod_inv);
+    sp_256_from_words_5(t, w);
+    /* r = (1 / (a.R)).R^3 / R = (1 / a).R */
+    sp_256_mont_mul_5(r, t, p256_mod_r3, p256_mod, p256_mp_mod);
+
+    ForceZero(w, sizeof(w));
 }
 
 /* Map the Montgomery form projective co-ordinate point to an affine point.
@@ -16281,19 +16279,6 @@ static int sp_256_mod_5(sp_digit* r, const sp_digit* a, const sp_digit* m)
 
 #endif
 #if defined(HAVE_ECC_SIGN) || defined(HAVE_ECC_VERIFY)
-#ifdef WOLFSSL_SP_SMALL
-/* Order-2 for the P256 curve. */
-static const uint64_t p256_order_2[4] = {
-    0xf3b9cac2fc63254fU,0xbce6faada7179e84U,0xffffffffffffffffU,
-    0xffffffff00000000U
-};
-#else
-/* The low half of the order-2 of the P256 curve. */
-static const uint64_t p256_order_low[2] = {
-    0xf3b9cac2fc63254fU,0xbce6faada7179e84U
-};
-#endif /* WOLFSSL_SP_SMALL */
-
 /* Multiply two number mod the order of P256 curve. (r = a * b mod order)
  *
  * r  Result of the multiplication.
@@ -16306,37 +16291,9 @@ static void sp_256_mont_mul_order_5(sp_digit* r, const sp_digit* a, const sp_dig
     sp_256_mont_reduce_order_5(r, p256_order, p256_mp_order);
 }
 
-/* Square number mod the order of P256 curve. (r = a * a mod order)
- *
- * r  Result of the squaring.
- * a  Number to square.
- */
-static void sp_256_mont_sqr_order_5(sp_digit* r, const sp_digit* a)
-{
-    sp_256_sqr_5(r, a);
-    sp_256_mont_reduce_order_5(r, p256_order, p256_mp_order);
-}
-
-#ifndef WOLFSSL_SP_SMALL
-/* Square number mod the order of P256 curve a number of times.
- * (r = a ^ n mod order)
- *
- * r  Result of the squaring.
- * a  Number to square.
- */
-static void sp_256_mont_sqr_n_order_5(sp_digit* r, const sp_digit* a, int n)
-{
-    int i;
-
-    sp_256_mont_sqr_order_5(r, a);
-    for (i=1; i<n; i++) {
-        sp_256_mont_sqr_order_5(r, r);
-    }
-}
-#endif /* !WOLFSSL_SP_SMALL */
-
 /* Invert the number, in Montgomery form, modulo the order of the P256 curve.
  * (r = 1 / a mod order)
+ * Uses constant time divsteps (safegcd) on the reduced number.
  *
  * r   Inverse result.
  * a   Number to invert.
@@ -16345,94 +16302,23 @@ static void sp_256_mont_sqr_n_order_5(sp_digit* r, const sp_digit* a, int n)
 static void sp_256_mont_inv_order_5(sp_digit* r, const sp_digit* a,
         sp_digit* td)
 {
-#ifdef WOLFSSL_SP_SMALL
     sp_digit* t = td;
-    int i;
-
-    XMEMCPY(t, a, sizeof(sp_digit) * 5);
-    for (i=254; i>=0; i--) {
-        sp_256_mont_sqr_order_5(t, t);
-        if ((p256_order_2[i / 64] & ((sp_int_digit)1 << (i % 64))) != 0) {
-            sp_256_mont_mul_order_5(t, t, a);
-        }
-    }
-    XMEMCPY(r, t, sizeof(sp_digit) * 5U);
-#else
-    sp_digit* t = td;
-    sp_digit* t2 = td + 2 * 5;
-    sp_digit* t3 = td + 4 * 5;
-    int i;
+    uint64_t w[4];
+    sp_digit n;
 
-    /* t = a^2 */
-    sp_256_mont_sqr_order_5(t, a);
-    /* t = a^3 = t * a */
-    sp_256_mont_mul_order_5(t, t, a);
-    /* t2= a^c = t ^ 2 ^ 2 */
-    sp_256_mont_sqr_n_order_5(t2, t, 2);
-    /* t3= a^f = t2 * t */
-    sp_256_mont_mul_order_5(t3, t2, t);
-    /* t2= a^f0 = t3 ^ 2 ^ 4 */
-    sp_256_mont_sqr_n_order_5(t2, t3, 4);
-    /* t = a^ff = t2 * t3 */
-    sp_256_mont_mul_order_5(t, t2, t3);
-    /* t3= a^ff00 = t ^ 2 ^ 8 */
-    sp_256_mont_sqr_n_order_5(t2, t, 8);
-    /* t = a^ffff = t2 * t */
-    sp_256_mont_mul_order_5(t, t2, t);
-    /* t2= a^ffff0000 = t ^ 2 ^ 16 */
-    sp_256_mont_sqr_n_order_5(t2, t, 16);
-    /* t = a^ffffffff = t2 * t */
-    sp_256_mont_mul_order_5(t, t2, t);
-    /* t2= a^ffffffff0000000000000000 = t ^ 2 ^ 64  */
-    sp_256_mont_sqr_n_order_5(t2, t, 64);
-    /* t2= a^ffffffff00000000ffffffff = t2 * t */
-    sp_256_mont_mul_order_5(t2, t2, t);
-    /* t2= a^ffffffff00000000ffffffff00000000 = t2 ^ 2 ^ 32  */
-    sp_256_mont_sqr_n_order_5(t2, t2, 32);
-    /* t2= a^ffffffff00000000ffffffffffffffff = t2 * t */
-    sp_256_mont_mul_order_5(t2, t2, t);
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6 */
-    for (i=127; i>=112; i--) {
-        sp_256_mont_sqr_order_5(t2, t2);
-        if (((sp_digit)p256_order_low[i / 64] & ((sp_int_digit)1 << (i % 64))) != 0) {
-            sp_256_mont_mul_order_5(t2, t2, a);
-        }
-    }
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6f */
-    sp_256_mont_sqr_n_order_5(t2, t2, 4);
-    sp_256_mont_mul_order_5(t2, t2, t3);
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84 */
-    for (i=107; i>=64; i--) {
-        sp_256_mont_sqr_order_5(t2, t2);
-        if (((sp_digit)p256_order_low[i / 64] & ((sp_int_digit)1 << (i % 64))) != 0) {
-            sp_256_mont_mul_order_5(t2, t2, a);
-        }
-    }
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84f */
-    sp_256_mont_sqr_n_order_5(t2, t2, 4);
-    sp_256_mont_mul_order_5(t2, t2, t3);
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2 */
-    for (i=59; i>=32; i--) {
-        sp_256_mont_sqr_order_5(t2, t2);
-        if (((sp_digit)p256_order_low[i / 64] & ((sp_int_digit)1 << (i % 64))) != 0) {
-            sp_256_mont_mul_order_5(t2, t2, a);
-        }
-    }
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2f */
-    sp_256_mont_sqr_n_order_5(t2, t2, 4);
-    sp_256_mont_mul_order_5(t2, t2, t3);
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc63254 */
-    for (i=27; i>=0; i--) {
-        sp_256_mont_sqr_order_5(t2, t2);
-        if (((sp_digit)p256_order_low[i / 64] & ((sp_int_digit)1 << (i % 64))) != 0) {
-            sp_256_mont_mul_order_5(t2, t2, a);
-        }
-    }
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632540 */
-    sp_256_mont_sqr_n_order_5(t2, t2, 4);
-    /* r = a^ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc63254f */
-    sp_256_mont_mul_order_5(r, t2, t3);
-#endif /* WOLFSSL_SP_SMALL */
+    /* Reduce a to less than order */
+    n = sp_256_cmp_5(a, p256_order);
+    sp_256_cond_sub_5(t, a, p256_order, 0 - ((n >= 0) ?
+                (sp_digit)1 : (sp_digit)0));
+    sp_256_norm_5(t);
+    /* t = 1 / (a.R) */
+    sp_256_to_words_5(w, t);
+    safegcd_inv_256(w, w, &p256_order_inv);
+    sp_256_from_words_5(t, w);
+    /* r = (1 / (a.R)).R^3 / R = (1 / a).R */
+    sp_256_mont_mul_order_5(r, t, p256_order_r3);
+
+    ForceZero(w, sizeof(w));
 }
 
 #endif /* HAVE_ECC_SIGN || HAVE_ECC_VERIFY */
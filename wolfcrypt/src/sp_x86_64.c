@@ -46,6 +46,10 @@
 
 #include <wolfssl/wolfcrypt/sp.h>
 
+#ifdef HAVE_INTEL_AVX512
+    #include <immintrin.h>
+#endif
+
 #ifdef WOLFSSL_SP_X86_64_ASM
 #if defined(WOLFSSL_HAVE_SP_RSA) || defined(WOLFSSL_HAVE_SP_DH)
 #ifndef WOLFSSL_SP_NO_2048
@@ -1542,6 +1546,411 @@ int sp_RsaPublic_2048(const byte* in, word32 inLen, mp_int* em, mp_int* mm,
     return err;
 }
 
+#ifdef WOLFSSL_SP_RSA_BATCH
+#ifdef HAVE_INTEL_AVX512
+/* Number of 52-bit words holding a 2048-bit number in an IFMA lane. */
+#define SP_2048_IFMA_WORDS      40
+/* Mask of the 52 bits in an IFMA word. */
+#define SP_2048_IFMA_MASK       0xfffffffffffffL
+/* Size of a batch of numbers with one word from each lane per vector. */
+#define SP_2048_IFMA_SZ         (SP_2048_IFMA_WORDS * SP_RSA_BATCH_SZ)
+/* Fewest operations that are faster in IFMA lanes than one at a time. */
+#define SP_2048_IFMA_MIN        4
+
+/* Put a 2048-bit number into one lane of a batch of 52-bit words.
+ *
+ * r  Batch of numbers with one word from each lane per vector.
+ * l  Lane to put number into.
+ * a  A single precision number.
+ */
+static void sp_2048_to_ifma_8(word64* r, int l, const sp_digit* a)
+{
+    int i, j, s;
+    word64 v;
+
+    for (i = 0; i < SP_2048_IFMA_WORDS; i++) {
+        j = (i * 52) / 64;
+        s = (i * 52) % 64;
+        v = (j < 32) ? a[j] >> s : 0;
+        if (s > 12 && j + 1 < 32)
+            v |= a[j + 1] << (64 - s);
+        r[i * SP_RSA_BATCH_SZ + l] = v & SP_2048_IFMA_MASK;
+    }
+}
+
+/* Take the 2048-bit number out of one lane of a batch of 52-bit words.
+ * The words are normalized and the number is less than 2^2048.
+ *
+ * r  A single precision number.
+ * a  Batch of numbers with one word from each lane per vector.
+ * l  Lane to take number from.
+ */
+static void sp_2048_from_ifma_8(sp_digit* r, const word64* a, int l)
+{
+    int i, j, s;
+    word64 v;
+
+    XMEMSET(r, 0, sizeof(sp_digit) * 32);
+    for (i = 0; i < SP_2048_IFMA_WORDS; i++) {
+        j = (i * 52) / 64;
+        s = (i * 52) % 64;
+        v = a[i * SP_RSA_BATCH_SZ + l];
+        if (j < 32)
+            r[j] |= v << s;
+        if (s > 12 && j + 1 < 32)
+            r[j + 1] |= v >> (64 - s);
+    }
+}
+
+/* Montgomery multiply a and b in each of the 8 lanes. (r = a * b / 2^2080)
+ * Words are 52 bits and the result is normalized but not fully reduced: when
+ * a and b are less than 2m then r is less than 2m.
+ *
+ * r   Result of multiplication.
+ * a   First number to multiply.
+ * b   Second number to multiply.
+ * m   Modulus of each lane.
+ * mp  Montgomery multiplier of each lane (-1/m mod 2^52).
+ */
+static __attribute__((target("avx512f,avx512ifma")))
+void sp_2048_mont_mul_ifma_8(word64* r, const word64* a, const word64* b,
+        const word64* m, const word64* mp)
+{
+    __m512i t[SP_2048_IFMA_WORDS];
+    __m512i zero = _mm512_setzero_si512();
+    __m512i rho = _mm512_loadu_si512(mp);
+    __m512i bi, q, c, tj, aj, mj, ap, mpv;
+    int i, j;
+
+    for (j = 0; j < SP_2048_IFMA_WORDS; j++)
+        t[j] = zero;
+
+    for (i = 0; i < SP_2048_IFMA_WORDS; i++) {
+        bi = _mm512_loadu_si512(&b[i * SP_RSA_BATCH_SZ]);
+        ap = _mm512_loadu_si512(&a[0]);
+        mpv = _mm512_loadu_si512(&m[0]);
+
+        /* Low word determines multiple of modulus to add. */
+        c = _mm512_madd52lo_epu64(t[0], ap, bi);
+        q = _mm512_madd52lo_epu64(zero, c, rho);
+        c = _mm512_madd52lo_epu64(c, mpv, q);
+        c = _mm512_srli_epi64(c, 52);
+
+        /* Add products and shift down a word. Accumulating in 64 bits leaves
+         * room for all the carries without propagating them. */
+        for (j = 1; j < SP_2048_IFMA_WORDS; j++) {
+            aj = _mm512_loadu_si512(&a[j * SP_RSA_BATCH_SZ]);
+            mj = _mm512_loadu_si512(&m[j * SP_RSA_BATCH_SZ]);
+            tj = _mm512_madd52lo_epu64(t[j], aj, bi);
+            tj = _mm512_madd52lo_epu64(tj, mj, q);
+            tj = _mm512_madd52hi_epu64(tj, ap, bi);
+            t[j - 1] = _mm512_madd52hi_epu64(tj, mpv, q);
+            ap = aj;
+            mpv = mj;
+        }
+        tj = _mm512_madd52hi_epu64(zero, ap, bi);
+        t[SP_2048_IFMA_WORDS - 1] = _mm512_madd52hi_epu64(tj, mpv, q);
+        t[0] = _mm512_add_epi64(t[0], c);
+    }
+
+    /* Normalize to 52-bit words. */
+    c = zero;
+    for (j = 0; j < SP_2048_IFMA_WORDS; j++) {
+        tj = _mm512_add_epi64(t[j], c);
+        c = _mm512_srli_epi64(tj, 52);
+        tj = _mm512_and_si512(tj, _mm512_set1_epi64(SP_2048_IFMA_MASK));
+        _mm512_storeu_si512(&r[j * SP_RSA_BATCH_SZ], tj);
+    }
+}
+
+/* Select the number from b in the lanes set in mask, otherwise keep r.
+ *
+ * r     Number to update.
+ * b     Number to select from.
+ * mask  Lanes to take from b.
+ */
+static __attribute__((target("avx512f")))
+void sp_2048_blend_ifma_8(word64* r, const word64* b, byte mask)
+{
+    __m512i t;
+    int j;
+
+    for (j = 0; j < SP_2048_IFMA_WORDS; j++) {
+        t = _mm512_mask_blend_epi64((__mmask8)mask,
+                _mm512_loadu_si512(&r[j * SP_RSA_BATCH_SZ]),
+                _mm512_loadu_si512(&b[j * SP_RSA_BATCH_SZ]));
+        _mm512_storeu_si512(&r[j * SP_RSA_BATCH_SZ], t);
+    }
+}
+
+/* Exponentiate 8 numbers by public exponents at the same time.
+ * The left-to-right binary method is used as the exponents are public.
+ * Lanes with a shorter exponent start with one and the multiplication is only
+ * kept in the lanes that have the bit set.
+ *
+ * r     Result in each lane. (r = a^e mod m)
+ * a     Base multiplied by 2^2048 mod m in each lane.
+ *       Replaced with the base in Montgomery form.
+ * norm  2^2112 mod m in each lane.
+ * one   2^2080 mod m in lanes with an exponent shorter than bits.
+ * e     Exponent of each lane.
+ * bits  Number of bits in the longest exponent.
+ * m     Modulus of each lane.
+ * mp    Montgomery multiplier of each lane.
+ * t     Temporary number.
+ */
+static void sp_2048_rsa_public_ifma_8(word64* r, word64* a,
+        const word64* norm, const word64* one, const sp_digit* e, int bits,
+        const word64* m, const word64* mp, word64* t)
+{
+    byte mask;
+    int i, l;
+
+    /* a * 2^2048 * 2^2112 / 2^2080 = a * 2^2080 */
+    sp_2048_mont_mul_ifma_8(a, a, norm, m, mp);
+
+    mask = 0;
+    for (l = 0; l < SP_RSA_BATCH_SZ; l++) {
+        if ((e[l] >> (bits - 1)) != 0)
+            mask |= (byte)(1 << l);
+    }
+    XMEMCPY(r, one, sizeof(word64) * SP_2048_IFMA_SZ);
+    sp_2048_blend_ifma_8(r, a, mask);
+
+    for (i = bits - 2; i >= 0; i--) {
+        sp_2048_mont_mul_ifma_8(r, r, r, m, mp);
+        mask = 0;
+        for (l = 0; l < SP_RSA_BATCH_SZ; l++)
+            mask |= (byte)(((e[l] >> i) & 1) << l);
+        if (mask == 0xff) {
+            sp_2048_mont_mul_ifma_8(r, r, a, m, mp);
+        }
+        else if (mask != 0) {
+            sp_2048_mont_mul_ifma_8(t, r, a, m, mp);
+            sp_2048_blend_ifma_8(r, t, mask);
+        }
+    }
+
+    /* Convert out of Montgomery form: multiply by 1. */
+    XMEMSET(t, 0, sizeof(word64) * SP_2048_IFMA_SZ);
+    for (l = 0; l < SP_RSA_BATCH_SZ; l++)
+        t[l] = 1;
+    sp_2048_mont_mul_ifma_8(r, r, t, m, mp);
+}
+
+/* RSA public key operation on a full batch in the lanes of AVX-512 IFMA.
+ * Unused lanes are filled with a copy of the first valid operation.
+ *
+ * in      Array of bases as big-endian bytes.
+ * inLen   Number of bytes in each base.
+ * em      Public exponent of each operation.
+ * mm      Modulus of each operation.
+ * out     Array of buffers to hold the results.
+ * outLen  Number of bytes in each result.
+ * res     Result of each operation. Only operations with MP_OKAY are done.
+ * cnt     Number of operations.
+ * returns 0 on success and MEMORY_E when dynamic memory allocation fails.
+ */
+static int sp_2048_rsa_public_batch_ifma(const byte** in, const word32* inLen,
+        mp_int** em, mp_int** mm, byte** out, word32* outLen, int* res,
+        int cnt)
+{
+#if !defined(WOLFSSL_SP_SMALL) && !defined(WOLFSSL_SMALL_STACK)
+    word64 bd[6 * SP_2048_IFMA_SZ];
+    sp_digit ad[64], md[32];
+#else
+    word64* bd = NULL;
+    sp_digit* ad = NULL;
+    sp_digit* md;
+#endif
+    word64* ra;
+    word64* xa;
+    word64* na;
+    word64* oa;
+    word64* ma;
+    word64* ta;
+    word64 mp[SP_RSA_BATCH_SZ];
+    sp_digit e[SP_RSA_BATCH_SZ];
+    sp_digit rho;
+    int idx[SP_RSA_BATCH_SZ];
+    int i, l, bits, first = -1;
+    int err = MP_OKAY;
+
+#if defined(WOLFSSL_SP_SMALL) || defined(WOLFSSL_SMALL_STACK)
+    bd = (word64*)XMALLOC(sizeof(word64) * 6 * SP_2048_IFMA_SZ, NULL,
+                                                              DYNAMIC_TYPE_RSA);
+    ad = (sp_digit*)XMALLOC(sizeof(sp_digit) * 32 * 3, NULL, DYNAMIC_TYPE_RSA);
+    if (bd == NULL || ad == NULL)
+        err = MEMORY_E;
+    else
+        md = ad + 64;
+#endif
+
+    if (err == MP_OKAY) {
+        ra = bd;
+        xa = ra + SP_2048_IFMA_SZ;
+        na = xa + SP_2048_IFMA_SZ;
+        oa = na + SP_2048_IFMA_SZ;
+        ma = oa + SP_2048_IFMA_SZ;
+        ta = ma + SP_2048_IFMA_SZ;
+
+        /* Assign operations to lanes, repeating the first in unused lanes. */
+        for (i = 0, l = 0; i < cnt; i++) {
+            if (res[i] == MP_OKAY) {
+                if (first < 0)
+                    first = i;
+                idx[l++] = i;
+            }
+        }
+        for (; l < SP_RSA_BATCH_SZ; l++)
+            idx[l] = first;
+
+        bits = 0;
+        for (l = 0; l < SP_RSA_BATCH_SZ; l++) {
+            i = idx[l];
+            e[l] = (sp_digit)em[i]->dp[0];
+        #if DIGIT_BIT < 64
+            if (em[i]->used > 1)
+                e[l] |= ((sp_digit)em[i]->dp[1]) << DIGIT_BIT;
+        #endif
+            if (mp_count_bits(em[i]) > bits)
+                bits = mp_count_bits(em[i]);
+        }
+
+        for (l = 0; l < SP_RSA_BATCH_SZ; l++) {
+            i = idx[l];
+            sp_2048_from_mp(md, 32, mm[i]);
+            sp_2048_to_ifma_8(ma, l, md);
+            sp_2048_mont_setup(md, &rho);
+            mp[l] = (word64)rho & SP_2048_IFMA_MASK;
+
+            /* Base multiplied by 2^2048 mod m. */
+            XMEMSET(ad, 0, sizeof(sp_digit) * 32);
+            sp_2048_from_bin(ad + 32, 32, in[i], inLen[i]);
+            err = sp_2048_mod_32_cond(ad, ad, md);
+            if (err != MP_OKAY)
+                break;
+            sp_2048_to_ifma_8(xa, l, ad);
+
+            /* 2^2112 mod m converts base to Montgomery form. */
+            XMEMSET(ad, 0, sizeof(sp_digit) * 64);
+            ad[33] = 1;
+            err = sp_2048_mod_32_cond(ad, ad, md);
+            if (err != MP_OKAY)
+                break;
+            sp_2048_to_ifma_8(na, l, ad);
+
+            /* Montgomery form of one only needed for shorter exponents. */
+            XMEMSET(ad, 0, sizeof(sp_digit) * 64);
+            if ((e[l] >> (bits - 1)) == 0) {
+                ad[32] = (sp_digit)1 << 32;
+                err = sp_2048_mod_32_cond(ad, ad, md);
+                if (err != MP_OKAY)
+                    break;
+            }
+            sp_2048_to_ifma_8(oa, l, ad);
+        }
+    }
+
+    if (err == MP_OKAY) {
+        sp_2048_rsa_public_ifma_8(ra, xa, na, oa, e, bits, ma, mp, ta);
+
+        for (l = 0; l < SP_RSA_BATCH_SZ; l++) {
+            i = idx[l];
+            if (l > 0 && i == first)
+                break;
+
+            sp_2048_from_ifma_8(ad, ra, l);
+            sp_2048_from_mp(md, 32, mm[i]);
+            if (sp_2048_cmp_32(ad, md) >= 0)
+                sp_2048_sub_in_place_32(ad, md);
+            sp_2048_to_bin(ad, out[i]);
+            outLen[i] = 256;
+        }
+    }
+
+#if defined(WOLFSSL_SP_SMALL) || defined(WOLFSSL_SMALL_STACK)
+    if (ad != NULL)
+        XFREE(ad, NULL, DYNAMIC_TYPE_RSA);
+    if (bd != NULL)
+        XFREE(bd, NULL, DYNAMIC_TYPE_RSA);
+#endif
+
+    return err;
+}
+#endif /* HAVE_INTEL_AVX512 */
+
+/* RSA public key operation on a batch of independent inputs and keys.
+ * With AVX-512 IFMA the operations are performed together, one in each lane,
+ * otherwise they are performed one at a time.
+ *
+ * in      Array of bases as big-endian bytes.
+ * inLen   Number of bytes in each base.
+ * em      Public exponent of each operation.
+ * mm      Modulus of each operation.
+ * out     Array of buffers to hold the results.
+ *         Each must be at least 256 bytes long.
+ * outLen  On in, the size of each buffer. On out, the number of bytes in
+ *         each result.
+ * res     Result of each operation: 0 on success, MP_TO_E when the outLen is
+ *         too small, MP_READ_E when an array is too long and MP_EXPTMOD_E
+ *         when the exponent is zero.
+ * cnt     Number of operations - at most SP_RSA_BATCH_SZ.
+ * returns 0 when the batch was processed, BAD_FUNC_ARG when cnt is out of
+ * range and MEMORY_E when dynamic memory allocation fails.
+ */
+int sp_RsaPublic_2048_batch(const byte** in, const word32* inLen,
+    mp_int** em, mp_int** mm, byte** out, word32* outLen, int* res, int cnt)
+{
+    int i;
+    int valid = 0;
+    int err = MP_OKAY;
+#ifdef HAVE_INTEL_AVX512
+    word32 cpuid_flags = cpuid_get_flags();
+#endif
+
+    if (cnt <= 0 || cnt > SP_RSA_BATCH_SZ)
+        return BAD_FUNC_ARG;
+
+    for (i = 0; i < cnt; i++) {
+        if (outLen[i] < 256)
+            res[i] = MP_TO_E;
+        else if (mp_count_bits(em[i]) > 64 || inLen[i] > 256 ||
+                                                mp_count_bits(mm[i]) != 2048)
+            res[i] = MP_READ_E;
+        else if (mp_iszero(em[i]))
+            res[i] = MP_EXPTMOD_E;
+        else {
+            res[i] = MP_OKAY;
+            valid++;
+        }
+    }
+
+#ifdef HAVE_INTEL_AVX512
+    if (IS_INTEL_AVX512(cpuid_flags) && IS_INTEL_IFMA(cpuid_flags) &&
+                                                  valid >= SP_2048_IFMA_MIN) {
+        err = sp_2048_rsa_public_batch_ifma(in, inLen, em, mm, out, outLen,
+                                                                 res, cnt);
+    }
+    else
+#endif
+    {
+        for (i = 0; i < cnt && err == MP_OKAY; i++) {
+            if (res[i] == MP_OKAY) {
+                res[i] = sp_RsaPublic_2048(in[i], inLen[i], em[i], mm[i],
+                                                        out[i], &outLen[i]);
+                if (res[i] == MEMORY_E)
+                    err = MEMORY_E;
+            }
+        }
+    }
+
+    (void)valid;
+
+    return err;
+}
+#endif /* WOLFSSL_SP_RSA_BATCH */
+
 /* RSA private key operation.
  *
  * in      Array of bytes representing the number to exponentiate, base.
@@ -5802,6 +6211,8 @@ int sp_DhExp_4096(mp_int* base, const byte* exp, word32 expLen,
 
 #endif /* WOLFSSL_HAVE_SP_RSA || WOLFSSL_HAVE_SP_DH */
 #ifdef WOLFSSL_HAVE_SP_ECC
+#include "safegcd.i"
+
 #ifndef WOLFSSL_SP_NO_256
 
 /* Point structure to use. */
@@ -5824,6 +6235,17 @@ static const sp_digit p256_norm_mod[4] = {
 };
 /* The Montogmery multiplier for modulus of the curve P256. */
 static const sp_digit p256_mp_mod = 0x0000000000000001;
+/* R^3 mod modulus of the curve P256 (R = 2^256). */
+static const sp_digit p256_mod_r3[4] = {
+    0xfffffffd0000000aL,0xffffffedfffffff7L,0x00000005fffffffcL,
+    0x0000001800000001L
+};
+/* The modulus of the curve P256 for inversion. */
+static const safegcd_mod p256_mod_inv = {
+    { 0x3fffffffffffffffL,0x00000003ffffffffL,0x0000000000000000L,
+      0x3fffffc000000040L,0x00000000000000ffL },
+    0x3fffffffffffffffUL
+};
 #if defined(WOLFSSL_VALIDATE_ECC_KEYGEN) || defined(HAVE_ECC_SIGN) || \
                                             defined(HAVE_ECC_VERIFY)
 /* The order of the curve P256. */
@@ -5847,6 +6269,17 @@ static const sp_digit p256_norm_order[4] = {
 #if defined(HAVE_ECC_SIGN) || defined(HAVE_ECC_VERIFY)
 /* The Montogmery multiplier for order of the curve P256. */
 static const sp_digit p256_mp_order = 0xccd1c8aaee00bc4fL;
+/* R^3 mod order of the curve P256 (R = 2^256). */
+static const sp_digit p256_order_r3[4] = {
+    0xac8ebec90b65a624L,0x111f28ae0c0555c9L,0x2543b9246ba5e93fL,
+    0x503a54e76407be65L
+};
+/* The order of the curve P256 for inversion. */
+static const safegcd_mod p256_order_inv = {
+    { 0x33b9cac2fc632551L,0x339beab69c5e7a13L,0x3ffffffffffffffbL,
+      0x3fffffc00000003fL,0x00000000000000ffL },
+    0x332e375511ff43b1UL
+};
 #endif
 #ifdef WOLFSSL_SP_SMALL
 /* The base point of curve P256. */
@@ -6187,7 +6620,7 @@ extern sp_digit sp_256_sub_4(sp_digit* r, const sp_digit* a, const sp_digit* b);
 extern void sp_256_mont_reduce_4(sp_digit* a, const sp_digit* m, sp_digit mp);
 extern void sp_256_mont_mul_4(sp_digit* r, const sp_digit* a, const sp_digit* b, const sp_digit* m, sp_digit mp);
 extern void sp_256_mont_sqr_4(sp_digit* r, const sp_digit* a, const sp_digit* m, sp_digit mp);
-#if !defined(WOLFSSL_SP_SMALL) || defined(HAVE_COMP_KEY)
+#ifdef HAVE_COMP_KEY
 /* Square the Montgomery form number a number of times. (r = a ^ n mod m)
  *
  * r   Result of squaring.
@@ -6205,17 +6638,10 @@ static void sp_256_mont_sqr_n_4(sp_digit* r, const sp_digit* a, int n,
     }
 }
 
-#endif /* !WOLFSSL_SP_SMALL || HAVE_COMP_KEY */
-#ifdef WOLFSSL_SP_SMALL
-/* Mod-2 for the P256 curve. */
-static const uint64_t p256_mod_2[4] = {
-    0xfffffffffffffffdU,0x00000000ffffffffU,0x0000000000000000U,
-    0xffffffff00000001U
-};
-#endif /* !WOLFSSL_SP_SMALL */
-
+#endif /* HAVE_COMP_KEY */
 /* Invert the number, in Montgomery form, modulo the modulus (prime) of the
  * P256 curve. (r = 1 / a mod m)
+ * Uses constant time divsteps (safegcd) on the reduced number.
  *
  * r   Inverse result.
  * a   Number to invert.
@@ -6223,69 +6649,17 @@ static const uint64_t p256_mod_2[4] = {
  */
 static void sp_256_mont_inv_4(sp_digit* r, const sp_digit* a, sp_digit* td)
 {
-#ifdef WOLFSSL_SP_SMALL
     sp_digit* t = td;
-    int i;
+    int64_t n;
 
-    XMEMCPY(t, a, sizeof(sp_digit) * 4);
-    for (i=254; i>=0; i--) {
-        sp_256_mont_sqr_4(t, t, p256_mod, p256_mp_mod);
-        if (p256_mod_2[i / 64] & ((sp_digit)1 << (i % 64)))
-            sp_256_mont_mul_4(t, t, a, p256_mod, p256_mp_mod);
-    }
-    XMEMCPY(r, t, sizeof(sp_digit) * 4);
-#else
-    sp_digit* t = td;
-    sp_digit* t2 = td + 2 * 4;
-    sp_digit* t3 = td + 4 * 4;
-
-    /* t = a^2 */
-    sp_256_mont_sqr_4(t, a, p256_mod, p256_mp_mod);
-    /* t = a^3 = t * a */
-    sp_256_mont_mul_4(t, t, a, p256_mod, p256_mp_mod);
-    /* t2= a^c = t ^ 2 ^ 2 */
-    sp_256_mont_sqr_n_4(t2, t, 2, p256_mod, p256_mp_mod);
-    /* t3= a^d = t2 * a */
-    sp_256_mont_mul_4(t3, t2, a, p256_mod, p256_mp_mod);
-    /* t = a^f = t2 * t */
-    sp_256_mont_mul_4(t, t2, t, p256_mod, p256_mp_mod);
-    /* t2= a^f0 = t ^ 2 ^ 4 */
-    sp_256_mont_sqr_n_4(t2, t, 4, p256_mod, p256_mp_mod);
-    /* t3= a^fd = t2 * t3 */
-    sp_256_mont_mul_4(t3, t2, t3, p256_mod, p256_mp_mod);
-    /* t = a^ff = t2 * t */
-    sp_256_mont_mul_4(t, t2, t, p256_mod, p256_mp_mod);
-    /* t2= a^ff00 = t ^ 2 ^ 8 */
-    sp_256_mont_sqr_n_4(t2, t, 8, p256_mod, p256_mp_mod);
-    /* t3= a^fffd = t2 * t3 */
-    sp_256_mont_mul_4(t3, t2, t3, p256_mod, p256_mp_mod);
-    /* t = a^ffff = t2 * t */
-    sp_256_mont_mul_4(t, t2, t, p256_mod, p256_mp_mod);
-    /* t2= a^ffff0000 = t ^ 2 ^ 16 */
-    sp_256_mont_sqr_n_4(t2, t, 16, p256_mod, p256_mp_mod);
-    /* t3= a^fffffffd = t2 * t3 */
-    sp_256_mont_mul_4(t3, t2, t3, p256_mod, p256_mp_mod);
-    /* t = a^ffffffff = t2 * t */
-    sp_256_mont_mul_4(t, t2, t, p256_mod, p256_mp_mod);
-    /* t = a^ffffffff00000000 = t ^ 2 ^ 32  */
-    sp_256_mont_sqr_n_4(t2, t, 32, p256_mod, p256_mp_mod);
-    /* t2= a^ffffffffffffffff = t2 * t */
-    sp_256_mont_mul_4(t, t2, t, p256_mod, p256_mp_mod);
-    /* t2= a^ffffffff00000001 = t2 * a */
-    sp_256_mont_mul_4(t2, t2, a, p256_mod, p256_mp_mod);
-    /* t2= a^ffffffff000000010000000000000000000000000000000000000000
-     *   = t2 ^ 2 ^ 160 */
-    sp_256_mont_sqr_n_4(t2, t2, 160, p256_mod, p256_mp_mod);
-    /* t2= a^ffffffff00000001000000000000000000000000ffffffffffffffff
-     *   = t2 * t */
-    sp_256_mont_mul_4(t2, t2, t, p256_mod, p256_mp_mod);
-    /* t2= a^ffffffff00000001000000000000000000000000ffffffffffffffff00000000
-     *   = t2 ^ 2 ^ 32 */
-    sp_256_mont_sqr_n_4(t2, t2, 32, p256_mod, p256_mp_mod);
-    /* r = a^ffffffff00000001000000000000000000000000fffffffffffffffffffffffd
-     *   = t2 * t3 */
-    sp_256_mont_mul_4(r, t2, t3, p256_mod, p256_mp_mod);
-#endif /* WOLFSSL_SP_SMALL */
+    /* Reduce a to less than modulus */
+    n = sp_256_cmp_4(a, p256_mod);
+    sp_256_cond_sub_4(t, a, p256_mod, 0 - ((n >= 0) ?
+                (sp_digit)1 : (sp_digit)0));
+    /* t = 1 / (a.R) */
+    safegcd_inv_256(t, t, &p256_mod_inv);
+    /* r = (1 / (a.R)).R^3 / R = (1 / a).R */
+    sp_256_mont_mul_4(r, t, p256_mod_r3, p256_mod, p256_mp_mod);
 }
 
 /* Map the Montgomery form projective co-ordinate point to an affine point.
@@ -6935,7 +7309,7 @@ static int sp_256_ecc_mulmod_win_add_sub_4(sp_point* r, const sp_point* g,
 #ifdef HAVE_INTEL_AVX2
 extern void sp_256_mont_mul_avx2_4(sp_digit* r, const sp_digit* a, const sp_digit* b, const sp_digit* m, sp_digit mp);
 extern void sp_256_mont_sqr_avx2_4(sp_digit* r, const sp_digit* a, const sp_digit* m, sp_digit mp);
-#if !defined(WOLFSSL_SP_SMALL) || defined(HAVE_COMP_KEY)
+#ifdef HAVE_COMP_KEY
 /* Square the Montgomery form number a number of times. (r = a ^ n mod m)
  *
  * r   Result of squaring.
@@ -6953,10 +7327,11 @@ static void sp_256_mont_sqr_n_avx2_4(sp_digit* r, const sp_digit* a, int n,
     }
 }
 
-#endif /* !WOLFSSL_SP_SMALL || HAVE_COMP_KEY */
+#endif /* HAVE_COMP_KEY */
 
 /* Invert the number, in Montgomery form, modulo the modulus (prime) of the
  * P256 curve. (r = 1 / a mod m)
+ * Uses constant time divsteps (safegcd) on the reduced number.
  *
  * r   Inverse result.
  * a   Number to invert.
@@ -6964,69 +7339,17 @@ static void sp_256_mont_sqr_n_avx2_4(sp_digit* r, const sp_digit* a, int n,
  */
 static void sp_256_mont_inv_avx2_4(sp_digit* r, const sp_digit* a, sp_digit* td)
 {
-#ifdef WOLFSSL_SP_SMALL
     sp_digit* t = td;
-    int i;
+    int64_t n;
 
-    XMEMCPY(t, a, sizeof(sp_digit) * 4);
-    for (i=254; i>=0; i--) {
-        sp_256_mont_sqr_avx2_4(t, t, p256_mod, p256_mp_mod);
-        if (p256_mod_2[i / 64] & ((sp_digit)1 << (i % 64)))
-            sp_256_mont_mul_avx2_4(t, t, a, p256_mod, p256_mp_mod);
-    }
-    XMEMCPY(r, t, sizeof(sp_digit) * 4);
-#else
-    sp_digit* t = td;
-    sp_digit* t2 = td + 2 * 4;
-    sp_digit* t3 = td + 4 * 4;
-
-    /* t = a^2 */
-    sp_256_mont_sqr_avx2_4(t, a, p256_mod, p256_mp_mod);
-    /* t = a^3 = t * a */
-    sp_256_mont_mul_avx2_4(t, t, a, p256_mod, p256_mp_mod);
-    /* t2= a^c = t ^ 2 ^ 2 */
-    sp_256_mont_sqr_n_avx2_4(t2, t, 2, p256_mod, p256_mp_mod);
-    /* t3= a^d = t2 * a */
-    sp_256_mont_mul_avx2_4(t3, t2, a, p256_mod, p256_mp_mod);
-    /* t = a^f = t2 * t */
-    sp_256_mont_mul_avx2_4(t, t2, t, p256_mod, p256_mp_mod);
-    /* t2= a^f0 = t ^ 2 ^ 4 */
-    sp_256_mont_sqr_n_avx2_4(t2, t, 4, p256_mod, p256_mp_mod);
-    /* t3= a^fd = t2 * t3 */
-    sp_256_mont_mul_avx2_4(t3, t2, t3, p256_mod, p256_mp_mod);
-    /* t = a^ff = t2 * t */
-    sp_256_mont_mul_avx2_4(t, t2, t, p256_mod, p256_mp_mod);
-    /* t2= a^ff00 = t ^ 2 ^ 8 */
-    sp_256_mont_sqr_n_avx2_4(t2, t, 8, p256_mod, p256_mp_mod);
-    /* t3= a^fffd = t2 * t3 */
-    sp_256_mont_mul_avx2_4(t3, t2, t3, p256_mod, p256_mp_mod);
-    /* t = a^ffff = t2 * t */
-    sp_256_mont_mul_avx2_4(t, t2, t, p256_mod, p256_mp_mod);
-    /* t2= a^ffff0000 = t ^ 2 ^ 16 */
-    sp_256_mont_sqr_n_avx2_4(t2, t, 16, p256_mod, p256_mp_mod);
-    /* t3= a^fffffffd = t2 * t3 */
-    sp_256_mont_mul_avx2_4(t3, t2, t3, p256_mod, p256_mp_mod);
-    /* t = a^ffffffff = t2 * t */
-    sp_256_mont_mul_avx2_4(t, t2, t, p256_mod, p256_mp_mod);
-    /* t = a^ffffffff00000000 = t ^ 2 ^ 32  */
-    sp_256_mont_sqr_n_avx2_4(t2, t, 32, p256_mod, p256_mp_mod);
-    /* t2= a^ffffffffffffffff = t2 * t */
-    sp_256_mont_mul_avx2_4(t, t2, t, p256_mod, p256_mp_mod);
-    /* t2= a^ffffffff00000001 = t2 * a */
-    sp_256_mont_mul_avx2_4(t2, t2, a, p256_mod, p256_mp_mod);
-    /* t2= a^ffffffff000000010000000000000000000000000000000000000000
-     *   = t2 ^ 2 ^ 160 */
-    sp_256_mont_sqr_n_avx2_4(t2, t2, 160, p256_mod, p256_mp_mod);
-    /* t2= a^ffffffff00000001000000000000000000000000ffffffffffffffff
-     *   = t2 * t */
-    sp_256_mont_mul_avx2_4(t2, t2, t, p256_mod, p256_mp_mod);
-    /* t2= a^ffffffff00000001000000000000000000000000ffffffffffffffff00000000
-     *   = t2 ^ 2 ^ 32 */
-    sp_256_mont_sqr_n_avx2_4(t2, t2, 32, p256_mod, p256_mp_mod);
-    /* r = a^ffffffff00000001000000000000000000000000fffffffffffffffffffffffd
-     *   = t2 * t3 */
-    sp_256_mont_mul_avx2_4(r, t2, t3, p256_mod, p256_mp_mod);
-#endif /* WOLFSSL_SP_SMALL */
+    /* Reduce a to less than modulus */
+    n = sp_256_cmp_4(a, p256_mod);
+    sp_256_cond_sub_4(t, a, p256_mod, 0 - ((n >= 0) ?
+                (sp_digit)1 : (sp_digit)0));
+    /* t = 1 / (a.R) */
+    safegcd_inv_256(t, t, &p256_mod_inv);
+    /* r = (1 / (a.R)).R^3 / R = (1 / a).R */
+    sp_256_mont_mul_avx2_4(r, t, p256_mod_r3, p256_mod, p256_mp_mod);
 }
 
 /* Map the Montgomery form projective co-ordinate point to an affine point.
@@ -7677,7 +8000,7 @@ static void sp_256_proj_point_add_qz1_4(sp_point* r, const sp_point* p,
     }
 }
 
-#ifdef FP_ECC
+#if defined(FP_ECC) || defined(WOLFSSL_SP_ECC_PRECOMP)
 /* Convert the projective point to affine.
  * Ordinates are in Montgomery form.
  *
@@ -7781,8 +8104,9 @@ static int sp_256_gen_stripe_table_4(const sp_point* a,
     return err;
 }
 
-#endif /* FP_ECC */
-#if defined(FP_ECC) || defined(WOLFSSL_SP_SMALL)
+#endif /* FP_ECC || WOLFSSL_SP_ECC_PRECOMP */
+#if defined(FP_ECC) || defined(WOLFSSL_SP_SMALL) || \
+    defined(WOLFSSL_SP_ECC_PRECOMP)
 /* Multiply the point by the scalar and return the result.
  * If map is true then convert result to affine co-ordinates.
  *
@@ -7867,7 +8191,7 @@ static int sp_256_ecc_mulmod_stripe_4(sp_point* r, const sp_point* g,
     return err;
 }
 
-#endif /* FP_ECC || WOLFSSL_SP_SMALL */
+#endif /* FP_ECC || WOLFSSL_SP_SMALL || WOLFSSL_SP_ECC_PRECOMP */
 #ifdef FP_ECC
 #ifndef FP_ENTRIES
     #define FP_ENTRIES 16
@@ -8082,7 +8406,7 @@ static void sp_256_proj_point_add_qz1_avx2_4(sp_point* r, const sp_point* p,
     }
 }
 
-#ifdef FP_ECC
+#if defined(FP_ECC) || defined(WOLFSSL_SP_ECC_PRECOMP)
 /* Convert the projective point to affine.
  * Ordinates are in Montgomery form.
  *
@@ -8186,8 +8510,9 @@ static int sp_256_gen_stripe_table_avx2_4(const sp_point* a,
     return err;
 }
 
-#endif /* FP_ECC */
-#if defined(FP_ECC) || defined(WOLFSSL_SP_SMALL)
+#endif /* FP_ECC || WOLFSSL_SP_ECC_PRECOMP */
+#if defined(FP_ECC) || defined(WOLFSSL_SP_SMALL) || \
+    defined(WOLFSSL_SP_ECC_PRECOMP)
 /* Multiply the point by the scalar and return the result.
  * If map is true then convert result to affine co-ordinates.
  *
@@ -8272,7 +8597,7 @@ static int sp_256_ecc_mulmod_stripe_avx2_4(sp_point* r, const sp_point* g,
     return err;
 }
 
-#endif /* FP_ECC || WOLFSSL_SP_SMALL */
+#endif /* FP_ECC || WOLFSSL_SP_SMALL || WOLFSSL_SP_ECC_PRECOMP */
 /* Multiply the base point of P256 by the scalar and return the result.
  * If map is true then convert result to affine co-ordinates.
  *
@@ -8385,6 +8710,119 @@ int sp_ecc_mulmod_256(mp_int* km, ecc_point* gm, ecc_point* r, int map,
     return err;
 }
 
+#ifdef WOLFSSL_SP_ECC_PRECOMP
+typedef struct sp_precomp_t {
+    sp_digit x[4];
+    sp_digit y[4];
+    sp_digit z[4];
+    sp_table_entry table[256];
+} sp_precomp_t;
+
+/* Check whether the table of multiples was generated for the point.
+ *
+ * precomp  Table of multiples of a point and the point. May be NULL.
+ * p        Point to check - ordinates not in Montgomery form.
+ * returns 1 when the table can be used for the point and 0 otherwise.
+ */
+static int sp_256_precomp_match_4(const sp_precomp_t* precomp,
+        const sp_point* p)
+{
+    return (precomp != NULL) &&
+           (XMEMCMP(precomp->x, p->x, sizeof(precomp->x)) == 0) &&
+           (XMEMCMP(precomp->y, p->y, sizeof(precomp->y)) == 0) &&
+           (XMEMCMP(precomp->z, p->z, sizeof(precomp->z)) == 0);
+}
+
+/* Generate a table of multiples of the point for fixed base multiplication.
+ * The table is used in place of the point when the point is multiplied by
+ * many different scalars - e.g. verifying signatures with a public key.
+ *
+ * pX     X ordinate of point.
+ * pY     Y ordinate of point.
+ * pZ     Z ordinate of point.
+ * table  Allocated table of points on success. Only used with the same
+ *        point. Free with sp_ecc_precompute_free_256().
+ * heap   Heap to use for allocation.
+ * returns MEMORY_E when memory allocation fails and MP_OKAY on success.
+ */
+int sp_ecc_precompute_256(mp_int* pX, mp_int* pY, mp_int* pZ, void** table,
+        void* heap)
+{
+#if !defined(WOLFSSL_SP_SMALL) && !defined(WOLFSSL_SMALL_STACK)
+    sp_point p;
+    sp_digit tmpd[2 * 4 * 5];
+#endif
+    sp_point* point;
+    sp_digit* tmp = NULL;
+    sp_precomp_t* t = NULL;
+    int err;
+#ifdef HAVE_INTEL_AVX2
+    word32 cpuid_flags = cpuid_get_flags();
+#endif
+
+    err = sp_ecc_point_new(heap, p, point);
+#if defined(WOLFSSL_SP_SMALL) || defined(WOLFSSL_SMALL_STACK)
+    if (err == MP_OKAY) {
+        tmp = (sp_digit*)XMALLOC(sizeof(sp_digit) * 2 * 4 * 5, heap,
+                                                              DYNAMIC_TYPE_ECC);
+        if (tmp == NULL)
+            err = MEMORY_E;
+    }
+#else
+    tmp = tmpd;
+#endif
+    if (err == MP_OKAY) {
+        t = (sp_precomp_t*)XMALLOC(sizeof(sp_precomp_t), heap,
+                                                              DYNAMIC_TYPE_ECC);
+        if (t == NULL)
+            err = MEMORY_E;
+    }
+    if (err == MP_OKAY) {
+        sp_256_from_mp(point->x, 4, pX);
+        sp_256_from_mp(point->y, 4, pY);
+        sp_256_from_mp(point->z, 4, pZ);
+        XMEMCPY(t->x, point->x, sizeof(t->x));
+        XMEMCPY(t->y, point->y, sizeof(t->y));
+        XMEMCPY(t->z, point->z, sizeof(t->z));
+
+#ifdef HAVE_INTEL_AVX2
+        if (IS_INTEL_BMI2(cpuid_flags) && IS_INTEL_ADX(cpuid_flags))
+            err = sp_256_gen_stripe_table_avx2_4(point, t->table, tmp, heap);
+        else
+#endif
+            err = sp_256_gen_stripe_table_4(point, t->table, tmp, heap);
+    }
+    if (err == MP_OKAY) {
+        *table = t;
+    }
+    else if (t != NULL) {
+        XFREE(t, heap, DYNAMIC_TYPE_ECC);
+    }
+
+#if defined(WOLFSSL_SP_SMALL) || defined(WOLFSSL_SMALL_STACK)
+    if (tmp != NULL) {
+        XFREE(tmp, heap, DYNAMIC_TYPE_ECC);
+    }
+#endif
+    sp_ecc_point_free(point, 0, heap);
+
+    return err;
+}
+
+/* Free a table generated with sp_ecc_precompute_256().
+ *
+ * table  Table of points.
+ * heap   Heap used for allocation.
+ */
+void sp_ecc_precompute_free_256(void* table, void* heap)
+{
+    if (table != NULL) {
+        XFREE(table, heap, DYNAMIC_TYPE_ECC);
+    }
+    (void)heap;
+}
+#endif /* WOLFSSL_SP_ECC_PRECOMP */
+
 #ifdef WOLFSSL_SP_SMALL
 static const sp_table_entry p256_table[256] = {
     /* 0 */
@@ -22196,6 +22634,8 @@ static void sp_256_to_bin(sp_digit* r, byte* a)
  *
  * priv    Scalar to multiply the point by.
  * pub     Point to multiply.
+ * table   Table of multiples of the point from sp_ecc_precompute_256().
+ *         May be NULL.
  * out     Buffer to hold X ordinate.
  * outLen  On entry, size of the buffer in bytes.
  *         On exit, length of data in buffer in bytes.
@@ -22203,8 +22643,8 @@ static void sp_256_to_bin(sp_digit* r, byte* a)
  * returns BUFFER_E if the buffer is to small for output size,
  * MEMORY_E when memory allocation fails and MP_OKAY on success.
  */
-int sp_ecc_secret_gen_256(mp_int* priv, ecc_point* pub, byte* out,
-                          word32* outLen, void* heap)
+static int sp_256_ecc_secret_gen_4(mp_int* priv, ecc_point* pub,
+        const void* table, byte* out, word32* outLen, void* heap)
 {
 #if !defined(WOLFSSL_SP_SMALL) && !defined(WOLFSSL_SMALL_STACK)
     sp_point p;
@@ -22213,6 +22653,9 @@ int sp_ecc_secret_gen_256(mp_int* priv, ecc_point* pub, byte* out,
     sp_point* point = NULL;
     sp_digit* k = NULL;
     int err = MP_OKAY;
+#ifdef WOLFSSL_SP_ECC_PRECOMP
+    const sp_precomp_t* precomp = (const sp_precomp_t*)table;
+#endif
 #ifdef HAVE_INTEL_AVX2
     word32 cpuid_flags = cpuid_get_flags();
 #endif
@@ -22238,12 +22681,27 @@ int sp_ecc_secret_gen_256(mp_int* priv, ecc_point* pub, byte* out,
     if (err == MP_OKAY) {
         sp_256_from_mp(k, 4, priv);
         sp_256_point_from_ecc_point_4(point, pub);
+#ifdef WOLFSSL_SP_ECC_PRECOMP
+        if (sp_256_precomp_match_4(precomp, point)) {
 #ifdef HAVE_INTEL_AVX2
-        if (IS_INTEL_BMI2(cpuid_flags) && IS_INTEL_ADX(cpuid_flags))
-            err = sp_256_ecc_mulmod_avx2_4(point, point, k, 1, heap);
+            if (IS_INTEL_BMI2(cpuid_flags) && IS_INTEL_ADX(cpuid_flags))
+                err = sp_256_ecc_mulmod_stripe_avx2_4(point, point,
+                                                precomp->table, k, 1, heap);
+            else
+#endif
+                err = sp_256_ecc_mulmod_stripe_4(point, point,
+                                                precomp->table, k, 1, heap);
+        }
         else
 #endif
-            err = sp_256_ecc_mulmod_4(point, point, k, 1, heap);
+        {
+#ifdef HAVE_INTEL_AVX2
+            if (IS_INTEL_BMI2(cpuid_flags) && IS_INTEL_ADX(cpuid_flags))
+                err = sp_256_ecc_mulmod_avx2_4(point, point, k, 1, heap);
+            else
+#endif
+                err = sp_256_ecc_mulmod_4(point, point, k, 1, heap);
+        }
     }
     if (err == MP_OKAY) {
         sp_256_to_bin(point->x, out);
@@ -22257,8 +22715,51 @@ int sp_ecc_secret_gen_256(mp_int* priv, ecc_point* pub, byte* out,
 #endif
     sp_ecc_point_free(point, 0, heap);
 
+    (void)table;
+
     return err;
 }
+
+/* Multiply the point by the scalar and serialize the X ordinate.
+ * The number is 0 padded to maximum size on output.
+ *
+ * priv    Scalar to multiply the point by.
+ * pub     Point to multiply.
+ * out     Buffer to hold X ordinate.
+ * outLen  On entry, size of the buffer in bytes.
+ *         On exit, length of data in buffer in bytes.
+ * heap    Heap to use for allocation.
+ * returns BUFFER_E if the buffer is to small for output size,
+ * MEMORY_E when memory allocation fails and MP_OKAY on success.
+ */
+int sp_ecc_secret_gen_256(mp_int* priv, ecc_point* pub, byte* out,
+                          word32* outLen, void* heap)
+{
+    return sp_256_ecc_secret_gen_4(priv, pub, NULL, out, outLen, heap);
+}
+
+#ifdef WOLFSSL_SP_ECC_PRECOMP
+/* Multiply the point by the scalar, using a table of multiples of the point
+ * generated with sp_ecc_precompute_256(), and serialize the X ordinate.
+ * The number is 0 padded to maximum size on output.
+ *
+ * priv    Scalar to multiply the point by.
+ * pub     Point to multiply.
+ * table   Table of multiples of the point - ignored when generated for a
+ *         different point.
+ * out     Buffer to hold X ordinate.
+ * outLen  On entry, size of the buffer in bytes.
+ *         On exit, length of data in buffer in bytes.
+ * heap    Heap to use for allocation.
+ * returns BUFFER_E if the buffer is to small for output size,
+ * MEMORY_E when memory allocation fails and MP_OKAY on success.
+ */
+int sp_ecc_secret_gen_table_256(mp_int* priv, ecc_point* pub,
+        const void* table, byte* out, word32* outLen, void* heap)
+{
+    return sp_256_ecc_secret_gen_4(priv, pub, table, out, outLen, heap);
+}
+#endif /* WOLFSSL_SP_ECC_PRECOMP */
 #endif /* HAVE_ECC_DHE */
 
 #if defined(HAVE_ECC_SIGN) || defined(HAVE_ECC_VERIFY)
@@ -22376,19 +22877,6 @@ static WC_INLINE int sp_256_mod_4(sp_digit* r, const sp_digit* a, const sp_digit
 #endif
 #if defined(HAVE_ECC_SIGN) || defined(HAVE_ECC_VERIFY)
 extern void sp_256_sqr_4(sp_digit* r, const sp_digit* a);
-#ifdef WOLFSSL_SP_SMALL
-/* Order-2 for the P256 curve. */
-static const uint64_t p256_order_2[4] = {
-    0xf3b9cac2fc63254fU,0xbce6faada7179e84U,0xffffffffffffffffU,
-    0xffffffff00000000U
-};
-#else
-/* The low half of the order-2 of the P256 curve. */
-static const uint64_t p256_order_low[2] = {
-    0xf3b9cac2fc63254fU,0xbce6faada7179e84U
-};
-#endif /* WOLFSSL_SP_SMALL */
-
 /* Multiply two number mod the order of P256 curve. (r = a * b mod order)
  *
  * r  Result of the multiplication.
@@ -22401,37 +22889,9 @@ static void sp_256_mont_mul_order_4(sp_digit* r, const sp_digit* a, const sp_dig
     sp_256_mont_reduce_order_4(r, p256_order, p256_mp_order);
 }
 
-/* Square number mod the order of P256 curve. (r = a * a mod order)
- *
- * r  Result of the squaring.
- * a  Number to square.
- */
-static void sp_256_mont_sqr_order_4(sp_digit* r, const sp_digit* a)
-{
-    sp_256_sqr_4(r, a);
-    sp_256_mont_reduce_order_4(r, p256_order, p256_mp_order);
-}
-
-#ifndef WOLFSSL_SP_SMALL
-/* Square number mod the order of P256 curve a number of times.
- * (r = a ^ n mod order)
- *
- * r  Result of the squaring.
- * a  Number to square.
- */
-static void sp_256_mont_sqr_n_order_4(sp_digit* r, const sp_digit* a, int n)
-{
-    int i;
-
-    sp_256_mont_sqr_order_4(r, a);
-    for (i=1; i<n; i++) {
-        sp_256_mont_sqr_order_4(r, r);
-    }
-}
-#endif /* !WOLFSSL_SP_SMALL */
-
 /* Invert the number, in Montgomery form, modulo the order of the P256 curve.
  * (r = 1 / a mod order)
+ * Uses constant time divsteps (safegcd) on the reduced number.
  *
  * r   Inverse result.
  * a   Number to invert.
@@ -22440,98 +22900,20 @@ static void sp_256_mont_sqr_n_order_4(sp_digit* r, const sp_digit* a, int n)
 static void sp_256_mont_inv_order_4(sp_digit* r, const sp_digit* a,
         sp_digit* td)
 {
-#ifdef WOLFSSL_SP_SMALL
     sp_digit* t = td;
-    int i;
-
-    XMEMCPY(t, a, sizeof(sp_digit) * 4);
-    for (i=254; i>=0; i--) {
-        sp_256_mont_sqr_order_4(t, t);
-        if ((p256_order_2[i / 64] & ((sp_int_digit)1 << (i % 64))) != 0) {
-            sp_256_mont_mul_order_4(t, t, a);
-        }
-    }
-    XMEMCPY(r, t, sizeof(sp_digit) * 4U);
-#else
-    sp_digit* t = td;
-    sp_digit* t2 = td + 2 * 4;
-    sp_digit* t3 = td + 4 * 4;
-    int i;
+    int64_t n;
 
-    /* t = a^2 */
-    sp_256_mont_sqr_order_4(t, a);
-    /* t = a^3 = t * a */
-    sp_256_mont_mul_order_4(t, t, a);
-    /* t2= a^c = t ^ 2 ^ 2 */
-    sp_256_mont_sqr_n_order_4(t2, t, 2);
-    /* t3= a^f = t2 * t */
-    sp_256_mont_mul_order_4(t3, t2, t);
-    /* t2= a^f0 = t3 ^ 2 ^ 4 */
-    sp_256_mont_sqr_n_order_4(t2, t3, 4);
-    /* t = a^ff = t2 * t3 */
-    sp_256_mont_mul_order_4(t, t2, t3);
-    /* t3= a^ff00 = t ^ 2 ^ 8 */
-    sp_256_mont_sqr_n_order_4(t2, t, 8);
-    /* t = a^ffff = t2 * t */
-    sp_256_mont_mul_order_4(t, t2, t);
-    /* t2= a^ffff0000 = t ^ 2 ^ 16 */
-    sp_256_mont_sqr_n_order_4(t2, t, 16);
-    /* t = a^ffffffff = t2 * t */
-    sp_256_mont_mul_order_4(t, t2, t);
-    /* t2= a^ffffffff0000000000000000 = t ^ 2 ^ 64  */
-    sp_256_mont_sqr_n_order_4(t2, t, 64);
-    /* t2= a^ffffffff00000000ffffffff = t2 * t */
-    sp_256_mont_mul_order_4(t2, t2, t);
-    /* t2= a^ffffffff00000000ffffffff00000000 = t2 ^ 2 ^ 32  */
-    sp_256_mont_sqr_n_order_4(t2, t2, 32);
-    /* t2= a^ffffffff00000000ffffffffffffffff = t2 * t */
-    sp_256_mont_mul_order_4(t2, t2, t);
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6 */
-    for (i=127; i>=112; i--) {
-        sp_256_mont_sqr_order_4(t2, t2);
-        if (((sp_digit)p256_order_low[i / 64] & ((sp_int_digit)1 << (i % 64))) != 0) {
-            sp_256_mont_mul_order_4(t2, t2, a);
-        }
-    }
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6f */
-    sp_256_mont_sqr_n_order_4(t2, t2, 4);
-    sp_256_mont_mul_order_4(t2, t2, t3);
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84 */
-    for (i=107; i>=64; i--) {
-        sp_256_mont_sqr_order_4(t2, t2);
-        if (((sp_digit)p256_order_low[i / 64] & ((sp_int_digit)1 << (i % 64))) != 0) {
-            sp_256_mont_mul_order_4(t2, t2, a);
-        }
-    }
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84f */
-    sp_256_mont_sqr_n_order_4(t2, t2, 4);
-    sp_256_mont_mul_order_4(t2, t2, t3);
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2 */
-    for (i=59; i>=32; i--) {
-        sp_256_mont_sqr_order_4(t2, t2);
-        if (((sp_digit)p256_order_low[i / 64] & ((sp_int_digit)1 << (i % 64))) != 0) {
-            sp_256_mont_mul_order_4(t2, t2, a);
-        }
-    }
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2f */
-    sp_256_mont_sqr_n_order_4(t2, t2, 4);
-    sp_256_mont_mul_order_4(t2, t2, t3);
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc63254 */
-    for (i=27; i>=0; i--) {
-        sp_256_mont_sqr_order_4(t2, t2);
-        if (((sp_digit)p256_order_low[i / 64] & ((sp_int_digit)1 << (i % 64))) != 0) {
-            sp_256_mont_mul_order_4(t2, t2, a);
-        }
-    }
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632540 */
-    sp_256_mont_sqr_n_order_4(t2, t2, 4);
-    /* r = a^ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc63254f */
-    sp_256_mont_mul_order_4(r, t2, t3);
-#endif /* WOLFSSL_SP_SMALL */
+    /* Reduce a to less than order */
+    n = sp_256_cmp_4(a, p256_order);
+    sp_256_cond_sub_4(t, a, p256_order, 0 - ((n >= 0) ?
+                (sp_digit)1 : (sp_digit)0));
+    /* t = 1 / (a.R) */
+    safegcd_inv_256(t, t, &p256_order_inv);
+    /* r = (1 / (a.R)).R^3 / R = (1 / a).R */
+    sp_256_mont_mul_order_4(r, t, p256_order_r3);
 }
 
 #ifdef HAVE_INTEL_AVX2
-extern void sp_256_sqr_avx2_4(sp_digit* r, const sp_digit* a);
 #define sp_256_mont_reduce_order_avx2_4    sp_256_mont_reduce_avx2_4
 
 extern void sp_256_mont_reduce_avx2_4(sp_digit* a, const sp_digit* m, sp_digit mp);
@@ -22547,37 +22929,9 @@ static void sp_256_mont_mul_order_avx2_4(sp_digit* r, const sp_digit* a, const s
     sp_256_mont_reduce_order_avx2_4(r, p256_order, p256_mp_order);
 }
 
-/* Square number mod the order of P256 curve. (r = a * a mod order)
- *
- * r  Result of the squaring.
- * a  Number to square.
- */
-static void sp_256_mont_sqr_order_avx2_4(sp_digit* r, const sp_digit* a)
-{
-    sp_256_sqr_avx2_4(r, a);
-    sp_256_mont_reduce_order_avx2_4(r, p256_order, p256_mp_order);
-}
-
-#ifndef WOLFSSL_SP_SMALL
-/* Square number mod the order of P256 curve a number of times.
- * (r = a ^ n mod order)
- *
- * r  Result of the squaring.
- * a  Number to square.
- */
-static void sp_256_mont_sqr_n_order_avx2_4(sp_digit* r, const sp_digit* a, int n)
-{
-    int i;
-
-    sp_256_mont_sqr_order_avx2_4(r, a);
-    for (i=1; i<n; i++) {
-        sp_256_mont_sqr_order_avx2_4(r, r);
-    }
-}
-#endif /* !WOLFSSL_SP_SMALL */
-
 /* Invert the number, in Montgomery form, modulo the order of the P256 curve.
  * (r = 1 / a mod order)
+ * Uses constant time divsteps (safegcd) on the reduced number.
  *
  * r   Inverse result.
  * a   Number to invert.
@@ -22586,94 +22940,17 @@ static void sp_256_mont_sqr_n_order_avx2_4(sp_digit* r, const sp_digit* a, int n
 static void sp_256_mont_inv_order_avx2_4(sp_digit* r, const sp_digit* a,
         sp_digit* td)
 {
-#ifdef WOLFSSL_SP_SMALL
-    sp_digit* t = td;
-    int i;
-
-    XMEMCPY(t, a, sizeof(sp_digit) * 4);
-    for (i=254; i>=0; i--) {
-        sp_256_mont_sqr_order_avx2_4(t, t);
-        if ((p256_order_2[i / 64] & ((sp_int_digit)1 << (i % 64))) != 0) {
-            sp_256_mont_mul_order_avx2_4(t, t, a);
-        }
-    }
-    XMEMCPY(r, t, sizeof(sp_digit) * 4U);
-#else
     sp_digit* t = td;
-    sp_digit* t2 = td + 2 * 4;
-    sp_digit* t3 = td + 4 * 4;
-    int i;
+    int64_t n;
 
-    /* t = a^2 */
-    sp_256_mont_sqr_order_avx2_4(t, a);
-    /* t = a^3 = t * a */
-    sp_256_mont_mul_order_avx2_4(t, t, a);
-    /* t2= a^c = t ^ 2 ^ 2 */
-    sp_256_mont_sqr_n_order_avx2_4(t2, t, 2);
-    /* t3= a^f = t2 * t */
-    sp_256_mont_mul_order_avx2_4(t3, t2, t);
-    /* t2= a^f0 = t3 ^ 2 ^ 4 */
-    sp_256_mont_sqr_n_order_avx2_4(t2, t3, 4);
-    /* t = a^ff = t2 * t3 */
-    sp_256_mont_mul_order_avx2_4(t, t2, t3);
-    /* t3= a^ff00 = t ^ 2 ^ 8 */
-    sp_256_mont_sqr_n_order_avx2_4(t2, t, 8);
-    /* t = a^ffff = t2 * t */
-    sp_256_mont_mul_order_avx2_4(t, t2, t);
-    /* t2= a^ffff0000 = t ^ 2 ^ 16 */
-    sp_256_mont_sqr_n_order_avx2_4(t2, t, 16);
-    /* t = a^ffffffff = t2 * t */
-    sp_256_mont_mul_order_avx2_4(t, t2, t);
-    /* t2= a^ffffffff0000000000000000 = t ^ 2 ^ 64  */
-    sp_256_mont_sqr_n_order_avx2_4(t2, t, 64);
-    /* t2= a^ffffffff00000000ffffffff = t2 * t */
-    sp_256_mont_mul_order_avx2_4(t2, t2, t);
-    /* t2= a^ffffffff00000000ffffffff00000000 = t2 ^ 2 ^ 32  */
-    sp_256_mont_sqr_n_order_avx2_4(t2, t2, 32);
-    /* t2= a^ffffffff00000000ffffffffffffffff = t2 * t */
-    sp_256_mont_mul_order_avx2_4(t2, t2, t);
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6 */
-    for (i=127; i>=112; i--) {
-        sp_256_mont_sqr_order_avx2_4(t2, t2);
-        if (((sp_digit)p256_order_low[i / 64] & ((sp_int_digit)1 << (i % 64))) != 0) {
-            sp_256_mont_mul_order_avx2_4(t2, t2, a);
-        }
-    }
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6f */
-    sp_256_mont_sqr_n_order_avx2_4(t2, t2, 4);
-    sp_256_mont_mul_order_avx2_4(t2, t2, t3);
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84 */
-    for (i=107; i>=64; i--) {
-        sp_256_mont_sqr_order_avx2_4(t2, t2);
-        if (((sp_digit)p256_order_low[i / 64] & ((sp_int_digit)1 << (i % 64))) != 0) {
-            sp_256_mont_mul_order_avx2_4(t2, t2, a);
-        }
-    }
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84f */
-    sp_256_mont_sqr_n_order_avx2_4(t2, t2, 4);
-    sp_256_mont_mul_order_avx2_4(t2, t2, t3);
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2 */
-    for (i=59; i>=32; i--) {
-        sp_256_mont_sqr_order_avx2_4(t2, t2);
-        if (((sp_digit)p256_order_low[i / 64] & ((sp_int_digit)1 << (i % 64))) != 0) {
-            sp_256_mont_mul_order_avx2_4(t2, t2, a);
-        }
-    }
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2f */
-    sp_256_mont_sqr_n_order_avx2_4(t2, t2, 4);
-    sp_256_mont_mul_order_avx2_4(t2, t2, t3);
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc63254 */
-    for (i=27; i>=0; i--) {
-        sp_256_mont_sqr_order_avx2_4(t2, t2);
-        if (((sp_digit)p256_order_low[i / 64] & ((sp_int_digit)1 << (i % 64))) != 0) {
-            sp_256_mont_mul_order_avx2_4(t2, t2, a);
-        }
-    }
-    /* t2= a^ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc632540 */
-    sp_256_mont_sqr_n_order_avx2_4(t2, t2, 4);
-    /* r = a^ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc63254f */
-    sp_256_mont_mul_order_avx2_4(r, t2, t3);
-#endif /* WOLFSSL_SP_SMALL */
+    /* Reduce a to less than order */
+    n = sp_256_cmp_4(a, p256_order);
+    sp_256_cond_sub_4(t, a, p256_order, 0 - ((n >= 0) ?
+                (sp_digit)1 : (sp_digit)0));
+    /* t = 1 / (a.R) */
+    safegcd_inv_256(t, t, &p256_order_inv);
+    /* r = (1 / (a.R)).R^3 / R = (1 / a).R */
+    sp_256_mont_mul_order_avx2_4(r, t, p256_order_r3);
 }
 
 #endif /* HAVE_INTEL_AVX2 */
@@ -22890,16 +23167,20 @@ int sp_ecc_sign_256(const byte* hash, word32 hashLen, WC_RNG* rng, mp_int* priv,
  *
  * hash     Hash to sign.
  * hashLen  Length of the hash data.
- * rng      Random number generator.
- * priv     Private part of key - scalar.
- * rm       First part of result as an mp_int.
- * sm       Sirst part of result as an mp_int.
+ * pX       X ordinate of public key.
+ * pY       Y ordinate of public key.
+ * pZ       Z ordinate of public key.
+ * table    Table of multiples of the public key from
+ *          sp_ecc_precompute_256(). May be NULL.
+ * r        First part of signature as an mp_int.
+ * sm       Second part of signature as an mp_int.
+ * res      Result of verification - 1 when valid and 0 otherwise.
  * heap     Heap to use for allocation.
- * returns RNG failures, MEMORY_E when memory allocation fails and
- * MP_OKAY on success.
+ * returns MEMORY_E when memory allocation fails and MP_OKAY on success.
  */
-int sp_ecc_verify_256(const byte* hash, word32 hashLen, mp_int* pX,
-    mp_int* pY, mp_int* pZ, mp_int* r, mp_int* sm, int* res, void* heap)
+static int sp_256_ecc_verify_4(const byte* hash, word32 hashLen, mp_int* pX,
+    mp_int* pY, mp_int* pZ, const void* table, mp_int* r, mp_int* sm,
+    int* res, void* heap)
 {
 #if defined(WOLFSSL_SP_SMALL) || defined(WOLFSSL_SMALL_STACK)
     sp_digit* d = NULL;
@@ -22920,6 +23201,9 @@ int sp_ecc_verify_256(const byte* hash, word32 hashLen, mp_int* pX,
     sp_digit carry;
     int64_t c;
     int err;
+#ifdef WOLFSSL_SP_ECC_PRECOMP
+    const sp_precomp_t* precomp = (const sp_precomp_t*)table;
+#endif
 #ifdef HAVE_INTEL_AVX2
     word32 cpuid_flags = cpuid_get_flags();
 #endif
@@ -22997,12 +23281,27 @@ int sp_ecc_verify_256(const byte* hash, word32 hashLen, mp_int* pX,
             err = sp_256_ecc_mulmod_base_4(p1, u1, 0, heap);
     }
     if (err == MP_OKAY) {
+#ifdef WOLFSSL_SP_ECC_PRECOMP
+        if (sp_256_precomp_match_4(precomp, p2)) {
 #ifdef HAVE_INTEL_AVX2
-        if (IS_INTEL_BMI2(cpuid_flags) && IS_INTEL_ADX(cpuid_flags))
-            err = sp_256_ecc_mulmod_avx2_4(p2, p2, u2, 0, heap);
+            if (IS_INTEL_BMI2(cpuid_flags) && IS_INTEL_ADX(cpuid_flags))
+                err = sp_256_ecc_mulmod_stripe_avx2_4(p2, p2, precomp->table,
+                                                                u2, 0, heap);
+            else
+#endif
+                err = sp_256_ecc_mulmod_stripe_4(p2, p2, precomp->table, u2,
+                                                                    0, heap);
+        }
         else
 #endif
-            err = sp_256_ecc_mulmod_4(p2, p2, u2, 0, heap);
+        {
+#ifdef HAVE_INTEL_AVX2
+            if (IS_INTEL_BMI2(cpuid_flags) && IS_INTEL_ADX(cpuid_flags))
+                err = sp_256_ecc_mulmod_avx2_4(p2, p2, u2, 0, heap);
+            else
+#endif
+                err = sp_256_ecc_mulmod_4(p2, p2, u2, 0, heap);
+        }
     }
 
     if (err == MP_OKAY) {
@@ -23084,8 +23383,64 @@ int sp_ecc_verify_256(const byte* hash, word32 hashLen, mp_int* pX,
     sp_ecc_point_free(p1, 0, heap);
     sp_ecc_point_free(p2, 0, heap);
 
+    (void)table;
+
     return err;
 }
+
+/* Verify the signature values with the hash and public key.
+ *   e = Truncate(hash, 256)
+ *   u1 = e/s mod order
+ *   u2 = r/s mod order
+ *   r == (u1.G + u2.Q)->x mod order
+ * Optimization: Leave point in projective form.
+ *   (x, y, 1) == (x' / z'*z', y' / z'*z'*z', z' / z')
+ *   (r + n*order).z'.z' mod prime == (u1.G + u2.Q)->x'
+ * The hash is truncated to the first 256 bits.
+ *
+ * hash     Hash to sign.
+ * hashLen  Length of the hash data.
+ * pX       X ordinate of public key.
+ * pY       Y ordinate of public key.
+ * pZ       Z ordinate of public key.
+ * r        First part of signature as an mp_int.
+ * sm       Second part of signature as an mp_int.
+ * res      Result of verification - 1 when valid and 0 otherwise.
+ * heap     Heap to use for allocation.
+ * returns MEMORY_E when memory allocation fails and MP_OKAY on success.
+ */
+int sp_ecc_verify_256(const byte* hash, word32 hashLen, mp_int* pX,
+    mp_int* pY, mp_int* pZ, mp_int* r, mp_int* sm, int* res, void* heap)
+{
+    return sp_256_ecc_verify_4(hash, hashLen, pX, pY, pZ, NULL, r, sm, res,
+                               heap);
+}
+
+#ifdef WOLFSSL_SP_ECC_PRECOMP
+/* Verify the signature values with the hash and public key, using a table of
+ * multiples of the public key generated with sp_ecc_precompute_256().
+ *
+ * hash     Hash to sign.
+ * hashLen  Length of the hash data.
+ * pX       X ordinate of public key.
+ * pY       Y ordinate of public key.
+ * pZ       Z ordinate of public key.
+ * table    Table of multiples of the public key - ignored when generated
+ *          for a different public key.
+ * r        First part of signature as an mp_int.
+ * sm       Second part of signature as an mp_int.
+ * res      Result of verification - 1 when valid and 0 otherwise.
+ * heap     Heap to use for allocation.
+ * returns MEMORY_E when memory allocation fails and MP_OKAY on success.
+ */
+int sp_ecc_verify_table_256(const byte* hash, word32 hashLen, mp_int* pX,
+    mp_int* pY, mp_int* pZ, const void* table, mp_int* r, mp_int* sm,
+    int* res, void* heap)
+{
+    return sp_256_ecc_verify_4(hash, hashLen, pX, pY, pZ, table, r, sm, res,
+                               heap);
+}
+#endif /* WOLFSSL_SP_ECC_PRECOMP */
 #endif /* HAVE_ECC_VERIFY */
 
 #ifdef HAVE_ECC_CHECK_KEY
@@ -138,16 +138,27 @@ void s_fp_add(fp_int *a, fp_int *b, fp_int *c)
   int      x, y, oldused;
   fp_word  t;
 
-  y       = MAX(a->used, b->used);
+  /* only read the used digits of each - a is the longer */
+  if (a->used < b->used) {
+      fp_int* tmp = a;
+      a = b;
+      b = tmp;
+  }
+  y       = a->used;
   oldused = MIN(c->used, FP_SIZE);   /* help static analysis w/ largest size */
   c->used = y;
 
   t = 0;
-  for (x = 0; x < y; x++) {
+  for (x = 0; x < b->used; x++) {
       t         += ((fp_word)a->dp[x]) + ((fp_word)b->dp[x]);
       c->dp[x]   = (fp_digit)t;
       t        >>= DIGIT_BIT;
   }
+  for (; x < y; x++) {
+      t         += (fp_word)a->dp[x];
+      c->dp[x]   = (fp_digit)t;
+      t        >>= DIGIT_BIT;
+  }
   if (t != 0 && x < FP_SIZE) {
      c->dp[c->used++] = (fp_digit)t;
      ++x;
@@ -225,6 +236,350 @@ void s_fp_sub(fp_int *a, fp_int *b, fp_int *c)
   fp_clamp(c);
 }
 
+#ifdef TFM_KARATSUBA
+/* Karatsuba multiplication and squaring of large numbers.
+ *
+ * Numbers are split in half until there are fewer than FP_KARATSUBA_CUTOFF
+ * digits, where a schoolbook multiply is used. On x86_64 with BMI2 and ADX
+ * the schoolbook multiply uses MULX/ADCX/ADOX; this is selected at run time.
+ * Operands are zero padded to a multiple of 16 digits so that every split
+ * leaves halves that are a multiple of 8 digits.
+ * No branches depend on the values of the operands.
+ */
+#ifndef FP_KARATSUBA_CUTOFF
+    #define FP_KARATSUBA_CUTOFF    48
+#endif
+#if FP_KARATSUBA_CUTOFF < 16
+    #error FP_KARATSUBA_CUTOFF must be at least 16
+#endif
+
+/* largest padded operand, in digits */
+#define FP_KARATSUBA_MAX    (((FP_SIZE / 2) + 15) & ~15)
+/* space needed: a, b and r (4 * n) and scratch for all levels (4 * n + 8) */
+#define FP_KARATSUBA_WORDS  (8 * FP_KARATSUBA_MAX + 8)
+
+/* r = a + b over n digits, returns carry */
+static fp_digit fp_karat_add(fp_digit* r, const fp_digit* a,
+                             const fp_digit* b, int n)
+{
+    int     i;
+    fp_word t = 0;
+
+    for (i = 0; i < n; i++) {
+        t    += (fp_word)a[i] + b[i];
+        r[i]  = (fp_digit)t;
+        t   >>= DIGIT_BIT;
+    }
+
+    return (fp_digit)t;
+}
+
+/* r += a & m over n digits, returns carry */
+static fp_digit fp_karat_add_mask(fp_digit* r, const fp_digit* a, fp_digit m,
+                                  int n)
+{
+    int     i;
+    fp_word t = 0;
+
+    for (i = 0; i < n; i++) {
+        t    += (fp_word)r[i] + (a[i] & m);
+        r[i]  = (fp_digit)t;
+        t   >>= DIGIT_BIT;
+    }
+
+    return (fp_digit)t;
+}
+
+/* r -= a over n digits, returns borrow */
+static fp_digit fp_karat_sub(fp_digit* r, const fp_digit* a, int n)
+{
+    int     i;
+    fp_word t = 0;
+
+    for (i = 0; i < n; i++) {
+        t    = ((fp_word)r[i]) - (((fp_word)a[i]) + t);
+        r[i] = (fp_digit)t;
+        t    = (t >> DIGIT_BIT) & 1;
+    }
+
+    return (fp_digit)t;
+}
+
+/* Combine the middle product z1 (n + 1 digits) with z0 and z2 in r.
+ * r = z2 * B^n + (z1 - z0 - z2) * B^(n/2) + z0
+ */
+static void fp_karat_combine(fp_digit* r, fp_digit* z1, int n)
+{
+    int     i;
+    fp_word t;
+
+    z1[n] -= fp_karat_sub(z1, r, n);
+    z1[n] -= fp_karat_sub(z1, r + n, n);
+
+    t = fp_karat_add(r + n / 2, r + n / 2, z1, n + 1);
+    for (i = n + n / 2 + 1; i < 2 * n; i++) {
+        t    += r[i];
+        r[i]  = (fp_digit)t;
+        t   >>= DIGIT_BIT;
+    }
+}
+
+#ifdef HAVE_INTEL_MULX
+/* r = a * b, n digits each and a multiple of 8, using MULX/ADCX/ADOX */
+static void fp_mul_digits_mulx(fp_digit* r, const fp_digit* a,
+                               const fp_digit* b, int n)
+{
+    int       i, j;
+    fp_digit* c_mulx;
+
+    XMEMSET(r, 0, sizeof(fp_digit) * n);
+    for (i = 0; i < n; i++) {
+        fp_digit cy = 0;
+        for (j = 0; j < n; j += 8) {
+            c_mulx = r + i + j;
+            MULX_INNERMUL8(a + j, b[i], c_mulx, cy);
+        }
+        r[i + n] = cy;
+    }
+}
+
+/* r = a * a, n digits and a multiple of 8, using MULX/ADCX/ADOX */
+static void fp_sqr_digits_mulx(fp_digit* r, const fp_digit* a, int n)
+{
+    int       i, j;
+    fp_digit* c_mulx;
+    fp_digit  hi, lo, top;
+    fp_word   t;
+
+    /* products of different digits, each only once */
+    XMEMSET(r, 0, sizeof(fp_digit) * 2 * n);
+    for (i = 0; i < n - 1; i++) {
+        fp_digit cy = 0;
+        for (j = i + 1; j + 8 <= n; j += 8) {
+            c_mulx = r + i + j;
+            MULX_INNERMUL8(a + j, a[i], c_mulx, cy);
+        }
+        for (; j < n; j++) {
+            t        = ((fp_word)a[i]) * a[j] + r[i + j] + cy;
+            r[i + j] = (fp_digit)t;
+            cy       = (fp_digit)(t >> DIGIT_BIT);
+        }
+        r[i + n] = cy;
+    }
+
+    /* double and add in the squares */
+    top = 0;
+    t = 0;
+    for (i = 0; i < n; i++) {
+        fp_word sq = ((fp_word)a[i]) * a[i];
+
+        lo  = (r[2 * i] << 1) | top;
+        top = r[2 * i] >> (DIGIT_BIT - 1);
+        hi  = (r[2 * i + 1] << 1) | top;
+        top = r[2 * i + 1] >> (DIGIT_BIT - 1);
+
+        t           += (fp_word)lo + (fp_digit)sq;
+        r[2 * i]     = (fp_digit)t;
+        t          >>= DIGIT_BIT;
+        t           += (fp_word)hi + (fp_digit)(sq >> DIGIT_BIT);
+        r[2 * i + 1] = (fp_digit)t;
+        t          >>= DIGIT_BIT;
+    }
+}
+#endif
+
+/* r = a * b, n digits each, comba */
+static void fp_mul_digits(fp_digit* r, const fp_digit* a, const fp_digit* b,
+                          int n)
+{
+    int       ix, iy, iz, tx, ty;
+    fp_digit  c0, c1, c2;
+    const fp_digit *tmpx, *tmpy;
+
+    IF_HAVE_INTEL_MULX(fp_mul_digits_mulx(r, a, b, n), return) ;
+
+    COMBA_START;
+    COMBA_CLEAR;
+
+    for (ix = 0; ix < 2 * n; ix++) {
+        ty = MIN(ix, n - 1);
+        tx = ix - ty;
+        tmpx = a + tx;
+        tmpy = b + ty;
+        iy = MIN(n - tx, ty + 1);
+
+        COMBA_FORWARD;
+        for (iz = 0; iz < iy; ++iz) {
+            fp_digit _tmpx = *tmpx++;
+            fp_digit _tmpy = *tmpy--;
+            MULADD(_tmpx, _tmpy);
+        }
+        COMBA_STORE(r[ix]);
+    }
+    COMBA_FINI;
+}
+
+/* r = a * a, n digits, comba */
+static void fp_sqr_digits(fp_digit* r, const fp_digit* a, int n)
+{
+    int       ix, iy, iz, tx, ty;
+    fp_digit  c0, c1, c2;
+    const fp_digit *tmpx, *tmpy;
+#ifdef TFM_ISO
+    fp_word   tt;
+#endif
+
+    IF_HAVE_INTEL_MULX(fp_sqr_digits_mulx(r, a, n), return) ;
+
+    COMBA_START;
+    COMBA_CLEAR;
+
+    for (ix = 0; ix < 2 * n; ix++) {
+        ty = MIN(n - 1, ix);
+        tx = ix - ty;
+        tmpx = a + tx;
+        tmpy = a + ty;
+        iy = MIN(n - tx, ty + 1);
+        iy = MIN(iy, (ty - tx + 1) >> 1);
+
+        COMBA_FORWARD;
+        for (iz = 0; iz < iy; iz++) {
+            SQRADD2(*tmpx++, *tmpy--);
+        }
+        if ((ix & 1) == 0) {
+            SQRADD(a[ix >> 1], a[ix >> 1]);
+        }
+        COMBA_STORE(r[ix]);
+    }
+    COMBA_FINI;
+}
+
+/* r = a * b, n digits each, using scratch t of 4 * n + 8 digits */
+static void fp_mul_karat(fp_digit* r, const fp_digit* a, const fp_digit* b,
+                         int n, fp_digit* t)
+{
+    int       h = n / 2;
+    fp_digit  ca, cb;
+    fp_digit* sa = t;
+    fp_digit* sb = t + h;
+    fp_digit* z1 = t + n;
+
+    if (n < FP_KARATSUBA_CUTOFF || (n & 15) != 0) {
+        fp_mul_digits(r, a, b, n);
+        return;
+    }
+
+    /* z1 = (a0 + a1) * (b0 + b1) */
+    ca = fp_karat_add(sa, a, a + h, h);
+    cb = fp_karat_add(sb, b, b + h, h);
+    fp_mul_karat(z1, sa, sb, h, t + 2 * n + 1);
+    z1[n]  = ca & cb;
+    z1[n] += fp_karat_add_mask(z1 + h, sb, (fp_digit)0 - ca, h);
+    z1[n] += fp_karat_add_mask(z1 + h, sa, (fp_digit)0 - cb, h);
+
+    /* z0 = a0 * b0, z2 = a1 * b1 */
+    fp_mul_karat(r, a, b, h, t + 2 * n + 1);
+    fp_mul_karat(r + n, a + h, b + h, h, t + 2 * n + 1);
+
+    fp_karat_combine(r, z1, n);
+}
+
+/* r = a * a, n digits, using scratch t of 4 * n + 8 digits */
+static void fp_sqr_karat(fp_digit* r, const fp_digit* a, int n, fp_digit* t)
+{
+    int       h = n / 2;
+    fp_digit  ca;
+    fp_digit* sa = t;
+    fp_digit* z1 = t + h;
+
+    if (n < FP_KARATSUBA_CUTOFF || (n & 15) != 0) {
+        fp_sqr_digits(r, a, n);
+        return;
+    }
+
+    /* z1 = (a0 + a1)^2 */
+    ca = fp_karat_add(sa, a, a + h, h);
+    fp_sqr_karat(z1, sa, h, t + h + n + 1);
+    z1[n]  = ca;
+    z1[n] += fp_karat_add_mask(z1 + h, sa, (fp_digit)0 - ca, h);
+    z1[n] += fp_karat_add_mask(z1 + h, sa, (fp_digit)0 - ca, h);
+
+    /* z0 = a0^2, z2 = a1^2 */
+    fp_sqr_karat(r, a, h, t + h + n + 1);
+    fp_sqr_karat(r + n, a + h, h, t + h + n + 1);
+
+    fp_karat_combine(r, z1, n);
+}
+
+/* c = a * b using Karatsuba, a and b have a similar number of digits */
+static int fp_mul_karatsuba(fp_int *A, fp_int *B, fp_int *C)
+{
+    int       n, x;
+    fp_digit* a;
+    fp_digit* b;
+    fp_digit* r;
+#ifndef WOLFSSL_SMALL_STACK
+    fp_digit  t[FP_KARATSUBA_WORDS];
+#else
+    fp_digit* t;
+#endif
+
+#ifdef WOLFSSL_SMALL_STACK
+    t = (fp_digit*)XMALLOC(sizeof(fp_digit) * FP_KARATSUBA_WORDS, NULL,
+                                                           DYNAMIC_TYPE_BIGINT);
+    if (t == NULL)
+        return FP_MEM;
+#endif
+
+    n = (MAX(A->used, B->used) + 15) & ~15;
+    a = t;
+    b = a + n;
+    r = b + n;
+
+    XMEMSET(a, 0, sizeof(fp_digit) * 2 * n);
+    XMEMCPY(a, A->dp, sizeof(fp_digit) * A->used);
+    XMEMCPY(b, B->dp, sizeof(fp_digit) * B->used);
+    if (A == B) {
+        fp_sqr_karat(r, a, n, r + 2 * n);
+    }
+    else {
+        fp_mul_karat(r, a, b, n, r + 2 * n);
+    }
+
+    C->used = A->used + B->used;
+    C->sign = A->sign ^ B->sign;
+    for (x = 0; x < C->used; x++) {
+        C->dp[x] = r[x];
+    }
+    fp_clamp(C);
+
+#ifdef WOLFSSL_SMALL_STACK
+    XFREE(t, NULL, DYNAMIC_TYPE_BIGINT);
+#endif
+    return FP_OKAY;
+}
+#endif /* TFM_KARATSUBA */
+
+#if defined(TFM_SIZED_INT) && !defined(ALT_ECC_SIZE)
+/* Zero the digits of a past used and size, up to n.
+ * The unrolled comba multipliers read a fixed number of digits of each
+ * operand which may be more than a smaller operand was sized for. */
+static void fp_extend_size(fp_int *a, int n)
+{
+    int x;
+
+    for (x = MAX(a->used, a->size); x < n; x++) {
+        a->dp[x] = 0;
+    }
+    if (a->size < n) {
+        a->size = n;
+    }
+}
+    #define FP_COMBA_DIGITS(a, n)   fp_extend_size(a, n)
+#else
+    #define FP_COMBA_DIGITS(a, n)
+#endif
+
 /* c = a * b */
 int fp_mul(fp_int *A, fp_int *B, fp_int *C)
 {
@@ -248,6 +603,15 @@ int fp_mul(fp_int *A, fp_int *B, fp_int *C)
        goto clean;
     }
 
+#ifdef TFM_KARATSUBA
+    /* split large numbers of about the same size */
+    if (yy >= FP_KARATSUBA_CUTOFF && y + yy < FP_SIZE &&
+                                                    yy + (yy >> 2) >= y) {
+       ret = fp_mul_karatsuba(A, B, C);
+       goto clean;
+    }
+#endif
+
     /* pick a comba (unrolled 4/8/16/32 x or rolled) based on the size
        of the largest input.  We also want to avoid doing excess mults if the
        inputs are not close to the next power of two.  That is, for example,
@@ -256,48 +620,64 @@ int fp_mul(fp_int *A, fp_int *B, fp_int *C)
 
 #if defined(TFM_MUL3) && FP_SIZE >= 6
         if (y <= 3) {
+           FP_COMBA_DIGITS(A, 3);
+           FP_COMBA_DIGITS(B, 3);
            ret = fp_mul_comba3(A,B,C);
            goto clean;
         }
 #endif
 #if defined(TFM_MUL4) && FP_SIZE >= 8
         if (y == 4) {
+           FP_COMBA_DIGITS(A, 4);
+           FP_COMBA_DIGITS(B, 4);
            ret = fp_mul_comba4(A,B,C);
            goto clean;
         }
 #endif
 #if defined(TFM_MUL6) && FP_SIZE >= 12
         if (y <= 6) {
+           FP_COMBA_DIGITS(A, 6);
+           FP_COMBA_DIGITS(B, 6);
            ret = fp_mul_comba6(A,B,C);
            goto clean;
         }
 #endif
 #if defined(TFM_MUL7) && FP_SIZE >= 14
         if (y == 7) {
+           FP_COMBA_DIGITS(A, 7);
+           FP_COMBA_DIGITS(B, 7);
            ret = fp_mul_comba7(A,B,C);
            goto clean;
         }
 #endif
 #if defined(TFM_MUL8) && FP_SIZE >= 16
         if (y == 8) {
+           FP_COMBA_DIGITS(A, 8);
+           FP_COMBA_DIGITS(B, 8);
            ret = fp_mul_comba8(A,B,C);
            goto clean;
         }
 #endif
 #if defined(TFM_MUL9) && FP_SIZE >= 18
         if (y == 9) {
+           FP_COMBA_DIGITS(A, 9);
+           FP_COMBA_DIGITS(B, 9);
            ret = fp_mul_comba9(A,B,C);
            goto clean;
         }
 #endif
 #if defined(TFM_MUL12) && FP_SIZE >= 24
         if (y <= 12) {
+           FP_COMBA_DIGITS(A, 12);
+           FP_COMBA_DIGITS(B, 12);
            ret = fp_mul_comba12(A,B,C);
            goto clean;
         }
 #endif
 #if defined(TFM_MUL17) && FP_SIZE >= 34
         if (y <= 17) {
+           FP_COMBA_DIGITS(A, 17);
+           FP_COMBA_DIGITS(B, 17);
            ret = fp_mul_comba17(A,B,C);
            goto clean;
         }
@@ -305,42 +685,56 @@ int fp_mul(fp_int *A, fp_int *B, fp_int *C)
 
 #if defined(TFM_SMALL_SET) && FP_SIZE >= 32
         if (y <= 16) {
+           FP_COMBA_DIGITS(A, y);
+           FP_COMBA_DIGITS(B, y);
            ret = fp_mul_comba_small(A,B,C);
            goto clean;
         }
 #endif
 #if defined(TFM_MUL20) && FP_SIZE >= 40
         if (y <= 20) {
+           FP_COMBA_DIGITS(A, 20);
+           FP_COMBA_DIGITS(B, 20);
            ret = fp_mul_comba20(A,B,C);
            goto clean;
         }
 #endif
 #if defined(TFM_MUL24) && FP_SIZE >= 48
         if (yy >= 16 && y <= 24) {
+           FP_COMBA_DIGITS(A, 24);
+           FP_COMBA_DIGITS(B, 24);
            ret = fp_mul_comba24(A,B,C);
            goto clean;
         }
 #endif
 #if defined(TFM_MUL28) && FP_SIZE >= 56
         if (yy >= 20 && y <= 28) {
+           FP_COMBA_DIGITS(A, 28);
+           FP_COMBA_DIGITS(B, 28);
            ret = fp_mul_comba28(A,B,C);
            goto clean;
         }
 #endif
 #if defined(TFM_MUL32) && FP_SIZE >= 64
         if (yy >= 24 && y <= 32) {
+           FP_COMBA_DIGITS(A, 32);
+           FP_COMBA_DIGITS(B, 32);
            ret = fp_mul_comba32(A,B,C);
            goto clean;
         }
 #endif
 #if defined(TFM_MUL48) && FP_SIZE >= 96
         if (yy >= 40 && y <= 48) {
+          FP_COMBA_DIGITS(A, 48);
+          FP_COMBA_DIGITS(B, 48);
           ret = fp_mul_comba48(A,B,C);
           goto clean;
         }
 #endif
 #if defined(TFM_MUL64) && FP_SIZE >= 128
         if (yy >= 56 && y <= 64) {
+           FP_COMBA_DIGITS(A, 64);
+           FP_COMBA_DIGITS(B, 64);
            ret = fp_mul_comba64(A,B,C);
            goto clean;
         }
@@ -472,7 +866,10 @@ void fp_mul_2d(fp_int *a, int b, fp_int *c)
 WC_INLINE static int fp_mul_comba_mulx(fp_int *A, fp_int *B, fp_int *C)
 
 {
-   int       ix, iy, iz, pa;
+   int       ix, iy, pa;
+   fp_digit  cy;
+   fp_digit  *c_mulx;
+   fp_word   t;
    fp_int    *dst;
 #ifndef WOLFSSL_SMALL_STACK
    fp_int    tmp[1];
@@ -486,20 +883,30 @@ WC_INLINE static int fp_mul_comba_mulx(fp_int *A, fp_int *B, fp_int *C)
        return FP_MEM;
 #endif
 
-   /* get size of output and trim */
+   /* get size of output - caller ensures it fits */
    pa = A->used + B->used;
-   if (pa >= FP_SIZE) {
-      pa = FP_SIZE-1;
-   }
 
    /* Always take branch to use tmp variable. This avoids a cache attack for
     * determining if C equals A */
    if (1) {
-      fp_init(tmp);
+      fp_init_size(tmp, pa);
       dst = tmp;
    }
 
-   TFM_INTEL_MUL_COMBA(A, B, dst) ;
+   /* add in a row of B times each digit of A, 8 digits at a time */
+   for (ix = 0; ix < A->used; ix++) {
+      cy = 0;
+      for (iy = 0; iy + 8 <= B->used; iy += 8) {
+         c_mulx = dst->dp + ix + iy;
+         MULX_INNERMUL8(B->dp + iy, A->dp[ix], c_mulx, cy);
+      }
+      for (; iy < B->used; iy++) {
+         t = ((fp_word)A->dp[ix]) * B->dp[iy] + dst->dp[ix + iy] + cy;
+         dst->dp[ix + iy] = (fp_digit)t;
+         cy = (fp_digit)(t >> DIGIT_BIT);
+      }
+      dst->dp[ix + B->used] = cy;
+   }
 
   dst->used = pa;
   dst->sign = A->sign ^ B->sign;
@@ -526,7 +933,9 @@ int fp_mul_comba(fp_int *A, fp_int *B, fp_int *C)
    fp_int    *tmp;
 #endif
 
-   IF_HAVE_INTEL_MULX(ret = fp_mul_comba_mulx(A, B, C), return ret) ;
+   if (A->used + B->used < FP_SIZE) {
+      IF_HAVE_INTEL_MULX(ret = fp_mul_comba_mulx(A, B, C), return ret) ;
+   }
 
 #ifdef WOLFSSL_SMALL_STACK
    tmp = (fp_int*)XMALLOC(sizeof(fp_int), NULL, DYNAMIC_TYPE_BIGINT);
@@ -546,7 +955,7 @@ int fp_mul_comba(fp_int *A, fp_int *B, fp_int *C)
    /* Always take branch to use tmp variable. This avoids a cache attack for
     * determining if C equals A */
    if (1) {
-      fp_init(tmp);
+      fp_init_size(tmp, pa);
       dst = tmp;
    }
 
@@ -1232,6 +1641,45 @@ int fp_addmod(fp_int *a, fp_int *b, fp_int *c, fp_int *d)
   return err;
 }
 
+/* Convert G to Montgomery form for exponentiation modulo P.
+ * r is set to R mod P (one in Montgomery form) and gr to G * R mod P.
+ * When R2 (R^2 mod P) is passed, mp must be the Montgomery setup value of P
+ * and no division is needed.
+ */
+static int _fp_exptmod_mont_init(fp_int * G, fp_int * P, fp_int * R2,
+                                 fp_digit mp, fp_int * r, fp_int * gr)
+{
+  int err = FP_OKAY;
+
+  if (fp_cmp_mag(P, G) != FP_GT) {
+     /* G > P so we reduce it first */
+     err = fp_mod(G, P, gr);
+  } else {
+     fp_copy(G, gr);
+  }
+
+  if (R2 == NULL) {
+     /* now we need R mod m */
+     fp_montgomery_calc_normalization (r, P);
+
+     /* now set gr to G * R mod m */
+     if (err == FP_OKAY)
+        err = fp_mulmod (gr, r, P, gr);
+  }
+  else {
+     /* R mod m = R^2 / R and G * R mod m = G * R^2 / R */
+     fp_copy(R2, r);
+     if (err == FP_OKAY)
+        err = fp_montgomery_reduce(r, P, mp);
+     if (err == FP_OKAY)
+        err = fp_mul(gr, R2, gr);
+     if (err == FP_OKAY)
+        err = fp_montgomery_reduce(gr, P, mp);
+  }
+
+  return err;
+}
+
 #ifdef TFM_TIMING_RESISTANT
 
 #ifdef WC_RSA_NONBLOCK
@@ -1462,8 +1910,10 @@ int fp_exptmod_nb(exptModNb_t* nb, fp_int* G, fp_int* X, fp_int* P, fp_int* Y)
 /* timing resistant montgomery ladder based exptmod
    Based on work by Marc Joye, Sung-Ming Yen, "The Montgomery Powering Ladder",
    Cryptographic Hardware and Embedded Systems, CHES 2002
+   R2 and rho are the precomputed Montgomery values of P or NULL and 0.
 */
-static int _fp_exptmod(fp_int * G, fp_int * X, int digits, fp_int * P, fp_int * Y)
+static int _fp_exptmod(fp_int * G, fp_int * X, int digits, fp_int * P,
+                       fp_int * R2, fp_digit rho, fp_int * Y)
 {
 #ifndef WOLFSSL_SMALL_STACK
 #ifdef WC_NO_CACHE_RESISTANT
@@ -1478,7 +1928,10 @@ static int _fp_exptmod(fp_int * G, fp_int * X, int digits, fp_int * P, fp_int *
   int      err, bitcnt, digidx, y;
 
   /* now setup montgomery  */
-  if ((err = fp_montgomery_setup (P, &mp)) != FP_OKAY) {
+  if (R2 != NULL) {
+     mp = rho;
+  }
+  else if ((err = fp_montgomery_setup (P, &mp)) != FP_OKAY) {
      return err;
   }
 
@@ -1497,17 +1950,14 @@ static int _fp_exptmod(fp_int * G, fp_int * X, int digits, fp_int * P, fp_int *
   fp_init(&R[2]);
 #endif
 
-  /* now we need R mod m */
-  fp_montgomery_calc_normalization (&R[0], P);
-
-  /* now set R[0][1] to G * R mod m */
-  if (fp_cmp_mag(P, G) != FP_GT) {
-     /* G > P so we reduce it first */
-     fp_mod(G, P, &R[1]);
-  } else {
-     fp_copy(G, &R[1]);
+  /* now set R[0] to R mod m and R[1] to G * R mod m */
+  err = _fp_exptmod_mont_init(G, P, R2, mp, &R[0], &R[1]);
+  if (err != FP_OKAY) {
+  #ifdef WOLFSSL_SMALL_STACK
+    XFREE(R, NULL, DYNAMIC_TYPE_BIGINT);
+  #endif
+    return err;
   }
-  fp_mulmod (&R[1], &R[0], P, &R[1]);
 
   /* for j = t-1 downto 0 do
         r_!k = R0*R1; r_k = r_k^2
@@ -1604,9 +2054,10 @@ static int _fp_exptmod(fp_int * G, fp_int * X, int digits, fp_int * P, fp_int *
 
 /* y = g**x (mod b)
  * Some restrictions... x must be positive and < b
+ * R2 and rho are the precomputed Montgomery values of P or NULL and 0.
  */
 static int _fp_exptmod(fp_int * G, fp_int * X, int digits, fp_int * P,
-                       fp_int * Y)
+                       fp_int * R2, fp_digit rho, fp_int * Y)
 {
   fp_digit buf, mp;
   int      err, bitbuf, bitcpy, bitcnt, mode, digidx, x, y, winsize;
@@ -1635,7 +2086,10 @@ static int _fp_exptmod(fp_int * G, fp_int * X, int digits, fp_int * P,
   }
 
   /* now setup montgomery  */
-  if ((err = fp_montgomery_setup (P, &mp)) != FP_OKAY) {
+  if (R2 != NULL) {
+     mp = rho;
+  }
+  else if ((err = fp_montgomery_setup (P, &mp)) != FP_OKAY) {
      return err;
   }
 
@@ -1662,17 +2116,14 @@ static int _fp_exptmod(fp_int * G, fp_int * X, int digits, fp_int * P,
    * The first half of the table is not computed though except for M[0] and M[1]
    */
 
-   /* now we need R mod m */
-   fp_montgomery_calc_normalization (res, P);
-
-   /* now set M[1] to G * R mod m */
-   if (fp_cmp_mag(P, G) != FP_GT) {
-      /* G > P so we reduce it first */
-      fp_mod(G, P, &M[1]);
-   } else {
-      fp_copy(G, &M[1]);
+   /* now set res to R mod m and M[1] to G * R mod m */
+   err = _fp_exptmod_mont_init(G, P, R2, mp, res, &M[1]);
+   if (err != FP_OKAY) {
+   #ifdef WOLFSSL_SMALL_STACK
+     XFREE(M, NULL, DYNAMIC_TYPE_BIGINT);
+   #endif
+     return err;
    }
-   fp_mulmod (&M[1], res, P, &M[1]);
 
   /* compute the value at M[1<<(winsize-1)] by
    * squaring M[1] (winsize-1) times */
@@ -2222,7 +2673,7 @@ int fp_exptmod(fp_int * G, fp_int * X, fp_int * P, fp_int * Y)
       err = fp_invmod(&tmp[0], &tmp[1], &tmp[0]);
       if (err == FP_OKAY) {
          X->sign = FP_ZPOS;
-         err =  _fp_exptmod(&tmp[0], X, X->used, P, Y);
+         err =  _fp_exptmod(&tmp[0], X, X->used, P, NULL, 0, Y);
          if (X != Y) {
             X->sign = FP_NEG;
          }
@@ -2243,7 +2694,7 @@ int fp_exptmod(fp_int * G, fp_int * X, fp_int * P, fp_int * Y)
    }
    else {
       /* Positive exponent so just exptmod */
-      return _fp_exptmod(G, X, X->used, P, Y);
+      return _fp_exptmod(G, X, X->used, P, NULL, 0, Y);
    }
 }
 
@@ -2294,7 +2745,7 @@ int fp_exptmod_ex(fp_int * G, fp_int * X, int digits, fp_int * P, fp_int * Y)
       err = fp_invmod(&tmp[0], &tmp[1], &tmp[0]);
       if (err == FP_OKAY) {
          X->sign = FP_ZPOS;
-         err =  _fp_exptmod(&tmp[0], X, digits, P, Y);
+         err =  _fp_exptmod(&tmp[0], X, digits, P, NULL, 0, Y);
          if (X != Y) {
             X->sign = FP_NEG;
          }
@@ -2312,10 +2763,52 @@ int fp_exptmod_ex(fp_int * G, fp_int * X, int digits, fp_int * P, fp_int * Y)
    }
    else {
       /* Positive exponent so just exptmod */
-      return _fp_exptmod(G, X, digits, P, Y);
+      return _fp_exptmod(G, X, digits, P, NULL, 0, Y);
    }
 }
 
+#ifdef WC_RSA_PREPARED
+/* Precompute the Montgomery values of P for fp_exptmod_mont():
+ * mp = -1/P mod 2**DIGIT_BIT and R2 = R**2 mod P.
+ */
+int fp_exptmod_mont_setup(fp_int * P, fp_int * R2, fp_digit * mp)
+{
+   int err;
+
+   /* prevent overflows */
+   if (P->used > (FP_SIZE/2)) {
+      return FP_VAL;
+   }
+
+   err = fp_montgomery_setup(P, mp);
+   if (err == FP_OKAY) {
+      fp_montgomery_calc_normalization(R2, P);
+      err = fp_sqrmod(R2, P, R2);
+   }
+
+   return err;
+}
+
+/* Y = G**X (mod P) using values from fp_exptmod_mont_setup().
+ * Only positive exponents are supported.
+ */
+int fp_exptmod_mont(fp_int * G, fp_int * X, fp_int * P, fp_int * R2,
+                    fp_digit mp, fp_int * Y)
+{
+   if (fp_iszero(G)) {
+      fp_set(Y, 0);
+      return FP_OKAY;
+   }
+
+   /* prevent overflows */
+   if (P->used > (FP_SIZE/2) || X->sign == FP_NEG) {
+      return FP_VAL;
+   }
+
+   return _fp_exptmod(G, X, X->used, P, R2, mp, Y);
+}
+#endif /* WC_RSA_PREPARED */
+
 
 /* computes a = 2**b */
 void fp_2expt(fp_int *a, int b)
@@ -2356,92 +2849,114 @@ int fp_sqr(fp_int *A, fp_int *B)
        goto clean;
     }
 
+#ifdef TFM_KARATSUBA
+    if (y >= FP_KARATSUBA_CUTOFF && y + y < FP_SIZE) {
+       err = fp_mul_karatsuba(A, A, B);
+       goto clean;
+    }
+#endif
+
 #if defined(TFM_SQR3) && FP_SIZE >= 6
         if (y <= 3) {
+           FP_COMBA_DIGITS(A, 3);
            err = fp_sqr_comba3(A,B);
            goto clean;
         }
 #endif
 #if defined(TFM_SQR4) && FP_SIZE >= 8
         if (y == 4) {
+           FP_COMBA_DIGITS(A, 4);
            err = fp_sqr_comba4(A,B);
            goto clean;
         }
 #endif
 #if defined(TFM_SQR6) && FP_SIZE >= 12
         if (y <= 6) {
+           FP_COMBA_DIGITS(A, 6);
            err = fp_sqr_comba6(A,B);
            goto clean;
         }
 #endif
 #if defined(TFM_SQR7) && FP_SIZE >= 14
         if (y == 7) {
+           FP_COMBA_DIGITS(A, 7);
            err = fp_sqr_comba7(A,B);
            goto clean;
         }
 #endif
 #if defined(TFM_SQR8) && FP_SIZE >= 16
         if (y == 8) {
+           FP_COMBA_DIGITS(A, 8);
            err = fp_sqr_comba8(A,B);
            goto clean;
         }
 #endif
 #if defined(TFM_SQR9) && FP_SIZE >= 18
         if (y == 9) {
+           FP_COMBA_DIGITS(A, 9);
            err = fp_sqr_comba9(A,B);
            goto clean;
         }
 #endif
 #if defined(TFM_SQR12) && FP_SIZE >= 24
         if (y <= 12) {
+           FP_COMBA_DIGITS(A, 12);
            err = fp_sqr_comba12(A,B);
            goto clean;
         }
 #endif
 #if defined(TFM_SQR17) && FP_SIZE >= 34
         if (y <= 17) {
+           FP_COMBA_DIGITS(A, 17);
            err = fp_sqr_comba17(A,B);
            goto clean;
         }
 #endif
 #if defined(TFM_SMALL_SET)
         if (y <= 16) {
+           FP_COMBA_DIGITS(A, y);
            err = fp_sqr_comba_small(A,B);
            goto clean;
         }
 #endif
 #if defined(TFM_SQR20) && FP_SIZE >= 40
         if (y <= 20) {
+           FP_COMBA_DIGITS(A, 20);
            err = fp_sqr_comba20(A,B);
            goto clean;
         }
 #endif
 #if defined(TFM_SQR24) && FP_SIZE >= 48
         if (y <= 24) {
+           FP_COMBA_DIGITS(A, 24);
            err = fp_sqr_comba24(A,B);
            goto clean;
         }
 #endif
 #if defined(TFM_SQR28) && FP_SIZE >= 56
         if (y <= 28) {
+           FP_COMBA_DIGITS(A, 28);
            err = fp_sqr_comba28(A,B);
            goto clean;
         }
 #endif
 #if defined(TFM_SQR32) && FP_SIZE >= 64
         if (y <= 32) {
+           FP_COMBA_DIGITS(A, 32);
            err = fp_sqr_comba32(A,B);
            goto clean;
         }
 #endif
 #if defined(TFM_SQR48) && FP_SIZE >= 96
         if (y <= 48) {
+           FP_COMBA_DIGITS(A, 48);
            err = fp_sqr_comba48(A,B);
            goto clean;
         }
 #endif
 #if defined(TFM_SQR64) && FP_SIZE >= 128
         if (y <= 64) {
+           FP_COMBA_DIGITS(A, 64);
            err = fp_sqr_comba64(A,B);
            goto clean;
         }
@@ -2489,9 +3004,15 @@ int fp_sqr_comba(fp_int *A, fp_int *B)
   COMBA_CLEAR;
 
   if (A == B) {
-     fp_init(tmp);
+     fp_init_size(tmp, pa);
      dst = tmp;
   } else {
+#if defined(TFM_SIZED_INT) && !defined(ALT_ECC_SIZE)
+     /* all dp's are FP_SIZE digits - grow B to take the square */
+     if (B->size < pa) {
+        B->size = pa;
+     }
+#endif
      fp_zero(B);
      dst = B;
   }
@@ -2701,7 +3222,7 @@ static int fp_montgomery_reduce_mulx(fp_int *a, fp_int *m, fp_digit mp)
    fp_digit *c;
 #endif
    fp_digit *_c, *tmpm, mu = 0;
-   int      oldused, x, y, pa;
+   int      oldused, x, y, pa, sz;
 
    /* bail if too large */
    if (m->used > (FP_SIZE/2)) {
@@ -2715,23 +3236,24 @@ static int fp_montgomery_reduce_mulx(fp_int *a, fp_int *m, fp_digit mp)
    }
 #endif
 
+   pa = m->used;
+   oldused = a->used;
+   /* digits the result and its carries can reach */
+   sz = MIN(MAX(oldused, pa + pa) + 1, FP_SIZE + 1);
+
 #ifdef WOLFSSL_SMALL_STACK
    /* only allocate space for what's needed for window plus res */
-   c = (fp_digit*)XMALLOC(sizeof(fp_digit)*(FP_SIZE + 1), NULL, DYNAMIC_TYPE_BIGINT);
+   c = (fp_digit*)XMALLOC(sizeof(fp_digit)*sz, NULL, DYNAMIC_TYPE_BIGINT);
    if (c == NULL) {
       return FP_MEM;
    }
 #endif
 
-   /* now zero the buff */
-   XMEMSET(c, 0, sizeof(fp_digit)*(FP_SIZE + 1));
-   pa = m->used;
-
-   /* copy the input */
-   oldused = a->used;
+   /* copy the input and zero the rest of the buff */
    for (x = 0; x < oldused; x++) {
        c[x] = a->dp[x];
    }
+   XMEMSET(c + oldused, 0, sizeof(fp_digit)*(sz - oldused));
    MONT_START;
 
    for (x = 0; x < pa; x++) {
@@ -2795,7 +3317,7 @@ int fp_montgomery_reduce(fp_int *a, fp_int *m, fp_digit mp)
    fp_digit *c;
 #endif
    fp_digit *_c, *tmpm, mu = 0;
-   int      oldused, x, y, pa, err = 0;
+   int      oldused, x, y, pa, sz, err = 0;
 
    IF_HAVE_INTEL_MULX(err = fp_montgomery_reduce_mulx(a, m, mp), return err) ;
    (void)err;
@@ -2812,23 +3334,24 @@ int fp_montgomery_reduce(fp_int *a, fp_int *m, fp_digit mp)
    }
 #endif
 
+   pa = m->used;
+   oldused = a->used;
+   /* digits the result and its carries can reach */
+   sz = MIN(MAX(oldused, pa + pa) + 1, FP_SIZE + 1);
+
 #ifdef WOLFSSL_SMALL_STACK
    /* only allocate space for what's needed for window plus res */
-   c = (fp_digit*)XMALLOC(sizeof(fp_digit)*(FP_SIZE + 1), NULL, DYNAMIC_TYPE_BIGINT);
+   c = (fp_digit*)XMALLOC(sizeof(fp_digit)*sz, NULL, DYNAMIC_TYPE_BIGINT);
    if (c == NULL) {
       return FP_MEM;
    }
 #endif
 
-   /* now zero the buff */
-   XMEMSET(c, 0, sizeof(fp_digit)*(FP_SIZE + 1));
-   pa = m->used;
-
-   /* copy the input */
-   oldused = a->used;
+   /* copy the input and zero the rest of the buff */
    for (x = 0; x < oldused; x++) {
        c[x] = a->dp[x];
    }
+   XMEMSET(c + oldused, 0, sizeof(fp_digit)*(sz - oldused));
    MONT_START;
 
    for (x = 0; x < pa; x++) {
@@ -2884,7 +3407,7 @@ int fp_montgomery_reduce(fp_int *a, fp_int *m, fp_digit mp)
   return FP_OKAY;
 }
 
-void fp_read_unsigned_bin(fp_int *a, const unsigned char *b, int c)
+int fp_read_unsigned_bin(fp_int *a, const unsigned char *b, int c)
 {
 #if defined(ALT_ECC_SIZE) || defined(HAVE_WOLF_BIGINT)
   const word32 maxC = (a->size * sizeof(fp_digit));
@@ -2895,12 +3418,19 @@ void fp_read_unsigned_bin(fp_int *a, const unsigned char *b, int c)
   /* zero the int */
   fp_zero (a);
 
-  /* if input b excess max, then truncate */
+  /* leading zeros don't need to fit */
+  while (c > 0 && *b == 0) {
+     c--;
+     b++;
+  }
+  /* if input b excess max, then it can't be stored */
   if (c > 0 && (word32)c > maxC) {
-     int excess = (c - maxC);
-     c -= excess;
-     b += excess;
+     return FP_VAL;
   }
+#if defined(TFM_SIZED_INT) && !defined(ALT_ECC_SIZE)
+  /* digits are always there to read into - clear those past size */
+  fp_extend_size(a, (c + (int)sizeof(fp_digit) - 1) / (int)sizeof(fp_digit));
+#endif
 
   /* If we know the endianness of this architecture, and we're using
      32-bit fp_digits, we can optimize this */
@@ -2946,6 +3476,8 @@ void fp_read_unsigned_bin(fp_int *a, const unsigned char *b, int c)
   }
 #endif
   fp_clamp (a);
+
+  return FP_OKAY;
 }
 
 int fp_to_unsigned_bin_at_pos(int x, fp_int *t, unsigned char *b)
@@ -3318,10 +3850,36 @@ int mp_init (mp_int * a)
   return MP_OKAY;
 }
 
+/* init a new mp_int to hold at most size digits */
+int mp_init_size (mp_int * a, int size)
+{
+  if (a)
+    fp_init_size(a, size);
+  return MP_OKAY;
+}
+
 void fp_init(fp_int *a)
 {
-#if defined(ALT_ECC_SIZE) || defined(HAVE_WOLF_BIGINT)
+    fp_init_size(a, FP_SIZE);
+}
+
+/* Only the first size digits are initialized when TFM_SIZED_INT is defined.
+ * Otherwise all FP_SIZE digits are.
+ * Digits past size are not read until written. Operations that write past
+ * size grow it or leave used covering the digits written so that fp_zero(),
+ * fp_clear() and fp_forcezero() clear them. */
+void fp_init_size(fp_int *a, int size)
+{
+#ifdef TFM_SIZED_INT
+    if (size <= 0 || size > FP_SIZE)
+        size = FP_SIZE;
+    a->size = size;
+    a->used = 0;
+#else
+    (void)size;
+  #if defined(ALT_ECC_SIZE) || defined(HAVE_WOLF_BIGINT)
     a->size = FP_SIZE;
+  #endif
 #endif
 #ifdef HAVE_WOLF_BIGINT
     wc_bigint_init(&a->raw);
@@ -3332,22 +3890,36 @@ void fp_init(fp_int *a)
 void fp_zero(fp_int *a)
 {
     int size = FP_SIZE;
-    a->used = 0;
-    a->sign = FP_ZPOS;
-#if defined(ALT_ECC_SIZE) || defined(HAVE_WOLF_BIGINT)
+#if defined(ALT_ECC_SIZE) || defined(HAVE_WOLF_BIGINT) || \
+    defined(TFM_SIZED_INT)
     size = a->size;
 #endif
+#if defined(TFM_SIZED_INT) && !defined(ALT_ECC_SIZE)
+    /* results may be written past size - clear all used digits */
+    if (size < a->used) {
+        size = a->used;
+    }
+#endif
+    a->used = 0;
+    a->sign = FP_ZPOS;
     XMEMSET(a->dp, 0, size * sizeof(fp_digit));
 }
 
 void fp_clear(fp_int *a)
 {
     int size = FP_SIZE;
-    a->used = 0;
-    a->sign = FP_ZPOS;
-#if defined(ALT_ECC_SIZE) || defined(HAVE_WOLF_BIGINT)
+#if defined(ALT_ECC_SIZE) || defined(HAVE_WOLF_BIGINT) || \
+    defined(TFM_SIZED_INT)
     size = a->size;
 #endif
+#if defined(TFM_SIZED_INT) && !defined(ALT_ECC_SIZE)
+    /* results may be written past size - clear all used digits */
+    if (size < a->used) {
+        size = a->used;
+    }
+#endif
+    a->used = 0;
+    a->sign = FP_ZPOS;
     XMEMSET(a->dp, 0, size * sizeof(fp_digit));
     fp_free(a);
 }
@@ -3355,11 +3927,18 @@ void fp_clear(fp_int *a)
 void fp_forcezero (mp_int * a)
 {
     int size = FP_SIZE;
-    a->used = 0;
-    a->sign = FP_ZPOS;
-#if defined(ALT_ECC_SIZE) || defined(HAVE_WOLF_BIGINT)
+#if defined(ALT_ECC_SIZE) || defined(HAVE_WOLF_BIGINT) || \
+    defined(TFM_SIZED_INT)
     size = a->size;
 #endif
+#if defined(TFM_SIZED_INT) && !defined(ALT_ECC_SIZE)
+    /* results may be written past size - clear all used digits */
+    if (size < a->used) {
+        size = a->used;
+    }
+#endif
+    a->used = 0;
+    a->sign = FP_ZPOS;
     ForceZero(a->dp, size * sizeof(fp_digit));
 #ifdef HAVE_WOLF_BIGINT
     wc_bigint_zero(&a->raw);
@@ -3515,6 +4094,19 @@ int mp_exptmod_ex (mp_int * G, mp_int * X, int digits, mp_int * P, mp_int * Y)
   return fp_exptmod_ex(G, X, digits, P, Y);
 }
 
+#ifdef WC_RSA_PREPARED
+int mp_exptmod_mont_setup (mp_int * P, mp_int * R2, mp_digit * mp)
+{
+  return fp_exptmod_mont_setup(P, R2, mp);
+}
+
+int mp_exptmod_mont (mp_int * G, mp_int * X, mp_int * P, mp_int * R2,
+                     mp_digit mp, mp_int * Y)
+{
+  return fp_exptmod_mont(G, X, P, R2, mp, Y);
+}
+#endif
+
 /* compare two ints (signed)*/
 int mp_cmp (mp_int * a, mp_int * b)
 {
@@ -3551,8 +4143,7 @@ int mp_to_unsigned_bin_len(mp_int * a, unsigned char *b, int c)
 /* reads a unsigned char array, assumes the msb is stored first [big endian] */
 int mp_read_unsigned_bin (mp_int * a, const unsigned char *b, int c)
 {
-  fp_read_unsigned_bin(a, b, c);
-  return MP_OKAY;
+  return fp_read_unsigned_bin(a, b, c);
 }
 
 
@@ -3588,11 +4179,18 @@ void fp_copy(fp_int *a, fp_int *b)
 {
     /* if source and destination are different */
     if (a != b) {
-#if defined(ALT_ECC_SIZE) || defined(HAVE_WOLF_BIGINT)
+#if defined(ALT_ECC_SIZE) || defined(HAVE_WOLF_BIGINT) || \
+    defined(TFM_SIZED_INT)
+    #if defined(TFM_SIZED_INT) && !defined(ALT_ECC_SIZE)
+        /* all dp's are FP_SIZE digits - grow b to take a */
+        if (b->size < a->used) {
+            b->size = a->used;
+        }
+    #endif
         /* verify a will fit in b */
         if (b->size >= a->used) {
             int x, oldused;
-            oldused = b->used;
+            oldused = MIN(b->used, FP_SIZE);
             b->used = a->used;
             b->sign = a->sign;
 
@@ -4364,7 +4962,12 @@ int fp_randprime(fp_int* N, int len, WC_RNG* rng, void* heap)
         buf[len-1] |= 0x01 | ((type & USE_BBS) ? 0x02 : 0x00);
 
         /* load value */
-        fp_read_unsigned_bin(N, buf, len);
+        err = fp_read_unsigned_bin(N, buf, len);
+        if (err != FP_OKAY) {
+            XMEMSET(buf, 0, len);
+            XFREE(buf, heap, DYNAMIC_TYPE_TMP_BUFFER);
+            return err;
+        }
 
         /* test */
         /* Running Miller-Rabin up to 3 times gives us a 2^{-80} chance
@@ -4854,7 +5457,8 @@ void mp_dump(const char* desc, mp_int* a, byte verbose)
   char buffer[FP_SIZE * sizeof(fp_digit) * 2];
   int size = FP_SIZE;
 
-#if defined(ALT_ECC_SIZE) || defined(HAVE_WOLF_BIGINT)
+#if defined(ALT_ECC_SIZE) || defined(HAVE_WOLF_BIGINT) || \
+    defined(TFM_SIZED_INT)
   size = a->size;
 #endif
 
@@ -218,6 +218,12 @@ int wolfCrypt_Init(void)
             return ret;
         }
     #endif
+    #ifdef FP_ECC
+        if ((ret = wc_ecc_fp_gen_init()) != 0) {
+            WOLFSSL_MSG("Error creating ECC generator tables");
+            return ret;
+        }
+    #endif
 #endif
 
 #if defined(WOLFSSL_IMX6_CAAM) || defined(WOLFSSL_IMX6_CAAM_RNG) || \
@@ -248,6 +254,7 @@ int wolfCrypt_Cleanup(void)
 #ifdef HAVE_ECC
     #ifdef FP_ECC
         wc_ecc_fp_free();
+        wc_ecc_fp_gen_free();
     #endif
     #ifdef ECC_CACHE_CURVE
         wc_ecc_curve_cache_free();
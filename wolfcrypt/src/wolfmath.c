@@ -81,6 +81,32 @@ int get_digit_count(mp_int* a)
 }
 #endif
 
+#if !defined(WOLFSSL_SP_MATH)
+/* Initialize up to six big numbers that each hold at most size digits.
+ * On error none of them are left initialized. */
+int mp_init_multi_size(int size, mp_int* a, mp_int* b, mp_int* c, mp_int* d,
+                       mp_int* e, mp_int* f)
+{
+    int     ret = MP_OKAY;
+    int     i;
+    mp_int* n[6];
+
+    n[0] = a; n[1] = b; n[2] = c; n[3] = d; n[4] = e; n[5] = f;
+    for (i = 0; i < 6; i++) {
+        if (n[i] != NULL && (ret = mp_init_size(n[i], size)) != MP_OKAY)
+            break;
+    }
+    if (ret != MP_OKAY) {
+        while (i-- > 0) {
+            if (n[i] != NULL)
+                mp_clear(n[i]);
+        }
+    }
+
+    return ret;
+}
+#endif
+
 mp_digit get_digit(mp_int* a, int n)
 {
     if (a == NULL)
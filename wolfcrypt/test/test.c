@@ -391,6 +391,11 @@ int memory_test(void);
 #ifdef HAVE_VALGRIND
 int mp_test(void);
 #endif
+#if (defined(HAVE_VALGRIND) || defined(WOLFSSL_PUBLIC_MP)) && \
+    !defined(WOLFSSL_SP_MATH) && !defined(NO_SHA256) && \
+    (!defined(USE_FAST_MATH) || FP_MAX_BITS >= 16384)
+int mp_mul_test(void);
+#endif
 #ifdef WOLFSSL_PUBLIC_MP
 int prime_test(void);
 #endif
@@ -1080,6 +1085,15 @@ initDefaultName();
         test_pass("mp       test passed!\n");
 #endif
 
+#if (defined(HAVE_VALGRIND) || defined(WOLFSSL_PUBLIC_MP)) && \
+    !defined(WOLFSSL_SP_MATH) && !defined(NO_SHA256) && \
+    (!defined(USE_FAST_MATH) || FP_MAX_BITS >= 16384)
+    if ( (ret = mp_mul_test()) != 0)
+        return err_sys("mp mul   test failed!\n", ret);
+    else
+        test_pass("mp mul   test passed!\n");
+#endif
+
 #if defined(WOLFSSL_PUBLIC_MP)
     if ( (ret = prime_test()) != 0)
         return err_sys("prime    test failed!\n", ret);
@@ -9379,6 +9393,12 @@ int cert_test(void)
     size_t      bytes;
     XFILE       file;
     int         ret;
+#ifdef WOLFSSL_ASN_LAZY_EXT
+    /* OID of subject alt names then OCTET STRING header */
+    static const byte altNamesOid[] = { ASN_OBJECT_ID, 0x03, 0x55, 0x1d, 0x11,
+                                        ASN_OCTET_STRING };
+    int         i;
+#endif
 
     tmp = (byte*)XMALLOC(FOURK_BUF, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
     if (tmp == NULL)
@@ -9419,6 +9439,57 @@ int cert_test(void)
         ERROR_OUT(-6604, done);
     }
 
+#ifdef WOLFSSL_ASN_LAZY_EXT
+    FreeDecodedCert(&cert);
+
+    /* Alt names are only decoded on request when parsing lazily. */
+#ifdef FREESCALE_MQX
+    file = XFOPEN(".\\certs\\client-cert-ext.der", "rb");
+#else
+    file = XFOPEN("./certs/client-cert-ext.der", "rb");
+#endif
+    if (!file) {
+        ERROR_OUT(-6605, done);
+    }
+    bytes = XFREAD(tmp, 1, FOURK_BUF, file);
+    XFCLOSE(file);
+    InitDecodedCert(&cert, tmp, (word32)bytes, 0);
+    cert.lazyExt = 1;
+    ret = ParseCert(&cert, CERT_TYPE, NO_VERIFY, NULL);
+    if (ret != 0) {
+        ERROR_OUT(-6606, done);
+    }
+    if (cert.altNames != NULL || !cert.extSubjAltNameSet) {
+        ERROR_OUT(-6607, done);
+    }
+    ret = DecodeCertLazyExt(&cert, CERT_LAZY_ALL);
+    if (ret != 0) {
+        ERROR_OUT(-6608, done);
+    }
+    if (cert.altNames == NULL || cert.altNames->len != 11 ||
+            XMEMCMP(cert.altNames->name, "example.com", 11) != 0) {
+        ERROR_OUT(-6609, done);
+    }
+
+    /* A deferred extension that isn't a SEQUENCE still fails to parse. */
+    for (i = 0; i + 7 < (int)bytes; i++) {
+        if (XMEMCMP(&tmp[i], altNamesOid, sizeof(altNamesOid)) == 0)
+            break;
+    }
+    if (i + 7 >= (int)bytes || tmp[i + 7] != (ASN_SEQUENCE | ASN_CONSTRUCTED)) {
+        ERROR_OUT(-6610, done);
+    }
+    FreeDecodedCert(&cert);
+    tmp[i + 7] = ASN_OCTET_STRING;
+    InitDecodedCert(&cert, tmp, (word32)bytes, 0);
+    cert.lazyExt = 1;
+    ret = ParseCert(&cert, CERT_TYPE, NO_VERIFY, NULL);
+    if (ret != ASN_PARSE_E) {
+        ERROR_OUT(-6611, done);
+    }
+    ret = 0;
+#endif /* WOLFSSL_ASN_LAZY_EXT */
+
 done:
     FreeDecodedCert(&cert);
     XFREE(tmp, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
@@ -10444,6 +10515,193 @@ done:
 
 #define RSA_TEST_BYTES 256
 
+#if defined(WC_RSA_PREPARED) && !defined(NO_ASN) && \
+    !defined(WOLFSSL_RSA_VERIFY_ONLY) && !defined(WOLFSSL_ASYNC_CRYPT)
+static int rsa_prepared_test(RsaKey* key, const byte* der, word32 derSz,
+    const byte* in, word32 inLen, byte* out, word32 outSz, byte* plain,
+    word32 plainSz, WC_RNG* rng)
+{
+    int    ret, i;
+    int    sigSz, encSz;
+    word32 idx = 0;
+    RsaKey prepKey;
+#ifdef WOLFSSL_SMALL_STACK
+    byte*  sig;
+#else
+    byte   sig[RSA_TEST_BYTES];
+#endif
+
+    if (outSz > RSA_TEST_BYTES)
+        return -7240;
+#ifdef WOLFSSL_SMALL_STACK
+    sig = (byte*)XMALLOC(RSA_TEST_BYTES, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+    if (sig == NULL)
+        return -7241;
+#endif
+
+    ret = wc_InitRsaKey_ex(&prepKey, HEAP_HINT, devId);
+    if (ret != 0) {
+        ret = -7242;
+        goto done;
+    }
+    if (wc_RsaPrepareKey(&prepKey) != BAD_FUNC_ARG ||
+                                    wc_RsaPrepareKey(NULL) != BAD_FUNC_ARG) {
+        ERROR_OUT(-7243, exit_rsa_prepared);
+    }
+    ret = wc_RsaPrivateKeyDecode(der, &idx, &prepKey, derSz);
+    if (ret != 0) {
+        ERROR_OUT(-7244, exit_rsa_prepared);
+    }
+    ret = wc_RsaPrepareKey(&prepKey);
+    if (ret != 0) {
+        ERROR_OUT(-7245, exit_rsa_prepared);
+    }
+#ifdef WC_RSA_BLINDING
+    ret = wc_RsaSetRNG(&prepKey, rng);
+    if (ret != 0) {
+        ERROR_OUT(-7246, exit_rsa_prepared);
+    }
+#endif
+
+    /* PKCS #1 v1.5 signatures are deterministic - use more operations than
+     * the blinding pair is cached for */
+    sigSz = wc_RsaSSL_Sign(in, inLen, sig, outSz, key, rng);
+    if (sigSz < 0) {
+        ERROR_OUT(-7247, exit_rsa_prepared);
+    }
+    for (i = 0; i < 40; i++) {
+        ret = wc_RsaSSL_Sign(in, inLen, out, outSz, &prepKey, rng);
+        if (ret != sigSz || XMEMCMP(out, sig, (size_t)sigSz) != 0) {
+            ERROR_OUT(-7248, exit_rsa_prepared);
+        }
+    }
+
+    /* decrypt with prepared key */
+    encSz = wc_RsaPublicEncrypt(in, inLen, out, outSz, key, rng);
+    if (encSz < 0) {
+        ERROR_OUT(-7249, exit_rsa_prepared);
+    }
+    XMEMSET(plain, 0, plainSz);
+    ret = wc_RsaPrivateDecrypt(out, (word32)encSz, plain, plainSz, &prepKey);
+    if (ret != (int)inLen || XMEMCMP(plain, in, inLen) != 0) {
+        ERROR_OUT(-7250, exit_rsa_prepared);
+    }
+
+    /* preparing again starts from fresh values */
+    ret = wc_RsaPrepareKey(&prepKey);
+    if (ret == 0)
+        ret = wc_RsaSSL_Sign(in, inLen, out, outSz, &prepKey, rng);
+    if (ret != sigSz || XMEMCMP(out, sig, (size_t)sigSz) != 0) {
+        ERROR_OUT(-7251, exit_rsa_prepared);
+    }
+    ret = 0;
+
+exit_rsa_prepared:
+    wc_FreeRsaKey(&prepKey);
+done:
+#ifdef WOLFSSL_SMALL_STACK
+    XFREE(sig, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+    return ret;
+}
+#endif
+
+#if defined(WC_RSA_BATCH) && !defined(WOLFSSL_RSA_PUBLIC_ONLY) && \
+    !defined(WOLFSSL_ASYNC_CRYPT)
+#define RSA_BATCH_TEST_CNT  11
+
+static int rsa_batch_test(RsaKey* key, WC_RNG* rng)
+{
+    int          ret = 0;
+    int          i, sz;
+    RsaKey*      keys[RSA_BATCH_TEST_CNT];
+    const byte*  sigs[RSA_BATCH_TEST_CNT];
+    word32       sigSz[RSA_BATCH_TEST_CNT];
+    byte*        outs[RSA_BATCH_TEST_CNT];
+    word32       outSz[RSA_BATCH_TEST_CNT];
+    int          res[RSA_BATCH_TEST_CNT];
+    byte         msg[32];
+    byte         plain[RSA_TEST_BYTES];
+    byte*        buf;
+#ifdef WOLFSSL_KEY_GEN
+    RsaKey       genKey;
+#endif
+
+    buf = (byte*)XMALLOC(2 * RSA_BATCH_TEST_CNT * RSA_TEST_BYTES, HEAP_HINT,
+                                                       DYNAMIC_TYPE_TMP_BUFFER);
+    if (buf == NULL)
+        return -7264;
+#ifdef WOLFSSL_KEY_GEN
+    /* second modulus with a short exponent */
+    ret = wc_InitRsaKey_ex(&genKey, HEAP_HINT, devId);
+    if (ret != 0) {
+        XFREE(buf, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+        return -7265;
+    }
+    ret = wc_MakeRsaKey(&genKey, 2048, 3, rng);
+    if (ret != 0) {
+        ERROR_OUT(-7266, exit_rsa_batch);
+    }
+#endif
+
+    for (i = 0; i < RSA_BATCH_TEST_CNT; i++) {
+        keys[i] = key;
+    #ifdef WOLFSSL_KEY_GEN
+        if (i % 3 == 1)
+            keys[i] = &genKey;
+    #endif
+        XMEMSET(msg, (byte)i, sizeof(msg));
+        outs[i] = buf + (RSA_BATCH_TEST_CNT + i) * RSA_TEST_BYTES;
+        outSz[i] = RSA_TEST_BYTES;
+        sz = wc_RsaSSL_Sign(msg, sizeof(msg), buf + i * RSA_TEST_BYTES,
+                                             RSA_TEST_BYTES, keys[i], rng);
+        if (sz <= 0) {
+            ERROR_OUT(-7267, exit_rsa_batch);
+        }
+        sigs[i] = buf + i * RSA_TEST_BYTES;
+        sigSz[i] = (word32)sz;
+    }
+    /* bad signature and output buffer too small */
+    buf[5 * RSA_TEST_BYTES + 17] ^= 0x80;
+    outSz[8] = sizeof(msg) - 1;
+
+    if (wc_RsaSSL_VerifyBatch(NULL, sigSz, outs, outSz, keys, res,
+                                         RSA_BATCH_TEST_CNT) != BAD_FUNC_ARG) {
+        ERROR_OUT(-7268, exit_rsa_batch);
+    }
+    ret = wc_RsaSSL_VerifyBatch(sigs, sigSz, outs, outSz, keys, res,
+                                                            RSA_BATCH_TEST_CNT);
+    if (ret != 0) {
+        ERROR_OUT(-7269, exit_rsa_batch);
+    }
+
+    for (i = 0; i < RSA_BATCH_TEST_CNT; i++) {
+        XMEMSET(msg, (byte)i, sizeof(msg));
+        sz = wc_RsaSSL_Verify(sigs[i], sigSz[i], plain, outSz[i], keys[i]);
+        if (res[i] != sz) {
+            ERROR_OUT(-7270, exit_rsa_batch);
+        }
+        if (i == 5 || i == 8) {
+            if (sz >= 0) {
+                ERROR_OUT(-7271, exit_rsa_batch);
+            }
+        }
+        else if (sz != (int)sizeof(msg) ||
+                 XMEMCMP(outs[i], msg, sizeof(msg)) != 0) {
+            ERROR_OUT(-7272, exit_rsa_batch);
+        }
+    }
+    ret = 0;
+
+exit_rsa_batch:
+#ifdef WOLFSSL_KEY_GEN
+    wc_FreeRsaKey(&genKey);
+#endif
+    XFREE(buf, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+    return ret;
+}
+#endif
+
 #ifdef WC_RSA_PSS
 static int rsa_pss_test(WC_RNG* rng, RsaKey* key)
 {
@@ -11470,6 +11728,22 @@ exit_rsa:
 #endif /* !NO_RSA && HAVE_ECC && WOLFSSL_CERT_GEN */
 
 #ifdef WOLFSSL_KEY_GEN
+#if !defined(HAVE_FIPS) && !defined(HAVE_SELFTEST) && \
+    !defined(HAVE_USER_RSA) && !defined(WOLFSSL_ASYNC_CRYPT)
+/* Key generation thread pool that runs the jobs one after the other. */
+static int rsa_keygen_pool_run(void* ctx, void (*job)(void* arg), void** args,
+                               int cnt)
+{
+    int i;
+
+    for (i = 0; i < cnt; i++)
+        job(args[i]);
+    *(int*)ctx += cnt;
+
+    return 0;
+}
+#endif
+
 static int rsa_keygen_test(WC_RNG* rng)
 {
     RsaKey genKey;
@@ -11514,6 +11788,61 @@ static int rsa_keygen_test(WC_RNG* rng)
         ERROR_OUT(-8228, exit_rsa);
     }
     #endif
+
+#if !defined(HAVE_FIPS) && !defined(HAVE_SELFTEST) && \
+    !defined(HAVE_USER_RSA) && !defined(WOLFSSL_ASYNC_CRYPT)
+    {
+        RsaKeyGenPool pool;
+        int           jobs = 0;
+
+        pool.run = rsa_keygen_pool_run;
+        pool.ctx = &jobs;
+        pool.threads = 0;
+        if (wc_MakeRsaKey_ex(&genKey, keySz, WC_RSA_EXPONENT, rng,
+                                                       &pool) != BAD_FUNC_ARG) {
+            ERROR_OUT(-7218, exit_rsa);
+        }
+
+        /* a job for each thread when searching for p and for q */
+        wc_FreeRsaKey(&genKey);
+        ret = wc_InitRsaKey_ex(&genKey, HEAP_HINT, devId);
+        if (ret == 0) {
+            pool.threads = 3;
+            ret = wc_MakeRsaKey_ex(&genKey, keySz, WC_RSA_EXPONENT, rng, &pool);
+        }
+        if (ret != 0) {
+            ERROR_OUT(-7219, exit_rsa);
+        }
+        if (jobs != 6) {
+            ERROR_OUT(-7220, exit_rsa);
+        }
+    #if !defined(HAVE_FAST_RSA) && !defined(HAVE_INTEL_QA)
+        if (wc_CheckRsaKey(&genKey) != 0) {
+            ERROR_OUT(-7221, exit_rsa);
+        }
+    #endif
+    #ifndef WOLFSSL_RSA_VERIFY_ONLY
+        {
+            const byte msg[] = "key generated with a pool";
+            byte       sig[256];
+            byte*      out = NULL;
+            int        sigSz;
+
+            sigSz = wc_RsaSSL_Sign(msg, sizeof(msg), sig, sizeof(sig),
+                                                                 &genKey, rng);
+            if (sigSz <= 0) {
+                ERROR_OUT(-7222, exit_rsa);
+            }
+            ret = wc_RsaSSL_VerifyInline(sig, sigSz, &out, &genKey);
+            if (ret != (int)sizeof(msg) ||
+                                       XMEMCMP(out, msg, sizeof(msg)) != 0) {
+                ERROR_OUT(-7223, exit_rsa);
+            }
+            ret = 0;
+        }
+    #endif
+    }
+#endif
     der = (byte*)XMALLOC(FOURK_BUF, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
     if (der == NULL) {
         ERROR_OUT(-6964, exit_rsa);
@@ -11559,6 +11888,101 @@ exit_rsa:
 }
 #endif
 
+#if defined(WOLFSSL_KEY_GEN) && defined(WOLFSSL_RSA_MULTI_PRIME)
+static int rsa_multi_prime_test(WC_RNG* rng)
+{
+    RsaKey      genKey;
+    RsaKey      decKey;
+    int         ret;
+    int         sigSz, derSz;
+    word32      idx = 0;
+    const char* inStr = "Everyone gets Friday off.";
+    word32      inLen = (word32)XSTRLEN((char*)inStr);
+    byte*       der = NULL;
+    byte*       sig = NULL;
+    byte*       out = NULL;
+
+    XMEMSET(&genKey, 0, sizeof(genKey));
+    XMEMSET(&decKey, 0, sizeof(decKey));
+
+    der = (byte*)XMALLOC(FOURK_BUF, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+    sig = (byte*)XMALLOC(RSA_TEST_BYTES * 2, HEAP_HINT,
+                                                      DYNAMIC_TYPE_TMP_BUFFER);
+    if (der == NULL || sig == NULL) {
+        ERROR_OUT(-7252, exit_rsa_mp);
+    }
+    out = sig + RSA_TEST_BYTES;
+
+    ret = wc_InitRsaKey_ex(&genKey, HEAP_HINT, devId);
+    if (ret == 0)
+        ret = wc_InitRsaKey_ex(&decKey, HEAP_HINT, devId);
+    if (ret != 0) {
+        ERROR_OUT(-7253, exit_rsa_mp);
+    }
+
+    /* 4 primes are too small at 2048 bits */
+    if (wc_MakeRsaKeyMultiPrime(&genKey, 2048, WC_RSA_EXPONENT, 4,
+                                                      rng) != BAD_FUNC_ARG ||
+            wc_MakeRsaKeyMultiPrime(&genKey, 2048, WC_RSA_EXPONENT,
+                                     RSA_MAX_PRIMES + 1, rng) != BAD_FUNC_ARG) {
+        ERROR_OUT(-7254, exit_rsa_mp);
+    }
+
+    ret = wc_MakeRsaKeyMultiPrime(&genKey, 2048, WC_RSA_EXPONENT, 3, rng);
+    if (ret != 0) {
+        ERROR_OUT(-7255, exit_rsa_mp);
+    }
+    if (wc_RsaEncryptSize(&genKey) != RSA_TEST_BYTES ||
+                                                 wc_CheckRsaKey(&genKey) != 0) {
+        ERROR_OUT(-7256, exit_rsa_mp);
+    }
+
+    sigSz = wc_RsaSSL_Sign((const byte*)inStr, inLen, sig, RSA_TEST_BYTES,
+                                                                  &genKey, rng);
+    if (sigSz != RSA_TEST_BYTES) {
+        ERROR_OUT(-7257, exit_rsa_mp);
+    }
+    ret = wc_RsaSSL_Verify(sig, (word32)sigSz, out, RSA_TEST_BYTES, &genKey);
+    if (ret != (int)inLen || XMEMCMP(out, inStr, inLen) != 0) {
+        ERROR_OUT(-7258, exit_rsa_mp);
+    }
+
+    /* DER has the other prime - decoded key gives the same signature */
+    derSz = wc_RsaKeyToDer(&genKey, der, FOURK_BUF);
+    if (derSz < 0) {
+        ERROR_OUT(-7259, exit_rsa_mp);
+    }
+    ret = wc_RsaPrivateKeyDecode(der, &idx, &decKey, (word32)derSz);
+    if (ret != 0 || idx != (word32)derSz || decKey.primes != 3) {
+        ERROR_OUT(-7260, exit_rsa_mp);
+    }
+    ret = wc_RsaSSL_Sign((const byte*)inStr, inLen, out, RSA_TEST_BYTES,
+                                                                  &decKey, rng);
+    if (ret != sigSz || XMEMCMP(out, sig, (size_t)sigSz) != 0) {
+        ERROR_OUT(-7261, exit_rsa_mp);
+    }
+
+    /* truncated other prime information */
+    wc_FreeRsaKey(&decKey);
+    ret = wc_InitRsaKey_ex(&decKey, HEAP_HINT, devId);
+    if (ret != 0) {
+        ERROR_OUT(-7262, exit_rsa_mp);
+    }
+    idx = 0;
+    if (wc_RsaPrivateKeyDecode(der, &idx, &decKey, (word32)derSz - 1) == 0) {
+        ERROR_OUT(-7263, exit_rsa_mp);
+    }
+    ret = 0;
+
+exit_rsa_mp:
+    wc_FreeRsaKey(&decKey);
+    wc_FreeRsaKey(&genKey);
+    XFREE(sig, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(der, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+    return ret;
+}
+#endif
+
 int rsa_test(void)
 {
     int    ret;
@@ -11714,6 +12138,21 @@ int rsa_test(void)
         goto exit_rsa;
 #endif
 
+#if defined(WC_RSA_PREPARED) && !defined(NO_ASN) && \
+    !defined(WOLFSSL_RSA_VERIFY_ONLY) && !defined(WOLFSSL_ASYNC_CRYPT)
+    ret = rsa_prepared_test(&key, tmp, (word32)bytes, in, inLen, out, outSz,
+                                                          plain, plainSz, &rng);
+    if (ret != 0)
+        goto exit_rsa;
+#endif
+
+#if defined(WC_RSA_BATCH) && !defined(WOLFSSL_RSA_PUBLIC_ONLY) && \
+    !defined(WOLFSSL_ASYNC_CRYPT)
+    ret = rsa_batch_test(&key, &rng);
+    if (ret != 0)
+        goto exit_rsa;
+#endif
+
 #if !defined(WOLFSSL_RSA_VERIFY_ONLY) && !defined(WOLFSSL_RSA_PUBLIC_ONLY)
     do {
 #if defined(WOLFSSL_ASYNC_CRYPT)
@@ -12266,6 +12705,11 @@ int rsa_test(void)
     if (ret != 0)
         goto exit_rsa;
 #endif
+#if defined(WOLFSSL_KEY_GEN) && defined(WOLFSSL_RSA_MULTI_PRIME)
+    ret = rsa_multi_prime_test(&rng);
+    if (ret != 0)
+        goto exit_rsa;
+#endif
 
 #ifdef WOLFSSL_CERT_GEN
     /* Make Cert / Sign example for RSA cert and RSA CA */
@@ -18411,6 +18855,97 @@ exit:
 }
 #endif /* WOLFSSL_CERT_GEN */
 
+#if defined(WOLFSSL_ECC_PRECOMPUTE) && defined(HAVE_ECC_SIGN) && \
+    defined(HAVE_ECC_VERIFY) && defined(HAVE_ECC_DHE) && \
+    !defined(WOLFSSL_ASYNC_CRYPT) && (!defined(NO_ECC256) || defined(HAVE_ALL_CURVES))
+/* Test signature verification and shared secrets with precomputed tables of
+ * the public key, including a table left over from a replaced public key. */
+static int ecc_test_precompute(WC_RNG* rng)
+{
+    int     ret;
+    int     i;
+    int     verify;
+    ecc_key key;
+    ecc_key peer;
+    byte    hash[WC_SHA256_DIGEST_SIZE];
+    byte    sig[ECC_MAX_SIG_SIZE];
+    word32  sigSz;
+    byte    secret1[32];
+    byte    secret2[32];
+    word32  secretSz;
+
+    XMEMSET(hash, 0x5a, sizeof(hash));
+
+    wc_ecc_init_ex(&key, HEAP_HINT, devId);
+    wc_ecc_init_ex(&peer, HEAP_HINT, devId);
+
+    if (wc_ecc_precompute(NULL) != BAD_FUNC_ARG)
+        ERROR_OUT(-8452, done);
+    if (wc_ecc_precompute(&key) != ECC_BAD_ARG_E)
+        ERROR_OUT(-8453, done);
+
+    ret = wc_ecc_make_key(rng, 32, &key);
+    if (ret != 0)
+        ERROR_OUT(-8454, done);
+    ret = wc_ecc_make_key(rng, 32, &peer);
+    if (ret != 0)
+        ERROR_OUT(-8455, done);
+    ret = wc_ecc_precompute(&key);
+    if (ret != 0)
+        ERROR_OUT(-8456, done);
+    ret = wc_ecc_precompute(&peer);
+    if (ret != 0)
+        ERROR_OUT(-8457, done);
+
+    /* second time peer's public key has been replaced - table not valid */
+    for (i = 0; i < 2; i++) {
+        sigSz = (word32)sizeof(sig);
+        ret = wc_ecc_sign_hash(hash, sizeof(hash), sig, &sigSz, rng, &key);
+        if (ret != 0)
+            ERROR_OUT(-8458, done);
+        verify = 0;
+        ret = wc_ecc_verify_hash(sig, sigSz, hash, sizeof(hash), &verify,
+                                 &key);
+        if (ret != 0 || verify != 1)
+            ERROR_OUT(-8459, done);
+        hash[0] ^= 0x01;
+        ret = wc_ecc_verify_hash(sig, sigSz, hash, sizeof(hash), &verify,
+                                 &key);
+        if (ret != 0 || verify != 0)
+            ERROR_OUT(-8460, done);
+
+        sigSz = (word32)sizeof(sig);
+        ret = wc_ecc_sign_hash(hash, sizeof(hash), sig, &sigSz, rng, &peer);
+        if (ret != 0)
+            ERROR_OUT(-8461, done);
+        ret = wc_ecc_verify_hash(sig, sigSz, hash, sizeof(hash), &verify,
+                                 &peer);
+        if (ret != 0 || verify != 1)
+            ERROR_OUT(-8462, done);
+
+        secretSz = (word32)sizeof(secret1);
+        ret = wc_ecc_shared_secret(&key, &peer, secret1, &secretSz);
+        if (ret != 0 || secretSz != (word32)sizeof(secret1))
+            ERROR_OUT(-8463, done);
+        secretSz = (word32)sizeof(secret2);
+        ret = wc_ecc_shared_secret(&peer, &key, secret2, &secretSz);
+        if (ret != 0 || secretSz != (word32)sizeof(secret2))
+            ERROR_OUT(-8464, done);
+        if (XMEMCMP(secret1, secret2, sizeof(secret1)) != 0)
+            ERROR_OUT(-8465, done);
+
+        ret = wc_ecc_make_key(rng, 32, &peer);
+        if (ret != 0)
+            ERROR_OUT(-8466, done);
+    }
+
+done:
+    wc_ecc_free(&peer);
+    wc_ecc_free(&key);
+    return ret;
+}
+#endif
+
 #if !defined(HAVE_FIPS) && !defined(HAVE_SELFTEST)
 /* Test for the wc_ecc_key_new() and wc_ecc_key_free() functions. */
 static int ecc_test_allocator(WC_RNG* rng)
@@ -18568,6 +19103,15 @@ int ecc_test(void)
         goto done;
     }
 #endif
+#if defined(WOLFSSL_ECC_PRECOMPUTE) && defined(HAVE_ECC_SIGN) && \
+    defined(HAVE_ECC_VERIFY) && defined(HAVE_ECC_DHE) && \
+    !defined(WOLFSSL_ASYNC_CRYPT) && (!defined(NO_ECC256) || defined(HAVE_ALL_CURVES))
+    ret = ecc_test_precompute(&rng);
+    if (ret != 0) {
+        printf("ecc_test_precompute failed!: %d\n", ret);
+        goto done;
+    }
+#endif
 #if !defined(HAVE_FIPS) && !defined(HAVE_SELFTEST)
     ret = ecc_test_allocator(&rng);
     if (ret != 0) {
@@ -24450,6 +24994,9 @@ int mp_test(void)
     mp_digit d;
 #endif
     mp_int a, b, r1, r2, p;
+#if defined(USE_FAST_MATH) && !defined(WOLFSSL_SP_MATH)
+    byte   buffer[FP_SIZE * sizeof(fp_digit) + 1];
+#endif
 
     ret = mp_init_multi(&a, &b, &r1, &r2, NULL, NULL);
     if (ret != 0)
@@ -24556,6 +25103,101 @@ int mp_test(void)
     }
 #endif
 
+#ifndef WOLFSSL_SP_MATH
+    /* Check numbers sized for a modulus hold products and copies. */
+    ret = randNum(&p, MP_MAX_TEST_BYTE_LEN, &rng, NULL);
+    if (ret == 0)
+        ret = randNum(&a, MP_MAX_TEST_BYTE_LEN, &rng, NULL);
+    if (ret == 0)
+        ret = randNum(&b, MP_MAX_TEST_BYTE_LEN, &rng, NULL);
+    if (ret != 0)
+        return -9621;
+    mp_clear(&r2);
+    mp_clear(&r1);
+    ret = mp_init_multi_size(MP_MOD_SIZE(&p), &r1, &r2, NULL, NULL, NULL,
+                                                                         NULL);
+    if (ret == 0)
+        ret = mp_mulmod(&a, &b, &p, &r1);
+    if (ret != 0)
+        return -9622;
+    ret = mp_mul(&a, &b, &r2);
+    if (ret == 0)
+        ret = mp_mod(&r2, &p, &r2);
+    if (ret != 0)
+        return -9623;
+    if (mp_cmp(&r1, &r2) != MP_EQ)
+        return -9624;
+    mp_clear(&r1);
+    ret = mp_init_size(&r1, 1);
+    if (ret != 0)
+        return -9625;
+    ret = mp_copy(&r2, &r1);
+    if (ret != 0 || mp_cmp(&r1, &r2) != MP_EQ)
+        return -9626;
+    /* Square into a smaller number and clear all of it. */
+    mp_clear(&r1);
+    ret = mp_init_size(&r1, 1);
+    if (ret != 0)
+        return -9627;
+    ret = mp_sqr(&a, &r1);
+    if (ret == 0)
+        ret = mp_mul(&a, &a, &r2);
+    if (ret != 0 || mp_cmp(&r1, &r2) != MP_EQ)
+        return -9628;
+    {
+        int x;
+        int usedSz = r1.used;
+
+        mp_zero(&r1);
+        for (x = 0; x < usedSz; x++) {
+            if (r1.dp[x] != 0)
+                return -9629;
+        }
+    }
+#if defined(USE_FAST_MATH) && defined(TFM_SIZED_INT)
+    /* Only the digits up to size are initialized - use a smaller number
+     * without reading past them. */
+    mp_clear(&r1);
+    XMEMSET(r1.dp, 0xff, sizeof(r1.dp));
+    ret = mp_init_size(&r1, 1);
+    if (ret == 0)
+        ret = mp_set_int(&r1, 3);
+    if (ret == 0)
+        ret = mp_add(&a, &r1, &r2);
+    if (ret == 0)
+        ret = mp_add_d(&a, 3, &b);
+    if (ret != 0 || mp_cmp(&r2, &b) != MP_EQ)
+        return -9640;
+    ret = mp_mul(&a, &r1, &r2);
+    if (ret == 0)
+        ret = mp_mul_d(&a, 3, &b);
+    if (ret != 0 || mp_cmp(&r2, &b) != MP_EQ)
+        return -9641;
+    /* Read a number bigger than the size. */
+    mp_clear(&r1);
+    XMEMSET(r1.dp, 0xff, sizeof(r1.dp));
+    ret = mp_init_size(&r1, 1);
+    if (ret == 0)
+        ret = mp_to_unsigned_bin(&r2, buffer);
+    if (ret == 0)
+        ret = mp_read_unsigned_bin(&r1, buffer, mp_unsigned_bin_size(&r2));
+    if (ret != 0 || mp_cmp(&r1, &r2) != MP_EQ)
+        return -9642;
+#endif
+#ifdef USE_FAST_MATH
+    /* Numbers too big to store are rejected, not truncated. */
+    XMEMSET(buffer, 0, sizeof(buffer));
+    buffer[sizeof(buffer) - 1] = 1;
+    if (mp_read_unsigned_bin(&r1, buffer, (int)sizeof(buffer)) != MP_OKAY ||
+                                                      mp_cmp_d(&r1, 1) != MP_EQ)
+        return -9643;
+    buffer[0] = 1;
+    if (mp_read_unsigned_bin(&r1, buffer, (int)sizeof(buffer)) != MP_VAL)
+        return -9644;
+    ret = 0;
+#endif
+#endif
+
 done:
     mp_clear(&p);
     mp_clear(&r2);
@@ -24567,6 +25209,126 @@ done:
 }
 #endif
 
+#if (defined(HAVE_VALGRIND) || defined(WOLFSSL_PUBLIC_MP)) && \
+    !defined(WOLFSSL_SP_MATH) && !defined(NO_SHA256) && \
+    (!defined(USE_FAST_MATH) || FP_MAX_BITS >= 16384)
+/* Known answers for multiplying and squaring numbers large enough to be
+ * split by Karatsuba, with sizes that need padding. The same operand twice
+ * is squared. */
+int mp_mul_test(void)
+{
+    int    ret = 0;
+    int    i;
+    word32 outSz;
+    mp_int a, b, r;
+    byte   hash[WC_SHA256_DIGEST_SIZE];
+#ifdef WOLFSSL_SMALL_STACK
+    byte*  buf;
+#else
+    byte   buf[1520];
+#endif
+    /* SHA-256 of the big-endian a * b and a * a */
+    static const byte mulHash[] = {
+        0xe9, 0xf1, 0xde, 0x3e, 0x16, 0xd5, 0x6c, 0x15,
+        0x6a, 0x64, 0xfa, 0x39, 0xf2, 0xa6, 0xa0, 0x04,
+        0x8c, 0x26, 0xb8, 0x5f, 0x72, 0x9c, 0xf1, 0x6b,
+        0xd6, 0x2f, 0x90, 0x17, 0x38, 0x6f, 0x01, 0xb1
+    };
+    static const byte sqrHash[] = {
+        0xbc, 0x9c, 0x40, 0x06, 0xa8, 0x28, 0x37, 0x8c,
+        0xa9, 0x7a, 0x7a, 0xcb, 0xf9, 0xd0, 0xdd, 0x0a,
+        0xde, 0x5f, 0x6c, 0xa7, 0xff, 0xfc, 0x6e, 0x35,
+        0x9e, 0xbd, 0x30, 0xa9, 0xa6, 0x29, 0xf8, 0x19
+    };
+
+#ifdef WOLFSSL_SMALL_STACK
+    buf = (byte*)XMALLOC(1520, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+    if (buf == NULL)
+        return -9630;
+#endif
+
+    if (mp_init_multi(&a, &b, &r, NULL, NULL, NULL) != MP_OKAY) {
+        ret = -9631;
+        goto done;
+    }
+
+    /* 760 and 700 byte operands */
+    for (i = 0; i < 760; i++)
+        buf[i] = (byte)(i * 0x9d + 0x3b);
+    ret = mp_read_unsigned_bin(&a, buf, 760);
+    if (ret == 0) {
+        for (i = 0; i < 700; i++)
+            buf[i] = (byte)(i * 0x5b + 0xc1);
+        ret = mp_read_unsigned_bin(&b, buf, 700);
+    }
+    if (ret != 0) {
+        ret = -9632;
+        goto done;
+    }
+
+    ret = mp_mul(&a, &b, &r);
+    if (ret == 0) {
+        outSz = (word32)mp_unsigned_bin_size(&r);
+        if (outSz != 1460)
+            ret = -9633;
+    }
+    if (ret == 0)
+        ret = mp_to_unsigned_bin(&r, buf);
+    if (ret == 0)
+        ret = wc_Sha256Hash(buf, outSz, hash);
+    if (ret != 0 || XMEMCMP(hash, mulHash, sizeof(hash)) != 0) {
+        ret = -9634;
+        goto done;
+    }
+
+    ret = mp_mul(&a, &a, &r);
+    if (ret == 0) {
+        outSz = (word32)mp_unsigned_bin_size(&r);
+        if (outSz != 1520)
+            ret = -9635;
+    }
+    if (ret == 0)
+        ret = mp_to_unsigned_bin(&r, buf);
+    if (ret == 0)
+        ret = wc_Sha256Hash(buf, outSz, hash);
+    if (ret != 0 || XMEMCMP(hash, sqrHash, sizeof(hash)) != 0) {
+        ret = -9636;
+        goto done;
+    }
+
+    /* (2^6080 - 1)^2 = 2^12160 - 2^6081 + 1 carries through every digit */
+    XMEMSET(buf, 0xff, 760);
+    ret = mp_read_unsigned_bin(&a, buf, 760);
+    if (ret == 0)
+        ret = mp_mul(&a, &a, &r);
+    if (ret == 0 && mp_unsigned_bin_size(&r) != 1520)
+        ret = -9637;
+    if (ret == 0)
+        ret = mp_to_unsigned_bin(&r, buf);
+    if (ret != 0) {
+        ret = -9638;
+        goto done;
+    }
+    for (i = 0; i < 759; i++) {
+        if (buf[i] != 0xff || buf[760 + i] != 0x00)
+            break;
+    }
+    if (i != 759 || buf[759] != 0xfe || buf[1519] != 0x01) {
+        ret = -9639;
+        goto done;
+    }
+
+done:
+    mp_clear(&r);
+    mp_clear(&b);
+    mp_clear(&a);
+#ifdef WOLFSSL_SMALL_STACK
+    XFREE(buf, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+    return ret;
+}
+#endif
+
 
 #if defined(WOLFSSL_PUBLIC_MP)
 
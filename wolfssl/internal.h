@@ -1657,6 +1657,10 @@ WOLFSSL_LOCAL int  HashOutputRaw(WOLFSSL* ssl, const byte* output, int sz);
 WOLFSSL_LOCAL int  HashOutput(WOLFSSL* ssl, const byte* output, int sz,
                               int ivSz);
 WOLFSSL_LOCAL int  HashInput(WOLFSSL* ssl, const byte* input, int sz);
+WOLFSSL_LOCAL int  HashRaw(WOLFSSL* ssl, const byte* data, int sz);
+WOLFSSL_LOCAL int  SelectHandshakeHashes(WOLFSSL* ssl);
+WOLFSSL_LOCAL int  FlushHandshakeHashes(WOLFSSL* ssl);
+WOLFSSL_LOCAL int  GetHandshakeHash(WOLFSSL* ssl, int macAlgo, byte* hash);
 #if defined(OPENSSL_ALL) || defined(HAVE_STUNNEL) || defined(WOLFSSL_NGINX) || defined(WOLFSSL_HAPROXY)
 WOLFSSL_LOCAL int SNI_Callback(WOLFSSL* ssl);
 #endif
@@ -1671,6 +1675,9 @@ WOLFSSL_LOCAL int  DoTls13HandShakeMsg(WOLFSSL* ssl, byte* input,
 WOLFSSL_LOCAL int DoTls13ServerHello(WOLFSSL* ssl, const byte* input,
                                      word32* inOutIdx, word32 helloSz,
                                      byte* extMsgType);
+#ifdef WOLFSSL_HMAC_MIDSTATE
+WOLFSSL_LOCAL void FreeTls13HkdfKeys(WOLFSSL* ssl);
+#endif
 #endif
 int TimingPadVerify(WOLFSSL* ssl, const byte* input, int padLen, int t,
                     int pLen, int content);
@@ -1819,6 +1826,61 @@ struct WOLFSSL_CIPHER {
     typedef struct WOLFSSL_OCSP WOLFSSL_OCSP;
 #endif
 
+#ifdef WOLFSSL_OCSP_STAPLE_MGR
+#if !defined(WOLFSSL_PTHREADS) || defined(NO_ASN_TIME)
+    #error OCSP staple manager requires pthreads and ASN time
+#endif
+
+/* seconds to wait before retrying a failed staple fetch */
+#ifndef WOLFSSL_OCSP_STAPLE_RETRY
+    #define WOLFSSL_OCSP_STAPLE_RETRY    60
+#endif
+/* refresh interval for responses without a nextUpdate */
+#ifndef WOLFSSL_OCSP_STAPLE_REFRESH
+    #define WOLFSSL_OCSP_STAPLE_REFRESH  3600
+#endif
+
+typedef struct OcspStapleMgr OcspStapleMgr;
+
+/* Encoded OCSP response shared by all connections stapling it */
+typedef struct OcspStaple {
+    byte*          response;      /* DER OCSP response */
+    word32         responseSz;
+    time_t         nextUpdate;    /* 0 if the response has none */
+    int            refCount;      /* entry's reference plus handshakes */
+    OcspStapleMgr* mgr;           /* owner, its lock guards refCount */
+} OcspStaple;
+
+/* Server certificate the manager keeps a fresh staple for */
+typedef struct OcspStapleEntry OcspStapleEntry;
+struct OcspStapleEntry {
+    OcspStapleEntry* next;
+    OcspRequest      request;     /* request for this certificate */
+    OcspStaple*      staple;      /* current response, NULL until fetched */
+    time_t           refreshAt;   /* when to fetch again */
+    byte             refreshing;  /* refresh thread is fetching for it */
+    byte             removed;     /* unlisted, refresh thread frees it */
+};
+
+struct OcspStapleMgr {
+    WOLFSSL_CERT_MANAGER* cm;
+    OcspStapleEntry*      entries;
+    wolfSSL_Mutex         lock;   /* entry list, staple pointers, refCounts */
+    pthread_cond_t        cond;   /* wakes the refresh thread */
+    pthread_t             tid;    /* refresh thread, 0 if not running */
+    int                   stop;   /* asks the refresh thread to exit */
+};
+
+WOLFSSL_LOCAL void FreeOcspStapleMgr(OcspStapleMgr* mgr, void* heap);
+WOLFSSL_LOCAL int  OcspStapleMgrAdd(WOLFSSL_OCSP* ocsp, DecodedCert* cert,
+                                    OcspStapleEntry** entry);
+WOLFSSL_LOCAL void OcspStapleMgrRemove(WOLFSSL_CERT_MANAGER* cm,
+                                       OcspStapleEntry** entry);
+WOLFSSL_LOCAL OcspStaple* OcspStapleGet(OcspStapleEntry* entry,
+                                        OcspStapleMgr* mgr);
+WOLFSSL_LOCAL void OcspStapleRelease(OcspStaple* staple);
+#endif /* WOLFSSL_OCSP_STAPLE_MGR */
+
 /* wolfSSL OCSP controller */
 #ifdef HAVE_OCSP
 struct WOLFSSL_OCSP {
@@ -1830,6 +1892,9 @@ struct WOLFSSL_OCSP {
     defined(WOLFSSL_NGINX) || defined(WOLFSSL_HAPROXY)
     int(*statusCb)(WOLFSSL*, void*);
 #endif
+#ifdef WOLFSSL_OCSP_STAPLE_MGR
+    OcspStapleMgr*        stapleMgr;     /* background staple refresh */
+#endif
 };
 #endif
 
@@ -1849,6 +1914,12 @@ typedef struct CRL_Entry CRL_Entry;
     typedef struct RevokedCert RevokedCert;
 #endif
 
+/* Revoked serial number, kept sorted in the CRL entry for binary search */
+typedef struct CRL_RevokedSerial {
+    byte    serialSz;                        /* serial length in bytes */
+    byte    serial[EXTERNAL_SERIAL_SIZE];    /* raw serial number      */
+} CRL_RevokedSerial;
+
 /* Complete CRL */
 struct CRL_Entry {
     CRL_Entry* next;                      /* next entry */
@@ -1859,8 +1930,10 @@ struct CRL_Entry {
     byte    nextDate[MAX_DATE_SIZE]; /* next update date   */
     byte    lastDateFormat;          /* last date format */
     byte    nextDateFormat;          /* next date format */
-    RevokedCert* certs;              /* revoked cert list  */
-    int          totalCerts;         /* number on list     */
+    CRL_RevokedSerial* revoked;      /* sorted revoked serials */
+    int          totalCerts;         /* number in revoked  */
+    char*   srcFile;                 /* file loaded from, NULL for buffers */
+    int     refCount;                /* list reference plus active checks */
     int     verified;
     byte*   toBeSigned;
     word32  tbsSz;
@@ -1921,6 +1994,46 @@ struct WOLFSSL_CRL {
     #define TP_TABLE_SIZE 11
 #endif
 
+#ifdef WOLFSSL_CERT_VERIFY_CACHE
+#ifndef CERT_VERIFY_CACHE_PER_ROW
+    #define CERT_VERIFY_CACHE_PER_ROW 4
+#endif
+#ifndef CERT_VERIFY_CACHE_DEF_SZ
+    #define CERT_VERIFY_CACHE_DEF_SZ 1024
+#endif
+
+/* Peer chain that passed signature verification */
+typedef struct CertVerifyCacheEntry {
+    byte   chainHash[WC_SHA256_DIGEST_SIZE]; /* hash of DER chain as received */
+    byte   notAfter[MAX_DATE_SIZE];          /* leaf not after date */
+    byte   notAfterFormat;                   /* leaf not after date format */
+    byte   inUse;                            /* entry holds a result */
+    word32 epoch;                            /* cache epoch when verified */
+} CertVerifyCacheEntry;
+
+typedef struct CertVerifyCacheRow {
+    int                  nextIdx;            /* next entry to replace */
+    CertVerifyCacheEntry entries[CERT_VERIFY_CACHE_PER_ROW];
+} CertVerifyCacheRow;
+
+/* Verified peer chain cache, entries are dropped when the trust store, CRL
+ * or OCSP state changes by bumping the epoch */
+typedef struct CertVerifyCache {
+    CertVerifyCacheRow* rows;
+    word32              rowCount;
+    word32              epoch;               /* current verification epoch */
+    word32              hits;
+    word32              misses;
+    wolfSSL_Mutex       lock;                /* rows and counters lock */
+} CertVerifyCache;
+
+WOLFSSL_LOCAL int  CM_VerifyCacheLookup(WOLFSSL_CERT_MANAGER* cm,
+                                        const byte* chainHash, word32* epoch);
+WOLFSSL_LOCAL int  CM_VerifyCacheAdd(WOLFSSL_CERT_MANAGER* cm,
+                                     const byte* chainHash, word32 epoch,
+                                     const DecodedCert* leaf);
+#endif /* WOLFSSL_CERT_VERIFY_CACHE */
+
 /* wolfSSL Certificate Manager */
 struct WOLFSSL_CERT_MANAGER {
     Signer*         caTable[CA_TABLE_SIZE]; /* the CA signer table */
@@ -1956,8 +2069,16 @@ struct WOLFSSL_CERT_MANAGER {
 #if defined(HAVE_ECC) || defined(HAVE_ED25519)
     short           minEccKeySz;         /* minimum allowed ECC key size */
 #endif
+#ifdef WOLFSSL_CERT_VERIFY_CACHE
+    CertVerifyCache* verifyCache;        /* verified peer chain cache */
+#endif
 };
 
+#ifdef WOLFSSL_CERT_VERIFY_CACHE
+WOLFSSL_LOCAL void CM_VerifyCacheInvalidate(WOLFSSL_CERT_MANAGER* cm);
+#else
+    #define CM_VerifyCacheInvalidate(cm) (void)(cm)
+#endif
 WOLFSSL_LOCAL int CM_SaveCertCache(WOLFSSL_CERT_MANAGER*, const char*);
 WOLFSSL_LOCAL int CM_RestoreCertCache(WOLFSSL_CERT_MANAGER*, const char*);
 WOLFSSL_LOCAL int CM_MemSaveCertCache(WOLFSSL_CERT_MANAGER*, void*, int, int*);
@@ -2076,6 +2197,9 @@ typedef enum {
     TLSX_ENCRYPT_THEN_MAC           = 0x0016, /* RFC 7366 */
 #endif
     TLSX_QUANTUM_SAFE_HYBRID        = 0x0018, /* a.k.a. QSH  */
+#ifdef HAVE_CERT_COMPRESSION
+    TLSX_COMPRESS_CERTIFICATE       = 0x001b, /* RFC 8879 */
+#endif
     TLSX_SESSION_TICKET             = 0x0023,
 #ifdef WOLFSSL_TLS13
     #if defined(HAVE_SESSION_TICKET) || !defined(NO_PSK)
@@ -2241,6 +2365,9 @@ typedef struct {
     } request;
 #if defined(WOLFSSL_TLS13) && !defined(NO_WOLFSSL_SERVER)
     buffer response;
+    #ifdef WOLFSSL_OCSP_STAPLE_MGR
+    OcspStaple* staple;  /* reference when response is a managed staple */
+    #endif
 #endif
 } CertificateStatusRequest;
 
@@ -2519,6 +2646,203 @@ enum SetCBIO {
 };
 #endif
 
+#ifdef HAVE_CERT_COMPRESSION
+#ifndef MAX_CERT_COMPRESS_ALGS
+    #define MAX_CERT_COMPRESS_ALGS 3
+#endif
+
+/* Certificate compression algorithm registered with a context. */
+typedef struct CertCompressAlg {
+    word16                 alg;
+    CallbackCertCompress   compress;
+    CallbackCertDecompress decompress;
+    DerBuffer*             msg;       /* CompressedCertificate body of chain */
+} CertCompressAlg;
+#endif
+
+#ifdef WOLFSSL_EARLY_DATA_ANTI_REPLAY
+#ifndef ANTI_REPLAY_SHARDS
+    #define ANTI_REPLAY_SHARDS 16
+#endif
+#ifndef ANTI_REPLAY_DEF_ENTRIES
+    #define ANTI_REPLAY_DEF_ENTRIES 4096
+#endif
+#define ANTI_REPLAY_FP_SZ      16  /* bytes of binder kept per ClientHello */
+#define ANTI_REPLAY_BLOOM_K    4   /* bit positions set per ClientHello */
+#define ANTI_REPLAY_BLOOM_BITS 16  /* filter bits per ClientHello */
+
+/* ClientHellos seen in one time window */
+typedef struct AntiReplayGen {
+    word32 start;                  /* window start in milliseconds */
+    word32 count;                  /* ClientHellos recorded */
+    byte*  data;                   /* fingerprint slots or filter bits */
+} AntiReplayGen;
+
+typedef struct AntiReplayShard {
+    AntiReplayGen gen[2];          /* current and previous window */
+    byte          cur;             /* index of current window */
+    word32        checks;          /* early data offers checked */
+    word32        replays;         /* binders seen before */
+    word32        rejects;         /* not fresh or window full */
+    wolfSSL_Mutex lock;            /* windows and counters lock */
+} AntiReplayShard;
+
+/* Binders of ClientHellos that offered early data, kept for two windows */
+typedef struct AntiReplayCache {
+    AntiReplayShard shards[ANTI_REPLAY_SHARDS];
+    word32          windowMs;      /* allowed ticket age error */
+    word32          perShard;      /* max ClientHellos per window per shard */
+    word32          dataSz;        /* size of a window's data */
+    byte            bloom;         /* data is a Bloom filter */
+} AntiReplayCache;
+
+WOLFSSL_LOCAL void FreeAntiReplayCache(AntiReplayCache* cache, void* heap);
+#endif /* WOLFSSL_EARLY_DATA_ANTI_REPLAY */
+
+#ifdef WOLFSSL_KEY_SHARE_CACHE
+#ifndef KEY_SHARE_CACHE_DEF_ENTRIES
+    #define KEY_SHARE_CACHE_DEF_ENTRIES 64
+#endif
+#ifndef KEY_SHARE_CACHE_TIMEOUT
+    #define KEY_SHARE_CACHE_TIMEOUT 86400  /* seconds an entry is trusted */
+#endif
+#define KEY_SHARE_CACHE_ID_SZ 8            /* bytes of server name hash */
+
+/* Group selected by a server */
+typedef struct KeyShareCacheEntry {
+    byte   id[KEY_SHARE_CACHE_ID_SZ];      /* hash of server name */
+    word32 timeStamp;                      /* LowResTimer() when recorded */
+    word16 group;                          /* 0 when empty */
+} KeyShareCacheEntry;
+
+/* Key exchange groups selected by servers, indexed by server name */
+typedef struct KeyShareCache {
+    KeyShareCacheEntry* entries;
+    word32              cnt;               /* number of entries */
+    word32              lookups;           /* ClientHellos with a server name */
+    word32              hits;              /* group predicted from cache */
+    word32              hrrs;              /* HelloRetryRequests received */
+    wolfSSL_Mutex       lock;
+} KeyShareCache;
+
+WOLFSSL_LOCAL void FreeKeyShareCache(KeyShareCache* cache, void* heap);
+WOLFSSL_LOCAL void TLSX_KeyShareCache_Remove(WOLFSSL* ssl);
+#endif /* WOLFSSL_KEY_SHARE_CACHE */
+
+#ifdef WOLFSSL_KEY_SHARE_POOL
+#ifndef KEY_SHARE_POOL_MAX_GROUPS
+    #define KEY_SHARE_POOL_MAX_GROUPS 4
+#endif
+#ifndef KEY_SHARE_POOL_DEF_SIZE
+    #define KEY_SHARE_POOL_DEF_SIZE 16
+#endif
+
+/* Pre-generated key pairs of a group */
+typedef struct KeySharePoolGroup {
+    KeyShareEntry* list;                   /* single use key pairs */
+    word32         cnt;                    /* number of key pairs in list */
+    word32         size;                   /* max number of key pairs */
+    word32         hits;                   /* key pairs taken from list */
+    word32         misses;                 /* generated as list was empty */
+    word16         group;                  /* NamedGroup */
+} KeySharePoolGroup;
+
+/* Key pairs generated ahead of handshakes, off the critical path */
+typedef struct KeySharePool {
+    KeySharePoolGroup groups[KEY_SHARE_POOL_MAX_GROUPS];
+    int               numGroups;
+    wolfSSL_Mutex     lock;
+} KeySharePool;
+
+WOLFSSL_LOCAL int  TLSX_KeySharePool_Add(KeySharePool* pool, word16 group,
+                                         word32 size);
+WOLFSSL_LOCAL int  TLSX_KeySharePool_Fill(KeySharePool* pool, void* heap,
+                                          int devId, int max);
+WOLFSSL_LOCAL void FreeKeySharePool(KeySharePool* pool, void* heap);
+#endif /* WOLFSSL_KEY_SHARE_POOL */
+
+#ifdef WOLFSSL_CH_PREPARSE
+#define CH_EXT_INDEX_SZ   64               /* extension types indexed */
+#define CH_EXT_RENEG_IDX  CH_EXT_INDEX_SZ  /* index of renegotiation_info */
+#define SUITE_MAP_SZ      32               /* bytes in bitmap of suites */
+/* Bit in a suite map for a cipher suite - different suites may share a bit */
+#define SUITE_MAP_BIT(s0, s1)     ((byte)((s1) ^ ((s0) * 7)))
+#define SUITE_MAP_HAS(map, s0, s1) \
+    (((map)[SUITE_MAP_BIT(s0, s1) >> 3] >> (SUITE_MAP_BIT(s0, s1) & 7)) & 1)
+
+/* Location of an extension in a ClientHello */
+typedef struct ClientHelloExt {
+    word32 offset;                         /* index of type */
+    word16 length;                         /* length of extension data */
+} ClientHelloExt;
+
+/* Fields of a ClientHello found in one pass over the message.
+ * Offsets are from the start of the ClientHello body. */
+typedef struct ClientHelloIndex {
+    ProtocolVersion pv;                    /* legacy_version */
+    byte            sessionIdSz;
+    byte            compSz;
+    word16          suitesSz;
+    word16          extsSz;
+    word32          sessionId;
+    word32          suites;
+    word32          comp;
+    word32          exts;                  /* 0 when no extensions */
+    word16          extCnt;                /* number of extensions */
+    byte            extSeen[(CH_EXT_INDEX_SZ + 8) / 8]; /* ext set bits */
+    ClientHelloExt  ext[CH_EXT_INDEX_SZ + 1];
+} ClientHelloIndex;
+
+WOLFSSL_LOCAL int TLSX_ClientHello_Index(const byte* input, word32 helloSz,
+                                         ClientHelloIndex* ch);
+WOLFSSL_LOCAL const ClientHelloExt* TLSX_ClientHello_FindExt(
+                                   const ClientHelloIndex* ch, word16 type);
+WOLFSSL_LOCAL void BuildSuiteMap(byte* map, const byte* suites, word16 sz);
+WOLFSSL_LOCAL int  HaveCommonSuite(const Suites* suites, const byte* peer,
+                                   word16 peerSz, const byte* peerMap);
+#endif /* WOLFSSL_CH_PREPARSE */
+
+#ifdef WOLFSSL_SNI_CERT_STORE
+#ifndef SNI_CERT_STORE_MIN_BUCKETS
+    #define SNI_CERT_STORE_MIN_BUCKETS 64      /* power of 2 */
+#endif
+#define SNI_CERT_STORE_MAX_NAME_SZ     255     /* max length of DNS name */
+
+/* Certificate and private key for a server name */
+typedef struct SNICertEntry {
+    struct SNICertEntry* next;             /* next entry in bucket */
+    char*       name;                      /* lower case, "*." for wildcard */
+    word32      hash;                      /* hash of name */
+    word16      nameSz;
+    word32      id;                        /* unique in store - set on insert */
+    byte        loaded;                    /* cert and key decoded */
+    int         format;                    /* format of data as added */
+    byte*       certSrc;                   /* certificate as added */
+    word32      certSrcSz;
+    byte*       keySrc;                    /* private key as added */
+    word32      keySrcSz;
+#ifndef NO_FILESYSTEM
+    char*       certFile;                  /* read on first use */
+    char*       keyFile;
+#endif
+    DerBuffer*  cert;                      /* DER certificate when loaded */
+    DerBuffer*  key;                       /* DER private key when loaded */
+} SNICertEntry;
+
+/* Hash table of certificates by server name */
+typedef struct SNICertStore {
+    SNICertEntry** buckets;
+    word32         bucketCnt;              /* power of 2 */
+    word32         count;                  /* number of entries */
+    word32         nextId;                 /* id of next entry inserted */
+    wolfSSL_Mutex  lock;
+} SNICertStore;
+
+WOLFSSL_LOCAL int  SNICertStore_Use(WOLFSSL* ssl, const byte* name,
+                                    word16 nameSz);
+WOLFSSL_LOCAL void FreeSNICertStore(SNICertStore* store, void* heap);
+#endif /* WOLFSSL_SNI_CERT_STORE */
+
 /* wolfSSL context type */
 struct WOLFSSL_CTX {
     WOLFSSL_METHOD* method;
@@ -2546,6 +2870,16 @@ struct WOLFSSL_CTX {
     #endif
 #ifdef WOLFSSL_TLS13
     int         certChainCnt;
+#endif
+#ifdef WOLFSSL_CERT_MSG_CACHE
+    DerBuffer*  certMsg;    /* encoded TLS Certificate message body */
+    #ifdef WOLFSSL_TLS13
+    DerBuffer*  certMsg13;  /* encoded TLS v1.3 Certificate message body */
+    #endif
+#endif
+#ifdef HAVE_CERT_COMPRESSION
+    CertCompressAlg certCompress[MAX_CERT_COMPRESS_ALGS];
+    byte        certCompressCnt;
 #endif
     DerBuffer*  privateKey;
     byte        privateKeyType:7;
@@ -2677,6 +3011,18 @@ struct WOLFSSL_CTX {
 #ifdef WOLFSSL_EARLY_DATA
     word32          maxEarlyDataSz;
 #endif
+#ifdef WOLFSSL_EARLY_DATA_ANTI_REPLAY
+    AntiReplayCache* antiReplay;        /* seen early data ClientHellos */
+#endif
+#ifdef WOLFSSL_KEY_SHARE_CACHE
+    KeyShareCache*   keyShareCache;     /* server's groups by server name */
+#endif
+#ifdef WOLFSSL_KEY_SHARE_POOL
+    KeySharePool*    keySharePool;      /* pre-generated key share pairs */
+#endif
+#ifdef WOLFSSL_SNI_CERT_STORE
+    SNICertStore*    sniCertStore;      /* certificates by server name */
+#endif
 #ifdef HAVE_ANON
     byte        haveAnon;               /* User wants to allow Anon suites */
 #endif /* HAVE_ANON */
@@ -2719,6 +3065,9 @@ struct WOLFSSL_CTX {
         #if defined(HAVE_CERTIFICATE_STATUS_REQUEST) \
          || defined(HAVE_CERTIFICATE_STATUS_REQUEST_V2)
             OcspRequest* certOcspRequest;
+            #ifdef WOLFSSL_OCSP_STAPLE_MGR
+            OcspStapleEntry* certStaple; /* managed staple for certificate */
+            #endif
         #endif
         #if defined(HAVE_CERTIFICATE_STATUS_REQUEST_V2)
             OcspRequest* chainOcspRequest[MAX_CHAIN_DEPTH];
@@ -3333,6 +3682,13 @@ typedef struct Options {
 #if defined(WOLFSSL_TLS13) && defined(WOLFSSL_TLS13_MIDDLEBOX_COMPAT)
     word16            sentChangeCipher:1; /* Change Cipher Spec sent */
 #endif
+#ifdef WOLFSSL_HALF_RTT_DATA
+    word16            halfRttData:1;      /* Server writing 0.5-RTT data */
+    word16            halfRttPending:1;   /* 0.5-RTT data still buffered */
+#endif
+#ifdef WOLFSSL_KEY_SHARE_CACHE
+    word16            keySharePredicted:1;/* Key share group from cache */
+#endif
 #if !defined(WOLFSSL_NO_CLIENT_AUTH) && defined(HAVE_ED25519) && \
                                                 !defined(NO_ED25519_CLIENT_AUTH)
     word16            cacheMessages:1;    /* Cache messages for sign/verify */
@@ -3673,6 +4029,16 @@ typedef struct MsgsReceived {
 } MsgsReceived;
 
 
+/* Handshake hashes being kept up to date, HS_Hashes hashMask */
+enum HsHashMask {
+    HS_HASH_MD5    = 0x01,
+    HS_HASH_SHA    = 0x02,
+    HS_HASH_SHA256 = 0x04,
+    HS_HASH_SHA384 = 0x08,
+    HS_HASH_SHA512 = 0x10,
+    HS_HASH_ALL    = 0x1F
+};
+
 /* Handshake hashes */
 typedef struct HS_Hashes {
     Hashes          verifyHashes;
@@ -3696,6 +4062,12 @@ typedef struct HS_Hashes {
     byte*           messages;           /* handshake messages */
     int             length;             /* length of handshake messages' data */
     int             prevLen;            /* length of messages but last */
+#endif
+    word32          hashMask;           /* HS_HASH_* hashes being updated */
+#ifdef WOLFSSL_LAZY_HS_HASH
+    byte*           transcript;         /* messages until hashes are picked */
+    word32          transcriptSz;       /* allocated size of transcript */
+    word32          transcriptLen;      /* length of messages in transcript */
 #endif
 } HS_Hashes;
 
@@ -3746,6 +4118,21 @@ typedef enum EarlyDataState {
 } EarlyDataState;
 #endif
 
+#if defined(WOLFSSL_TLS13) && defined(WOLFSSL_HMAC_MIDSTATE)
+#ifndef TLS13_HKDF_KEYS_SZ
+    /* key and IV of both sides are derived in turn */
+    #define TLS13_HKDF_KEYS_SZ 2
+#endif
+
+/* Keyed HMAC states of the secrets most recently used in the key schedule */
+typedef struct Tls13HkdfKeys {
+    HmacKeyState state[TLS13_HKDF_KEYS_SZ];
+    byte         secret[TLS13_HKDF_KEYS_SZ][WC_MAX_DIGEST_SIZE];
+    word32       secretSz[TLS13_HKDF_KEYS_SZ];  /* 0 when entry unused */
+    byte         next;                          /* entry to replace next */
+} Tls13HkdfKeys;
+#endif
+
 /* wolfSSL ssl type */
 struct WOLFSSL {
     WOLFSSL_CTX*    ctx;
@@ -3754,6 +4141,9 @@ struct WOLFSSL {
 #ifdef WOLFSSL_TLS13
     byte            clientSecret[SECRET_LEN];
     byte            serverSecret[SECRET_LEN];
+#ifdef WOLFSSL_HMAC_MIDSTATE
+    Tls13HkdfKeys*  hkdfKeys;           /* only need during handshake */
+#endif
 #endif
     HS_Hashes*      hsHashes;
     void*           IOCB_ReadCtx;
@@ -3995,6 +4385,10 @@ struct WOLFSSL {
         byte                  expect_session_ticket;
     #endif
 #endif /* HAVE_TLS_EXTENSIONS */
+#ifdef HAVE_CERT_COMPRESSION
+    word16          certCompressAlg;    /* algorithm to compress chain with */
+    buffer          certDecomp;         /* decompressed peer Certificate */
+#endif
 #ifdef HAVE_OCSP
         void*       ocspIOCtx;
     #ifdef OPENSSL_EXTRA
@@ -4161,6 +4555,7 @@ enum HandShakeType {
     finished             =  20,
     certificate_status   =  22,
     key_update           =  24,
+    compressed_certificate = 25,
     change_cipher_hs     =  55,    /* simulate unique handshake type for sanity
                                       checks.  record layer change_cipher
                                       conflicts with handshake finished */
@@ -4195,10 +4590,19 @@ WOLFSSL_LOCAL int SendTls13ServerHello(WOLFSSL*, byte);
 #endif
 #endif
 WOLFSSL_LOCAL int SendCertificate(WOLFSSL*);
+#ifdef WOLFSSL_CERT_MSG_CACHE
+WOLFSSL_LOCAL void CacheCertMsg(WOLFSSL_CTX* ctx);
+WOLFSSL_LOCAL void FreeCertMsgCache(WOLFSSL_CTX* ctx);
+WOLFSSL_LOCAL DerBuffer* GetCertMsgCache(WOLFSSL* ssl);
+#endif
 WOLFSSL_LOCAL int SendCertificateRequest(WOLFSSL*);
 #if defined(HAVE_CERTIFICATE_STATUS_REQUEST) \
  || defined(HAVE_CERTIFICATE_STATUS_REQUEST_V2)
 WOLFSSL_LOCAL int CreateOcspResponse(WOLFSSL*, OcspRequest**, buffer*);
+#ifdef WOLFSSL_OCSP_STAPLE_MGR
+WOLFSSL_LOCAL int GetOcspStaple(WOLFSSL* ssl, buffer* response,
+                                OcspStaple** staple);
+#endif
 #endif
 #if defined(HAVE_SECURE_RENEGOTIATION) && \
     defined(HAVE_SERVER_RENEGOTIATION_INFO)
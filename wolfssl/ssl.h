@@ -842,9 +842,31 @@ WOLFSSL_API int  wolfSSL_preferred_group(WOLFSSL* ssl);
 WOLFSSL_API int  wolfSSL_CTX_set_groups(WOLFSSL_CTX* ctx, int* groups,
                                         int count);
 WOLFSSL_API int  wolfSSL_set_groups(WOLFSSL* ssl, int* groups, int count);
+#ifdef WOLFSSL_KEY_SHARE_CACHE
+WOLFSSL_API int  wolfSSL_CTX_EnableKeyShareCache(WOLFSSL_CTX* ctx,
+                                                 unsigned int entries);
+WOLFSSL_API int  wolfSSL_CTX_DisableKeyShareCache(WOLFSSL_CTX* ctx);
+WOLFSSL_API int  wolfSSL_CTX_GetKeyShareCacheStats(WOLFSSL_CTX* ctx,
+                                                   unsigned int* lookups,
+                                                   unsigned int* hits,
+                                                   unsigned int* hrrs);
+#endif
+#ifdef WOLFSSL_KEY_SHARE_POOL
+WOLFSSL_API int  wolfSSL_CTX_UseKeySharePool(WOLFSSL_CTX* ctx, word16 group,
+                                             unsigned int size);
+WOLFSSL_API int  wolfSSL_CTX_FillKeySharePool(WOLFSSL_CTX* ctx, int max);
+WOLFSSL_API int  wolfSSL_CTX_GetKeySharePoolStats(WOLFSSL_CTX* ctx,
+                                                  word16 group,
+                                                  unsigned int* avail,
+                                                  unsigned int* hits,
+                                                  unsigned int* misses);
+#endif
 
 WOLFSSL_API int  wolfSSL_connect_TLSv13(WOLFSSL*);
 WOLFSSL_API int  wolfSSL_accept_TLSv13(WOLFSSL*);
+#ifdef WOLFSSL_HALF_RTT_DATA
+WOLFSSL_API int  wolfSSL_write_half_rtt_data(WOLFSSL*, const void*, int, int*);
+#endif
 
 #ifdef WOLFSSL_EARLY_DATA
 WOLFSSL_API int  wolfSSL_CTX_set_max_early_data(WOLFSSL_CTX* ctx,
@@ -852,6 +874,23 @@ WOLFSSL_API int  wolfSSL_CTX_set_max_early_data(WOLFSSL_CTX* ctx,
 WOLFSSL_API int  wolfSSL_set_max_early_data(WOLFSSL* ssl, unsigned int sz);
 WOLFSSL_API int  wolfSSL_write_early_data(WOLFSSL*, const void*, int, int*);
 WOLFSSL_API int  wolfSSL_read_early_data(WOLFSSL*, void*, int, int*);
+#ifdef WOLFSSL_EARLY_DATA_ANTI_REPLAY
+enum {
+    WOLFSSL_ANTI_REPLAY_EXACT = 0,
+    WOLFSSL_ANTI_REPLAY_BLOOM = 1
+};
+
+WOLFSSL_API int  wolfSSL_CTX_EnableAntiReplay(WOLFSSL_CTX* ctx,
+                                              unsigned int windowMs,
+                                              unsigned int maxEntries,
+                                              int mode);
+WOLFSSL_API int  wolfSSL_CTX_DisableAntiReplay(WOLFSSL_CTX* ctx);
+WOLFSSL_API int  wolfSSL_CTX_GetAntiReplayStats(WOLFSSL_CTX* ctx,
+                                     unsigned int* checks,
+                                     unsigned int* replays,
+                                     unsigned int* rejects,
+                                     unsigned int* memSz);
+#endif
 #endif
 #endif
 WOLFSSL_ABI WOLFSSL_API void wolfSSL_CTX_free(WOLFSSL_CTX*);
@@ -2596,6 +2635,15 @@ WOLFSSL_API void* wolfSSL_GetRsaDecCtx(WOLFSSL* ssl);
                                                       WOLFSSL_CERT_MANAGER* cm);
     WOLFSSL_API int wolfSSL_CertManagerDisableOCSPStapling(
                                                       WOLFSSL_CERT_MANAGER* cm);
+#ifdef WOLFSSL_CERT_VERIFY_CACHE
+    WOLFSSL_API int wolfSSL_CertManagerEnableVerifyCache(
+                                              WOLFSSL_CERT_MANAGER*, int sz);
+    WOLFSSL_API int wolfSSL_CertManagerDisableVerifyCache(
+                                                      WOLFSSL_CERT_MANAGER*);
+    WOLFSSL_API int wolfSSL_CertManagerFlushVerifyCache(WOLFSSL_CERT_MANAGER*);
+    WOLFSSL_API int wolfSSL_CertManagerGetVerifyCacheStats(
+                          WOLFSSL_CERT_MANAGER*, word32* hits, word32* misses);
+#endif
 #if defined(OPENSSL_EXTRA) && defined(WOLFSSL_SIGNER_DER_CERT) && !defined(NO_FILESYSTEM)
 WOLFSSL_API WOLFSSL_STACK* wolfSSL_CertManagerGetCerts(WOLFSSL_CERT_MANAGER* cm);
 #endif
@@ -2632,6 +2680,12 @@ WOLFSSL_API WOLFSSL_STACK* wolfSSL_CertManagerGetCerts(WOLFSSL_CERT_MANAGER* cm)
                                                CbOCSPIO, CbOCSPRespFree, void*);
     WOLFSSL_API int wolfSSL_CTX_EnableOCSPStapling(WOLFSSL_CTX*);
     WOLFSSL_API int wolfSSL_CTX_DisableOCSPStapling(WOLFSSL_CTX*);
+#ifdef WOLFSSL_OCSP_STAPLE_MGR
+    WOLFSSL_API int wolfSSL_CTX_EnableOCSPStapleRefresh(WOLFSSL_CTX*);
+#endif
+#ifdef WOLFSSL_CERT_VERIFY_CACHE
+    WOLFSSL_API int wolfSSL_CTX_EnableVerifyCache(WOLFSSL_CTX*, int sz);
+#endif
 #endif /* !NO_CERTS */
 
 
@@ -2699,6 +2753,20 @@ WOLFSSL_API int wolfSSL_SNI_GetFromBuffer(
                  const unsigned char* clientHello, unsigned int helloSz,
                  unsigned char type, unsigned char* sni, unsigned int* inOutSz);
 
+#ifdef WOLFSSL_SNI_CERT_STORE
+WOLFSSL_API int wolfSSL_CTX_SNI_AddCert(WOLFSSL_CTX* ctx, const char* name,
+                          const unsigned char* cert, long certSz,
+                          const unsigned char* key, long keySz, int format);
+#ifndef NO_FILESYSTEM
+WOLFSSL_API int wolfSSL_CTX_SNI_AddCertFiles(WOLFSSL_CTX* ctx,
+                          const char* name, const char* certFile,
+                          const char* keyFile, int format);
+#endif
+WOLFSSL_API int wolfSSL_CTX_SNI_RemoveCert(WOLFSSL_CTX* ctx, const char* name);
+WOLFSSL_API int wolfSSL_CTX_SNI_FindCert(WOLFSSL_CTX* ctx,
+                          const unsigned char* name, unsigned short nameSz);
+#endif /* WOLFSSL_SNI_CERT_STORE */
+
 #endif /* NO_WOLFSSL_SERVER */
 
 /* SNI status */
@@ -2799,6 +2867,31 @@ WOLFSSL_API int wolfSSL_CTX_UseTruncatedHMAC(WOLFSSL_CTX* ctx);
 #endif
 #endif
 
+/* Certificate Compression - RFC 8879 */
+#ifdef HAVE_CERT_COMPRESSION
+
+/* Certificate compression algorithms */
+enum {
+    WOLFSSL_CERT_COMPRESS_ZLIB   = 1,
+    WOLFSSL_CERT_COMPRESS_BROTLI = 2,
+    WOLFSSL_CERT_COMPRESS_ZSTD   = 3
+};
+
+/* Compress in into out. *outSz is the size of out on entry and the compressed
+ * size on return. Return 0 on success. */
+typedef int (*CallbackCertCompress)(const unsigned char* in, unsigned int inSz,
+                                    unsigned char* out, unsigned int* outSz);
+/* Decompress in into out which must be filled exactly. Return 0 on success. */
+typedef int (*CallbackCertDecompress)(const unsigned char* in,
+              unsigned int inSz, unsigned char* out, unsigned int outSz);
+
+WOLFSSL_API int wolfSSL_CTX_UseCertCompression(WOLFSSL_CTX* ctx,
+                                unsigned short alg,
+                                CallbackCertCompress compress,
+                                CallbackCertDecompress decompress);
+
+#endif /* HAVE_CERT_COMPRESSION */
+
 /* Certificate Status Request */
 /* Certificate Status Type */
 enum {
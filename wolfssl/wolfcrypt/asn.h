@@ -742,6 +742,21 @@ struct CertSignCtx {
     #define WOLFSSL_MAX_PATH_LEN 127
 #endif
 
+#ifdef WOLFSSL_ASN_LAZY_EXT
+/* Certificate extensions whose decoding can be deferred until first use.
+ * Values are bits so a caller can request several at once. */
+enum CertLazyExt {
+    CERT_LAZY_ALT_NAMES   = 0x01,
+    CERT_LAZY_AUTH_INFO   = 0x02,
+    CERT_LAZY_CRL_DIST    = 0x04,
+    CERT_LAZY_CERT_POLICY = 0x08,
+    CERT_LAZY_NAME_CONS   = 0x10,
+    CERT_LAZY_ALL         = 0x1F,
+
+    CERT_LAZY_EXT_COUNT   = 5
+};
+#endif /* WOLFSSL_ASN_LAZY_EXT */
+
 typedef struct DecodedCert DecodedCert;
 typedef struct DecodedName DecodedName;
 typedef struct Signer      Signer;
@@ -887,6 +902,12 @@ struct DecodedCert {
     SignatureCtx sigCtx;
 #endif
     byte*  tsip_encRsaKeyIdx;
+#ifdef WOLFSSL_ASN_LAZY_EXT
+    word32  lazyExtIdx[CERT_LAZY_EXT_COUNT]; /* value offset in extensions */
+    word32  lazyExtSz[CERT_LAZY_EXT_COUNT];  /* value length               */
+    int     lazyExtErr;              /* first deferred decode error     */
+    byte    lazyExtPending;          /* CertLazyExt bits not yet decoded */
+#endif
 
     /* Option Bits */
     byte subjectCNStored : 1;      /* have we saved a copy we own */
@@ -909,6 +930,9 @@ struct DecodedCert {
 #ifdef WOLFSSL_SEP
     byte extCertPolicySet : 1;
 #endif
+#ifdef WOLFSSL_ASN_LAZY_EXT
+    byte lazyExt : 1;              /* defer CertLazyExt decoding, set by user */
+#endif
 #if defined(OPENSSL_EXTRA) || defined(OPENSSL_EXTRA_X509_SMALL)
     byte extCRLdistCrit : 1;
     byte extAuthInfoCrit : 1;
@@ -1023,6 +1047,9 @@ WOLFSSL_LOCAL int CheckCertSignaturePubKey(const byte* cert, word32 certSz,
         void* heap, const byte* pubKey, word32 pubKeySz, int pubKeyOID);
 WOLFSSL_LOCAL int ParseCertRelative(DecodedCert*,int type,int verify,void* cm);
 WOLFSSL_LOCAL int DecodeToKey(DecodedCert*, int verify);
+#ifdef WOLFSSL_ASN_LAZY_EXT
+WOLFSSL_ASN_API int DecodeCertLazyExt(DecodedCert* cert, byte exts);
+#endif
 WOLFSSL_LOCAL int wc_GetPubX509(DecodedCert* cert, int verify, int* badDate);
 
 WOLFSSL_LOCAL const byte* OidFromId(word32 id, word32 type, word32* oidSz);
@@ -41,6 +41,8 @@
     #define CPUID_BMI2   0x0010   /* MULX, RORX */
     #define CPUID_AESNI  0x0020
     #define CPUID_ADX    0x0040   /* ADCX, ADOX */
+    #define CPUID_AVX512 0x0080   /* AVX-512F with OS support */
+    #define CPUID_IFMA   0x0100   /* AVX-512 IFMA52 */
 
     #define IS_INTEL_AVX1(f)    ((f) & CPUID_AVX1)
     #define IS_INTEL_AVX2(f)    ((f) & CPUID_AVX2)
@@ -49,6 +51,8 @@
     #define IS_INTEL_BMI2(f)    ((f) & CPUID_BMI2)
     #define IS_INTEL_AESNI(f)   ((f) & CPUID_AESNI)
     #define IS_INTEL_ADX(f)     ((f) & CPUID_ADX)
+    #define IS_INTEL_AVX512(f)  ((f) & CPUID_AVX512)
+    #define IS_INTEL_IFMA(f)    ((f) & CPUID_IFMA)
 
     void cpuid_set_flags(void);
     word32 cpuid_get_flags(void);
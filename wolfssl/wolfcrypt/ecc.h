@@ -395,6 +395,11 @@ struct ecc_key {
     mp_int *sign_k;
 #endif
 
+#ifdef WOLFSSL_ECC_PRECOMPUTE
+    void* precomp;      /* table of multiples of public key for verify and
+                           shared secret, see wc_ecc_precompute() */
+#endif
+
 #ifdef WOLFSSL_SMALL_STACK_CACHE
     mp_int* t1;
     mp_int* t2;
@@ -506,8 +511,16 @@ WOLFSSL_ABI WOLFSSL_API
 int wc_ecc_free(ecc_key* key);
 WOLFSSL_API
 int wc_ecc_set_flags(ecc_key* key, word32 flags);
+#ifdef WOLFSSL_ECC_PRECOMPUTE
+WOLFSSL_API
+int wc_ecc_precompute(ecc_key* key);
+#endif
 WOLFSSL_API
 void wc_ecc_fp_free(void);
+WOLFSSL_API
+int wc_ecc_fp_gen_init(void);
+WOLFSSL_API
+void wc_ecc_fp_gen_free(void);
 
 WOLFSSL_API
 int wc_ecc_set_curve(ecc_key* key, int keysize, int curve_id);
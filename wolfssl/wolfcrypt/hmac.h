@@ -157,6 +157,11 @@ struct Hmac {
 #if defined(WOLFSSL_ASYNC_CRYPT) || defined(WOLF_CRYPTO_CB)
     word16  keyLen;          /* hmac key length (key in ipad) */
 #endif
+#ifdef WOLFSSL_HMAC_MIDSTATE
+    Hash    innerState;           /* hash state after the ipad block */
+    Hash    outerState;           /* hash state after the opad block */
+    byte    midState;             /* innerState and outerState are set */
+#endif
 };
 
 #ifndef WC_HMAC_TYPE_DEFINED
@@ -164,6 +169,15 @@ struct Hmac {
     #define WC_HMAC_TYPE_DEFINED
 #endif
 
+#ifdef WOLFSSL_HMAC_MIDSTATE
+/* Keyed HMAC state that can be re-used without the key */
+typedef struct HmacKeyState {
+    Hash    inner;                /* hash state after the ipad block */
+    Hash    outer;                /* hash state after the opad block */
+    byte    macType;
+} HmacKeyState;
+#endif
+
 
 #endif /* HAVE_FIPS */
 
@@ -182,6 +196,12 @@ WOLFSSL_API int wolfSSL_GetHmacMaxSize(void);
 
 WOLFSSL_LOCAL int _InitHmac(Hmac* hmac, int type, void* heap);
 
+#if defined(WOLFSSL_HMAC_MIDSTATE) && !defined(HAVE_FIPS)
+WOLFSSL_API int  wc_HmacExportKeyState(Hmac* hmac, HmacKeyState* state);
+WOLFSSL_API int  wc_HmacImportKeyState(Hmac* hmac, HmacKeyState* state);
+WOLFSSL_API void wc_HmacFreeKeyState(HmacKeyState* state);
+#endif
+
 #ifdef HAVE_HKDF
 
 WOLFSSL_API int wc_HKDF_Extract(int type, const byte* salt, word32 saltSz,
@@ -190,6 +210,11 @@ WOLFSSL_API int wc_HKDF_Expand(int type, const byte* inKey, word32 inKeySz,
                                const byte* info, word32 infoSz,
                                byte* out,        word32 outSz);
 
+#ifndef HAVE_FIPS
+WOLFSSL_API int wc_HKDF_ExpandKeyed(Hmac* hmac, const byte* info,
+                                    word32 infoSz, byte* out, word32 outSz);
+#endif
+
 WOLFSSL_API int wc_HKDF(int type, const byte* inKey, word32 inKeySz,
                     const byte* salt, word32 saltSz,
                     const byte* info, word32 infoSz,
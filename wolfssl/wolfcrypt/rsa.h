@@ -88,10 +88,13 @@
     extern "C" {
 #endif
 
-enum {
-    RSA_MIN_SIZE = 512,
-    RSA_MAX_SIZE = 4096,
-};
+#ifndef RSA_MIN_SIZE
+    #define RSA_MIN_SIZE 512
+#endif
+/* Larger keys also need FP_MAX_BITS of twice the size with fast math. */
+#ifndef RSA_MAX_SIZE
+    #define RSA_MAX_SIZE 4096
+#endif
 
 /* avoid redefinition of structs */
 #if !defined(HAVE_FIPS) || \
@@ -138,8 +141,17 @@ enum {
 #ifdef HAVE_PKCS11
     RSA_MAX_ID_LEN      = 32,
 #endif
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    RSA_MAX_PRIMES      = 4,   /* most primes in a multi-prime key */
+#endif
 };
 
+#if defined(WC_RSA_PREPARED) && defined(USE_FAST_MATH) && \
+    !defined(RSA_LOW_MEM)
+    /* cache Montgomery values of the CRT primes in prepared keys */
+    #define WC_RSA_PREPARED_MONT
+#endif
+
 #ifdef WC_RSA_NONBLOCK
 typedef struct RsaNb {
     exptModNb_t exptmod; /* non-block expt_mod */
@@ -155,6 +167,12 @@ struct RsaKey {
 #if defined(WOLFSSL_KEY_GEN) || defined(OPENSSL_EXTRA) || !defined(RSA_LOW_MEM)
     mp_int dP, dQ, u;
 #endif
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    mp_int r[RSA_MAX_PRIMES - 2];             /* other primes r_i */
+    mp_int dR[RSA_MAX_PRIMES - 2];            /* d mod (r_i - 1) */
+    mp_int tR[RSA_MAX_PRIMES - 2];            /* CRT coefficients t_i */
+    int    primes;                            /* prime count, 0 is two */
+#endif
 #endif
     void* heap;                               /* for user memory overrides */
     byte* data;                               /* temp buffer for async RSA */
@@ -164,6 +182,18 @@ struct RsaKey {
 #ifdef WC_RSA_BLINDING
     WC_RNG* rng;                              /* for PrivateDecrypt blinding */
 #endif
+#ifdef WC_RSA_PREPARED
+#ifdef WC_RSA_BLINDING
+    mp_int blind;                             /* cached r^e mod n */
+    mp_int blindInv;                          /* cached 1/r mod n */
+    word32 blindUses;                         /* uses since new blinding */
+#endif
+#ifdef WC_RSA_PREPARED_MONT
+    mp_int   r2p, r2q;                        /* R^2 mod p and R^2 mod q */
+    mp_digit mpp, mpq;                        /* Montgomery setup p and q */
+#endif
+    byte  prepared;                           /* wc_RsaPrepareKey called */
+#endif
 #ifdef WOLF_CRYPTO_CB
     int   devId;
 #endif
@@ -238,6 +268,11 @@ WOLFSSL_API int  wc_RsaSSL_VerifyInline(byte* in, word32 inLen, byte** out,
                                     RsaKey* key);
 WOLFSSL_API int  wc_RsaSSL_Verify(const byte* in, word32 inLen, byte* out,
                               word32 outLen, RsaKey* key);
+#ifdef WC_RSA_BATCH
+WOLFSSL_API int  wc_RsaSSL_VerifyBatch(const byte** in, const word32* inLen,
+                                   byte** out, const word32* outLen,
+                                   RsaKey** key, int* res, int cnt);
+#endif
 WOLFSSL_API int  wc_RsaPSS_VerifyInline(byte* in, word32 inLen, byte** out,
                                         enum wc_HashType hash, int mgf,
                                         RsaKey* key);
@@ -285,6 +320,9 @@ WOLFSSL_API int  wc_RsaPublicKeyDecodeRaw(const byte* n, word32 nSz,
 #ifdef WC_RSA_BLINDING
     WOLFSSL_API int wc_RsaSetRNG(RsaKey* key, WC_RNG* rng);
 #endif
+#ifdef WC_RSA_PREPARED
+    WOLFSSL_API int wc_RsaPrepareKey(RsaKey* key);
+#endif
 #ifdef WC_RSA_NONBLOCK
     WOLFSSL_API int wc_RsaSetNonBlock(RsaKey* key, RsaNb* nb);
     #ifdef WC_RSA_NONBLOCK_TIME
@@ -339,7 +377,25 @@ WOLFSSL_API int wc_RsaExportKey(RsaKey* key,
 WOLFSSL_API int wc_RsaKeyToPublicDer(RsaKey*, byte* output, word32 inLen);
 
 #ifdef WOLFSSL_KEY_GEN
+    /* Runs job once with each of the cnt args at the same time and returns
+     * when all have completed. Returns 0 on success. */
+    typedef int (*wc_RsaKeyGenRunCb)(void* ctx, void (*job)(void* arg),
+                                     void** args, int cnt);
+
+    /* Thread pool to search for primes with in key generation */
+    typedef struct RsaKeyGenPool {
+        wc_RsaKeyGenRunCb run;     /* runs jobs on the threads of the pool */
+        void*             ctx;     /* passed to run */
+        int               threads; /* number of jobs to run at the same time */
+    } RsaKeyGenPool;
+
     WOLFSSL_API int wc_MakeRsaKey(RsaKey* key, int size, long e, WC_RNG* rng);
+    WOLFSSL_API int wc_MakeRsaKey_ex(RsaKey* key, int size, long e,
+                                     WC_RNG* rng, RsaKeyGenPool* pool);
+    #ifdef WOLFSSL_RSA_MULTI_PRIME
+    WOLFSSL_API int wc_MakeRsaKeyMultiPrime(RsaKey* key, int size, long e,
+                                            int primes, WC_RNG* rng);
+    #endif
     WOLFSSL_API int wc_CheckProbablePrime_ex(const byte* p, word32 pSz,
                                           const byte* q, word32 qSz,
                                           const byte* e, word32 eSz,
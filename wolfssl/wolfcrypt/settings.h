@@ -1939,6 +1939,53 @@ extern void uITRON4_free(void *p) ;
     #error old TLS requires MD5 and SHA
 #endif
 
+#if defined(WOLFSSL_CERT_VERIFY_CACHE) && (defined(NO_SHA256) || defined(NO_CERTS))
+    #error certificate verify cache requires SHA-256 and certificates
+#endif
+
+#if defined(HAVE_CERT_COMPRESSION) && !defined(WOLFSSL_TLS13)
+    #error certificate compression requires TLS v1.3
+#endif
+#if defined(HAVE_CERT_COMPRESSION) && !defined(WOLFSSL_CERT_MSG_CACHE)
+    /* compressed chain is made from the pre-encoded Certificate message */
+    #define WOLFSSL_CERT_MSG_CACHE
+#endif
+#if defined(WOLFSSL_EARLY_DATA_ANTI_REPLAY) && \
+    (!defined(WOLFSSL_EARLY_DATA) || !defined(HAVE_SESSION_TICKET))
+    #error early data anti-replay requires early data and session tickets
+#endif
+#if defined(WOLFSSL_HALF_RTT_DATA) && !defined(WOLFSSL_TLS13)
+    #error 0.5-RTT data requires TLS v1.3
+#endif
+#if defined(WOLFSSL_KEY_SHARE_CACHE) && (!defined(WOLFSSL_TLS13) || \
+    !defined(HAVE_SNI) || defined(NO_SHA256))
+    #error key share cache requires TLS v1.3, SNI and SHA-256
+#endif
+#if defined(WOLFSSL_KEY_SHARE_POOL) && !defined(WOLFSSL_TLS13)
+    #error key share pool requires TLS v1.3
+#endif
+#if defined(WOLFSSL_CH_PREPARSE) && (!defined(HAVE_TLS_EXTENSIONS) || \
+    defined(NO_WOLFSSL_SERVER))
+    #error ClientHello pre-parser requires TLS extensions and server
+#endif
+#if defined(WOLFSSL_SNI_CERT_STORE) && (!defined(HAVE_SNI) || \
+    defined(NO_CERTS) || defined(NO_WOLFSSL_SERVER))
+    #error SNI certificate store requires SNI, certificates and server
+#endif
+#if defined(WC_RSA_PREPARED) && (defined(NO_RSA) || \
+    defined(WOLFSSL_RSA_PUBLIC_ONLY) || defined(WOLFSSL_SP_MATH))
+    #error Prepared RSA keys require RSA private key support and MP math
+#endif
+#if defined(WOLFSSL_RSA_MULTI_PRIME) && (defined(NO_RSA) || \
+    defined(WOLFSSL_RSA_PUBLIC_ONLY) || defined(WOLFSSL_SP_MATH))
+    #error Multi-prime RSA requires RSA private key support and MP math
+#endif
+
+#if defined(WC_RSA_BATCH) && (defined(NO_RSA) || \
+    defined(WOLFSSL_RSA_VERIFY_ONLY))
+    #error Batched RSA verify requires RSA with wc_RsaSSL_Verify
+#endif
+
 /* for backwards compatibility */
 #if defined(TEST_IPV6) && !defined(WOLFSSL_IPV6)
     #define WOLFSSL_IPV6
@@ -68,6 +68,18 @@ WOLFSSL_LOCAL int sp_RsaPrivate_4096(const byte* in, word32 inLen,
     mp_int* dm, mp_int* pm, mp_int* qm, mp_int* dpm, mp_int* dqm, mp_int* qim,
     mp_int* mm, byte* out, word32* outLen);
 
+#if defined(WC_RSA_BATCH) && defined(WOLFSSL_SP_X86_64_ASM) && \
+    !defined(WOLFSSL_SP_NO_2048)
+    #define WOLFSSL_SP_RSA_BATCH
+
+    /* Maximum number of public key operations performed together. */
+    #define SP_RSA_BATCH_SZ     8
+
+WOLFSSL_LOCAL int sp_RsaPublic_2048_batch(const byte** in,
+    const word32* inLen, mp_int** em, mp_int** mm, byte** out,
+    word32* outLen, int* res, int cnt);
+#endif
+
 #endif /* WOLFSSL_HAVE_SP_RSA */
 
 #if defined(WOLFSSL_HAVE_SP_DH) || defined(WOLFSSL_HAVE_SP_RSA)
@@ -119,6 +131,20 @@ int sp_ecc_proj_dbl_point_256(mp_int* pX, mp_int* pY, mp_int* pZ,
 int sp_ecc_map_256(mp_int* pX, mp_int* pY, mp_int* pZ);
 int sp_ecc_uncompress_256(mp_int* xm, int odd, mp_int* ym);
 
+#if defined(WOLFSSL_ECC_PRECOMPUTE) && defined(WOLFSSL_SP_X86_64_ASM) && \
+    !defined(WOLFSSL_SP_NO_256)
+    #define WOLFSSL_SP_ECC_PRECOMP
+
+WOLFSSL_LOCAL int sp_ecc_precompute_256(mp_int* pX, mp_int* pY, mp_int* pZ,
+    void** table, void* heap);
+WOLFSSL_LOCAL void sp_ecc_precompute_free_256(void* table, void* heap);
+WOLFSSL_LOCAL int sp_ecc_secret_gen_table_256(mp_int* priv, ecc_point* pub,
+    const void* table, byte* out, word32* outlen, void* heap);
+WOLFSSL_LOCAL int sp_ecc_verify_table_256(const byte* hash, word32 hashLen,
+    mp_int* pX, mp_int* pY, mp_int* pZ, const void* table, mp_int* r,
+    mp_int* sm, int* res, void* heap);
+#endif
+
 #endif /*ifdef WOLFSSL_HAVE_SP_ECC */
 
 
@@ -40,6 +40,10 @@
 
     #define HAVE_INTEL_AVX1
     #define HAVE_INTEL_AVX2
+    #if defined(WC_RSA_BATCH) && defined(__GNUC__) && \
+        (__GNUC__ >= 5 || defined(__clang__))
+        #define HAVE_INTEL_AVX512
+    #endif
 #elif defined(WOLFSSL_SP_ARM64_ASM)
     #define SP_WORD_SIZE 64
 #elif defined(WOLFSSL_SP_ARM32_ASM)
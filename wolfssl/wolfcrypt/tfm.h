@@ -155,6 +155,11 @@
    #undef TFM_ASM
 #endif
 
+/* MULX/ADCX/ADOX kernels are x86_64 assembly */
+#if defined(HAVE_INTEL_MULX) && !defined(TFM_X86_64)
+   #undef HAVE_INTEL_MULX
+#endif
+
 /* ECC helpers */
 #ifdef TFM_ECC192
    #ifdef FP_64BIT
@@ -308,11 +313,16 @@
     #define WOLF_BIGINT_DEFINED
 #endif
 
-/* a FP type */
+/* a FP type
+ * With TFM_SIZED_INT, size is the number of digits set up by fp_init_size()
+ * and cleared, with any used digits past it, by fp_zero()/fp_clear() - copies
+ * only touch the used digits. The size must hold the largest value stored,
+ * including products. */
 typedef struct fp_int {
     int      used;
     int      sign;
-#if defined(ALT_ECC_SIZE) || defined(HAVE_WOLF_BIGINT)
+#if defined(ALT_ECC_SIZE) || defined(HAVE_WOLF_BIGINT) || \
+    defined(TFM_SIZED_INT)
     int      size;
 #endif
     fp_digit dp[FP_SIZE];
@@ -409,6 +419,7 @@ typedef fp_int   mp_int;
 
 /* initialize [or zero] an fp int */
 void fp_init(fp_int *a);
+void fp_init_size(fp_int *a, int size);
 MP_API void fp_zero(fp_int *a);
 MP_API void fp_clear(fp_int *a); /* uses ForceZero to clear sensitive memory */
 MP_API void fp_forcezero (fp_int * a);
@@ -548,6 +559,12 @@ int fp_montgomery_reduce(fp_int *a, fp_int *m, fp_digit mp);
 /* d = a**b (mod c) */
 int fp_exptmod(fp_int *a, fp_int *b, fp_int *c, fp_int *d);
 int fp_exptmod_ex(fp_int *a, fp_int *b, int minDigits, fp_int *c, fp_int *d);
+#ifdef WC_RSA_PREPARED
+/* d = a**b (mod c) with precomputed Montgomery values of c */
+int fp_exptmod_mont_setup(fp_int *c, fp_int *r2, fp_digit *mp);
+int fp_exptmod_mont(fp_int *a, fp_int *b, fp_int *c, fp_int *r2, fp_digit mp,
+                    fp_int *d);
+#endif
 
 #ifdef WC_RSA_NONBLOCK
 
@@ -627,7 +644,7 @@ int fp_count_bits(fp_int *a);
 int fp_leading_bit(fp_int *a);
 
 int fp_unsigned_bin_size(fp_int *a);
-void fp_read_unsigned_bin(fp_int *a, const unsigned char *b, int c);
+int fp_read_unsigned_bin(fp_int *a, const unsigned char *b, int c);
 int fp_to_unsigned_bin(fp_int *a, unsigned char *b);
 int fp_to_unsigned_bin_len(fp_int *a, unsigned char *b, int c);
 int fp_to_unsigned_bin_at_pos(int x, fp_int *t, unsigned char *b);
@@ -717,6 +734,7 @@ int  fp_sqr_comba64(fp_int *a, fp_int *b);
 #define mp_tohex(M, S)     mp_toradix((M), (S), MP_RADIX_HEX)
 
 MP_API int  mp_init (mp_int * a);
+MP_API int  mp_init_size (mp_int * a, int size);
 MP_API void mp_clear (mp_int * a);
 MP_API void mp_free (mp_int * a);
 MP_API void mp_forcezero (mp_int * a);
@@ -737,6 +755,11 @@ MP_API int  mp_invmod(mp_int *a, mp_int *b, mp_int *c);
 MP_API int  mp_exptmod (mp_int * g, mp_int * x, mp_int * p, mp_int * y);
 MP_API int  mp_exptmod_ex (mp_int * g, mp_int * x, int minDigits, mp_int * p,
                            mp_int * y);
+#ifdef WC_RSA_PREPARED
+MP_API int  mp_exptmod_mont_setup (mp_int * p, mp_int * r2, mp_digit * mp);
+MP_API int  mp_exptmod_mont (mp_int * g, mp_int * x, mp_int * p, mp_int * r2,
+                             mp_digit mp, mp_int * y);
+#endif
 MP_API int  mp_mul_2d(mp_int *a, int b, mp_int *c);
 MP_API int  mp_2expt(mp_int* a, int b);
 
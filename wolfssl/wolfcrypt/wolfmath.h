@@ -54,6 +54,13 @@ MP_API int get_digit_count(mp_int* a);
 MP_API mp_digit get_digit(mp_int* a, int n);
 MP_API int get_rand_digit(WC_RNG* rng, mp_digit* d);
 
+MP_API int mp_init_multi_size(int size, mp_int* a, mp_int* b, mp_int* c,
+                              mp_int* d, mp_int* e, mp_int* f);
+
+/* Size class, in digits, for mp_init_size() of a temporary reduced modulo m:
+ * room for the product of two such values. */
+#define MP_MOD_SIZE(m)   (2 * get_digit_count(m) + 1)
+
 WOLFSSL_API int mp_rand(mp_int* a, int digits, WC_RNG* rng);
 
 enum {